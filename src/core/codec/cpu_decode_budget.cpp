@@ -0,0 +1,70 @@
+// src/core/codec/cpu_decode_budget.cpp
+#include "cpu_decode_budget.h"
+#include <algorithm>
+#include <thread>
+
+namespace fluxvision {
+
+namespace {
+    size_t hardwareThreads() {
+        const unsigned int threads = std::thread::hardware_concurrency();
+        return threads > 0 ? threads : 4;
+    }
+}
+
+CpuDecodeBudget::CpuDecodeBudget()
+    : limit_(hardwareThreads())
+{
+}
+
+CpuDecodeBudget& CpuDecodeBudget::instance() {
+    static CpuDecodeBudget budget;
+    return budget;
+}
+
+void CpuDecodeBudget::setLimit(size_t threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    limit_ = threads > 0 ? threads : hardwareThreads();
+}
+
+size_t CpuDecodeBudget::getLimit() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return limit_;
+}
+
+size_t CpuDecodeBudget::getInUse() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return inUse_;
+}
+
+size_t CpuDecodeBudget::acquire(size_t wanted) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const size_t available = inUse_ < limit_ ? limit_ - inUse_ : 0;
+    const size_t granted = std::max<size_t>(1, std::min(wanted, available));
+    inUse_ += granted;
+    return granted;
+}
+
+void CpuDecodeBudget::release(size_t threads) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    inUse_ = inUse_ > threads ? inUse_ - threads : 0;
+}
+
+size_t CpuDecodeBudget::threadsFor(uint32_t width, uint32_t height) {
+    // Frame threading adds one frame of latency per extra thread, so small
+    // streams that one core decodes in real time stay single-threaded
+    const uint64_t pixels = static_cast<uint64_t>(width) * height;
+    if (pixels <= 640 * 360) {
+        return 1;
+    }
+    if (pixels <= 1280 * 720) {
+        return 2;
+    }
+    if (pixels <= 1920 * 1088) {
+        return 4;
+    }
+    return 8;
+}
+
+} // namespace fluxvision
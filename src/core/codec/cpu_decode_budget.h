@@ -0,0 +1,44 @@
+// src/core/codec/cpu_decode_budget.h
+// Process-wide cap on libavcodec decode threads, shared by every CpuDecoder
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+namespace fluxvision {
+
+// Decode threads handed out to software decoders
+//
+// Each CpuDecoder asks for threads sized to its resolution and gets what is
+// left of the limit, but always at least one: a camera admitted to the CPU
+// decoder must be able to decode, so once the budget is spent new decoders
+// run single-threaded instead of oversubscribing the cores further. The limit
+// defaults to the number of hardware threads.
+//
+// Thread-safety: all methods may be called from any thread
+class CpuDecodeBudget {
+public:
+    static CpuDecodeBudget& instance();
+
+    // 0 = one thread per hardware thread. Decoders already running keep theirs.
+    void setLimit(size_t threads);
+    size_t getLimit() const;
+    size_t getInUse() const;
+
+    // Between 1 and wanted threads; pass the result back to release()
+    size_t acquire(size_t wanted);
+    void release(size_t threads);
+
+    // Frame threads worth using at this resolution (1 up to 360p, 8 beyond 1080p)
+    static size_t threadsFor(uint32_t width, uint32_t height);
+
+private:
+    CpuDecodeBudget();
+
+    mutable std::mutex mutex_;
+    size_t limit_;
+    size_t inUse_ = 0;
+};
+
+} // namespace fluxvision
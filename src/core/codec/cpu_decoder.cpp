@@ -1,16 +1,37 @@
 // src/core/codec/cpu_decoder.cpp
 // CPU-based software decoder using FFmpeg libavcodec
 #include "cpu_decoder.h"
+#include "cpu_decode_budget.h"
+#include <chrono>
 #include <cstring>
 #include <iostream>
 
 namespace fluxvision {
 
+namespace {
+    // Idle AVFrame shells kept for reuse (the pixel buffers are pooled by libavcodec)
+    constexpr size_t kMaxRecycledFrames = 8;
+
+    const char* qsvDecoderName(CodecType codec) {
+        return codec == CodecType::H265 ? "hevc_qsv" : "h264_qsv";
+    }
+
+    bool hasHwDevice(AVHWDeviceType type) {
+        AVBufferRef* device = nullptr;
+        if (av_hwdevice_ctx_create(&device, type, nullptr, nullptr, 0) < 0) {
+            return false;
+        }
+        av_buffer_unref(&device);
+        return true;
+    }
+}
+
 CpuDecoder::CpuDecoder()
     : codec_(nullptr)
     , codecCtx_(nullptr)
     , packet_(nullptr)
     , avFrame_(nullptr)
+    , framePool_(std::make_shared<FramePool>())
     , frameAvailable_(false)
     , systemMemoryUsed_(0)
     , framesDecoded_(0)
@@ -20,29 +41,73 @@ CpuDecoder::CpuDecoder()
 }
 
 CpuDecoder::~CpuDecoder() {
+    // Frames still held by consumers keep their buffers until released
+    currentHandle_.reset();
     freeFrame();
 
     if (packet_) {
         av_packet_free(&packet_);
     }
 
-    if (codecCtx_) {
-        avcodec_free_context(&codecCtx_);
-    }
+    closeCodec();
 }
 
 bool CpuDecoder::initialize(const DecoderConfig& config) {
     if (initialized_) {
         reset();
+        closeCodec();
+        initialized_ = false;
     }
 
     config_ = config;
 
-    // Find decoder
-    AVCodecID codecId = (config_.codec == CodecType::H265) ? AV_CODEC_ID_HEVC : AV_CODEC_ID_H264;
-    codec_ = avcodec_find_decoder(codecId);
+    // Hardware offload first; software if the device or decoder refuses
+    const HwAccel accel = config_.hwAccel == HwAccel::AUTO ? detectHwAccel(config_.codec) : config_.hwAccel;
+    if (accel != HwAccel::NONE && !openCodec(accel)) {
+        std::cerr << "CpuDecoder: " << hwAccelName(accel) << " unavailable for "
+                  << codecToString(config_.codec) << ", decoding in software" << std::endl;
+    }
+
+    if (!codecCtx_ && !openCodec(HwAccel::NONE)) {
+        return false;
+    }
+
+    // Allocate packet
+    if (!packet_) {
+        packet_ = av_packet_alloc();
+    }
+    if (!packet_) {
+        std::cerr << "CpuDecoder: Failed to allocate packet" << std::endl;
+        closeCodec();
+        return false;
+    }
+
+    // Allocate frame
+    if (!avFrame_ && !allocateFrame()) {
+        av_packet_free(&packet_);
+        closeCodec();
+        return false;
+    }
+
+    initialized_ = true;
+    std::cout << "CpuDecoder: Initialized " << codecToString(config_.codec) << " decoder ("
+              << (activeAccel_ == HwAccel::NONE ? "software fallback" : hwAccelName(activeAccel_))
+              << ", " << budgetThreads_ << (budgetThreads_ > 1 ? " frame threads)" : " thread)") << std::endl;
+
+    return true;
+}
+
+bool CpuDecoder::openCodec(HwAccel accel) {
+    // QSV has its own decoders; VAAPI and software use the native one
+    if (accel == HwAccel::QSV) {
+        codec_ = avcodec_find_decoder_by_name(qsvDecoderName(config_.codec));
+    } else {
+        codec_ = avcodec_find_decoder(config_.codec == CodecType::H265 ? AV_CODEC_ID_HEVC : AV_CODEC_ID_H264);
+    }
     if (!codec_) {
-        std::cerr << "CpuDecoder: Failed to find " << codecToString(config_.codec) << " decoder" << std::endl;
+        if (accel == HwAccel::NONE) {
+            std::cerr << "CpuDecoder: Failed to find " << codecToString(config_.codec) << " decoder" << std::endl;
+        }
         return false;
     }
 
@@ -53,10 +118,31 @@ bool CpuDecoder::initialize(const DecoderConfig& config) {
         return false;
     }
 
-    // Configure codec context for low latency
-    codecCtx_->thread_count = 2;  // Limited threading for CPU decoder
-    codecCtx_->thread_type = FF_THREAD_SLICE;
-    codecCtx_->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    if (accel == HwAccel::VAAPI) {
+        if (av_hwdevice_ctx_create(&hwDevice_, AV_HWDEVICE_TYPE_VAAPI, nullptr, nullptr, 0) < 0) {
+            avcodec_free_context(&codecCtx_);
+            return false;
+        }
+        codecCtx_->hw_device_ctx = av_buffer_ref(hwDevice_);
+        codecCtx_->get_format = selectVaapiFormat;
+    }
+
+    // Most cameras send one slice per picture, so software decoding scales with
+    // frame threads, sized by resolution and capped by the process-wide budget.
+    // Offloaded decoders only parse on the CPU.
+    const size_t wanted = accel == HwAccel::NONE
+        ? CpuDecodeBudget::threadsFor(config_.maxWidth, config_.maxHeight) : 1;
+    budgetThreads_ = CpuDecodeBudget::instance().acquire(wanted);
+
+    codecCtx_->thread_count = static_cast<int>(budgetThreads_);
+    if (budgetThreads_ > 1) {
+        // libavcodec disables frame threading under LOW_DELAY; the cost is one
+        // frame of latency per extra thread
+        codecCtx_->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+    } else {
+        codecCtx_->thread_type = FF_THREAD_SLICE;
+        codecCtx_->flags |= AV_CODEC_FLAG_LOW_DELAY;
+    }
     codecCtx_->flags2 |= AV_CODEC_FLAG2_FAST;
 
     // Set maximum resolution
@@ -68,36 +154,68 @@ bool CpuDecoder::initialize(const DecoderConfig& config) {
     if (ret < 0) {
         char errBuf[AV_ERROR_MAX_STRING_SIZE];
         av_strerror(ret, errBuf, sizeof(errBuf));
-        std::cerr << "CpuDecoder: Failed to open codec: " << errBuf << std::endl;
-        avcodec_free_context(&codecCtx_);
+        std::cerr << "CpuDecoder: Failed to open " << codec_->name << ": " << errBuf << std::endl;
+        closeCodec();
         return false;
     }
 
-    // Allocate packet
-    packet_ = av_packet_alloc();
-    if (!packet_) {
-        std::cerr << "CpuDecoder: Failed to allocate packet" << std::endl;
+    activeAccel_ = accel;
+    return true;
+}
+
+void CpuDecoder::closeCodec() {
+    if (codecCtx_) {
         avcodec_free_context(&codecCtx_);
-        return false;
     }
+    if (hwDevice_) {
+        av_buffer_unref(&hwDevice_);
+    }
+    if (budgetThreads_ > 0 && !budgetReleased_) {
+        CpuDecodeBudget::instance().release(budgetThreads_);
+    }
+    budgetThreads_ = 0;
+    budgetReleased_ = false;
+    activeAccel_ = HwAccel::NONE;
+}
 
-    // Allocate frame
-    if (!allocateFrame()) {
-        av_packet_free(&packet_);
-        avcodec_free_context(&codecCtx_);
-        return false;
+AVPixelFormat CpuDecoder::selectVaapiFormat(AVCodecContext* ctx, const AVPixelFormat* formats) {
+    for (const AVPixelFormat* format = formats; *format != AV_PIX_FMT_NONE; ++format) {
+        if (*format == AV_PIX_FMT_VAAPI) {
+            return *format;
+        }
     }
 
-    initialized_ = true;
-    std::cout << "CpuDecoder: Initialized " << codecToString(config_.codec)
-              << " decoder (software fallback)" << std::endl;
+    // Profile the device can't decode: software output from here on
+    return avcodec_default_get_format(ctx, formats);
+}
 
-    return true;
+HwAccel CpuDecoder::detectHwAccel(CodecType codec) {
+    // Opening a device takes milliseconds: probe once per process
+    static const bool vaapi = hasHwDevice(AV_HWDEVICE_TYPE_VAAPI);
+    static const bool qsv = hasHwDevice(AV_HWDEVICE_TYPE_QSV);
+
+    if (vaapi) {
+        return HwAccel::VAAPI;
+    }
+    if (qsv && avcodec_find_decoder_by_name(qsvDecoderName(codec))) {
+        return HwAccel::QSV;
+    }
+    return HwAccel::NONE;
+}
+
+const char* CpuDecoder::hwAccelName(HwAccel accel) {
+    switch (accel) {
+        case HwAccel::VAAPI: return "VAAPI";
+        case HwAccel::QSV:   return "QSV";
+        case HwAccel::AUTO:  return "auto";
+        default:             return "software";
+    }
 }
 
 bool CpuDecoder::allocateFrame() {
     avFrame_ = av_frame_alloc();
-    if (!avFrame_) {
+    transferFrame_ = av_frame_alloc();
+    if (!avFrame_ || !transferFrame_) {
         std::cerr << "CpuDecoder: Failed to allocate frame" << std::endl;
         return false;
     }
@@ -109,26 +227,91 @@ void CpuDecoder::freeFrame() {
     if (avFrame_) {
         av_frame_free(&avFrame_);
     }
+    if (transferFrame_) {
+        av_frame_free(&transferFrame_);
+    }
+}
+
+bool CpuDecoder::downloadFrame() {
+    av_frame_unref(transferFrame_);
+    if (av_hwframe_transfer_data(transferFrame_, avFrame_, 0) < 0 ||
+        av_frame_copy_props(transferFrame_, avFrame_) < 0) {
+        av_frame_unref(transferFrame_);
+        av_frame_unref(avFrame_);
+        return false;
+    }
+
+    av_frame_unref(avFrame_);
+    av_frame_move_ref(avFrame_, transferFrame_);
+    return true;
 }
 
 DecodeResult CpuDecoder::decode(const uint8_t* data, size_t size) {
-    DecodeResult result = {};
-    result.status = DecodeStatus::NEED_MORE_DATA;
-    result.frame = nullptr;
-    result.errorMessage = nullptr;
+    if (packet_) {
+        packet_->pts = AV_NOPTS_VALUE;
+    }
+    return sendCopy(data, size);
+}
 
+DecodeResult CpuDecoder::sendCopy(const uint8_t* data, size_t size) {
     if (!initialized_) {
+        DecodeResult result = {};
         result.status = DecodeStatus::ERROR_DECODER_FAILURE;
         result.errorMessage = "Decoder not initialized";
         return result;
     }
 
-    // Prepare packet
+    // Prepare packet (not refcounted: libavcodec copies it internally)
     packet_->data = const_cast<uint8_t*>(data);
     packet_->size = static_cast<int>(size);
 
+    return sendAndReceive();
+}
+
+DecodeResult CpuDecoder::decodePacket(const PacketBuffer& packet, int64_t pts) {
+    if (packet_) {
+        packet_->pts = pts;  // libavcodec carries it to the frame, through reordering
+    }
+
+    AVBufferRef* buffer = packet.avBuffer();
+    if (!initialized_ || !buffer) {
+        return sendCopy(packet.data(), packet.size());
+    }
+
+    // Hand libavcodec a reference to the network buffer instead of a copy
+    packet_->buf = av_buffer_ref(buffer);
+    if (!packet_->buf) {
+        return sendCopy(packet.data(), packet.size());
+    }
+
+    packet_->data = const_cast<uint8_t*>(packet.data());
+    packet_->size = static_cast<int>(packet.size());
+
+    DecodeResult result = sendAndReceive();
+    av_packet_unref(packet_);
+    return result;
+}
+
+DecodeResult CpuDecoder::sendAndReceive() {
+    DecodeResult result = {};
+    result.status = DecodeStatus::NEED_MORE_DATA;
+    result.frame = nullptr;
+    result.errorMessage = nullptr;
+
     // Send packet to decoder
     int ret = avcodec_send_packet(codecCtx_, packet_);
+    if (ret == AVERROR(EAGAIN)) {
+        // Output is full: take every ready frame, then the same packet fits
+        ret = drainFrames();
+        if (ret == AVERROR(EAGAIN)) {
+            ret = avcodec_send_packet(codecCtx_, packet_);
+        } else if (ret == kDownloadFailed) {
+            result.status = DecodeStatus::ERROR_DECODER_FAILURE;
+            result.errorMessage = "VAAPI frame download failed";
+            return result;
+        }
+    }
+
     if (ret < 0) {
         if (ret == AVERROR(EAGAIN)) {
             result.status = DecodeStatus::NEED_MORE_DATA;
@@ -142,15 +325,16 @@ DecodeResult CpuDecoder::decode(const uint8_t* data, size_t size) {
     }
 
     // Receive decoded frame
-    ret = avcodec_receive_frame(codecCtx_, avFrame_);
+    ret = receiveFrame();
     if (ret == 0) {
         // Frame decoded successfully
-        frameAvailable_ = true;
-        framesDecoded_++;
         result.status = DecodeStatus::SUCCESS;
+    } else if (ret == kDownloadFailed) {
+        result.status = DecodeStatus::ERROR_DECODER_FAILURE;
+        result.errorMessage = "VAAPI frame download failed";
     } else if (ret == AVERROR(EAGAIN)) {
         // Need more data
-        result.status = DecodeStatus::NEED_MORE_DATA;
+        result.status = !drained_.empty() ? DecodeStatus::SUCCESS : DecodeStatus::NEED_MORE_DATA;
     } else if (ret == AVERROR_EOF) {
         // End of stream
         result.status = DecodeStatus::SUCCESS;
@@ -162,52 +346,174 @@ DecodeResult CpuDecoder::decode(const uint8_t* data, size_t size) {
     return result;
 }
 
+int CpuDecoder::receiveFrame() {
+    int ret = avcodec_receive_frame(codecCtx_, avFrame_);
+    if (ret != 0) {
+        return ret;
+    }
+
+    if (avFrame_->format == AV_PIX_FMT_VAAPI && !downloadFrame()) {
+        return kDownloadFailed;
+    }
+
+    frameAvailable_ = true;
+    outputTime_ = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    framesDecoded_++;
+    return 0;
+}
+
+int CpuDecoder::drainFrames() {
+    // Queued in decode order, ahead of whatever the resent packet produces
+    while (true) {
+        if (frameAvailable_) {
+            if (FrameHandle frame = takeFrame()) {
+                drained_.push_back(std::move(frame));
+            }
+        }
+
+        const int ret = receiveFrame();
+        if (ret != 0) {
+            return ret;
+        }
+    }
+}
+
 DecodedFrame* CpuDecoder::getFrame() {
+    // The frame stays valid until the next call
+    currentHandle_ = acquireFrame();
+    if (!currentHandle_) {
+        return nullptr;
+    }
+
+    currentFrame_ = *currentHandle_;
+    return &currentFrame_;
+}
+
+FrameHandle CpuDecoder::acquireFrame() {
+    // Frames drained to make room for a packet come first
+    if (!drained_.empty()) {
+        FrameHandle frame = std::move(drained_.front());
+        drained_.pop_front();
+        return frame;
+    }
+    return takeFrame();
+}
+
+FrameHandle CpuDecoder::takeFrame() {
     if (!frameAvailable_ || !avFrame_) {
         return nullptr;
     }
 
+    frameAvailable_ = false;  // Mark frame as consumed
+
+    DecodedFrame frame = {};
+    if (!describeFrame(avFrame_, frame)) {
+        std::cerr << "CpuDecoder: Unsupported pixel format: " << avFrame_->format << std::endl;
+        av_frame_unref(avFrame_);
+        return nullptr;
+    }
+    frame.outputTime = outputTime_;
+
+    // Move the decoded buffers into a pooled frame owned by the handle; the
+    // plane pointers don't change, so the description above stays valid
+    AVFrame* held = framePool_->take();
+    if (!held) {
+        std::cerr << "CpuDecoder: Failed to allocate frame" << std::endl;
+        av_frame_unref(avFrame_);
+        return nullptr;
+    }
+    av_frame_move_ref(held, avFrame_);
+
+    return makeFrameHandle(FrameLease(frame, framePool_, reinterpret_cast<uint64_t>(held)));
+}
+
+bool CpuDecoder::describeFrame(const AVFrame* avFrame, DecodedFrame& frame) {
     // Map AVFrame to DecodedFrame
-    currentFrame_.width = avFrame_->width;
-    currentFrame_.height = avFrame_->height;
-    currentFrame_.pts = avFrame_->pts;
-    currentFrame_.dts = avFrame_->pkt_dts;
+    frame.width = avFrame->width;
+    frame.height = avFrame->height;
+    frame.pts = avFrame->pts;
+    frame.dts = avFrame->pkt_dts;
     // FFmpeg 6.0+ API: use flags instead of deprecated key_frame field
-    currentFrame_.isKeyframe = (avFrame_->flags & AV_FRAME_FLAG_KEY);
+    frame.isKeyframe = (avFrame->flags & AV_FRAME_FLAG_KEY);
 
     // Determine pixel format
-    switch (avFrame_->format) {
+    switch (avFrame->format) {
         case AV_PIX_FMT_YUV420P:
-            currentFrame_.format = PixelFormat::YUV420P;
-            currentFrame_.data[0] = avFrame_->data[0];  // Y plane
-            currentFrame_.data[1] = avFrame_->data[1];  // U plane
-            currentFrame_.data[2] = avFrame_->data[2];  // V plane
-            currentFrame_.pitch[0] = avFrame_->linesize[0];
-            currentFrame_.pitch[1] = avFrame_->linesize[1];
-            currentFrame_.pitch[2] = avFrame_->linesize[2];
+            frame.format = PixelFormat::YUV420P;
+            frame.data[0] = avFrame->data[0];  // Y plane
+            frame.data[1] = avFrame->data[1];  // U plane
+            frame.data[2] = avFrame->data[2];  // V plane
+            frame.pitch[0] = avFrame->linesize[0];
+            frame.pitch[1] = avFrame->linesize[1];
+            frame.pitch[2] = avFrame->linesize[2];
             break;
 
         case AV_PIX_FMT_NV12:
-            currentFrame_.format = PixelFormat::NV12;
-            currentFrame_.data[0] = avFrame_->data[0];  // Y plane
-            currentFrame_.data[1] = avFrame_->data[1];  // UV plane (interleaved)
-            currentFrame_.data[2] = nullptr;
-            currentFrame_.pitch[0] = avFrame_->linesize[0];
-            currentFrame_.pitch[1] = avFrame_->linesize[1];
-            currentFrame_.pitch[2] = 0;
+            frame.format = PixelFormat::NV12;
+            frame.data[0] = avFrame->data[0];  // Y plane
+            frame.data[1] = avFrame->data[1];  // UV plane (interleaved)
+            frame.data[2] = nullptr;
+            frame.pitch[0] = avFrame->linesize[0];
+            frame.pitch[1] = avFrame->linesize[1];
+            frame.pitch[2] = 0;
             break;
 
         default:
-            std::cerr << "CpuDecoder: Unsupported pixel format: " << avFrame_->format << std::endl;
-            return nullptr;
+            return false;
     }
 
     // CPU decoder doesn't use GPU memory
-    currentFrame_.cudaSurface = nullptr;
-    currentFrame_.cudaPitch = 0;
+    frame.cudaSurface = nullptr;
+    frame.cudaPitch = 0;
 
-    frameAvailable_ = false;  // Mark frame as consumed
-    return &currentFrame_;
+    return true;
+}
+
+CpuDecoder::FramePool::~FramePool() {
+    for (AVFrame* frame : free_) {
+        av_frame_free(&frame);
+    }
+}
+
+AVFrame* CpuDecoder::FramePool::take() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    AVFrame* frame = nullptr;
+    if (!free_.empty()) {
+        frame = free_.back();
+        free_.pop_back();
+    } else {
+        frame = av_frame_alloc();
+    }
+
+    if (frame) {
+        outstanding_++;
+    }
+    return frame;
+}
+
+void CpuDecoder::FramePool::releaseLease(uint64_t token) {
+    AVFrame* frame = reinterpret_cast<AVFrame*>(token);
+
+    // Drops this frame's buffer references (may run on any consumer thread)
+    av_frame_unref(frame);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (outstanding_ > 0) {
+        outstanding_--;
+    }
+
+    if (free_.size() < kMaxRecycledFrames) {
+        free_.push_back(frame);
+    } else {
+        av_frame_free(&frame);
+    }
+}
+
+size_t CpuDecoder::FramePool::outstanding() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return outstanding_;
 }
 
 void CpuDecoder::setQuality(StreamQuality quality) {
@@ -223,13 +529,16 @@ MemoryStats CpuDecoder::getMemoryUsage() const {
     stats.gpuMemoryUsed = 0;  // CPU decoder doesn't use GPU
     stats.systemMemoryUsed = systemMemoryUsed_;
 
+    // Estimate frame buffer size (YUV420P format): the working frame plus the ones consumers hold
+    const size_t heldFrames = framePool_->outstanding();
+    const size_t frameBytes = config_.maxWidth * config_.maxHeight * 3 / 2;
     if (avFrame_) {
-        // Estimate frame buffer size (YUV420P format)
-        stats.systemMemoryUsed += (config_.maxWidth * config_.maxHeight * 3 / 2);
+        stats.systemMemoryUsed += frameBytes;
     }
+    stats.systemMemoryUsed += heldFrames * frameBytes;
 
-    stats.surfacePoolSize = 1;  // CPU decoder uses single frame
-    stats.surfacePoolCapacity = 1;
+    stats.surfacePoolSize = 1 + heldFrames;
+    stats.surfacePoolCapacity = 1 + heldFrames;  // libavcodec grows its buffer pool on demand
 
     return stats;
 }
@@ -242,6 +551,8 @@ void CpuDecoder::flush() {
     // Flush decoder
     avcodec_flush_buffers(codecCtx_);
     frameAvailable_ = false;
+    drained_.clear();
+    currentHandle_.reset();
 }
 
 void CpuDecoder::reset() {
@@ -249,4 +560,36 @@ void CpuDecoder::reset() {
     framesDecoded_ = 0;
 }
 
+void CpuDecoder::park() {
+    reset();
+
+    // Idle frame threads don't count against the budget of decoders still running
+    if (budgetThreads_ > 0 && !budgetReleased_) {
+        CpuDecodeBudget::instance().release(budgetThreads_);
+        budgetReleased_ = true;
+    }
+}
+
+bool CpuDecoder::rebind(const DecoderConfig& config) {
+    // Thread count and offload were chosen for this codec and size at open
+    if (!initialized_ || config.codec != config_.codec || config.hwAccel != config_.hwAccel ||
+        config.maxWidth != config_.maxWidth || config.maxHeight != config_.maxHeight) {
+        return false;
+    }
+
+    // A budget spent meanwhile would be oversubscribed: open a smaller decoder instead
+    if (budgetReleased_) {
+        const size_t granted = CpuDecodeBudget::instance().acquire(budgetThreads_);
+        if (granted < budgetThreads_) {
+            CpuDecodeBudget::instance().release(granted);
+            return false;
+        }
+        budgetReleased_ = false;
+    }
+
+    config_ = config;
+    frameAvailable_ = false;
+    return true;
+}
+
 } // namespace fluxvision
@@ -6,15 +6,20 @@
 
 extern "C" {
 #include <libavcodec/avcodec.h>
+#include <libavutil/hwcontext.h>
 #include <libavutil/imgutils.h>
 #include <libavutil/opt.h>
 }
 
+#include <deque>
 #include <memory>
 #include <mutex>
+#include <vector>
 
 namespace fluxvision {
 
+// libavcodec decoder: VAAPI/QSV offload where available, otherwise software
+// with frame threads from the process-wide CpuDecodeBudget
 class CpuDecoder : public IDecoder {
 public:
     CpuDecoder();
@@ -23,17 +28,39 @@ public:
     // IDecoder interface
     bool initialize(const DecoderConfig& config) override;
     DecodeResult decode(const uint8_t* data, size_t size) override;
+    DecodeResult decodePacket(const PacketBuffer& packet, int64_t pts) override;
     DecodedFrame* getFrame() override;
+    FrameHandle acquireFrame() override;
     void setQuality(StreamQuality quality) override;
     MemoryStats getMemoryUsage() const override;
     void flush() override;
     void reset() override;
+    void park() override;
+    bool rebind(const DecoderConfig& config) override;
     const DecoderConfig& getConfig() const override { return config_; }
     bool isHardwareAccelerated() const override { return false; }
 
+    // Offload in use after initialize() (NONE = software)
+    HwAccel getHwAccel() const { return activeAccel_; }
+    size_t getThreadCount() const { return budgetThreads_; }
+
+    // Best offload this machine offers for the codec (devices probed once per process)
+    static HwAccel detectHwAccel(CodecType codec);
+    static const char* hwAccelName(HwAccel accel);
+
 private:
+    bool openCodec(HwAccel accel);
+    void closeCodec();
+    bool downloadFrame();  // VAAPI surface -> NV12 in system memory
+    static AVPixelFormat selectVaapiFormat(AVCodecContext* ctx, const AVPixelFormat* formats);
     bool allocateFrame();
     void freeFrame();
+    DecodeResult sendCopy(const uint8_t* data, size_t size);  // packet_->pts already set
+    DecodeResult sendAndReceive();
+    int receiveFrame();    // Into avFrame_: 0, an AVERROR, or kDownloadFailed
+    int drainFrames();     // Receive into drained_ until receiveFrame() fails; returns that
+    FrameHandle takeFrame();  // avFrame_ as a handle, if a frame is available
+    static bool describeFrame(const AVFrame* avFrame, DecodedFrame& frame);
 
     // Configuration
     DecoderConfig config_;
@@ -43,10 +70,37 @@ private:
     AVCodecContext* codecCtx_;
     AVPacket* packet_;
     AVFrame* avFrame_;
+    AVFrame* transferFrame_ = nullptr;   // VAAPI download target
+    AVBufferRef* hwDevice_ = nullptr;
+    HwAccel activeAccel_ = HwAccel::NONE;
+    size_t budgetThreads_ = 0;           // Taken from CpuDecodeBudget
+    bool budgetReleased_ = false;        // Parked: budgetThreads_ given back until rebind()
+
+    // Decoded frames handed out as handles. Each holds its own reference to
+    // libavcodec's buffer pool, so it stays valid while the decoder moves on
+    // (or is destroyed); the AVFrame shells are recycled on release.
+    class FramePool : public FrameLease::Owner {
+    public:
+        ~FramePool() override;
+
+        AVFrame* take();                             // Empty frame (recycled or new)
+        void releaseLease(uint64_t token) override;  // Unref and recycle (any thread)
+        size_t outstanding() const;
+
+    private:
+        mutable std::mutex mutex_;
+        std::vector<AVFrame*> free_;
+        size_t outstanding_ = 0;
+    };
+    std::shared_ptr<FramePool> framePool_;
 
     // Current decoded frame (for getFrame())
     DecodedFrame currentFrame_;
+    FrameHandle currentHandle_;    // Keeps getFrame()'s frame alive until the next call
     bool frameAvailable_;
+    int64_t outputTime_ = 0;       // When avFrame_ was received (steady clock, microseconds)
+    std::deque<FrameHandle> drained_;  // Taken out when send_packet returned EAGAIN
+    static constexpr int kDownloadFailed = AVERROR_EXTERNAL;
 
     // Statistics
     mutable std::mutex statsMutex_;
@@ -20,6 +20,12 @@ std::unique_ptr<IDecoder> DecoderFactory::create(const DecoderConfig& config) {
 std::unique_ptr<IDecoder> DecoderFactory::create(DecoderType type, const DecoderConfig& config) {
     std::unique_ptr<IDecoder> decoder;
 
+    // The CPU path offloads to VAAPI/QSV when the machine has it (NVDEC ignores this)
+    DecoderConfig resolved = config;
+    if (resolved.hwAccel == HwAccel::AUTO) {
+        resolved.hwAccel = getCpuHwAccel(config.codec);
+    }
+
     switch (type) {
         case DecoderType::AUTO:
             return create(config);  // Recursive call to auto-select
@@ -44,7 +50,7 @@ std::unique_ptr<IDecoder> DecoderFactory::create(DecoderType type, const Decoder
     }
 
     // Initialize the decoder
-    if (decoder && !decoder->initialize(config)) {
+    if (decoder && !decoder->initialize(resolved)) {
         std::cerr << "DecoderFactory: Failed to initialize decoder" << std::endl;
         return nullptr;
     }
@@ -78,18 +84,17 @@ DecoderType DecoderFactory::getRecommendedType() {
     return DecoderType::CPU;
 }
 
+HwAccel DecoderFactory::getCpuHwAccel(CodecType codec) {
+    return CpuDecoder::detectHwAccel(codec);
+}
+
 DecoderFactory::DecoderCapabilities DecoderFactory::getCapabilities() {
     DecoderCapabilities caps = {};
 
 #ifdef HAVE_CUDA
     caps.nvdecAvailable = isNvdecAvailable();
 
-    auto& cudaCtx = CudaContext::getInstance();
-    if (cudaCtx.isInitialized()) {
-        caps.cudaDeviceCount = 1;  // Simplified: we use device 0
-    } else {
-        caps.cudaDeviceCount = 0;
-    }
+    caps.cudaDeviceCount = caps.nvdecAvailable ? CudaContext::getDeviceCount() : 0;
 #else
     caps.nvdecAvailable = false;
     caps.cudaDeviceCount = 0;
@@ -97,9 +102,15 @@ DecoderFactory::DecoderCapabilities DecoderFactory::getCapabilities() {
 
     // CPU decoder is always available (FFmpeg is a required dependency)
     caps.cpuDecoderAvailable = true;
+    const HwAccel cpuHwAccel = getCpuHwAccel();
+    caps.cpuHwAccel = CpuDecoder::hwAccelName(cpuHwAccel);
 
     if (caps.nvdecAvailable) {
         caps.recommendedDecoder = "NVDEC (Hardware)";
+    } else if (cpuHwAccel == HwAccel::VAAPI) {
+        caps.recommendedDecoder = "VAAPI (Hardware)";
+    } else if (cpuHwAccel == HwAccel::QSV) {
+        caps.recommendedDecoder = "QSV (Hardware)";
     } else {
         caps.recommendedDecoder = "CPU (Software)";
     }
@@ -29,11 +29,15 @@ public:
     // Get recommended decoder type for current system
     static DecoderType getRecommendedType();
 
+    // Offload the CPU decoder uses under HwAccel::AUTO: VAAPI, then QSV, else NONE
+    static HwAccel getCpuHwAccel(CodecType codec = CodecType::H264);
+
     // Get decoder capabilities info
     struct DecoderCapabilities {
         bool nvdecAvailable;
         bool cpuDecoderAvailable;
         int cudaDeviceCount;
+        const char* cpuHwAccel;          // "VAAPI", "QSV" or "software" (H.264)
         const char* recommendedDecoder;
     };
 
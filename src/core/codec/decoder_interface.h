@@ -3,6 +3,8 @@
 #pragma once
 
 #include "types.h"
+#include "packet_buffer.h"
+#include "frame_lease.h"
 #include <memory>
 
 namespace fluxvision {
@@ -21,11 +23,27 @@ public:
     // Returns DecodeResult with status and frame (if available)
     virtual DecodeResult decode(const uint8_t* data, size_t size) = 0;
 
+    // Decode a refcounted packet
+    // pts (microseconds) is carried to the frames the packet produces, so
+    // callers can match output to input. Decoders that can hold a reference
+    // instead of copying (FFmpeg) or take timestamps (NVDEC) override this.
+    virtual DecodeResult decodePacket(const PacketBuffer& packet, int64_t pts) {
+        (void)pts;
+        return decode(packet.data(), packet.size());
+    }
+
     // Get the most recent decoded frame
     // Returns nullptr if no frame is available
-    // Note: Frame ownership remains with decoder (zero-copy)
+    // Note: Frame ownership remains with decoder; valid until the next getFrame() call.
+    // Prefer acquireFrame() for frames that outlive the call.
     virtual DecodedFrame* getFrame() = 0;
 
+    // Take the next decoded frame as a shared handle (nullptr if none is ready)
+    // The frame's surface is pool-backed and returns to the pool when the last
+    // copy of the handle is dropped, on any thread. Decoders with a fixed pool
+    // drop new pictures while consumers hold every surface rather than block.
+    virtual FrameHandle acquireFrame() = 0;
+
     // Dynamically change quality level
     // This will resize surface pools and adjust FPS limiting
     // quality: new quality level
@@ -40,6 +58,17 @@ public:
     // Reset decoder state
     virtual void reset() = 0;
 
+    // Decoder reuse (DecoderPool)
+    // park() drops the camera's stream state and the resources that are cheap
+    // to get back; rebind() readies a parked decoder for another camera's
+    // config. rebind() returns false if the decoder can't serve it, and the
+    // caller then creates a new one.
+    virtual void park() { reset(); }
+    virtual bool rebind(const DecoderConfig& config) {
+        (void)config;
+        return false;
+    }
+
     // Get current configuration
     virtual const DecoderConfig& getConfig() const = 0;
 
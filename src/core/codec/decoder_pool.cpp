@@ -0,0 +1,169 @@
+// src/core/codec/decoder_pool.cpp
+#include "decoder_pool.h"
+#include <algorithm>
+#include <iostream>
+
+namespace fluxvision {
+
+DecoderPool& DecoderPool::instance() {
+    static DecoderPool pool;
+    return pool;
+}
+
+void DecoderPool::setCapacity(size_t decoders) {
+    // Destroyed after the lock is released: NVDEC teardown synchronizes with the driver
+    std::vector<std::unique_ptr<IDecoder>> surplus;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        capacity_ = decoders;
+        while (idle_.size() > capacity_) {
+            surplus.push_back(std::move(idle_.front().decoder));
+            idle_.erase(idle_.begin());
+            stats_.evicted++;
+        }
+    }
+}
+
+void DecoderPool::setMaxIdleAge(std::chrono::seconds age) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    maxIdleAge_ = age;
+}
+
+bool DecoderPool::matches(const IDecoder& decoder, DecoderType type, const DecoderConfig& config) {
+    const bool hardware = decoder.isHardwareAccelerated();
+    if ((type == DecoderType::NVDEC && !hardware) || (type == DecoderType::CPU && hardware)) {
+        return false;
+    }
+
+    const DecoderConfig& current = decoder.getConfig();
+    if (current.codec != config.codec || current.maxWidth != config.maxWidth ||
+        current.maxHeight != config.maxHeight) {
+        return false;
+    }
+
+    // NVDEC decoders belong to a device and output mode; CPU decoders to an offload
+    return hardware ? current.cudaDeviceId == config.cudaDeviceId && current.memoryPool == config.memoryPool &&
+                          current.zeroCopyOutput == config.zeroCopyOutput
+                    : current.hwAccel == config.hwAccel;
+}
+
+std::unique_ptr<IDecoder> DecoderPool::acquire(DecoderType type, const DecoderConfig& config) {
+    // Parked CPU decoders carry the offload the factory resolved for them
+    DecoderConfig resolved = config;
+    if (resolved.hwAccel == HwAccel::AUTO) {
+        resolved.hwAccel = DecoderFactory::getCpuHwAccel(config.codec);
+    }
+
+    std::vector<std::unique_ptr<IDecoder>> discarded;
+    std::vector<const IDecoder*> refused;   // Rebind failed this time: left parked, not tried again
+    while (true) {
+        std::unique_ptr<IDecoder> candidate;
+        std::chrono::steady_clock::time_point since;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            takeExpired(discarded);
+
+            // Most recently parked first, same quality tier preferred
+            auto best = idle_.end();
+            for (auto it = idle_.end(); it != idle_.begin();) {
+                --it;
+                if (!matches(*it->decoder, type, resolved) ||
+                    std::find(refused.begin(), refused.end(), it->decoder.get()) != refused.end()) {
+                    continue;
+                }
+                if (best == idle_.end()) {
+                    best = it;
+                }
+                if (it->decoder->getConfig().quality == resolved.quality) {
+                    best = it;
+                    break;
+                }
+            }
+
+            if (best == idle_.end()) {
+                stats_.created++;
+                break;
+            }
+
+            candidate = std::move(best->decoder);
+            since = best->since;
+            idle_.erase(best);
+        }
+
+        if (candidate->rebind(resolved)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stats_.reused++;
+            return candidate;
+        }
+
+        // Refused for now (e.g. the CPU budget is spent), not broken: it goes
+        // back where it was and ages out as usual
+        candidate->park();
+        refused.push_back(candidate.get());
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto slot = std::find_if(idle_.begin(), idle_.end(), [since](const Idle& idle) {
+            return idle.since > since;
+        });
+        idle_.insert(slot, Idle{std::move(candidate), since});
+    }
+
+    discarded.clear();
+    return DecoderFactory::create(type, config);
+}
+
+void DecoderPool::release(std::unique_ptr<IDecoder> decoder) {
+    if (!decoder) {
+        return;
+    }
+
+    decoder->park();
+
+    std::vector<std::unique_ptr<IDecoder>> discarded;
+    std::lock_guard<std::mutex> lock(mutex_);
+    takeExpired(discarded);
+
+    if (capacity_ == 0) {
+        discarded.push_back(std::move(decoder));
+        return;
+    }
+
+    if (idle_.size() >= capacity_) {
+        discarded.push_back(std::move(idle_.front().decoder));
+        idle_.erase(idle_.begin());
+        stats_.evicted++;
+    }
+
+    idle_.push_back(Idle{std::move(decoder), std::chrono::steady_clock::now()});
+    stats_.parked++;
+}
+
+void DecoderPool::clear() {
+    std::vector<Idle> idle;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle.swap(idle_);
+    }
+
+    if (!idle.empty()) {
+        std::cout << "DecoderPool: destroying " << idle.size() << " idle decoders" << std::endl;
+    }
+}
+
+DecoderPool::Stats DecoderPool::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.idle = idle_.size();
+    return stats;
+}
+
+void DecoderPool::takeExpired(std::vector<std::unique_ptr<IDecoder>>& expired) {
+    const auto cutoff = std::chrono::steady_clock::now() - maxIdleAge_;
+    while (!idle_.empty() && idle_.front().since < cutoff) {
+        expired.push_back(std::move(idle_.front().decoder));
+        idle_.erase(idle_.begin());
+        stats_.evicted++;
+    }
+}
+
+} // namespace fluxvision
@@ -0,0 +1,75 @@
+// src/core/codec/decoder_pool.h
+// Idle initialized decoders, reused across reconnects and camera churn
+#pragma once
+
+#include "decoder_factory.h"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace fluxvision {
+
+// Process-wide pool of parked decoders
+//
+// Creating an NVDEC decoder (parser, cuvidCreateDecoder, surfaces) takes tens
+// of ms and synchronizes the driver; a CpuDecoder spins up its frame threads.
+// Cameras that reconnect or restart give their decoder back here instead of
+// destroying it, and the next camera asking for the same decoder type, codec,
+// maximum resolution and device gets it rebound (same quality tier
+// preferred). Parked NVDEC decoders keep their hardware decoder but return
+// their output surfaces to the memory pool; parked CPU decoders return their
+// threads to the CpuDecodeBudget. Decoders idle for longer than the maximum
+// age, or beyond the capacity, are destroyed.
+//
+// Thread-safety: all methods may be called from any thread
+class DecoderPool {
+public:
+    struct Stats {
+        size_t idle = 0;
+        uint64_t reused = 0;       // acquire() served from the pool
+        uint64_t created = 0;      // acquire() had to create a decoder
+        uint64_t parked = 0;       // release() kept the decoder
+        uint64_t evicted = 0;      // Destroyed for capacity or age
+    };
+
+    static DecoderPool& instance();
+
+    // Idle decoders kept (0 = no pooling; existing idle decoders are destroyed)
+    void setCapacity(size_t decoders);
+    void setMaxIdleAge(std::chrono::seconds age);
+
+    // A parked decoder matching the config, rebound to it, else a new one from
+    // DecoderFactory (nullptr if that fails too)
+    std::unique_ptr<IDecoder> acquire(DecoderType type, const DecoderConfig& config);
+
+    // Park a decoder the camera is done with (nullptr is ignored)
+    void release(std::unique_ptr<IDecoder> decoder);
+
+    // Destroy every idle decoder (before the CUDA contexts and memory pools go)
+    void clear();
+
+    Stats getStats() const;
+
+private:
+    DecoderPool() = default;
+
+    struct Idle {
+        std::unique_ptr<IDecoder> decoder;
+        std::chrono::steady_clock::time_point since;
+    };
+
+    static bool matches(const IDecoder& decoder, DecoderType type, const DecoderConfig& config);
+
+    // Hand back what has been idle too long; mutex_ held
+    void takeExpired(std::vector<std::unique_ptr<IDecoder>>& expired);
+
+    mutable std::mutex mutex_;
+    std::vector<Idle> idle_;   // Oldest first
+    size_t capacity_ = 16;
+    std::chrono::seconds maxIdleAge_{300};
+    Stats stats_;
+};
+
+} // namespace fluxvision
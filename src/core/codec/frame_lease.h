@@ -0,0 +1,92 @@
+// src/core/codec/frame_lease.h
+// Decoded frame ownership: move-only leases and shared, refcounted frame handles
+#pragma once
+
+#include "types.h"
+#include <cstdint>
+#include <memory>
+
+namespace fluxvision {
+
+// Lease on one decoded frame
+//
+// Owns one pooled decoder resource (an output surface, a mapped NVDEC frame or
+// an AVFrame reference) and gives it back to its owner exactly once, when the
+// lease is destroyed, reset or release()d, from any thread. Owners are shared
+// with their leases, so releasing after the decoder is gone is safe.
+class FrameLease {
+public:
+    // Takes back leased resources (implemented by decoders)
+    class Owner {
+    public:
+        virtual ~Owner() = default;
+        virtual void releaseLease(uint64_t token) = 0;
+    };
+
+    FrameLease() = default;
+
+    // owner->releaseLease(token) is called exactly once on release
+    FrameLease(const DecodedFrame& frame, std::shared_ptr<Owner> owner, uint64_t token)
+        : frame_(frame), owner_(std::move(owner)), token_(token) {}
+
+    ~FrameLease() { release(); }
+
+    FrameLease(const FrameLease&) = delete;
+    FrameLease& operator=(const FrameLease&) = delete;
+
+    FrameLease(FrameLease&& other) noexcept { moveFrom(other); }
+
+    FrameLease& operator=(FrameLease&& other) noexcept {
+        if (this != &other) {
+            release();
+            moveFrom(other);
+        }
+        return *this;
+    }
+
+    const DecodedFrame* get() const { return owner_ ? &frame_ : nullptr; }
+    const DecodedFrame* operator->() const { return &frame_; }
+    const DecodedFrame& operator*() const { return frame_; }
+    explicit operator bool() const { return owner_ != nullptr; }
+
+    // Give the frame back now
+    void release() noexcept {
+        if (owner_) {
+            owner_->releaseLease(token_);
+            owner_.reset();
+        }
+        token_ = 0;
+    }
+
+private:
+    DecodedFrame frame_{};          // Leases carry their own copy of the metadata
+    std::shared_ptr<Owner> owner_;
+    uint64_t token_ = 0;
+
+    void moveFrom(FrameLease& other) noexcept {
+        frame_ = other.frame_;
+        owner_ = std::move(other.owner_);
+        token_ = other.token_;
+        other.token_ = 0;
+    }
+};
+
+// Shared handle to a decoded frame
+//
+// Copies are cheap and may be handed to any number of consumers (display,
+// recording, analytics) on any thread; the frame goes back to its decoder's
+// pool when the last copy is dropped. The pixels are read-only.
+using FrameHandle = std::shared_ptr<const DecodedFrame>;
+
+// Turn a lease into a shared handle (empty lease -> empty handle)
+inline FrameHandle makeFrameHandle(FrameLease&& lease) {
+    if (!lease) {
+        return nullptr;
+    }
+
+    auto holder = std::make_shared<FrameLease>(std::move(lease));
+    const DecodedFrame* frame = holder->get();
+    return FrameHandle(std::move(holder), frame);
+}
+
+} // namespace fluxvision
@@ -0,0 +1,433 @@
+// src/core/codec/jpeg_encoder.cpp
+#include "jpeg_encoder.h"
+#include "../gpu/cuda_context.h"
+#include "../gpu/frame_converter.h"
+#include <algorithm>
+#include <array>
+#include <iostream>
+
+namespace fluxvision {
+
+namespace {
+    // Studio swing (16-235 luma, 16-240 chroma) to the full range JFIF expects
+    struct RangeTables {
+        std::array<uint8_t, 256> luma;
+        std::array<uint8_t, 256> chroma;
+
+        RangeTables() {
+            for (int v = 0; v < 256; ++v) {
+                luma[v] = static_cast<uint8_t>(std::clamp((v - 16) * 255 / 219, 0, 255));
+                chroma[v] = static_cast<uint8_t>(std::clamp((v - 128) * 255 / 224 + 128, 0, 255));
+            }
+        }
+    };
+
+    const RangeTables& rangeTables() {
+        static const RangeTables tables;
+        return tables;
+    }
+
+    // Area-average one plane (step: bytes between samples, 2 for NV12 chroma)
+    void boxScale(const uint8_t* src, int srcPitch, int step, int srcWidth, int srcHeight,
+                  uint8_t* dst, int dstPitch, int dstWidth, int dstHeight, const uint8_t* table) {
+        for (int y = 0; y < dstHeight; ++y) {
+            const int y0 = y * srcHeight / dstHeight;
+            const int y1 = std::max(y0 + 1, (y + 1) * srcHeight / dstHeight);
+
+            for (int x = 0; x < dstWidth; ++x) {
+                const int x0 = x * srcWidth / dstWidth;
+                const int x1 = std::max(x0 + 1, (x + 1) * srcWidth / dstWidth);
+
+                uint32_t sum = 0;
+                for (int sy = y0; sy < y1; ++sy) {
+                    const uint8_t* row = src + sy * srcPitch;
+                    for (int sx = x0; sx < x1; ++sx) {
+                        sum += row[sx * step];
+                    }
+                }
+                const uint32_t count = static_cast<uint32_t>((y1 - y0) * (x1 - x0));
+                dst[y * dstPitch + x] = table[(sum + count / 2) / count];
+            }
+        }
+    }
+}
+
+JpegEncoder::JpegEncoder(const Config& config)
+    : config_(config)
+{
+    config_.quality = std::clamp(config_.quality, 1, 100);
+}
+
+JpegEncoder::~JpegEncoder() {
+    closeCodec();
+    av_packet_free(&packet_);
+
+#if defined(HAVE_NVJPEG) && defined(HAVE_CUDA_KERNELS)
+    destroyHardware();
+#endif
+}
+
+bool JpegEncoder::initialize() {
+    if (codec_) {
+        return true;
+    }
+
+    codec_ = avcodec_find_encoder(AV_CODEC_ID_MJPEG);
+    packet_ = av_packet_alloc();
+    if (!codec_ || !packet_) {
+        std::cerr << "JpegEncoder: MJPEG encoder not available" << std::endl;
+        codec_ = nullptr;
+        return false;
+    }
+
+#if defined(HAVE_NVJPEG) && defined(HAVE_CUDA_KERNELS)
+    if (config_.preferHardware) {
+        hardwareReady_ = initializeHardware();
+        if (!hardwareReady_) {
+            std::cerr << "JpegEncoder: nvJPEG unavailable, encoding on the CPU" << std::endl;
+            destroyHardware();
+        }
+    }
+#endif
+
+    return true;
+}
+
+size_t JpegEncoder::encode(const std::vector<FrameHandle>& frames, std::vector<JpegImage>& images) {
+    images.assign(frames.size(), JpegImage{});
+    if (!codec_) {
+        return 0;
+    }
+
+    size_t encoded = 0;
+
+#if defined(HAVE_NVJPEG) && defined(HAVE_CUDA_KERNELS)
+    // Device frames: scale and convert the whole batch in one launch, then compress each
+    if (hardwareReady_) {
+        size_t submitted = 0;
+        for (size_t i = 0; i < frames.size(); ++i) {
+            if (!frames[i] || !frames[i]->cudaSurface) {
+                continue;
+            }
+
+            gpu::FrameConverter::Request request;
+            request.format = PixelFormat::BGR;
+            fitSize(frames[i]->width, frames[i]->height, request.width, request.height);
+            submitted += converter_->submit(i, frames[i], request) ? 1 : 0;
+        }
+
+        std::vector<gpu::FrameConverter::Result> results;
+        while (submitted > 0 && converter_->getStats().pending > 0) {
+            converter_->flush(results);
+            if (results.empty()) {
+                break;  // Launch failed: the CPU path below takes these frames
+            }
+
+            for (const auto& result : results) {
+                JpegImage& image = images[result.tag];
+                if (encodeGpu(*result.frame, image)) {
+                    image.pts = frames[result.tag]->pts;
+                    encoded++;
+                }
+            }
+        }
+        converter_->trim();
+    }
+#endif
+
+    // Host frames, and anything the GPU didn't take
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (frames[i] && images[i].data.empty() && encodeCpu(*frames[i], images[i])) {
+            images[i].pts = frames[i]->pts;
+            encoded++;
+        }
+    }
+
+    return encoded;
+}
+
+void JpegEncoder::fitSize(uint32_t width, uint32_t height, uint32_t& outWidth, uint32_t& outHeight) const {
+    outWidth = width;
+    outHeight = height;
+
+    if (config_.maxWidth > 0 && outWidth > config_.maxWidth) {
+        outHeight = static_cast<uint32_t>(static_cast<uint64_t>(outHeight) * config_.maxWidth / outWidth);
+        outWidth = config_.maxWidth;
+    }
+    if (config_.maxHeight > 0 && outHeight > config_.maxHeight) {
+        outWidth = static_cast<uint32_t>(static_cast<uint64_t>(outWidth) * config_.maxHeight / outHeight);
+        outHeight = config_.maxHeight;
+    }
+
+    // 4:2:0 output: even dimensions
+    outWidth = std::max(2u, outWidth & ~1u);
+    outHeight = std::max(2u, outHeight & ~1u);
+}
+
+bool JpegEncoder::encodeCpu(const DecodedFrame& frame, JpegImage& image) {
+    DecodedFrame source = frame;
+    if (frame.cudaSurface && !downloadFrame(frame, source)) {
+        return false;
+    }
+    if ((source.format != PixelFormat::YUV420P && source.format != PixelFormat::NV12) ||
+        !source.data[0] || !source.data[1] || source.width < 2 || source.height < 2) {
+        return false;
+    }
+
+    uint32_t width = 0;
+    uint32_t height = 0;
+    fitSize(source.width, source.height, width, height);
+    if (!openCodec(width, height) || av_frame_make_writable(scaled_) < 0) {
+        return false;
+    }
+
+    // Downscale into the encoder's frame, expanding to full range on the way
+    const RangeTables& tables = rangeTables();
+    const int srcWidth = static_cast<int>(source.width);
+    const int srcHeight = static_cast<int>(source.height);
+    const int chromaWidth = (srcWidth + 1) / 2;
+    const int chromaHeight = (srcHeight + 1) / 2;
+    const int dstWidth = static_cast<int>(width);
+    const int dstHeight = static_cast<int>(height);
+
+    boxScale(source.data[0], source.pitch[0], 1, srcWidth, srcHeight,
+             scaled_->data[0], scaled_->linesize[0], dstWidth, dstHeight, tables.luma.data());
+
+    const bool interleaved = source.format == PixelFormat::NV12;
+    const uint8_t* cb = source.data[1];
+    const uint8_t* cr = interleaved ? source.data[1] + 1 : source.data[2];
+    const int cbPitch = source.pitch[1];
+    const int crPitch = interleaved ? source.pitch[1] : source.pitch[2];
+    if (!cr) {
+        return false;
+    }
+
+    const int step = interleaved ? 2 : 1;
+    boxScale(cb, cbPitch, step, chromaWidth, chromaHeight,
+             scaled_->data[1], scaled_->linesize[1], dstWidth / 2, dstHeight / 2, tables.chroma.data());
+    boxScale(cr, crPitch, step, chromaWidth, chromaHeight,
+             scaled_->data[2], scaled_->linesize[2], dstWidth / 2, dstHeight / 2, tables.chroma.data());
+
+    scaled_->quality = codecCtx_->global_quality;
+    scaled_->pts++;
+
+    if (avcodec_send_frame(codecCtx_, scaled_) < 0 || avcodec_receive_packet(codecCtx_, packet_) < 0) {
+        std::cerr << "JpegEncoder: MJPEG encode failed" << std::endl;
+        return false;
+    }
+
+    image.data.assign(packet_->data, packet_->data + packet_->size);
+    image.width = width;
+    image.height = height;
+    image.hardware = false;
+    av_packet_unref(packet_);
+    return true;
+}
+
+bool JpegEncoder::openCodec(uint32_t width, uint32_t height) {
+    if (codecCtx_ && codecCtx_->width == static_cast<int>(width) &&
+        codecCtx_->height == static_cast<int>(height)) {
+        return true;
+    }
+    closeCodec();
+
+    codecCtx_ = avcodec_alloc_context3(codec_);
+    scaled_ = av_frame_alloc();
+    if (!codecCtx_ || !scaled_) {
+        closeCodec();
+        return false;
+    }
+
+    // Fixed quantizer: quality 100 -> qscale 2, quality 1 -> qscale 31
+    const int qscale = 2 + (100 - config_.quality) * 29 / 99;
+    codecCtx_->width = static_cast<int>(width);
+    codecCtx_->height = static_cast<int>(height);
+    codecCtx_->pix_fmt = AV_PIX_FMT_YUVJ420P;
+    codecCtx_->time_base = AVRational{1, 25};
+    codecCtx_->flags |= AV_CODEC_FLAG_QSCALE;
+    codecCtx_->global_quality = FF_QP2LAMBDA * qscale;
+    codecCtx_->qmin = qscale;
+    codecCtx_->qmax = qscale;
+
+    if (avcodec_open2(codecCtx_, codec_, nullptr) < 0) {
+        std::cerr << "JpegEncoder: failed to open MJPEG encoder at " << width << "x" << height << std::endl;
+        closeCodec();
+        return false;
+    }
+
+    scaled_->width = codecCtx_->width;
+    scaled_->height = codecCtx_->height;
+    scaled_->format = AV_PIX_FMT_YUVJ420P;
+    scaled_->pts = 0;
+    if (av_frame_get_buffer(scaled_, 32) < 0) {
+        closeCodec();
+        return false;
+    }
+
+    return true;
+}
+
+void JpegEncoder::closeCodec() {
+    avcodec_free_context(&codecCtx_);
+    av_frame_free(&scaled_);
+}
+
+bool JpegEncoder::downloadFrame(const DecodedFrame& frame, DecodedFrame& host) {
+#ifdef HAVE_CUDA
+    if (frame.format != PixelFormat::NV12 || !frame.data[0] || !frame.data[1]) {
+        return false;
+    }
+
+    CudaContext& cuda = CudaContext::getInstance(config_.cudaDeviceId);
+    if (!cuda.initialize()) {
+        return false;
+    }
+
+    // Tightly packed NV12: Y rows then UV rows
+    const size_t width = frame.width;
+    const size_t lumaRows = frame.height;
+    const size_t chromaRows = (frame.height + 1) / 2;
+    download_.resize(width * (lumaRows + chromaRows));
+
+    CUDA_MEMCPY2D copy = {};
+    copy.srcMemoryType = CU_MEMORYTYPE_DEVICE;
+    copy.srcPitch = static_cast<size_t>(frame.pitch[0]);
+    copy.dstMemoryType = CU_MEMORYTYPE_HOST;
+    copy.dstPitch = width;
+    copy.WidthInBytes = width;
+
+    cuCtxPushCurrent(cuda.getContext());
+    copy.srcDevice = reinterpret_cast<CUdeviceptr>(frame.data[0]);
+    copy.dstHost = download_.data();
+    copy.Height = lumaRows;
+    CUresult result = cuMemcpy2D(&copy);
+    if (result == CUDA_SUCCESS) {
+        copy.srcDevice = reinterpret_cast<CUdeviceptr>(frame.data[1]);
+        copy.srcPitch = static_cast<size_t>(frame.pitch[1]);
+        copy.dstHost = download_.data() + width * lumaRows;
+        copy.Height = chromaRows;
+        result = cuMemcpy2D(&copy);
+    }
+    cuCtxPopCurrent(nullptr);
+
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "JpegEncoder: frame download failed: " << result << std::endl;
+        return false;
+    }
+
+    host = frame;
+    host.data[0] = download_.data();
+    host.data[1] = download_.data() + width * lumaRows;
+    host.data[2] = nullptr;
+    host.pitch[0] = static_cast<int>(width);
+    host.pitch[1] = static_cast<int>(width);
+    host.pitch[2] = 0;
+    host.cudaSurface = nullptr;
+    host.cudaPitch = 0;
+    return true;
+#else
+    (void)frame;
+    (void)host;
+    return false;
+#endif
+}
+
+#if defined(HAVE_NVJPEG) && defined(HAVE_CUDA_KERNELS)
+bool JpegEncoder::initializeHardware() {
+    CudaContext& cuda = CudaContext::getInstance(config_.cudaDeviceId);
+    if (!cuda.initialize()) {
+        return false;
+    }
+    context_ = cuda.getContext();
+
+    cuCtxPushCurrent(context_);
+
+    bool ok = cuStreamCreate(&stream_, CU_STREAM_NON_BLOCKING) == CUDA_SUCCESS;
+
+    if (ok) {
+        converter_ = std::make_shared<gpu::FrameConverter>(gpu::FrameConverter::Config{});
+        ok = converter_->initialize();
+    }
+
+    const cudaStream_t stream = static_cast<cudaStream_t>(stream_);
+    ok = ok && nvjpegCreateSimple(&nvjpeg_) == NVJPEG_STATUS_SUCCESS;
+    ok = ok && nvjpegEncoderStateCreate(nvjpeg_, &encoderState_, stream) == NVJPEG_STATUS_SUCCESS;
+    ok = ok && nvjpegEncoderParamsCreate(nvjpeg_, &encoderParams_, stream) == NVJPEG_STATUS_SUCCESS;
+    ok = ok && nvjpegEncoderParamsSetQuality(encoderParams_, config_.quality, stream) == NVJPEG_STATUS_SUCCESS;
+    ok = ok && nvjpegEncoderParamsSetSamplingFactors(encoderParams_, NVJPEG_CSS_420, stream) ==
+                   NVJPEG_STATUS_SUCCESS;
+
+    cuCtxPopCurrent(nullptr);
+    return ok;
+}
+
+void JpegEncoder::destroyHardware() {
+    if (!context_) {
+        return;
+    }
+
+    cuCtxPushCurrent(context_);
+    if (encoderParams_) {
+        nvjpegEncoderParamsDestroy(encoderParams_);
+        encoderParams_ = nullptr;
+    }
+    if (encoderState_) {
+        nvjpegEncoderStateDestroy(encoderState_);
+        encoderState_ = nullptr;
+    }
+    if (nvjpeg_) {
+        nvjpegDestroy(nvjpeg_);
+        nvjpeg_ = nullptr;
+    }
+    converter_.reset();
+    if (stream_) {
+        cuStreamDestroy(stream_);
+        stream_ = nullptr;
+    }
+    cuCtxPopCurrent(nullptr);
+
+    context_ = nullptr;
+    hardwareReady_ = false;
+}
+
+bool JpegEncoder::encodeGpu(const DecodedFrame& bgr, JpegImage& image) {
+    const cudaStream_t stream = static_cast<cudaStream_t>(stream_);
+
+    nvjpegImage_t source = {};
+    source.channel[0] = bgr.data[0];
+    source.pitch[0] = static_cast<size_t>(bgr.pitch[0]);
+
+    cuCtxPushCurrent(context_);
+
+    size_t length = 0;
+    nvjpegStatus_t status = nvjpegEncodeImage(nvjpeg_, encoderState_, encoderParams_, &source,
+                                              NVJPEG_INPUT_BGRI, static_cast<int>(bgr.width),
+                                              static_cast<int>(bgr.height), stream);
+    if (status == NVJPEG_STATUS_SUCCESS) {
+        status = nvjpegEncodeRetrieveBitstream(nvjpeg_, encoderState_, nullptr, &length, stream);
+    }
+    bool ok = status == NVJPEG_STATUS_SUCCESS && cuStreamSynchronize(stream_) == CUDA_SUCCESS;
+
+    if (ok) {
+        image.data.resize(length);
+        ok = nvjpegEncodeRetrieveBitstream(nvjpeg_, encoderState_, image.data.data(), &length, stream) ==
+                 NVJPEG_STATUS_SUCCESS &&
+             cuStreamSynchronize(stream_) == CUDA_SUCCESS;
+        image.data.resize(ok ? length : 0);
+    }
+
+    cuCtxPopCurrent(nullptr);
+
+    if (!ok) {
+        std::cerr << "JpegEncoder: nvJPEG encode failed (status " << status << ")" << std::endl;
+        return false;
+    }
+
+    image.width = bgr.width;
+    image.height = bgr.height;
+    image.hardware = true;
+    return true;
+}
+#endif
+
+} // namespace fluxvision
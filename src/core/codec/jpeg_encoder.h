@@ -0,0 +1,108 @@
+// src/core/codec/jpeg_encoder.h
+// Still-image JPEG encoder: nvJPEG from NVDEC surfaces, libavcodec MJPEG for CPU frames
+#pragma once
+
+#include "frame_lease.h"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+}
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#endif
+
+#if defined(HAVE_NVJPEG) && defined(HAVE_CUDA_KERNELS)
+#include <nvjpeg.h>
+#endif
+
+namespace fluxvision {
+
+namespace gpu {
+class FrameConverter;
+}
+
+// One encoded still
+struct JpegImage {
+    std::vector<uint8_t> data;   // Complete JFIF file
+    uint32_t width = 0;          // Encoded size (after downscaling)
+    uint32_t height = 0;
+    int64_t pts = 0;             // Of the source frame
+    bool hardware = false;       // nvJPEG (false: CPU)
+};
+
+// JPEG encoder for decoded frames
+//
+// Device frames (NVDEC) are scaled and converted to BGR by a gpu::FrameConverter
+// (the whole batch in one launch) and compressed by nvJPEG, so only the JPEG
+// crosses PCIe. Host frames (CpuDecoder), and device frames when nvJPEG is
+// unavailable, are box-filtered on the CPU and compressed by libavcodec's MJPEG
+// encoder.
+//
+// Output is fitted inside maxWidth x maxHeight (aspect kept, never upscaled).
+//
+// Thread-safety: Not thread-safe (one caller at a time)
+class JpegEncoder {
+public:
+    struct Config {
+        int quality = 80;            // 1-100
+        uint32_t maxWidth = 0;       // 0 = source size
+        uint32_t maxHeight = 0;
+        bool preferHardware = true;  // nvJPEG for device frames when available
+        int cudaDeviceId = 0;        // Device the NVDEC frames live on
+    };
+
+    explicit JpegEncoder(const Config& config);
+    ~JpegEncoder();
+
+    // Delete copy/move
+    JpegEncoder(const JpegEncoder&) = delete;
+    JpegEncoder& operator=(const JpegEncoder&) = delete;
+
+    // Set up the CPU encoder, and the GPU path if possible (its failure isn't fatal)
+    bool initialize();
+
+    bool isHardwareAvailable() const { return hardwareReady_; }
+
+    // Encode frames[i] into images[i] (images resized to match)
+    // Returns: number encoded; a frame that fails leaves an empty image
+    size_t encode(const std::vector<FrameHandle>& frames, std::vector<JpegImage>& images);
+
+    // Output size for a source frame
+    void fitSize(uint32_t width, uint32_t height, uint32_t& outWidth, uint32_t& outHeight) const;
+
+private:
+    Config config_;
+    bool hardwareReady_ = false;
+
+    // CPU path: MJPEG context, reopened when the output size changes
+    const AVCodec* codec_ = nullptr;
+    AVCodecContext* codecCtx_ = nullptr;
+    AVFrame* scaled_ = nullptr;       // YUVJ420P at the output size
+    AVPacket* packet_ = nullptr;
+    std::vector<uint8_t> download_;   // Device frames without nvJPEG: NV12 copied to host
+
+    bool encodeCpu(const DecodedFrame& frame, JpegImage& image);
+    bool openCodec(uint32_t width, uint32_t height);
+    void closeCodec();
+    bool downloadFrame(const DecodedFrame& frame, DecodedFrame& host);
+
+#if defined(HAVE_NVJPEG) && defined(HAVE_CUDA_KERNELS)
+    // GPU path
+    CUcontext context_ = nullptr;
+    CUstream stream_ = nullptr;
+    std::shared_ptr<gpu::FrameConverter> converter_;
+    nvjpegHandle_t nvjpeg_ = nullptr;
+    nvjpegEncoderState_t encoderState_ = nullptr;
+    nvjpegEncoderParams_t encoderParams_ = nullptr;
+
+    bool initializeHardware();
+    void destroyHardware();
+    bool encodeGpu(const DecodedFrame& bgr, JpegImage& image);
+#endif
+};
+
+} // namespace fluxvision
@@ -2,6 +2,8 @@
 // NVIDIA NVDEC hardware decoder implementation
 #include "nvdec_decoder.h"
 #include "../gpu/cuda_context.h"
+#include <algorithm>
+#include <chrono>
 #include <cstring>
 #include <iostream>
 
@@ -11,7 +13,6 @@ NvdecDecoder::NvdecDecoder()
     : cudaContext_(nullptr)
     , parser_(nullptr)
     , decoder_(nullptr)
-    , totalMemoryAllocated_(0)
     , framesDecoded_(0)
     , initialized_(false)
 {
@@ -23,6 +24,7 @@ NvdecDecoder::~NvdecDecoder() {
     destroyDecoder();
     destroyParser();
     freeSurfaces();
+    surfacePool_.reset();  // Freed for good once the last frame handle is dropped
 }
 
 bool NvdecDecoder::initialize(const DecoderConfig& config) {
@@ -32,8 +34,8 @@ bool NvdecDecoder::initialize(const DecoderConfig& config) {
 
     config_ = config;
 
-    // Get CUDA context from singleton
-    auto& cudaCtx = CudaContext::getInstance();
+    // Shared context of the decoder's device
+    auto& cudaCtx = CudaContext::getInstance(config_.cudaDeviceId);
     if (!cudaCtx.isInitialized() && !cudaCtx.initialize()) {
         std::cerr << "NvdecDecoder: Failed to initialize CUDA context" << std::endl;
         return false;
@@ -41,6 +43,7 @@ bool NvdecDecoder::initialize(const DecoderConfig& config) {
 
 #ifdef HAVE_CUDA
     cudaContext_ = cudaCtx.getContext();
+    surfacePool_ = std::make_shared<SurfacePool>(cudaContext_, config_.memoryPool, config_.cameraId);
 
     // Set CUDA context as current
     CUresult cuResult = cuCtxPushCurrent(cudaContext_);
@@ -102,11 +105,13 @@ bool NvdecDecoder::createDecoder(CUVIDEOFORMAT* format) {
 
     decoderInfo_.ulWidth = format->coded_width;
     decoderInfo_.ulHeight = format->coded_height;
-    decoderInfo_.ulMaxWidth = config_.maxWidth;
-    decoderInfo_.ulMaxHeight = config_.maxHeight;
 
-    decoderInfo_.ulNumDecodeSurfaces = static_cast<unsigned long>(getSurfacePoolSize(config_.quality));
-    decoderInfo_.ulNumOutputSurfaces = 2;  // Double buffering for display
+    // Max size bounds later in-place reconfigures (e.g. sub -> main stream switch)
+    decoderInfo_.ulMaxWidth = std::max<unsigned long>(config_.maxWidth, format->coded_width);
+    decoderInfo_.ulMaxHeight = std::max<unsigned long>(config_.maxHeight, format->coded_height);
+
+    decoderInfo_.ulNumDecodeSurfaces = decodeSurfaceCount(format);
+    decoderInfo_.ulNumOutputSurfaces = static_cast<unsigned long>(getOutputSurfaceCount(config_.quality));
     decoderInfo_.ulCreationFlags = cudaVideoCreate_PreferCUVID;
     decoderInfo_.ulIntraDecodeOnly = 0;
 
@@ -127,6 +132,11 @@ bool NvdecDecoder::createDecoder(CUVIDEOFORMAT* format) {
         return false;
     }
 
+    // Zero-copy leases may hold all output surfaces but one (kept for the copy fallback).
+    // The count is fixed at creation: cuvidReconfigureDecoder can't change it.
+    const size_t leaseLimit = config_.zeroCopyOutput ? decoderInfo_.ulNumOutputSurfaces - 1 : 0;
+    mappedFrames_ = std::make_shared<MappedFrames>(decoder_, cudaContext_, leaseLimit);
+
     // Allocate output surfaces
     if (!allocateSurfaces()) {
         destroyDecoder();
@@ -139,50 +149,220 @@ bool NvdecDecoder::createDecoder(CUVIDEOFORMAT* format) {
 #endif
 }
 
-bool NvdecDecoder::allocateSurfaces() {
+bool NvdecDecoder::reconfigureDecoder(CUVIDEOFORMAT* format) {
 #ifdef HAVE_CUDA
-    size_t numSurfaces = getSurfacePoolSize(config_.quality);
-    surfaces_.resize(numSurfaces);
-
-    size_t surfaceHeight = decoderInfo_.ulTargetHeight;
-    // NV12 format: Y plane + UV plane (half height)
-    size_t totalHeight = surfaceHeight + (surfaceHeight / 2);
-
-    for (size_t i = 0; i < numSurfaces; ++i) {
-        size_t pitch;
-        CUresult result = cuMemAllocPitch(&surfaces_[i].devicePtr, &pitch,
-                                          decoderInfo_.ulTargetWidth, totalHeight, 16);
-        if (result != CUDA_SUCCESS) {
-            std::cerr << "NvdecDecoder: Failed to allocate surface " << i << std::endl;
-            // Free already allocated surfaces
-            for (size_t j = 0; j < i; ++j) {
-                cuMemFree(surfaces_[j].devicePtr);
-            }
-            surfaces_.clear();
+    // Resize the existing decoder in place: no destroy/create, no parser reset
+    CUVIDRECONFIGUREDECODERINFO reconfigInfo = {};
+    reconfigInfo.ulWidth = format->coded_width;
+    reconfigInfo.ulHeight = format->coded_height;
+    reconfigInfo.ulTargetWidth = format->display_area.right - format->display_area.left;
+    reconfigInfo.ulTargetHeight = format->display_area.bottom - format->display_area.top;
+    reconfigInfo.ulNumDecodeSurfaces = decodeSurfaceCount(format);
+
+    reconfigInfo.display_area.left = 0;
+    reconfigInfo.display_area.top = 0;
+    reconfigInfo.display_area.right = static_cast<short>(format->display_area.right);
+    reconfigInfo.display_area.bottom = static_cast<short>(format->display_area.bottom);
+
+    CUresult result = cuvidReconfigureDecoder(decoder_, &reconfigInfo);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "NvdecDecoder: cuvidReconfigureDecoder failed: " << result << std::endl;
+        return false;
+    }
+
+    decoderInfo_.ulWidth = reconfigInfo.ulWidth;
+    decoderInfo_.ulHeight = reconfigInfo.ulHeight;
+    decoderInfo_.ulTargetWidth = reconfigInfo.ulTargetWidth;
+    decoderInfo_.ulTargetHeight = reconfigInfo.ulTargetHeight;
+    decoderInfo_.ulNumDecodeSurfaces = reconfigInfo.ulNumDecodeSurfaces;
+    decoderInfo_.display_area = reconfigInfo.display_area;
+
+    // Frames still queued were produced at the old geometry
+    std::lock_guard<std::mutex> lock(frameMutex_);
+    clearFrameQueue();
+
+    return allocateSurfaces();
+#else
+    (void)format;
+    return false;
+#endif
+}
+
+bool NvdecDecoder::canReconfigure(const CUVIDEOFORMAT* format) const {
+    // cuvidReconfigureDecoder only changes resolution and surface counts
+    return decoder_ &&
+           format->codec == decoderInfo_.CodecType &&
+           format->chroma_format == decoderInfo_.ChromaFormat &&
+           format->bit_depth_luma_minus8 == decoderInfo_.bitDepthMinus8 &&
+           format->coded_width <= decoderInfo_.ulMaxWidth &&
+           format->coded_height <= decoderInfo_.ulMaxHeight;
+}
+
+unsigned int NvdecDecoder::decodeSurfaceCount(const CUVIDEOFORMAT* format) const {
+    // Quality tier budget, but never below what the stream's DPB needs
+    unsigned int count = static_cast<unsigned int>(getSurfacePoolSize(config_.quality));
+    if (format && format->min_num_decode_surfaces > count) {
+        count = format->min_num_decode_surfaces;
+    }
+    return count;
+}
+
+bool NvdecDecoder::allocateSurfaces() {
+    // Resize the output pool in place: surfaces that are still large enough are kept
+    if (!surfacePool_) {
+        return false;
+    }
+
+    return surfacePool_->resize(getSurfacePoolSize(config_.quality),
+                                decoderInfo_.ulTargetWidth, decoderInfo_.ulTargetHeight);
+}
+
+void NvdecDecoder::freeSurfaces() {
+    // Surfaces held by frame handles are freed when they are released
+    if (surfacePool_) {
+        surfacePool_->resize(0, 0, 0);
+    }
+}
+
+NvdecDecoder::SurfacePool::~SurfacePool() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& surface : surfaces_) {
+        freeSurface(surface);
+    }
+    for (auto& surface : retired_) {
+        freeSurface(surface);
+    }
+}
+
+bool NvdecDecoder::SurfacePool::resize(size_t count, size_t width, size_t height) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Keep surfaces that still fit; surplus or undersized ones go, once released
+    std::vector<Surface> kept;
+    kept.reserve(count);
+    for (auto& surface : surfaces_) {
+        const bool fits = surface.memory.width >= width && surface.memory.height >= height;
+        if (fits && kept.size() < count) {
+            kept.push_back(surface);
+        } else if (surface.inUse) {
+            retired_.push_back(surface);
+        } else {
+            freeSurface(surface);
+        }
+    }
+    surfaces_ = std::move(kept);
+
+    while (surfaces_.size() < count) {
+        Surface surface;
+        if (!allocateSurface(width, height, surface)) {
+            std::cerr << "NvdecDecoder: Failed to allocate surface " << surfaces_.size() << std::endl;
             return false;
         }
 
-        surfaces_[i].pitch = pitch;
-        surfaces_[i].inUse = false;
-        totalMemoryAllocated_ += pitch * totalHeight;
+        surface.id = nextId_++;
+        bytes_ += surface.memory.bytes;
+        surfaces_.push_back(surface);
     }
 
     return true;
+}
+
+bool NvdecDecoder::SurfacePool::acquire(uint64_t& id, CUdeviceptr& devicePtr, size_t& pitch) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& surface : surfaces_) {
+        if (!surface.inUse) {
+            surface.inUse = true;
+            id = surface.id;
+            devicePtr = static_cast<CUdeviceptr>(surface.memory.devicePtr);
+            pitch = surface.memory.pitch;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void NvdecDecoder::SurfacePool::releaseLease(uint64_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto& surface : surfaces_) {
+        if (surface.id == id) {
+            surface.inUse = false;
+            return;
+        }
+    }
+
+    // Dropped from the pool while held: free it now (may run on any consumer thread)
+    for (auto it = retired_.begin(); it != retired_.end(); ++it) {
+        if (it->id == id) {
+            freeSurface(*it);
+            retired_.erase(it);
+            return;
+        }
+    }
+}
+
+size_t NvdecDecoder::SurfacePool::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return surfaces_.size();
+}
+
+size_t NvdecDecoder::SurfacePool::bytesAllocated() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return bytes_;
+}
+
+bool NvdecDecoder::SurfacePool::allocateSurface(size_t width, size_t height, Surface& surface) {
+#ifdef HAVE_CUDA
+    // Callers may already have the context current; pushing again is harmless
+    cuCtxPushCurrent(context_);
+
+    bool ok = false;
+    if (memoryPool_) {
+        ok = memoryPool_->allocateSurface(cameraId_, width, height, surface.memory);
+    } else {
+        // NV12 format: Y plane + UV plane (half height)
+        const size_t totalHeight = height + (height / 2);
+        CUdeviceptr devicePtr = 0;
+        size_t pitch = 0;
+        ok = cuMemAllocPitch(&devicePtr, &pitch, width, totalHeight, 16) == CUDA_SUCCESS;
+        if (ok) {
+            surface.memory.devicePtr = static_cast<uint64_t>(devicePtr);
+            surface.memory.pitch = pitch;
+            surface.memory.width = width;
+            surface.memory.height = height;
+            surface.memory.bytes = pitch * totalHeight;
+        }
+    }
+
+    cuCtxPopCurrent(nullptr);
+    return ok;
 #else
+    (void)width;
+    (void)height;
+    (void)surface;
     return false;
 #endif
 }
 
-void NvdecDecoder::freeSurfaces() {
+void NvdecDecoder::SurfacePool::freeSurface(Surface& surface) {
+    if (surface.memory.devicePtr) {
+        bytes_ -= surface.memory.bytes;
+
+        if (memoryPool_) {
+            // Back to its size class for the next camera
+            memoryPool_->releaseSurface(cameraId_, surface.memory);
+        } else {
 #ifdef HAVE_CUDA
-    for (auto& surface : surfaces_) {
-        if (surface.devicePtr) {
-            cuMemFree(surface.devicePtr);
+            cuCtxPushCurrent(context_);
+            cuMemFree(static_cast<CUdeviceptr>(surface.memory.devicePtr));
+            cuCtxPopCurrent(nullptr);
+#endif
         }
     }
-    surfaces_.clear();
-    totalMemoryAllocated_ = 0;
-#endif
+    surface = Surface{};
 }
 
 void NvdecDecoder::destroyParser() {
@@ -197,13 +377,98 @@ void NvdecDecoder::destroyParser() {
 void NvdecDecoder::destroyDecoder() {
 #ifdef HAVE_CUDA
     if (decoder_) {
-        cuvidDestroyDecoder(decoder_);
+        // Unmap what we still own; zero-copy handles held by consumers keep the
+        // decoder (and their surfaces) alive until they are released
+        currentHandle_.reset();
+        {
+            std::lock_guard<std::mutex> lock(frameMutex_);
+            clearFrameQueue();
+        }
+
+        if (mappedFrames_) {
+            mappedFrames_->retire();
+            mappedFrames_.reset();
+        } else {
+            cuvidDestroyDecoder(decoder_);
+        }
         decoder_ = nullptr;
     }
 #endif
 }
 
+bool NvdecDecoder::MappedFrames::tryReserve() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!decoder_ || retired_ || mapped_ >= limit_) {
+        return false;
+    }
+
+    mapped_++;
+    return true;
+}
+
+void NvdecDecoder::MappedFrames::unreserve() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (mapped_ > 0) {
+        mapped_--;
+    }
+}
+
+void NvdecDecoder::MappedFrames::releaseLease(uint64_t token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!decoder_) {
+        return;
+    }
+
+#ifdef HAVE_CUDA
+    // May run on any consumer thread
+    cuCtxPushCurrent(context_);
+    cuvidUnmapVideoFrame(decoder_, static_cast<CUdeviceptr>(token));
+    cuCtxPopCurrent(nullptr);
+#else
+    (void)token;
+#endif
+
+    if (mapped_ > 0) {
+        mapped_--;
+    }
+
+    // Last lease on a decoder its owner has given up
+    if (retired_ && mapped_ == 0) {
+        destroyDecoder();
+    }
+}
+
+void NvdecDecoder::MappedFrames::retire() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    retired_ = true;
+    if (mapped_ == 0) {
+        destroyDecoder();
+    }
+}
+
+void NvdecDecoder::MappedFrames::destroyDecoder() {
+#ifdef HAVE_CUDA
+    if (decoder_) {
+        cuCtxPushCurrent(context_);
+        cuvidDestroyDecoder(decoder_);
+        cuCtxPopCurrent(nullptr);
+    }
+#endif
+    decoder_ = nullptr;
+}
+
 DecodeResult NvdecDecoder::decode(const uint8_t* data, size_t size) {
+    return parse(data, size, 0);
+}
+
+DecodeResult NvdecDecoder::decodePacket(const PacketBuffer& packet, int64_t pts) {
+    return parse(packet.data(), packet.size(), pts);
+}
+
+DecodeResult NvdecDecoder::parse(const uint8_t* data, size_t size, int64_t pts) {
     DecodeResult result = {};
     result.status = DecodeStatus::NEED_MORE_DATA;
     result.frame = nullptr;
@@ -224,7 +489,7 @@ DecodeResult NvdecDecoder::decode(const uint8_t* data, size_t size) {
     packet.payload = data;
     packet.payload_size = static_cast<unsigned long>(size);
     packet.flags = CUVID_PKT_TIMESTAMP;
-    packet.timestamp = 0;  // Will be set by parser callbacks
+    packet.timestamp = pts;  // Comes back as the display callback's timestamp
 
     CUresult cuResult = cuvidParseVideoData(parser_, &packet);
 
@@ -246,6 +511,17 @@ DecodeResult NvdecDecoder::decode(const uint8_t* data, size_t size) {
 }
 
 DecodedFrame* NvdecDecoder::getFrame() {
+    // The frame stays valid (and its surface held) until the next call
+    currentHandle_ = acquireFrame();
+    if (!currentHandle_) {
+        return nullptr;
+    }
+
+    currentFrame_ = *currentHandle_;
+    return &currentFrame_;
+}
+
+FrameHandle NvdecDecoder::acquireFrame() {
     std::lock_guard<std::mutex> lock(frameMutex_);
 
     if (frameQueue_.empty()) {
@@ -256,31 +532,53 @@ DecodedFrame* NvdecDecoder::getFrame() {
     FrameInfo frameInfo = frameQueue_.front();
     frameQueue_.pop();
 
-    // Map to DecodedFrame structure
-    if (frameInfo.surfaceIndex >= 0 && frameInfo.surfaceIndex < static_cast<int>(surfaces_.size())) {
-        Surface& surface = surfaces_[frameInfo.surfaceIndex];
+    DecodedFrame frame = {};
+    describeFrame(frameInfo, frame);
 
-        currentFrame_.cudaSurface = reinterpret_cast<void*>(surface.devicePtr);
-        currentFrame_.cudaPitch = static_cast<int>(surface.pitch);
-        currentFrame_.width = decoderInfo_.ulTargetWidth;
-        currentFrame_.height = decoderInfo_.ulTargetHeight;
-        currentFrame_.format = PixelFormat::NV12;
-        currentFrame_.pts = frameInfo.pts;
-        currentFrame_.isKeyframe = frameInfo.isKeyframe;
+    // Copy path: the pool surface is recycled when the last handle is dropped
+    if (frameInfo.surfaceId != 0) {
+        return makeFrameHandle(FrameLease(frame, surfacePool_, frameInfo.surfaceId));
+    }
 
-        // For NV12: Y plane at offset 0, UV plane at offset (height * pitch)
-        currentFrame_.data[0] = reinterpret_cast<uint8_t*>(surface.devicePtr);
-        currentFrame_.data[1] = reinterpret_cast<uint8_t*>(surface.devicePtr + (currentFrame_.height * surface.pitch));
-        currentFrame_.data[2] = nullptr;  // NV12 has only 2 planes
+    // Zero-copy: the consumer reads the driver's output surface, unmapped on release
+    return makeFrameHandle(FrameLease(frame, mappedFrames_, static_cast<uint64_t>(frameInfo.devicePtr)));
+}
 
-        currentFrame_.pitch[0] = static_cast<int>(surface.pitch);
-        currentFrame_.pitch[1] = static_cast<int>(surface.pitch);  // UV plane has same pitch
-        currentFrame_.pitch[2] = 0;
+void NvdecDecoder::describeFrame(const FrameInfo& info, DecodedFrame& frame) const {
+    const CUdeviceptr surface = info.devicePtr;
+    const size_t pitch = info.pitch;
+
+    frame.cudaSurface = reinterpret_cast<void*>(surface);
+    frame.cudaPitch = static_cast<int>(pitch);
+    frame.width = decoderInfo_.ulTargetWidth;
+    frame.height = decoderInfo_.ulTargetHeight;
+    frame.format = PixelFormat::NV12;
+    frame.pts = info.pts;
+    frame.outputTime = info.outputTime;
+    frame.isKeyframe = info.isKeyframe;
+
+    // For NV12: Y plane at offset 0, UV plane at offset (height * pitch)
+    frame.data[0] = reinterpret_cast<uint8_t*>(surface);
+    frame.data[1] = reinterpret_cast<uint8_t*>(surface + (frame.height * pitch));
+    frame.data[2] = nullptr;  // NV12 has only 2 planes
+
+    frame.pitch[0] = static_cast<int>(pitch);
+    frame.pitch[1] = static_cast<int>(pitch);  // UV plane has same pitch
+    frame.pitch[2] = 0;
+}
 
-        return &currentFrame_;
+void NvdecDecoder::clearFrameQueue() {
+    while (!frameQueue_.empty()) {
+        const FrameInfo& info = frameQueue_.front();
+        if (info.surfaceId != 0) {
+            if (surfacePool_) {
+                surfacePool_->releaseLease(info.surfaceId);
+            }
+        } else if (mappedFrames_) {
+            mappedFrames_->releaseLease(static_cast<uint64_t>(info.devicePtr));
+        }
+        frameQueue_.pop();
     }
-
-    return nullptr;
 }
 
 void NvdecDecoder::setQuality(StreamQuality quality) {
@@ -290,23 +588,26 @@ void NvdecDecoder::setQuality(StreamQuality quality) {
 
     config_.quality = quality;
 
-    // Quality changes require re-allocating surface pool
-    // This is safe to do because we're not actively decoding during quality change
-    std::lock_guard<std::mutex> lock(frameMutex_);
-    freeSurfaces();
-
-    if (decoder_) {
-        allocateSurfaces();
+    if (!decoder_) {
+        return;  // Applied when the first sequence header creates the decoder
     }
+
+    // Resize the output surface pool in place (called between packets, nothing
+    // in flight). The decoder's own decode surface count follows at the next
+    // format change (e.g. sub/main stream switch): it can only be reconfigured
+    // from the sequence callback, where the parser learns the new count.
+    std::lock_guard<std::mutex> lock(frameMutex_);
+    clearFrameQueue();
+    allocateSurfaces();
 }
 
 MemoryStats NvdecDecoder::getMemoryUsage() const {
     std::lock_guard<std::mutex> lock(statsMutex_);
 
     MemoryStats stats = {};
-    stats.gpuMemoryUsed = totalMemoryAllocated_;
-    stats.systemMemoryUsed = sizeof(*this) + surfaces_.size() * sizeof(Surface);
-    stats.surfacePoolSize = surfaces_.size();
+    stats.gpuMemoryUsed = surfacePool_ ? surfacePool_->bytesAllocated() : 0;
+    stats.systemMemoryUsed = sizeof(*this) + sizeof(SurfacePool);
+    stats.surfacePoolSize = surfacePool_ ? surfacePool_->size() : 0;
     stats.surfacePoolCapacity = getSurfacePoolSize(config_.quality);
 
     return stats;
@@ -333,36 +634,76 @@ void NvdecDecoder::flush() {
 }
 
 void NvdecDecoder::reset() {
+    currentHandle_.reset();
+
     std::lock_guard<std::mutex> lock(frameMutex_);
 
-    // Clear frame queue
-    while (!frameQueue_.empty()) {
-        frameQueue_.pop();
-    }
+    // Clear frame queue (surfaces held by consumers come back when their handles are dropped)
+    clearFrameQueue();
 
-    // Mark all surfaces as not in use
-    for (auto& surface : surfaces_) {
-        surface.inUse = false;
+    framesDecoded_ = 0;
+}
+
+void NvdecDecoder::park() {
+    reset();
+
+    // Parser state belongs to the old stream; the decoder (the expensive part) is kept
+    destroyParser();
+
+    // Output surfaces go back to the memory pool's size classes, where the next
+    // camera finds them again, or any camera under memory pressure
+    freeSurfaces();
+}
+
+bool NvdecDecoder::rebind(const DecoderConfig& config) {
+    // Lease limit, device and surface allocator were fixed at creation
+    if (!initialized_ || config.codec != config_.codec || config.cudaDeviceId != config_.cudaDeviceId ||
+        config.memoryPool != config_.memoryPool || config.zeroCopyOutput != config_.zeroCopyOutput ||
+        config.maxWidth != config_.maxWidth || config.maxHeight != config_.maxHeight) {
+        return false;
     }
 
-    framesDecoded_ = 0;
+    config_ = config;
+
+#ifdef HAVE_CUDA
+    // Surfaces still held by the old camera's consumers stay with the old pool,
+    // so they are given back under the camera that allocated them
+    surfacePool_ = std::make_shared<SurfacePool>(cudaContext_, config_.memoryPool, config_.cameraId);
+
+    cuCtxPushCurrent(cudaContext_);
+    const bool ok = createParser() && (!decoder_ || allocateSurfaces());
+    cuCtxPopCurrent(nullptr);
+
+    // The first sequence header reconfigures the kept decoder if the stream differs
+    return ok;
+#else
+    return false;
+#endif
 }
 
 // NVDEC Callbacks
 int CUDAAPI NvdecDecoder::handleVideoSequence(void* userData, CUVIDEOFORMAT* format) {
     NvdecDecoder* decoder = static_cast<NvdecDecoder*>(userData);
 
-    // Create decoder on first sequence or when format changes
-    if (!decoder->decoder_ ||
-        decoder->decoderInfo_.ulWidth != format->coded_width ||
-        decoder->decoderInfo_.ulHeight != format->coded_height) {
+    // Create decoder on first sequence; on a format change (sub/main stream switch,
+    // quality change) reconfigure it in place if possible, else rebuild it
+    const bool formatChanged = decoder->decoder_ &&
+        (decoder->decoderInfo_.ulWidth != format->coded_width ||
+         decoder->decoderInfo_.ulHeight != format->coded_height ||
+         decoder->decoderInfo_.ulNumDecodeSurfaces != decoder->decodeSurfaceCount(format));
 
+    if (!decoder->decoder_) {
         if (!decoder->createDecoder(format)) {
             return 0;  // Fail
         }
+    } else if (formatChanged) {
+        if (!(decoder->canReconfigure(format) && decoder->reconfigureDecoder(format)) &&
+            !decoder->createDecoder(format)) {
+            return 0;  // Fail
+        }
     }
 
-    return static_cast<int>(getSurfacePoolSize(decoder->config_.quality));  // Return number of decode surfaces
+    return static_cast<int>(decoder->decodeSurfaceCount(format));  // Return number of decode surfaces
 }
 
 int CUDAAPI NvdecDecoder::handlePictureDecode(void* userData, CUVIDPICPARAMS* picParams) {
@@ -396,31 +737,47 @@ int CUDAAPI NvdecDecoder::handlePictureDisplay(void* userData, CUVIDPARSERDISPIN
     procParams.top_field_first = dispInfo->top_field_first;
     procParams.unpaired_field = (dispInfo->repeat_first_field < 0);
 
+    // Zero-copy while an output surface is free for a lease; otherwise copy (below)
+    const bool zeroCopy = decoder->mappedFrames_ && decoder->mappedFrames_->tryReserve();
+
     CUdeviceptr decodedSurface = 0;
     unsigned int pitch = 0;
     CUresult result = cuvidMapVideoFrame(decoder->decoder_, dispInfo->picture_index,
                                          &decodedSurface, &pitch, &procParams);
 
     if (result != CUDA_SUCCESS) {
+        if (zeroCopy) {
+            decoder->mappedFrames_->unreserve();
+        }
         std::cerr << "NvdecDecoder: cuvidMapVideoFrame failed: " << result << std::endl;
         return 0;
     }
 
-    // Find available surface in our pool
     std::lock_guard<std::mutex> lock(decoder->frameMutex_);
 
-    int surfaceIndex = -1;
-    for (size_t i = 0; i < decoder->surfaces_.size(); ++i) {
-        if (!decoder->surfaces_[i].inUse) {
-            surfaceIndex = static_cast<int>(i);
-            decoder->surfaces_[i].inUse = true;
-            break;
-        }
+    const int64_t outputTime = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    if (zeroCopy) {
+        // Queue the mapped surface itself: unmapped when the consumer's lease is released
+        FrameInfo frameInfo;
+        frameInfo.devicePtr = decodedSurface;
+        frameInfo.pitch = pitch;
+        frameInfo.pts = dispInfo->timestamp;
+        frameInfo.outputTime = outputTime;
+        frameInfo.isKeyframe = (dispInfo->picture_index == 0);  // Simplified keyframe detection
+
+        decoder->frameQueue_.push(frameInfo);
+        decoder->framesDecoded_++;
+        return 1;
     }
 
-    if (surfaceIndex >= 0) {
+    // Copy fallback (zero-copy off, or every lease is held): claim a free surface in our pool.
+    // If consumers hold all of them the picture is dropped; the decoder never waits.
+    FrameInfo frameInfo;
+    if (decoder->surfacePool_ &&
+        decoder->surfacePool_->acquire(frameInfo.surfaceId, frameInfo.devicePtr, frameInfo.pitch)) {
         // Copy from decoder surface to our surface pool
-        Surface& surface = decoder->surfaces_[surfaceIndex];
 
         // Copy Y plane
         CUDA_MEMCPY2D copyParams = {};
@@ -428,8 +785,8 @@ int CUDAAPI NvdecDecoder::handlePictureDisplay(void* userData, CUVIDPARSERDISPIN
         copyParams.srcDevice = decodedSurface;
         copyParams.srcPitch = pitch;
         copyParams.dstMemoryType = CU_MEMORYTYPE_DEVICE;
-        copyParams.dstDevice = surface.devicePtr;
-        copyParams.dstPitch = surface.pitch;
+        copyParams.dstDevice = frameInfo.devicePtr;
+        copyParams.dstPitch = frameInfo.pitch;
         copyParams.WidthInBytes = decoder->decoderInfo_.ulTargetWidth;
         copyParams.Height = decoder->decoderInfo_.ulTargetHeight;
 
@@ -437,15 +794,14 @@ int CUDAAPI NvdecDecoder::handlePictureDisplay(void* userData, CUVIDPARSERDISPIN
 
         // Copy UV plane (NV12 interleaved)
         copyParams.srcDevice = decodedSurface + (pitch * decoder->decoderInfo_.ulTargetHeight);
-        copyParams.dstDevice = surface.devicePtr + (surface.pitch * decoder->decoderInfo_.ulTargetHeight);
+        copyParams.dstDevice = frameInfo.devicePtr + (frameInfo.pitch * decoder->decoderInfo_.ulTargetHeight);
         copyParams.Height = decoder->decoderInfo_.ulTargetHeight / 2;
 
         cuMemcpy2D(&copyParams);
 
         // Add to frame queue
-        FrameInfo frameInfo;
-        frameInfo.surfaceIndex = surfaceIndex;
         frameInfo.pts = dispInfo->timestamp;
+        frameInfo.outputTime = outputTime;
         frameInfo.isKeyframe = (dispInfo->picture_index == 0);  // Simplified keyframe detection
 
         decoder->frameQueue_.push(frameInfo);
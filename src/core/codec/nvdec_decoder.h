@@ -3,6 +3,7 @@
 #pragma once
 
 #include "decoder_interface.h"
+#include "../gpu/memory_pool.h"
 #include <cuda.h>
 #include <nvcuvid.h>
 #include <memory>
@@ -20,11 +21,15 @@ public:
     // IDecoder interface
     bool initialize(const DecoderConfig& config) override;
     DecodeResult decode(const uint8_t* data, size_t size) override;
+    DecodeResult decodePacket(const PacketBuffer& packet, int64_t pts) override;
     DecodedFrame* getFrame() override;
+    FrameHandle acquireFrame() override;
     void setQuality(StreamQuality quality) override;
     MemoryStats getMemoryUsage() const override;
     void flush() override;
     void reset() override;
+    void park() override;
+    bool rebind(const DecoderConfig& config) override;
     const DecoderConfig& getConfig() const override { return config_; }
     bool isHardwareAccelerated() const override { return true; }
 
@@ -35,8 +40,12 @@ private:
     static int CUDAAPI handlePictureDisplay(void* userData, CUVIDPARSERDISPINFO* dispInfo);
 
     // Internal helpers
+    DecodeResult parse(const uint8_t* data, size_t size, int64_t pts);
     bool createParser();
     bool createDecoder(CUVIDEOFORMAT* format);
+    bool canReconfigure(const CUVIDEOFORMAT* format) const;
+    bool reconfigureDecoder(CUVIDEOFORMAT* format);
+    unsigned int decodeSurfaceCount(const CUVIDEOFORMAT* format) const;
     void destroyParser();
     void destroyDecoder();
     bool allocateSurfaces();
@@ -44,6 +53,10 @@ private:
 
     DecodedFrame* mapSurfaceToFrame(CUdeviceptr surface, CUVIDPARSERDISPINFO* dispInfo);
 
+    struct FrameInfo;
+    void describeFrame(const FrameInfo& info, DecodedFrame& frame) const;
+    void clearFrameQueue();  // frameMutex_ held; gives queued frames back
+
     // Configuration
     DecoderConfig config_;
 
@@ -57,29 +70,95 @@ private:
     // Decoder creation parameters
     CUVIDDECODECREATEINFO decoderInfo_;
 
-    // Surface pool for decoded frames
-    struct Surface {
-        CUdeviceptr devicePtr;
-        size_t pitch;
-        bool inUse;
+    // Surface pool for decoded frames (copy path)
+    // Shared with outstanding frame handles: a surface returns to the pool when
+    // its last handle is dropped, and surfaces still held when the pool is
+    // resized or the decoder is destroyed are given back on that release instead.
+    // Surfaces come from the shared GPUMemoryPool when the config provides one
+    // (recycled across cameras, limit enforced), else straight from cuMemAllocPitch.
+    class SurfacePool : public FrameLease::Owner {
+    public:
+        SurfacePool(CUcontext context, std::shared_ptr<gpu::GPUMemoryPool> memoryPool,
+                    std::string cameraId)
+            : context_(context), memoryPool_(std::move(memoryPool)), cameraId_(std::move(cameraId)) {}
+        ~SurfacePool() override;
+
+        // Keep count NV12 surfaces of at least width x height, reusing what fits
+        bool resize(size_t count, size_t width, size_t height);
+
+        // Claim a free surface (false if consumers hold all of them)
+        bool acquire(uint64_t& id, CUdeviceptr& devicePtr, size_t& pitch);
+
+        void releaseLease(uint64_t id) override;  // Back to the pool (any thread)
+
+        size_t size() const;             // Surfaces in the pool
+        size_t bytesAllocated() const;   // Including retired surfaces still held
+
+    private:
+        struct Surface {
+            uint64_t id = 0;
+            gpu::SurfaceAllocation memory;  // Allocated size may exceed the current target
+            bool inUse = false;
+        };
+
+        bool allocateSurface(size_t width, size_t height, Surface& surface);  // mutex_ held
+        void freeSurface(Surface& surface);                                 // mutex_ held
+
+        mutable std::mutex mutex_;
+        CUcontext context_;
+        std::shared_ptr<gpu::GPUMemoryPool> memoryPool_;
+        std::string cameraId_;
+        std::vector<Surface> surfaces_;
+        std::vector<Surface> retired_;   // Dropped from the pool but still held by handles
+        uint64_t nextId_ = 1;
+        size_t bytes_ = 0;
     };
-    std::vector<Surface> surfaces_;
+    std::shared_ptr<SurfacePool> surfacePool_;
 
     // Frame queue
     struct FrameInfo {
-        int surfaceIndex;
-        int64_t pts;
-        bool isKeyframe;
+        CUdeviceptr devicePtr = 0;    // Pool surface, or the driver-mapped output surface (zero-copy)
+        size_t pitch = 0;
+        uint64_t surfaceId = 0;       // Copy path: pool surface id (0 = mapped frame)
+        int64_t pts = 0;
+        int64_t outputTime = 0;       // Display callback time (steady clock, microseconds)
+        bool isKeyframe = false;
     };
     std::queue<FrameInfo> frameQueue_;
     std::mutex frameMutex_;
 
+    // Mapped output surfaces handed out as handles (zero-copy mode)
+    // Shared with outstanding handles. Driver mappings die with the decoder, so
+    // a decoder rebuilt or destroyed while handles are out is handed over here
+    // and destroyed by the last release: its surfaces stay valid until then.
+    class MappedFrames : public FrameLease::Owner {
+    public:
+        MappedFrames(CUvideodecoder decoder, CUcontext context, size_t limit)
+            : decoder_(decoder), context_(context), limit_(limit) {}
+
+        bool tryReserve();   // Count one more mapped frame (false once at the limit)
+        void unreserve();
+        void releaseLease(uint64_t token) override;  // Unmap (any thread)
+        void retire();       // Owner is done with the decoder: destroy it now or at the last release
+
+    private:
+        std::mutex mutex_;
+        CUvideodecoder decoder_;   // nullptr once destroyed
+        CUcontext context_;
+        size_t limit_;
+        size_t mapped_ = 0;
+        bool retired_ = false;
+
+        void destroyDecoder();     // mutex_ held
+    };
+    std::shared_ptr<MappedFrames> mappedFrames_;
+
     // Current frame being accessed
     DecodedFrame currentFrame_;
+    FrameHandle currentHandle_;    // Keeps getFrame()'s frame alive until the next call
 
     // Statistics
     mutable std::mutex statsMutex_;
-    size_t totalMemoryAllocated_;
     size_t framesDecoded_;
 
     // Initialization state
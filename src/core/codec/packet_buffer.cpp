@@ -0,0 +1,168 @@
+// src/core/codec/packet_buffer.cpp
+#include "packet_buffer.h"
+#include <cstring>
+#include <new>
+
+extern "C" {
+#include <libavcodec/avcodec.h>
+#include <libavutil/buffer.h>
+}
+
+namespace fluxvision {
+
+PacketBuffer::~PacketBuffer() {
+    reset();
+}
+
+PacketBuffer::PacketBuffer(const PacketBuffer& other) noexcept
+    : storage_(other.storage_)
+    , data_(other.data_)
+    , size_(other.size_)
+{
+    if (storage_) {
+        storage_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+PacketBuffer::PacketBuffer(PacketBuffer&& other) noexcept
+    : storage_(other.storage_)
+    , data_(other.data_)
+    , size_(other.size_)
+{
+    other.storage_ = nullptr;
+    other.data_ = nullptr;
+    other.size_ = 0;
+}
+
+PacketBuffer& PacketBuffer::operator=(const PacketBuffer& other) noexcept {
+    if (this != &other) {
+        PacketBuffer copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+PacketBuffer& PacketBuffer::operator=(PacketBuffer&& other) noexcept {
+    if (this != &other) {
+        reset();
+        storage_ = other.storage_;
+        data_ = other.data_;
+        size_ = other.size_;
+        other.storage_ = nullptr;
+        other.data_ = nullptr;
+        other.size_ = 0;
+    }
+    return *this;
+}
+
+PacketBuffer PacketBuffer::adopt(AVBufferRef* ref, const uint8_t* data, size_t size) {
+    Storage* storage = new (std::nothrow) Storage();
+    if (!storage) {
+        av_buffer_unref(&ref);
+        return PacketBuffer();
+    }
+
+    storage->ref = ref;
+    return PacketBuffer(storage, data, size);
+}
+
+PacketBuffer PacketBuffer::fromPacket(AVPacket* packet) {
+    if (!packet || !packet->data || packet->size <= 0) {
+        return PacketBuffer();
+    }
+
+    if (!packet->buf) {
+        // Not refcounted (legacy demuxers): one copy into padded storage
+        PacketBuffer copy = copyOf(packet->data, static_cast<size_t>(packet->size));
+        av_packet_unref(packet);
+        return copy;
+    }
+
+    // Steal the packet's reference instead of taking a new one
+    AVBufferRef* ref = packet->buf;
+    const uint8_t* data = packet->data;
+    size_t size = static_cast<size_t>(packet->size);
+
+    packet->buf = nullptr;
+    av_packet_unref(packet);
+
+    return adopt(ref, data, size);
+}
+
+PacketBuffer PacketBuffer::copyOf(const uint8_t* data, size_t size) {
+    PacketBuffer buffer = allocate(size);
+    if (size > 0 && buffer.size() == size) {
+        std::memcpy(buffer.mutableData(), data, size);
+    }
+    return buffer;
+}
+
+PacketBuffer PacketBuffer::allocate(size_t size) {
+    if (size == 0) {
+        return PacketBuffer();
+    }
+
+    AVBufferRef* ref = av_buffer_alloc(size + AV_INPUT_BUFFER_PADDING_SIZE);
+    if (!ref) {
+        return PacketBuffer();
+    }
+
+    std::memset(ref->data + size, 0, AV_INPUT_BUFFER_PADDING_SIZE);
+    return adopt(ref, ref->data, size);
+}
+
+PacketBuffer PacketBuffer::slice(size_t offset, size_t length) const {
+    if (!storage_ || offset >= size_) {
+        return PacketBuffer();
+    }
+
+    if (length > size_ - offset) {
+        length = size_ - offset;
+    }
+
+    storage_->refs.fetch_add(1, std::memory_order_relaxed);
+    return PacketBuffer(storage_, data_ + offset, length);
+}
+
+bool PacketBuffer::isContiguousWith(const PacketBuffer& next) const {
+    return storage_ && storage_ == next.storage_ && data_ + size_ == next.data_;
+}
+
+bool PacketBuffer::extendWith(const PacketBuffer& next) {
+    if (next.empty()) {
+        return true;
+    }
+
+    if (!isContiguousWith(next)) {
+        return false;
+    }
+
+    size_ += next.size_;
+    return true;
+}
+
+uint8_t* PacketBuffer::mutableData() {
+    if (!storage_ || storage_->refs.load(std::memory_order_acquire) != 1) {
+        return nullptr;
+    }
+
+    // Storage is private to this reference; recover the writable view
+    return storage_->ref->data + (data_ - storage_->ref->data);
+}
+
+AVBufferRef* PacketBuffer::avBuffer() const {
+    return storage_ ? storage_->ref : nullptr;
+}
+
+void PacketBuffer::reset() noexcept {
+    if (storage_ && storage_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        av_buffer_unref(&storage_->ref);
+        delete storage_;
+    }
+
+    storage_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+} // namespace fluxvision
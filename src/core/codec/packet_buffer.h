@@ -0,0 +1,92 @@
+// src/core/codec/packet_buffer.h
+// Refcounted immutable byte slices shared by the network and decode paths
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Forward declarations for FFmpeg
+struct AVBufferRef;
+struct AVPacket;
+
+namespace fluxvision {
+
+// Slice [data, data + size) of a refcounted storage block backed by an AVBufferRef
+//
+// Copying a PacketBuffer or taking a slice() only bumps an atomic refcount: an
+// AVPacket read from the network is wrapped once, then its NAL units, access
+// units and queued StreamPackets all point into the same memory until the
+// decoder is done with it. Storage obtained from FFmpeg or allocate() keeps
+// AV_INPUT_BUFFER_PADDING_SIZE zeroed bytes after the end, as decoders require.
+//
+// Read-only once shared; mutableData() is only for filling a fresh allocate().
+// Thread-safety: distinct PacketBuffer objects may be used from different
+// threads even when they share storage (like std::shared_ptr).
+class PacketBuffer {
+public:
+    PacketBuffer() noexcept = default;
+    ~PacketBuffer();
+
+    PacketBuffer(const PacketBuffer& other) noexcept;
+    PacketBuffer(PacketBuffer&& other) noexcept;
+    PacketBuffer& operator=(const PacketBuffer& other) noexcept;
+    PacketBuffer& operator=(PacketBuffer&& other) noexcept;
+
+    // Take over the packet's buffer reference (no copy); the packet is left blank
+    // Non-refcounted packets are copied
+    static PacketBuffer fromPacket(AVPacket* packet);
+
+    // Copy bytes into new padded storage
+    static PacketBuffer copyOf(const uint8_t* data, size_t size);
+    static PacketBuffer copyOf(const std::vector<uint8_t>& bytes) {
+        return copyOf(bytes.data(), bytes.size());
+    }
+
+    // New padded storage of size bytes, to be filled through mutableData()
+    static PacketBuffer allocate(size_t size);
+
+    // Sub-range sharing this storage (clamped to the current slice)
+    PacketBuffer slice(size_t offset, size_t length) const;
+
+    // True if next starts exactly where this slice ends in the same storage
+    bool isContiguousWith(const PacketBuffer& next) const;
+
+    // Extend this slice to also cover next (requires isContiguousWith(next))
+    bool extendWith(const PacketBuffer& next);
+
+    // Byte access (vector-like)
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    const uint8_t* begin() const { return data_; }
+    const uint8_t* end() const { return data_ + size_; }
+    uint8_t operator[](size_t index) const { return data_[index]; }
+
+    // Writable pointer while this is the only reference (nullptr once shared)
+    uint8_t* mutableData();
+
+    // Underlying FFmpeg buffer (for av_buffer_ref into an AVPacket), nullptr if empty
+    AVBufferRef* avBuffer() const;
+
+    // Release this reference
+    void reset() noexcept;
+
+private:
+    struct Storage {
+        std::atomic<uint32_t> refs{1};
+        AVBufferRef* ref = nullptr;
+    };
+
+    PacketBuffer(Storage* storage, const uint8_t* data, size_t size) noexcept
+        : storage_(storage), data_(data), size_(size) {}
+
+    static PacketBuffer adopt(AVBufferRef* ref, const uint8_t* data, size_t size);
+
+    Storage* storage_ = nullptr;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+};
+
+} // namespace fluxvision
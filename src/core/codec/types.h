@@ -4,9 +4,15 @@
 
 #include <cstdint>
 #include <cstddef>
+#include <memory>
+#include <string>
 
 namespace fluxvision {
 
+namespace gpu {
+class GPUMemoryPool;
+}
+
 // Video codec types
 enum class CodecType {
     H264,
@@ -28,6 +34,7 @@ enum class PixelFormat {
     NV12,        // NVIDIA NVDEC output format (Y plane + interleaved UV)
     YUV420P,     // Planar YUV 4:2:0 (FFmpeg common format)
     RGBA,        // 32-bit RGBA (for rendering)
+    BGR,         // 24-bit packed BGR (for inference)
     UNKNOWN
 };
 
@@ -57,6 +64,7 @@ struct DecodedFrame {
     PixelFormat format;
     int64_t pts;               // Presentation timestamp (microseconds)
     int64_t dts;               // Decode timestamp (microseconds)
+    int64_t outputTime;        // Steady clock (microseconds) the decoder output the picture (0 = unknown)
     bool isKeyframe;
 
     // GPU-specific (NVDEC)
@@ -64,6 +72,14 @@ struct DecodedFrame {
     int cudaPitch;             // CUDA surface pitch
 };
 
+// libavcodec hardware offload for the non-NVDEC decoder
+enum class HwAccel {
+    NONE,        // Pure software (frame-threaded)
+    AUTO,        // Whatever DecoderFactory detects: VAAPI, then QSV, then software
+    VAAPI,       // Native decoder with a VA-API device, output downloaded as NV12
+    QSV          // Intel Quick Sync (h264_qsv/hevc_qsv), NV12 in system memory
+};
+
 // Decode result
 struct DecodeResult {
     DecodeStatus status;
@@ -79,6 +95,11 @@ struct DecoderConfig {
     uint32_t maxHeight;        // Max resolution (e.g., 1080 or 360)
     bool preferHardware;       // Auto-select NVDEC if available
     bool isSubStream;          // true for grid view (640×360), false for main (1920×1080)
+    bool zeroCopyOutput;       // NVDEC: lease mapped output surfaces instead of copying them
+    std::shared_ptr<gpu::GPUMemoryPool> memoryPool;  // Shared output surface allocator (optional)
+    std::string cameraId;      // Owner of pooled surfaces, for accounting
+    int cudaDeviceId;          // NVDEC: CUDA device to decode on (memoryPool must be on it too)
+    HwAccel hwAccel;           // CPU decoder: VAAPI/QSV offload before software
 
     // Constructor with defaults
     DecoderConfig()
@@ -88,6 +109,9 @@ struct DecoderConfig {
         , maxHeight(1080)
         , preferHardware(true)
         , isSubStream(false)
+        , zeroCopyOutput(false)
+        , cudaDeviceId(0)
+        , hwAccel(HwAccel::AUTO)
     {}
 };
 
@@ -114,6 +138,19 @@ inline size_t getSurfacePoolSize(StreamQuality quality) {
     }
 }
 
+// Driver output surfaces (ulNumOutputSurfaces): frames that can be mapped at once
+// In zero-copy mode all but one can be leased; the last is kept for the copy fallback
+inline size_t getOutputSurfaceCount(StreamQuality quality) {
+    switch (quality) {
+        case StreamQuality::PAUSED:     return 2;
+        case StreamQuality::THUMBNAIL:  return 2;
+        case StreamQuality::GRID_VIEW:  return 3;
+        case StreamQuality::FOCUSED:    return 4;
+        case StreamQuality::FULLSCREEN: return 5;
+        default:                        return 3;
+    }
+}
+
 inline const char* codecToString(CodecType codec) {
     switch (codec) {
         case CodecType::H264:    return "H.264";
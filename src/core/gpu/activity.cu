@@ -0,0 +1,68 @@
+// src/core/gpu/activity.cu
+// Low-resolution luma change measurement
+#include "activity_kernels.h"
+#include <cuda_runtime.h>
+
+namespace fluxvision {
+namespace gpu {
+
+namespace {
+    // Samples per cell side: one thread each, 256 per cell
+    constexpr int kSamplesPerSide = 16;
+
+    // One block per cell: sample its luma, reduce to the mean, compare with the last frame
+    __global__ void activityGrid(const unsigned char* luma, int pitch, int width, int height,
+                                 int gridWidth, int gridHeight, int cellThreshold,
+                                 unsigned char* current, const unsigned char* previous,
+                                 ActivityCounts* counts) {
+        __shared__ unsigned int sums[kSamplesPerSide * kSamplesPerSide];
+
+        const int cell = blockIdx.y * gridWidth + blockIdx.x;
+        const int thread = threadIdx.y * kSamplesPerSide + threadIdx.x;
+
+        // Sample centres spread evenly over the cell
+        const int x = ((blockIdx.x * kSamplesPerSide + threadIdx.x) * 2 + 1) * width /
+                      (2 * gridWidth * kSamplesPerSide);
+        const int y = ((blockIdx.y * kSamplesPerSide + threadIdx.y) * 2 + 1) * height /
+                      (2 * gridHeight * kSamplesPerSide);
+        sums[thread] = luma[min(y, height - 1) * pitch + min(x, width - 1)];
+        __syncthreads();
+
+        for (int stride = kSamplesPerSide * kSamplesPerSide / 2; stride > 0; stride >>= 1) {
+            if (thread < stride) {
+                sums[thread] += sums[thread + stride];
+            }
+            __syncthreads();
+        }
+
+        if (thread == 0) {
+            const int mean = static_cast<int>(sums[0] / (kSamplesPerSide * kSamplesPerSide));
+            current[cell] = static_cast<unsigned char>(mean);
+
+            const int difference = abs(mean - static_cast<int>(previous[cell]));
+            atomicAdd(&counts->sad, static_cast<unsigned int>(difference));
+            if (difference > cellThreshold) {
+                atomicAdd(&counts->changedCells, 1u);
+            }
+        }
+    }
+}
+
+int launchActivityGrid(uint64_t luma, int pitch, int width, int height,
+                       int gridWidth, int gridHeight, int cellThreshold,
+                       uint8_t* current, const uint8_t* previous,
+                       ActivityCounts* counts, void* stream) {
+    if (width <= 0 || height <= 0 || gridWidth <= 0 || gridHeight <= 0) {
+        return cudaSuccess;
+    }
+
+    const dim3 block(kSamplesPerSide, kSamplesPerSide);
+    const dim3 grid(gridWidth, gridHeight);
+    activityGrid<<<grid, block, 0, static_cast<cudaStream_t>(stream)>>>(
+        reinterpret_cast<const unsigned char*>(luma), pitch, width, height,
+        gridWidth, gridHeight, cellThreshold, current, previous, counts);
+    return static_cast<int>(cudaGetLastError());
+}
+
+} // namespace gpu
+} // namespace fluxvision
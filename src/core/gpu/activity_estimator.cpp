@@ -0,0 +1,275 @@
+// src/core/gpu/activity_estimator.cpp
+#include "activity_estimator.h"
+#include "activity_kernels.h"
+#include "cuda_context.h"
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+
+namespace fluxvision {
+namespace gpu {
+
+namespace {
+    // Matches kSamplesPerSide in activity.cu, so both paths see the same grid
+    constexpr int kSamplesPerSide = 16;
+}
+
+ActivityEstimator::ActivityEstimator(const Config& config)
+    : config_(config)
+{
+    config_.gridWidth = std::clamp(config_.gridWidth, 1, 256);
+    config_.gridHeight = std::clamp(config_.gridHeight, 1, 256);
+}
+
+ActivityEstimator::~ActivityEstimator() {
+    release();
+}
+
+bool ActivityEstimator::initialize() {
+#if defined(HAVE_CUDA) && defined(HAVE_CUDA_KERNELS)
+    if (stream_) {
+        return true;
+    }
+
+    CudaContext& cuda = CudaContext::getInstance(config_.cudaDeviceId);
+    if (!cuda.initialize()) {
+        std::cerr << "ActivityEstimator: CUDA device " << config_.cudaDeviceId << " unavailable" << std::endl;
+        return false;
+    }
+    context_ = cuda.getContext();
+
+    // Own non-blocking stream: the measurement never serializes with decode work
+    cuCtxPushCurrent(context_);
+    const size_t gridBytes = static_cast<size_t>(cellCount());
+    CUresult result = cuStreamCreate(&stream_, CU_STREAM_NON_BLOCKING);
+    if (result == CUDA_SUCCESS) {
+        result = cuEventCreate(&done_, CU_EVENT_DISABLE_TIMING);
+    }
+    for (CUdeviceptr& grid : deviceGrids_) {
+        if (result == CUDA_SUCCESS) {
+            result = cuMemAlloc(&grid, gridBytes);
+        }
+    }
+    if (result == CUDA_SUCCESS) {
+        result = cuMemAlloc(&deviceCounts_, sizeof(ActivityCounts));
+    }
+    if (result == CUDA_SUCCESS) {
+        result = cuMemHostAlloc(&hostCounts_, sizeof(ActivityCounts), 0);
+    }
+    cuCtxPopCurrent(nullptr);
+
+    if (result != CUDA_SUCCESS) {
+        const char* errorStr = nullptr;
+        cuGetErrorString(result, &errorStr);
+        std::cerr << "ActivityEstimator: failed to create stream or grids: "
+                  << (errorStr ? errorStr : "Unknown error") << std::endl;
+        release();
+        return false;
+    }
+    return true;
+#else
+    std::cerr << "ActivityEstimator: built without CUDA kernels, measuring host frames only" << std::endl;
+    return false;
+#endif
+}
+
+bool ActivityEstimator::submit(const FrameHandle& frame) {
+    const bool measurable = frame && frame->data[0] && frame->width > 0 && frame->height > 0 &&
+                            (frame->format == PixelFormat::NV12 || frame->format == PixelFormat::YUV420P);
+    if (pending_ || !measurable) {
+        return false;
+    }
+
+    if (frame->cudaSurface) {
+        return submitDevice(frame);
+    }
+    return measureHost(*frame);
+}
+
+bool ActivityEstimator::poll(float& activity) {
+    if (!pending_) {
+        return false;
+    }
+
+    if (pendingOnDevice_) {
+        return pollDevice(activity);
+    }
+
+    pending_ = false;
+    if (!havePrevious_) {
+        havePrevious_ = true;
+        return false;
+    }
+    activity = hostActivity_;
+    return true;
+}
+
+bool ActivityEstimator::measureHost(const DecodedFrame& frame) {
+    const int cells = cellCount();
+    std::vector<uint8_t>& current = hostGrids_[hostCurrent_ ^ 1];
+    const std::vector<uint8_t>& previous = hostGrids_[hostCurrent_];
+    current.resize(static_cast<size_t>(cells));
+
+    // Same sample positions as the kernel
+    const int width = static_cast<int>(frame.width);
+    const int height = static_cast<int>(frame.height);
+    const int samplesX = config_.gridWidth * kSamplesPerSide;
+    const int samplesY = config_.gridHeight * kSamplesPerSide;
+    int changed = 0;
+
+    for (int cellY = 0; cellY < config_.gridHeight; ++cellY) {
+        for (int cellX = 0; cellX < config_.gridWidth; ++cellX) {
+            unsigned int sum = 0;
+            for (int sy = 0; sy < kSamplesPerSide; ++sy) {
+                const int y = std::min(((cellY * kSamplesPerSide + sy) * 2 + 1) * height / (2 * samplesY), height - 1);
+                const uint8_t* row = frame.data[0] + static_cast<size_t>(y) * frame.pitch[0];
+                for (int sx = 0; sx < kSamplesPerSide; ++sx) {
+                    const int x = std::min(((cellX * kSamplesPerSide + sx) * 2 + 1) * width / (2 * samplesX), width - 1);
+                    sum += row[x];
+                }
+            }
+
+            const size_t cell = static_cast<size_t>(cellY * config_.gridWidth + cellX);
+            current[cell] = static_cast<uint8_t>(sum / (kSamplesPerSide * kSamplesPerSide));
+            if (!previous.empty() && std::abs(current[cell] - previous[cell]) > config_.cellThreshold) {
+                changed++;
+            }
+        }
+    }
+
+    // A grid kept on the device describes a different frame sequence
+    if (previousOnDevice_ || previous.empty()) {
+        havePrevious_ = false;
+    }
+    previousOnDevice_ = false;
+    hostCurrent_ ^= 1;
+    hostActivity_ = static_cast<float>(changed) / static_cast<float>(cells);
+    pending_ = true;
+    pendingOnDevice_ = false;
+    return true;
+}
+
+bool ActivityEstimator::submitDevice(const FrameHandle& frame) {
+#if defined(HAVE_CUDA) && defined(HAVE_CUDA_KERNELS)
+    if (!stream_) {
+        return false;
+    }
+
+    uint8_t* current = reinterpret_cast<uint8_t*>(deviceGrids_[deviceCurrent_ ^ 1]);
+    const uint8_t* previous = reinterpret_cast<const uint8_t*>(deviceGrids_[deviceCurrent_]);
+
+    cuCtxPushCurrent(context_);
+    CUresult result = cuMemsetD8Async(deviceCounts_, 0, sizeof(ActivityCounts), stream_);
+    int launch = 0;
+    if (result == CUDA_SUCCESS) {
+        launch = launchActivityGrid(reinterpret_cast<uint64_t>(frame->data[0]), frame->pitch[0],
+                                    static_cast<int>(frame->width), static_cast<int>(frame->height),
+                                    config_.gridWidth, config_.gridHeight, config_.cellThreshold,
+                                    current, previous,
+                                    reinterpret_cast<ActivityCounts*>(deviceCounts_), stream_);
+    }
+    if (result == CUDA_SUCCESS && launch == 0) {
+        result = cuMemcpyDtoHAsync(hostCounts_, deviceCounts_, sizeof(ActivityCounts), stream_);
+    }
+    if (result == CUDA_SUCCESS && launch == 0) {
+        result = cuEventRecord(done_, stream_);
+    }
+    cuCtxPopCurrent(nullptr);
+
+    if (result != CUDA_SUCCESS || launch != 0) {
+        std::cerr << "ActivityEstimator: measurement failed (CUDA " << result
+                  << ", launch " << launch << ")" << std::endl;
+        // The grids' contents are unknown now
+        havePrevious_ = false;
+        return false;
+    }
+
+    if (!previousOnDevice_) {
+        havePrevious_ = false;
+    }
+    previousOnDevice_ = true;
+    deviceCurrent_ ^= 1;
+    source_ = frame;
+    pending_ = true;
+    pendingOnDevice_ = true;
+    return true;
+#else
+    (void)frame;
+    return false;
+#endif
+}
+
+bool ActivityEstimator::pollDevice(float& activity) {
+#if defined(HAVE_CUDA) && defined(HAVE_CUDA_KERNELS)
+    cuCtxPushCurrent(context_);
+    const CUresult result = cuEventQuery(done_);
+    cuCtxPopCurrent(nullptr);
+
+    if (result == CUDA_ERROR_NOT_READY) {
+        return false;
+    }
+
+    pending_ = false;
+    source_.reset();   // Surface back to the decoder
+
+    if (result != CUDA_SUCCESS) {
+        havePrevious_ = false;
+        return false;
+    }
+    if (!havePrevious_) {
+        havePrevious_ = true;
+        return false;
+    }
+
+    const auto* counts = static_cast<const ActivityCounts*>(hostCounts_);
+    activity = static_cast<float>(counts->changedCells) / static_cast<float>(cellCount());
+    return true;
+#else
+    (void)activity;
+    pending_ = false;
+    return false;
+#endif
+}
+
+void ActivityEstimator::release() {
+#if defined(HAVE_CUDA) && defined(HAVE_CUDA_KERNELS)
+    if (!context_) {
+        return;
+    }
+
+    cuCtxPushCurrent(context_);
+    if (stream_) {
+        cuStreamSynchronize(stream_);   // The kernel may still read the source surface
+        cuStreamDestroy(stream_);
+    }
+    if (done_) {
+        cuEventDestroy(done_);
+    }
+    for (CUdeviceptr& grid : deviceGrids_) {
+        if (grid) {
+            cuMemFree(grid);
+        }
+        grid = 0;
+    }
+    if (deviceCounts_) {
+        cuMemFree(deviceCounts_);
+    }
+    if (hostCounts_) {
+        cuMemFreeHost(hostCounts_);
+    }
+    cuCtxPopCurrent(nullptr);
+
+    stream_ = nullptr;
+    done_ = nullptr;
+    deviceCounts_ = 0;
+    hostCounts_ = nullptr;
+    context_ = nullptr;
+    source_.reset();
+    if (pendingOnDevice_) {
+        pending_ = false;
+    }
+#endif
+}
+
+} // namespace gpu
+} // namespace fluxvision
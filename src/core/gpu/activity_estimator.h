@@ -0,0 +1,93 @@
+// src/core/gpu/activity_estimator.h
+// Scene activity of a camera from its decoded luma, measured on a coarse grid
+#pragma once
+
+#include "../codec/frame_lease.h"
+#include <cstdint>
+#include <vector>
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#endif
+
+namespace fluxvision {
+namespace gpu {
+
+// Activity estimator
+//
+// Reduces the Y plane of a decoded frame to the mean luma of each cell of a
+// gridWidth x gridHeight grid (16 x 16 samples per cell, not every pixel) and
+// compares it with the previous measurement: the activity is the fraction of
+// cells whose mean moved by more than cellThreshold. Noise and compression
+// flicker average out within a cell; a person crossing a corridor does not.
+//
+// Device frames are measured by one small kernel on the estimator's own
+// non-blocking stream in the shared context of Config::cudaDeviceId; the
+// result is copied to pinned memory and picked up by a later poll(), which
+// never waits on the GPU. The source frame is held until then. Host frames
+// (CPU decoder) are measured on the spot. One measurement is pending at a
+// time.
+//
+// Thread-safety: one thread at a time (the camera's decode consumer)
+class ActivityEstimator {
+public:
+    struct Config {
+        int cudaDeviceId = 0;
+        int gridWidth = 32;       // 60 x 60 pixel cells at 1080p
+        int gridHeight = 18;
+        int cellThreshold = 8;    // Mean luma change (0-255) that marks a cell as changed
+    };
+
+    explicit ActivityEstimator(const Config& config);
+    ~ActivityEstimator();
+
+    // Delete copy/move
+    ActivityEstimator(const ActivityEstimator&) = delete;
+    ActivityEstimator& operator=(const ActivityEstimator&) = delete;
+
+    // Create the stream and grids for device frames
+    // Returns: false without CUDA kernels (host frames are still measured)
+    bool initialize();
+
+    // A measurement is queued and not yet picked up
+    bool isBusy() const { return pending_; }
+
+    // Start measuring a frame (NV12/YUV420P, device or host)
+    // Returns: false if busy or the frame can't be measured
+    bool submit(const FrameHandle& frame);
+
+    // The latest measurement, once finished (never waits)
+    // Returns: false if none finished, or it had no earlier frame to compare with
+    bool poll(float& activity);
+
+private:
+    Config config_;
+    bool pending_ = false;
+    bool pendingOnDevice_ = false;
+    bool havePrevious_ = false;
+    bool previousOnDevice_ = false;  // Where the previous grid lives (decoder fell back to the CPU)
+    float hostActivity_ = 0.0f;
+
+    std::vector<uint8_t> hostGrids_[2];
+    int hostCurrent_ = 0;
+
+#if defined(HAVE_CUDA) && defined(HAVE_CUDA_KERNELS)
+    CUcontext context_ = nullptr;
+    CUstream stream_ = nullptr;
+    CUevent done_ = nullptr;
+    CUdeviceptr deviceGrids_[2] = {};
+    CUdeviceptr deviceCounts_ = 0;
+    void* hostCounts_ = nullptr;      // Pinned ActivityCounts
+    int deviceCurrent_ = 0;
+    FrameHandle source_;              // Keeps the surface valid until the kernel is done
+#endif
+
+    int cellCount() const { return config_.gridWidth * config_.gridHeight; }
+    bool measureHost(const DecodedFrame& frame);
+    bool submitDevice(const FrameHandle& frame);
+    bool pollDevice(float& activity);
+    void release();
+};
+
+} // namespace gpu
+} // namespace fluxvision
@@ -0,0 +1,27 @@
+// src/core/gpu/activity_kernels.h
+// Low-resolution luma change measurement (CUDA kernel, host interface)
+// Plain C++: included by host code, implemented in activity.cu
+#pragma once
+
+#include <cstdint>
+
+namespace fluxvision {
+namespace gpu {
+
+// Result of one measurement (device memory, zeroed before each launch)
+struct ActivityCounts {
+    uint32_t changedCells = 0;   // Cells whose mean luma moved by more than the threshold
+    uint32_t sad = 0;            // Sum of absolute mean differences over all cells
+};
+
+// Mean luma of each gridWidth x gridHeight cell of the Y plane (sampled, not
+// every pixel) into current[], compared against previous[] into counts
+// luma: CUdeviceptr of the Y plane; current/previous/counts: device buffers
+// Asynchronous on stream (a CUstream); returns the launch's cudaError_t (0 = queued)
+int launchActivityGrid(uint64_t luma, int pitch, int width, int height,
+                       int gridWidth, int gridHeight, int cellThreshold,
+                       uint8_t* current, const uint8_t* previous,
+                       ActivityCounts* counts, void* stream);
+
+} // namespace gpu
+} // namespace fluxvision
@@ -0,0 +1,104 @@
+// src/core/gpu/color_convert.cu
+// Batched NV12 -> RGBA/BGR conversion with bilinear scaling
+#include "color_convert_kernels.h"
+#include <cuda_runtime.h>
+
+namespace fluxvision {
+namespace gpu {
+
+namespace {
+    constexpr int kBlockWidth = 32;
+    constexpr int kBlockHeight = 8;
+
+    // Per ColorMatrix: luma scale, luma offset, then Cr->R, Cb->G, Cr->G, Cb->B
+    __constant__ float kCoefficients[4][6] = {
+        {1.164383f, 16.0f, 1.596027f, -0.391762f, -0.812968f, 2.017232f},  // BT.601 limited
+        {1.0f,       0.0f, 1.402000f, -0.344136f, -0.714136f, 1.772000f},  // BT.601 full
+        {1.164383f, 16.0f, 1.792741f, -0.213249f, -0.532909f, 2.112402f},  // BT.709 limited
+        {1.0f,       0.0f, 1.574800f, -0.187324f, -0.468124f, 1.855600f},  // BT.709 full
+    };
+
+    __device__ __forceinline__ unsigned char clampByte(float value) {
+        return static_cast<unsigned char>(fminf(fmaxf(value + 0.5f, 0.0f), 255.0f));
+    }
+
+    // Bilinear sample of one channel (stride bytes between samples) at plane coordinates x, y
+    __device__ __forceinline__ float sample(const unsigned char* plane, int pitch, int stride,
+                                            int width, int height, float x, float y) {
+        x = fminf(fmaxf(x, 0.0f), static_cast<float>(width - 1));
+        y = fminf(fmaxf(y, 0.0f), static_cast<float>(height - 1));
+
+        const int x0 = static_cast<int>(x);
+        const int y0 = static_cast<int>(y);
+        const int x1 = min(x0 + 1, width - 1);
+        const int y1 = min(y0 + 1, height - 1);
+        const float fx = x - x0;
+        const float fy = y - y0;
+
+        const unsigned char* row0 = plane + y0 * pitch;
+        const unsigned char* row1 = plane + y1 * pitch;
+        const float top = row0[x0 * stride] + (row0[x1 * stride] - row0[x0 * stride]) * fx;
+        const float bottom = row1[x0 * stride] + (row1[x1 * stride] - row1[x0 * stride]) * fx;
+        return top + (bottom - top) * fy;
+    }
+
+    // blockIdx.z selects the job; threads outside that job's output return early
+    __global__ void convertBatch(const ConvertJob* jobs) {
+        const ConvertJob& job = jobs[blockIdx.z];
+
+        const int x = blockIdx.x * blockDim.x + threadIdx.x;
+        const int y = blockIdx.y * blockDim.y + threadIdx.y;
+        if (x >= job.dstWidth || y >= job.dstHeight) {
+            return;
+        }
+
+        // Pixel centres of the output mapped onto the source
+        const float scaleX = static_cast<float>(job.srcWidth) / job.dstWidth;
+        const float scaleY = static_cast<float>(job.srcHeight) / job.dstHeight;
+        const float sx = (x + 0.5f) * scaleX - 0.5f;
+        const float sy = (y + 0.5f) * scaleY - 0.5f;
+        const float cx = (x + 0.5f) * scaleX * 0.5f - 0.5f;
+        const float cy = (y + 0.5f) * scaleY * 0.5f - 0.5f;
+
+        const auto* luma = reinterpret_cast<const unsigned char*>(job.srcLuma);
+        const auto* chroma = reinterpret_cast<const unsigned char*>(job.srcChroma);
+        const int chromaWidth = (job.srcWidth + 1) / 2;
+        const int chromaHeight = (job.srcHeight + 1) / 2;
+
+        const float* k = kCoefficients[job.matrix & 0x3];
+        const float yv = (sample(luma, job.srcPitch, 1, job.srcWidth, job.srcHeight, sx, sy) - k[1]) * k[0];
+        const float cb = sample(chroma, job.srcPitch, 2, chromaWidth, chromaHeight, cx, cy) - 128.0f;
+        const float cr = sample(chroma + 1, job.srcPitch, 2, chromaWidth, chromaHeight, cx, cy) - 128.0f;
+
+        const unsigned char r = clampByte(yv + k[2] * cr);
+        const unsigned char g = clampByte(yv + k[3] * cb + k[4] * cr);
+        const unsigned char b = clampByte(yv + k[5] * cb);
+
+        unsigned char* out = reinterpret_cast<unsigned char*>(job.dst) + y * job.dstPitch;
+        if (job.channels == 4) {
+            reinterpret_cast<uchar4*>(out)[x] = make_uchar4(r, g, b, 255);
+        } else {
+            out += x * 3;
+            out[0] = b;
+            out[1] = g;
+            out[2] = r;
+        }
+    }
+}
+
+int launchConvertBatch(const ConvertJob* deviceJobs, int count,
+                       int maxDstWidth, int maxDstHeight, void* stream) {
+    if (count <= 0 || maxDstWidth <= 0 || maxDstHeight <= 0) {
+        return cudaSuccess;
+    }
+
+    const dim3 block(kBlockWidth, kBlockHeight);
+    const dim3 grid((maxDstWidth + kBlockWidth - 1) / kBlockWidth,
+                    (maxDstHeight + kBlockHeight - 1) / kBlockHeight,
+                    count);
+    convertBatch<<<grid, block, 0, static_cast<cudaStream_t>(stream)>>>(deviceJobs);
+    return static_cast<int>(cudaGetLastError());
+}
+
+} // namespace gpu
+} // namespace fluxvision
@@ -0,0 +1,52 @@
+// src/core/gpu/color_convert_kernels.h
+// Batched NV12 -> RGBA/BGR conversion with bilinear scaling (CUDA kernels, host interface)
+// Plain C++: included by host code, implemented in color_convert.cu
+#pragma once
+
+#include <cstdint>
+
+namespace fluxvision {
+namespace gpu {
+
+// YUV -> RGB coefficients used by a conversion
+enum class ColorMatrix : uint8_t {
+    BT601_LIMITED = 0,   // SD cameras (studio swing 16-235)
+    BT601_FULL = 1,
+    BT709_LIMITED = 2,   // HD cameras
+    BT709_FULL = 3
+};
+
+// Cameras rarely signal colour primaries: follow the resolution like most players
+inline ColorMatrix colorMatrixFor(uint32_t sourceHeight, bool fullRange) {
+    if (sourceHeight >= 720) {
+        return fullRange ? ColorMatrix::BT709_FULL : ColorMatrix::BT709_LIMITED;
+    }
+    return fullRange ? ColorMatrix::BT601_FULL : ColorMatrix::BT601_LIMITED;
+}
+
+// One frame of a batched launch (plain data, copied to the device per launch)
+struct ConvertJob {
+    uint64_t srcLuma = 0;      // CUdeviceptr of the Y plane
+    uint64_t srcChroma = 0;    // CUdeviceptr of the interleaved UV plane
+    int32_t srcPitch = 0;      // Bytes per row (both planes)
+    int32_t srcWidth = 0;
+    int32_t srcHeight = 0;
+
+    uint64_t dst = 0;          // CUdeviceptr of the packed RGBA/BGR output
+    int32_t dstPitch = 0;
+    int32_t dstWidth = 0;
+    int32_t dstHeight = 0;
+
+    uint8_t channels = 4;      // 4 = RGBA (alpha 255), 3 = BGR
+    uint8_t matrix = 0;        // ColorMatrix
+    uint8_t reserved[2] = {};
+};
+
+// Convert and scale deviceJobs[0..count) in one kernel launch on stream (a CUstream)
+// maxDstWidth/maxDstHeight: largest output in the batch (sizes the grid)
+// Asynchronous; returns the launch's cudaError_t (0 = queued)
+int launchConvertBatch(const ConvertJob* deviceJobs, int count,
+                       int maxDstWidth, int maxDstHeight, void* stream);
+
+} // namespace gpu
+} // namespace fluxvision
@@ -2,11 +2,13 @@
 #include "cuda_context.h"
 #include <cstring>
 #include <iostream>
+#include <map>
 
 namespace fluxvision {
 
-CudaContext::CudaContext()
-    : initialized_(false)
+CudaContext::CudaContext(int deviceId)
+    : deviceId_(deviceId)
+    , initialized_(false)
 #ifdef HAVE_CUDA
     , context_(nullptr)
     , device_(0)
@@ -30,9 +32,33 @@ CudaContext::~CudaContext() {
     initialized_ = false;
 }
 
-CudaContext& CudaContext::getInstance() {
-    static CudaContext instance;
-    return instance;
+CudaContext& CudaContext::getInstance(int deviceId) {
+    static std::mutex instancesMutex;
+    static std::map<int, std::unique_ptr<CudaContext>> instances;
+
+    std::lock_guard<std::mutex> lock(instancesMutex);
+
+    auto& instance = instances[deviceId];
+    if (!instance) {
+        instance.reset(new CudaContext(deviceId));
+    }
+    return *instance;
+}
+
+int CudaContext::getDeviceCount() {
+#ifdef HAVE_CUDA
+    if (cuInit(0) != CUDA_SUCCESS) {
+        return 0;
+    }
+
+    int deviceCount = 0;
+    if (cuDeviceGetCount(&deviceCount) != CUDA_SUCCESS) {
+        return 0;
+    }
+    return deviceCount;
+#else
+    return 0;
+#endif
 }
 
 bool CudaContext::initialize() {
@@ -60,12 +86,18 @@ bool CudaContext::initialize() {
         return false;
     }
 
-    // Use first device (device 0)
-    result = cuDeviceGet(&device_, 0);
+    if (deviceId_ < 0 || deviceId_ >= deviceCount) {
+        std::cerr << "CUDA device " << deviceId_ << " not found (" << deviceCount
+                  << " devices)" << std::endl;
+        return false;
+    }
+
+    result = cuDeviceGet(&device_, deviceId_);
     if (result != CUDA_SUCCESS) {
         const char* errorStr = nullptr;
         cuGetErrorString(result, &errorStr);
-        std::cerr << "Failed to get CUDA device: " << (errorStr ? errorStr : "Unknown error") << std::endl;
+        std::cerr << "Failed to get CUDA device " << deviceId_ << ": "
+                  << (errorStr ? errorStr : "Unknown error") << std::endl;
         return false;
     }
 
@@ -87,7 +119,7 @@ bool CudaContext::initialize() {
     initialized_ = true;
 
     std::cout << "CUDA initialized successfully:" << std::endl;
-    std::cout << "  Device: " << deviceName_ << std::endl;
+    std::cout << "  Device " << deviceId_ << ": " << deviceName_ << std::endl;
     std::cout << "  Compute Capability: " << computeMajor_ << "." << computeMinor_ << std::endl;
     std::cout << "  Total Memory: " << (totalMemory_ / (1024 * 1024)) << " MB" << std::endl;
 
@@ -1,19 +1,23 @@
 // src/core/gpu/cuda_context.h
-// CUDA context singleton - shared across all NVDEC decoders
+// CUDA context per device - shared across the NVDEC decoders on that device
 #pragma once
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
 #endif
 
+#include <memory>
 #include <mutex>
 
 namespace fluxvision {
 
 class CudaContext {
 public:
-    // Get singleton instance
-    static CudaContext& getInstance();
+    // Get the instance for a device (one per device, created on first use)
+    static CudaContext& getInstance(int deviceId = 0);
+
+    // Number of CUDA devices (0 if CUDA is unavailable)
+    static int getDeviceCount();
 
     // Initialize CUDA context (thread-safe)
     bool initialize();
@@ -21,6 +25,9 @@ public:
     // Check if CUDA is available and initialized
     bool isInitialized() const { return initialized_; }
 
+    // Device this instance belongs to
+    int getDeviceId() const { return deviceId_; }
+
 #ifdef HAVE_CUDA
     // Get CUDA context (for NVDEC decoders)
     CUcontext getContext() const { return context_; }
@@ -47,9 +54,12 @@ public:
     CudaContext& operator=(const CudaContext&) = delete;
 
 private:
-    CudaContext();
+    friend struct std::default_delete<CudaContext>;
+
+    explicit CudaContext(int deviceId);
     ~CudaContext();
 
+    const int deviceId_;
     bool initialized_;
     std::mutex initMutex_;
 
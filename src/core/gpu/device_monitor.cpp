@@ -0,0 +1,91 @@
+// src/core/gpu/device_monitor.cpp
+#include "device_monitor.h"
+#include <iostream>
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#endif
+
+#ifdef HAVE_NVML
+#include <nvml.h>
+#endif
+
+namespace fluxvision {
+namespace gpu {
+
+DeviceMonitor& DeviceMonitor::instance() {
+    static DeviceMonitor monitor;
+    return monitor;
+}
+
+DeviceMonitor::~DeviceMonitor() {
+#ifdef HAVE_NVML
+    if (initialized_) {
+        nvmlShutdown();
+    }
+#endif
+}
+
+int DeviceMonitor::getDecoderUtilization(int cudaDeviceId) {
+#if defined(HAVE_CUDA) && defined(HAVE_NVML)
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    void* device = findDevice(cudaDeviceId);
+    if (!device) {
+        return -1;
+    }
+
+    unsigned int utilization = 0;
+    unsigned int samplingPeriodUs = 0;
+    if (nvmlDeviceGetDecoderUtilization(static_cast<nvmlDevice_t>(device), &utilization,
+                                        &samplingPeriodUs) != NVML_SUCCESS) {
+        return -1;
+    }
+    return static_cast<int>(utilization);
+#else
+    (void)cudaDeviceId;
+    return -1;
+#endif
+}
+
+void* DeviceMonitor::findDevice(int cudaDeviceId) {
+#if defined(HAVE_CUDA) && defined(HAVE_NVML)
+    auto known = devices_.find(cudaDeviceId);
+    if (known != devices_.end()) {
+        return known->second;
+    }
+
+    if (unavailable_) {
+        return nullptr;
+    }
+
+    if (!initialized_) {
+        const nvmlReturn_t result = nvmlInit();
+        if (result != NVML_SUCCESS) {
+            std::cerr << "DeviceMonitor: NVML unavailable: " << nvmlErrorString(result) << std::endl;
+            unavailable_ = true;
+            return nullptr;
+        }
+        initialized_ = true;
+    }
+
+    // Not found is remembered too
+    nvmlDevice_t handle = nullptr;
+    CUdevice cuDevice = 0;
+    char busId[32] = {};
+    if (cuInit(0) != CUDA_SUCCESS || cuDeviceGet(&cuDevice, cudaDeviceId) != CUDA_SUCCESS ||
+        cuDeviceGetPCIBusId(busId, static_cast<int>(sizeof(busId)), cuDevice) != CUDA_SUCCESS ||
+        nvmlDeviceGetHandleByPciBusId(busId, &handle) != NVML_SUCCESS) {
+        handle = nullptr;
+    }
+
+    devices_[cudaDeviceId] = handle;
+    return handle;
+#else
+    (void)cudaDeviceId;
+    return nullptr;
+#endif
+}
+
+} // namespace gpu
+} // namespace fluxvision
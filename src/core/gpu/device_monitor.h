@@ -0,0 +1,43 @@
+// src/core/gpu/device_monitor.h
+// Measured NVDEC engine utilization per CUDA device (NVML)
+#pragma once
+
+#include <map>
+#include <mutex>
+
+namespace fluxvision {
+namespace gpu {
+
+// Process-wide NVML session
+//
+// NVML numbers devices differently from CUDA, so devices are matched by PCI
+// bus id. NVML is initialized at the first query and shut down with the
+// process. Builds without NVML (HAVE_NVML), or drivers that refuse the query,
+// report -1 and callers fall back to their own estimate.
+//
+// Thread-safety: all methods may be called from any thread
+class DeviceMonitor {
+public:
+    static DeviceMonitor& instance();
+
+    // Decode engine busy percentage (0-100) over the driver's last sampling
+    // period, -1 if unavailable
+    int getDecoderUtilization(int cudaDeviceId);
+
+private:
+    DeviceMonitor() = default;
+    ~DeviceMonitor();
+
+    DeviceMonitor(const DeviceMonitor&) = delete;
+    DeviceMonitor& operator=(const DeviceMonitor&) = delete;
+
+    std::mutex mutex_;
+    bool initialized_ = false;
+    bool unavailable_ = false;       // Init failed: don't retry on every query
+    std::map<int, void*> devices_;   // CUDA ordinal -> nvmlDevice_t (nullptr: not found)
+
+    void* findDevice(int cudaDeviceId);  // mutex_ held
+};
+
+} // namespace gpu
+} // namespace fluxvision
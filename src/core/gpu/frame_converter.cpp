@@ -0,0 +1,363 @@
+// src/core/gpu/frame_converter.cpp
+#include "frame_converter.h"
+#include <algorithm>
+#include <iostream>
+
+namespace fluxvision {
+namespace gpu {
+
+namespace {
+    constexpr uint32_t kMaxOutputDimension = 8192;
+
+    int channelsOf(PixelFormat format) {
+        return format == PixelFormat::BGR ? 3 : 4;
+    }
+}
+
+FrameConverter::FrameConverter(const Config& config)
+    : config_(config)
+{
+    config_.maxBatch = std::max<size_t>(1, std::min<size_t>(config_.maxBatch, 65535));  // Grid z limit
+    config_.maxPending = std::max(config_.maxPending, config_.maxBatch);
+}
+
+FrameConverter::~FrameConverter() {
+    // Outputs hold a reference to the converter, so every buffer left is idle
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto& output : outputs_) {
+        freeOutput(output);
+    }
+    outputs_.clear();
+
+#ifdef HAVE_CUDA
+    if (context_) {
+        cuCtxPushCurrent(context_);
+        if (stream_) {
+            cuStreamDestroy(stream_);
+        }
+        if (deviceJobs_) {
+            cuMemFree(deviceJobs_);
+        }
+        if (pinnedJobs_) {
+            cuMemFreeHost(pinnedJobs_);
+        }
+        cuCtxPopCurrent(nullptr);
+    }
+#endif
+}
+
+bool FrameConverter::initialize() {
+    if (initialized_) {
+        return true;
+    }
+
+    // Output handles keep the converter alive through a shared reference
+    if (weak_from_this().expired()) {
+        std::cerr << "FrameConverter: must be owned by a std::shared_ptr" << std::endl;
+        return false;
+    }
+
+#if defined(HAVE_CUDA) && defined(HAVE_CUDA_KERNELS)
+    if (cuCtxGetCurrent(&context_) != CUDA_SUCCESS || !context_) {
+        std::cerr << "FrameConverter: no current CUDA context" << std::endl;
+        context_ = nullptr;
+        return false;
+    }
+
+    // Own non-blocking stream: never serializes with decode work on the legacy stream
+    CUresult result = cuStreamCreate(&stream_, CU_STREAM_NON_BLOCKING);
+    if (result == CUDA_SUCCESS) {
+        result = cuMemHostAlloc(reinterpret_cast<void**>(&pinnedJobs_),
+                                config_.maxBatch * sizeof(ConvertJob), 0);
+    }
+    if (result == CUDA_SUCCESS) {
+        result = cuMemAlloc(&deviceJobs_, config_.maxBatch * sizeof(ConvertJob));
+    }
+    if (result != CUDA_SUCCESS) {
+        const char* errorStr = nullptr;
+        cuGetErrorString(result, &errorStr);
+        std::cerr << "FrameConverter: failed to create stream or batch buffers: "
+                  << (errorStr ? errorStr : "Unknown error") << std::endl;
+        return false;  // Partial state is released by the destructor
+    }
+
+    batch_.reserve(config_.maxBatch);
+    claimed_.reserve(config_.maxBatch);
+    initialized_ = true;
+    return true;
+#else
+    std::cerr << "FrameConverter: built without CUDA kernels" << std::endl;
+    return false;
+#endif
+}
+
+bool FrameConverter::submit(uint64_t tag, const FrameHandle& frame, const Request& request) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const bool convertible = initialized_ && frame && frame->format == PixelFormat::NV12 &&
+                             frame->cudaSurface && frame->data[0] && frame->data[1] &&
+                             frame->width > 0 && frame->height > 0;
+    const bool validRequest = (request.format == PixelFormat::RGBA || request.format == PixelFormat::BGR) &&
+                              request.width <= kMaxOutputDimension && request.height <= kMaxOutputDimension;
+    if (!convertible || !validRequest) {
+        stats_.rejected++;
+        return false;
+    }
+
+    stats_.submitted++;
+
+    // Newest frame wins: the queued one would be stale by the time it's shown
+    for (auto& pending : pending_) {
+        if (pending.tag == tag) {
+            pending.source = frame;
+            pending.request = request;
+            stats_.superseded++;
+            return true;
+        }
+    }
+
+    if (pending_.size() >= config_.maxPending) {
+        stats_.submitted--;
+        stats_.rejected++;
+        return false;
+    }
+
+    pending_.push_back(Pending{tag, frame, request});
+    return true;
+}
+
+bool FrameConverter::flush(std::vector<Result>& results) {
+    results.clear();
+    if (!initialized_) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const size_t count = std::min(pending_.size(), config_.maxBatch);
+        batch_.assign(std::make_move_iterator(pending_.begin()),
+                      std::make_move_iterator(pending_.begin() + static_cast<std::ptrdiff_t>(count)));
+        pending_.erase(pending_.begin(), pending_.begin() + static_cast<std::ptrdiff_t>(count));
+    }
+
+    if (batch_.empty()) {
+        return true;
+    }
+
+#if defined(HAVE_CUDA) && defined(HAVE_CUDA_KERNELS)
+    cuCtxPushCurrent(context_);
+
+    // Claim outputs and describe each job; a frame without an output is dropped
+    int jobs = 0;
+    int maxWidth = 0;
+    int maxHeight = 0;
+    claimed_.clear();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto it = batch_.begin(); it != batch_.end();) {
+            const DecodedFrame& source = *it->source;
+            const uint32_t width = it->request.width ? it->request.width : source.width;
+            const uint32_t height = it->request.height ? it->request.height : source.height;
+
+            Output output;
+            if (!acquireOutput(width, height, it->request.format, output)) {
+                stats_.failed++;
+                it = batch_.erase(it);
+                continue;
+            }
+
+            ConvertJob& job = pinnedJobs_[jobs++];
+            job = ConvertJob{};
+            job.srcLuma = reinterpret_cast<uint64_t>(source.data[0]);
+            job.srcChroma = reinterpret_cast<uint64_t>(source.data[1]);
+            job.srcPitch = source.pitch[0];
+            job.srcWidth = static_cast<int32_t>(source.width);
+            job.srcHeight = static_cast<int32_t>(source.height);
+            job.dst = output.devicePtr;
+            job.dstPitch = static_cast<int32_t>(output.pitch);
+            job.dstWidth = static_cast<int32_t>(width);
+            job.dstHeight = static_cast<int32_t>(height);
+            job.channels = static_cast<uint8_t>(channelsOf(it->request.format));
+            job.matrix = static_cast<uint8_t>(colorMatrixFor(source.height, it->request.fullRange));
+
+            maxWidth = std::max(maxWidth, job.dstWidth);
+            maxHeight = std::max(maxHeight, job.dstHeight);
+            claimed_.push_back(output);
+            ++it;
+        }
+    }
+
+    // One upload and one launch for the whole batch, then wait for this stream only
+    bool ok = true;
+    if (jobs > 0) {
+        CUresult result = cuMemcpyHtoDAsync(deviceJobs_, pinnedJobs_, jobs * sizeof(ConvertJob), stream_);
+        int launch = 0;
+        if (result == CUDA_SUCCESS) {
+            launch = launchConvertBatch(reinterpret_cast<const ConvertJob*>(deviceJobs_), jobs,
+                                        maxWidth, maxHeight, stream_);
+        }
+        if (result == CUDA_SUCCESS && launch == 0) {
+            result = cuStreamSynchronize(stream_);
+        }
+        ok = result == CUDA_SUCCESS && launch == 0;
+
+        if (!ok) {
+            std::cerr << "FrameConverter: batch of " << jobs << " failed (CUDA " << result
+                      << ", launch " << launch << ")" << std::endl;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (ok) {
+            stats_.launches += jobs > 0 ? 1 : 0;
+            stats_.converted += static_cast<uint64_t>(jobs);
+        } else {
+            stats_.failed += static_cast<uint64_t>(jobs);
+            for (const Output& output : claimed_) {
+                for (auto& owned : outputs_) {
+                    if (owned.id == output.id) {
+                        owned.inUse = false;
+                    }
+                }
+            }
+        }
+    }
+
+    if (ok) {
+        auto self = shared_from_this();
+        results.reserve(claimed_.size());
+        for (size_t i = 0; i < claimed_.size(); ++i) {
+            const DecodedFrame& source = *batch_[i].source;
+            const Output& output = claimed_[i];
+
+            DecodedFrame frame = {};
+            frame.data[0] = reinterpret_cast<uint8_t*>(output.devicePtr);
+            frame.pitch[0] = static_cast<int>(output.pitch);
+            frame.width = output.width;
+            frame.height = output.height;
+            frame.format = output.format;
+            frame.pts = source.pts;
+            frame.dts = source.dts;
+            frame.isKeyframe = source.isKeyframe;
+            frame.cudaSurface = reinterpret_cast<void*>(output.devicePtr);
+            frame.cudaPitch = static_cast<int>(output.pitch);
+
+            results.push_back(Result{batch_[i].tag, makeFrameHandle(FrameLease(frame, self, output.id))});
+        }
+    }
+
+    // Sources go back to their decoders now that the kernel has read them
+    batch_.clear();
+    claimed_.clear();
+    cuCtxPopCurrent(nullptr);
+    return ok;
+#else
+    batch_.clear();
+    return false;
+#endif
+}
+
+void FrameConverter::releaseLease(uint64_t token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = outputs_.begin(); it != outputs_.end(); ++it) {
+        if (it->id != token) {
+            continue;
+        }
+
+        it->inUse = false;
+        if (idleOutputs(it->width, it->height, it->format) > config_.maxCachedOutputs) {
+            freeOutput(*it);
+            outputs_.erase(it);
+        }
+        return;
+    }
+}
+
+void FrameConverter::trim() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (auto it = outputs_.begin(); it != outputs_.end();) {
+        if (!it->inUse) {
+            freeOutput(*it);
+            it = outputs_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+FrameConverter::Stats FrameConverter::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats = stats_;
+    stats.pending = pending_.size();
+    stats.outputBuffers = outputs_.size();
+    stats.outputBytes = outputBytes_;
+    return stats;
+}
+
+bool FrameConverter::acquireOutput(uint32_t width, uint32_t height, PixelFormat format, Output& output) {
+    for (auto& candidate : outputs_) {
+        if (!candidate.inUse && candidate.width == width && candidate.height == height &&
+            candidate.format == format) {
+            candidate.inUse = true;
+            output = candidate;
+            return true;
+        }
+    }
+
+#ifdef HAVE_CUDA
+    // Called from flush() with the context pushed
+    CUdeviceptr devicePtr = 0;
+    size_t pitch = 0;
+    const size_t rowBytes = static_cast<size_t>(width) * channelsOf(format);
+    CUresult result = cuMemAllocPitch(&devicePtr, &pitch, rowBytes, height, 16);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "FrameConverter: cuMemAllocPitch " << width << "x" << height
+                  << " failed: " << result << std::endl;
+        return false;
+    }
+
+    output = Output{};
+    output.id = nextOutputId_++;
+    output.devicePtr = static_cast<uint64_t>(devicePtr);
+    output.pitch = pitch;
+    output.width = width;
+    output.height = height;
+    output.format = format;
+    output.bytes = pitch * height;
+    output.inUse = true;
+
+    outputs_.push_back(output);
+    outputBytes_ += output.bytes;
+    return true;
+#else
+    (void)output;
+    return false;
+#endif
+}
+
+void FrameConverter::freeOutput(Output& output) {
+#ifdef HAVE_CUDA
+    if (output.devicePtr) {
+        cuCtxPushCurrent(context_);
+        cuMemFree(static_cast<CUdeviceptr>(output.devicePtr));
+        cuCtxPopCurrent(nullptr);
+    }
+#endif
+
+    outputBytes_ -= std::min(outputBytes_, output.bytes);
+    output = Output{};
+}
+
+size_t FrameConverter::idleOutputs(uint32_t width, uint32_t height, PixelFormat format) const {
+    return static_cast<size_t>(std::count_if(outputs_.begin(), outputs_.end(), [&](const Output& output) {
+        return !output.inUse && output.width == width && output.height == height &&
+               output.format == format;
+    }));
+}
+
+} // namespace gpu
+} // namespace fluxvision
@@ -0,0 +1,144 @@
+// src/core/gpu/frame_converter.h
+// Batched GPU post-processing: NV12 decoder output -> scaled RGBA/BGR in device memory
+#pragma once
+
+#include "../codec/frame_lease.h"
+#include "color_convert_kernels.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#endif
+
+namespace fluxvision {
+namespace gpu {
+
+// GPU frame converter
+//
+// Decoded NV12 frames (any thread, typically the decode worker that produced
+// them) are queued with submit(); once per display or inference tick, flush()
+// converts and scales everything queued in a single kernel launch on the
+// converter's own CUDA stream, so decode work never waits behind it and no
+// pixels cross PCIe. Results are RGBA or BGR DecodedFrames in device memory
+// (data[0] and cudaSurface point at the pixels), recycled through per-shape
+// free lists when their last handle is dropped.
+//
+// Each tag (usually one per camera and output) keeps only its newest frame
+// until the next flush: a picture superseded before the tick is never converted.
+//
+// Runs in the CUDA context current when initialize() is called (a decode
+// worker's); source frames must live on that device.
+//
+// Thread-safety: submit() and output releases from any thread; flush() from
+// one thread at a time. Create with std::make_shared (outputs keep it alive).
+class FrameConverter : public FrameLease::Owner,
+                       public std::enable_shared_from_this<FrameConverter> {
+public:
+    struct Config {
+        size_t maxBatch = 64;             // Frames per launch; the rest wait for the next flush
+        size_t maxPending = 256;          // Distinct tags queued at once
+        size_t maxCachedOutputs = 4;      // Idle output buffers kept per shape
+    };
+
+    // Output of one submission
+    struct Request {
+        PixelFormat format = PixelFormat::RGBA;  // RGBA or BGR
+        uint32_t width = 0;               // Output size (0 = source size)
+        uint32_t height = 0;
+        bool fullRange = false;           // Source uses 0-255 luma (most cameras signal 16-235)
+    };
+
+    struct Result {
+        uint64_t tag = 0;                 // As passed to submit()
+        FrameHandle frame;                // Converted frame (pts/dts/isKeyframe of the source)
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t superseded = 0;          // Replaced by a newer frame with the same tag before a flush
+        uint64_t rejected = 0;            // Not an NV12 device frame, bad request, or queue full
+        uint64_t converted = 0;
+        uint64_t failed = 0;              // Output allocation or launch failures
+        uint64_t launches = 0;            // Kernel launches (one per non-empty flush)
+        size_t pending = 0;
+        size_t outputBuffers = 0;         // Allocated (in use + cached)
+        size_t outputBytes = 0;
+    };
+
+    explicit FrameConverter(const Config& config);
+    ~FrameConverter() override;
+
+    // Delete copy/move
+    FrameConverter(const FrameConverter&) = delete;
+    FrameConverter& operator=(const FrameConverter&) = delete;
+
+    // Create the stream and batch buffers in the current CUDA context
+    bool initialize();
+    bool isInitialized() const { return initialized_; }
+
+    // Queue a frame for the next flush (replaces a frame still queued under tag)
+    // Returns: false if the frame or request can't be converted here
+    bool submit(uint64_t tag, const FrameHandle& frame, const Request& request);
+
+    // Convert up to maxBatch queued frames in one launch and wait for that
+    // stream only; results are ready to use on any stream afterwards
+    // Returns: false if the launch failed (its frames are dropped)
+    bool flush(std::vector<Result>& results);
+
+    // Output buffer returned by its last handle (any thread)
+    void releaseLease(uint64_t token) override;
+
+    // Free idle output buffers
+    void trim();
+
+    Stats getStats() const;
+
+private:
+    struct Pending {
+        uint64_t tag = 0;
+        FrameHandle source;
+        Request request;
+    };
+
+    struct Output {
+        uint64_t id = 0;
+        uint64_t devicePtr = 0;          // CUdeviceptr
+        size_t pitch = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        PixelFormat format = PixelFormat::RGBA;
+        size_t bytes = 0;
+        bool inUse = false;
+    };
+
+    Config config_;
+    bool initialized_ = false;
+
+    mutable std::mutex mutex_;
+    std::vector<Pending> pending_;       // Insertion order (oldest converted first)
+    std::vector<Output> outputs_;
+    uint64_t nextOutputId_ = 1;
+    size_t outputBytes_ = 0;
+    Stats stats_;
+
+    // flush() only
+    std::vector<Pending> batch_;
+    std::vector<Output> claimed_;        // Output per converted batch_ entry
+
+#ifdef HAVE_CUDA
+    CUcontext context_ = nullptr;
+    CUstream stream_ = nullptr;
+    ConvertJob* pinnedJobs_ = nullptr;   // Page-locked, for the async upload
+    CUdeviceptr deviceJobs_ = 0;
+#endif
+
+    bool acquireOutput(uint32_t width, uint32_t height, PixelFormat format, Output& output);  // mutex_ held
+    void freeOutput(Output& output);                                                        // mutex_ held
+    size_t idleOutputs(uint32_t width, uint32_t height, PixelFormat format) const;           // mutex_ held
+};
+
+} // namespace gpu
+} // namespace fluxvision
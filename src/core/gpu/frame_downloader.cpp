@@ -0,0 +1,344 @@
+// src/core/gpu/frame_downloader.cpp
+#include "frame_downloader.h"
+#include "cuda_context.h"
+#include <algorithm>
+#include <iostream>
+
+namespace fluxvision {
+namespace gpu {
+
+FrameDownloader::FrameDownloader(const Config& config)
+    : config_(config)
+{
+    config_.maxInFlight = std::max<size_t>(config_.maxInFlight, 1);
+}
+
+FrameDownloader::~FrameDownloader() {
+#ifdef HAVE_CUDA
+    if (!context_) {
+        return;
+    }
+
+    cuCtxPushCurrent(context_);
+
+    // Copies still queued write into buffers freed below
+    if (stream_) {
+        cuStreamSynchronize(stream_);
+    }
+    for (auto& pending : pending_) {
+        if (pending.done) {
+            cuEventDestroy(pending.done);
+        }
+    }
+    pending_.clear();
+    for (CUevent event : freeEvents_) {
+        cuEventDestroy(event);
+    }
+    freeEvents_.clear();
+
+    // Outputs hold a reference to the downloader, so every buffer left is idle
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (auto& buffer : buffers_) {
+            freeBuffer(buffer);
+        }
+        buffers_.clear();
+    }
+
+    if (stream_) {
+        cuStreamDestroy(stream_);
+    }
+    cuCtxPopCurrent(nullptr);
+#endif
+}
+
+bool FrameDownloader::initialize() {
+    if (initialized_) {
+        return true;
+    }
+
+    // Output handles keep the downloader alive through a shared reference
+    if (weak_from_this().expired()) {
+        std::cerr << "FrameDownloader: must be owned by a std::shared_ptr" << std::endl;
+        return false;
+    }
+
+#ifdef HAVE_CUDA
+    CudaContext& cuda = CudaContext::getInstance(config_.cudaDeviceId);
+    if (!cuda.initialize()) {
+        std::cerr << "FrameDownloader: CUDA device " << config_.cudaDeviceId << " unavailable" << std::endl;
+        return false;
+    }
+    context_ = cuda.getContext();
+
+    // Own non-blocking stream: copies never serialize with decode work
+    cuCtxPushCurrent(context_);
+    CUresult result = cuStreamCreate(&stream_, CU_STREAM_NON_BLOCKING);
+    cuCtxPopCurrent(nullptr);
+
+    if (result != CUDA_SUCCESS) {
+        const char* errorStr = nullptr;
+        cuGetErrorString(result, &errorStr);
+        std::cerr << "FrameDownloader: failed to create stream: "
+                  << (errorStr ? errorStr : "Unknown error") << std::endl;
+        stream_ = nullptr;
+        return false;
+    }
+
+    pending_.reserve(config_.maxInFlight);
+    initialized_ = true;
+    return true;
+#else
+    std::cerr << "FrameDownloader: built without CUDA" << std::endl;
+    return false;
+#endif
+}
+
+bool FrameDownloader::submit(const FrameHandle& frame) {
+    const bool downloadable = initialized_ && frame && frame->format == PixelFormat::NV12 &&
+                              frame->cudaSurface && frame->data[0] && frame->data[1] &&
+                              frame->width > 0 && frame->height > 0;
+    if (!downloadable || pending_.size() >= config_.maxInFlight) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.rejected++;
+        return false;
+    }
+
+#ifdef HAVE_CUDA
+    // Tightly packed NV12: Y rows then UV rows
+    const size_t width = frame->width;
+    const size_t lumaRows = frame->height;
+    const size_t chromaRows = (frame->height + 1) / 2;
+
+    cuCtxPushCurrent(context_);
+
+    Buffer buffer;
+    bool ok = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ok = acquireBuffer(width * (lumaRows + chromaRows), buffer);
+    }
+
+    Pending pending;
+    if (ok) {
+        if (!freeEvents_.empty()) {
+            pending.done = freeEvents_.back();
+            freeEvents_.pop_back();
+        } else {
+            ok = cuEventCreate(&pending.done, CU_EVENT_DISABLE_TIMING) == CUDA_SUCCESS;
+        }
+    }
+
+    CUresult result = ok ? CUDA_SUCCESS : CUDA_ERROR_OUT_OF_MEMORY;
+    bool queued = false;
+    if (ok) {
+        CUDA_MEMCPY2D copy = {};
+        copy.srcMemoryType = CU_MEMORYTYPE_DEVICE;
+        copy.srcDevice = reinterpret_cast<CUdeviceptr>(frame->data[0]);
+        copy.srcPitch = static_cast<size_t>(frame->pitch[0]);
+        copy.dstMemoryType = CU_MEMORYTYPE_HOST;
+        copy.dstHost = buffer.host;
+        copy.dstPitch = width;
+        copy.WidthInBytes = width;
+        copy.Height = lumaRows;
+        result = cuMemcpy2DAsync(&copy, stream_);
+        queued = result == CUDA_SUCCESS;
+
+        if (result == CUDA_SUCCESS) {
+            copy.srcDevice = reinterpret_cast<CUdeviceptr>(frame->data[1]);
+            copy.srcPitch = static_cast<size_t>(frame->pitch[1]);
+            copy.dstHost = buffer.host + width * lumaRows;
+            copy.Height = chromaRows;
+            result = cuMemcpy2DAsync(&copy, stream_);
+        }
+        if (result == CUDA_SUCCESS) {
+            result = cuEventRecord(pending.done, stream_);
+        }
+    }
+
+    if (result != CUDA_SUCCESS) {
+        // A copy already queued may still write into the buffer
+        if (queued) {
+            cuStreamSynchronize(stream_);
+        }
+        if (pending.done) {
+            freeEvents_.push_back(pending.done);
+        }
+        cuCtxPopCurrent(nullptr);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (buffer.id != 0) {
+            for (auto& owned : buffers_) {
+                if (owned.id == buffer.id) {
+                    owned.inUse = false;
+                }
+            }
+        }
+        stats_.failed++;
+        std::cerr << "FrameDownloader: failed to queue download: " << result << std::endl;
+        return false;
+    }
+
+    cuCtxPopCurrent(nullptr);
+
+    pending.source = frame;
+    pending.bufferId = buffer.id;
+    pending.host = *frame;
+    pending.host.data[0] = buffer.host;
+    pending.host.data[1] = buffer.host + width * lumaRows;
+    pending.host.data[2] = nullptr;
+    pending.host.pitch[0] = static_cast<int>(width);
+    pending.host.pitch[1] = static_cast<int>(width);
+    pending.host.pitch[2] = 0;
+    pending.host.cudaSurface = nullptr;
+    pending.host.cudaPitch = 0;
+    pending_.push_back(std::move(pending));
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.submitted++;
+    stats_.inFlight = pending_.size();
+    return true;
+#else
+    return false;
+#endif
+}
+
+size_t FrameDownloader::poll(std::vector<FrameHandle>& frames) {
+#ifdef HAVE_CUDA
+    if (pending_.empty()) {
+        return 0;
+    }
+
+    size_t completed = 0;
+    size_t failed = 0;
+    std::vector<uint64_t> abandoned;
+
+    cuCtxPushCurrent(context_);
+
+    // One stream: copies finish in submission order
+    while (!pending_.empty()) {
+        const CUresult result = cuEventQuery(pending_.front().done);
+        if (result == CUDA_ERROR_NOT_READY) {
+            break;
+        }
+
+        Pending pending = std::move(pending_.front());
+        pending_.erase(pending_.begin());
+        freeEvents_.push_back(pending.done);
+        pending.source.reset();   // Surface back to the decoder
+
+        if (result != CUDA_SUCCESS) {
+            abandoned.push_back(pending.bufferId);
+            failed++;
+            continue;
+        }
+
+        frames.push_back(makeFrameHandle(FrameLease(pending.host, shared_from_this(), pending.bufferId)));
+        completed++;
+    }
+
+    cuCtxPopCurrent(nullptr);
+
+    for (uint64_t bufferId : abandoned) {
+        releaseLease(bufferId);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats_.completed += completed;
+    stats_.failed += failed;
+    stats_.inFlight = pending_.size();
+    return completed;
+#else
+    (void)frames;
+    return 0;
+#endif
+}
+
+size_t FrameDownloader::inFlight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_.inFlight;
+}
+
+void FrameDownloader::releaseLease(uint64_t token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    size_t idle = 0;
+    for (const auto& buffer : buffers_) {
+        idle += buffer.inUse ? 0 : 1;
+    }
+
+    for (auto it = buffers_.begin(); it != buffers_.end(); ++it) {
+        if (it->id != token) {
+            continue;
+        }
+
+        // Keep a few for the next frames; pinning memory is far dearer than reusing it
+        if (idle >= config_.maxCachedBuffers) {
+            freeBuffer(*it);
+            buffers_.erase(it);
+        } else {
+            it->inUse = false;
+        }
+        return;
+    }
+}
+
+FrameDownloader::Stats FrameDownloader::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stats stats = stats_;
+    stats.buffers = buffers_.size();
+    stats.bufferBytes = bufferBytes_;
+    return stats;
+}
+
+bool FrameDownloader::acquireBuffer(size_t bytes, Buffer& buffer) {
+    // Smallest idle buffer the frame fits in
+    Buffer* best = nullptr;
+    for (auto& candidate : buffers_) {
+        if (!candidate.inUse && candidate.bytes >= bytes && (!best || candidate.bytes < best->bytes)) {
+            best = &candidate;
+        }
+    }
+
+    if (best) {
+        best->inUse = true;
+        buffer = *best;
+        return true;
+    }
+
+#ifdef HAVE_CUDA
+    // Caller has the context current
+    Buffer allocated;
+    if (cuMemHostAlloc(reinterpret_cast<void**>(&allocated.host), bytes, 0) != CUDA_SUCCESS) {
+        std::cerr << "FrameDownloader: failed to allocate " << bytes << " pinned bytes" << std::endl;
+        return false;
+    }
+
+    allocated.id = nextBufferId_++;
+    allocated.bytes = bytes;
+    allocated.inUse = true;
+    bufferBytes_ += bytes;
+    buffers_.push_back(allocated);
+    buffer = allocated;
+    return true;
+#else
+    (void)buffer;
+    return false;
+#endif
+}
+
+void FrameDownloader::freeBuffer(Buffer& buffer) {
+#ifdef HAVE_CUDA
+    if (buffer.host) {
+        // May run on any consumer thread
+        cuCtxPushCurrent(context_);
+        cuMemFreeHost(buffer.host);
+        cuCtxPopCurrent(nullptr);
+        bufferBytes_ -= buffer.bytes;
+    }
+#endif
+    buffer = Buffer{};
+}
+
+} // namespace gpu
+} // namespace fluxvision
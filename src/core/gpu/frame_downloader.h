@@ -0,0 +1,123 @@
+// src/core/gpu/frame_downloader.h
+// Asynchronous NV12 device-to-host download into recycled pinned buffers
+#pragma once
+
+#include "../codec/frame_lease.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#endif
+
+namespace fluxvision {
+namespace gpu {
+
+// Frame downloader
+//
+// submit() queues the copy of a decoded NV12 device frame into a page-locked
+// host buffer (cuMemHostAlloc) with cuMemcpy2DAsync on the downloader's own
+// non-blocking stream, records an event and returns; the source frame is
+// held until the copy is done. poll() hands back the downloads whose event
+// has completed, without ever waiting on the GPU, so the caller (a decode
+// worker) keeps decoding while the copies cross PCIe.
+//
+// Results are tightly packed NV12 DecodedFrames in host memory (pitch =
+// width, cudaSurface = nullptr) with the source's metadata. Their buffers go
+// back to the downloader when the last handle is dropped and are reused for
+// the next download of a size they fit. When maxInFlight copies are pending,
+// submit() refuses the frame instead of waiting.
+//
+// Runs in the shared context of Config::cudaDeviceId; source frames must
+// live on that device.
+//
+// Thread-safety: submit()/poll() from one thread at a time (the decode worker
+// serving the owner); output releases from any thread. Create with
+// std::make_shared (outputs keep it alive).
+class FrameDownloader : public FrameLease::Owner,
+                        public std::enable_shared_from_this<FrameDownloader> {
+public:
+    struct Config {
+        int cudaDeviceId = 0;
+        size_t maxInFlight = 4;           // Copies queued on the stream at once
+        size_t maxCachedBuffers = 4;      // Idle pinned buffers kept for reuse
+    };
+
+    struct Stats {
+        uint64_t submitted = 0;
+        uint64_t completed = 0;
+        uint64_t rejected = 0;            // Not an NV12 device frame, or maxInFlight reached
+        uint64_t failed = 0;              // Allocation, copy or event failures
+        size_t inFlight = 0;
+        size_t buffers = 0;               // Pinned buffers allocated (in flight + held + cached)
+        size_t bufferBytes = 0;
+    };
+
+    explicit FrameDownloader(const Config& config);
+    ~FrameDownloader() override;
+
+    // Delete copy/move
+    FrameDownloader(const FrameDownloader&) = delete;
+    FrameDownloader& operator=(const FrameDownloader&) = delete;
+
+    // Create the stream in the device's shared CUDA context
+    bool initialize();
+    bool isInitialized() const { return initialized_; }
+
+    // Start downloading a frame (returns once the copy is queued)
+    // Returns: false if the frame is not an NV12 device frame, too many copies
+    // are pending, or the copy could not be queued
+    bool submit(const FrameHandle& frame);
+
+    // Append the finished downloads, oldest first (never waits)
+    size_t poll(std::vector<FrameHandle>& frames);
+
+    size_t inFlight() const;
+
+    // Host buffer returned by its last handle (any thread)
+    void releaseLease(uint64_t token) override;
+
+    Stats getStats() const;
+
+private:
+    struct Buffer {
+        uint64_t id = 0;
+        uint8_t* host = nullptr;          // Page-locked
+        size_t bytes = 0;
+        bool inUse = false;
+    };
+
+    struct Pending {
+        FrameHandle source;               // Keeps the device surface valid until the copy is done
+        DecodedFrame host{};              // Result metadata, pointing into the buffer
+        uint64_t bufferId = 0;
+#ifdef HAVE_CUDA
+        CUevent done = nullptr;
+#endif
+    };
+
+    Config config_;
+    bool initialized_ = false;
+
+    mutable std::mutex mutex_;            // buffers_, stats_ (releases come from any thread)
+    std::vector<Buffer> buffers_;
+    uint64_t nextBufferId_ = 1;
+    size_t bufferBytes_ = 0;
+    Stats stats_;
+
+    std::vector<Pending> pending_;        // Submission order; submit()/poll() thread only
+
+#ifdef HAVE_CUDA
+    CUcontext context_ = nullptr;
+    CUstream stream_ = nullptr;
+    std::vector<CUevent> freeEvents_;     // Recycled completion events
+#endif
+
+    bool acquireBuffer(size_t bytes, Buffer& buffer);  // mutex_ held
+    void freeBuffer(Buffer& buffer);                   // mutex_ held
+};
+
+} // namespace gpu
+} // namespace fluxvision
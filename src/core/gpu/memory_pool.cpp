@@ -1,18 +1,40 @@
 // src/core/gpu/memory_pool.cpp
 #include "memory_pool.h"
+#include <algorithm>
 #include <iostream>
 
 namespace fluxvision {
 namespace gpu {
 
+namespace {
+    // Size classes: sub stream, 720p, main stream
+    constexpr size_t kBucketShapes[GPUMemoryPool::kBucketCount][2] = {
+        {640, 360},
+        {1280, 720},
+        {1920, 1080},
+    };
+
+    // cuMemAllocPitch row alignment, for estimating a surface before allocating it
+    constexpr size_t kPitchAlignment = 512;
+
+    size_t nv12Rows(size_t height) {
+        return height + (height / 2);  // Y plane + UV plane (half height)
+    }
+}
+
 GPUMemoryPool::GPUMemoryPool(const Config& config)
     : config_(config)
     , initialized_(false)
 {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        buckets_[i].width = kBucketShapes[i][0];
+        buckets_[i].height = kBucketShapes[i][1];
+    }
 }
 
 GPUMemoryPool::~GPUMemoryPool() {
-    // Cleanup handled by individual decoders
+    // Surfaces still in use hold a reference to the pool, so only idle ones are left
+    trim(0);
 }
 
 bool GPUMemoryPool::initialize() {
@@ -87,8 +109,18 @@ void GPUMemoryPool::updateAllocation(const std::string& cameraId, size_t newByte
 
         checkMemoryLimits();
     } else {
-        // Not found, treat as new allocation
-        registerAllocation(cameraId, newBytes, newSurfaceCount);
+        // Not found, treat as new allocation (inline: statsMutex_ is already held)
+        perCameraMemory_[cameraId] = newBytes;
+        perCameraSurfaces_[cameraId] = newSurfaceCount;
+
+        size_t newTotal = totalAllocatedBytes_.load() + newBytes;
+        totalAllocatedBytes_.store(newTotal);
+
+        if (newTotal > peakAllocatedBytes_.load()) {
+            peakAllocatedBytes_.store(newTotal);
+        }
+
+        checkMemoryLimits();
     }
 }
 
@@ -107,6 +139,28 @@ GPUMemoryPool::Stats GPUMemoryPool::getStats() const {
     stats.perCameraMemoryBytes = perCameraMemory_;
     stats.perCameraSurfaceCount = perCameraSurfaces_;
 
+    // Surfaces handed out by the allocator count towards their camera
+    for (const auto& [cameraId, pooled] : perCameraPooled_) {
+        stats.perCameraMemoryBytes[cameraId] += pooled.bytes;
+        stats.perCameraSurfaceCount[cameraId] += pooled.count;
+        stats.totalSurfaceCount += pooled.count;
+    }
+
+    stats.pooledBytes = pooledBytes_;
+    stats.cachedBytes = cachedBytes_;
+    stats.allocationFailures = allocationFailures_;
+
+    for (const auto& bucket : buckets_) {
+        BucketStats bucketStats;
+        bucketStats.width = bucket.width;
+        bucketStats.height = bucket.height;
+        bucketStats.inUse = bucket.inUse;
+        bucketStats.cached = bucket.free.size();
+        bucketStats.allocations = bucket.allocations;
+        bucketStats.reuses = bucket.reuses;
+        stats.buckets.push_back(bucketStats);
+    }
+
     if (config_.maxGpuMemoryBytes > 0) {
         stats.utilizationPercent = (static_cast<double>(stats.totalAllocatedBytes) /
                                    config_.maxGpuMemoryBytes) * 100.0;
@@ -115,6 +169,194 @@ GPUMemoryPool::Stats GPUMemoryPool::getStats() const {
     return stats;
 }
 
+bool GPUMemoryPool::allocateSurface(const std::string& cameraId, size_t width, size_t height,
+                                    SurfaceAllocation& surface) {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+
+    const int index = bucketFor(width, height);
+
+    if (index >= 0 && !buckets_[index].free.empty()) {
+        // Recycle: no cuMemAlloc, nothing new counted against the limit
+        Bucket& bucket = buckets_[index];
+        surface = bucket.free.back();
+        bucket.free.pop_back();
+        bucket.inUse++;
+        bucket.reuses++;
+        cachedBytes_ -= surface.bytes;
+    } else {
+        const size_t allocWidth = index >= 0 ? buckets_[index].width : width;
+        const size_t allocHeight = index >= 0 ? buckets_[index].height : height;
+
+        // Enforce the limit up front, reclaiming idle surfaces of other sizes if needed
+        const size_t estimate = ((allocWidth + kPitchAlignment - 1) / kPitchAlignment) *
+                                kPitchAlignment * nv12Rows(allocHeight);
+        if (!makeRoom(estimate)) {
+            allocationFailures_++;
+            if (config_.enableWarnings) {
+                std::cerr << "GPUMemoryPool: refusing " << allocWidth << "x" << allocHeight
+                          << " surface for camera " << cameraId << ": limit of "
+                          << (config_.maxGpuMemoryBytes / (1024 * 1024)) << " MB reached" << std::endl;
+            }
+            return false;
+        }
+
+        if (!allocateDevice(allocWidth, allocHeight, surface)) {
+            allocationFailures_++;
+            return false;
+        }
+
+        surface.bucket = index;
+        if (index >= 0) {
+            buckets_[index].inUse++;
+            buckets_[index].allocations++;
+        }
+        addPooledBytes(surface.bytes);
+    }
+
+    CameraSurfaces& pooled = perCameraPooled_[cameraId];
+    pooled.bytes += surface.bytes;
+    pooled.count++;
+
+    return true;
+}
+
+void GPUMemoryPool::releaseSurface(const std::string& cameraId, const SurfaceAllocation& surface) {
+    if (!surface.devicePtr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+
+    auto it = perCameraPooled_.find(cameraId);
+    if (it != perCameraPooled_.end()) {
+        it->second.bytes -= std::min(it->second.bytes, surface.bytes);
+        it->second.count -= std::min<size_t>(it->second.count, 1);
+        if (it->second.count == 0) {
+            perCameraPooled_.erase(it);
+        }
+    }
+
+    if (surface.bucket < 0 || surface.bucket >= static_cast<int>(kBucketCount)) {
+        SurfaceAllocation oversize = surface;
+        freeDevice(oversize);
+        return;
+    }
+
+    // Keep it for the next camera that needs this size
+    Bucket& bucket = buckets_[surface.bucket];
+    if (bucket.inUse > 0) {
+        bucket.inUse--;
+    }
+    bucket.free.push_back(surface);
+    cachedBytes_ += surface.bytes;
+}
+
+void GPUMemoryPool::trim(size_t keepBytes) {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+
+    // Largest surfaces first: they return the most memory per call
+    for (size_t i = kBucketCount; i-- > 0 && cachedBytes_ > keepBytes;) {
+        Bucket& bucket = buckets_[i];
+        while (!bucket.free.empty() && cachedBytes_ > keepBytes) {
+            SurfaceAllocation surface = bucket.free.back();
+            bucket.free.pop_back();
+            cachedBytes_ -= surface.bytes;
+            freeDevice(surface);
+        }
+    }
+}
+
+int GPUMemoryPool::bucketFor(size_t width, size_t height) {
+    for (size_t i = 0; i < kBucketCount; ++i) {
+        if (width <= kBucketShapes[i][0] && height <= kBucketShapes[i][1]) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool GPUMemoryPool::makeRoom(size_t bytes) {
+    if (totalAllocatedBytes_.load() + bytes <= config_.maxGpuMemoryBytes) {
+        return true;
+    }
+
+    // Free idle cached surfaces, largest first, until the new one fits
+    for (size_t i = kBucketCount; i-- > 0;) {
+        Bucket& bucket = buckets_[i];
+        while (!bucket.free.empty()) {
+            SurfaceAllocation surface = bucket.free.back();
+            bucket.free.pop_back();
+            cachedBytes_ -= surface.bytes;
+            freeDevice(surface);
+
+            if (totalAllocatedBytes_.load() + bytes <= config_.maxGpuMemoryBytes) {
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool GPUMemoryPool::allocateDevice(size_t width, size_t height, SurfaceAllocation& surface) {
+#ifdef HAVE_CUDA
+    // Remember the allocating context: releases (and trims) may run on threads without one
+    if (!context_) {
+        cuCtxGetCurrent(&context_);
+    }
+
+    CUdeviceptr devicePtr = 0;
+    size_t pitch = 0;
+    CUresult result = cuMemAllocPitch(&devicePtr, &pitch, width, nv12Rows(height), 16);
+    if (result != CUDA_SUCCESS) {
+        std::cerr << "GPUMemoryPool: cuMemAllocPitch " << width << "x" << height
+                  << " failed: " << result << std::endl;
+        return false;
+    }
+
+    surface = SurfaceAllocation{};
+    surface.devicePtr = static_cast<uint64_t>(devicePtr);
+    surface.pitch = pitch;
+    surface.width = width;
+    surface.height = height;
+    surface.bytes = pitch * nv12Rows(height);
+    return true;
+#else
+    (void)width;
+    (void)height;
+    (void)surface;
+    return false;
+#endif
+}
+
+void GPUMemoryPool::freeDevice(SurfaceAllocation& surface) {
+#ifdef HAVE_CUDA
+    if (surface.devicePtr) {
+        cuCtxPushCurrent(context_);
+        cuMemFree(static_cast<CUdeviceptr>(surface.devicePtr));
+        cuCtxPopCurrent(nullptr);
+    }
+#endif
+
+    pooledBytes_ -= std::min(pooledBytes_, surface.bytes);
+    const size_t total = totalAllocatedBytes_.load();
+    totalAllocatedBytes_.store(total - std::min(total, surface.bytes));
+    surface = SurfaceAllocation{};
+}
+
+void GPUMemoryPool::addPooledBytes(size_t bytes) {
+    pooledBytes_ += bytes;
+
+    const size_t newTotal = totalAllocatedBytes_.load() + bytes;
+    totalAllocatedBytes_.store(newTotal);
+
+    if (newTotal > peakAllocatedBytes_.load()) {
+        peakAllocatedBytes_.store(newTotal);
+    }
+
+    checkMemoryLimits();
+}
+
 bool GPUMemoryPool::wouldExceedLimit(size_t additionalBytes) const {
     size_t current = totalAllocatedBytes_.load();
     return (current + additionalBytes) > config_.maxGpuMemoryBytes;
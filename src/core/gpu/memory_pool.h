@@ -1,14 +1,16 @@
 // src/core/gpu/memory_pool.h
-// GPU memory pool manager for centralized VRAM tracking
-// Note: NVDEC decoders maintain their own surface pools (API requirement)
-// This pool provides centralized statistics and monitoring
+// GPU memory pool: shared NV12 surface allocator with size-class buckets, plus VRAM tracking
+// Note: NVDEC's internal decode surfaces are allocated by the driver; decoders
+// take their output surfaces from here and report anything else via the ledger
 #pragma once
 
 #include "../codec/types.h"
 #include <string>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <atomic>
+#include <vector>
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
@@ -17,12 +19,43 @@
 namespace fluxvision {
 namespace gpu {
 
-// GPU Memory Pool - Centralized VRAM tracking and statistics
-class GPUMemoryPool {
+// One pitched NV12 surface (Y plane + half-height UV plane)
+struct SurfaceAllocation {
+    uint64_t devicePtr = 0;    // CUdeviceptr
+    size_t pitch = 0;
+    size_t width = 0;          // Allocated size: the bucket shape, at least the requested size
+    size_t height = 0;
+    size_t bytes = 0;
+    int bucket = -1;           // Size class, -1 = oversize (not cached)
+};
+
+// GPU Memory Pool - Shared surface allocator and centralized VRAM tracking
+//
+// Output surfaces are rounded up to one of three size classes (640x360,
+// 1280x720, 1920x1080 NV12) and recycled through per-class free lists, so
+// cameras that flap, reconnect or change quality reuse VRAM instead of
+// calling cuMemAlloc/cuMemFree each time. maxGpuMemoryBytes is enforced when
+// memory is allocated: idle cached surfaces are freed first to make room,
+// and an allocation that still doesn't fit fails.
+//
+// Thread-safety: all methods may be called from any thread. Create the pool
+// with std::make_shared so decoders (and frame handles that outlive them)
+// can keep it alive; see shared().
+class GPUMemoryPool : public std::enable_shared_from_this<GPUMemoryPool> {
 public:
     struct Config {
         size_t maxGpuMemoryBytes = 3ULL * 1024 * 1024 * 1024;  // 3GB limit
         bool enableWarnings = true;
+        int cudaDeviceId = 0;      // Device the surfaces live on (one pool per device)
+    };
+
+    struct BucketStats {
+        size_t width = 0;
+        size_t height = 0;
+        size_t inUse = 0;          // Surfaces handed out
+        size_t cached = 0;         // Idle surfaces ready for reuse
+        uint64_t allocations = 0;  // cuMemAllocPitch calls
+        uint64_t reuses = 0;       // Requests served from the free list
     };
 
     struct Stats {
@@ -32,8 +65,17 @@ public:
         std::map<std::string, size_t> perCameraMemoryBytes;  // cameraId -> bytes
         std::map<std::string, size_t> perCameraSurfaceCount; // cameraId -> count
         double utilizationPercent = 0.0;
+
+        // Surface allocator
+        size_t pooledBytes = 0;            // Allocated by the pool (in use + cached)
+        size_t cachedBytes = 0;            // Idle, reclaimable
+        uint64_t allocationFailures = 0;   // Requests refused by the memory limit (or CUDA)
+        std::vector<BucketStats> buckets;
     };
 
+    // Size classes (NV12 surface shapes)
+    static constexpr size_t kBucketCount = 3;
+
     explicit GPUMemoryPool(const Config& config);
     ~GPUMemoryPool();
 
@@ -44,6 +86,22 @@ public:
     // Initialize pool
     bool initialize();
 
+    // Shared ownership for decoders; nullptr if the pool isn't owned by a shared_ptr
+    std::shared_ptr<GPUMemoryPool> shared() { return weak_from_this().lock(); }
+
+    // Allocate an NV12 surface of at least width x height for a camera
+    // The caller's CUDA context must be current. Served from the size class's
+    // free list when possible. Returns false if the memory limit (after
+    // trimming idle surfaces) or CUDA refuses it.
+    bool allocateSurface(const std::string& cameraId, size_t width, size_t height,
+                         SurfaceAllocation& surface);
+
+    // Return a surface to its size class (any thread); oversize surfaces are freed
+    void releaseSurface(const std::string& cameraId, const SurfaceAllocation& surface);
+
+    // Free idle cached surfaces until at most keepBytes remain cached
+    void trim(size_t keepBytes = 0);
+
     // Register camera allocation (called by decoders)
     void registerAllocation(const std::string& cameraId, size_t bytes, size_t surfaceCount);
 
@@ -61,18 +119,53 @@ public:
 
     // Get available memory
     size_t getAvailableMemory() const;
+    size_t getMemoryLimit() const { return config_.maxGpuMemoryBytes; }
+
+    int getDeviceId() const { return config_.cudaDeviceId; }
+
+    // Currently allocated (ledger + pooled, including idle cached surfaces)
+    size_t getAllocatedBytes() const { return totalAllocatedBytes_.load(); }
 
 private:
+    struct Bucket {
+        size_t width = 0;
+        size_t height = 0;
+        std::vector<SurfaceAllocation> free;
+        size_t inUse = 0;
+        uint64_t allocations = 0;
+        uint64_t reuses = 0;
+    };
+
+    struct CameraSurfaces {
+        size_t bytes = 0;
+        size_t count = 0;
+    };
+
     Config config_;
     bool initialized_;
 
     mutable std::mutex statsMutex_;
-    std::atomic<size_t> totalAllocatedBytes_{0};
+    std::atomic<size_t> totalAllocatedBytes_{0};   // Ledger + pooled
     std::atomic<size_t> peakAllocatedBytes_{0};
-    std::map<std::string, size_t> perCameraMemory_;
+    std::map<std::string, size_t> perCameraMemory_;    // Ledger (registerAllocation)
     std::map<std::string, size_t> perCameraSurfaces_;
 
+    // Surface allocator (statsMutex_)
+    Bucket buckets_[kBucketCount];
+    std::map<std::string, CameraSurfaces> perCameraPooled_;
+    size_t pooledBytes_ = 0;
+    size_t cachedBytes_ = 0;
+    uint64_t allocationFailures_ = 0;
+#ifdef HAVE_CUDA
+    CUcontext context_ = nullptr;   // Context the surfaces were allocated in
+#endif
+
     void checkMemoryLimits();
+    static int bucketFor(size_t width, size_t height);
+    bool allocateDevice(size_t width, size_t height, SurfaceAllocation& surface);  // statsMutex_ held
+    void freeDevice(SurfaceAllocation& surface);                                   // statsMutex_ held
+    bool makeRoom(size_t bytes);                                                   // statsMutex_ held
+    void addPooledBytes(size_t bytes);                                             // statsMutex_ held
 };
 
 } // namespace gpu
@@ -0,0 +1,368 @@
+// src/core/gpu/mosaic_compositor.cpp
+#include "mosaic_compositor.h"
+#include <algorithm>
+#include <iostream>
+
+namespace fluxvision {
+namespace gpu {
+
+namespace {
+    constexpr uint32_t kMaxWallDimension = 16384;
+    constexpr uint32_t kOpaqueBlack = 0xFF000000;  // RGBA bytes 0, 0, 0, 255 (little-endian)
+    constexpr uint64_t kUnknownGeneration = ~0ULL;  // Surface content lost: redraw the tile
+}
+
+MosaicCompositor::MosaicCompositor(const Config& config)
+    : config_(config)
+{
+    config_.columns = std::max(1u, config_.columns);
+    config_.rows = std::max(1u, config_.rows);
+    config_.tileWidth = std::max(2u, config_.tileWidth);
+    config_.tileHeight = std::max(2u, config_.tileHeight);
+    config_.surfaces = std::max<size_t>(1, config_.surfaces);
+    if (config_.format != PixelFormat::BGR) {
+        config_.format = PixelFormat::RGBA;
+    }
+
+    tiles_.resize(static_cast<size_t>(config_.columns) * config_.rows);
+}
+
+MosaicCompositor::~MosaicCompositor() {
+#ifdef HAVE_CUDA
+    // Surfaces held by the client keep the compositor alive, so none are in use here
+    if (context_) {
+        cuCtxPushCurrent(context_);
+        for (auto& surface : surfaces_) {
+            if (surface.devicePtr) {
+                cuMemFree(static_cast<CUdeviceptr>(surface.devicePtr));
+            }
+        }
+        if (stream_) {
+            cuStreamDestroy(stream_);
+        }
+        if (deviceJobs_) {
+            cuMemFree(deviceJobs_);
+        }
+        if (pinnedJobs_) {
+            cuMemFreeHost(pinnedJobs_);
+        }
+        cuCtxPopCurrent(nullptr);
+    }
+#endif
+}
+
+bool MosaicCompositor::initialize() {
+    if (initialized_) {
+        return true;
+    }
+
+    if (weak_from_this().expired()) {
+        std::cerr << "MosaicCompositor: must be owned by a std::shared_ptr" << std::endl;
+        return false;
+    }
+
+    if (getWidth() > kMaxWallDimension || getHeight() > kMaxWallDimension) {
+        std::cerr << "MosaicCompositor: wall " << getWidth() << "x" << getHeight()
+                  << " is too large" << std::endl;
+        return false;
+    }
+
+#if defined(HAVE_CUDA) && defined(HAVE_CUDA_KERNELS)
+    if (cuCtxGetCurrent(&context_) != CUDA_SUCCESS || !context_) {
+        std::cerr << "MosaicCompositor: no current CUDA context" << std::endl;
+        context_ = nullptr;
+        return false;
+    }
+
+    const size_t tileCount = tiles_.size();
+    CUresult result = cuStreamCreate(&stream_, CU_STREAM_NON_BLOCKING);
+    if (result == CUDA_SUCCESS) {
+        result = cuMemHostAlloc(reinterpret_cast<void**>(&pinnedJobs_), tileCount * sizeof(ConvertJob), 0);
+    }
+    if (result == CUDA_SUCCESS) {
+        result = cuMemAlloc(&deviceJobs_, tileCount * sizeof(ConvertJob));
+    }
+
+    // Preallocate every wall surface and start it out black
+    const size_t rowBytes = static_cast<size_t>(getWidth()) * channels();
+    surfaces_.resize(config_.surfaces);
+    for (auto& surface : surfaces_) {
+        if (result != CUDA_SUCCESS) {
+            break;
+        }
+
+        CUdeviceptr devicePtr = 0;
+        result = cuMemAllocPitch(&devicePtr, &surface.pitch, rowBytes, getHeight(), 16);
+        if (result == CUDA_SUCCESS) {
+            surface.devicePtr = static_cast<uint64_t>(devicePtr);
+            surface.generations.assign(tileCount, 0);
+            surface.drawn.assign(tileCount, Rect{});
+            stats_.surfaceBytes += surface.pitch * getHeight();
+
+            const Rect whole{0, 0, static_cast<int32_t>(getWidth()), static_cast<int32_t>(getHeight())};
+            if (!clearRect(surface, whole)) {
+                result = CUDA_ERROR_OUT_OF_MEMORY;
+            }
+        }
+    }
+    if (result == CUDA_SUCCESS) {
+        result = cuStreamSynchronize(stream_);
+    }
+
+    if (result != CUDA_SUCCESS) {
+        const char* errorStr = nullptr;
+        cuGetErrorString(result, &errorStr);
+        std::cerr << "MosaicCompositor: failed to allocate " << config_.surfaces << " wall surfaces of "
+                  << getWidth() << "x" << getHeight() << ": "
+                  << (errorStr ? errorStr : "Unknown error") << std::endl;
+        return false;  // Partial state is released by the destructor
+    }
+
+    draws_.reserve(tileCount);
+    initialized_ = true;
+    return true;
+#else
+    std::cerr << "MosaicCompositor: built without CUDA kernels" << std::endl;
+    return false;
+#endif
+}
+
+bool MosaicCompositor::updateTile(size_t index, const FrameHandle& frame) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    const bool drawable = !frame || (frame->format == PixelFormat::NV12 && frame->cudaSurface &&
+                                     frame->data[0] && frame->data[1] &&
+                                     frame->width > 0 && frame->height > 0);
+    if (index >= tiles_.size() || !drawable) {
+        stats_.rejected++;
+        return false;
+    }
+
+    // The previous picture (if any) goes back to its decoder here
+    Tile& tile = tiles_[index];
+    tile.frame = frame;
+    tile.generation = frame ? nextGeneration_++ : 0;
+    stats_.updates++;
+    return true;
+}
+
+bool MosaicCompositor::compose(FrameHandle& wall) {
+    wall.reset();
+    if (!initialized_) {
+        return false;
+    }
+
+    // Claim a surface the client isn't reading and collect the tiles it's missing
+    size_t index = surfaces_.size();
+    int64_t pts = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        if (!surfaces_[lastSurface_].inUse) {
+            index = lastSurface_;
+        } else {
+            for (size_t i = 0; i < surfaces_.size(); ++i) {
+                if (!surfaces_[i].inUse) {
+                    index = i;
+                    break;
+                }
+            }
+        }
+        if (index == surfaces_.size()) {
+            stats_.busy++;
+            return false;
+        }
+
+        Surface& surface = surfaces_[index];
+        surface.inUse = true;
+
+        draws_.clear();
+        for (size_t i = 0; i < tiles_.size(); ++i) {
+            const Tile& tile = tiles_[i];
+            if (tile.frame) {
+                pts = std::max(pts, tile.frame->pts);
+            }
+            if (tile.generation != surface.generations[i]) {
+                draws_.push_back(Draw{i, tile.frame, tile.generation});
+            }
+        }
+        stats_.tilesReused += tiles_.size() - draws_.size();
+    }
+
+    Surface& surface = surfaces_[index];
+    bool ok = true;
+
+#if defined(HAVE_CUDA) && defined(HAVE_CUDA_KERNELS)
+    if (!draws_.empty()) {
+        cuCtxPushCurrent(context_);
+
+        int jobs = 0;
+        int maxWidth = 0;
+        int maxHeight = 0;
+        std::vector<Rect> rects(draws_.size());
+
+        for (size_t i = 0; i < draws_.size() && ok; ++i) {
+            const Draw& draw = draws_[i];
+            const Rect rect = draw.frame ? fitTile(draw.tile, *draw.frame) : Rect{};
+            rects[i] = rect;
+
+            // Wipe what the old picture covered if the new one won't paint over all of it
+            const Rect& previous = surface.drawn[draw.tile];
+            if (previous.width > 0 && previous != rect) {
+                ok = clearRect(surface, previous);
+            }
+            if (!draw.frame) {
+                continue;
+            }
+
+            const DecodedFrame& source = *draw.frame;
+            ConvertJob& job = pinnedJobs_[jobs++];
+            job = ConvertJob{};
+            job.srcLuma = reinterpret_cast<uint64_t>(source.data[0]);
+            job.srcChroma = reinterpret_cast<uint64_t>(source.data[1]);
+            job.srcPitch = source.pitch[0];
+            job.srcWidth = static_cast<int32_t>(source.width);
+            job.srcHeight = static_cast<int32_t>(source.height);
+            job.dst = surface.devicePtr + static_cast<uint64_t>(rect.y) * surface.pitch +
+                      static_cast<uint64_t>(rect.x) * channels();
+            job.dstPitch = static_cast<int32_t>(surface.pitch);
+            job.dstWidth = rect.width;
+            job.dstHeight = rect.height;
+            job.channels = static_cast<uint8_t>(channels());
+            job.matrix = static_cast<uint8_t>(colorMatrixFor(source.height, config_.fullRange));
+
+            maxWidth = std::max(maxWidth, rect.width);
+            maxHeight = std::max(maxHeight, rect.height);
+        }
+
+        // Every changed tile in one upload and one launch, then wait for this stream only
+        CUresult result = CUDA_SUCCESS;
+        int launch = 0;
+        if (ok && jobs > 0) {
+            result = cuMemcpyHtoDAsync(deviceJobs_, pinnedJobs_, jobs * sizeof(ConvertJob), stream_);
+            if (result == CUDA_SUCCESS) {
+                launch = launchConvertBatch(reinterpret_cast<const ConvertJob*>(deviceJobs_), jobs,
+                                            maxWidth, maxHeight, stream_);
+            }
+        }
+        if (result == CUDA_SUCCESS && launch == 0) {
+            result = cuStreamSynchronize(stream_);
+        }
+        ok = ok && result == CUDA_SUCCESS && launch == 0;
+
+        if (ok) {
+            for (size_t i = 0; i < draws_.size(); ++i) {
+                surface.generations[draws_[i].tile] = draws_[i].generation;
+                surface.drawn[draws_[i].tile] = rects[i];
+            }
+        } else {
+            std::cerr << "MosaicCompositor: drawing " << draws_.size() << " tiles failed (CUDA "
+                      << result << ", launch " << launch << ")" << std::endl;
+
+            // Whatever landed is unknown: clear and redraw these tiles next time
+            for (const Draw& draw : draws_) {
+                surface.generations[draw.tile] = kUnknownGeneration;
+                surface.drawn[draw.tile] = fitTile(draw.tile, DecodedFrame{});
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats_.launches += (ok && jobs > 0) ? 1 : 0;
+        stats_.tilesDrawn += ok ? draws_.size() : 0;
+
+        cuCtxPopCurrent(nullptr);
+    }
+#endif
+
+    // Tile frames stay referenced by tiles_; drop the copies taken for drawing
+    draws_.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!ok) {
+        surface.inUse = false;
+        stats_.failed++;
+        return false;
+    }
+
+    lastSurface_ = index;
+    lastPts_ = std::max(lastPts_, pts);
+    stats_.compositions++;
+
+    DecodedFrame frame = {};
+    frame.data[0] = reinterpret_cast<uint8_t*>(surface.devicePtr);
+    frame.pitch[0] = static_cast<int>(surface.pitch);
+    frame.width = getWidth();
+    frame.height = getHeight();
+    frame.format = config_.format;
+    frame.pts = lastPts_;
+    frame.dts = lastPts_;
+    frame.isKeyframe = false;
+    frame.cudaSurface = reinterpret_cast<void*>(surface.devicePtr);
+    frame.cudaPitch = static_cast<int>(surface.pitch);
+
+    wall = makeFrameHandle(FrameLease(frame, shared_from_this(), index));
+    return true;
+}
+
+void MosaicCompositor::releaseLease(uint64_t token) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (token < surfaces_.size()) {
+        surfaces_[token].inUse = false;
+    }
+}
+
+MosaicCompositor::Stats MosaicCompositor::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+MosaicCompositor::Rect MosaicCompositor::fitTile(size_t tile, const DecodedFrame& frame) const {
+    Rect rect;
+    rect.x = static_cast<int32_t>((tile % config_.columns) * config_.tileWidth);
+    rect.y = static_cast<int32_t>((tile / config_.columns) * config_.tileHeight);
+    rect.width = static_cast<int32_t>(config_.tileWidth);
+    rect.height = static_cast<int32_t>(config_.tileHeight);
+
+    if (!config_.preserveAspect || frame.width == 0 || frame.height == 0) {
+        return rect;
+    }
+
+    // Largest centred area with the picture's aspect ratio (4:3 in a 16:9 tile: pillarbox)
+    const uint64_t sourceWide = static_cast<uint64_t>(frame.width) * config_.tileHeight;
+    const uint64_t tileWide = static_cast<uint64_t>(config_.tileWidth) * frame.height;
+    if (sourceWide > tileWide) {
+        const int32_t height = static_cast<int32_t>(
+            std::max<uint64_t>(1, static_cast<uint64_t>(config_.tileWidth) * frame.height / frame.width));
+        rect.y += (rect.height - height) / 2;
+        rect.height = height;
+    } else if (sourceWide < tileWide) {
+        const int32_t width = static_cast<int32_t>(
+            std::max<uint64_t>(1, static_cast<uint64_t>(config_.tileHeight) * frame.width / frame.height));
+        rect.x += (rect.width - width) / 2;
+        rect.width = width;
+    }
+    return rect;
+}
+
+bool MosaicCompositor::clearRect(const Surface& surface, const Rect& rect) {
+#ifdef HAVE_CUDA
+    const CUdeviceptr origin = static_cast<CUdeviceptr>(surface.devicePtr) +
+                               static_cast<CUdeviceptr>(rect.y) * surface.pitch +
+                               static_cast<CUdeviceptr>(rect.x) * channels();
+    CUresult result;
+    if (config_.format == PixelFormat::RGBA) {
+        result = cuMemsetD2D32Async(origin, surface.pitch, kOpaqueBlack, rect.width, rect.height, stream_);
+    } else {
+        result = cuMemsetD2D8Async(origin, surface.pitch, 0,
+                                   static_cast<size_t>(rect.width) * 3, rect.height, stream_);
+    }
+    return result == CUDA_SUCCESS;
+#else
+    (void)surface;
+    (void)rect;
+    return false;
+#endif
+}
+
+} // namespace gpu
+} // namespace fluxvision
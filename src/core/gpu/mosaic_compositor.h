@@ -0,0 +1,153 @@
+// src/core/gpu/mosaic_compositor.h
+// GPU grid mosaic: the latest frame of each wall tile scaled into one preallocated surface
+#pragma once
+
+#include "../codec/frame_lease.h"
+#include "color_convert_kernels.h"
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#endif
+
+namespace fluxvision {
+namespace gpu {
+
+// Video wall compositor (GRID_VIEW / THUMBNAIL walls, 4x4 to 8x8)
+//
+// Cameras hand their newest decoded NV12 frame to a tile with updateTile()
+// (any thread, usually a frame subscription or the decode callback). Once per
+// display tick, compose() scales every tile that changed since the surface
+// was last drawn into it, all in one kernel launch on the compositor's own
+// stream, and returns the whole wall as a single RGBA/BGR device frame. Tiles
+// without a new frame are left as they are, so a quiet camera costs nothing.
+//
+// Surfaces are preallocated at initialize() and rotated: the client keeps the
+// handle from compose() while it reads or uploads the wall, and the next tick
+// draws into a surface nobody holds. Each surface remembers which picture of
+// each tile it shows, so switching surfaces only redraws what it missed.
+// The newest frame of each tile stays leased from its decoder until replaced.
+//
+// Runs in the CUDA context current when initialize() is called (a decode
+// worker's); tile frames must live on that device.
+//
+// Thread-safety: updateTile() and surface releases from any thread; compose()
+// from one thread at a time. Create with std::make_shared.
+class MosaicCompositor : public FrameLease::Owner,
+                         public std::enable_shared_from_this<MosaicCompositor> {
+public:
+    struct Config {
+        uint32_t columns = 4;
+        uint32_t rows = 4;
+        uint32_t tileWidth = 480;         // Wall = columns x tileWidth by rows x tileHeight
+        uint32_t tileHeight = 270;
+        PixelFormat format = PixelFormat::RGBA;  // RGBA or BGR
+        bool preserveAspect = true;       // Letterbox instead of stretching to the tile
+        bool fullRange = false;           // Sources use 0-255 luma
+        size_t surfaces = 2;              // Rotated wall surfaces (>= 2 lets the client hold one)
+    };
+
+    struct Stats {
+        uint64_t updates = 0;             // updateTile() calls accepted
+        uint64_t rejected = 0;            // Not an NV12 device frame, or bad tile index
+        uint64_t compositions = 0;        // compose() calls that returned a surface
+        uint64_t tilesDrawn = 0;
+        uint64_t tilesReused = 0;         // Tiles left untouched by a composition
+        uint64_t launches = 0;
+        uint64_t busy = 0;                // Ticks skipped: the client held every surface
+        uint64_t failed = 0;
+        size_t surfaceBytes = 0;
+    };
+
+    explicit MosaicCompositor(const Config& config);
+    ~MosaicCompositor() override;
+
+    // Delete copy/move
+    MosaicCompositor(const MosaicCompositor&) = delete;
+    MosaicCompositor& operator=(const MosaicCompositor&) = delete;
+
+    // Allocate the wall surfaces in the current CUDA context
+    bool initialize();
+    bool isInitialized() const { return initialized_; }
+
+    uint32_t getWidth() const { return config_.columns * config_.tileWidth; }
+    uint32_t getHeight() const { return config_.rows * config_.tileHeight; }
+    size_t getTileCount() const { return tiles_.size(); }
+
+    // Show frame in tile (row-major index); nullptr blanks the tile
+    // Returns: false if the frame can't be drawn or the index is out of range
+    bool updateTile(size_t index, const FrameHandle& frame);
+
+    // Draw the tiles that changed and return the wall (pts of its newest tile)
+    // Returns: false if every surface is still held or the launch failed
+    bool compose(FrameHandle& wall);
+
+    // Wall surface released by its last handle (any thread)
+    void releaseLease(uint64_t token) override;
+
+    Stats getStats() const;
+
+private:
+    struct Tile {
+        FrameHandle frame;                // Newest picture (nullptr = blank)
+        uint64_t generation = 0;          // Picture id, unique across tiles (0 = blank)
+    };
+
+    // Area of a tile the picture was drawn into
+    struct Rect {
+        int32_t x = 0;
+        int32_t y = 0;
+        int32_t width = 0;
+        int32_t height = 0;
+
+        bool operator==(const Rect& other) const {
+            return x == other.x && y == other.y && width == other.width && height == other.height;
+        }
+        bool operator!=(const Rect& other) const { return !(*this == other); }
+    };
+
+    struct Surface {
+        uint64_t devicePtr = 0;           // CUdeviceptr
+        size_t pitch = 0;
+        bool inUse = false;               // Held by the client
+        std::vector<uint64_t> generations;  // Tile picture last drawn here (0 = blank)
+        std::vector<Rect> drawn;          // Where it was drawn
+    };
+
+    struct Draw {
+        size_t tile = 0;
+        FrameHandle frame;
+        uint64_t generation = 0;
+    };
+
+    Config config_;
+    bool initialized_ = false;
+
+    mutable std::mutex mutex_;
+    std::vector<Tile> tiles_;
+    std::vector<Surface> surfaces_;
+    uint64_t nextGeneration_ = 1;
+    size_t lastSurface_ = 0;              // Most recently composed (fewest stale tiles)
+    int64_t lastPts_ = 0;
+    Stats stats_;
+
+    // compose() only
+    std::vector<Draw> draws_;
+
+#ifdef HAVE_CUDA
+    CUcontext context_ = nullptr;
+    CUstream stream_ = nullptr;
+    ConvertJob* pinnedJobs_ = nullptr;    // One job per tile at most
+    CUdeviceptr deviceJobs_ = 0;
+#endif
+
+    Rect fitTile(size_t tile, const DecodedFrame& frame) const;
+    bool clearRect(const Surface& surface, const Rect& rect);
+    int channels() const { return config_.format == PixelFormat::BGR ? 3 : 4; }
+};
+
+} // namespace gpu
+} // namespace fluxvision
@@ -0,0 +1,675 @@
+// src/core/ipc/frame_ring.cpp
+#include "frame_ring.h"
+#include "../gpu/cuda_context.h"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <ctime>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace fluxvision {
+namespace ipc {
+
+namespace {
+    constexpr size_t kPlaneAlignment = 64;
+    constexpr size_t kMaxMappings = 256;   // Reader: opened allocations before starting over
+    constexpr int kSeqlockRetries = 16;
+
+    size_t alignUp(size_t value, size_t alignment) {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    // Row bytes and row count of each plane, tightly packed
+    struct PlaneLayout {
+        int count = 0;
+        size_t rowBytes[3] = {};
+        size_t rows[3] = {};
+    };
+
+    bool planeLayout(const DecodedFrame& frame, PlaneLayout& layout) {
+        const size_t width = frame.width;
+        const size_t height = frame.height;
+        const size_t chromaWidth = (width + 1) / 2;
+        const size_t chromaHeight = (height + 1) / 2;
+
+        switch (frame.format) {
+            case PixelFormat::NV12:
+                layout.count = 2;
+                layout.rowBytes[0] = width;
+                layout.rows[0] = height;
+                layout.rowBytes[1] = chromaWidth * 2;
+                layout.rows[1] = chromaHeight;
+                return true;
+            case PixelFormat::YUV420P:
+                layout.count = 3;
+                layout.rowBytes[0] = width;
+                layout.rows[0] = height;
+                layout.rowBytes[1] = layout.rowBytes[2] = chromaWidth;
+                layout.rows[1] = layout.rows[2] = chromaHeight;
+                return true;
+            case PixelFormat::RGBA:
+            case PixelFormat::BGR:
+                layout.count = 1;
+                layout.rowBytes[0] = width * (frame.format == PixelFormat::RGBA ? 4 : 3);
+                layout.rows[0] = height;
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    // Seqlock write side: odd while the descriptor (and its payload) change
+    void beginWrite(FrameDescriptor& descriptor) {
+        descriptor.sequence.store(descriptor.sequence.load(std::memory_order_relaxed) + 1,
+                                  std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+    }
+
+    void endWrite(FrameDescriptor& descriptor) {
+        descriptor.sequence.store(descriptor.sequence.load(std::memory_order_relaxed) + 1,
+                                  std::memory_order_release);
+    }
+
+#ifndef _WIN32
+    long futex(std::atomic<uint32_t>* word, int op, uint32_t value, const timespec* timeout) {
+        // Shared (not FUTEX_PRIVATE): waiters are in other processes
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(word), op, value, timeout, nullptr, 0);
+    }
+#endif
+}
+
+// ============================================================================
+// FrameRingWriter
+// ============================================================================
+
+FrameRingWriter::FrameRingWriter(const Config& config)
+    : config_(config)
+{
+    config_.slots = std::max<uint32_t>(1, config_.slots);
+    config_.bufferBytes = alignUp(std::max<size_t>(kPlaneAlignment, config_.bufferBytes), kPlaneAlignment);
+}
+
+FrameRingWriter::~FrameRingWriter() {
+    close();
+}
+
+bool FrameRingWriter::create() {
+    close();
+
+    const size_t slotsOffset = alignUp(sizeof(RingHeader), kPlaneAlignment);
+    const size_t payloadOffset = alignUp(slotsOffset + config_.slots * sizeof(SlotHeader), 4096);
+    const size_t totalBytes = payloadOffset + size_t(config_.slots) * kBuffersPerSlot * config_.bufferBytes;
+
+    if (!region_.create(config_.name, totalBytes)) {
+        std::cerr << "FrameRingWriter: failed to create region " << config_.name << std::endl;
+        return false;
+    }
+
+    uint8_t* base = region_.data();
+    header_ = new (base) RingHeader();
+    slots_ = reinterpret_cast<SlotHeader*>(base + slotsOffset);
+    payload_ = base + payloadOffset;
+
+    for (uint32_t i = 0; i < config_.slots; ++i) {
+        SlotHeader* slot = new (&slots_[i]) SlotHeader();
+        slot->latest.store(kNoBuffer, std::memory_order_relaxed);
+    }
+
+    header_->version = kFrameRingVersion;
+    header_->slotCount = config_.slots;
+    header_->buffersPerSlot = kBuffersPerSlot;
+    header_->bufferBytes = config_.bufferBytes;
+    header_->slotsOffset = slotsOffset;
+    header_->payloadOffset = payloadOffset;
+    header_->totalBytes = totalBytes;
+
+    // Magic last: a reader that sees it sees the whole layout
+    std::atomic_thread_fence(std::memory_order_release);
+    header_->magic = kFrameRingMagic;
+
+    {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        held_.assign(config_.slots, {});
+        frameNumbers_.assign(config_.slots, 0);
+    }
+
+#ifdef HAVE_CUDA
+    // Device frames are exported or downloaded in their decoder's context
+    CudaContext::getInstance(config_.cudaDeviceId).initialize();
+#endif
+
+    std::cout << "FrameRingWriter: " << config_.name << " with " << config_.slots << " slots ("
+              << totalBytes / (1024 * 1024) << " MB)" << std::endl;
+    return true;
+}
+
+void FrameRingWriter::close() {
+    if (!region_.isOpen()) {
+        return;
+    }
+
+    // Viewers see every slot go away before the name does
+    for (uint32_t i = 0; i < header_->slotCount; ++i) {
+        closeSlot(static_cast<int>(i));
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        held_.clear();
+        frameNumbers_.clear();
+    }
+
+    header_ = nullptr;
+    slots_ = nullptr;
+    payload_ = nullptr;
+    region_.close();
+}
+
+int FrameRingWriter::openSlot(const std::string& cameraId) {
+    if (!header_ || cameraId.empty()) {
+        return -1;
+    }
+
+    std::lock_guard<std::mutex> lock(slotMutex_);
+
+    int freeSlot = -1;
+    for (uint32_t i = 0; i < header_->slotCount; ++i) {
+        SlotHeader& slot = slots_[i];
+        if (slot.active.load(std::memory_order_relaxed)) {
+            if (std::strncmp(slot.cameraId, cameraId.c_str(), kCameraIdLength - 1) == 0) {
+                return static_cast<int>(i);
+            }
+        } else if (freeSlot < 0) {
+            freeSlot = static_cast<int>(i);
+        }
+    }
+
+    if (freeSlot < 0) {
+        std::cerr << "FrameRingWriter: no free slot for camera " << cameraId << std::endl;
+        return -1;
+    }
+
+    SlotHeader& slot = slots_[freeSlot];
+    std::memset(slot.cameraId, 0, sizeof(slot.cameraId));
+    std::memcpy(slot.cameraId, cameraId.data(), std::min(cameraId.size(), kCameraIdLength - 1));
+    slot.latest.store(kNoBuffer, std::memory_order_relaxed);
+    slot.published.store(0, std::memory_order_relaxed);
+    frameNumbers_[freeSlot] = 0;
+    slot.active.store(1, std::memory_order_release);
+
+    return freeSlot;
+}
+
+void FrameRingWriter::closeSlot(int slot) {
+    if (!header_ || slot < 0 || static_cast<uint32_t>(slot) >= header_->slotCount) {
+        return;
+    }
+
+    std::array<FrameHandle, kBuffersPerSlot> released;
+    {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        SlotHeader& header = slots_[slot];
+        if (!header.active.load(std::memory_order_relaxed)) {
+            return;
+        }
+
+        header.active.store(0, std::memory_order_release);
+        header.latest.store(kNoBuffer, std::memory_order_release);
+
+        // Invalidate views still held by viewers before their surfaces go back to the pool
+        for (FrameDescriptor& descriptor : header.buffers) {
+            beginWrite(descriptor);
+            descriptor.storage = static_cast<uint32_t>(FrameStorage::EMPTY);
+            endWrite(descriptor);
+        }
+        released.swap(held_[slot]);
+    }
+
+    wakeReaders();
+}
+
+bool FrameRingWriter::publish(int slot, const FrameHandle& frame) {
+    if (!header_ || !frame || slot < 0 || static_cast<uint32_t>(slot) >= header_->slotCount) {
+        return false;
+    }
+
+    SlotHeader& header = slots_[slot];
+    if (!header.active.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    // The buffer after the newest: viewers reading the newest (or the one before) are undisturbed
+    const uint32_t latest = header.latest.load(std::memory_order_relaxed);
+    const uint32_t index = latest == kNoBuffer ? 0 : (latest + 1) % kBuffersPerSlot;
+    FrameDescriptor& descriptor = header.buffers[index];
+    uint8_t* buffer = payload_ + (size_t(slot) * kBuffersPerSlot + index) * header_->bufferBytes;
+
+    FrameHandle previous;
+    {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        previous = std::move(held_[slot][index]);
+    }
+
+    beginWrite(descriptor);
+
+    descriptor.width = frame->width;
+    descriptor.height = frame->height;
+    descriptor.format = static_cast<uint32_t>(frame->format);
+    descriptor.pts = frame->pts;
+    descriptor.keyframe = frame->isKeyframe ? 1 : 0;
+    descriptor.cudaDevice = config_.cudaDeviceId;
+
+    bool exported = false;
+    bool written = false;
+    if (frame->cudaSurface) {
+        exported = exportDevice(*frame, descriptor);
+        written = exported;
+        if (!exported) {
+            written = writeHost(*frame, descriptor, buffer);
+            downloads_ += written ? 1 : 0;
+        }
+    } else {
+        written = writeHost(*frame, descriptor, buffer);
+        hostCopies_ += written ? 1 : 0;
+    }
+
+    if (!written) {
+        descriptor.storage = static_cast<uint32_t>(FrameStorage::EMPTY);
+        endWrite(descriptor);
+        dropped_++;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(slotMutex_);
+        descriptor.frameNumber = ++frameNumbers_[slot];
+        if (exported) {
+            held_[slot][index] = frame;   // Viewers read the surface itself
+        }
+    }
+
+    endWrite(descriptor);
+    header.latest.store(index, std::memory_order_release);
+    header.published.fetch_add(1, std::memory_order_relaxed);
+
+    ipcExports_ += exported ? 1 : 0;
+    published_++;
+    wakeReaders();
+    return true;
+}
+
+FrameRingWriter::Stats FrameRingWriter::getStats() const {
+    Stats stats;
+    stats.published = published_.load();
+    stats.hostCopies = hostCopies_.load();
+    stats.ipcExports = ipcExports_.load();
+    stats.downloads = downloads_.load();
+    stats.dropped = dropped_.load();
+    return stats;
+}
+
+bool FrameRingWriter::writeHost(const DecodedFrame& frame, FrameDescriptor& descriptor, uint8_t* buffer) {
+    PlaneLayout layout;
+    if (!planeLayout(frame, layout)) {
+        return false;
+    }
+
+    size_t offsets[3] = {};
+    size_t bytes = 0;
+    for (int i = 0; i < layout.count; ++i) {
+        if (!frame.data[i]) {
+            return false;
+        }
+        offsets[i] = bytes;
+        bytes = alignUp(bytes + layout.rowBytes[i] * layout.rows[i], kPlaneAlignment);
+    }
+    if (bytes > header_->bufferBytes) {
+        return false;
+    }
+
+    if (frame.cudaSurface) {
+#ifdef HAVE_CUDA
+        // Not exportable (driver-mapped surface): one download straight into the region
+        CudaContext& cuda = CudaContext::getInstance(config_.cudaDeviceId);
+        if (!cuda.isInitialized()) {
+            return false;
+        }
+
+        CUresult result = CUDA_SUCCESS;
+        cuCtxPushCurrent(cuda.getContext());
+        for (int i = 0; i < layout.count && result == CUDA_SUCCESS; ++i) {
+            CUDA_MEMCPY2D copy = {};
+            copy.srcMemoryType = CU_MEMORYTYPE_DEVICE;
+            copy.srcDevice = reinterpret_cast<CUdeviceptr>(frame.data[i]);
+            copy.srcPitch = static_cast<size_t>(frame.pitch[i]);
+            copy.dstMemoryType = CU_MEMORYTYPE_HOST;
+            copy.dstHost = buffer + offsets[i];
+            copy.dstPitch = layout.rowBytes[i];
+            copy.WidthInBytes = layout.rowBytes[i];
+            copy.Height = layout.rows[i];
+            result = cuMemcpy2D(&copy);
+        }
+        cuCtxPopCurrent(nullptr);
+
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "FrameRingWriter: frame download failed: " << result << std::endl;
+            return false;
+        }
+#else
+        return false;
+#endif
+    } else {
+        for (int i = 0; i < layout.count; ++i) {
+            const uint8_t* src = frame.data[i];
+            uint8_t* dst = buffer + offsets[i];
+            for (size_t row = 0; row < layout.rows[i]; ++row) {
+                std::memcpy(dst + row * layout.rowBytes[i], src + row * frame.pitch[i], layout.rowBytes[i]);
+            }
+        }
+    }
+
+    descriptor.storage = static_cast<uint32_t>(FrameStorage::HOST);
+    for (int i = 0; i < 3; ++i) {
+        descriptor.pitch[i] = i < layout.count ? static_cast<uint32_t>(layout.rowBytes[i]) : 0;
+        descriptor.planeOffset[i] = i < layout.count ? offsets[i] : 0;
+    }
+    return true;
+}
+
+bool FrameRingWriter::exportDevice(const DecodedFrame& frame, FrameDescriptor& descriptor) {
+#ifdef HAVE_CUDA
+    PlaneLayout layout;
+    CudaContext& cuda = CudaContext::getInstance(config_.cudaDeviceId);
+    if (!planeLayout(frame, layout) || !cuda.isInitialized()) {
+        return false;
+    }
+
+    // All planes of a decoder surface live in one allocation; export that allocation
+    const CUdeviceptr first = reinterpret_cast<CUdeviceptr>(frame.data[0]);
+    CUdeviceptr base = 0;
+    size_t size = 0;
+    CUipcMemHandle handle = {};
+
+    cuCtxPushCurrent(cuda.getContext());
+    CUresult result = cuMemGetAddressRange(&base, &size, first);
+    if (result == CUDA_SUCCESS) {
+        result = cuIpcGetMemHandle(&handle, base);
+    }
+    cuCtxPopCurrent(nullptr);
+
+    if (result != CUDA_SUCCESS) {
+        return false;
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        descriptor.pitch[i] = 0;
+        descriptor.planeOffset[i] = 0;
+        if (i >= layout.count) {
+            continue;
+        }
+
+        const CUdeviceptr plane = reinterpret_cast<CUdeviceptr>(frame.data[i]);
+        if (!frame.data[i] || plane < base || plane - base >= size) {
+            return false;
+        }
+        descriptor.pitch[i] = static_cast<uint32_t>(frame.pitch[i]);
+        descriptor.planeOffset[i] = plane - base;
+    }
+
+    static_assert(sizeof(CUipcMemHandle) == sizeof(descriptor.ipcHandle), "CUipcMemHandle size");
+    std::memcpy(descriptor.ipcHandle, &handle, sizeof(handle));
+    descriptor.storage = static_cast<uint32_t>(FrameStorage::CUDA_IPC);
+    return true;
+#else
+    (void)frame;
+    (void)descriptor;
+    return false;
+#endif
+}
+
+void FrameRingWriter::wakeReaders() {
+    if (!header_) {
+        return;
+    }
+
+    header_->notify.fetch_add(1, std::memory_order_release);
+#ifndef _WIN32
+    if (header_->waiters.load(std::memory_order_acquire) > 0) {
+        futex(&header_->notify, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+#endif
+}
+
+// ============================================================================
+// FrameRingReader
+// ============================================================================
+
+FrameRingReader::~FrameRingReader() {
+    close();
+}
+
+bool FrameRingReader::open(const std::string& name) {
+    close();
+
+    if (!region_.open(name)) {
+        return false;
+    }
+
+    uint8_t* base = region_.data();
+    const RingHeader* header = reinterpret_cast<const RingHeader*>(base);
+    if (region_.size() < sizeof(RingHeader) || header->magic != kFrameRingMagic) {
+        region_.close();
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (header->version != kFrameRingVersion || header->buffersPerSlot != kBuffersPerSlot ||
+        header->totalBytes > region_.size()) {
+        std::cerr << "FrameRingReader: " << name << " has an incompatible layout (version "
+                  << header->version << ")" << std::endl;
+        region_.close();
+        return false;
+    }
+
+    header_ = reinterpret_cast<RingHeader*>(base);
+    slots_ = reinterpret_cast<SlotHeader*>(base + header_->slotsOffset);
+    payload_ = base + header_->payloadOffset;
+    return true;
+}
+
+void FrameRingReader::close() {
+#ifdef HAVE_CUDA
+    closeMappings();
+#endif
+    header_ = nullptr;
+    slots_ = nullptr;
+    payload_ = nullptr;
+    region_.close();
+}
+
+int FrameRingReader::findSlot(const std::string& cameraId) const {
+    if (!header_) {
+        return -1;
+    }
+
+    for (uint32_t i = 0; i < header_->slotCount; ++i) {
+        const SlotHeader& slot = slots_[i];
+        if (slot.active.load(std::memory_order_acquire) &&
+            std::strncmp(slot.cameraId, cameraId.c_str(), kCameraIdLength - 1) == 0) {
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool FrameRingReader::acquire(int slot, FrameView& view, uint64_t afterFrame) const {
+    if (!header_ || slot < 0 || static_cast<uint32_t>(slot) >= header_->slotCount) {
+        return false;
+    }
+
+    const SlotHeader& header = slots_[slot];
+    if (!header.active.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    for (int attempt = 0; attempt < kSeqlockRetries; ++attempt) {
+        const uint32_t index = header.latest.load(std::memory_order_acquire);
+        if (index >= kBuffersPerSlot) {
+            return false;
+        }
+
+        const FrameDescriptor& descriptor = header.buffers[index];
+        const uint64_t before = descriptor.sequence.load(std::memory_order_acquire);
+        if (before & 1) {
+            continue;   // Being rewritten: latest has moved on
+        }
+
+        FrameView copy;
+        copy.slot = slot;
+        copy.buffer = index;
+        copy.sequence = before;
+        copy.frameNumber = descriptor.frameNumber;
+        copy.pts = descriptor.pts;
+        copy.width = descriptor.width;
+        copy.height = descriptor.height;
+        copy.format = static_cast<PixelFormat>(descriptor.format);
+        copy.storage = static_cast<FrameStorage>(descriptor.storage);
+        copy.keyframe = descriptor.keyframe != 0;
+        copy.cudaDevice = descriptor.cudaDevice;
+        for (int i = 0; i < 3; ++i) {
+            copy.pitch[i] = descriptor.pitch[i];
+            copy.ipcOffset[i] = descriptor.planeOffset[i];
+        }
+        std::memcpy(copy.ipcHandle, descriptor.ipcHandle, sizeof(copy.ipcHandle));
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (descriptor.sequence.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+
+        if (copy.storage == FrameStorage::EMPTY || copy.frameNumber <= afterFrame) {
+            return false;
+        }
+
+        if (copy.storage == FrameStorage::HOST) {
+            const uint8_t* buffer = payload_ + (size_t(slot) * kBuffersPerSlot + index) * header_->bufferBytes;
+            for (int i = 0; i < 3; ++i) {
+                if (copy.pitch[i] && copy.ipcOffset[i] < header_->bufferBytes) {
+                    copy.planes[i] = buffer + copy.ipcOffset[i];
+                }
+            }
+            std::memset(copy.ipcOffset, 0, sizeof(copy.ipcOffset));
+        }
+
+        view = copy;
+        return true;
+    }
+
+    return false;
+}
+
+bool FrameRingReader::isCurrent(const FrameView& view) const {
+    if (!header_ || view.slot < 0 || static_cast<uint32_t>(view.slot) >= header_->slotCount ||
+        view.buffer >= kBuffersPerSlot) {
+        return false;
+    }
+
+    // Order the caller's reads of the pixels before the re-check
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slots_[view.slot].buffers[view.buffer].sequence.load(std::memory_order_relaxed) == view.sequence;
+}
+
+bool FrameRingReader::mapDevice(FrameView& view) {
+    if (view.storage != FrameStorage::CUDA_IPC) {
+        return false;
+    }
+
+#ifdef HAVE_CUDA
+    const std::string key(reinterpret_cast<const char*>(view.ipcHandle), sizeof(view.ipcHandle));
+
+    CUdeviceptr base = 0;
+    auto it = mapped_.find(key);
+    if (it != mapped_.end()) {
+        base = it->second;
+    } else {
+        // Decoder pools recycle surfaces, so the set of allocations seen stays small
+        if (mapped_.size() >= kMaxMappings) {
+            closeMappings();
+        }
+
+        CUipcMemHandle handle;
+        std::memcpy(&handle, view.ipcHandle, sizeof(handle));
+        CUresult result = cuIpcOpenMemHandle(&base, handle, CU_IPC_MEM_LAZY_ENABLE_PEER_ACCESS);
+        if (result != CUDA_SUCCESS) {
+            std::cerr << "FrameRingReader: cuIpcOpenMemHandle failed: " << result << std::endl;
+            return false;
+        }
+        mapped_.emplace(key, base);
+    }
+
+    for (int i = 0; i < 3; ++i) {
+        view.devicePlanes[i] = view.pitch[i] ? base + view.ipcOffset[i] : 0;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+uint32_t FrameRingReader::notifyCounter() const {
+    return header_ ? header_->notify.load(std::memory_order_acquire) : 0;
+}
+
+bool FrameRingReader::waitForPublish(uint32_t notifyValue, std::chrono::milliseconds timeout) const {
+    if (!header_) {
+        return false;
+    }
+
+#ifdef _WIN32
+    // WaitOnAddress doesn't cross processes: poll the counter
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+    while (header_->notify.load(std::memory_order_acquire) == notifyValue) {
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return false;
+        }
+        Sleep(1);
+    }
+    return true;
+#else
+    header_->waiters.fetch_add(1, std::memory_order_acq_rel);
+
+    if (header_->notify.load(std::memory_order_acquire) == notifyValue) {
+        const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(timeout);
+        timespec relative = {};
+        relative.tv_sec = static_cast<time_t>(seconds.count());
+        relative.tv_nsec = static_cast<long>(std::chrono::duration_cast<std::chrono::nanoseconds>(timeout - seconds).count());
+
+        // Returns at once if a publish got in between the load and the wait
+        futex(&header_->notify, FUTEX_WAIT, notifyValue, &relative);
+    }
+
+    header_->waiters.fetch_sub(1, std::memory_order_acq_rel);
+    return header_->notify.load(std::memory_order_acquire) != notifyValue;
+#endif
+}
+
+#ifdef HAVE_CUDA
+void FrameRingReader::closeMappings() {
+    for (auto& [key, base] : mapped_) {
+        cuIpcCloseMemHandle(base);
+    }
+    mapped_.clear();
+}
+#endif
+
+} // namespace ipc
+} // namespace fluxvision
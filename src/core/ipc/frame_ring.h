@@ -0,0 +1,224 @@
+// src/core/ipc/frame_ring.h
+// Server -> viewer frame transport: per-camera seqlocked slots in shared memory, CUDA IPC for GPU surfaces
+#pragma once
+
+#include "shared_memory.h"
+#include "../codec/frame_lease.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#endif
+
+namespace fluxvision {
+namespace ipc {
+
+constexpr uint32_t kFrameRingMagic = 0x46565246;     // "FRVF"
+constexpr uint32_t kFrameRingVersion = 1;
+constexpr uint32_t kBuffersPerSlot = 3;              // Newest, previous, and the one being written
+constexpr uint32_t kNoBuffer = ~0u;
+constexpr size_t kCameraIdLength = 64;
+
+// Where a published frame's pixels are
+enum class FrameStorage : uint32_t {
+    EMPTY = 0,
+    HOST = 1,        // Packed planes in the slot's payload area of the region
+    CUDA_IPC = 2     // Device allocation exported with cuIpcGetMemHandle (no copy)
+};
+
+// Shared layout. Every field is plain data or an address-free lock-free
+// atomic, so both processes can use it in place.
+
+// One buffer of a slot, guarded by its own seqlock (odd sequence = being written)
+struct alignas(64) FrameDescriptor {
+    std::atomic<uint64_t> sequence;
+    uint64_t frameNumber;        // Per slot, from 1
+    int64_t pts;
+    uint32_t width;
+    uint32_t height;
+    uint32_t format;             // PixelFormat
+    uint32_t storage;            // FrameStorage
+    uint32_t keyframe;
+    int32_t cudaDevice;
+    uint32_t pitch[3];
+    uint64_t planeOffset[3];     // HOST: from the buffer start; CUDA_IPC: from the allocation base
+    uint8_t ipcHandle[64];       // CUipcMemHandle of the allocation (CUDA_IPC)
+};
+
+// One camera
+struct alignas(64) SlotHeader {
+    char cameraId[kCameraIdLength];
+    std::atomic<uint32_t> active;     // 0 = free
+    std::atomic<uint32_t> latest;     // Buffer index of the newest frame (kNoBuffer = none yet)
+    std::atomic<uint64_t> published;
+    FrameDescriptor buffers[kBuffersPerSlot];
+};
+
+struct alignas(64) RingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t slotCount;
+    uint32_t buffersPerSlot;
+    uint64_t bufferBytes;             // Host payload capacity of one buffer
+    uint64_t slotsOffset;             // SlotHeader[slotCount]
+    uint64_t payloadOffset;           // slotCount x buffersPerSlot x bufferBytes
+    uint64_t totalBytes;
+    alignas(64) std::atomic<uint32_t> notify;   // Futex word, bumped by every publish
+    std::atomic<uint32_t> waiters;              // Readers blocked on notify
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "frame ring atomics must be lock-free to live in shared memory");
+
+// Server side: creates the region and publishes frames into it
+//
+// Host frames (CpuDecoder, converted RGBA/BGR) are copied once into the
+// slot's next buffer. Device frames are exported as CUDA IPC handles: the
+// viewer maps the writer's allocation and reads it in place, and the writer
+// keeps the frame leased until that buffer is reused two publishes later.
+// Device memory that can't be exported (driver-mapped NVDEC output in
+// zero-copy mode) is downloaded into the host buffer instead.
+//
+// Thread-safety: openSlot()/closeSlot() from any thread; publish() for a
+// given slot from one thread at a time (its camera's decode worker).
+class FrameRingWriter {
+public:
+    struct Config {
+        std::string name = "fluxvision-frames";
+        uint32_t slots = 32;                               // Cameras
+        size_t bufferBytes = 1280 * 720 * 3 / 2;           // Host payload per buffer (720p NV12; exported device frames need none)
+        int cudaDeviceId = 0;                              // Device the decoded surfaces live on
+    };
+
+    struct Stats {
+        uint64_t published = 0;
+        uint64_t hostCopies = 0;
+        uint64_t ipcExports = 0;
+        uint64_t downloads = 0;       // Device frames copied to the host buffer
+        uint64_t dropped = 0;         // Too large for a buffer, or CUDA failures
+    };
+
+    explicit FrameRingWriter(const Config& config);
+    ~FrameRingWriter();
+
+    // Delete copy/move
+    FrameRingWriter(const FrameRingWriter&) = delete;
+    FrameRingWriter& operator=(const FrameRingWriter&) = delete;
+
+    bool create();
+    void close();
+    bool isOpen() const { return region_.isOpen(); }
+
+    // Claim a slot for cameraId (the existing one if already open)
+    // Returns: slot index, -1 if the ring is full
+    int openSlot(const std::string& cameraId);
+    void closeSlot(int slot);
+
+    // Make frame the slot's newest and wake waiting viewers
+    bool publish(int slot, const FrameHandle& frame);
+
+    Stats getStats() const;
+
+private:
+    Config config_;
+    SharedMemoryRegion region_;
+    RingHeader* header_ = nullptr;
+    SlotHeader* slots_ = nullptr;
+    uint8_t* payload_ = nullptr;
+
+    std::mutex slotMutex_;
+    std::vector<std::array<FrameHandle, kBuffersPerSlot>> held_;   // Exported frames, per buffer
+    std::vector<uint64_t> frameNumbers_;
+
+    std::atomic<uint64_t> published_{0};
+    std::atomic<uint64_t> hostCopies_{0};
+    std::atomic<uint64_t> ipcExports_{0};
+    std::atomic<uint64_t> downloads_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    bool writeHost(const DecodedFrame& frame, FrameDescriptor& descriptor, uint8_t* buffer);
+    bool exportDevice(const DecodedFrame& frame, FrameDescriptor& descriptor);
+    void wakeReaders();
+};
+
+// Viewer side: a published frame, valid while isCurrent() holds
+struct FrameView {
+    int slot = -1;
+    uint32_t buffer = kNoBuffer;
+    uint64_t sequence = 0;           // Seqlock value the view was taken at
+    uint64_t frameNumber = 0;
+    int64_t pts = 0;
+    uint32_t width = 0;
+    uint32_t height = 0;
+    PixelFormat format = PixelFormat::UNKNOWN;
+    FrameStorage storage = FrameStorage::EMPTY;
+    bool keyframe = false;
+    int cudaDevice = 0;
+    uint32_t pitch[3] = {};
+    const uint8_t* planes[3] = {};   // HOST: pointers into the shared region
+    uint64_t devicePlanes[3] = {};   // CUDA_IPC: mapped in this process (after mapDevice())
+    uint8_t ipcHandle[64] = {};
+    uint64_t ipcOffset[3] = {};
+};
+
+// Viewer side: maps the server's region and reads frames in place
+//
+// acquire() takes a consistent snapshot of a slot's descriptor without
+// locks; the pixels stay where the writer put them. After using them (texture
+// upload, GPU copy), isCurrent() tells whether the writer has since reused
+// that buffer, in which case the result should be discarded.
+//
+// Thread-safety: Not thread-safe (one viewer thread per reader)
+class FrameRingReader {
+public:
+    FrameRingReader() = default;
+    ~FrameRingReader();
+
+    // Delete copy/move
+    FrameRingReader(const FrameRingReader&) = delete;
+    FrameRingReader& operator=(const FrameRingReader&) = delete;
+
+    bool open(const std::string& name = "fluxvision-frames");
+    void close();
+    bool isOpen() const { return header_ != nullptr; }
+
+    uint32_t getSlotCount() const { return header_ ? header_->slotCount : 0; }
+
+    // Slot carrying cameraId (-1 if the server hasn't opened one)
+    int findSlot(const std::string& cameraId) const;
+
+    // Newest frame of slot; false if none, or nothing newer than afterFrame
+    bool acquire(int slot, FrameView& view, uint64_t afterFrame = 0) const;
+
+    // The writer hasn't touched view's buffer since acquire()
+    bool isCurrent(const FrameView& view) const;
+
+    // CUDA_IPC views: fill devicePlanes (this process's CUDA context must be current)
+    bool mapDevice(FrameView& view);
+
+    // Block until something is published after notifyValue (from notifyCounter())
+    bool waitForPublish(uint32_t notifyValue, std::chrono::milliseconds timeout) const;
+    uint32_t notifyCounter() const;
+
+private:
+    SharedMemoryRegion region_;
+    RingHeader* header_ = nullptr;
+    SlotHeader* slots_ = nullptr;
+    uint8_t* payload_ = nullptr;
+
+#ifdef HAVE_CUDA
+    // Exported allocations opened in this process, keyed by handle bytes
+    std::unordered_map<std::string, CUdeviceptr> mapped_;
+    void closeMappings();
+#endif
+};
+
+} // namespace ipc
+} // namespace fluxvision
@@ -0,0 +1,179 @@
+// src/core/ipc/shared_memory.cpp
+#include "shared_memory.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace fluxvision {
+namespace ipc {
+
+SharedMemoryRegion::~SharedMemoryRegion() {
+    close();
+}
+
+std::string SharedMemoryRegion::platformName(const std::string& name) {
+#ifdef _WIN32
+    return "Local\\" + name;    // Session namespace: no SeCreateGlobalPrivilege needed
+#else
+    return "/" + name;          // POSIX shm names start with a single slash
+#endif
+}
+
+bool SharedMemoryRegion::create(const std::string& name, size_t size) {
+    close();
+    if (name.empty() || size == 0) {
+        return false;
+    }
+
+    const std::string path = platformName(name);
+
+#ifdef _WIN32
+    const DWORD high = static_cast<DWORD>(static_cast<uint64_t>(size) >> 32);
+    const DWORD low = static_cast<DWORD>(size & 0xFFFFFFFFu);
+    HANDLE mapping = CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, high, low, path.c_str());
+    if (!mapping) {
+        std::cerr << "SharedMemoryRegion: CreateFileMapping " << path << " failed: " << GetLastError() << std::endl;
+        return false;
+    }
+    if (GetLastError() == ERROR_ALREADY_EXISTS) {
+        // Mapped by a previous server instance's viewers; its size is fixed
+        std::cerr << "SharedMemoryRegion: " << path << " is still mapped by another process" << std::endl;
+        CloseHandle(mapping);
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (!view) {
+        std::cerr << "SharedMemoryRegion: MapViewOfFile " << path << " failed: " << GetLastError() << std::endl;
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_ = mapping;
+    data_ = static_cast<uint8_t*>(view);  // Pagefile-backed views start zeroed
+#else
+    // A region left behind by a crashed server would have the old layout
+    shm_unlink(path.c_str());
+
+    int fd = shm_open(path.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "SharedMemoryRegion: shm_open " << path << " failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    if (ftruncate(fd, static_cast<off_t>(size)) != 0) {
+        std::cerr << "SharedMemoryRegion: ftruncate " << path << " failed: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        std::cerr << "SharedMemoryRegion: mmap " << path << " failed: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        shm_unlink(path.c_str());
+        return false;
+    }
+    fd_ = fd;
+    data_ = static_cast<uint8_t*>(view);  // ftruncate zero-fills
+#endif
+
+    name_ = name;
+    size_ = size;
+    owner_ = true;
+    return true;
+}
+
+bool SharedMemoryRegion::open(const std::string& name) {
+    close();
+    if (name.empty()) {
+        return false;
+    }
+
+    const std::string path = platformName(name);
+
+#ifdef _WIN32
+    HANDLE mapping = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, path.c_str());
+    if (!mapping) {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, 0);
+    MEMORY_BASIC_INFORMATION info = {};
+    if (!view || VirtualQuery(view, &info, sizeof(info)) == 0) {
+        if (view) {
+            UnmapViewOfFile(view);
+        }
+        CloseHandle(mapping);
+        return false;
+    }
+    mapping_ = mapping;
+    data_ = static_cast<uint8_t*>(view);
+    size_ = info.RegionSize;
+#else
+    int fd = shm_open(path.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        return false;
+    }
+
+    struct stat st = {};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        ::close(fd);
+        return false;
+    }
+
+    const size_t size = static_cast<size_t>(st.st_size);
+    void* view = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (view == MAP_FAILED) {
+        std::cerr << "SharedMemoryRegion: mmap " << path << " failed: " << std::strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    fd_ = fd;
+    data_ = static_cast<uint8_t*>(view);
+    size_ = size;
+#endif
+
+    name_ = name;
+    owner_ = false;
+    return true;
+}
+
+void SharedMemoryRegion::close() {
+#ifdef _WIN32
+    if (data_) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_) {
+        CloseHandle(static_cast<HANDLE>(mapping_));
+        mapping_ = nullptr;
+    }
+#else
+    if (data_) {
+        munmap(data_, size_);
+    }
+    if (fd_ >= 0) {
+        ::close(fd_);
+        fd_ = -1;
+    }
+    if (owner_ && !name_.empty()) {
+        shm_unlink(platformName(name_).c_str());
+    }
+#endif
+
+    data_ = nullptr;
+    size_ = 0;
+    owner_ = false;
+    name_.clear();
+}
+
+} // namespace ipc
+} // namespace fluxvision
@@ -0,0 +1,57 @@
+// src/core/ipc/shared_memory.h
+// Named shared memory region: POSIX shm on Linux, a pagefile-backed file mapping on Windows
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fluxvision {
+namespace ipc {
+
+// Named region mapped read-write into this process
+//
+// The creator owns the name: it is removed when the creator closes the region
+// (mappings other processes still hold stay valid until they close theirs).
+//
+// Thread-safety: Not thread-safe (open/close from one thread; the mapped
+// memory itself is shared)
+class SharedMemoryRegion {
+public:
+    SharedMemoryRegion() = default;
+    ~SharedMemoryRegion();
+
+    // Delete copy/move
+    SharedMemoryRegion(const SharedMemoryRegion&) = delete;
+    SharedMemoryRegion& operator=(const SharedMemoryRegion&) = delete;
+
+    // Create (replacing a stale region of the same name) and map size bytes, zero-filled
+    bool create(const std::string& name, size_t size);
+
+    // Map an existing region (its full size)
+    bool open(const std::string& name);
+
+    void close();
+
+    bool isOpen() const { return data_ != nullptr; }
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    const std::string& name() const { return name_; }
+
+private:
+    std::string name_;
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool owner_ = false;
+
+#ifdef _WIN32
+    void* mapping_ = nullptr;   // HANDLE
+#else
+    int fd_ = -1;
+#endif
+
+    static std::string platformName(const std::string& name);
+};
+
+} // namespace ipc
+} // namespace fluxvision
@@ -0,0 +1,227 @@
+// src/core/metrics/camera_metrics.h
+// Per-camera counters and histograms, updated lock-free on the hot paths and read on scrape
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace fluxvision {
+namespace metrics {
+
+// Upper bounds of the latency buckets (microseconds); the last bucket is +Inf
+constexpr std::array<uint32_t, 13> kLatencyBucketsUs = {
+    250, 500, 1000, 2000, 5000, 10000, 20000, 40000, 80000, 160000, 320000, 640000, 1280000
+};
+constexpr size_t kLatencyBucketCount = kLatencyBucketsUs.size() + 1;
+
+// Pipeline intervals of one access unit (see metrics::FrameTracer)
+enum class LatencyStage : uint8_t {
+    INGEST,      // Socket read -> queue push (depacketize, assemble, fan out)
+    QUEUE,       // Queue push -> pop by the decode worker
+    DISPATCH,    // Pop -> decoder submit (decimation, prime replay)
+    DECODE,      // Submit -> decoder output (NVDEC display callback)
+    DELIVER,     // Output -> handed to every subscriber
+    TOTAL        // Socket read -> delivered
+};
+constexpr size_t kLatencyStageCount = 6;
+
+inline const char* latencyStageName(LatencyStage stage) {
+    static const char* const names[kLatencyStageCount] = {"ingest", "queue", "dispatch", "decode", "deliver", "total"};
+    return names[static_cast<size_t>(stage)];
+}
+
+// Fixed-bucket histogram with a single writer; readers may race (each field is atomic)
+class LatencyHistogram {
+public:
+    struct Snapshot {
+        std::array<uint64_t, kLatencyBucketCount> buckets{};   // Not cumulative
+        uint64_t count = 0;
+        uint64_t sumUs = 0;
+    };
+
+    void record(uint64_t micros) {
+        size_t bucket = 0;
+        while (bucket < kLatencyBucketsUs.size() && micros > kLatencyBucketsUs[bucket]) {
+            bucket++;
+        }
+        buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+        sumUs_.fetch_add(micros, std::memory_order_relaxed);
+    }
+
+    Snapshot snapshot() const {
+        Snapshot snapshot;
+        for (size_t i = 0; i < kLatencyBucketCount; ++i) {
+            snapshot.buckets[i] = buckets_[i].load(std::memory_order_relaxed);
+            snapshot.count += snapshot.buckets[i];
+        }
+        snapshot.sumUs = sumUs_.load(std::memory_order_relaxed);
+        return snapshot;
+    }
+
+private:
+    std::array<std::atomic<uint64_t>, kLatencyBucketCount> buckets_{};
+    std::atomic<uint64_t> sumUs_{0};
+};
+
+// Counters of one camera
+//
+// Grouped by the thread that writes them, each group on its own cache line:
+// the network thread (ingest) and the decode worker (decode, surfaces) never
+// share a line, and scrapes only read. Counters are cumulative for the
+// camera's lifetime, as Prometheus expects; rates are taken by the scraper.
+//
+// Thread-safety: each record*() from its group's thread; reads from any thread
+class CameraMetrics {
+public:
+    // Network thread
+    void recordPacket(size_t bytes, bool keyframe) {
+        ingest_.packets.fetch_add(1, std::memory_order_relaxed);
+        ingest_.bytes.fetch_add(bytes, std::memory_order_relaxed);
+        if (keyframe) {
+            ingest_.keyframes.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Decode worker: one decoder call for one access unit
+    void recordDecode(std::chrono::steady_clock::duration elapsed, bool ok) {
+        const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+        decodeLatency_.record(static_cast<uint64_t>(micros > 0 ? micros : 0));
+        if (!ok) {
+            decode_.errors.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // Decode worker: a frame left the decoder
+    void recordFrame(int64_t pts) {
+        decode_.frames.fetch_add(1, std::memory_order_relaxed);
+        decode_.lastPts.store(pts, std::memory_order_relaxed);
+
+        // Frame rate over the last whole second (window state is decode-worker only)
+        const auto now = std::chrono::steady_clock::now();
+        decode_.windowFrames++;
+        const auto elapsed = now - decode_.windowStart;
+        if (elapsed >= std::chrono::seconds(1)) {
+            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count();
+            decode_.fps.store(static_cast<uint32_t>(decode_.windowFrames * 1000 / ms), std::memory_order_relaxed);
+            decode_.windowFrames = 0;
+            decode_.windowStart = now;
+        }
+    }
+
+    // Decode worker: one traced frame's interval
+    void recordStage(LatencyStage stage, int64_t micros) {
+        stageLatency_[static_cast<size_t>(stage)].record(static_cast<uint64_t>(micros > 0 ? micros : 0));
+        if (stage == LatencyStage::TOTAL) {
+            decode_.lastLatencyUs.store(micros, std::memory_order_relaxed);
+        }
+    }
+
+    // Decode worker: decoder kind and surface pool occupancy after a slice
+    void recordSurfaces(bool hardware, size_t allocated, size_t capacity, size_t gpuBytes) {
+        surfaces_.decoder.store(hardware ? DECODER_NVDEC : DECODER_CPU, std::memory_order_relaxed);
+        surfaces_.allocated.store(allocated, std::memory_order_relaxed);
+        surfaces_.capacity.store(capacity, std::memory_order_relaxed);
+        surfaces_.gpuBytes.store(gpuBytes, std::memory_order_relaxed);
+    }
+
+    uint64_t packets() const { return ingest_.packets.load(std::memory_order_relaxed); }
+    uint64_t bytes() const { return ingest_.bytes.load(std::memory_order_relaxed); }
+    uint64_t keyframes() const { return ingest_.keyframes.load(std::memory_order_relaxed); }
+    uint64_t framesDecoded() const { return decode_.frames.load(std::memory_order_relaxed); }
+    uint64_t decodeErrors() const { return decode_.errors.load(std::memory_order_relaxed); }
+    int64_t lastPts() const { return decode_.lastPts.load(std::memory_order_relaxed); }
+    uint32_t fps() const { return decode_.fps.load(std::memory_order_relaxed); }
+    size_t surfacesAllocated() const { return surfaces_.allocated.load(std::memory_order_relaxed); }
+    size_t surfaceCapacity() const { return surfaces_.capacity.load(std::memory_order_relaxed); }
+    size_t gpuBytes() const { return surfaces_.gpuBytes.load(std::memory_order_relaxed); }
+    const char* decoderName() const {
+        switch (surfaces_.decoder.load(std::memory_order_relaxed)) {
+            case DECODER_CPU: return "cpu";
+            case DECODER_NVDEC: return "nvdec";
+            default: return "none";
+        }
+    }
+    LatencyHistogram::Snapshot decodeLatency() const { return decodeLatency_.snapshot(); }
+    LatencyHistogram::Snapshot stageLatency(LatencyStage stage) const {
+        return stageLatency_[static_cast<size_t>(stage)].snapshot();
+    }
+    int64_t lastLatencyUs() const { return decode_.lastLatencyUs.load(std::memory_order_relaxed); }
+
+private:
+    enum : uint32_t { DECODER_NONE = 0, DECODER_CPU = 1, DECODER_NVDEC = 2 };
+
+    struct alignas(64) Ingest {
+        std::atomic<uint64_t> packets{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> keyframes{0};
+    };
+
+    struct alignas(64) Decode {
+        std::atomic<uint64_t> frames{0};
+        std::atomic<uint64_t> errors{0};
+        std::atomic<int64_t> lastPts{0};
+        std::atomic<uint32_t> fps{0};
+        std::atomic<int64_t> lastLatencyUs{0};   // Newest traced frame, socket read to delivery
+        uint64_t windowFrames = 0;
+        std::chrono::steady_clock::time_point windowStart = std::chrono::steady_clock::now();
+    };
+
+    struct alignas(64) Surfaces {
+        std::atomic<uint32_t> decoder{DECODER_NONE};
+        std::atomic<size_t> allocated{0};
+        std::atomic<size_t> capacity{0};
+        std::atomic<size_t> gpuBytes{0};
+    };
+
+    Ingest ingest_;
+    Decode decode_;
+    alignas(64) LatencyHistogram decodeLatency_;   // Decode worker
+    std::array<LatencyHistogram, kLatencyStageCount> stageLatency_;   // Decode worker
+    Surfaces surfaces_;
+};
+
+// Point-in-time copy of one camera's metrics, for exposition
+struct CameraSample {
+    std::string cameraId;
+    std::string state;               // StreamState name
+    std::string quality;             // StreamQuality name (as decoded: gated or capped tier)
+    std::string decoder;             // "nvdec", "cpu" or "none"
+    int cudaDevice = 0;
+    bool idleGated = false;          // Activity gate holds it at keyframe-only decode
+    bool governed = false;           // Quality governor holds it below the requested tier
+
+    // Ingest
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t keyframes = 0;
+
+    // Packet queue
+    size_t queueDepth = 0;
+    size_t queueCapacity = 0;
+
+    // Drops by reason
+    uint64_t droppedNonReference = 0;   // Queue overflow: non-reference pictures
+    uint64_t droppedGop = 0;            // Queue overflow: rest of the GOP
+    uint64_t droppedFull = 0;           // Queue completely full
+    uint64_t discardedStale = 0;        // Queued behind a resync keyframe
+    uint64_t decimated = 0;             // Skipped for the quality tier's frame rate
+
+    // Decode
+    uint64_t framesDecoded = 0;
+    uint64_t decodeErrors = 0;
+    uint32_t fps = 0;
+    LatencyHistogram::Snapshot decodeLatency;
+    std::array<LatencyHistogram::Snapshot, kLatencyStageCount> stageLatency;
+
+    // Decoder surfaces
+    size_t surfacesAllocated = 0;
+    size_t surfaceCapacity = 0;
+    size_t gpuBytes = 0;
+};
+
+} // namespace metrics
+} // namespace fluxvision
@@ -0,0 +1,245 @@
+// src/core/metrics/frame_trace.cpp
+#include "frame_trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace fluxvision {
+namespace metrics {
+
+namespace {
+    // Interval of each LatencyStage except TOTAL: [from, to]
+    constexpr std::array<std::pair<TraceStamp, TraceStamp>, kLatencyStageCount - 1> kIntervals = {{
+        {TraceStamp::RECEIVE, TraceStamp::QUEUE_PUSH},
+        {TraceStamp::QUEUE_PUSH, TraceStamp::QUEUE_POP},
+        {TraceStamp::QUEUE_POP, TraceStamp::DECODE_SUBMIT},
+        {TraceStamp::DECODE_SUBMIT, TraceStamp::DECODE_OUTPUT},
+        {TraceStamp::DECODE_OUTPUT, TraceStamp::DELIVER},
+    }};
+
+    void appendJsonString(std::string& out, const char* value) {
+        out += '"';
+        for (const char* c = value; *c; ++c) {
+            const unsigned char ch = static_cast<unsigned char>(*c);
+            if (ch == '"' || ch == '\\') {
+                out += '\\';
+                out += *c;
+            } else if (ch < 0x20) {
+                char escaped[8];
+                std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+                out += escaped;
+            } else {
+                out += *c;
+            }
+        }
+        out += '"';
+    }
+}
+
+int64_t traceNow() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ============================================================================
+// TraceBuffer
+// ============================================================================
+
+TraceBuffer::TraceBuffer()
+    : slots_(new Slot[kCapacity])
+{
+}
+
+TraceBuffer& TraceBuffer::instance() {
+    static TraceBuffer buffer;
+    return buffer;
+}
+
+void TraceBuffer::record(const std::string& cameraId, const FrameTrace& trace) {
+    if (!isEnabled()) {
+        return;
+    }
+
+    Slot& slot = slots_[next_.fetch_add(1, std::memory_order_relaxed) % kCapacity];
+
+    // Two writers lapping onto one slot would need kCapacity records in between; the
+    // sequence only has to tell readers the slot changed
+    const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+    slot.sequence.store(sequence | 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const size_t length = std::min(cameraId.size(), kCameraIdLength - 1);
+    std::memcpy(slot.record.cameraId, cameraId.data(), length);
+    slot.record.cameraId[length] = '\0';
+    slot.record.trace = trace;
+
+    slot.sequence.store((sequence | 1) + 1, std::memory_order_release);
+}
+
+std::vector<TraceBuffer::Record> TraceBuffer::snapshot() const {
+    const uint64_t end = next_.load(std::memory_order_acquire);
+    const uint64_t begin = end > kCapacity ? end - kCapacity : 0;
+
+    std::vector<Record> records;
+    records.reserve(static_cast<size_t>(end - begin));
+
+    for (uint64_t i = begin; i < end; ++i) {
+        const Slot& slot = slots_[i % kCapacity];
+
+        const uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before == 0 || (before & 1)) {
+            continue;   // Never written, or being rewritten
+        }
+
+        Record copy = slot.record;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) == before) {
+            records.push_back(copy);
+        }
+    }
+
+    return records;
+}
+
+std::string TraceBuffer::toChromeTrace() const {
+    const std::vector<Record> records = snapshot();
+
+    std::string out;
+    out.reserve(256 + records.size() * 600);
+    out += "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    // One track (tid) per camera, named by a metadata event
+    std::unordered_map<std::string, int> tracks;
+    bool first = true;
+    auto separator = [&]() {
+        if (!first) {
+            out += ',';
+        }
+        first = false;
+    };
+
+    for (const Record& record : records) {
+        auto [it, added] = tracks.emplace(record.cameraId, static_cast<int>(tracks.size()) + 1);
+        const std::string tid = std::to_string(it->second);
+
+        if (added) {
+            separator();
+            out += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+            out += tid;
+            out += ",\"args\":{\"name\":";
+            appendJsonString(out, record.cameraId);
+            out += "}}";
+        }
+
+        for (size_t i = 0; i < kIntervals.size(); ++i) {
+            const int64_t from = record.trace.at(kIntervals[i].first);
+            const int64_t to = record.trace.at(kIntervals[i].second);
+            if (from == 0 || to == 0 || to < from) {
+                continue;
+            }
+
+            separator();
+            out += "{\"name\":\"";
+            out += latencyStageName(static_cast<LatencyStage>(i));
+            out += "\",\"cat\":\"frame\",\"ph\":\"X\",\"pid\":1,\"tid\":";
+            out += tid;
+            out += ",\"ts\":";
+            out += std::to_string(from);
+            out += ",\"dur\":";
+            out += std::to_string(to - from);
+            out += ",\"args\":{\"pts\":";
+            out += std::to_string(record.trace.pts);
+            out += "}}";
+        }
+    }
+
+    out += "]}\n";
+    return out;
+}
+
+bool TraceBuffer::writeChromeTrace(const std::string& path) const {
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file) {
+        std::cerr << "TraceBuffer: cannot write " << path << std::endl;
+        return false;
+    }
+
+    const std::string json = toChromeTrace();
+    file.write(json.data(), static_cast<std::streamsize>(json.size()));
+    return static_cast<bool>(file);
+}
+
+void TraceBuffer::clear() {
+    // Slots keep their sequence; resetting the cursor hides everything older
+    for (size_t i = 0; i < kCapacity; ++i) {
+        Slot& slot = slots_[i];
+        const uint64_t sequence = slot.sequence.load(std::memory_order_relaxed);
+        if (!(sequence & 1)) {
+            slot.sequence.store(0, std::memory_order_release);
+        }
+    }
+    next_.store(0, std::memory_order_release);
+}
+
+// ============================================================================
+// FrameTracer
+// ============================================================================
+
+void FrameTracer::onSubmit(int64_t pts, int64_t receiveTime, int64_t queuedTime,
+                           int64_t poppedTime, int64_t submitTime) {
+    // Oldest entry is replaced: its frame was dropped by the decoder
+    FrameTrace& trace = pending_[cursor_];
+    used_[cursor_] = true;
+    cursor_ = (cursor_ + 1) % kPending;
+
+    trace = FrameTrace{};
+    trace.pts = pts;
+    trace.at(TraceStamp::RECEIVE) = receiveTime;
+    trace.at(TraceStamp::QUEUE_PUSH) = queuedTime;
+    trace.at(TraceStamp::QUEUE_POP) = poppedTime;
+    trace.at(TraceStamp::DECODE_SUBMIT) = submitTime;
+}
+
+void FrameTracer::onDelivered(const std::string& cameraId, int64_t pts, int64_t outputTime, int64_t deliverTime) {
+    // Oldest pending submit with this pts (timestamps may repeat on broken streams)
+    size_t match = kPending;
+    for (size_t n = 0; n < kPending; ++n) {
+        const size_t i = (cursor_ + n) % kPending;
+        if (used_[i] && pending_[i].pts == pts) {
+            match = i;
+            break;
+        }
+    }
+
+    if (match == kPending) {
+        return;   // Not submitted through the traced path (GOP replay)
+    }
+
+    FrameTrace trace = pending_[match];
+    used_[match] = false;
+
+    trace.at(TraceStamp::DECODE_OUTPUT) = outputTime > 0 ? outputTime : deliverTime;
+    trace.at(TraceStamp::DELIVER) = deliverTime;
+
+    for (size_t i = 0; i < kIntervals.size(); ++i) {
+        const int64_t from = trace.at(kIntervals[i].first);
+        const int64_t to = trace.at(kIntervals[i].second);
+        if (from > 0 && to >= from) {
+            metrics_.recordStage(static_cast<LatencyStage>(i), to - from);
+        }
+    }
+
+    const int64_t received = trace.at(TraceStamp::RECEIVE);
+    if (received > 0 && deliverTime >= received) {
+        metrics_.recordStage(LatencyStage::TOTAL, deliverTime - received);
+    }
+
+    TraceBuffer::instance().record(cameraId, trace);
+}
+
+} // namespace metrics
+} // namespace fluxvision
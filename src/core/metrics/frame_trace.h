@@ -0,0 +1,114 @@
+// src/core/metrics/frame_trace.h
+// Per-frame pipeline timestamps: stage histograms and a Chrome trace / Perfetto ring buffer
+#pragma once
+
+#include "camera_metrics.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fluxvision {
+namespace metrics {
+
+// Points an access unit passes through, in order
+enum class TraceStamp : uint8_t {
+    RECEIVE,        // Read from the socket / demuxer
+    QUEUE_PUSH,     // Queued for decoding (network thread)
+    QUEUE_POP,      // Taken by the decode worker
+    DECODE_SUBMIT,  // Handed to the decoder
+    DECODE_OUTPUT,  // Decoder output it (NVDEC display callback, avcodec_receive_frame)
+    DELIVER         // Offered to every subscriber
+};
+constexpr size_t kTraceStampCount = 6;
+
+// Steady-clock microseconds, the clock every stamp uses
+int64_t traceNow();
+
+// Stamps of one frame (0 = not reached)
+struct FrameTrace {
+    int64_t pts = 0;
+    std::array<int64_t, kTraceStampCount> stamps{};
+
+    int64_t& at(TraceStamp stamp) { return stamps[static_cast<size_t>(stamp)]; }
+    int64_t at(TraceStamp stamp) const { return stamps[static_cast<size_t>(stamp)]; }
+};
+
+// Process-wide ring of completed frame traces
+//
+// Disabled by default (per-stage histograms are always kept). record() is
+// wait-free: writers claim slots with one fetch_add and publish them under a
+// per-slot seqlock, so dumps run concurrently and skip slots being rewritten.
+// The oldest traces are overwritten.
+//
+// Thread-safety: all methods may be called from any thread
+class TraceBuffer {
+public:
+    static constexpr size_t kCapacity = 16384;   // ~2 MB; at 400 cameras x 15 fps, the last ~3 s
+    static constexpr size_t kCameraIdLength = 48;
+
+    struct Record {
+        char cameraId[kCameraIdLength];
+        FrameTrace trace;
+    };
+
+    static TraceBuffer& instance();
+
+    void setEnabled(bool enabled) { enabled_.store(enabled, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled_.load(std::memory_order_relaxed); }
+
+    void record(const std::string& cameraId, const FrameTrace& trace);
+
+    // Consistent copy of the stored traces, oldest first
+    std::vector<Record> snapshot() const;
+
+    // Chrome trace event JSON (chrome://tracing, ui.perfetto.dev): one track
+    // per camera, one complete event per stage interval of every frame
+    std::string toChromeTrace() const;
+    bool writeChromeTrace(const std::string& path) const;
+
+    void clear();
+
+private:
+    TraceBuffer();
+
+    struct Slot {
+        std::atomic<uint64_t> sequence{0};   // Odd while being written
+        Record record;
+    };
+
+    std::atomic<bool> enabled_{false};
+    std::atomic<uint64_t> next_{0};
+    std::unique_ptr<Slot[]> slots_;
+};
+
+// Joins one camera's stamps from the network side, the decoder input and
+// the decoder output
+//
+// The network thread stamps RECEIVE/QUEUE_PUSH on the packet; the decode
+// worker reports submit with those and the packet's pts, and the delivered
+// frame with the pts the decoder carried through. Matching is by pts, so
+// reordered (B-frame) output is attributed correctly; frames the decoder
+// drops simply age out of the small pending table.
+//
+// Thread-safety: Not thread-safe (the camera's decode worker)
+class FrameTracer {
+public:
+    explicit FrameTracer(CameraMetrics& metrics) : metrics_(metrics) {}
+
+    void onSubmit(int64_t pts, int64_t receiveTime, int64_t queuedTime, int64_t poppedTime, int64_t submitTime);
+    void onDelivered(const std::string& cameraId, int64_t pts, int64_t outputTime, int64_t deliverTime);
+
+private:
+    static constexpr size_t kPending = 32;   // Beyond any decoder's reorder depth
+
+    CameraMetrics& metrics_;
+    std::array<FrameTrace, kPending> pending_{};
+    std::array<bool, kPending> used_{};
+    size_t cursor_ = 0;
+};
+
+} // namespace metrics
+} // namespace fluxvision
@@ -0,0 +1,252 @@
+// src/core/metrics/metrics_server.cpp
+#include "metrics_server.h"
+#include "openmetrics.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fluxvision {
+namespace metrics {
+
+namespace {
+    constexpr size_t kMaxRequestBytes = 8192;
+    constexpr int kAcceptPollMs = 250;      // stop() latency
+    constexpr int kClientTimeoutMs = 2000;  // Slow or idle scrapers
+
+    void closeSocket(intptr_t socket) {
+#ifdef _WIN32
+        closesocket(static_cast<SOCKET>(socket));
+#else
+        ::close(static_cast<int>(socket));
+#endif
+    }
+
+    void setTimeouts(intptr_t socket) {
+#ifdef _WIN32
+        DWORD timeout = kClientTimeoutMs;
+        setsockopt(static_cast<SOCKET>(socket), SOL_SOCKET, SO_RCVTIMEO,
+                   reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+        setsockopt(static_cast<SOCKET>(socket), SOL_SOCKET, SO_SNDTIMEO,
+                   reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+#else
+        timeval timeout = {};
+        timeout.tv_sec = kClientTimeoutMs / 1000;
+        timeout.tv_usec = (kClientTimeoutMs % 1000) * 1000;
+        setsockopt(static_cast<int>(socket), SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+        setsockopt(static_cast<int>(socket), SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+#endif
+    }
+
+    bool sendAll(intptr_t socket, const std::string& data) {
+        size_t sent = 0;
+        while (sent < data.size()) {
+#ifdef _WIN32
+            const int n = ::send(static_cast<SOCKET>(socket), data.data() + sent,
+                                 static_cast<int>(data.size() - sent), 0);
+#else
+            const ssize_t n = ::send(static_cast<int>(socket), data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+#endif
+            if (n <= 0) {
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    std::string response(const char* status, const char* contentType, const std::string& body) {
+        std::string out = "HTTP/1.1 ";
+        out += status;
+        out += "\r\nContent-Type: ";
+        out += contentType;
+        out += "\r\nContent-Length: ";
+        out += std::to_string(body.size());
+        out += "\r\nConnection: close\r\n\r\n";
+        out += body;
+        return out;
+    }
+}
+
+MetricsServer::MetricsServer(const Config& config, RenderCallback render)
+    : config_(config)
+    , render_(std::move(render))
+{
+}
+
+MetricsServer::~MetricsServer() {
+    stop();
+}
+
+bool MetricsServer::start() {
+    if (running_ || !render_) {
+        return running_;
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "MetricsServer: WSAStartup failed" << std::endl;
+        return false;
+    }
+    SOCKET fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd == INVALID_SOCKET) {
+        std::cerr << "MetricsServer: socket() failed: " << WSAGetLastError() << std::endl;
+        WSACleanup();
+        return false;
+    }
+#else
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "MetricsServer: socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+#endif
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(config_.port);
+    if (inet_pton(AF_INET, config_.bindAddress.c_str(), &address.sin_addr) != 1) {
+        std::cerr << "MetricsServer: invalid bind address " << config_.bindAddress << std::endl;
+        closeSocket(static_cast<intptr_t>(fd));
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    if (::bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+        ::listen(fd, 16) != 0) {
+        std::cerr << "MetricsServer: cannot listen on " << config_.bindAddress << ":" << config_.port << std::endl;
+        closeSocket(static_cast<intptr_t>(fd));
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+    listenSocket_ = static_cast<intptr_t>(fd);
+    running_ = true;
+    thread_ = std::thread([this]() { serveLoop(); });
+
+    std::cout << "MetricsServer: serving http://" << config_.bindAddress << ":" << config_.port
+              << config_.path << std::endl;
+    return true;
+}
+
+void MetricsServer::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    closeSocket(listenSocket_);
+    listenSocket_ = -1;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+void MetricsServer::serveLoop() {
+    while (running_) {
+        // Wait for a connection with a timeout, so stop() is noticed
+        fd_set readable;
+        FD_ZERO(&readable);
+#ifdef _WIN32
+        FD_SET(static_cast<SOCKET>(listenSocket_), &readable);
+#else
+        FD_SET(static_cast<int>(listenSocket_), &readable);
+#endif
+        timeval timeout = {};
+        timeout.tv_usec = kAcceptPollMs * 1000;
+
+        const int ready = ::select(static_cast<int>(listenSocket_) + 1, &readable, nullptr, nullptr, &timeout);
+        if (ready <= 0) {
+            continue;
+        }
+
+#ifdef _WIN32
+        SOCKET client = ::accept(static_cast<SOCKET>(listenSocket_), nullptr, nullptr);
+        if (client == INVALID_SOCKET) {
+            continue;
+        }
+#else
+        int client = ::accept4(static_cast<int>(listenSocket_), nullptr, nullptr, SOCK_CLOEXEC);
+        if (client < 0) {
+            continue;
+        }
+#endif
+
+        handleConnection(static_cast<intptr_t>(client));
+        closeSocket(static_cast<intptr_t>(client));
+    }
+}
+
+void MetricsServer::handleConnection(intptr_t socket) {
+    setTimeouts(socket);
+
+    // The request line is all we need; read until the end of the headers
+    std::string request;
+    char buffer[1024];
+    while (request.size() < kMaxRequestBytes && request.find("\r\n\r\n") == std::string::npos) {
+#ifdef _WIN32
+        const int n = ::recv(static_cast<SOCKET>(socket), buffer, sizeof(buffer), 0);
+#else
+        const ssize_t n = ::recv(static_cast<int>(socket), buffer, sizeof(buffer), 0);
+#endif
+        if (n <= 0) {
+            break;
+        }
+        request.append(buffer, static_cast<size_t>(n));
+    }
+
+    const size_t lineEnd = request.find("\r\n");
+    if (lineEnd == std::string::npos) {
+        return;
+    }
+
+    // "GET /metrics?query HTTP/1.1"
+    const std::string line = request.substr(0, lineEnd);
+    const size_t methodEnd = line.find(' ');
+    const size_t targetEnd = methodEnd == std::string::npos ? std::string::npos : line.find(' ', methodEnd + 1);
+    if (targetEnd == std::string::npos) {
+        sendAll(socket, response("400 Bad Request", "text/plain", "bad request\n"));
+        return;
+    }
+
+    const std::string method = line.substr(0, methodEnd);
+    std::string target = line.substr(methodEnd + 1, targetEnd - methodEnd - 1);
+    target = target.substr(0, target.find('?'));
+
+    if (method != "GET") {
+        sendAll(socket, response("405 Method Not Allowed", "text/plain", "GET only\n"));
+        return;
+    }
+    if (target != config_.path) {
+        sendAll(socket, response("404 Not Found", "text/plain", "not found\n"));
+        return;
+    }
+
+    scrapes_++;
+    sendAll(socket, response("200 OK", kOpenMetricsContentType, render_()));
+}
+
+} // namespace metrics
+} // namespace fluxvision
@@ -0,0 +1,59 @@
+// src/core/metrics/metrics_server.h
+// Minimal HTTP endpoint serving a metrics document to Prometheus scrapers
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+
+namespace fluxvision {
+namespace metrics {
+
+// Scrape endpoint (GET /metrics)
+//
+// One thread accepts and answers requests one at a time: scrapers poll every
+// few seconds, and rendering only reads counters, so nothing here ever waits
+// on the streaming threads. Each response is rendered fresh by the callback
+// (typically StreamManager::collectMetrics() + renderOpenMetrics()).
+//
+// Thread-safety: start()/stop() from one thread; render is called on the
+// server thread
+class MetricsServer {
+public:
+    struct Config {
+        std::string bindAddress = "0.0.0.0";
+        uint16_t port = 9464;               // Registered Prometheus exporter port range
+        std::string path = "/metrics";
+    };
+
+    using RenderCallback = std::function<std::string()>;
+
+    MetricsServer(const Config& config, RenderCallback render);
+    ~MetricsServer();
+
+    // Delete copy/move
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    bool start();
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    uint64_t getScrapeCount() const { return scrapes_.load(); }
+
+private:
+    Config config_;
+    RenderCallback render_;
+    intptr_t listenSocket_ = -1;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::atomic<uint64_t> scrapes_{0};
+
+    void serveLoop();
+    void handleConnection(intptr_t socket);
+};
+
+} // namespace metrics
+} // namespace fluxvision
@@ -0,0 +1,224 @@
+// src/core/metrics/openmetrics.cpp
+#include "openmetrics.h"
+#include <cstdio>
+
+namespace fluxvision {
+namespace metrics {
+
+namespace {
+    // Label values escape backslash, double quote and newline
+    void appendEscaped(std::string& out, const std::string& value) {
+        for (char c : value) {
+            switch (c) {
+                case '\\': out += "\\\\"; break;
+                case '"': out += "\\\""; break;
+                case '\n': out += "\\n"; break;
+                default: out += c; break;
+            }
+        }
+    }
+
+    void appendFamily(std::string& out, const char* name, const char* type, const char* help) {
+        out += "# TYPE ";
+        out += name;
+        out += ' ';
+        out += type;
+        out += "\n# HELP ";
+        out += name;
+        out += ' ';
+        out += help;
+        out += '\n';
+    }
+
+    void appendLabels(std::string& out, const CameraSample& camera, const char* extraName = nullptr,
+                      const std::string& extraValue = std::string()) {
+        out += "{camera=\"";
+        appendEscaped(out, camera.cameraId);
+        out += '"';
+        if (extraName) {
+            out += ',';
+            out += extraName;
+            out += "=\"";
+            appendEscaped(out, extraValue);
+            out += '"';
+        }
+        out += '}';
+    }
+
+    void appendValue(std::string& out, uint64_t value) {
+        out += ' ';
+        out += std::to_string(value);
+        out += '\n';
+    }
+
+    void appendValue(std::string& out, double value) {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), " %.6f\n", value);
+        out += buffer;
+    }
+
+    void appendHistogramLabels(std::string& out, const CameraSample& camera, const char* extraName,
+                               const char* extraValue, const char* bound) {
+        out += "{camera=\"";
+        appendEscaped(out, camera.cameraId);
+        out += '"';
+        if (extraName) {
+            out += ',';
+            out += extraName;
+            out += "=\"";
+            out += extraValue;
+            out += '"';
+        }
+        if (bound) {
+            out += ",le=\"";
+            out += bound;
+            out += '"';
+        }
+        out += '}';
+    }
+
+    // _bucket (cumulative), _count and _sum of one histogram series
+    void appendHistogram(std::string& out, const char* family, const CameraSample& camera,
+                         const char* extraName, const char* extraValue,
+                         const LatencyHistogram::Snapshot& latency) {
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < kLatencyBucketCount; ++i) {
+            cumulative += latency.buckets[i];
+
+            char bound[32];
+            if (i < kLatencyBucketsUs.size()) {
+                std::snprintf(bound, sizeof(bound), "%g", kLatencyBucketsUs[i] / 1e6);
+            } else {
+                std::snprintf(bound, sizeof(bound), "+Inf");
+            }
+
+            out += family;
+            out += "_bucket";
+            appendHistogramLabels(out, camera, extraName, extraValue, bound);
+            appendValue(out, cumulative);
+        }
+
+        // Buckets and sum are read separately: keep count consistent with the buckets
+        out += family;
+        out += "_count";
+        appendHistogramLabels(out, camera, extraName, extraValue, nullptr);
+        appendValue(out, cumulative);
+        out += family;
+        out += "_sum";
+        appendHistogramLabels(out, camera, extraName, extraValue, nullptr);
+        appendValue(out, latency.sumUs / 1e6);
+    }
+
+    // One sample per camera: name{camera="..."} value
+    template <typename Getter>
+    void appendPerCamera(std::string& out, const std::vector<CameraSample>& cameras,
+                         const char* family, const char* suffix, const char* type, const char* help,
+                         Getter getter) {
+        appendFamily(out, family, type, help);
+        for (const CameraSample& camera : cameras) {
+            out += family;
+            out += suffix;
+            appendLabels(out, camera);
+            appendValue(out, static_cast<uint64_t>(getter(camera)));
+        }
+    }
+}
+
+std::string renderOpenMetrics(const std::vector<CameraSample>& cameras) {
+    std::string out;
+    out.reserve(512 + cameras.size() * 3072);
+
+    // Identity of each camera: state, tier, decoder, device as labels of a constant 1
+    appendFamily(out, "fluxvision_camera", "info", "Camera stream state, quality tier and decoder placement");
+    for (const CameraSample& camera : cameras) {
+        out += "fluxvision_camera_info{camera=\"";
+        appendEscaped(out, camera.cameraId);
+        out += "\",state=\"";
+        appendEscaped(out, camera.state);
+        out += "\",quality=\"";
+        appendEscaped(out, camera.quality);
+        out += "\",decoder=\"";
+        appendEscaped(out, camera.decoder);
+        out += "\",device=\"";
+        out += std::to_string(camera.cudaDevice);
+        out += "\"} 1\n";
+    }
+
+    appendPerCamera(out, cameras, "fluxvision_camera_idle_gated", "", "gauge",
+                    "1 while no activity is seen and only keyframes are decoded",
+                    [](const CameraSample& c) { return c.idleGated ? 1 : 0; });
+    appendPerCamera(out, cameras, "fluxvision_camera_governed", "", "gauge",
+                    "1 while the quality governor holds the camera below its requested tier",
+                    [](const CameraSample& c) { return c.governed ? 1 : 0; });
+
+    // Ingest
+    appendPerCamera(out, cameras, "fluxvision_camera_ingest_packets", "_total", "counter",
+                    "Access units received", [](const CameraSample& c) { return c.packets; });
+    appendPerCamera(out, cameras, "fluxvision_camera_ingest_bytes", "_total", "counter",
+                    "Access unit bytes received (rate() gives the ingest bitrate)",
+                    [](const CameraSample& c) { return c.bytes; });
+    appendPerCamera(out, cameras, "fluxvision_camera_ingest_keyframes", "_total", "counter",
+                    "Keyframes received", [](const CameraSample& c) { return c.keyframes; });
+
+    // Packet queue
+    appendPerCamera(out, cameras, "fluxvision_camera_queue_depth", "", "gauge",
+                    "Access units waiting for the decoder", [](const CameraSample& c) { return c.queueDepth; });
+    appendPerCamera(out, cameras, "fluxvision_camera_queue_capacity", "", "gauge",
+                    "Packet queue capacity", [](const CameraSample& c) { return c.queueCapacity; });
+
+    // Drops, one series per reason
+    appendFamily(out, "fluxvision_camera_dropped_packets", "counter", "Access units not decoded, by reason");
+    for (const CameraSample& camera : cameras) {
+        const std::pair<const char*, uint64_t> reasons[] = {
+            {"non_reference", camera.droppedNonReference},
+            {"gop", camera.droppedGop},
+            {"queue_full", camera.droppedFull},
+            {"stale", camera.discardedStale},
+            {"decimated", camera.decimated},
+        };
+        for (const auto& [reason, count] : reasons) {
+            out += "fluxvision_camera_dropped_packets_total";
+            appendLabels(out, camera, "reason", reason);
+            appendValue(out, count);
+        }
+    }
+
+    // Decode
+    appendPerCamera(out, cameras, "fluxvision_camera_decoded_frames", "_total", "counter",
+                    "Frames delivered by the decoder", [](const CameraSample& c) { return c.framesDecoded; });
+    appendPerCamera(out, cameras, "fluxvision_camera_decode_errors", "_total", "counter",
+                    "Access units the decoder rejected", [](const CameraSample& c) { return c.decodeErrors; });
+    appendPerCamera(out, cameras, "fluxvision_camera_fps", "", "gauge",
+                    "Decoded frames over the last second", [](const CameraSample& c) { return c.fps; });
+
+    appendFamily(out, "fluxvision_camera_decode_seconds", "histogram",
+                 "Decoder time per access unit");
+    for (const CameraSample& camera : cameras) {
+        appendHistogram(out, "fluxvision_camera_decode_seconds", camera, nullptr, nullptr, camera.decodeLatency);
+    }
+
+    // Where an access unit's glass-to-glass time goes (traced frames)
+    appendFamily(out, "fluxvision_camera_stage_seconds", "histogram",
+                 "Time per access unit in each pipeline stage (total: socket read to subscriber delivery)");
+    for (const CameraSample& camera : cameras) {
+        for (size_t i = 0; i < kLatencyStageCount; ++i) {
+            appendHistogram(out, "fluxvision_camera_stage_seconds", camera, "stage",
+                            latencyStageName(static_cast<LatencyStage>(i)), camera.stageLatency[i]);
+        }
+    }
+
+    // Decoder surfaces
+    appendPerCamera(out, cameras, "fluxvision_camera_surfaces", "", "gauge",
+                    "Decoder output surfaces allocated", [](const CameraSample& c) { return c.surfacesAllocated; });
+    appendPerCamera(out, cameras, "fluxvision_camera_surface_capacity", "", "gauge",
+                    "Decoder output surfaces allowed at the current quality",
+                    [](const CameraSample& c) { return c.surfaceCapacity; });
+    appendPerCamera(out, cameras, "fluxvision_camera_gpu_bytes", "", "gauge",
+                    "VRAM held by the decoder's surfaces", [](const CameraSample& c) { return c.gpuBytes; });
+
+    out += "# EOF\n";
+    return out;
+}
+
+} // namespace metrics
+} // namespace fluxvision
@@ -0,0 +1,19 @@
+// src/core/metrics/openmetrics.h
+// OpenMetrics (Prometheus) text exposition of camera samples
+#pragma once
+
+#include "camera_metrics.h"
+#include <string>
+#include <vector>
+
+namespace fluxvision {
+namespace metrics {
+
+// Content-Type of renderOpenMetrics() output
+constexpr const char* kOpenMetricsContentType = "application/openmetrics-text; version=1.0.0; charset=utf-8";
+
+// Every camera's metrics as one OpenMetrics text document (ends with "# EOF")
+std::string renderOpenMetrics(const std::vector<CameraSample>& cameras);
+
+} // namespace metrics
+} // namespace fluxvision
@@ -0,0 +1,170 @@
+#include "access_unit_assembler.h"
+#include "h264_parser.h"
+#include "hevc_parser.h"
+#include <cstring>
+
+namespace fluxvision {
+namespace network {
+
+void AccessUnitAssembler::push(NalUnit&& nal) {
+    if (nal.data.empty()) {
+        return;
+    }
+
+    if (startsNewAccessUnit(nal)) {
+        completePending();
+    }
+
+    if (pending_.nalCount == 0) {
+        pending_.pts = nal.pts;
+        pending_.dts = nal.dts;
+        pending_.receiveTime = nal.receiveTime;
+    }
+
+    if (isSlice(nal.type)) {
+        if (!pendingHasSlice_) {
+            // Picture timestamp comes from its first slice
+            pending_.pts = nal.pts;
+            pending_.dts = nal.dts;
+        }
+        pendingHasSlice_ = true;
+
+        // Non-reference pictures (nal_ref_idc == 0, H.265 *_N types) can be dropped
+        // without breaking decode
+        if (codec_ == CodecType::H265 ? HevcParser::isReference(nal.type)
+                                      : H264Parser::parseNalHeader(nal.data.data(), nal.data.size()).refIdc != 0) {
+            pending_.isReference = true;
+        }
+    }
+
+    if (codec_ == CodecType::H265 ? HevcParser::isIrap(nal.type) : nal.type == NalUnitType::IDR) {
+        pending_.isKeyframe = true;
+    }
+
+    // Concatenated as Annex B on completion (NAL data already carries its start code)
+    pendingBytes_ += nal.data.size();
+    pendingNals_.push_back(std::move(nal.data));
+    pending_.nalCount++;
+}
+
+void AccessUnitAssembler::endOfPacket() {
+    if (pendingHasSlice_) {
+        completePending();
+    }
+}
+
+void AccessUnitAssembler::flush() {
+    completePending();
+}
+
+bool AccessUnitAssembler::pop(AccessUnit& au) {
+    if (completed_.empty()) {
+        return false;
+    }
+
+    au = std::move(completed_.front());
+    completed_.pop_front();
+    return true;
+}
+
+void AccessUnitAssembler::reset() {
+    completed_.clear();
+    pending_ = AccessUnit{};
+    pendingNals_.clear();
+    pendingBytes_ = 0;
+    pendingHasSlice_ = false;
+}
+
+bool AccessUnitAssembler::startsNewAccessUnit(const NalUnit& nal) const {
+    if (!pendingHasSlice_) {
+        return false;  // Still collecting the prefix of the current picture
+    }
+
+    if (codec_ == CodecType::H265) {
+        // Suffix SEI and slices of the same picture stay; VPS/SPS/PPS/AUD/EOS/prefix SEI split
+        if (!HevcParser::isSlice(nal.type)) {
+            return HevcParser::isParameterSet(nal.type) || nal.type == NalUnitType::HEVC_AUD ||
+                   nal.type == NalUnitType::HEVC_EOS || nal.type == NalUnitType::HEVC_PREFIX_SEI;
+        }
+        if (nal.pts != pending_.pts) {
+            return true;
+        }
+
+        size_t nalSize = 0;
+        const uint8_t* header = H264Parser::skipStartCode(nal.data.data(), nal.data.size(), nalSize);
+        return header && HevcParser::isFirstSliceInPicture(header, nalSize);
+    }
+
+    switch (nal.type) {
+        case NalUnitType::AUD:
+        case NalUnitType::SPS:
+        case NalUnitType::PPS:
+        case NalUnitType::SEI:
+        case NalUnitType::END_SEQUENCE:
+            return true;
+        default:
+            break;
+    }
+
+    if (!isSlice(nal.type)) {
+        return false;
+    }
+
+    if (nal.pts != pending_.pts) {
+        return true;
+    }
+
+    // first_mb_in_slice is ue(v): a leading '1' bit means 0 (first slice of a picture)
+    size_t nalSize = 0;
+    const uint8_t* header = H264Parser::skipStartCode(nal.data.data(), nal.data.size(), nalSize);
+    if (header && nalSize > 1) {
+        return (header[1] & 0x80) != 0;
+    }
+
+    return false;
+}
+
+void AccessUnitAssembler::completePending() {
+    if (pending_.nalCount == 0) {
+        return;
+    }
+
+    // Zero-copy when all NAL units are adjacent in the same packet buffer
+    PacketBuffer merged = pendingNals_.front();
+    for (size_t i = 1; i < pendingNals_.size(); ++i) {
+        if (!merged.extendWith(pendingNals_[i])) {
+            merged.reset();
+            break;
+        }
+    }
+
+    if (merged.empty()) {
+        merged = PacketBuffer::allocate(pendingBytes_);
+        uint8_t* out = merged.mutableData();
+        if (out) {
+            for (const auto& nal : pendingNals_) {
+                std::memcpy(out, nal.data(), nal.size());
+                out += nal.size();
+            }
+        }
+    }
+
+    pending_.data = std::move(merged);
+    completed_.push_back(std::move(pending_));
+
+    pending_ = AccessUnit{};
+    pendingNals_.clear();  // Keeps capacity: no allocation per access unit
+    pendingBytes_ = 0;
+    pendingHasSlice_ = false;
+}
+
+bool AccessUnitAssembler::isSlice(NalUnitType type) const {
+    if (codec_ == CodecType::H265) {
+        return HevcParser::isSlice(type);
+    }
+    return type == NalUnitType::SLICE || type == NalUnitType::IDR ||
+           type == NalUnitType::DPA;
+}
+
+} // namespace network
+} // namespace fluxvision
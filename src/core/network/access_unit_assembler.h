@@ -0,0 +1,98 @@
+#pragma once
+
+#include "types.h"
+#include <deque>
+#include <vector>
+
+namespace fluxvision {
+namespace network {
+
+/**
+ * H.264/H.265 Access Unit Assembler
+ *
+ * Groups the NAL units produced by BitstreamParser into access units (one
+ * picture each: AUD/SPS/PPS/SEI prefix + all slices) so decoders are called
+ * once per frame instead of once per NAL unit.
+ *
+ * Boundary detection (H.264 7.4.1.2.3, H.265 7.4.2.4.4), applied when the
+ * next NAL arrives:
+ * - AUD, parameter set, (prefix) SEI or end-of-sequence after a slice starts a new AU
+ * - a slice with first_mb_in_slice == 0 (H.265: first_slice_segment_in_pic_flag)
+ *   after a slice starts a new AU
+ * - a timestamp change after a slice starts a new AU
+ *
+ * endOfPacket() closes the pending AU early when the transport delivers whole
+ * pictures per packet (FFmpeg's RTSP demuxer runs the H.264 parser), so no
+ * extra frame of latency is added waiting for the next picture.
+ *
+ * NAL units that are adjacent in one packet buffer (the common case) become a
+ * single slice of that buffer; only AUs spanning packets are copied.
+ *
+ * Thread-safety: Not thread-safe (one instance per stream, single producer)
+ */
+class AccessUnitAssembler {
+public:
+    explicit AccessUnitAssembler(CodecType codec = CodecType::H264) : codec_(codec) {}
+    ~AccessUnitAssembler() = default;
+
+    /**
+     * Codec of the following NAL units (call reset() first when it changes mid-stream)
+     */
+    void setCodec(CodecType codec) { codec_ = codec; }
+
+    /**
+     * Add next NAL unit in decode order
+     */
+    void push(NalUnit&& nal);
+
+    /**
+     * Mark the end of a transport packet
+     * Completes the pending AU if it already holds at least one slice
+     */
+    void endOfPacket();
+
+    /**
+     * Complete the pending AU unconditionally (end of stream / reconnect)
+     */
+    void flush();
+
+    /**
+     * Get next completed access unit
+     */
+    bool pop(AccessUnit& au);
+
+    /**
+     * Check if completed access units are available
+     */
+    bool hasAccessUnits() const { return !completed_.empty(); }
+
+    /**
+     * Drop pending and completed access units
+     */
+    void reset();
+
+private:
+    CodecType codec_;
+    std::deque<AccessUnit> completed_;
+
+    // Pending access unit: metadata plus NAL slices (merged or copied on completion)
+    AccessUnit pending_;
+    std::vector<PacketBuffer> pendingNals_;
+    size_t pendingBytes_ = 0;
+    bool pendingHasSlice_ = false;
+
+    /**
+     * Check if nal starts a new access unit given the pending one
+     */
+    bool startsNewAccessUnit(const NalUnit& nal) const;
+
+    /**
+     * Move the pending AU to the completed list
+     */
+    void completePending();
+
+    bool isSlice(NalUnitType type) const;
+};
+
+} // namespace network
+} // namespace fluxvision
@@ -1,6 +1,7 @@
 #include "bitstream_parser.h"
 #include "h264_parser.h"
-#include <cstring>
+#include "hevc_parser.h"
+#include "start_code_scanner.h"
 
 namespace fluxvision {
 namespace network {
@@ -10,8 +11,21 @@ int BitstreamParser::parsePacket(const uint8_t* data, size_t size, int64_t times
         return 0;
     }
 
+    // One copy for the whole packet, NAL units are slices of it
+    return parsePacket(PacketBuffer::copyOf(data, size), timestamp);
+}
+
+int BitstreamParser::parsePacket(const PacketBuffer& packet, int64_t timestamp) {
+    const uint8_t* data = packet.data();
+    size_t size = packet.size();
+
+    if (!data || size == 0) {
+        return 0;
+    }
+
     // Find all NAL start codes in the bitstream
-    std::vector<size_t> startCodes = findStartCodes(data, size);
+    StartCodeScanner::findAll(data, size, startCodes_);
+    const std::vector<size_t>& startCodes = startCodes_;
 
     if (startCodes.empty()) {
         // No start codes found - might be single NAL without start code
@@ -27,12 +41,10 @@ int BitstreamParser::parsePacket(const uint8_t* data, size_t size, int64_t times
         size_t nalEnd = (i + 1 < startCodes.size()) ? startCodes[i + 1] : size;
         size_t nalSize = nalEnd - nalStart;
 
-        if (nalSize > 0) {
-            NalUnit nal = extractNalUnit(data + nalStart, nalSize, timestamp);
-            if (nal.type != NalUnitType::UNSPECIFIED) {
-                nalUnits_.push(std::move(nal));
-                nalCount++;
-            }
+        NalUnit nal;
+        if (nalSize > 0 && extractNalUnit(packet.slice(nalStart, nalSize), timestamp, nal)) {
+            nalUnits_.push(std::move(nal));
+            nalCount++;
         }
     }
 
@@ -59,64 +71,56 @@ void BitstreamParser::reset() {
     }
 }
 
-std::vector<size_t> BitstreamParser::findStartCodes(const uint8_t* data, size_t size) {
-    std::vector<size_t> positions;
-
-    if (size < 3) {
-        return positions;
-    }
-
-    for (size_t i = 0; i < size - 2; i++) {
-        // Check for 3-byte start code: 0x000001
-        if (data[i] == 0x00 && data[i + 1] == 0x00 && data[i + 2] == 0x01) {
-            positions.push_back(i);
-            i += 2;  // Skip past this start code
-        }
-        // Check for 4-byte start code: 0x00000001
-        else if (i < size - 3 &&
-                 data[i] == 0x00 && data[i + 1] == 0x00 &&
-                 data[i + 2] == 0x00 && data[i + 3] == 0x01) {
-            positions.push_back(i);
-            i += 3;  // Skip past this start code
-        }
-    }
-
-    return positions;
-}
-
-NalUnit BitstreamParser::extractNalUnit(const uint8_t* data, size_t size, int64_t timestamp) {
-    NalUnit nal;
+bool BitstreamParser::extractNalUnit(const PacketBuffer& nalData, int64_t timestamp, NalUnit& nal) const {
     nal.pts = timestamp;
     nal.dts = timestamp;
+    nal.codec = codec_;
 
-    if (!data || size == 0) {
-        return nal;
+    if (nalData.empty()) {
+        return false;
     }
 
-    // Copy the entire NAL unit including start code
-    nal.data.resize(size);
-    std::memcpy(nal.data.data(), data, size);
+    // Reference the entire NAL unit including start code (no copy)
+    nal.data = nalData;
+    const uint8_t* data = nalData.data();
+    size_t size = nalData.size();
 
     // Parse NAL header to get type
     size_t nalSize = 0;
     const uint8_t* nalHeader = H264Parser::skipStartCode(data, size, nalSize);
+    if (!nalHeader || nalSize == 0) {
+        return false;
+    }
+
+    SPSInfo sps;
+    if (codec_ == CodecType::H265) {
+        // nal_unit_type 0 (TRAIL_N) is a valid slice here
+        const HevcParser::NalInfo info = HevcParser::parseNalHeader(nalHeader, nalSize);
+        if (!info.valid) {
+            return false;
+        }
+        nal.type = info.type;
+        nal.isKeyframe = info.isKeyframe;
 
-    if (nalHeader && nalSize > 0) {
-        nal.type = H264Parser::getNalType(nalHeader, nalSize);
-        nal.isKeyframe = H264Parser::isKeyframe(nalHeader, nalSize);
-
-        // For SPS, extract resolution info
-        if (nal.type == NalUnitType::SPS) {
-            SPSInfo sps;
-            if (H264Parser::extractSPS(data, size, sps)) {
-                nal.width = sps.width;
-                nal.height = sps.height;
-                nal.framerate = sps.framerate;
-            }
+        if (nal.type == NalUnitType::HEVC_SPS && HevcParser::extractSPS(data, size, sps)) {
+            nal.width = sps.width;
+            nal.height = sps.height;
+            nal.framerate = sps.framerate;
         }
+        return true;
+    }
+
+    nal.type = H264Parser::getNalType(nalHeader, nalSize);
+    nal.isKeyframe = H264Parser::isKeyframe(nalHeader, nalSize);
+
+    // For SPS, extract resolution info
+    if (nal.type == NalUnitType::SPS && H264Parser::extractSPS(data, size, sps)) {
+        nal.width = sps.width;
+        nal.height = sps.height;
+        nal.framerate = sps.framerate;
     }
 
-    return nal;
+    return nal.type != NalUnitType::UNSPECIFIED;
 }
 
 } // namespace network
@@ -8,17 +8,23 @@ namespace fluxvision {
 namespace network {
 
 /**
- * H.264 Bitstream Parser
+ * H.264/H.265 Bitstream Parser
  *
- * Parses H.264 bitstream (from FFmpeg av_read_frame) into individual NAL units.
- * FFmpeg already handles RTSP/RTP depacketization, so we just need to split
- * the bitstream by NAL start codes.
+ * Parses an Annex B bitstream (from FFmpeg av_read_frame) into individual NAL
+ * units. FFmpeg already handles RTSP/RTP depacketization, so we just need to
+ * split the bitstream by NAL start codes. The NAL header is read per codec.
  */
 class BitstreamParser {
 public:
-    BitstreamParser() = default;
+    explicit BitstreamParser(CodecType codec = CodecType::H264) : codec_(codec) {}
     ~BitstreamParser() = default;
 
+    /**
+     * Codec of the following packets (H.264 one-byte or H.265 two-byte NAL headers)
+     */
+    void setCodec(CodecType codec) { codec_ = codec; }
+    CodecType getCodec() const { return codec_; }
+
     /**
      * Parse H.264 bitstream packet into NAL units
      * @param data Bitstream data (may contain multiple NAL units)
@@ -28,6 +34,13 @@ public:
      */
     int parsePacket(const uint8_t* data, size_t size, int64_t timestamp);
 
+    /**
+     * Parse refcounted packet into NAL units without copying
+     * Each NalUnit::data is a slice of packet
+     * @return Number of NAL units extracted
+     */
+    int parsePacket(const PacketBuffer& packet, int64_t timestamp);
+
     /**
      * Get next NAL unit
      */
@@ -44,18 +57,17 @@ public:
     void reset();
 
 private:
+    CodecType codec_;
     std::queue<NalUnit> nalUnits_;
 
-    /**
-     * Find NAL start code positions in bitstream
-     * @return Vector of start code positions
-     */
-    std::vector<size_t> findStartCodes(const uint8_t* data, size_t size);
+    // Start code positions of the current packet (reused across packets)
+    std::vector<size_t> startCodes_;
 
     /**
      * Extract single NAL unit and determine type
+     * Returns: false if the NAL header is invalid
      */
-    NalUnit extractNalUnit(const uint8_t* data, size_t size, int64_t timestamp);
+    bool extractNalUnit(const PacketBuffer& nalData, int64_t timestamp, NalUnit& nal) const;
 };
 
 } // namespace network
@@ -1,4 +1,5 @@
 #include "h264_parser.h"
+#include "start_code_scanner.h"
 #include <cstring>
 #include <iostream>
 
@@ -302,24 +303,15 @@ NalUnitType H264Parser::getNalType(const uint8_t* data, size_t size) {
 }
 
 bool H264Parser::hasStartCode(const uint8_t* data, size_t size) {
-    if (size >= 4 && data[0] == 0x00 && data[1] == 0x00) {
-        return (data[2] == 0x00 && data[3] == 0x01) ||  // 4-byte start code
-               (data[2] == 0x01);                        // 3-byte start code
-    }
-    return false;
+    return data && StartCodeScanner::prefixLength(data, size) != 0;
 }
 
 const uint8_t* H264Parser::skipStartCode(const uint8_t* data, size_t size, size_t& nalSize) {
-    if (size >= 4 && data[0] == 0x00 && data[1] == 0x00 &&
-        data[2] == 0x00 && data[3] == 0x01) {
-        // 4-byte start code
-        nalSize = size - 4;
-        return data + 4;
-    }
-    else if (size >= 3 && data[0] == 0x00 && data[1] == 0x00 && data[2] == 0x01) {
-        // 3-byte start code
-        nalSize = size - 3;
-        return data + 3;
+    // 4-byte or 3-byte start code
+    size_t length = data ? StartCodeScanner::prefixLength(data, size) : 0;
+    if (length != 0) {
+        nalSize = size - length;
+        return data + length;
     }
 
     nalSize = 0;
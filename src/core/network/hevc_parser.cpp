@@ -0,0 +1,196 @@
+#include "hevc_parser.h"
+#include "h264_parser.h"
+#include <algorithm>
+#include <vector>
+
+namespace fluxvision {
+namespace network {
+
+namespace {
+    // Enough RBSP for the SPS fields read here (profile_tier_level is at most ~100 bytes)
+    constexpr size_t kMaxSpsPrefix = 256;
+
+    // MSB-first reader over an RBSP (emulation prevention bytes removed); reads past the end give 0
+    class RbspReader {
+    public:
+        RbspReader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+        uint32_t readBits(int numBits) {
+            uint32_t result = 0;
+            for (int i = 0; i < numBits; i++) {
+                uint32_t bit = 0;
+                if (bitPos_ < size_ * 8) {
+                    bit = (data_[bitPos_ / 8] >> (7 - bitPos_ % 8)) & 1;
+                }
+                result = (result << 1) | bit;
+                bitPos_++;
+            }
+            return result;
+        }
+
+        void skipBits(size_t numBits) { bitPos_ += numBits; }
+
+        uint32_t readUE() {
+            int leadingZeros = 0;
+            while (!exhausted() && readBits(1) == 0) {
+                if (++leadingZeros > 31) {
+                    return 0;  // Invalid code
+                }
+            }
+            if (leadingZeros == 0) {
+                return 0;
+            }
+            return (1u << leadingZeros) - 1 + readBits(leadingZeros);
+        }
+
+        bool exhausted() const { return bitPos_ >= size_ * 8; }
+
+    private:
+        const uint8_t* data_;
+        size_t size_;
+        size_t bitPos_ = 0;
+    };
+
+    // NAL payload to RBSP: drops the 0x03 of every 0x000003 sequence
+    void unescape(const uint8_t* data, size_t size, std::vector<uint8_t>& rbsp) {
+        rbsp.clear();
+        rbsp.reserve(size);
+
+        int zeros = 0;
+        for (size_t i = 0; i < size; i++) {
+            if (zeros >= 2 && data[i] == 0x03) {
+                zeros = 0;
+                continue;
+            }
+            zeros = data[i] == 0 ? zeros + 1 : 0;
+            rbsp.push_back(data[i]);
+        }
+    }
+
+    const uint8_t* nalPayload(const uint8_t* data, size_t size, size_t& nalSize) {
+        const uint8_t* nalData = H264Parser::skipStartCode(data, size, nalSize);
+        if (!nalData) {
+            nalData = data;
+            nalSize = size;
+        }
+        return nalData;
+    }
+
+    void readProfileTierLevel(RbspReader& reader, int maxSubLayersMinus1, SPSInfo& sps) {
+        reader.readBits(2);                 // general_profile_space
+        reader.readBits(1);                 // general_tier_flag
+        sps.profile = reader.readBits(5);   // general_profile_idc
+        reader.skipBits(32);                // general_profile_compatibility_flag[32]
+        reader.skipBits(48);                // progressive/interlaced/non_packed/frame_only + constraint flags
+        sps.level = reader.readBits(8);     // general_level_idc (30 x level)
+
+        bool profilePresent[8] = {};
+        bool levelPresent[8] = {};
+        for (int i = 0; i < maxSubLayersMinus1; i++) {
+            profilePresent[i] = reader.readBits(1) != 0;
+            levelPresent[i] = reader.readBits(1) != 0;
+        }
+        if (maxSubLayersMinus1 > 0) {
+            reader.skipBits(2 * (8 - maxSubLayersMinus1));  // reserved_zero_2bits
+        }
+        for (int i = 0; i < maxSubLayersMinus1; i++) {
+            if (profilePresent[i]) {
+                reader.skipBits(88);        // sub_layer profile space .. constraint flags
+            }
+            if (levelPresent[i]) {
+                reader.skipBits(8);         // sub_layer_level_idc
+            }
+        }
+    }
+}
+
+HevcParser::NalInfo HevcParser::parseNalHeader(const uint8_t* data, size_t size) {
+    NalInfo info;
+
+    if (!data || size == 0) {
+        return info;
+    }
+
+    size_t nalSize = 0;
+    const uint8_t* nalData = nalPayload(data, size, nalSize);
+    if (nalSize < 2 || (nalData[0] & 0x80) != 0) {
+        return info;  // Truncated, or forbidden_zero_bit set
+    }
+
+    info.valid = true;
+    info.type = static_cast<NalUnitType>((nalData[0] >> 1) & 0x3F);
+    info.layerId = ((nalData[0] & 0x01) << 5) | (nalData[1] >> 3);
+    info.temporalId = (nalData[1] & 0x07) - 1;
+    info.isKeyframe = isIrap(info.type) || isParameterSet(info.type);
+    info.isReference = !isSlice(info.type) || isReference(info.type);
+
+    return info;
+}
+
+bool HevcParser::extractSPS(const uint8_t* data, size_t size, SPSInfo& sps) {
+    if (!data || size < 4) {
+        return false;
+    }
+
+    size_t nalSize = 0;
+    const uint8_t* nalData = nalPayload(data, size, nalSize);
+    if (nalSize < 3 || ((nalData[0] >> 1) & 0x3F) != static_cast<uint8_t>(NalUnitType::HEVC_SPS)) {
+        return false;
+    }
+
+    // SPS fields start after the two-byte NAL header; profile_tier_level is full of zero runs
+    std::vector<uint8_t> rbsp;
+    unescape(nalData + 2, std::min(nalSize - 2, kMaxSpsPrefix), rbsp);
+    RbspReader reader(rbsp.data(), rbsp.size());
+
+    reader.readBits(4);                               // sps_video_parameter_set_id
+    const int maxSubLayersMinus1 = static_cast<int>(reader.readBits(3));
+    reader.readBits(1);                               // sps_temporal_id_nesting_flag
+    if (maxSubLayersMinus1 > 6) {
+        return false;
+    }
+
+    readProfileTierLevel(reader, maxSubLayersMinus1, sps);
+
+    reader.readUE();                                  // sps_seq_parameter_set_id
+    const uint32_t chromaFormatIdc = reader.readUE();
+    if (chromaFormatIdc > 3) {
+        return false;
+    }
+    if (chromaFormatIdc == 3) {
+        reader.readBits(1);                           // separate_colour_plane_flag
+    }
+
+    const uint32_t width = reader.readUE();           // pic_width_in_luma_samples
+    const uint32_t height = reader.readUE();          // pic_height_in_luma_samples
+
+    int cropWidth = 0;
+    int cropHeight = 0;
+    if (reader.readBits(1)) {                         // conformance_window_flag
+        // Offsets are in chroma sample units
+        const int subWidth = (chromaFormatIdc == 1 || chromaFormatIdc == 2) ? 2 : 1;
+        const int subHeight = chromaFormatIdc == 1 ? 2 : 1;
+        const uint32_t left = reader.readUE();
+        const uint32_t right = reader.readUE();
+        const uint32_t top = reader.readUE();
+        const uint32_t bottom = reader.readUE();
+        cropWidth = static_cast<int>(left + right) * subWidth;
+        cropHeight = static_cast<int>(top + bottom) * subHeight;
+    }
+
+    if (reader.exhausted() || width == 0 || height == 0 || width > 16384 || height > 16384) {
+        return false;
+    }
+
+    sps.width = static_cast<int>(width) - cropWidth;
+    sps.height = static_cast<int>(height) - cropHeight;
+    sps.interlaced = false;  // Field coding is signalled per picture (SEI), not here
+    if (sps.framerate == 0) {
+        sps.framerate = 25;
+    }
+
+    return sps.width > 0 && sps.height > 0;
+}
+
+} // namespace network
+} // namespace fluxvision
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "types.h"
+#include <cstdint>
+
+namespace fluxvision {
+namespace network {
+
+/**
+ * H.265/HEVC NAL Unit Parser
+ *
+ * Counterpart of H264Parser for the two-byte HEVC NAL header
+ * (forbidden_zero_bit, nal_unit_type(6), nuh_layer_id(6), nuh_temporal_id_plus1(3)):
+ * - NAL unit type, IRAP (keyframe) and sub-layer reference classification
+ * - SPS resolution (conformance window applied), profile and level
+ *
+ * Thread-safety: All methods are thread-safe (stateless)
+ */
+class HevcParser {
+public:
+    struct NalInfo {
+        NalUnitType type = NalUnitType::UNSPECIFIED;
+        bool isKeyframe = false;   // IRAP picture or VPS/SPS/PPS (as H264Parser)
+        bool isReference = true;   // VCL only: false for *_N sub-layer non-reference pictures
+        int layerId = 0;           // nuh_layer_id
+        int temporalId = 0;        // nuh_temporal_id_plus1 - 1
+        bool valid = false;        // Header present and forbidden_zero_bit clear
+    };
+
+    /**
+     * Parse NAL unit header (start code optional)
+     */
+    static NalInfo parseNalHeader(const uint8_t* data, size_t size);
+
+    /**
+     * Extract SPS information (start code optional)
+     * Framerate lives in the VUI past the reference picture sets and is not
+     * parsed: it defaults to 25 like H264Parser's fallback
+     * Returns: true if SPS parsed successfully
+     */
+    static bool extractSPS(const uint8_t* data, size_t size, SPSInfo& sps);
+
+    /**
+     * Coded slice segment (VCL NAL unit, types 0-31)
+     */
+    static bool isSlice(NalUnitType type) { return static_cast<uint8_t>(type) < 32; }
+
+    /**
+     * Intra random access point picture (BLA, IDR, CRA; types 16-23)
+     */
+    static bool isIrap(NalUnitType type) {
+        return static_cast<uint8_t>(type) >= 16 && static_cast<uint8_t>(type) <= 23;
+    }
+
+    /**
+     * Parameter set (VPS, SPS or PPS)
+     */
+    static bool isParameterSet(NalUnitType type) {
+        return type == NalUnitType::HEVC_VPS || type == NalUnitType::HEVC_SPS ||
+               type == NalUnitType::HEVC_PPS;
+    }
+
+    /**
+     * Sub-layer reference picture: every VCL type except the even ones up to
+     * RSV_VCL_N14 (TRAIL_N, TSA_N, STSA_N, RADL_N, RASL_N, ...)
+     */
+    static bool isReference(NalUnitType type) {
+        const uint8_t value = static_cast<uint8_t>(type);
+        return !(value <= 14 && (value % 2) == 0);
+    }
+
+    /**
+     * first_slice_segment_in_pic_flag of a slice (nalData after the start code)
+     */
+    static bool isFirstSliceInPicture(const uint8_t* nalData, size_t nalSize) {
+        return nalSize > 2 && (nalData[2] & 0x80) != 0;
+    }
+};
+
+} // namespace network
+} // namespace fluxvision
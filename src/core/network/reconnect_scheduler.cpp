@@ -0,0 +1,209 @@
+#include "reconnect_scheduler.h"
+#include <algorithm>
+#include <chrono>
+
+namespace fluxvision {
+namespace network {
+
+ReconnectScheduler::ReconnectScheduler()
+    : ReconnectScheduler(Config{}) {
+}
+
+ReconnectScheduler::ReconnectScheduler(const Config& config)
+    : config_(config)
+    , random_(std::random_device{}()) {
+    config_.tickMs = std::max(config_.tickMs, 1);
+    config_.wheelSlots = std::max<size_t>(config_.wheelSlots, 1);
+    config_.maxConcurrentAttempts = std::max<size_t>(config_.maxConcurrentAttempts, 1);
+    config_.jitter = std::min(std::max(config_.jitter, 0.0), 1.0);
+    wheel_.resize(config_.wheelSlots);
+}
+
+ReconnectScheduler::~ReconnectScheduler() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    timerWake_.notify_all();
+    workReady_.notify_all();
+
+    if (timerThread_.joinable()) {
+        timerThread_.join();
+    }
+    for (auto& worker : workers_) {
+        worker.join();
+    }
+}
+
+ReconnectScheduler& ReconnectScheduler::shared() {
+    static ReconnectScheduler scheduler;
+    return scheduler;
+}
+
+ReconnectScheduler::TaskId ReconnectScheduler::schedule(Attempt attempt, int initialDelayMs) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!started_) {
+        startThreads();
+    }
+
+    const TaskId id = nextId_++;
+    Task& task = tasks_[id];
+    task.attempt = std::move(attempt);
+    task.delayMs = std::max(initialDelayMs, 0);
+
+    insert(id, task.delayMs);
+    timerWake_.notify_one();
+    return id;
+}
+
+void ReconnectScheduler::cancel(TaskId id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = tasks_.find(id);
+    if (it == tasks_.end()) {
+        return;
+    }
+
+    if (it->second.state != TaskState::RUNNING) {
+        // Its wheel entry or ready slot is skipped once the task is gone
+        if (it->second.state == TaskState::WAITING) {
+            waiting_--;
+        }
+        tasks_.erase(it);
+        return;
+    }
+
+    it->second.cancelled = true;
+    taskDone_.wait(lock, [this, id] { return tasks_.find(id) == tasks_.end(); });
+}
+
+ReconnectScheduler::Stats ReconnectScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats;
+    stats.pending = tasks_.size() - running_;
+    stats.running = running_;
+    stats.attempts = attempts_;
+    stats.failures = failures_;
+    return stats;
+}
+
+void ReconnectScheduler::startThreads() {
+    started_ = true;
+    timerThread_ = std::thread([this] { timerLoop(); });
+
+    workers_.reserve(config_.maxConcurrentAttempts);
+    for (size_t i = 0; i < config_.maxConcurrentAttempts; ++i) {
+        workers_.emplace_back([this] { workerLoop(); });
+    }
+}
+
+void ReconnectScheduler::insert(TaskId id, int delayMs) {
+    // Due after this many ticks (at least one: the cursor advances before a slot fires)
+    const size_t ticks = std::max<size_t>(1, static_cast<size_t>(jittered(delayMs) / config_.tickMs));
+
+    wheel_[(cursor_ + ticks) % wheel_.size()].push_back(WheelEntry{id, (ticks - 1) / wheel_.size()});
+    tasks_[id].state = TaskState::WAITING;
+    waiting_++;
+}
+
+int ReconnectScheduler::jittered(int delayMs) {
+    std::uniform_real_distribution<double> spread(1.0 - config_.jitter, 1.0);
+    return static_cast<int>(delayMs * spread(random_));
+}
+
+void ReconnectScheduler::timerLoop() {
+    const auto tick = std::chrono::milliseconds(config_.tickMs);
+    std::unique_lock<std::mutex> lock(mutex_);
+    auto next = std::chrono::steady_clock::now();
+
+    while (!stopping_) {
+        // Nothing in the wheel: sleep until something is scheduled
+        if (waiting_ == 0) {
+            timerWake_.wait(lock, [this] { return stopping_ || waiting_ > 0; });
+            next = std::chrono::steady_clock::now();
+            continue;
+        }
+
+        next += tick;
+        timerWake_.wait_until(lock, next, [this] { return stopping_; });
+        if (stopping_) {
+            break;
+        }
+
+        cursor_ = (cursor_ + 1) % wheel_.size();
+        auto& slot = wheel_[cursor_];
+
+        size_t kept = 0;
+        bool due = false;
+        for (WheelEntry& entry : slot) {
+            auto it = tasks_.find(entry.id);
+            if (it == tasks_.end() || it->second.state != TaskState::WAITING) {
+                continue;  // Cancelled
+            }
+
+            if (entry.rounds > 0) {
+                entry.rounds--;
+                slot[kept++] = entry;
+                continue;
+            }
+
+            it->second.state = TaskState::READY;
+            waiting_--;
+            ready_.push_back(entry.id);
+            due = true;
+        }
+        slot.resize(kept);
+
+        if (due) {
+            workReady_.notify_all();
+        }
+    }
+}
+
+void ReconnectScheduler::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    while (true) {
+        workReady_.wait(lock, [this] { return stopping_ || !ready_.empty(); });
+        if (stopping_) {
+            return;
+        }
+
+        const TaskId id = ready_.front();
+        ready_.pop_front();
+
+        auto it = tasks_.find(id);
+        if (it == tasks_.end()) {
+            continue;  // Cancelled while due
+        }
+
+        it->second.state = TaskState::RUNNING;
+        Attempt attempt = it->second.attempt;
+        running_++;
+        attempts_++;
+
+        lock.unlock();
+        const bool done = attempt();
+        lock.lock();
+
+        running_--;
+        it = tasks_.find(id);
+        if (done || it->second.cancelled) {
+            tasks_.erase(it);
+            taskDone_.notify_all();
+            continue;
+        }
+
+        failures_++;
+        Task& task = it->second;
+        task.delayMs = static_cast<int>(std::min<double>(
+            std::max(task.delayMs, config_.tickMs) * config_.multiplier, config_.maxDelayMs));
+        insert(id, task.delayMs);
+        timerWake_.notify_one();
+    }
+}
+
+} // namespace network
+} // namespace fluxvision
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fluxvision {
+namespace network {
+
+/**
+ * Reconnect scheduler shared by all RtspClients
+ *
+ * One timer wheel and a fixed set of attempt workers replace a detached
+ * thread per dropped camera. Retries back off exponentially, and each delay
+ * is drawn at random from [delay * (1 - jitter), delay]. Cameras that drop
+ * together (switch reboot) come back spread out instead of in synchronized
+ * waves, and never more than maxConcurrentAttempts connect at once.
+ *
+ * Threads are started on first use. Attempts run on the worker threads and
+ * may block (RTSP setup), bounded by the client's own deadline.
+ *
+ * Thread-safety: All methods are thread-safe
+ */
+class ReconnectScheduler {
+public:
+    struct Config {
+        int tickMs = 50;                   // Timer wheel resolution
+        size_t wheelSlots = 1024;          // One revolution: 51 s at 50 ms
+        size_t maxConcurrentAttempts = 8;  // Connection attempts in flight, process-wide
+        int maxDelayMs = 60000;            // Backoff ceiling
+        double multiplier = 2.0;           // Backoff growth per failed attempt
+        double jitter = 0.5;               // 0 = fixed delays, 1 = full jitter
+    };
+
+    struct Stats {
+        size_t pending = 0;                // Waiting for their delay or a free worker
+        size_t running = 0;
+        uint64_t attempts = 0;
+        uint64_t failures = 0;             // Attempts that asked to retry
+    };
+
+    /**
+     * One connection attempt
+     * Returns: true when done (connected, or gave up), false to retry after backoff
+     */
+    using Attempt = std::function<bool()>;
+    using TaskId = uint64_t;
+
+    ReconnectScheduler();
+    explicit ReconnectScheduler(const Config& config);
+    ~ReconnectScheduler();
+
+    // Disable copy
+    ReconnectScheduler(const ReconnectScheduler&) = delete;
+    ReconnectScheduler& operator=(const ReconnectScheduler&) = delete;
+
+    /**
+     * Process-wide instance (used by RtspClients without an explicit scheduler)
+     */
+    static ReconnectScheduler& shared();
+
+    /**
+     * Run attempt after a jittered initialDelayMs, then back off until it is done
+     * Returns: task id for cancel()
+     */
+    TaskId schedule(Attempt attempt, int initialDelayMs);
+
+    /**
+     * Drop a task; waits if its attempt is running (after that it is never called again)
+     */
+    void cancel(TaskId id);
+
+    Stats getStats() const;
+
+private:
+    enum class TaskState { WAITING, READY, RUNNING };
+
+    struct Task {
+        Attempt attempt;
+        TaskState state = TaskState::WAITING;
+        int delayMs = 0;                   // Un-jittered delay of the next retry
+        bool cancelled = false;            // Set while running: don't reschedule
+    };
+
+    struct WheelEntry {
+        TaskId id;
+        size_t rounds;                     // Revolutions left before it is due
+    };
+
+    Config config_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable timerWake_;    // Something was scheduled
+    std::condition_variable workReady_;    // A task is due
+    std::condition_variable taskDone_;     // An attempt returned (cancel() waits on it)
+
+    std::unordered_map<TaskId, Task> tasks_;
+    std::vector<std::vector<WheelEntry>> wheel_;
+    size_t cursor_ = 0;
+    size_t waiting_ = 0;                   // Tasks in the wheel
+    std::deque<TaskId> ready_;
+    TaskId nextId_ = 1;
+    std::mt19937 random_;
+
+    // Statistics (mutex_ held)
+    size_t running_ = 0;
+    uint64_t attempts_ = 0;
+    uint64_t failures_ = 0;
+
+    bool stopping_ = false;
+    bool started_ = false;
+    std::thread timerThread_;
+    std::vector<std::thread> workers_;
+
+    void startThreads();                   // mutex_ held
+    void insert(TaskId id, int delayMs);   // mutex_ held
+    int jittered(int delayMs);             // mutex_ held
+    void timerLoop();
+    void workerLoop();
+};
+
+} // namespace network
+} // namespace fluxvision
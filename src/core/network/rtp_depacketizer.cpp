@@ -1,39 +1,40 @@
 #include "rtp_depacketizer.h"
+#include "hevc_parser.h"
 #include <iostream>
 #include <cstring>
 
 namespace fluxvision {
 namespace network {
 
-RtpDepacketizer::RtpDepacketizer() {
+RtpDepacketizer::RtpDepacketizer(CodecType codec)
+    : codec_(codec)
+    , payloadHeaderSize_(codec == CodecType::H265 ? 2 : 1) {
     fragmentBuffer_.reserve(256 * 1024);  // Reserve 256KB for fragments
+    nalUnits_.reserve(16);
 }
 
 bool RtpDepacketizer::addPacket(const RtpPacket& packet) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
     if (packet.payload.empty()) {
         return false;
     }
 
-    // Check sequence number for packet loss
+    // Check sequence number for packet loss (modulo 2^16)
     if (!firstPacket_) {
-        uint16_t expected = lastSequenceNumber_ + 1;
-        if (packet.sequenceNumber != expected) {
-            if (packet.sequenceNumber > expected) {
-                // Packet loss detected
-                stats_.packetsLost += (packet.sequenceNumber - expected);
-
-                // Reset fragment buffer if we were in middle of fragmented NAL
-                if (fragmentInProgress_) {
-                    fragmentBuffer_.clear();
-                    fragmentInProgress_ = false;
-                }
-            } else {
-                // Out of order packet
-                stats_.packetsOutOfOrder++;
-                return false;  // Drop out-of-order packets
+        const uint16_t expected = lastSequenceNumber_ + 1;
+        const int16_t delta = static_cast<int16_t>(static_cast<uint16_t>(packet.sequenceNumber - expected));
+        if (delta > 0) {
+            // Packet loss detected
+            stats_.packetsLost += static_cast<uint64_t>(delta);
+
+            // Reset fragment buffer if we were in middle of fragmented NAL
+            if (fragmentInProgress_) {
+                fragmentBuffer_.clear();
+                fragmentInProgress_ = false;
             }
+        } else if (delta < 0) {
+            // Out of order packet
+            stats_.packetsOutOfOrder++;
+            return false;  // Drop out-of-order packets
         }
     }
 
@@ -41,12 +42,27 @@ bool RtpDepacketizer::addPacket(const RtpPacket& packet) {
     firstPacket_ = false;
     stats_.packetsProcessed++;
 
-    // Parse RTP header (if not already parsed)
-    // For now, we assume FFmpeg already stripped RTP header and gave us payload
     const uint8_t* payload = packet.payload.data();
     size_t payloadSize = packet.payload.size();
 
-    if (payloadSize == 0) {
+    if (codec_ == CodecType::H265) {
+        if (payloadSize < 2) {
+            return false;
+        }
+
+        // Type from the two-byte payload header
+        const uint8_t type = (payload[0] >> 1) & 0x3F;
+        if (type < 48) {
+            return processSingleNalUnit(payload, payloadSize, packet.timestamp);
+        }
+        if (type == 48) {
+            return processAggregationPacket(payload, payloadSize, packet.timestamp);
+        }
+        if (type == 49) {
+            return processFragmentedNalUnit(payload, payloadSize, packet.timestamp);
+        }
+
+        std::cerr << "RtpDepacketizer: Unknown HEVC payload type: " << static_cast<int>(type) << std::endl;
         return false;
     }
 
@@ -58,6 +74,10 @@ bool RtpDepacketizer::addPacket(const RtpPacket& packet) {
         // Single NAL unit packet
         return processSingleNalUnit(payload, payloadSize, packet.timestamp);
     }
+    else if (nalType == 24) {
+        // STAP-A aggregation packet
+        return processAggregationPacket(payload, payloadSize, packet.timestamp);
+    }
     else if (nalType == 28) {
         // FU-A fragmented NAL unit
         return processFragmentedNalUnit(payload, payloadSize, packet.timestamp);
@@ -76,35 +96,59 @@ bool RtpDepacketizer::processSingleNalUnit(const uint8_t* payload, size_t size,
     }
 
     NalUnit nal;
-    nal.type = getNalType(payload[0]);
-    nal.isKeyframe = isKeyframe(nal.type);
+    classify(nal, payload, size);
     nal.pts = timestamp;
     nal.dts = timestamp;
 
     // Copy NAL data with start code
-    nal.data.resize(size + 4);
-    nal.data[0] = 0x00;
-    nal.data[1] = 0x00;
-    nal.data[2] = 0x00;
-    nal.data[3] = 0x01;
-    std::memcpy(nal.data.data() + 4, payload, size);
-
-    nalUnits_.push(std::move(nal));
+    nal.data = PacketBuffer::allocate(size + 4);
+    uint8_t* out = nal.data.mutableData();
+    if (!out) {
+        return false;
+    }
+    out[0] = 0x00;
+    out[1] = 0x00;
+    out[2] = 0x00;
+    out[3] = 0x01;
+    std::memcpy(out + 4, payload, size);
+
+    nalUnits_.push_back(std::move(nal));
     stats_.nalUnitsExtracted++;
 
     return true;
 }
 
+bool RtpDepacketizer::processAggregationPacket(const uint8_t* payload, size_t size, uint32_t timestamp) {
+    // Payload header, then (16-bit size, NAL unit) pairs (RFC 6184 5.7.1, RFC 7798 4.4.2)
+    size_t offset = payloadHeaderSize_;
+    bool extracted = false;
+
+    while (offset + 2 <= size) {
+        const size_t nalSize = (payload[offset] << 8) | payload[offset + 1];
+        offset += 2;
+
+        if (nalSize == 0 || offset + nalSize > size) {
+            std::cerr << "RtpDepacketizer: Truncated aggregation packet" << std::endl;
+            break;
+        }
+
+        extracted = processSingleNalUnit(payload + offset, nalSize, timestamp) || extracted;
+        offset += nalSize;
+    }
+
+    return extracted;
+}
+
 bool RtpDepacketizer::processFragmentedNalUnit(const uint8_t* payload, size_t size, uint32_t timestamp) {
-    if (size < 2) {
+    // FU header follows the payload header (FU indicator for H.264); fragment data after it
+    const size_t dataOffset = payloadHeaderSize_ + 1;
+    if (size < dataOffset) {
         return false;
     }
 
-    uint8_t fuHeader = payload[1];
+    uint8_t fuHeader = payload[payloadHeaderSize_];
     bool startBit = (fuHeader & 0x80) != 0;
     bool endBit = (fuHeader & 0x40) != 0;
-    // NAL type is encoded in FU header but not needed for reassembly
-    // uint8_t nalType = fuHeader & 0x1F;
 
     if (startBit) {
         // Start of fragmented NAL unit
@@ -116,20 +160,25 @@ bool RtpDepacketizer::processFragmentedNalUnit(const uint8_t* payload, size_t si
         fragmentInProgress_ = true;
         fragmentTimestamp_ = timestamp;
 
-        // Reconstruct NAL header from FU indicator and FU header
-        uint8_t fuIndicator = payload[0];
-        uint8_t nalHeader = (fuIndicator & 0xE0) | (fuHeader & 0x1F);
-
         // Add NAL start code
         fragmentBuffer_.clear();
         fragmentBuffer_.push_back(0x00);
         fragmentBuffer_.push_back(0x00);
         fragmentBuffer_.push_back(0x00);
         fragmentBuffer_.push_back(0x01);
-        fragmentBuffer_.push_back(nalHeader);
 
-        // Add fragment payload (skip FU indicator and FU header)
-        fragmentBuffer_.insert(fragmentBuffer_.end(), payload + 2, payload + size);
+        // Reconstruct NAL header from the payload header and FU header
+        if (codec_ == CodecType::H265) {
+            // F bit and layer id MSB kept, type from the FU header; second byte unchanged
+            fragmentBuffer_.push_back((payload[0] & 0x81) | ((fuHeader & 0x3F) << 1));
+            fragmentBuffer_.push_back(payload[1]);
+        } else {
+            uint8_t fuIndicator = payload[0];
+            fragmentBuffer_.push_back((fuIndicator & 0xE0) | (fuHeader & 0x1F));
+        }
+
+        // Add fragment payload (skip payload header and FU header)
+        fragmentBuffer_.insert(fragmentBuffer_.end(), payload + dataOffset, payload + size);
     }
     else if (fragmentInProgress_) {
         // Middle or end fragment
@@ -140,8 +189,8 @@ bool RtpDepacketizer::processFragmentedNalUnit(const uint8_t* payload, size_t si
             return false;
         }
 
-        // Add fragment payload (skip FU indicator and FU header)
-        fragmentBuffer_.insert(fragmentBuffer_.end(), payload + 2, payload + size);
+        // Add fragment payload (skip payload header and FU header)
+        fragmentBuffer_.insert(fragmentBuffer_.end(), payload + dataOffset, payload + size);
 
         if (endBit) {
             // Complete NAL unit
@@ -159,51 +208,38 @@ bool RtpDepacketizer::processFragmentedNalUnit(const uint8_t* payload, size_t si
 }
 
 void RtpDepacketizer::completeNalUnit(uint32_t timestamp) {
-    if (fragmentBuffer_.size() <= 4) {
+    if (fragmentBuffer_.size() <= 4 + payloadHeaderSize_) {
         return;  // Invalid NAL unit
     }
 
     NalUnit nal;
-    nal.type = getNalType(fragmentBuffer_[4]);  // NAL header is at index 4 (after start code)
-    nal.isKeyframe = isKeyframe(nal.type);
+    classify(nal, fragmentBuffer_.data() + 4, fragmentBuffer_.size() - 4);  // After the start code
     nal.pts = timestamp;
     nal.dts = timestamp;
-    nal.data = std::move(fragmentBuffer_);
+    nal.data = PacketBuffer::copyOf(fragmentBuffer_);
 
-    nalUnits_.push(std::move(nal));
+    nalUnits_.push_back(std::move(nal));
     stats_.nalUnitsExtracted++;
 
-    fragmentBuffer_.clear();
+    fragmentBuffer_.clear();  // Keeps the reserved capacity for the next fragment
 }
 
 bool RtpDepacketizer::getNalUnit(NalUnit& nalUnit) {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (nalUnits_.empty()) {
+    if (readIndex_ == nalUnits_.size()) {
         return false;
     }
 
-    nalUnit = std::move(nalUnits_.front());
-    nalUnits_.pop();
+    nalUnit = std::move(nalUnits_[readIndex_++]);
+    if (readIndex_ == nalUnits_.size()) {
+        nalUnits_.clear();  // Keeps the capacity for the next packets
+        readIndex_ = 0;
+    }
     return true;
 }
 
-bool RtpDepacketizer::hasNalUnits() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return !nalUnits_.empty();
-}
-
-size_t RtpDepacketizer::getNalUnitCount() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return nalUnits_.size();
-}
-
 void RtpDepacketizer::reset() {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    while (!nalUnits_.empty()) {
-        nalUnits_.pop();
-    }
+    nalUnits_.clear();
+    readIndex_ = 0;
 
     fragmentBuffer_.clear();
     fragmentInProgress_ = false;
@@ -211,57 +247,20 @@ void RtpDepacketizer::reset() {
     lastSequenceNumber_ = 0;
 }
 
-RtpDepacketizer::Stats RtpDepacketizer::getStats() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return stats_;
-}
-
-NalUnitType RtpDepacketizer::getNalType(uint8_t header) const {
-    uint8_t type = header & 0x1F;
-    return static_cast<NalUnitType>(type);
-}
-
-bool RtpDepacketizer::isKeyframe(NalUnitType type) const {
-    return type == NalUnitType::IDR ||
-           type == NalUnitType::SPS ||
-           type == NalUnitType::PPS;
-}
-
-bool RtpDepacketizer::parseRtpHeader(const std::vector<uint8_t>& data,
-                                     RtpHeader& header,
-                                     size_t& headerSize) {
-    if (data.size() < 12) {
-        return false;  // Minimum RTP header size
-    }
-
-    const uint8_t* buf = data.data();
-
-    header.version = (buf[0] >> 6) & 0x03;
-    header.padding = (buf[0] & 0x20) != 0;
-    header.extension = (buf[0] & 0x10) != 0;
-    header.csrcCount = buf[0] & 0x0F;
-    header.marker = (buf[1] & 0x80) != 0;
-    header.payloadType = buf[1] & 0x7F;
-
-    header.sequenceNumber = (buf[2] << 8) | buf[3];
-    header.timestamp = (buf[4] << 24) | (buf[5] << 16) | (buf[6] << 8) | buf[7];
-    header.ssrc = (buf[8] << 24) | (buf[9] << 16) | (buf[10] << 8) | buf[11];
-
-    headerSize = 12 + (header.csrcCount * 4);
+void RtpDepacketizer::classify(NalUnit& nal, const uint8_t* nalHeader, size_t size) const {
+    nal.codec = codec_;
 
-    if (header.extension) {
-        if (data.size() < headerSize + 4) {
-            return false;
-        }
-        uint16_t extLength = (buf[headerSize + 2] << 8) | buf[headerSize + 3];
-        headerSize += 4 + (extLength * 4);
-    }
-
-    if (data.size() < headerSize) {
-        return false;
+    if (codec_ == CodecType::H265) {
+        const HevcParser::NalInfo info = HevcParser::parseNalHeader(nalHeader, size);
+        nal.type = info.type;
+        nal.isKeyframe = info.isKeyframe;
+        return;
     }
 
-    return true;
+    nal.type = static_cast<NalUnitType>(nalHeader[0] & 0x1F);
+    nal.isKeyframe = nal.type == NalUnitType::IDR ||
+                     nal.type == NalUnitType::SPS ||
+                     nal.type == NalUnitType::PPS;
 }
 
 } // namespace network
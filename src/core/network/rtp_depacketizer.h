@@ -1,8 +1,6 @@
 #pragma once
 
 #include "types.h"
-#include <queue>
-#include <mutex>
 #include <vector>
 
 namespace fluxvision {
@@ -11,17 +9,24 @@ namespace network {
 /**
  * RTP Depacketizer for H.264/H.265
  *
- * Converts RTP packets to complete NAL units, handling:
+ * Converts RTP payloads (header already stripped by RtpUdpReceiver) to
+ * complete NAL units, handling (RFC 6184 for H.264, RFC 7798 for H.265):
  * - Single NAL unit packets
- * - Fragmentation units (FU-A) for large NAL units
- * - Packet reordering
- * - Packet loss detection
+ * - Aggregation packets (STAP-A, H.265 AP type 48), as cameras send parameter sets
+ * - Fragmentation units (FU-A, H.265 FU type 49) for large NAL units
+ * - Packet loss detection (a gap aborts the NAL being reassembled)
  *
- * Thread-safety: All methods are thread-safe
+ * Expects packets in sequence order: put an RtpJitterBuffer in front when
+ * the transport can reorder. Late packets are dropped.
+ *
+ * Completed NAL units wait in a reused vector, so steady-state operation
+ * allocates only the NAL unit buffers themselves.
+ *
+ * Thread-safety: Not thread-safe (one instance per stream, single producer)
  */
 class RtpDepacketizer {
 public:
-    RtpDepacketizer();
+    explicit RtpDepacketizer(CodecType codec = CodecType::H264);
     ~RtpDepacketizer() = default;
 
     /**
@@ -39,12 +44,12 @@ public:
     /**
      * Check if NAL units are available
      */
-    bool hasNalUnits() const;
+    bool hasNalUnits() const { return readIndex_ < nalUnits_.size(); }
 
     /**
      * Get number of NAL units in queue
      */
-    size_t getNalUnitCount() const;
+    size_t getNalUnitCount() const { return nalUnits_.size() - readIndex_; }
 
     /**
      * Reset depacketizer state
@@ -62,31 +67,26 @@ public:
         uint64_t packetsOutOfOrder = 0;
     };
 
-    Stats getStats() const;
+    Stats getStats() const { return stats_; }
 
 private:
-    struct RtpHeader {
-        uint8_t version;
-        bool padding;
-        bool extension;
-        uint8_t csrcCount;
-        bool marker;
-        uint8_t payloadType;
-        uint16_t sequenceNumber;
-        uint32_t timestamp;
-        uint32_t ssrc;
-    };
-
-    bool parseRtpHeader(const std::vector<uint8_t>& data, RtpHeader& header, size_t& headerSize);
     bool processSingleNalUnit(const uint8_t* payload, size_t size, uint32_t timestamp);
+    bool processAggregationPacket(const uint8_t* payload, size_t size, uint32_t timestamp);
     bool processFragmentedNalUnit(const uint8_t* payload, size_t size, uint32_t timestamp);
 
     void completeNalUnit(uint32_t timestamp);
-    NalUnitType getNalType(uint8_t header) const;
-    bool isKeyframe(NalUnitType type) const;
 
-    mutable std::mutex mutex_;
-    std::queue<NalUnit> nalUnits_;
+    /**
+     * Set codec, type and keyframe flag from the NAL header
+     */
+    void classify(NalUnit& nal, const uint8_t* nalHeader, size_t size) const;
+
+    CodecType codec_;
+    size_t payloadHeaderSize_;         // NAL/payload header: 1 byte (H.264), 2 bytes (H.265)
+
+    // Completed NAL units [readIndex_, size()); cleared (capacity kept) once drained
+    std::vector<NalUnit> nalUnits_;
+    size_t readIndex_ = 0;
 
     // Fragmentation state
     std::vector<uint8_t> fragmentBuffer_;
@@ -0,0 +1,135 @@
+#include "rtp_jitter_buffer.h"
+#include <algorithm>
+
+namespace fluxvision {
+namespace network {
+
+namespace {
+    size_t roundUpToPowerOfTwo(size_t value) {
+        size_t result = 16;
+        while (result < value && result < 32768) {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+RtpJitterBuffer::RtpJitterBuffer()
+    : RtpJitterBuffer(Config{}) {
+}
+
+RtpJitterBuffer::RtpJitterBuffer(const Config& config)
+    : latencyUs_(std::max<int64_t>(config.latencyUs, 0))
+    , slots_(roundUpToPowerOfTwo(config.capacity))
+    , mask_(slots_.size() - 1) {
+}
+
+bool RtpJitterBuffer::push(RtpPacket&& packet) {
+    stats_.packetsIn++;
+
+    if (!started_) {
+        started_ = true;
+        nextSeq_ = packet.sequenceNumber;
+        span_ = 0;
+    }
+
+    // Distance from the release point, modulo 2^16
+    int offset = static_cast<int16_t>(static_cast<uint16_t>(packet.sequenceNumber - nextSeq_));
+
+    if (offset < 0) {
+        stats_.packetsLate++;
+        return false;
+    }
+
+    if (static_cast<size_t>(offset) >= slots_.size()) {
+        // Too far ahead to be reordering: the sender restarted its sequence
+        stats_.resyncs++;
+        reset();
+        started_ = true;
+        nextSeq_ = packet.sequenceNumber;
+        offset = 0;
+    }
+
+    Slot& slot = slotFor(packet.sequenceNumber);
+    if (slot.occupied) {
+        stats_.packetsDuplicate++;
+        return false;
+    }
+
+    if (offset < span_) {
+        stats_.packetsReordered++;
+    } else {
+        span_ = static_cast<uint16_t>(offset + 1);
+    }
+
+    slot.packet = std::move(packet);
+    slot.occupied = true;
+    held_++;
+    return true;
+}
+
+bool RtpJitterBuffer::pop(RtpPacket& packet, int64_t nowUs) {
+    if (held_ == 0) {
+        return false;
+    }
+
+    if (!slotFor(nextSeq_).occupied) {
+        // Gap: wait for the missing packet until the one behind it has waited long enough
+        const Slot* first = firstHeld();
+        if (nowUs - first->packet.receiveTime < latencyUs_) {
+            return false;
+        }
+
+        const uint16_t lost = static_cast<uint16_t>(first->packet.sequenceNumber - nextSeq_);
+        stats_.packetsLost += lost;
+        span_ = static_cast<uint16_t>(span_ - lost);
+        nextSeq_ = first->packet.sequenceNumber;
+    }
+
+    Slot& slot = slotFor(nextSeq_);
+    packet = std::move(slot.packet);
+    slot.packet = RtpPacket{};  // Release the datagram buffer reference
+    slot.occupied = false;
+
+    held_--;
+    nextSeq_++;
+    span_--;
+    stats_.packetsOut++;
+    return true;
+}
+
+int64_t RtpJitterBuffer::nextDeadline() const {
+    if (held_ == 0 || slotFor(nextSeq_).occupied) {
+        return -1;
+    }
+    return firstHeld()->packet.receiveTime + latencyUs_;
+}
+
+void RtpJitterBuffer::reset() {
+    for (uint16_t i = 0; held_ > 0 && i < span_; ++i) {
+        Slot& slot = slotFor(static_cast<uint16_t>(nextSeq_ + i));
+        if (slot.occupied) {
+            slot.packet = RtpPacket{};
+            slot.occupied = false;
+            held_--;
+        }
+    }
+
+    held_ = 0;
+    span_ = 0;
+    started_ = false;
+}
+
+const RtpJitterBuffer::Slot* RtpJitterBuffer::firstHeld() const {
+    // held_ > 0 and nextSeq_ is empty, so a held slot lies within the span
+    for (uint16_t i = 1; i < span_; ++i) {
+        const Slot& slot = slotFor(static_cast<uint16_t>(nextSeq_ + i));
+        if (slot.occupied) {
+            return &slot;
+        }
+    }
+    return &slotFor(static_cast<uint16_t>(nextSeq_ + span_ - 1));
+}
+
+} // namespace network
+} // namespace fluxvision
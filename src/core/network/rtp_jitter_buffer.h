@@ -0,0 +1,107 @@
+#pragma once
+
+#include "types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fluxvision {
+namespace network {
+
+/**
+ * RTP reordering jitter buffer
+ *
+ * Sits between RtpUdpReceiver and RtpDepacketizer and restores sequence
+ * order. Packets are stored in a fixed ring indexed by sequence number, so
+ * insert and release are O(1) and nothing is allocated after construction.
+ *
+ * A missing packet holds back everything after it for at most latencyUs
+ * (measured from the arrival of the first packet past the gap); then the gap
+ * is declared lost and release continues. Duplicates and packets arriving
+ * after their slot was released are dropped. A sequence jump larger than the
+ * ring (camera restart, SSRC change) resynchronizes on the new packet.
+ *
+ * Sequence arithmetic is modulo 2^16 (RFC 3550 wrap-around).
+ *
+ * Thread-safety: Not thread-safe (one instance per stream, single consumer)
+ */
+class RtpJitterBuffer {
+public:
+    struct Config {
+        size_t capacity = 512;          // Packets held at most (power of two, 16..32768)
+        int64_t latencyUs = 20000;      // Longest wait for a missing packet (LAN: a few ms suffice)
+    };
+
+    struct Stats {
+        uint64_t packetsIn = 0;
+        uint64_t packetsOut = 0;
+        uint64_t packetsReordered = 0;  // Arrived after a later sequence number (filled a gap)
+        uint64_t packetsLost = 0;       // Gaps given up on
+        uint64_t packetsLate = 0;       // Arrived after their slot was released
+        uint64_t packetsDuplicate = 0;
+        uint64_t resyncs = 0;           // Jumps beyond the ring (held packets dropped)
+    };
+
+    RtpJitterBuffer();
+    explicit RtpJitterBuffer(const Config& config);
+    ~RtpJitterBuffer() = default;
+
+    /**
+     * Insert a received packet (packet.receiveTime drives the gap timeout)
+     * Returns: false if the packet was dropped (late or duplicate)
+     */
+    bool push(RtpPacket&& packet);
+
+    /**
+     * Release the next packet in sequence order
+     * Skips a gap once its wait exceeds latencyUs at time nowUs
+     * Returns: false if nothing is releasable yet
+     */
+    bool pop(RtpPacket& packet, int64_t nowUs);
+
+    /**
+     * Time (microseconds, receiveTime clock) at which the pending gap times out
+     * Returns: -1 if no packet is waiting behind a gap
+     */
+    int64_t nextDeadline() const;
+
+    /**
+     * Packets currently held
+     */
+    size_t size() const { return held_; }
+
+    /**
+     * Drop all held packets and wait for a new first packet
+     */
+    void reset();
+
+    Stats getStats() const { return stats_; }
+
+private:
+    struct Slot {
+        RtpPacket packet;
+        bool occupied = false;
+    };
+
+    int64_t latencyUs_;
+    std::vector<Slot> slots_;
+    size_t mask_;
+
+    uint16_t nextSeq_ = 0;          // Next sequence number to release
+    uint16_t span_ = 0;             // Held packets lie in [nextSeq_, nextSeq_ + span_)
+    size_t held_ = 0;
+    bool started_ = false;
+
+    Stats stats_;
+
+    Slot& slotFor(uint16_t seq) { return slots_[seq & mask_]; }
+    const Slot& slotFor(uint16_t seq) const { return slots_[seq & mask_]; }
+
+    /**
+     * First held slot after nextSeq_ (the packet that waits behind the gap)
+     */
+    const Slot* firstHeld() const;
+};
+
+} // namespace network
+} // namespace fluxvision
@@ -0,0 +1,106 @@
+#include "rtp_udp_ingest.h"
+#include <chrono>
+
+namespace fluxvision {
+namespace network {
+
+namespace {
+    int64_t nowMicros() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+bool RtpUdpIngest::open(const Config& config) {
+    close();
+    config_ = config;
+    if (config_.clockRate <= 0) {
+        config_.clockRate = 90000;
+    }
+
+    jitter_ = RtpJitterBuffer(config_.jitter);
+    depacketizer_ = RtpDepacketizer(config_.codec);
+    assembler_.setCodec(config_.codec);
+    received_.reserve(config_.receiver.batchSize);
+
+    return receiver_.open(config_.receiver);
+}
+
+void RtpUdpIngest::close() {
+    receiver_.close();
+    jitter_.reset();
+    depacketizer_.reset();
+    assembler_.reset();
+    received_.clear();
+    haveTimestamp_ = false;
+}
+
+RtpUdpIngest::ReadStatus RtpUdpIngest::readAccessUnits(std::vector<AccessUnit>& accessUnits) {
+    accessUnits.clear();
+    received_.clear();
+
+    const int received = receiver_.receive(received_);
+    if (received < 0) {
+        return ReadStatus::CLOSED;
+    }
+
+    for (RtpPacket& packet : received_) {
+        jitter_.push(std::move(packet));
+    }
+    received_.clear();  // Drop the moved-from slots' slice references
+
+    // Release in sequence order; a gap holds later packets back up to the latency
+    const int64_t now = nowMicros();
+    bool released = false;
+    RtpPacket packet;
+    NalUnit nal;
+
+    while (jitter_.pop(packet, now)) {
+        released = true;
+        depacketizer_.addPacket(packet);
+
+        const int64_t pts = toMicros(packet.timestamp);
+        while (depacketizer_.getNalUnit(nal)) {
+            nal.pts = pts;
+            nal.dts = pts;
+            nal.receiveTime = packet.receiveTime;
+            assembler_.push(std::move(nal));
+        }
+
+        // Marker bit: last packet of the picture (RFC 6184 5.1, RFC 7798 4.1)
+        if (packet.marker) {
+            assembler_.endOfPacket();
+        }
+    }
+
+    AccessUnit au;
+    while (assembler_.pop(au)) {
+        accessUnits.push_back(std::move(au));
+    }
+
+    return (received > 0 || released) ? ReadStatus::OK : ReadStatus::WOULD_BLOCK;
+}
+
+RtpUdpIngest::Stats RtpUdpIngest::getStats() const {
+    Stats stats;
+    stats.receiver = receiver_.getStats();
+    stats.jitter = jitter_.getStats();
+    stats.depacketizer = depacketizer_.getStats();
+    return stats;
+}
+
+int64_t RtpUdpIngest::toMicros(uint32_t rtpTimestamp) {
+    if (!haveTimestamp_) {
+        haveTimestamp_ = true;
+        extendedTimestamp_ = rtpTimestamp;
+    } else {
+        // Signed difference survives the 32-bit wrap (every ~13 h at 90 kHz)
+        extendedTimestamp_ += static_cast<int32_t>(rtpTimestamp - lastTimestamp_);
+    }
+    lastTimestamp_ = rtpTimestamp;
+
+    return extendedTimestamp_ * 1000000 / config_.clockRate;
+}
+
+} // namespace network
+} // namespace fluxvision
@@ -0,0 +1,108 @@
+#pragma once
+
+#include "types.h"
+#include "rtp_udp_receiver.h"
+#include "rtp_jitter_buffer.h"
+#include "rtp_depacketizer.h"
+#include "access_unit_assembler.h"
+#include <cstdint>
+#include <vector>
+
+namespace fluxvision {
+namespace network {
+
+/**
+ * Native RTP/UDP ingest path for one H.264 or H.265 stream
+ *
+ * RtpUdpReceiver (recvmmsg batches into a packet ring) -> RtpJitterBuffer
+ * (sequence reordering) -> RtpDepacketizer (NAL units) -> AccessUnitAssembler
+ * (whole pictures, closed at the RTP marker bit).
+ *
+ * The UDP counterpart of RtspClient::readAccessUnits() for LAN cameras that
+ * send RTP to a known port or multicast group (RtspUdpSource negotiates that
+ * port over RTSP): no FFmpeg demuxer, and per packet neither a syscall nor an
+ * allocation. RTP timestamps are unwrapped
+ * and converted to microseconds.
+ *
+ * Non-blocking: register nativeHandle() with a NetworkReactor. While a gap
+ * is open, also service again at nextDeadline() so the jitter buffer can
+ * give up on it even if the camera goes quiet.
+ *
+ * Thread-safety: Not thread-safe (one instance per stream, single consumer)
+ */
+class RtpUdpIngest {
+public:
+    struct Config {
+        RtpUdpReceiver::Config receiver;
+        RtpJitterBuffer::Config jitter;
+        CodecType codec = CodecType::H264;  // Payload format (RFC 6184 or RFC 7798)
+        int clockRate = 90000;          // RTP clock of the video payload
+    };
+
+    /**
+     * Outcome of a single non-blocking read (as RtspClient::ReadStatus)
+     */
+    enum class ReadStatus {
+        OK,            // Datagrams read or released (may complete zero access units)
+        WOULD_BLOCK,   // Nothing received and nothing releasable
+        CLOSED         // Socket closed or failed
+    };
+
+    struct Stats {
+        RtpUdpReceiver::Stats receiver;
+        RtpJitterBuffer::Stats jitter;
+        RtpDepacketizer::Stats depacketizer;
+    };
+
+    RtpUdpIngest() = default;
+    ~RtpUdpIngest() = default;
+
+    // Disable copy
+    RtpUdpIngest(const RtpUdpIngest&) = delete;
+    RtpUdpIngest& operator=(const RtpUdpIngest&) = delete;
+
+    bool open(const Config& config);
+    void close();
+    bool isOpen() const { return receiver_.isOpen(); }
+
+    /**
+     * Receive pending datagrams and return the access units they complete
+     */
+    ReadStatus readAccessUnits(std::vector<AccessUnit>& accessUnits);
+
+    /**
+     * Socket handle for NetworkReactor::addSource (-1 if closed)
+     */
+    intptr_t nativeHandle() const { return receiver_.nativeHandle(); }
+
+    /**
+     * Bound RTP port, e.g. for an RTSP SETUP client_port (0 if closed)
+     */
+    uint16_t localPort() const { return receiver_.localPort(); }
+
+    /**
+     * Steady-clock microseconds at which an open gap times out (-1 if none)
+     */
+    int64_t nextDeadline() const { return jitter_.nextDeadline(); }
+
+    Stats getStats() const;
+
+private:
+    Config config_;
+    RtpUdpReceiver receiver_;
+    RtpJitterBuffer jitter_;
+    RtpDepacketizer depacketizer_;
+    AccessUnitAssembler assembler_;
+
+    std::vector<RtpPacket> received_;   // Reused across reads
+
+    // RTP timestamp unwrapping
+    bool haveTimestamp_ = false;
+    uint32_t lastTimestamp_ = 0;
+    int64_t extendedTimestamp_ = 0;
+
+    int64_t toMicros(uint32_t rtpTimestamp);
+};
+
+} // namespace network
+} // namespace fluxvision
@@ -0,0 +1,406 @@
+#include "rtp_udp_receiver.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+
+// Older libc headers lack it; the kernel rejects it (ENOPROTOOPT) before 5.0
+#ifndef UDP_GRO
+#define UDP_GRO 104
+#endif
+#endif
+
+namespace fluxvision {
+namespace network {
+
+namespace {
+    constexpr size_t kDatagramSlotBytes = 2048;    // One datagram at Ethernet MTU
+    constexpr size_t kGroSlotBytes = 65536;        // Largest GRO aggregate
+    constexpr size_t kMaxGroBatch = 8;
+
+    int64_t nowMicros() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void closeSocket(intptr_t socket) {
+#ifdef _WIN32
+        closesocket(static_cast<SOCKET>(socket));
+#else
+        ::close(static_cast<int>(socket));
+#endif
+    }
+}
+
+struct RtpUdpReceiver::Batch {
+#ifdef PLATFORM_LINUX
+    // Room for the UDP_GRO segment size control message
+    struct Control {
+        alignas(cmsghdr) unsigned char data[CMSG_SPACE(sizeof(int))];
+    };
+
+    std::vector<mmsghdr> messages;
+    std::vector<iovec> iovecs;
+    std::vector<Control> controls;
+#endif
+};
+
+RtpUdpReceiver::RtpUdpReceiver() = default;
+
+RtpUdpReceiver::~RtpUdpReceiver() {
+    close();
+}
+
+bool RtpUdpReceiver::open(const Config& config) {
+    close();
+    config_ = config;
+    stats_ = Stats{};
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "RtpUdpReceiver: WSAStartup failed" << std::endl;
+        return false;
+    }
+    SOCKET fd = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (fd == INVALID_SOCKET) {
+        std::cerr << "RtpUdpReceiver: socket() failed: " << WSAGetLastError() << std::endl;
+        WSACleanup();
+        return false;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(fd, FIONBIO, &nonBlocking);
+#else
+    int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "RtpUdpReceiver: socket() failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+#endif
+    socket_ = static_cast<intptr_t>(fd);
+
+    const int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+
+    // A 1080p IDR arrives as a burst of ~100 datagrams: the socket buffer must hold it
+    const int requested = config_.recvBufferBytes;
+    setsockopt(fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<const char*>(&requested), sizeof(requested));
+
+    int granted = 0;
+    socklen_t grantedSize = sizeof(granted);
+    if (getsockopt(fd, SOL_SOCKET, SO_RCVBUF, reinterpret_cast<char*>(&granted), &grantedSize) == 0 &&
+        granted < requested) {
+        std::cerr << "RtpUdpReceiver: SO_RCVBUF limited to " << granted << " bytes (asked "
+                  << requested << "), raise net.core.rmem_max" << std::endl;
+    }
+
+    sockaddr_in local{};
+    local.sin_family = AF_INET;
+    local.sin_port = htons(config_.port);
+
+    // Multicast binds the wildcard address and joins on the bind interface
+    in_addr interfaceAddress{};
+    if (inet_pton(AF_INET, config_.bindAddress.c_str(), &interfaceAddress) != 1) {
+        std::cerr << "RtpUdpReceiver: invalid bind address " << config_.bindAddress << std::endl;
+        close();
+        return false;
+    }
+    local.sin_addr = interfaceAddress;
+    if (!config_.multicastGroup.empty()) {
+        local.sin_addr.s_addr = htonl(INADDR_ANY);
+    }
+
+    if (bind(fd, reinterpret_cast<const sockaddr*>(&local), sizeof(local)) != 0) {
+        std::cerr << "RtpUdpReceiver: bind to " << config_.bindAddress << ":" << config_.port
+                  << " failed" << std::endl;
+        close();
+        return false;
+    }
+
+    if (!config_.multicastGroup.empty()) {
+        ip_mreq membership{};
+        membership.imr_interface = interfaceAddress;
+        if (inet_pton(AF_INET, config_.multicastGroup.c_str(), &membership.imr_multiaddr) != 1 ||
+            setsockopt(fd, IPPROTO_IP, IP_ADD_MEMBERSHIP,
+                       reinterpret_cast<const char*>(&membership), sizeof(membership)) != 0) {
+            std::cerr << "RtpUdpReceiver: failed to join multicast group "
+                      << config_.multicastGroup << std::endl;
+            close();
+            return false;
+        }
+    }
+
+#ifdef PLATFORM_LINUX
+    if (config_.enableGro) {
+        const int enable = 1;
+        stats_.groActive = setsockopt(fd, SOL_UDP, UDP_GRO, &enable, sizeof(enable)) == 0;
+    }
+#endif
+
+    // Keep the ring's memory budget whether or not GRO coalesces datagrams
+    const size_t batch = std::max<size_t>(config_.batchSize, 1);
+    size_t slots = std::max<size_t>(config_.ringSlots, 1);
+    if (stats_.groActive) {
+        batchEntries_ = std::min(batch, kMaxGroBatch);
+        slotBytes_ = kGroSlotBytes;
+        slots = slots * kDatagramSlotBytes / kGroSlotBytes;
+    } else {
+        batchEntries_ = batch;
+        slotBytes_ = kDatagramSlotBytes;
+    }
+
+    // Twice the batch, so slots filled by one call are not needed by the next
+    ring_.clear();
+    ring_.resize(std::max(slots, 2 * batchEntries_));
+    for (PacketBuffer& slot : ring_) {
+        slot = PacketBuffer::allocate(slotBytes_);
+    }
+    ringCursor_ = 0;
+
+    batch_ = std::make_unique<Batch>();
+#ifdef PLATFORM_LINUX
+    batch_->messages.resize(batchEntries_);
+    batch_->iovecs.resize(batchEntries_);
+    batch_->controls.resize(batchEntries_);
+#endif
+
+    return true;
+}
+
+void RtpUdpReceiver::close() {
+    if (socket_ < 0) {
+        return;
+    }
+
+    closeSocket(socket_);
+    socket_ = -1;
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    // Slices handed out keep their slot's storage alive
+    ring_.clear();
+    batch_.reset();
+}
+
+bool RtpUdpReceiver::isOpen() const {
+    return socket_ >= 0;
+}
+
+intptr_t RtpUdpReceiver::nativeHandle() const {
+    return socket_;
+}
+
+uint16_t RtpUdpReceiver::localPort() const {
+    if (socket_ < 0) {
+        return 0;
+    }
+
+    sockaddr_in local{};
+    socklen_t size = sizeof(local);
+#ifdef _WIN32
+    if (getsockname(static_cast<SOCKET>(socket_), reinterpret_cast<sockaddr*>(&local), &size) != 0) {
+#else
+    if (getsockname(static_cast<int>(socket_), reinterpret_cast<sockaddr*>(&local), &size) != 0) {
+#endif
+        return 0;
+    }
+    return ntohs(local.sin_port);
+}
+
+int RtpUdpReceiver::receive(std::vector<RtpPacket>& packets) {
+    if (socket_ < 0) {
+        return -1;
+    }
+
+    int count = 0;
+
+#ifdef PLATFORM_LINUX
+    // Entry i fills the i-th ring slot after the cursor
+    for (size_t i = 0; i < batchEntries_; ++i) {
+        const size_t slot = (ringCursor_ + i) % ring_.size();
+
+        mmsghdr& message = batch_->messages[i];
+        std::memset(&message, 0, sizeof(message));
+        batch_->iovecs[i].iov_base = writableSlot(slot);
+        batch_->iovecs[i].iov_len = slotBytes_;
+        message.msg_hdr.msg_iov = &batch_->iovecs[i];
+        message.msg_hdr.msg_iovlen = 1;
+        if (stats_.groActive) {
+            message.msg_hdr.msg_control = batch_->controls[i].data;
+            message.msg_hdr.msg_controllen = sizeof(batch_->controls[i].data);
+        }
+    }
+
+    const int received = recvmmsg(static_cast<int>(socket_), batch_->messages.data(),
+                                  static_cast<unsigned int>(batchEntries_), MSG_DONTWAIT, nullptr);
+    if (received < 0) {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+            return 0;
+        }
+        std::cerr << "RtpUdpReceiver: recvmmsg failed: " << std::strerror(errno) << std::endl;
+        return -1;
+    }
+
+    stats_.syscalls++;
+    const int64_t receiveTime = nowMicros();
+
+    for (int i = 0; i < received; ++i) {
+        const msghdr& header = batch_->messages[i].msg_hdr;
+        const size_t slot = (ringCursor_ + i) % ring_.size();
+        const size_t length = batch_->messages[i].msg_len;
+
+        if (header.msg_flags & MSG_TRUNC) {
+            stats_.invalidPackets++;  // Larger than a slot: not a video RTP packet
+            continue;
+        }
+
+        // GRO: equal-sized datagrams back to back, the last one possibly shorter
+        size_t segmentSize = length;
+        for (cmsghdr* control = CMSG_FIRSTHDR(&header); control;
+             control = CMSG_NXTHDR(const_cast<msghdr*>(&header), control)) {
+            if (control->cmsg_level == SOL_UDP && control->cmsg_type == UDP_GRO) {
+                int size = 0;
+                std::memcpy(&size, CMSG_DATA(control), sizeof(size));
+                if (size > 0) {
+                    segmentSize = static_cast<size_t>(size);
+                }
+            }
+        }
+
+        emitDatagrams(slot, length, segmentSize, receiveTime, packets, count);
+    }
+
+    ringCursor_ = (ringCursor_ + static_cast<size_t>(received)) % ring_.size();
+#else
+    for (size_t i = 0; i < batchEntries_; ++i) {
+        const size_t slot = ringCursor_;
+        uint8_t* buffer = writableSlot(slot);
+
+#ifdef _WIN32
+        const int received = recv(static_cast<SOCKET>(socket_), reinterpret_cast<char*>(buffer),
+                                  static_cast<int>(slotBytes_), 0);
+        if (received < 0) {
+            const int error = WSAGetLastError();
+            if (error == WSAEMSGSIZE) {
+                stats_.invalidPackets++;  // Larger than a slot: not a video RTP packet
+                continue;
+            }
+            if (error == WSAEWOULDBLOCK) {
+                break;
+            }
+            std::cerr << "RtpUdpReceiver: recv failed: " << error << std::endl;
+            return count > 0 ? count : -1;
+        }
+#else
+        const ssize_t received = recv(static_cast<int>(socket_), buffer, slotBytes_, MSG_DONTWAIT);
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) {
+                break;
+            }
+            std::cerr << "RtpUdpReceiver: recv failed: " << std::strerror(errno) << std::endl;
+            return count > 0 ? count : -1;
+        }
+#endif
+
+        stats_.syscalls++;
+        emitDatagrams(slot, static_cast<size_t>(received), static_cast<size_t>(received),
+                      nowMicros(), packets, count);
+        ringCursor_ = (ringCursor_ + 1) % ring_.size();
+    }
+#endif
+
+    return count;
+}
+
+uint8_t* RtpUdpReceiver::writableSlot(size_t slot) {
+    uint8_t* data = ring_[slot].mutableData();
+    if (data) {
+        return data;
+    }
+
+    // Still referenced downstream: leave that storage to its slices
+    stats_.ringMisses++;
+    ring_[slot] = PacketBuffer::allocate(slotBytes_);
+    return ring_[slot].mutableData();
+}
+
+void RtpUdpReceiver::emitDatagrams(size_t slot, size_t length, size_t segmentSize,
+                                   int64_t receiveTime, std::vector<RtpPacket>& packets, int& count) {
+    for (size_t offset = 0; offset < length; offset += segmentSize) {
+        const size_t size = std::min(segmentSize, length - offset);
+        stats_.bytesReceived += size;
+
+        RtpPacket packet;
+        if (!parseRtpPacket(ring_[slot].slice(offset, size), packet) ||
+            (config_.payloadType != 0 && packet.payloadType != config_.payloadType)) {
+            stats_.invalidPackets++;
+            continue;
+        }
+
+        packet.receiveTime = receiveTime;
+        packets.push_back(std::move(packet));
+        stats_.datagrams++;
+        count++;
+    }
+}
+
+bool RtpUdpReceiver::parseRtpPacket(const PacketBuffer& datagram, RtpPacket& packet) {
+    const size_t size = datagram.size();
+    if (size < 12) {
+        return false;  // Minimum RTP header size
+    }
+
+    const uint8_t* buf = datagram.data();
+    if (((buf[0] >> 6) & 0x03) != 2) {
+        return false;  // RTP version 2 only
+    }
+
+    const bool padding = (buf[0] & 0x20) != 0;
+    const bool extension = (buf[0] & 0x10) != 0;
+    const size_t csrcCount = buf[0] & 0x0F;
+
+    size_t headerSize = 12 + csrcCount * 4;
+    if (extension) {
+        if (size < headerSize + 4) {
+            return false;
+        }
+        const size_t extLength = (buf[headerSize + 2] << 8) | buf[headerSize + 3];
+        headerSize += 4 + extLength * 4;
+    }
+
+    size_t end = size;
+    if (padding) {
+        const size_t padLength = buf[size - 1];
+        if (padLength == 0 || headerSize + padLength > size) {
+            return false;
+        }
+        end -= padLength;
+    }
+
+    if (headerSize >= end) {
+        return false;  // Truncated, or no payload
+    }
+
+    packet.marker = (buf[1] & 0x80) != 0;
+    packet.payloadType = buf[1] & 0x7F;
+    packet.sequenceNumber = static_cast<uint16_t>((buf[2] << 8) | buf[3]);
+    packet.timestamp = (static_cast<uint32_t>(buf[4]) << 24) | (buf[5] << 16) | (buf[6] << 8) | buf[7];
+    packet.ssrc = (static_cast<uint32_t>(buf[8]) << 24) | (buf[9] << 16) | (buf[10] << 8) | buf[11];
+    packet.payload = datagram.slice(headerSize, end - headerSize);
+    return true;
+}
+
+} // namespace network
+} // namespace fluxvision
@@ -1,5 +1,7 @@
 #include "rtsp_client.h"
 #include "bitstream_parser.h"
+#include "h264_parser.h"
+#include "hevc_parser.h"
 #include <iostream>
 #include <chrono>
 #include <thread>
@@ -20,15 +22,42 @@ namespace {
             std::chrono::steady_clock::now().time_since_epoch()
         ).count();
     }
+
+    // Fast connect: nothing to probe when the SDP is complete
+    constexpr const char* kFastProbeSize = "32";          // FFmpeg's minimum
+    constexpr const char* kFastAnalyzeDuration = "0";
+
+    // ...and just enough probing when it isn't
+    constexpr int64_t kFallbackProbeSize = 512 * 1024;
+    constexpr int64_t kFallbackAnalyzeDurationUs = 1000000;
+
+    constexpr AVRational kMicroseconds = {1, 1000000};
+    constexpr AVRational kRtpVideoClock = {1, 90000};   // RFC 3551: video payloads
+
+    // Packet time in the given time base (demuxers stamp in their stream's own)
+    int64_t packetTime(const AVFormatContext* ctx, const AVPacket* packet, AVRational timeBase) {
+        const int64_t ts = packet->pts != AV_NOPTS_VALUE ? packet->pts : packet->dts;
+        if (ts == AV_NOPTS_VALUE || packet->stream_index < 0 ||
+            static_cast<unsigned int>(packet->stream_index) >= ctx->nb_streams) {
+            return 0;
+        }
+        return av_rescale_q(ts, ctx->streams[packet->stream_index]->time_base, timeBase);
+    }
 }
 
 RtspClient::RtspClient() {
     // Initialize FFmpeg network (thread-safe, can be called multiple times)
     avformat_network_init();
+
+    readPacket_ = av_packet_alloc();
 }
 
 RtspClient::~RtspClient() {
     disconnect();
+
+    if (readPacket_) {
+        av_packet_free(&readPacket_);
+    }
 }
 
 bool RtspClient::connect(const Config& config) {
@@ -40,25 +69,47 @@ bool RtspClient::connect(const Config& config) {
     }
 
     config_ = config;
+    reconnectScheduler_ = config.reconnectScheduler ? config.reconnectScheduler
+                                                    : &ReconnectScheduler::shared();
+    closing_ = false;
     state_ = ConnectionState::CONNECTING;
 
-    if (!openStream(config.url)) {
+    // Fall back to the main stream when no sub stream is configured
+    currentProfile_ = urlFor(config.initialProfile).empty() ? StreamProfile::MAIN
+                                                            : config.initialProfile;
+
+    if (!openStream(urlFor(currentProfile_))) {
         state_ = ConnectionState::ERROR;
         return false;
     }
 
     state_ = ConnectionState::CONNECTED;
-    startTime_ = getCurrentTimeMicros();
-    stats_ = NetworkStats{};
+    resetStats(getCurrentTimeMicros());
 
-    std::cout << "RtspClient: Connected to " << config.url << std::endl;
+    std::cout << "RtspClient: Connected to " << urlFor(currentProfile_) << std::endl;
     return true;
 }
 
 void RtspClient::disconnect() {
-    std::lock_guard<std::mutex> lock(mutex_);
+    // Abort a reconnect attempt, a pending profile switch and a read in flight
+    // first; their I/O gives up at once instead of at its deadline
+    aborting_ = true;
+
+    // From here on a failing read no longer schedules a reconnect
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closing_ = true;
+    }
 
+    cancelReconnect();
+    cancelSwitch();
     stopReceiving();
+
+    std::lock_guard<std::mutex> readLock(readMutex_);
+    aborting_ = false;
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
     closeStream();
 
     state_ = ConnectionState::DISCONNECTED;
@@ -66,6 +117,58 @@ void RtspClient::disconnect() {
 }
 
 bool RtspClient::openStream(const std::string& url) {
+    // A dead camera can't hang the thread: setup is aborted at the deadline
+    armDeadline(config_.timeoutMs);
+    formatCtx_ = openContext(url, deadlineInterrupt, this, &codecParams_, nullptr);
+    disarmDeadline();
+    if (!formatCtx_) {
+        return false;
+    }
+
+    // NAL headers are read per codec from here on
+    const CodecType codec = codecOf(codecParams_);
+    codec_ = codec;
+    bitstreamParser_.setCodec(codec);
+    assembler_.setCodec(codec);
+    return true;
+}
+
+CodecType RtspClient::codecOf(const AVCodecParameters* codecParams) {
+    if (!codecParams) {
+        return CodecType::UNKNOWN;
+    }
+    switch (codecParams->codec_id) {
+        case AV_CODEC_ID_H264: return CodecType::H264;
+        case AV_CODEC_ID_HEVC: return CodecType::H265;
+        default:               return CodecType::UNKNOWN;
+    }
+}
+
+void RtspClient::armDeadline(int timeoutMs) {
+    ioDeadlineUs_.store(getCurrentTimeMicros() + static_cast<int64_t>(timeoutMs) * 1000,
+                        std::memory_order_relaxed);
+}
+
+void RtspClient::armReadDeadline() {
+    armDeadline(config_.readTimeoutMs > 0 ? config_.readTimeoutMs : config_.timeoutMs);
+}
+
+void RtspClient::disarmDeadline() {
+    // Disarmed between operations so close still sends its TEARDOWN
+    ioDeadlineUs_.store(0, std::memory_order_relaxed);
+}
+
+int RtspClient::deadlineInterrupt(void* opaque) {
+    auto* self = static_cast<RtspClient*>(opaque);
+    if (self->aborting_.load(std::memory_order_relaxed)) {
+        return 1;
+    }
+    const int64_t deadline = self->ioDeadlineUs_.load(std::memory_order_relaxed);
+    return deadline != 0 && getCurrentTimeMicros() > deadline ? 1 : 0;
+}
+
+AVFormatContext* RtspClient::openContext(const std::string& url, int (*interrupt)(void*), void* opaque,
+                                         AVCodecParameters** codecParams, int* videoStream) {
     AVDictionary* options = nullptr;
 
     // Set RTSP options for low latency and reliability
@@ -83,60 +186,124 @@ bool RtspClient::openStream(const std::string& url) {
     // Set buffer size
     av_dict_set(&options, "buffer_size", std::to_string(config_.receiveBufferSize).c_str(), 0);
 
+    if (config_.fastConnect) {
+        av_dict_set(&options, "probesize", kFastProbeSize, 0);
+        av_dict_set(&options, "analyzeduration", kFastAnalyzeDuration, 0);
+    }
+
     // Open RTSP stream
-    formatCtx_ = avformat_alloc_context();
-    if (!formatCtx_) {
+    AVFormatContext* ctx = avformat_alloc_context();
+    if (!ctx) {
         std::cerr << "RtspClient: Failed to allocate format context" << std::endl;
         av_dict_free(&options);
-        return false;
+        return nullptr;
     }
 
-    // Set timeout callback to prevent infinite hangs
-    formatCtx_->interrupt_callback.callback = [](void*) -> int {
-        // TODO: Implement proper timeout logic
-        return 0;
-    };
+    ctx->interrupt_callback.callback = interrupt;
+    ctx->interrupt_callback.opaque = opaque;
 
-    int ret = avformat_open_input(&formatCtx_, url.c_str(), nullptr, &options);
+    int ret = avformat_open_input(&ctx, url.c_str(), nullptr, &options);
     av_dict_free(&options);
 
     if (ret < 0) {
         char errbuf[AV_ERROR_MAX_STRING_SIZE];
         av_strerror(ret, errbuf, sizeof(errbuf));
         std::cerr << "RtspClient: Failed to open stream: " << errbuf << std::endl;
-        avformat_free_context(formatCtx_);
-        formatCtx_ = nullptr;
-        return false;
+        avformat_free_context(ctx);
+        return nullptr;
     }
 
-    // Find stream information
-    ret = avformat_find_stream_info(formatCtx_, nullptr);
-    if (ret < 0) {
-        std::cerr << "RtspClient: Failed to find stream info" << std::endl;
-        closeStream();
-        return false;
+    if (config_.nonBlocking) {
+        ctx->flags |= AVFMT_FLAG_NONBLOCK;
+    }
+
+    // Fast connect: codec from the SDP, resolution from its SPS, no buffering of
+    // seconds of video before the first packet is delivered
+    if (!config_.fastConnect || !streamInfoFromSdp(ctx)) {
+        if (config_.fastConnect) {
+            // SDP without usable parameter sets: probe only until the SPS shows up
+            ctx->probesize = kFallbackProbeSize;
+            ctx->max_analyze_duration = kFallbackAnalyzeDurationUs;
+        }
+
+        // Find stream information
+        ret = avformat_find_stream_info(ctx, nullptr);
+        if (ret < 0) {
+            std::cerr << "RtspClient: Failed to find stream info" << std::endl;
+            avformat_close_input(&ctx);
+            return nullptr;
+        }
     }
 
     // Find video stream
-    for (unsigned int i = 0; i < formatCtx_->nb_streams; i++) {
-        if (formatCtx_->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
-            codecParams_ = formatCtx_->streams[i]->codecpar;
+    AVCodecParameters* params = nullptr;
+    for (unsigned int i = 0; i < ctx->nb_streams; i++) {
+        if (ctx->streams[i]->codecpar->codec_type == AVMEDIA_TYPE_VIDEO) {
+            params = ctx->streams[i]->codecpar;
+            if (videoStream) {
+                *videoStream = static_cast<int>(i);
+            }
             break;
         }
     }
 
-    if (!codecParams_) {
+    if (!params) {
         std::cerr << "RtspClient: No video stream found" << std::endl;
-        closeStream();
-        return false;
+        avformat_close_input(&ctx);
+        return nullptr;
     }
 
     // Log stream info
     std::cout << "RtspClient: Video stream found - "
-              << codecParams_->width << "x" << codecParams_->height
-              << " codec: " << avcodec_get_name(codecParams_->codec_id) << std::endl;
+              << params->width << "x" << params->height
+              << " codec: " << avcodec_get_name(params->codec_id) << std::endl;
 
-    return true;
+    *codecParams = params;
+    return ctx;
+}
+
+bool RtspClient::streamInfoFromSdp(AVFormatContext* ctx) {
+    for (unsigned int i = 0; i < ctx->nb_streams; i++) {
+        AVStream* stream = ctx->streams[i];
+        AVCodecParameters* params = stream->codecpar;
+        if (params->codec_type != AVMEDIA_TYPE_VIDEO) {
+            continue;
+        }
+
+        // Only H.264/H.265 parameter sets are parsed here; other codecs are probed
+        const CodecType codec = codecOf(params);
+        if (codec == CodecType::UNKNOWN) {
+            return false;
+        }
+
+        // sprop-parameter-sets, as FFmpeg put them into extradata
+        std::vector<NalUnit> nalUnits;
+        if (!extradataNalUnits(params, nalUnits)) {
+            return false;
+        }
+
+        for (const NalUnit& nal : nalUnits) {
+            SPSInfo sps;
+            const bool parsed = codec == CodecType::H265
+                ? nal.type == NalUnitType::HEVC_SPS &&
+                  HevcParser::extractSPS(nal.data.data(), nal.data.size(), sps)
+                : nal.type == NalUnitType::SPS &&
+                  H264Parser::extractSPS(nal.data.data(), nal.data.size(), sps);
+            if (!parsed || sps.width <= 0 || sps.height <= 0) {
+                continue;
+            }
+
+            params->width = sps.width;
+            params->height = sps.height;
+            if (sps.framerate > 0) {
+                stream->avg_frame_rate = AVRational{sps.framerate, 1};
+            }
+            return true;
+        }
+        return false;
+    }
+
+    return false;
 }
 
 void RtspClient::closeStream() {
@@ -145,22 +312,31 @@ void RtspClient::closeStream() {
         formatCtx_ = nullptr;
         codecParams_ = nullptr;
     }
+
+    // A partial picture from the old session must not be glued to the new one
+    assembler_.reset();
 }
 
 bool RtspClient::receivePacket(RtpPacket& packet) {
-    if (!formatCtx_ || state_ != ConnectionState::CONNECTED) {
+    if (state_ != ConnectionState::CONNECTED) {
         return false;
     }
 
-    AVPacket* avPacket = av_packet_alloc();
-    if (!avPacket) {
+    // Busy: a reconnect is swapping the session or disconnect() is closing it
+    std::unique_lock<std::mutex> readLock(readMutex_, std::try_to_lock);
+    if (!readLock.owns_lock() || !formatCtx_ || !readPacket_ || state_ != ConnectionState::CONNECTED) {
         return false;
     }
 
+    AVPacket* avPacket = readPacket_;
+
+    // Every read gives up at the deadline: FFmpeg's RTSP demuxer waits on its
+    // socket even in non-blocking mode
+    armReadDeadline();
     int ret = av_read_frame(formatCtx_, avPacket);
+    disarmDeadline();
     if (ret < 0) {
         if (ret == AVERROR(EAGAIN)) {
-            av_packet_free(&avPacket);
             return false;  // No packet available, try again
         }
 
@@ -169,21 +345,16 @@ bool RtspClient::receivePacket(RtpPacket& packet) {
         av_strerror(ret, errbuf, sizeof(errbuf));
         std::cerr << "RtspClient: Read error: " << errbuf << std::endl;
 
-        av_packet_free(&avPacket);
-
-        if (config_.autoReconnect) {
-            state_ = ConnectionState::RECONNECTING;
-            std::thread([this] { attemptReconnect(); }).detach();
-        } else {
+        if (!config_.autoReconnect || !scheduleReconnect()) {
             state_ = ConnectionState::ERROR;
         }
 
         return false;
     }
 
-    // Parse RTP packet
+    // Parse RTP packet (takes over the packet's buffer)
     bool success = parseRtpPacket(avPacket, packet);
-    av_packet_free(&avPacket);
+    av_packet_unref(avPacket);
 
     if (success) {
         updateStats(packet);
@@ -197,14 +368,13 @@ bool RtspClient::parseRtpPacket(AVPacket* avPacket, RtpPacket& packet) {
         return false;
     }
 
-    // Copy payload data
-    packet.payload.resize(avPacket->size);
-    std::memcpy(packet.payload.data(), avPacket->data, avPacket->size);
-
-    // Set timestamps
-    packet.timestamp = static_cast<uint32_t>(avPacket->pts != AV_NOPTS_VALUE ? avPacket->pts : avPacket->dts);
+    // Set timestamps (before the packet is handed off); RtpPacket carries the RTP clock
+    packet.timestamp = static_cast<uint32_t>(packetTime(formatCtx_, avPacket, kRtpVideoClock));
     packet.receiveTime = getCurrentTimeMicros();
 
+    // Reference payload data (no copy)
+    packet.payload = PacketBuffer::fromPacket(avPacket);
+
     // RTP metadata (simplified - full RTP header parsing done in depacketizer)
     packet.sequenceNumber = ++lastSeqNumber_;
     packet.marker = (avPacket->flags & AV_PKT_FLAG_KEY) != 0;
@@ -213,102 +383,174 @@ bool RtspClient::parseRtpPacket(AVPacket* avPacket, RtpPacket& packet) {
 }
 
 int RtspClient::receiveNalUnits(std::vector<NalUnit>& nalUnits) {
-    if (!formatCtx_ || state_ != ConnectionState::CONNECTED) {
+    if (readNalUnits(nalUnits) != ReadStatus::OK) {
         return 0;
     }
+    return static_cast<int>(nalUnits.size());
+}
 
+RtspClient::ReadStatus RtspClient::readNalUnits(std::vector<NalUnit>& nalUnits) {
     nalUnits.clear();
 
-    AVPacket* avPacket = av_packet_alloc();
-    if (!avPacket) {
-        return 0;
+    std::unique_lock<std::mutex> readLock;
+    const ReadStatus status = lockRead(readLock);
+    if (status != ReadStatus::OK) {
+        return status;
     }
+    return readLockedNalUnits(nalUnits);
+}
 
+RtspClient::ReadStatus RtspClient::lockRead(std::unique_lock<std::mutex>& readLock) {
+    if (state_ == ConnectionState::RECONNECTING || state_ == ConnectionState::CONNECTING) {
+        return ReadStatus::WOULD_BLOCK;
+    }
+
+    // Never waits: the session is only held by a reconnect swapping it or by
+    // disconnect() closing it, and the state says which once they are done
+    readLock = std::unique_lock<std::mutex>(readMutex_, std::try_to_lock);
+    if (!readLock.owns_lock()) {
+        return ReadStatus::WOULD_BLOCK;
+    }
+
+    const ConnectionState state = state_;
+    if (state == ConnectionState::RECONNECTING || state == ConnectionState::CONNECTING) {
+        return ReadStatus::WOULD_BLOCK;
+    }
+    if (!formatCtx_ || state != ConnectionState::CONNECTED) {
+        return ReadStatus::CLOSED;
+    }
+    return ReadStatus::OK;
+}
+
+RtspClient::ReadStatus RtspClient::readLockedNalUnits(std::vector<NalUnit>& nalUnits) {
+    nalUnits.clear();
+
+    if (!readPacket_) {
+        return ReadStatus::CLOSED;
+    }
+
+    // Make-before-break: the standby session takes over at its first keyframe
+    if (standbyReady_.load(std::memory_order_acquire) && pollStandby(nalUnits)) {
+        return ReadStatus::OK;
+    }
+
+    AVPacket* avPacket = readPacket_;
+
+    // Every read gives up at the deadline: FFmpeg's RTSP demuxer waits on its
+    // socket even in non-blocking mode
+    armReadDeadline();
     int ret = av_read_frame(formatCtx_, avPacket);
+    disarmDeadline();
     if (ret < 0) {
-        av_packet_free(&avPacket);
+        if (ret == AVERROR(EAGAIN)) {
+            return ReadStatus::WOULD_BLOCK;
+        }
 
-        if (ret != AVERROR(EAGAIN)) {
-            // Connection error
-            char errbuf[AV_ERROR_MAX_STRING_SIZE];
-            av_strerror(ret, errbuf, sizeof(errbuf));
-            std::cerr << "RtspClient: Read error: " << errbuf << std::endl;
+        // Connection error
+        char errbuf[AV_ERROR_MAX_STRING_SIZE];
+        av_strerror(ret, errbuf, sizeof(errbuf));
+        std::cerr << "RtspClient: Read error: " << errbuf << std::endl;
 
-            if (config_.autoReconnect) {
-                state_ = ConnectionState::RECONNECTING;
-                std::thread([this] { attemptReconnect(); }).detach();
-            } else {
-                state_ = ConnectionState::ERROR;
-            }
+        if (config_.autoReconnect && scheduleReconnect()) {
+            return ReadStatus::WOULD_BLOCK;
         }
 
-        return 0;
+        state_ = ConnectionState::ERROR;
+        return ReadStatus::CLOSED;
     }
 
-    // FFmpeg gives us H.264 bitstream (already RTP-depacketized)
-    // Parse it into individual NAL units
-    BitstreamParser parser;
-    int nalCount = parser.parsePacket(avPacket->data, avPacket->size,
-                                      avPacket->pts != AV_NOPTS_VALUE ? avPacket->pts : avPacket->dts);
+    parseReadPacket(nalUnits);
+    return ReadStatus::OK;
+}
+
+void RtspClient::parseReadPacket(std::vector<NalUnit>& nalUnits) {
+    AVPacket* avPacket = readPacket_;
+
+    // NAL units and access units are stamped in microseconds (types.h)
+    const int64_t timestamp = packetTime(formatCtx_, avPacket, kMicroseconds);
+    const size_t packetSize = static_cast<size_t>(avPacket->size);
+
+    // FFmpeg gives us an H.264/H.265 bitstream (already RTP-depacketized)
+    // Take over its buffer and parse it into NAL unit slices (no copies)
+    bitstreamParser_.parsePacket(PacketBuffer::fromPacket(avPacket), timestamp);
 
-    // Extract all NAL units
+    // Extract all NAL units, stamped with the time the packet was read
+    const int64_t now = getCurrentTimeMicros();
     NalUnit nal;
-    while (parser.getNalUnit(nal)) {
+    while (bitstreamParser_.getNalUnit(nal)) {
+        nal.receiveTime = now;
         nalUnits.push_back(std::move(nal));
     }
 
     // Update stats (simplified - count bytes)
-    stats_.packetsReceived++;
-    stats_.bytesReceived += avPacket->size;
-
-    int64_t now = getCurrentTimeMicros();
-    if (lastPacketTime_ > 0) {
-        int64_t timeDiff = now - lastPacketTime_;
-        if (timeDiff > 0) {
-            double bitsPerSecond = (avPacket->size * 8.0) / (timeDiff / 1000000.0);
-            stats_.bitrate = stats_.bitrate * 0.9 + (bitsPerSecond / 1000000.0) * 0.1;
-        }
-    }
-    lastPacketTime_ = now;
-    stats_.uptime = (now - startTime_) / 1000000;
+    addPacketStats(packetSize, now);
+}
 
-    av_packet_free(&avPacket);
+RtspClient::ReadStatus RtspClient::readAccessUnits(std::vector<AccessUnit>& accessUnits) {
+    accessUnits.clear();
 
-    return nalCount;
-}
+    // The assembler belongs to the session: held until its pictures are out
+    std::unique_lock<std::mutex> readLock;
+    ReadStatus status = lockRead(readLock);
+    if (status == ReadStatus::OK) {
+        status = readLockedNalUnits(nalScratch_);
+    }
+    if (status != ReadStatus::OK) {
+        return status;
+    }
 
-void RtspClient::updateStats(const RtpPacket& packet) {
-    stats_.packetsReceived++;
-    stats_.bytesReceived += packet.payload.size();
+    for (auto& nal : nalScratch_) {
+        assembler_.push(std::move(nal));
+    }
 
-    int64_t now = getCurrentTimeMicros();
+    // FFmpeg's RTSP demuxer delivers whole pictures per packet
+    assembler_.endOfPacket();
 
-    // Calculate bitrate (rolling average over last second)
-    if (lastPacketTime_ > 0) {
-        int64_t timeDiff = now - lastPacketTime_;
-        if (timeDiff > 0) {
-            double bitsPerSecond = (packet.payload.size() * 8.0) / (timeDiff / 1000000.0);
-            stats_.bitrate = stats_.bitrate * 0.9 + (bitsPerSecond / 1000000.0) * 0.1;  // Mbps
-        }
+    AccessUnit au;
+    while (assembler_.pop(au)) {
+        accessUnits.push_back(std::move(au));
     }
 
-    lastPacketTime_ = now;
+    return ReadStatus::OK;
+}
 
-    // Calculate uptime
-    stats_.uptime = (now - startTime_) / 1000000;  // seconds
+void RtspClient::updateStats(const RtpPacket& packet) {
+    addPacketStats(packet.payload.size(), getCurrentTimeMicros());
 
     // Packet loss detection (simplified)
     if (lastSeqNumber_ > 0) {
         uint16_t expected = lastSeqNumber_ + 1;
         if (packet.sequenceNumber != expected && packet.sequenceNumber > expected) {
-            stats_.packetsLost += (packet.sequenceNumber - expected);
+            stats_.packetsLost.fetch_add(packet.sequenceNumber - expected, std::memory_order_relaxed);
         }
     }
+}
 
-    if (stats_.packetsReceived > 0) {
-        stats_.packetLossRate = static_cast<double>(stats_.packetsLost) /
-                               (stats_.packetsReceived + stats_.packetsLost) * 100.0;
+void RtspClient::resetStats(int64_t now) {
+    stats_.packetsReceived.store(0, std::memory_order_relaxed);
+    stats_.packetsLost.store(0, std::memory_order_relaxed);
+    stats_.bytesReceived.store(0, std::memory_order_relaxed);
+    stats_.bitrate.store(0.0, std::memory_order_relaxed);
+    stats_.reconnectCount.store(0, std::memory_order_relaxed);
+    stats_.startTime.store(now, std::memory_order_relaxed);
+}
+
+void RtspClient::addPacketStats(size_t bytes, int64_t now) {
+    stats_.packetsReceived.fetch_add(1, std::memory_order_relaxed);
+    stats_.bytesReceived.fetch_add(bytes, std::memory_order_relaxed);
+
+    // Calculate bitrate (rolling average over last second); the reader is its only writer
+    if (lastPacketTime_ > 0) {
+        int64_t timeDiff = now - lastPacketTime_;
+        if (timeDiff > 0) {
+            double bitsPerSecond = (bytes * 8.0) / (timeDiff / 1000000.0);
+            const double bitrate = stats_.bitrate.load(std::memory_order_relaxed);
+            stats_.bitrate.store(bitrate * 0.9 + (bitsPerSecond / 1000000.0) * 0.1,  // Mbps
+                                 std::memory_order_relaxed);
+        }
     }
+
+    lastPacketTime_ = now;
 }
 
 bool RtspClient::startReceiving(PacketCallback callback) {
@@ -348,20 +590,223 @@ void RtspClient::stopReceiving() {
 }
 
 bool RtspClient::switchToMainStream() {
-    // TODO: Implement stream switching by reconnecting with different URL
-    std::cerr << "RtspClient: Stream switching not yet implemented" << std::endl;
-    return false;
+    return beginSwitch(StreamProfile::MAIN);
 }
 
 bool RtspClient::switchToSubStream() {
-    // TODO: Implement stream switching
-    std::cerr << "RtspClient: Stream switching not yet implemented" << std::endl;
+    return beginSwitch(StreamProfile::SUB);
+}
+
+bool RtspClient::isSwitching() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return switchInProgress_;
+}
+
+const std::string& RtspClient::urlFor(StreamProfile profile) const {
+    static const std::string kNone;
+
+    if (profile == StreamProfile::SUB) {
+        return (config_.enableSubStream && !config_.subStreamUrl.empty()) ? config_.subStreamUrl : kNone;
+    }
+
+    return config_.url;
+}
+
+bool RtspClient::beginSwitch(StreamProfile profile) {
+    std::lock_guard<std::mutex> switchLock(switchMutex_);
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!formatCtx_ || state_ == ConnectionState::DISCONNECTED) {
+        return false;
+    }
+
+    const std::string url = urlFor(profile);
+    if (url.empty()) {
+        std::cerr << "RtspClient: No sub stream URL configured" << std::endl;
+        return false;
+    }
+
+    if (switchInProgress_ && standbyProfile_ == profile) {
+        return true;  // Already on its way
+    }
+
+    // Supersede any pending switch (its opener aborts through the interrupt callback)
+    const uint64_t generation = ++switchGeneration_;
+    closeStandby();
+
+    if (profile == currentProfile_) {
+        lock.unlock();
+        if (switchThread_ && switchThread_->joinable()) {
+            switchThread_->join();
+        }
+        switchThread_.reset();
+        return true;  // Switched back before the other profile took over
+    }
+
+    standbyProfile_ = profile;
+    switchInProgress_ = true;
+    lock.unlock();
+
+    if (switchThread_ && switchThread_->joinable()) {
+        switchThread_->join();
+    }
+
+    // Opening takes seconds (RTSP handshake + stream probing): keep streaming meanwhile
+    switchThread_ = std::make_unique<std::thread>([this, url, generation] {
+        openStandby(url, generation);
+    });
+
+    return true;
+}
+
+void RtspClient::cancelSwitch() {
+    std::lock_guard<std::mutex> switchLock(switchMutex_);
+
+    switchGeneration_++;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        closeStandby();
+    }
+
+    if (switchThread_ && switchThread_->joinable()) {
+        switchThread_->join();
+    }
+    switchThread_.reset();
+}
+
+void RtspClient::openStandby(const std::string& url, uint64_t generation) {
+    // Abort the open as soon as a newer switch request (or disconnect) supersedes this one
+    // or the setup deadline passes
+    struct Interrupt {
+        RtspClient* client;
+        uint64_t generation;
+        int64_t deadlineUs;
+    } interrupt{this, generation, getCurrentTimeMicros() + static_cast<int64_t>(config_.timeoutMs) * 1000};
+
+    auto superseded = [](void* opaque) -> int {
+        auto* self = static_cast<Interrupt*>(opaque);
+        return self->client->switchGeneration_.load() != self->generation ||
+               getCurrentTimeMicros() > self->deadlineUs ? 1 : 0;
+    };
+
+    AVCodecParameters* codecParams = nullptr;
+    int videoStream = -1;
+    AVFormatContext* ctx = openContext(url, superseded, &interrupt, &codecParams, &videoStream);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (generation != switchGeneration_.load()) {
+        if (ctx) {
+            avformat_close_input(&ctx);
+        }
+        return;
+    }
+
+    if (!ctx) {
+        std::cerr << "RtspClient: Profile switch failed, staying on current stream" << std::endl;
+        switchInProgress_ = false;
+        return;
+    }
+
+    // Polled alongside the live session, so it must never block; the interrupt
+    // callback referenced this thread's stack and only guarded the open
+    ctx->flags |= AVFMT_FLAG_NONBLOCK;
+    ctx->interrupt_callback.callback = [](void*) -> int { return 0; };
+    ctx->interrupt_callback.opaque = nullptr;
+
+    standbyCtx_ = ctx;
+    standbyCodecParams_ = codecParams;
+    standbyVideoStream_ = videoStream;
+    standbyReady_.store(true, std::memory_order_release);
+}
+
+bool RtspClient::pollStandby(std::vector<NalUnit>& nalUnits) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!standbyCtx_) {
+        return false;
+    }
+
+    // Drain what the standby session has buffered, looking for its first keyframe
+    constexpr int kMaxStandbyReads = 8;
+
+    for (int i = 0; i < kMaxStandbyReads; ++i) {
+        int ret = av_read_frame(standbyCtx_, readPacket_);
+        if (ret == AVERROR(EAGAIN)) {
+            return false;
+        }
+
+        if (ret < 0) {
+            std::cerr << "RtspClient: Standby stream failed, staying on current stream" << std::endl;
+            closeStandby();
+            return false;
+        }
+
+        if (readPacket_->stream_index != standbyVideoStream_ ||
+            (readPacket_->flags & AV_PKT_FLAG_KEY) == 0) {
+            av_packet_unref(readPacket_);
+            continue;
+        }
+
+        // The decoder was created for one codec: profiles must share it
+        if (codecOf(standbyCodecParams_) != codec_.load()) {
+            std::cerr << "RtspClient: Profiles use different codecs, staying on current stream" << std::endl;
+            av_packet_unref(readPacket_);
+            closeStandby();
+            return false;
+        }
+
+        // Keyframe: make the standby session current, then break the old one
+        AVFormatContext* oldCtx = formatCtx_;
+        formatCtx_ = standbyCtx_;
+        codecParams_ = standbyCodecParams_;
+        currentProfile_ = standbyProfile_;
+
+        standbyCtx_ = nullptr;
+        standbyCodecParams_ = nullptr;
+        standbyVideoStream_ = -1;
+        standbyReady_.store(false, std::memory_order_relaxed);
+        switchInProgress_ = false;
+
+        if (!config_.nonBlocking) {
+            formatCtx_->flags &= ~AVFMT_FLAG_NONBLOCK;
+        }
+        formatCtx_->interrupt_callback.callback = deadlineInterrupt;
+        formatCtx_->interrupt_callback.opaque = this;
+
+        if (oldCtx) {
+            avformat_close_input(&oldCtx);
+        }
+
+        // A partial picture from the old session must not be glued to the new one
+        assembler_.reset();
+
+        // New parameter sets first: some cameras only send them in the SDP
+        extradataNalUnits(codecParams_, nalUnits);
+        parseReadPacket(nalUnits);
+
+        std::cout << "RtspClient: Switched to "
+                  << (currentProfile_ == StreamProfile::MAIN ? "main" : "sub") << " stream" << std::endl;
+        return true;
+    }
+
     return false;
 }
 
+void RtspClient::closeStandby() {
+    if (standbyCtx_) {
+        avformat_close_input(&standbyCtx_);
+        standbyCtx_ = nullptr;
+    }
+
+    standbyCodecParams_ = nullptr;
+    standbyVideoStream_ = -1;
+    standbyReady_.store(false, std::memory_order_relaxed);
+    switchInProgress_ = false;
+}
+
 ConnectionState RtspClient::getState() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return state_;
+    return state_.load();
 }
 
 bool RtspClient::getStreamInfo(int& width, int& height, int& framerate) const {
@@ -391,25 +836,30 @@ bool RtspClient::getExtradata(std::vector<NalUnit>& nalUnits) const {
     std::lock_guard<std::mutex> lock(mutex_);
 
     nalUnits.clear();
+    return extradataNalUnits(codecParams_, nalUnits);
+}
+
+bool RtspClient::extradataNalUnits(const AVCodecParameters* codecParams, std::vector<NalUnit>& nalUnits) {
+    // Appends to nalUnits
+    const size_t initialCount = nalUnits.size();
 
-    if (!codecParams_ || !codecParams_->extradata || codecParams_->extradata_size == 0) {
+    if (!codecParams || !codecParams->extradata || codecParams->extradata_size == 0) {
         return false;
     }
 
-    // H.264 extradata is in AVCDecoderConfigurationRecord format (ISO/IEC 14496-15)
-    // Parse it to extract SPS and PPS NAL units
-    const uint8_t* data = codecParams_->extradata;
-    int size = codecParams_->extradata_size;
+    const CodecType codec = codecOf(codecParams);
+    const uint8_t* data = codecParams->extradata;
+    int size = codecParams->extradata_size;
 
     if (size < 7) {
         return false;  // Too small to be valid
     }
 
-    // Check for AVCDecoderConfigurationRecord
+    // Check for AVCDecoderConfigurationRecord / HEVCDecoderConfigurationRecord
     if (data[0] != 1) {
-        // Not in avcC format, might be raw Annex B with start codes
+        // Not in avcC/hvcC format, might be raw Annex B with start codes
         // Try parsing as bitstream
-        BitstreamParser parser;
+        BitstreamParser parser(codec == CodecType::H265 ? CodecType::H265 : CodecType::H264);
         parser.parsePacket(data, size, 0);
 
         NalUnit nal;
@@ -417,10 +867,15 @@ bool RtspClient::getExtradata(std::vector<NalUnit>& nalUnits) const {
             nalUnits.push_back(std::move(nal));
         }
 
-        return !nalUnits.empty();
+        return nalUnits.size() > initialCount;
     }
 
-    // Parse AVCDecoderConfigurationRecord
+    if (codec == CodecType::H265) {
+        return hvccNalUnits(data, size, nalUnits);
+    }
+
+    // H.264 extradata is in AVCDecoderConfigurationRecord format (ISO/IEC 14496-15)
+    // Parse it to extract SPS and PPS NAL units
     int offset = 5;  // Skip configurationVersion, AVCProfileIndication, profile_compatibility, AVCLevelIndication, lengthSizeMinusOne
 
     // Number of SPS
@@ -434,23 +889,12 @@ bool RtspClient::getExtradata(std::vector<NalUnit>& nalUnits) const {
 
         if (offset + spsSize > size) break;
 
-        // Create NAL unit with start code
-        NalUnit sps;
-        sps.type = NalUnitType::SPS;
-        sps.isKeyframe = true;
-        sps.data.resize(spsSize + 4);
-        sps.data[0] = 0x00;
-        sps.data[1] = 0x00;
-        sps.data[2] = 0x00;
-        sps.data[3] = 0x01;
-        std::memcpy(sps.data.data() + 4, data + offset, spsSize);
-
-        nalUnits.push_back(std::move(sps));
+        nalUnits.push_back(parameterSetNalUnit(data + offset, spsSize, CodecType::H264, NalUnitType::SPS));
         offset += spsSize;
     }
 
     // Number of PPS
-    if (offset >= size) return !nalUnits.empty();
+    if (offset >= size) return nalUnits.size() > initialCount;
 
     int numPPS = data[offset++];
 
@@ -462,53 +906,145 @@ bool RtspClient::getExtradata(std::vector<NalUnit>& nalUnits) const {
 
         if (offset + ppsSize > size) break;
 
-        // Create NAL unit with start code
-        NalUnit pps;
-        pps.type = NalUnitType::PPS;
-        pps.isKeyframe = true;
-        pps.data.resize(ppsSize + 4);
-        pps.data[0] = 0x00;
-        pps.data[1] = 0x00;
-        pps.data[2] = 0x00;
-        pps.data[3] = 0x01;
-        std::memcpy(pps.data.data() + 4, data + offset, ppsSize);
-
-        nalUnits.push_back(std::move(pps));
+        nalUnits.push_back(parameterSetNalUnit(data + offset, ppsSize, CodecType::H264, NalUnitType::PPS));
         offset += ppsSize;
     }
 
-    return !nalUnits.empty();
+    return nalUnits.size() > initialCount;
+}
+
+bool RtspClient::hvccNalUnits(const uint8_t* data, int size, std::vector<NalUnit>& nalUnits) {
+    const size_t initialCount = nalUnits.size();
+
+    // HEVCDecoderConfigurationRecord (ISO/IEC 14496-15 8.3.3): 22 bytes of
+    // profile/format fields, then numOfArrays arrays of one NAL type each
+    if (size < 23) {
+        return false;
+    }
+
+    int offset = 22;
+    int numArrays = data[offset++];
+
+    for (int i = 0; i < numArrays; i++) {
+        if (offset + 3 > size) break;
+
+        const NalUnitType type = static_cast<NalUnitType>(data[offset] & 0x3F);  // array_completeness, reserved, NAL_unit_type
+        int numNalus = (data[offset + 1] << 8) | data[offset + 2];
+        offset += 3;
+
+        for (int j = 0; j < numNalus; j++) {
+            if (offset + 2 > size) break;
+
+            int nalSize = (data[offset] << 8) | data[offset + 1];
+            offset += 2;
+
+            if (offset + nalSize > size) break;
+
+            // VPS/SPS/PPS (SEI arrays are passed on as well)
+            nalUnits.push_back(parameterSetNalUnit(data + offset, nalSize, CodecType::H265, type));
+            offset += nalSize;
+        }
+    }
+
+    return nalUnits.size() > initialCount;
+}
+
+NalUnit RtspClient::parameterSetNalUnit(const uint8_t* data, int size, CodecType codec, NalUnitType type) {
+    // Create NAL unit with start code
+    NalUnit nal;
+    nal.type = type;
+    nal.codec = codec;
+    nal.isKeyframe = true;
+    nal.data = PacketBuffer::allocate(size + 4);
+    if (uint8_t* out = nal.data.mutableData()) {
+        out[0] = 0x00;
+        out[1] = 0x00;
+        out[2] = 0x00;
+        out[3] = 0x01;
+        std::memcpy(out + 4, data, size);
+    }
+    return nal;
 }
 
 NetworkStats RtspClient::getStats() const {
+    NetworkStats stats;
+    stats.packetsReceived = stats_.packetsReceived.load(std::memory_order_relaxed);
+    stats.packetsLost = stats_.packetsLost.load(std::memory_order_relaxed);
+    stats.bytesReceived = stats_.bytesReceived.load(std::memory_order_relaxed);
+    stats.bitrate = stats_.bitrate.load(std::memory_order_relaxed);
+    stats.reconnectCount = stats_.reconnectCount.load(std::memory_order_relaxed);
+
+    if (stats.packetsReceived > 0) {
+        stats.packetLossRate = static_cast<double>(stats.packetsLost) /
+                               (stats.packetsReceived + stats.packetsLost) * 100.0;
+    }
+
+    const int64_t startTime = stats_.startTime.load(std::memory_order_relaxed);
+    if (startTime > 0) {
+        stats.uptime = (getCurrentTimeMicros() - startTime) / 1000000;  // seconds
+    }
+    return stats;
+}
+
+bool RtspClient::scheduleReconnect() {
+    // Under mutex_ so disconnect() either sees the task to cancel or makes us refuse
     std::lock_guard<std::mutex> lock(mutex_);
-    return stats_;
+
+    if (closing_) {
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+
+    state_ = ConnectionState::RECONNECTING;
+    reconnectAttempts_ = 0;
+
+    // Retried with backoff on the shared scheduler, which also caps how many
+    // cameras connect at once
+    reconnectTask_ = reconnectScheduler_->schedule([this] { return attemptReconnect(); },
+                                                   config_.reconnectDelayMs);
+    return true;
+}
+
+void RtspClient::cancelReconnect() {
+    const ReconnectScheduler::TaskId task = reconnectTask_.exchange(0);
+    if (task != 0 && reconnectScheduler_) {
+        reconnectScheduler_->cancel(task);
+    }
 }
 
 bool RtspClient::attemptReconnect() {
-    for (int attempt = 0; attempt < config_.maxReconnectAttempts; attempt++) {
-        std::cout << "RtspClient: Reconnection attempt " << (attempt + 1)
-                  << "/" << config_.maxReconnectAttempts << std::endl;
+    // The reader backs off while the session is swapped (lockRead())
+    std::lock_guard<std::mutex> readLock(readMutex_);
+    std::lock_guard<std::mutex> lock(mutex_);
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(config_.reconnectDelayMs));
+    if (closing_ || state_ != ConnectionState::RECONNECTING) {
+        return true;  // Disconnected meanwhile
+    }
 
-        closeStream();
+    reconnectAttempts_++;
+    std::cout << "RtspClient: Reconnection attempt " << reconnectAttempts_;
+    if (config_.maxReconnectAttempts > 0) {
+        std::cout << "/" << config_.maxReconnectAttempts;
+    }
+    std::cout << std::endl;
 
-        if (openStream(config_.url)) {
-            std::lock_guard<std::mutex> lock(mutex_);
-            state_ = ConnectionState::CONNECTED;
-            stats_.reconnectCount++;
-            std::cout << "RtspClient: Reconnected successfully" << std::endl;
-            return true;
-        }
+    closeStream();
+
+    if (openStream(urlFor(currentProfile_))) {
+        state_ = ConnectionState::CONNECTED;
+        stats_.reconnectCount.fetch_add(1, std::memory_order_relaxed);
+        std::cout << "RtspClient: Reconnected successfully" << std::endl;
+        return true;
     }
 
-    std::cerr << "RtspClient: Reconnection failed after "
-              << config_.maxReconnectAttempts << " attempts" << std::endl;
+    if (config_.maxReconnectAttempts > 0 && reconnectAttempts_ >= config_.maxReconnectAttempts) {
+        std::cerr << "RtspClient: Reconnection failed after "
+                  << config_.maxReconnectAttempts << " attempts" << std::endl;
+        state_ = ConnectionState::ERROR;
+        return true;
+    }
 
-    std::lock_guard<std::mutex> lock(mutex_);
-    state_ = ConnectionState::ERROR;
-    return false;
+    return false;  // Back off and retry
 }
 
 } // namespace network
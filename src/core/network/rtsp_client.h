@@ -1,6 +1,10 @@
 #pragma once
 
 #include "types.h"
+#include "stream_source.h"
+#include "access_unit_assembler.h"
+#include "bitstream_parser.h"
+#include "reconnect_scheduler.h"
 #include <string>
 #include <memory>
 #include <functional>
@@ -25,29 +29,45 @@ namespace network {
  * Features:
  * - TCP transport (reliable, firewall-friendly)
  * - Dual-stream support (main + sub)
- * - Automatic reconnection
- * - Low overhead (single thread per camera)
+ * - Automatic reconnection (jittered backoff on the shared ReconnectScheduler)
+ * - Read from a pinned thread per camera (default), or polled on a shared
+ *   NetworkReactor thread's timer (nonBlocking) along with other cameras
+ *
+ * FFmpeg does not expose the RTSP socket, and its demuxer blocks on it even
+ * with AVFMT_FLAG_NONBLOCK, so no socket readiness can drive the reads. Every
+ * read is bounded by a deadline (readTimeoutMs) instead, which caps how long a
+ * stalled camera holds the thread. On a shared thread each of those waits
+ * delays every other camera of that thread.
  *
  * Thread-safety: All methods are thread-safe
  */
-class RtspClient {
+class RtspClient : public StreamSource {
 public:
     struct Config {
         std::string url;
         std::string username;
         std::string password;
         TransportType transport = TransportType::TCP;
-        int timeoutMs = 5000;
+        int timeoutMs = 5000;        // Deadline for session setup (and each read, see readTimeoutMs)
+        int readTimeoutMs = 0;       // Deadline for each read; expiry fails the session (0 = timeoutMs)
+        bool fastConnect = true;     // Stream info from the SDP and its SPS instead of probing
         bool enableSubStream = true;
+        std::string subStreamUrl;    // Low-resolution profile of the same camera (empty = main only)
+        StreamProfile initialProfile = StreamProfile::MAIN;
 
         // Reconnection settings
         bool autoReconnect = true;
-        int maxReconnectAttempts = 10;
-        int reconnectDelayMs = 3000;
+        int maxReconnectAttempts = 10;   // 0 = retry forever
+        int reconnectDelayMs = 3000;     // First retry; later ones back off (with jitter)
+        ReconnectScheduler* reconnectScheduler = nullptr;  // nullptr = ReconnectScheduler::shared()
 
         // Buffer settings
         int receiveBufferSize = 2 * 1024 * 1024;  // 2MB
         bool lowLatency = true;  // Minimize buffering
+
+        // Non-blocking reads (AVFMT_FLAG_NONBLOCK) for reactor-driven receive;
+        // RTSP reads still wait for the socket, up to readTimeoutMs
+        bool nonBlocking = false;
     };
 
     /**
@@ -57,7 +77,7 @@ public:
     using PacketCallback = std::function<bool(const RtpPacket& packet)>;
 
     RtspClient();
-    ~RtspClient();
+    ~RtspClient() override;
 
     // Disable copy
     RtspClient(const RtspClient&) = delete;
@@ -72,7 +92,7 @@ public:
     /**
      * Disconnect from camera
      */
-    void disconnect();
+    void disconnect() override;
 
     /**
      * Receive next RTP packet (blocking)
@@ -88,6 +108,20 @@ public:
      */
     int receiveNalUnits(std::vector<NalUnit>& nalUnits);
 
+    /**
+     * Read one packet and split it into NAL units
+     * Same as receiveNalUnits(), but distinguishes "no data yet" from failure so an
+     * event loop can decide when to service this client again.
+     */
+    ReadStatus readNalUnits(std::vector<NalUnit>& nalUnits);
+
+    /**
+     * Read one packet and group its NAL units into whole pictures
+     * Each AccessUnit is one contiguous Annex B buffer for a single decode call.
+     * An OK read may complete zero access units (e.g. parameter sets only).
+     */
+    ReadStatus readAccessUnits(std::vector<AccessUnit>& accessUnits) override;
+
     /**
      * Start receiving packets asynchronously with callback
      * Returns: true if started successfully
@@ -100,61 +134,146 @@ public:
     void stopReceiving();
 
     /**
-     * Switch between main and sub streams
+     * Switch between main and sub streams (make-before-break)
+     * The target profile is opened in the background while the current one keeps
+     * streaming; reads switch over at the target's first keyframe, its parameter
+     * sets first. Switching back before that cancels the pending switch.
+     * Returns: false if the profile is not configured or the client is not connected
+     */
+    bool switchToMainStream() override;
+    bool switchToSubStream() override;
+
+    /**
+     * Check if a profile switch is waiting for the target stream
      */
-    bool switchToMainStream();
-    bool switchToSubStream();
+    bool isSwitching() const override;
 
     /**
      * Get current connection state
      */
-    ConnectionState getState() const;
+    ConnectionState getState() const override;
 
     /**
      * Get stream information
      */
-    bool getStreamInfo(int& width, int& height, int& framerate) const;
+    bool getStreamInfo(int& width, int& height, int& framerate) const override;
 
     /**
-     * Extract SPS/PPS from codec extradata (from RTSP SDP)
-     * These are sent out-of-band during RTSP negotiation
-     * Returns: true if extradata contains SPS/PPS
+     * Video codec of the current stream (H264, H265, or UNKNOWN before connect)
+     */
+    CodecType getCodec() const override { return codec_.load(); }
+
+    /**
+     * Extract parameter sets from codec extradata (from RTSP SDP)
+     * These are sent out-of-band during RTSP negotiation: SPS/PPS from avcC,
+     * VPS/SPS/PPS from hvcC, or Annex B
+     * Returns: true if extradata contains parameter sets
      */
     bool getExtradata(std::vector<NalUnit>& nalUnits) const;
 
     /**
-     * Get network statistics
+     * Get network statistics (lock-free snapshot; counters may be mutually a packet apart)
      */
     NetworkStats getStats() const;
 
     /**
      * Get current profile
      */
-    StreamProfile getCurrentProfile() const { return currentProfile_; }
+    StreamProfile getCurrentProfile() const override { return currentProfile_; }
 
 private:
     bool openStream(const std::string& url);
     void closeStream();
+    AVFormatContext* openContext(const std::string& url, int (*interrupt)(void*), void* opaque,
+                                 AVCodecParameters** codecParams, int* videoStream);
+    ReadStatus lockRead(std::unique_lock<std::mutex>& readLock);  // OK: readMutex_ held, connected
+    ReadStatus readLockedNalUnits(std::vector<NalUnit>& nalUnits);
+    void parseReadPacket(std::vector<NalUnit>& nalUnits);
+    static bool streamInfoFromSdp(AVFormatContext* ctx);
+
+    // Interrupt deadline for the main session (0 = none)
+    void armDeadline(int timeoutMs);
+    void armReadDeadline();
+    void disarmDeadline();
+    static int deadlineInterrupt(void* opaque);
+    static bool extradataNalUnits(const AVCodecParameters* codecParams, std::vector<NalUnit>& nalUnits);
+    static bool hvccNalUnits(const uint8_t* data, int size, std::vector<NalUnit>& nalUnits);
+    static NalUnit parameterSetNalUnit(const uint8_t* data, int size, CodecType codec, NalUnitType type);
+    static CodecType codecOf(const AVCodecParameters* codecParams);
+
+    // Profile switching
+    const std::string& urlFor(StreamProfile profile) const;
+    bool beginSwitch(StreamProfile profile);
+    void cancelSwitch();
+    void openStandby(const std::string& url, uint64_t generation);
+    bool pollStandby(std::vector<NalUnit>& nalUnits);
+    void closeStandby();
     bool parseRtpPacket(AVPacket* avPacket, RtpPacket& packet);
     void updateStats(const RtpPacket& packet);
+    void resetStats(int64_t now);
+    void addPacketStats(size_t bytes, int64_t now);
 
     // Reconnection logic
-    bool attemptReconnect();
-    void reconnectLoop();
+    bool scheduleReconnect();   // Read path, after a connection error; false once disconnecting
+    void cancelReconnect();     // Waits for an attempt in flight
+    bool attemptReconnect();    // On a scheduler worker; true when done
 
     Config config_;
     AVFormatContext* formatCtx_ = nullptr;
     AVCodecParameters* codecParams_ = nullptr;
+    std::atomic<CodecType> codec_{CodecType::UNKNOWN};
+    std::atomic<int64_t> ioDeadlineUs_{0};
+    std::atomic<bool> aborting_{false};  // disconnect(): abort I/O in flight now
+    bool closing_ = false;               // disconnect() began: no more reconnects (mutex_)
+
+    // Pending reconnect (0 = none)
+    ReconnectScheduler* reconnectScheduler_ = nullptr;
+    std::atomic<ReconnectScheduler::TaskId> reconnectTask_{0};
+    int reconnectAttempts_ = 0;          // Reconnect task only
 
+    // The session (formatCtx_, assembler_) is held by the reader for a whole
+    // read, and by the reconnect task and disconnect() to replace or close it.
+    // Taken before mutex_.
+    std::mutex readMutex_;
     mutable std::mutex mutex_;
-    ConnectionState state_ = ConnectionState::DISCONNECTED;
+    std::atomic<ConnectionState> state_{ConnectionState::DISCONNECTED};
     StreamProfile currentProfile_ = StreamProfile::MAIN;
 
-    // Statistics
-    NetworkStats stats_;
-    int64_t lastPacketTime_ = 0;
+    // Statistics: written by the reader (reconnectCount by the reconnect task) and
+    // read by getStats() without a lock, so relaxed atomics, each on its own
+    struct Counters {
+        std::atomic<uint64_t> packetsReceived{0};
+        std::atomic<uint64_t> packetsLost{0};
+        std::atomic<uint64_t> bytesReceived{0};
+        std::atomic<double> bitrate{0.0};       // Mbps, smoothed
+        std::atomic<int> reconnectCount{0};
+        std::atomic<int64_t> startTime{0};      // Microseconds, at connect
+    };
+    Counters stats_;
+    int64_t lastPacketTime_ = 0;                 // Reader only
     uint16_t lastSeqNumber_ = 0;
-    int64_t startTime_ = 0;
+
+    // Reused for every av_read_frame (its buffer is handed off, never copied)
+    AVPacket* readPacket_ = nullptr;
+
+    // Per-read parsing state (reused across reads)
+    BitstreamParser bitstreamParser_;
+
+    // Access unit assembly (readAccessUnits)
+    AccessUnitAssembler assembler_;
+    std::vector<NalUnit> nalScratch_;
+
+    // Make-before-break profile switch: standby session guarded by mutex_,
+    // opened on switchThread_, read by the receive path until its first keyframe
+    std::mutex switchMutex_;           // Serializes switch requests (taken before mutex_)
+    std::unique_ptr<std::thread> switchThread_;
+    std::atomic<uint64_t> switchGeneration_{0};  // Bumped to supersede/abort an opening switch
+    std::atomic<bool> standbyReady_{false};
+    bool switchInProgress_ = false;
+    StreamProfile standbyProfile_ = StreamProfile::MAIN;
+    AVFormatContext* standbyCtx_ = nullptr;
+    AVCodecParameters* standbyCodecParams_ = nullptr;
+    int standbyVideoStream_ = -1;
 
     // Async receiving
     std::atomic<bool> receiving_{false};
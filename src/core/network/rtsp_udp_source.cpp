@@ -0,0 +1,829 @@
+// src/core/network/rtsp_udp_source.cpp
+#include "rtsp_udp_source.h"
+#include "h264_parser.h"
+#include "hevc_parser.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+
+extern "C" {
+#include <libavutil/base64.h>
+#include <libavutil/md5.h>
+}
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fluxvision {
+namespace network {
+
+namespace {
+    constexpr uint8_t kStartCode[] = {0, 0, 0, 1};
+    constexpr size_t kMaxPendingControlBytes = 64 * 1024;
+    constexpr int kEvenPortAttempts = 8;
+    constexpr int64_t kDefaultSessionTimeoutUs = 60000000;  // RFC 2326 12.37
+
+    int64_t nowMicros() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void closeSocket(intptr_t socket) {
+#ifdef _WIN32
+        closesocket(static_cast<SOCKET>(socket));
+#else
+        ::close(static_cast<int>(socket));
+#endif
+    }
+
+    bool lastErrorWouldBlock() {
+#ifdef _WIN32
+        const int error = WSAGetLastError();
+        return error == WSAEWOULDBLOCK || error == WSAEINPROGRESS;
+#else
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS || errno == EINTR;
+#endif
+    }
+
+    // Wait until the socket is readable (or writable); false on timeout or error
+    bool waitSocket(intptr_t socket, bool forWrite, int timeoutMs) {
+#ifdef _WIN32
+        WSAPOLLFD pfd{};
+        pfd.fd = static_cast<SOCKET>(socket);
+        pfd.events = forWrite ? POLLWRNORM : POLLRDNORM;
+        return WSAPoll(&pfd, 1, timeoutMs) > 0;
+#else
+        pollfd pfd{};
+        pfd.fd = static_cast<int>(socket);
+        pfd.events = forWrite ? POLLOUT : POLLIN;
+        int ret;
+        do {
+            ret = ::poll(&pfd, 1, timeoutMs);
+        } while (ret < 0 && errno == EINTR);
+        return ret > 0;
+#endif
+    }
+
+    int remainingMs(int64_t deadlineUs) {
+        return static_cast<int>(std::max<int64_t>(0, (deadlineUs - nowMicros()) / 1000));
+    }
+
+    bool startsWithNoCase(const std::string& text, size_t pos, const std::string& prefix) {
+        if (text.size() - pos < prefix.size()) {
+            return false;
+        }
+        for (size_t i = 0; i < prefix.size(); ++i) {
+            if (std::tolower(static_cast<unsigned char>(text[pos + i])) !=
+                std::tolower(static_cast<unsigned char>(prefix[i]))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::string trim(const std::string& text) {
+        const size_t first = text.find_first_not_of(" \t\r\n");
+        if (first == std::string::npos) {
+            return std::string();
+        }
+        const size_t last = text.find_last_not_of(" \t\r\n");
+        return text.substr(first, last - first + 1);
+    }
+
+    // Value of key="value" (or key=value) in an auth challenge
+    std::string challengeParam(const std::string& challenge, const std::string& key) {
+        size_t pos = 0;
+        while ((pos = challenge.find(key, pos)) != std::string::npos) {
+            const bool keyStart = pos == 0 || challenge[pos - 1] == ' ' || challenge[pos - 1] == ',';
+            size_t eq = pos + key.size();
+            while (eq < challenge.size() && challenge[eq] == ' ') {
+                ++eq;
+            }
+            if (!keyStart || eq >= challenge.size() || challenge[eq] != '=') {
+                pos += key.size();
+                continue;
+            }
+
+            size_t start = eq + 1;
+            if (start < challenge.size() && challenge[start] == '"') {
+                const size_t end = challenge.find('"', start + 1);
+                return challenge.substr(start + 1, end == std::string::npos ? std::string::npos : end - start - 1);
+            }
+            const size_t end = challenge.find(',', start);
+            return trim(challenge.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        }
+        return std::string();
+    }
+
+    std::string md5Hex(const std::string& text) {
+        uint8_t digest[16];
+        av_md5_sum(digest, reinterpret_cast<const uint8_t*>(text.data()), text.size());
+
+        static const char kHex[] = "0123456789abcdef";
+        std::string hex(32, '0');
+        for (int i = 0; i < 16; ++i) {
+            hex[2 * i] = kHex[digest[i] >> 4];
+            hex[2 * i + 1] = kHex[digest[i] & 0x0F];
+        }
+        return hex;
+    }
+
+    // Track or session control attribute resolved against the base URL (RFC 2326 C.1.1)
+    std::string resolveControl(const std::string& base, const std::string& control) {
+        if (control.empty() || control == "*") {
+            return base;
+        }
+        if (startsWithNoCase(control, 0, "rtsp://")) {
+            return control;
+        }
+        if (!base.empty() && base.back() == '/') {
+            return base + control;
+        }
+        return base + "/" + control;
+    }
+}
+
+std::string RtspUdpSource::Response::header(const std::string& name) const {
+    std::istringstream lines(headers);
+    std::string line;
+    while (std::getline(lines, line)) {
+        if (startsWithNoCase(line, 0, name) && line.size() > name.size() && line[name.size()] == ':') {
+            return trim(line.substr(name.size() + 1));
+        }
+    }
+    return std::string();
+}
+
+RtspUdpSource::~RtspUdpSource() {
+    disconnect();
+}
+
+bool RtspUdpSource::connect(const Config& config) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    teardown();
+
+    config_ = config;
+    state_ = ConnectionState::CONNECTING;
+    cseq_ = 0;
+    authenticate_ = false;
+    digest_ = false;
+    parameterSets_.clear();
+    parameterSetsSent_ = false;
+
+    // rtsp://[user:pass@]host[:port][/path]
+    if (!startsWithNoCase(config_.url, 0, "rtsp://")) {
+        std::cerr << "RtspUdpSource: not an rtsp:// URL: " << config_.url << std::endl;
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+
+    const size_t authorityStart = 7;
+    const size_t pathStart = config_.url.find('/', authorityStart);
+    std::string authority = config_.url.substr(authorityStart, pathStart == std::string::npos
+                                                               ? std::string::npos : pathStart - authorityStart);
+    const std::string path = pathStart == std::string::npos ? "/" : config_.url.substr(pathStart);
+
+    username_ = config_.username;
+    password_ = config_.password;
+    const size_t at = authority.rfind('@');
+    if (at != std::string::npos) {
+        const std::string userInfo = authority.substr(0, at);
+        authority = authority.substr(at + 1);
+        if (username_.empty()) {
+            const size_t colon = userInfo.find(':');
+            username_ = userInfo.substr(0, colon);
+            password_ = colon == std::string::npos ? std::string() : userInfo.substr(colon + 1);
+        }
+    }
+
+    const size_t colon = authority.rfind(':');
+    host_ = authority.substr(0, colon);
+    port_ = 554;
+    if (colon != std::string::npos) {
+        port_ = static_cast<uint16_t>(std::atoi(authority.c_str() + colon + 1));
+    }
+    requestUrl_ = "rtsp://" + authority + path;
+
+    if (!openControl()) {
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+
+    Response response;
+    if (!request("OPTIONS", requestUrl_, "", response)) {
+        teardown();
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+    getParameter_ = response.header("Public").find("GET_PARAMETER") != std::string::npos;
+
+    if (!request("DESCRIBE", requestUrl_, "Accept: application/sdp\r\n", response)) {
+        teardown();
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+
+    std::string base = response.header("Content-Base");
+    if (base.empty()) {
+        base = response.header("Content-Location");
+    }
+    if (base.empty()) {
+        base = requestUrl_;
+    }
+    if (!parseSdp(response.body, base)) {
+        teardown();
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+
+    // RTP on an even port, RTCP (not read) announced on the next one (RFC 3550 11)
+    RtpUdpIngest::Config ingestConfig = config_.ingest;
+    ingestConfig.codec = codec_.load();
+    bool opened = false;
+    for (int attempt = 0; attempt < kEvenPortAttempts && !opened; ++attempt) {
+        opened = ingest_.open(ingestConfig);
+        if (opened && ingestConfig.receiver.port == 0 && (ingest_.localPort() & 1) &&
+            attempt + 1 < kEvenPortAttempts) {
+            ingest_.close();
+            opened = false;
+        }
+        if (!opened && ingestConfig.receiver.port != 0) {
+            break;  // A fixed port either binds or doesn't
+        }
+    }
+    if (!opened) {
+        std::cerr << "RtspUdpSource: failed to open RTP socket for " << requestUrl_ << std::endl;
+        teardown();
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+
+    const uint16_t rtpPort = ingest_.localPort();
+    std::ostringstream transport;
+    transport << "Transport: RTP/AVP;unicast;client_port=" << rtpPort << "-" << (rtpPort + 1) << "\r\n";
+    if (!request("SETUP", controlUrl_, transport.str(), response)) {
+        teardown();
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+
+    // Session: <id>[;timeout=<seconds>]
+    const std::string sessionHeader = response.header("Session");
+    session_ = trim(sessionHeader.substr(0, sessionHeader.find(';')));
+    if (session_.empty()) {
+        std::cerr << "RtspUdpSource: SETUP reply without a session for " << requestUrl_ << std::endl;
+        teardown();
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+
+    int64_t sessionTimeoutUs = kDefaultSessionTimeoutUs;
+    const size_t timeoutPos = sessionHeader.find("timeout=");
+    if (timeoutPos != std::string::npos) {
+        const int seconds = std::atoi(sessionHeader.c_str() + timeoutPos + 8);
+        if (seconds > 0) {
+            sessionTimeoutUs = static_cast<int64_t>(seconds) * 1000000;
+        }
+    }
+    keepaliveIntervalUs_ = sessionTimeoutUs / 2;
+
+    if (!request("PLAY", sessionUrl_, "Range: npt=0.000-\r\n", response)) {
+        teardown();
+        state_ = ConnectionState::ERROR;
+        return false;
+    }
+
+    const int64_t now = nowMicros();
+    lastDataUs_ = now;
+    nextKeepaliveUs_ = now + keepaliveIntervalUs_;
+    rtpHandle_ = ingest_.nativeHandle();
+    state_ = ConnectionState::CONNECTED;
+
+    int width = 0;
+    int height = 0;
+    int framerate = 0;
+    getStreamInfo(width, height, framerate);
+    std::cout << "RtspUdpSource: " << requestUrl_ << " playing on RTP port " << rtpPort << " - "
+              << width << "x" << height << " codec: " << (codec_.load() == CodecType::H265 ? "hevc" : "h264")
+              << std::endl;
+    return true;
+}
+
+void RtspUdpSource::disconnect() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    teardown();
+    state_ = ConnectionState::DISCONNECTED;
+}
+
+StreamSource::ReadStatus RtspUdpSource::readAccessUnits(std::vector<AccessUnit>& accessUnits) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    accessUnits.clear();
+
+    if (state_.load() != ConnectionState::CONNECTED) {
+        return ReadStatus::CLOSED;
+    }
+
+    if (config_.blocking) {
+        // Pinned thread: wait for a datagram, but not past an open gap's deadline
+        int waitMs = kBlockingWaitMs;
+        const int64_t deadline = ingest_.nextDeadline();
+        if (deadline >= 0) {
+            waitMs = std::min(waitMs, remainingMs(deadline) + 1);
+        }
+        waitSocket(rtpHandle_.load(), false, waitMs);
+    }
+
+    const auto status = ingest_.readAccessUnits(accessUnits);
+    if (status == RtpUdpIngest::ReadStatus::CLOSED) {
+        return fail("RTP socket failed");
+    }
+
+    const int64_t now = nowMicros();
+    if (status == RtpUdpIngest::ReadStatus::OK) {
+        lastDataUs_ = now;
+    } else if (now - lastDataUs_ > static_cast<int64_t>(config_.timeoutMs) * 1000) {
+        return fail("no RTP received within the timeout");
+    }
+
+    if (!serviceControl(now)) {
+        return fail("control connection lost");
+    }
+
+    // Cameras that only signal parameter sets in the SDP: the decoder needs them once
+    if (!parameterSetsSent_ && !parameterSets_.empty()) {
+        for (AccessUnit& au : accessUnits) {
+            if (!au.isKeyframe) {
+                continue;
+            }
+            PacketBuffer joined = PacketBuffer::allocate(parameterSets_.size() + au.data.size());
+            std::memcpy(joined.mutableData(), parameterSets_.data(), parameterSets_.size());
+            std::memcpy(joined.mutableData() + parameterSets_.size(), au.data.data(), au.data.size());
+            au.data = std::move(joined);
+            parameterSetsSent_ = true;
+            break;
+        }
+    }
+
+    return status == RtpUdpIngest::ReadStatus::OK ? ReadStatus::OK : ReadStatus::WOULD_BLOCK;
+}
+
+bool RtspUdpSource::getStreamInfo(int& width, int& height, int& framerate) const {
+    std::lock_guard<std::mutex> lock(infoMutex_);
+    if (width_ <= 0 || height_ <= 0) {
+        return false;
+    }
+    width = width_;
+    height = height_;
+    framerate = framerate_;
+    return true;
+}
+
+RtpUdpIngest::Stats RtspUdpSource::getIngestStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return ingest_.getStats();
+}
+
+bool RtspUdpSource::openControl() {
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "RtspUdpSource: WSAStartup failed" << std::endl;
+        return false;
+    }
+#endif
+
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addresses = nullptr;
+    const std::string service = std::to_string(port_);
+    if (getaddrinfo(host_.c_str(), service.c_str(), &hints, &addresses) != 0 || !addresses) {
+        std::cerr << "RtspUdpSource: cannot resolve " << host_ << std::endl;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+
+#ifdef _WIN32
+    SOCKET fd = ::socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (fd == INVALID_SOCKET) {
+        freeaddrinfo(addresses);
+        WSACleanup();
+        return false;
+    }
+    u_long nonBlocking = 1;
+    ioctlsocket(fd, FIONBIO, &nonBlocking);
+#else
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+        std::cerr << "RtspUdpSource: socket() failed: " << std::strerror(errno) << std::endl;
+        freeaddrinfo(addresses);
+        return false;
+    }
+#endif
+    control_ = static_cast<intptr_t>(fd);
+
+    const int noDelay = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+    const int ret = ::connect(fd, addresses->ai_addr, static_cast<int>(addresses->ai_addrlen));
+    freeaddrinfo(addresses);
+
+    bool connected = ret == 0;
+    if (!connected && lastErrorWouldBlock() && waitSocket(control_, true, config_.timeoutMs)) {
+        int error = 0;
+        socklen_t size = sizeof(error);
+        connected = getsockopt(fd, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &size) == 0 &&
+                    error == 0;
+    }
+
+    if (!connected) {
+        std::cerr << "RtspUdpSource: cannot connect to " << host_ << ":" << port_ << std::endl;
+        closeControl();
+        return false;
+    }
+    return true;
+}
+
+void RtspUdpSource::closeControl() {
+    if (control_ < 0) {
+        return;
+    }
+
+    closeSocket(control_);
+    control_ = -1;
+    pending_.clear();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+}
+
+bool RtspUdpSource::request(const std::string& method, const std::string& uri,
+                            const std::string& extraHeaders, Response& response) {
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        if (!sendRequest(method, uri, extraHeaders) || !readResponse(response)) {
+            std::cerr << "RtspUdpSource: " << method << " " << uri << " got no reply" << std::endl;
+            return false;
+        }
+
+        // One retry with credentials once the camera has named its scheme
+        if (response.status == 401 && attempt == 0 && !username_.empty() && parseChallenge(response)) {
+            continue;
+        }
+        break;
+    }
+
+    if (response.status != 200) {
+        std::cerr << "RtspUdpSource: " << method << " " << uri << " failed with status "
+                  << response.status << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool RtspUdpSource::sendRequest(const std::string& method, const std::string& uri,
+                                const std::string& extraHeaders) {
+    if (control_ < 0) {
+        return false;
+    }
+
+    std::ostringstream message;
+    message << method << " " << uri << " RTSP/1.0\r\n"
+            << "CSeq: " << ++cseq_ << "\r\n"
+            << "User-Agent: FluxVision\r\n"
+            << authorization(method, uri);
+    if (!session_.empty()) {
+        message << "Session: " << session_ << "\r\n";
+    }
+    message << extraHeaders << "\r\n";
+
+    const std::string text = message.str();
+    const int64_t deadline = nowMicros() + static_cast<int64_t>(config_.timeoutMs) * 1000;
+    size_t sent = 0;
+    while (sent < text.size()) {
+#ifdef _WIN32
+        const int ret = ::send(static_cast<SOCKET>(control_), text.data() + sent,
+                               static_cast<int>(text.size() - sent), 0);
+#else
+        const ssize_t ret = ::send(static_cast<int>(control_), text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+#endif
+        if (ret > 0) {
+            sent += static_cast<size_t>(ret);
+        } else if (!lastErrorWouldBlock() || !waitSocket(control_, true, remainingMs(deadline))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool RtspUdpSource::readResponse(Response& response) {
+    const int64_t deadline = nowMicros() + static_cast<int64_t>(config_.timeoutMs) * 1000;
+    char buffer[4096];
+
+    while (true) {
+        const size_t headerEnd = pending_.find("\r\n\r\n");
+        if (headerEnd != std::string::npos) {
+            const std::string headers = pending_.substr(0, headerEnd + 2);
+            response = Response{};
+            response.headers = headers.substr(headers.find("\r\n") + 2);
+
+            const size_t length = static_cast<size_t>(std::max(0, std::atoi(response.header("Content-Length").c_str())));
+            const size_t messageEnd = headerEnd + 4 + length;
+            if (pending_.size() >= messageEnd) {
+                response.body = pending_.substr(headerEnd + 4, length);
+                pending_.erase(0, messageEnd);
+
+                // Requests from the camera (e.g. ANNOUNCE) are skipped; only replies count
+                if (headers.compare(0, 5, "RTSP/") == 0) {
+                    const size_t space = headers.find(' ');
+                    response.status = space == std::string::npos ? 0 : std::atoi(headers.c_str() + space + 1);
+                    return true;
+                }
+                continue;
+            }
+        }
+
+        if (pending_.size() > kMaxPendingControlBytes || !waitSocket(control_, false, remainingMs(deadline))) {
+            return false;
+        }
+
+#ifdef _WIN32
+        const int received = ::recv(static_cast<SOCKET>(control_), buffer, sizeof(buffer), 0);
+#else
+        const ssize_t received = ::recv(static_cast<int>(control_), buffer, sizeof(buffer), 0);
+#endif
+        if (received == 0 || (received < 0 && !lastErrorWouldBlock())) {
+            return false;
+        }
+        if (received > 0) {
+            pending_.append(buffer, static_cast<size_t>(received));
+        }
+    }
+}
+
+std::string RtspUdpSource::authorization(const std::string& method, const std::string& uri) const {
+    if (!authenticate_) {
+        return std::string();
+    }
+
+    if (digest_) {
+        // RFC 2069 digest, as RTSP cameras issue it (no qop)
+        const std::string ha1 = md5Hex(username_ + ":" + realm_ + ":" + password_);
+        const std::string ha2 = md5Hex(method + ":" + uri);
+        const std::string response = md5Hex(ha1 + ":" + nonce_ + ":" + ha2);
+        return "Authorization: Digest username=\"" + username_ + "\", realm=\"" + realm_ +
+               "\", nonce=\"" + nonce_ + "\", uri=\"" + uri + "\", response=\"" + response + "\"\r\n";
+    }
+
+    const std::string credentials = username_ + ":" + password_;
+    std::string encoded(AV_BASE64_SIZE(credentials.size()), '\0');
+    av_base64_encode(&encoded[0], static_cast<int>(encoded.size()),
+                     reinterpret_cast<const uint8_t*>(credentials.data()), static_cast<int>(credentials.size()));
+    encoded.resize(std::strlen(encoded.c_str()));
+    return "Authorization: Basic " + encoded + "\r\n";
+}
+
+bool RtspUdpSource::parseChallenge(const Response& response) {
+    // Several WWW-Authenticate headers may be offered: Digest wins over Basic
+    std::istringstream lines(response.headers);
+    std::string line;
+    const std::string name = "WWW-Authenticate:";
+    bool basic = false;
+
+    while (std::getline(lines, line)) {
+        if (!startsWithNoCase(line, 0, name)) {
+            continue;
+        }
+        const std::string challenge = trim(line.substr(name.size()));
+        if (startsWithNoCase(challenge, 0, "Digest")) {
+            realm_ = challengeParam(challenge, "realm");
+            nonce_ = challengeParam(challenge, "nonce");
+            digest_ = !nonce_.empty();
+            authenticate_ = digest_;
+            if (digest_) {
+                return true;
+            }
+        } else if (startsWithNoCase(challenge, 0, "Basic")) {
+            basic = true;
+        }
+    }
+
+    digest_ = false;
+    authenticate_ = basic;
+    return basic;
+}
+
+bool RtspUdpSource::serviceControl(int64_t nowUs) {
+    // Keepalive replies and anything else the camera sends are consumed unread
+    char buffer[2048];
+    while (true) {
+#ifdef _WIN32
+        const int received = ::recv(static_cast<SOCKET>(control_), buffer, sizeof(buffer), 0);
+#else
+        const ssize_t received = ::recv(static_cast<int>(control_), buffer, sizeof(buffer), MSG_DONTWAIT);
+#endif
+        if (received == 0) {
+            return false;  // Camera closed the connection: the session is gone with it
+        }
+        if (received < 0) {
+            if (!lastErrorWouldBlock()) {
+                return false;
+            }
+            break;
+        }
+    }
+
+    if (nowUs >= nextKeepaliveUs_) {
+        nextKeepaliveUs_ = nowUs + keepaliveIntervalUs_;
+        return sendRequest(getParameter_ ? "GET_PARAMETER" : "OPTIONS", sessionUrl_, "");
+    }
+    return true;
+}
+
+bool RtspUdpSource::parseSdp(const std::string& sdp, const std::string& base) {
+    std::istringstream lines(sdp);
+    std::string line;
+    std::string sessionControl;
+    std::string trackControl;
+    std::string payloadType;
+    std::vector<std::string> parameterSets;
+    bool inVideo = false;
+    bool haveVideo = false;
+    int fps = 0;
+    CodecType codec = CodecType::UNKNOWN;
+
+    while (std::getline(lines, line)) {
+        line = trim(line);
+        if (line.compare(0, 2, "m=") == 0) {
+            if (haveVideo) {
+                break;  // First video stream only
+            }
+            inVideo = line.compare(0, 8, "m=video ") == 0;
+            if (inVideo) {
+                haveVideo = true;
+                // m=video <port> RTP/AVP <payload type>
+                std::istringstream fields(line.substr(2));
+                std::string media, port, profile;
+                fields >> media >> port >> profile >> payloadType;
+            }
+            continue;
+        }
+
+        if (line.compare(0, 10, "a=control:") == 0) {
+            (inVideo ? trackControl : sessionControl) = line.substr(10);
+            continue;
+        }
+        if (!inVideo) {
+            continue;
+        }
+
+        if (line.compare(0, 9, "a=rtpmap:") == 0) {
+            // a=rtpmap:<pt> <encoding>/<clock rate>
+            const size_t space = line.find(' ');
+            if (space == std::string::npos || line.substr(9, space - 9) != payloadType) {
+                continue;
+            }
+            const std::string encoding = line.substr(space + 1);
+            if (startsWithNoCase(encoding, 0, "H264/")) {
+                codec = CodecType::H264;
+            } else if (startsWithNoCase(encoding, 0, "H265/") || startsWithNoCase(encoding, 0, "HEVC/")) {
+                codec = CodecType::H265;
+            }
+            const size_t slash = encoding.find('/');
+            const int clockRate = std::atoi(encoding.c_str() + slash + 1);
+            if (clockRate > 0) {
+                config_.ingest.clockRate = clockRate;
+            }
+        } else if (line.compare(0, 7, "a=fmtp:") == 0) {
+            // a=fmtp:<pt> key=value;key=value...
+            std::istringstream params(line.substr(line.find(' ') + 1));
+            std::string param;
+            while (std::getline(params, param, ';')) {
+                param = trim(param);
+                const size_t eq = param.find('=');
+                if (eq == std::string::npos) {
+                    continue;
+                }
+                const std::string key = param.substr(0, eq);
+                if (key == "sprop-parameter-sets" || key == "sprop-vps" ||
+                    key == "sprop-sps" || key == "sprop-pps") {
+                    std::istringstream sets(param.substr(eq + 1));
+                    std::string set;
+                    while (std::getline(sets, set, ',')) {
+                        parameterSets.push_back(set);
+                    }
+                }
+            }
+        } else if (line.compare(0, 12, "a=framerate:") == 0) {
+            fps = static_cast<int>(std::atof(line.c_str() + 12) + 0.5);
+        }
+    }
+
+    if (!haveVideo || codec == CodecType::UNKNOWN) {
+        std::cerr << "RtspUdpSource: no H.264/H.265 video in the SDP of " << requestUrl_ << std::endl;
+        return false;
+    }
+
+    codec_ = codec;
+    config_.ingest.receiver.payloadType = static_cast<uint8_t>(std::atoi(payloadType.c_str()));
+    {
+        std::lock_guard<std::mutex> lock(infoMutex_);
+        width_ = 0;
+        height_ = 0;
+        framerate_ = fps;
+    }
+
+    // sprop-vps/sps/pps (H.265) are listed in that order, as decoders want them
+    for (const std::string& set : parameterSets) {
+        addParameterSet(set);
+    }
+
+    int width = 0;
+    int height = 0;
+    int framerate = 0;
+    if (!getStreamInfo(width, height, framerate)) {
+        std::cerr << "RtspUdpSource: SDP of " << requestUrl_ << " has no usable SPS" << std::endl;
+        return false;
+    }
+
+    sessionUrl_ = resolveControl(base, sessionControl);
+    controlUrl_ = resolveControl(base, trackControl);
+    return true;
+}
+
+bool RtspUdpSource::addParameterSet(const std::string& base64) {
+    std::vector<uint8_t> nal(base64.size());
+    const int size = av_base64_decode(nal.data(), base64.c_str(), static_cast<int>(nal.size()));
+    if (size <= 0) {
+        return false;
+    }
+    nal.resize(static_cast<size_t>(size));
+
+    const size_t offset = parameterSets_.size();
+    parameterSets_.insert(parameterSets_.end(), kStartCode, kStartCode + sizeof(kStartCode));
+    parameterSets_.insert(parameterSets_.end(), nal.begin(), nal.end());
+
+    // Resolution (and frame rate, unless the SDP named one) from the SPS
+    const uint8_t* data = parameterSets_.data() + offset;
+    const size_t length = parameterSets_.size() - offset;
+    SPSInfo sps;
+    const bool parsed = codec_.load() == CodecType::H265
+        ? ((nal[0] >> 1) & 0x3F) == static_cast<uint8_t>(NalUnitType::HEVC_SPS) &&
+          HevcParser::extractSPS(data, length, sps)
+        : (nal[0] & 0x1F) == static_cast<uint8_t>(NalUnitType::SPS) &&
+          H264Parser::extractSPS(data, length, sps);
+
+    if (parsed && sps.width > 0 && sps.height > 0) {
+        std::lock_guard<std::mutex> lock(infoMutex_);
+        width_ = sps.width;
+        height_ = sps.height;
+        if (framerate_ <= 0) {
+            framerate_ = sps.framerate;
+        }
+    }
+    return true;
+}
+
+void RtspUdpSource::endSession() {
+    if (control_ >= 0 && !session_.empty()) {
+        // Best effort: the camera drops the session on its own timeout otherwise
+        sendRequest("TEARDOWN", sessionUrl_, "");
+    }
+
+    closeControl();
+    session_.clear();
+}
+
+void RtspUdpSource::teardown() {
+    endSession();
+    rtpHandle_ = -1;
+    ingest_.close();
+}
+
+StreamSource::ReadStatus RtspUdpSource::fail(const char* reason) {
+    std::cerr << "RtspUdpSource: " << reason << " for " << requestUrl_ << std::endl;
+
+    // The RTP socket stays open until disconnect(): it may still be registered
+    // with a reactor, which must not see its descriptor reused meanwhile
+    endSession();
+    state_ = ConnectionState::ERROR;
+    return ReadStatus::CLOSED;
+}
+
+} // namespace network
+} // namespace fluxvision
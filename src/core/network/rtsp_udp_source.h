@@ -0,0 +1,163 @@
+// src/core/network/rtsp_udp_source.h
+// RTSP session with RTP over UDP, received by the native RtpUdpIngest path
+#pragma once
+
+#include "types.h"
+#include "stream_source.h"
+#include "rtp_udp_ingest.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fluxvision {
+namespace network {
+
+/**
+ * RTSP client that negotiates unicast RTP/UDP and receives it natively
+ *
+ * The RTSP control connection (OPTIONS, DESCRIBE, SETUP, PLAY, keepalives,
+ * TEARDOWN; Basic or Digest auth) is spoken here over TCP. The RTP it sets
+ * up is read by RtpUdpIngest: recvmmsg batches, jitter buffer, depacketizer
+ * and access unit assembly, without FFmpeg's demuxer in the way.
+ *
+ * Unlike RtspClient the UDP socket is exposed (nativeHandle()), so on a
+ * NetworkReactor the reads run on socket readiness rather than on a timer.
+ * Jitter gap deadlines, keepalives and the silence timeout are handled by
+ * whatever read comes next, so the reactor must also service the source
+ * without readiness every few milliseconds (NetworkReactor does).
+ *
+ * Codec, resolution and frame rate come from the SDP and its
+ * sprop-parameter-sets, which are also put in front of the first keyframe
+ * for cameras that only send them out of band. A session without them fails
+ * to connect.
+ *
+ * No reconnects of its own: a failed session reads CLOSED and the camera is
+ * reconnected by its owner. IPv4 only, single (main) profile.
+ *
+ * Thread-safety: All methods are thread-safe; reads are serialized
+ */
+class RtspUdpSource : public StreamSource {
+public:
+    struct Config {
+        std::string url;                // rtsp://[user:pass@]host[:port]/path
+        std::string username;           // Overrides credentials in the URL
+        std::string password;
+        int timeoutMs = 5000;           // Deadline for each setup request, and longest RTP silence
+        RtpUdpIngest::Config ingest;    // Port 0 = any free even port; payload type from the SDP
+
+        // Reads wait up to kBlockingWaitMs for a datagram (pinned thread);
+        // otherwise they return WOULD_BLOCK at once (reactor)
+        bool blocking = false;
+    };
+
+    RtspUdpSource() = default;
+    ~RtspUdpSource() override;
+
+    // Disable copy
+    RtspUdpSource(const RtspUdpSource&) = delete;
+    RtspUdpSource& operator=(const RtspUdpSource&) = delete;
+
+    /**
+     * Set up and start the session
+     * Returns: true once PLAY succeeded
+     */
+    bool connect(const Config& config);
+
+    /**
+     * Tear the session down; reads return CLOSED from here on
+     */
+    void disconnect() override;
+
+    /**
+     * Receive pending datagrams and return the access units they complete
+     * Also sends due keepalives and fails the session after timeoutMs of silence.
+     */
+    ReadStatus readAccessUnits(std::vector<AccessUnit>& accessUnits) override;
+
+    bool getStreamInfo(int& width, int& height, int& framerate) const override;
+    CodecType getCodec() const override { return codec_.load(); }
+    ConnectionState getState() const override { return state_.load(); }
+
+    /**
+     * RTP socket, for NetworkReactor::addSource (-1 when not connected)
+     */
+    intptr_t nativeHandle() const override { return rtpHandle_.load(); }
+
+    RtpUdpIngest::Stats getIngestStats() const;
+
+    static constexpr int kBlockingWaitMs = 100;
+
+private:
+    struct Response {
+        int status = 0;
+        std::string headers;            // Raw header block, one "Name: value" per line
+        std::string body;
+        std::string header(const std::string& name) const;
+    };
+
+    // RTSP control connection
+    bool openControl();
+    void closeControl();
+    bool request(const std::string& method, const std::string& uri,
+                 const std::string& extraHeaders, Response& response);
+    bool sendRequest(const std::string& method, const std::string& uri, const std::string& extraHeaders);
+    bool readResponse(Response& response);
+    std::string authorization(const std::string& method, const std::string& uri) const;
+    bool parseChallenge(const Response& response);
+    bool serviceControl(int64_t nowUs);   // Keepalives and unsolicited control data; false if lost
+
+    // Session description
+    bool parseSdp(const std::string& sdp, const std::string& base);
+    bool addParameterSet(const std::string& base64);
+
+    void endSession();                    // TEARDOWN and close the control connection
+    void teardown();                      // endSession() and close the RTP socket
+    ReadStatus fail(const char* reason);
+
+    Config config_;
+    mutable std::mutex mutex_;           // Held by reads, connect() and disconnect()
+    std::atomic<ConnectionState> state_{ConnectionState::DISCONNECTED};
+    std::atomic<CodecType> codec_{CodecType::UNKNOWN};
+    std::atomic<intptr_t> rtpHandle_{-1};
+    RtpUdpIngest ingest_;
+
+    // Control connection
+    intptr_t control_ = -1;
+    std::string host_;
+    uint16_t port_ = 554;
+    std::string requestUrl_;             // URL without the credentials
+    std::string controlUrl_;             // Track URL for SETUP
+    std::string sessionUrl_;             // Aggregate URL for PLAY, keepalives, TEARDOWN
+    std::string session_;
+    int cseq_ = 0;
+    std::string pending_;                // Control bytes received but not consumed yet
+
+    // Authentication (Digest when realm/nonce are set, else Basic)
+    std::string username_;
+    std::string password_;
+    bool authenticate_ = false;
+    bool digest_ = false;
+    std::string realm_;
+    std::string nonce_;
+
+    // Keepalive: GET_PARAMETER if the camera lists it, OPTIONS otherwise
+    bool getParameter_ = false;
+    int64_t keepaliveIntervalUs_ = 30000000;
+    int64_t nextKeepaliveUs_ = 0;
+    int64_t lastDataUs_ = 0;
+
+    // From the SDP (guarded by infoMutex_)
+    mutable std::mutex infoMutex_;
+    int width_ = 0;
+    int height_ = 0;
+    int framerate_ = 0;
+
+    // Annex B sprop parameter sets, put in front of the first keyframe (mutex_)
+    std::vector<uint8_t> parameterSets_;
+    bool parameterSetsSent_ = false;
+};
+
+} // namespace network
+} // namespace fluxvision
@@ -0,0 +1,235 @@
+#include "start_code_scanner.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define FLUXVISION_SCAN_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define FLUXVISION_SCAN_NEON 1
+#include <arm_neon.h>
+#endif
+
+// AVX2 code is compiled per function so the rest of the binary stays baseline x86-64
+#if defined(FLUXVISION_SCAN_X86) && (defined(__GNUC__) || defined(__clang__))
+#define FLUXVISION_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define FLUXVISION_TARGET_AVX2
+#endif
+
+namespace fluxvision {
+namespace network {
+
+namespace {
+
+using FindFn = const uint8_t* (*)(const uint8_t*, const uint8_t*);
+
+const uint8_t* findScalar(const uint8_t* begin, const uint8_t* end) {
+    if (end - begin < 3) {
+        return end;
+    }
+
+    const uint8_t* last = end - 2;
+    for (const uint8_t* p = begin; p < last; ++p) {
+        // Skip quickly: a start code needs data[2] == 1 and data[1] == 0
+        if (p[2] > 1) {
+            p += 2;
+        } else if (p[2] == 1 && p[1] == 0 && p[0] == 0) {
+            return p;
+        }
+    }
+
+    return end;
+}
+
+#if defined(FLUXVISION_SCAN_X86)
+
+// Bit i of the mask is set when p[i..i+2] == 00 00 01
+const uint8_t* findSse2(const uint8_t* begin, const uint8_t* end) {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one = _mm_set1_epi8(1);
+    const uint8_t* p = begin;
+
+    while (end - p >= 18) {
+        __m128i b0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i b1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 1));
+        __m128i b2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 2));
+
+        __m128i hit = _mm_and_si128(_mm_and_si128(_mm_cmpeq_epi8(b0, zero),
+                                                  _mm_cmpeq_epi8(b1, zero)),
+                                    _mm_cmpeq_epi8(b2, one));
+
+        unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(hit));
+        if (mask) {
+#if defined(_MSC_VER)
+            unsigned long bit;
+            _BitScanForward(&bit, mask);
+            return p + bit;
+#else
+            return p + __builtin_ctz(mask);
+#endif
+        }
+
+        p += 16;
+    }
+
+    return findScalar(p, end);
+}
+
+FLUXVISION_TARGET_AVX2
+const uint8_t* findAvx2(const uint8_t* begin, const uint8_t* end) {
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i one = _mm256_set1_epi8(1);
+    const uint8_t* p = begin;
+
+    while (end - p >= 34) {
+        __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i b1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 1));
+        __m256i b2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 2));
+
+        __m256i hit = _mm256_and_si256(_mm256_and_si256(_mm256_cmpeq_epi8(b0, zero),
+                                                        _mm256_cmpeq_epi8(b1, zero)),
+                                       _mm256_cmpeq_epi8(b2, one));
+
+        unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(hit));
+        if (mask) {
+#if defined(_MSC_VER)
+            unsigned long bit;
+            _BitScanForward(&bit, mask);
+            return p + bit;
+#else
+            return p + __builtin_ctz(mask);
+#endif
+        }
+
+        p += 32;
+    }
+
+    return findScalar(p, end);
+}
+
+bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4] = {0, 0, 0, 0};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // OS must save YMM state (OSXSAVE + XCR0 bits 1..2)
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // FLUXVISION_SCAN_X86
+
+#if defined(FLUXVISION_SCAN_NEON)
+
+const uint8_t* findNeon(const uint8_t* begin, const uint8_t* end) {
+    const uint8x16_t zero = vdupq_n_u8(0);
+    const uint8x16_t one = vdupq_n_u8(1);
+    const uint8_t* p = begin;
+
+    while (end - p >= 18) {
+        uint8x16_t b0 = vld1q_u8(p);
+        uint8x16_t b1 = vld1q_u8(p + 1);
+        uint8x16_t b2 = vld1q_u8(p + 2);
+
+        uint8x16_t hit = vandq_u8(vandq_u8(vceqq_u8(b0, zero), vceqq_u8(b1, zero)),
+                                  vceqq_u8(b2, one));
+
+        // Any lane set? Then locate it in the 16 candidates
+        if (vmaxvq_u8(hit)) {
+            return findScalar(p, p + 18);
+        }
+
+        p += 16;
+    }
+
+    return findScalar(p, end);
+}
+
+#endif // FLUXVISION_SCAN_NEON
+
+struct Implementation {
+    FindFn find;
+    const char* name;
+};
+
+Implementation selectImplementation() {
+#if defined(FLUXVISION_SCAN_X86)
+    if (cpuHasAvx2()) {
+        return {findAvx2, "avx2"};
+    }
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    return {findSse2, "sse2"};
+#endif
+#elif defined(FLUXVISION_SCAN_NEON)
+    return {findNeon, "neon"};
+#endif
+    return {findScalar, "scalar"};
+}
+
+const Implementation& implementation() {
+    static const Implementation impl = selectImplementation();
+    return impl;
+}
+
+} // anonymous namespace
+
+const uint8_t* StartCodeScanner::findNext(const uint8_t* begin, const uint8_t* end) {
+    if (!begin || begin >= end) {
+        return end;
+    }
+    return implementation().find(begin, end);
+}
+
+size_t StartCodeScanner::findAll(const uint8_t* data, size_t size, std::vector<size_t>& positions) {
+    positions.clear();
+
+    if (!data || size < 3) {
+        return 0;
+    }
+
+    const FindFn find = implementation().find;
+    const uint8_t* end = data + size;
+    const uint8_t* p = data;
+
+    while (true) {
+        const uint8_t* hit = find(p, end);
+        if (hit == end) {
+            break;
+        }
+
+        size_t pos = static_cast<size_t>(hit - data);
+
+        // Include the zero_byte of a 4-byte start code
+        if (hit > p && hit[-1] == 0x00) {
+            pos--;
+        }
+
+        positions.push_back(pos);
+        p = hit + 3;
+    }
+
+    return positions.size();
+}
+
+const char* StartCodeScanner::implementationName() {
+    return implementation().name;
+}
+
+} // namespace network
+} // namespace fluxvision
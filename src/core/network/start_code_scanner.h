@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fluxvision {
+namespace network {
+
+/**
+ * Annex B start code scanner (00 00 01 / 00 00 00 01)
+ *
+ * Vectorized search with a runtime-selected implementation:
+ * - AVX2 (32 bytes/iteration) or SSE2 (16 bytes/iteration) on x86-64
+ * - NEON on AArch64
+ * - Scalar fallback everywhere else
+ *
+ * The implementation is picked once per process from CPUID; all entry points
+ * are stateless and thread-safe.
+ */
+class StartCodeScanner {
+public:
+    /**
+     * Find all start codes in a buffer
+     * @param positions Caller-owned output, cleared and refilled (capacity reused).
+     *        Each entry is the offset of the first byte of a start code, including
+     *        the leading zero_byte of a 4-byte code.
+     * @return Number of start codes found
+     */
+    static size_t findAll(const uint8_t* data, size_t size, std::vector<size_t>& positions);
+
+    /**
+     * Find the next 3-byte start code pattern (00 00 01) in [begin, end)
+     * @return Pointer to its first byte, or end if there is none
+     */
+    static const uint8_t* findNext(const uint8_t* begin, const uint8_t* end);
+
+    /**
+     * Length of the start code at the very beginning of data
+     * @return 4 or 3 if data starts with a start code, else 0
+     */
+    static size_t prefixLength(const uint8_t* data, size_t size) {
+        if (size >= 4 && data[0] == 0x00 && data[1] == 0x00 &&
+            data[2] == 0x00 && data[3] == 0x01) {
+            return 4;
+        }
+        if (size >= 3 && data[0] == 0x00 && data[1] == 0x00 && data[2] == 0x01) {
+            return 3;
+        }
+        return 0;
+    }
+
+    /**
+     * Name of the implementation selected for this CPU ("avx2", "sse2", "neon", "scalar")
+     */
+    static const char* implementationName();
+};
+
+} // namespace network
+} // namespace fluxvision
@@ -0,0 +1,77 @@
+// src/core/network/stream_source.h
+// Abstract source of a camera's compressed pictures (RTSP client or a stand-in)
+#pragma once
+
+#include "types.h"
+#include <cstdint>
+#include <vector>
+
+namespace fluxvision {
+namespace network {
+
+/**
+ * Compressed stream source of one camera
+ *
+ * CameraStream reads whole access units from its source, whichever kind it
+ * is. RtspClient (RTP over TCP) and RtspUdpSource (RTP over UDP) are the
+ * production sources; tools supply their own (e.g. the pipeline benchmark's
+ * recorded-file replay) through CameraStream::Config::sourceFactory.
+ *
+ * Thread-safety: as RtspClient. Reads come from one thread at a time (the
+ * camera's reactor or pinned loop); the other methods may be called from any
+ * thread.
+ */
+class StreamSource {
+public:
+    /**
+     * Outcome of a single non-blocking read
+     */
+    enum class ReadStatus {
+        OK,            // Packet read (may contain zero parseable NAL units)
+        WOULD_BLOCK,   // No data available yet, or reconnect in progress
+        CLOSED         // Disconnected or failed permanently
+    };
+
+    virtual ~StreamSource() = default;
+
+    /**
+     * Stop streaming; reads return CLOSED from here on
+     */
+    virtual void disconnect() = 0;
+
+    /**
+     * Read one packet and group its NAL units into whole pictures
+     * Each AccessUnit is one contiguous Annex B buffer for a single decode call.
+     * An OK read may complete zero access units (e.g. parameter sets only).
+     */
+    virtual ReadStatus readAccessUnits(std::vector<AccessUnit>& accessUnits) = 0;
+
+    /**
+     * Resolution and frame rate of the current stream
+     */
+    virtual bool getStreamInfo(int& width, int& height, int& framerate) const = 0;
+
+    /**
+     * Video codec of the current stream (H264, H265, or UNKNOWN before connect)
+     */
+    virtual CodecType getCodec() const = 0;
+
+    virtual ConnectionState getState() const = 0;
+
+    /**
+     * Main/sub profile switching; sources with a single profile stay on MAIN
+     */
+    virtual StreamProfile getCurrentProfile() const { return StreamProfile::MAIN; }
+    virtual bool isSwitching() const { return false; }
+    virtual bool switchToMainStream() { return false; }
+    virtual bool switchToSubStream() { return false; }
+
+    /**
+     * Socket whose readiness means data to read, for NetworkReactor::addSource
+     * (-1 if the source does not expose one and must be polled)
+     */
+    virtual intptr_t nativeHandle() const { return -1; }
+};
+
+} // namespace network
+} // namespace fluxvision
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "../codec/packet_buffer.h"
+#include "../codec/types.h"
 #include <cstdint>
 #include <vector>
 #include <string>
@@ -28,6 +30,9 @@ enum class ConnectionState {
 
 /**
  * NAL unit types for H.264/H.265
+ *
+ * Values are the codec's own nal_unit_type (5 bits for H.264, 6 for H.265),
+ * so H.265 types below 24 alias H.264 ones: NalUnit::codec says which applies.
  */
 enum class NalUnitType : uint8_t {
     // H.264 NAL types
@@ -49,12 +54,24 @@ enum class NalUnitType : uint8_t {
     FU_A = 28,
     FU_B = 29,
 
-    // H.265 NAL types (for future support)
+    // H.265 NAL types: VCL 0-31, IRAP (keyframes) 16-23
+    HEVC_BLA_W_LP = 16,
+    HEVC_BLA_W_RADL = 17,
+    HEVC_BLA_N_LP = 18,
+    HEVC_IDR_W_RADL = 19,
+    HEVC_IDR_N_LP = 20,
+    HEVC_CRA = 21,
     HEVC_VPS = 32,      // Video parameter set
     HEVC_SPS = 33,
     HEVC_PPS = 34,
-    HEVC_IDR_W_RADL = 19,
-    HEVC_IDR_N_LP = 20
+    HEVC_AUD = 35,
+    HEVC_EOS = 36,
+    HEVC_PREFIX_SEI = 39,
+    HEVC_SUFFIX_SEI = 40,
+
+    // H.265 RTP payload structures (RFC 7798)
+    HEVC_AP = 48,       // Aggregation packet
+    HEVC_FU = 49        // Fragmentation unit
 };
 
 /**
@@ -75,7 +92,7 @@ struct RtpPacket {
     uint8_t payloadType = 0;
     bool marker = false;
 
-    std::vector<uint8_t> payload;
+    PacketBuffer payload;      // Shares the received packet's buffer
 
     // Metadata
     int64_t receiveTime = 0;  // microseconds
@@ -86,13 +103,15 @@ struct RtpPacket {
  */
 struct NalUnit {
     NalUnitType type = NalUnitType::UNSPECIFIED;
-    std::vector<uint8_t> data;
+    CodecType codec = CodecType::H264;  // Which codec's numbering type uses
+    PacketBuffer data;         // Slice of the source packet, start code included
 
     // Metadata
     int64_t pts = 0;           // Presentation timestamp (microseconds)
     int64_t dts = 0;           // Decode timestamp (microseconds)
     bool isKeyframe = false;
     StreamProfile profile = StreamProfile::MAIN;
+    int64_t receiveTime = 0;   // Steady clock (microseconds) the carrying packet was read
 
     // SPS/PPS info (if parsed)
     int width = 0;
@@ -100,6 +119,22 @@ struct NalUnit {
     int framerate = 0;
 };
 
+/**
+ * Access unit: all NAL units of one picture in one contiguous Annex B buffer
+ * (start codes kept), ready for a single decoder call
+ */
+struct AccessUnit {
+    PacketBuffer data;
+
+    // Metadata
+    int64_t pts = 0;           // Presentation timestamp (microseconds)
+    int64_t dts = 0;           // Decode timestamp (microseconds)
+    bool isKeyframe = false;   // Contains an IDR (H.265: IRAP) slice
+    bool isReference = false;  // A slice has nal_ref_idc != 0 (H.265: is not a *_N picture)
+    size_t nalCount = 0;       // NAL units grouped into this access unit
+    int64_t receiveTime = 0;   // Steady clock (microseconds) its first NAL unit was read
+};
+
 /**
  * SPS (Sequence Parameter Set) parsed information
  */
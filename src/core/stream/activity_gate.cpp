@@ -0,0 +1,58 @@
+// src/core/stream/activity_gate.cpp
+#include "activity_gate.h"
+#include "camera_stream.h"
+
+namespace fluxvision {
+namespace stream {
+
+ActivityGate::Config::Config()
+    : maxGatedQuality(StreamQuality::GRID_VIEW)
+{
+}
+
+ActivityGate::ActivityGate(const Config& config)
+    : config_(config)
+{
+}
+
+bool ActivityGate::shouldMeasure(Clock::time_point now) const {
+    if (!config_.enabled) {
+        return false;
+    }
+
+    // Gated: only keyframes are decoded, measure every one of them
+    return gated_.load() || !haveActivity_ || now - lastMeasured_ >= config_.measureInterval;
+}
+
+bool ActivityGate::eligible(StreamQuality requested) const {
+    return config_.enabled && requested != StreamQuality::PAUSED &&
+           static_cast<int>(requested) <= static_cast<int>(config_.maxGatedQuality);
+}
+
+bool ActivityGate::update(float activity, StreamQuality requested, Clock::time_point now) {
+    lastActivity_ = activity;
+
+    // The idle timer starts at the first measurement
+    if (!haveActivity_ || activity >= config_.threshold || !eligible(requested)) {
+        haveActivity_ = true;
+        lastActive_ = now;
+    }
+
+    const bool gated = eligible(requested) && now - lastActive_ >= config_.idleAfter;
+    if (gated && !gated_.load()) {
+        gatedCount_++;
+    }
+    gated_ = gated;
+    return gated;
+}
+
+bool ActivityGate::onRequestedQuality(StreamQuality requested, Clock::time_point now) {
+    if (!eligible(requested)) {
+        lastActive_ = now;
+        gated_ = false;
+    }
+    return gated_.load();
+}
+
+} // namespace stream
+} // namespace fluxvision
@@ -0,0 +1,78 @@
+// src/core/stream/activity_gate.h
+// Idle-scene policy: keyframe-only decode while nothing moves in front of the camera
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace fluxvision {
+namespace stream {
+
+enum class StreamQuality;
+
+// Decides from activity measurements (gpu::ActivityEstimator) whether a
+// camera's decode is gated down to PAUSED
+//
+// - A camera whose activity stayed below the threshold for idleAfter is gated:
+//   the decode consumer treats it as PAUSED (IDR pictures only) while its
+//   requested tier, network profile and admission reservation are kept.
+// - Gated cameras are still measured, on every keyframe. The first one above
+//   the threshold lifts the gate, and leaving PAUSED replays the GOP cache,
+//   so the camera is back at its requested tier within one GOP.
+// - Tiers above maxGatedQuality (someone is looking closely) and PAUSED
+//   cameras are never gated; going back under it restarts the idle timer.
+// - Without measurements (no frames, no estimator) a camera is never gated.
+//
+// Thread-safety: update()/shouldMeasure() from the camera's decode consumer
+// only; isGated() and the counters from any thread.
+class ActivityGate {
+public:
+    struct Config {
+        bool enabled = false;
+        float threshold = 0.02f;              // Fraction of grid cells changed that counts as activity
+        std::chrono::seconds idleAfter{10};   // Static this long before gating
+        std::chrono::milliseconds measureInterval{250};  // Spacing of measurements while not gated
+        StreamQuality maxGatedQuality;        // Highest tier that may be gated (GRID_VIEW)
+        int cellThreshold = 8;                // Passed to the estimator
+
+        Config();
+    };
+
+    using Clock = std::chrono::steady_clock;
+
+    explicit ActivityGate(const Config& config);
+
+    const Config& getConfig() const { return config_; }
+
+    // A frame decoded now should be measured
+    bool shouldMeasure(Clock::time_point now) const;
+    void onMeasured(Clock::time_point now) { lastMeasured_ = now; }
+
+    // Feed one measurement; requested is the camera's tier
+    // Returns: whether the camera is gated now
+    bool update(float activity, StreamQuality requested, Clock::time_point now);
+
+    // Tier changed without a measurement (may lift the gate)
+    // Returns: whether the camera is gated now
+    bool onRequestedQuality(StreamQuality requested, Clock::time_point now);
+
+    bool isGated() const { return gated_.load(); }
+    float lastActivity() const { return lastActivity_.load(); }
+    uint64_t gatedCount() const { return gatedCount_.load(); }   // Times the gate closed
+
+private:
+    Config config_;
+    bool eligible(StreamQuality requested) const;
+
+    Clock::time_point lastActive_;
+    Clock::time_point lastMeasured_;
+    bool haveActivity_ = false;
+
+    std::atomic<bool> gated_{false};
+    std::atomic<float> lastActivity_{0.0f};
+    std::atomic<uint64_t> gatedCount_{0};
+};
+
+} // namespace stream
+} // namespace fluxvision
@@ -0,0 +1,453 @@
+// src/core/stream/admission_controller.cpp
+#include "admission_controller.h"
+#include "../codec/cpu_decode_budget.h"
+#include <algorithm>
+
+namespace fluxvision {
+namespace stream {
+
+namespace {
+    constexpr double kReferencePixelRate = 1920.0 * 1080.0 * 30.0;  // One 1080p30 stream
+    constexpr int kDefaultFps = 30;
+    constexpr int kSubStreamWidth = 640;
+    constexpr int kSubStreamHeight = 360;
+    constexpr size_t kMinDecodeSurfaces = 8;      // Typical H.264 DPB plus one in flight
+    constexpr size_t kPitchAlignment = 512;
+
+    bool usesSubStream(StreamQuality quality) {
+        return quality == StreamQuality::PAUSED ||
+               quality == StreamQuality::THUMBNAIL ||
+               quality == StreamQuality::GRID_VIEW;
+    }
+
+    // Resolution decoded at a tier (low tiers run on the sub stream when there is one)
+    void decodedSize(const AdmissionController::StreamInfo& info, StreamQuality quality,
+                     int& width, int& height) {
+        if (info.hasSubStream && usesSubStream(quality)) {
+            width = kSubStreamWidth;
+            height = kSubStreamHeight;
+        } else {
+            width = info.width > 0 ? info.width : 1920;
+            height = info.height > 0 ? info.height : 1080;
+        }
+    }
+
+    StreamQuality lowerTier(StreamQuality quality) {
+        return static_cast<StreamQuality>(static_cast<int>(quality) - 1);
+    }
+}
+
+AdmissionController::AdmissionController(const Config& config, gpu::GPUMemoryPool* memoryPool)
+    : AdmissionController(config, std::vector<gpu::GPUMemoryPool*>{memoryPool})
+{
+}
+
+AdmissionController::AdmissionController(const Config& config,
+                                         const std::vector<gpu::GPUMemoryPool*>& devices)
+    : config_(config)
+{
+    // CPU fallback capacity tracks the cores the decode budget may use
+    if (config_.cpuCapacity < 0.0) {
+        config_.cpuCapacity = CpuDecodeBudget::instance().getLimit() * config_.cpuStreamsPerThread;
+    }
+
+    devices_.resize(devices.size());
+    for (size_t i = 0; i < devices.size(); ++i) {
+        devices_[i].memoryPool = devices[i];
+    }
+}
+
+double AdmissionController::estimateDecodeLoad(const StreamInfo& info, StreamQuality quality) {
+    int width, height;
+    decodedSize(info, quality, width, height);
+
+    // Decimation only skips non-reference pictures, so every tier but PAUSED
+    // (keyframes only) is costed at the native rate
+    const int nativeFps = info.fps > 0 ? info.fps : kDefaultFps;
+    const int decodedFps = quality == StreamQuality::PAUSED ? 1 : nativeFps;
+
+    return (static_cast<double>(width) * height * decodedFps) / kReferencePixelRate;
+}
+
+size_t AdmissionController::estimateVram(const StreamInfo& info, StreamQuality quality) const {
+    int width, height;
+    decodedSize(info, quality, width, height);
+
+    // NV12, pitched like cuMemAllocPitch
+    const size_t pitch = ((static_cast<size_t>(width) + kPitchAlignment - 1) / kPitchAlignment) *
+                         kPitchAlignment;
+    const size_t frameBytes = pitch * (height + height / 2);
+
+    const auto tier = static_cast<fluxvision::StreamQuality>(quality);
+    const size_t surfaces = getSurfacePoolSize(tier) +                          // Our output pool
+                            std::max(getSurfacePoolSize(tier), kMinDecodeSurfaces) +  // Decode surfaces
+                            getOutputSurfaceCount(tier);                         // Driver output surfaces
+
+    return surfaces * frameBytes + config_.perDecoderOverheadBytes;
+}
+
+AdmissionResult AdmissionController::admit(const std::string& cameraId, const StreamInfo& info,
+                                           StreamQuality requested) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // Re-admission (e.g. after a failed start) replaces the old reservation
+    auto existing = reservations_.find(cameraId);
+    if (existing != reservations_.end()) {
+        unreserve(existing->second);
+        reservations_.erase(existing);
+    }
+
+    AdmissionResult result;
+    Reservation reservation;
+    reservation.info = info;
+
+    // GPU, from the requested tier down to the lowest acceptable one
+    for (StreamQuality quality = requested; ; quality = lowerTier(quality)) {
+        const double load = estimateDecodeLoad(info, quality);
+        const size_t vram = estimateVram(info, quality);
+
+        const int device = placeOnGpu(load, vram);
+        if (device >= 0) {
+            result.decision = quality == requested ? AdmissionDecision::ADMIT
+                                                   : AdmissionDecision::ADMIT_DOWNGRADED;
+            result.quality = quality;
+            result.device = device;
+            result.decodeLoad = load;
+            result.vramBytes = vram;
+
+            reservation.quality = quality;
+            reservation.device = device;
+            reservation.decodeLoad = load;
+            reservation.vramBytes = vram;
+            reserve(cameraId, reservation);
+
+            admitted_++;
+            if (quality != requested) {
+                downgraded_++;
+            }
+            return result;
+        }
+
+        if (quality <= config_.minQuality || quality == StreamQuality::PAUSED) {
+            break;
+        }
+    }
+
+    // CPU decoder, same tier walk (no VRAM)
+    for (StreamQuality quality = requested; ; quality = lowerTier(quality)) {
+        const double load = estimateDecodeLoad(info, quality);
+
+        if (fitsCpu(load)) {
+            result.decision = AdmissionDecision::CPU_DECODE;
+            result.quality = quality;
+            result.decodeLoad = load;
+
+            reservation.quality = quality;
+            reservation.device = -1;
+            reservation.decodeLoad = load;
+            reserve(cameraId, reservation);
+
+            admitted_++;
+            cpuFallbacks_++;
+            return result;
+        }
+
+        if (quality <= config_.minQuality || quality == StreamQuality::PAUSED) {
+            break;
+        }
+    }
+
+    rejected_++;
+    result.decision = AdmissionDecision::REJECT;
+    result.quality = requested;
+    result.decodeLoad = estimateDecodeLoad(info, requested);
+    result.vramBytes = estimateVram(info, requested);
+    return result;
+}
+
+void AdmissionController::confirm(const std::string& cameraId, bool hardwareDecoder) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = reservations_.find(cameraId);
+    if (it == reservations_.end() || (it->second.device >= 0) == hardwareDecoder) {
+        return;
+    }
+
+    // Account where it really runs, even past capacity: it is running already
+    Reservation reservation = it->second;
+    unreserve(reservation);
+    if (hardwareDecoder) {
+        reservation.vramBytes = estimateVram(reservation.info, reservation.quality);
+        const int device = placeOnGpu(reservation.decodeLoad, reservation.vramBytes);
+        reservation.device = device >= 0 ? device : 0;
+    } else {
+        reservation.device = -1;
+        reservation.vramBytes = 0;
+    }
+    reserve(cameraId, reservation);
+}
+
+StreamQuality AdmissionController::requestQuality(const std::string& cameraId, StreamQuality quality) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = reservations_.find(cameraId);
+    if (it == reservations_.end()) {
+        return quality;  // Not admission-controlled
+    }
+
+    Reservation current = it->second;
+    if (quality == current.quality) {
+        return quality;
+    }
+
+    // Evaluate without this camera's own reservation
+    unreserve(current);
+
+    StreamQuality granted = quality;
+    while (granted > current.quality) {
+        const double load = estimateDecodeLoad(current.info, granted);
+        const bool fits = current.device >= 0
+                              ? fitsGpu(current.device, load, estimateVram(current.info, granted))
+                              : fitsCpu(load);
+        if (fits) {
+            break;
+        }
+        granted = lowerTier(granted);
+    }
+
+    if (granted != quality) {
+        downgraded_++;
+    }
+
+    Reservation updated = current;
+    updated.quality = granted;
+    updated.decodeLoad = estimateDecodeLoad(current.info, granted);
+    updated.vramBytes = current.device >= 0 ? estimateVram(current.info, granted) : 0;
+    reserve(cameraId, updated);
+
+    return granted;
+}
+
+bool AdmissionController::planMigration(std::string& cameraId, int& device) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (devices_.size() < 2) {
+        return false;
+    }
+
+    int busiest = 0;
+    int idlest = 0;
+    std::vector<double> utilizations(devices_.size());
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        utilizations[i] = utilization(static_cast<int>(i), 0.0, 0);
+        if (utilizations[i] > utilizations[busiest]) busiest = static_cast<int>(i);
+        if (utilizations[i] < utilizations[idlest]) idlest = static_cast<int>(i);
+    }
+
+    const double gap = utilizations[busiest] - utilizations[idlest];
+    if (gap <= config_.rebalanceThreshold) {
+        return false;
+    }
+
+    // The camera whose move leaves the busier of the two lowest; the idle
+    // device must end up below where the busy one started, or the move just
+    // swaps which side is busy
+    double bestPeak = utilizations[busiest];
+    const std::string* best = nullptr;
+
+    for (const auto& [id, reservation] : reservations_) {
+        if (reservation.device != busiest ||
+            !fitsGpu(idlest, reservation.decodeLoad, reservation.vramBytes)) {
+            continue;
+        }
+
+        const double vram = static_cast<double>(reservation.vramBytes);
+        const double peak = std::max(utilization(busiest, -reservation.decodeLoad, -vram),
+                                     utilization(idlest, reservation.decodeLoad, vram));
+        if (peak < bestPeak) {
+            bestPeak = peak;
+            best = &id;
+        }
+    }
+
+    if (!best) {
+        return false;
+    }
+
+    cameraId = *best;
+    device = idlest;
+    return true;
+}
+
+bool AdmissionController::migrate(const std::string& cameraId, int device) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = reservations_.find(cameraId);
+    if (it == reservations_.end() || it->second.device < 0 ||
+        device < 0 || device >= static_cast<int>(devices_.size())) {
+        return false;
+    }
+
+    if (it->second.device == device) {
+        return true;
+    }
+
+    Reservation reservation = it->second;
+    if (!fitsGpu(device, reservation.decodeLoad, reservation.vramBytes)) {
+        return false;
+    }
+
+    unreserve(reservation);
+    reservation.device = device;
+    reserve(cameraId, reservation);
+
+    migrations_++;
+    return true;
+}
+
+int AdmissionController::getDevice(const std::string& cameraId) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = reservations_.find(cameraId);
+    return it != reservations_.end() ? it->second.device : -1;
+}
+
+bool AdmissionController::getStreamInfo(const std::string& cameraId, StreamInfo& info) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = reservations_.find(cameraId);
+    if (it == reservations_.end()) {
+        return false;
+    }
+    info = it->second.info;
+    return true;
+}
+
+void AdmissionController::release(const std::string& cameraId) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = reservations_.find(cameraId);
+    if (it != reservations_.end()) {
+        unreserve(it->second);
+        reservations_.erase(it);
+    }
+}
+
+AdmissionController::Stats AdmissionController::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    Stats stats;
+    stats.cpuLoad = cpuLoad_;
+    stats.admitted = admitted_;
+    stats.downgraded = downgraded_;
+    stats.cpuFallbacks = cpuFallbacks_;
+    stats.rejected = rejected_;
+    stats.migrations = migrations_;
+
+    stats.devices.resize(devices_.size());
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        DeviceStats& device = stats.devices[i];
+        device.load = devices_[i].load;
+        device.capacity = config_.nvdecCapacity * config_.maxNvdecUtilization;
+        device.reservedVramBytes = devices_[i].reservedVram;
+        device.utilization = utilization(static_cast<int>(i), 0.0, 0.0);
+
+        stats.gpuLoad += device.load;
+        stats.gpuCapacity += device.capacity;
+        stats.reservedVramBytes += device.reservedVramBytes;
+    }
+
+    for (const auto& [id, reservation] : reservations_) {
+        if (reservation.device >= 0) {
+            stats.gpuCameras++;
+            stats.devices[reservation.device].cameras++;
+        } else {
+            stats.cpuCameras++;
+        }
+    }
+
+    return stats;
+}
+
+bool AdmissionController::fitsGpu(int device, double load, size_t vram) const {
+    const Device& gpu = devices_[device];
+    if (gpu.load + load > config_.nvdecCapacity * config_.maxNvdecUtilization) {
+        return false;
+    }
+
+    if (!gpu.memoryPool) {
+        return true;
+    }
+
+    // Reservations cover decoders that haven't allocated yet (and the driver's
+    // decode surfaces the pool never sees); actual usage covers everything else
+    const size_t allocated = gpu.memoryPool->getAllocatedBytes();
+    const size_t unallocatedReservations = gpu.reservedVram > allocated ? gpu.reservedVram - allocated : 0;
+    return !gpu.memoryPool->wouldExceedLimit(vram + unallocatedReservations);
+}
+
+bool AdmissionController::fitsCpu(double load) const {
+    return config_.cpuCapacity > 0.0 && cpuLoad_ + load <= config_.cpuCapacity;
+}
+
+double AdmissionController::utilization(int device, double loadDelta, double vramDelta) const {
+    const Device& gpu = devices_[device];
+
+    const double capacity = config_.nvdecCapacity * config_.maxNvdecUtilization;
+    const double decode = capacity > 0.0 ? std::max(0.0, gpu.load + loadDelta) / capacity : 1.0;
+
+    double memory = 0.0;
+    if (gpu.memoryPool && gpu.memoryPool->getMemoryLimit() > 0) {
+        // Same view of VRAM as fitsGpu(): actual usage or reservations, whichever is larger
+        const double used = static_cast<double>(std::max(gpu.memoryPool->getAllocatedBytes(),
+                                                         gpu.reservedVram));
+        memory = std::max(0.0, used + vramDelta) / gpu.memoryPool->getMemoryLimit();
+    }
+
+    return std::max(decode, memory);
+}
+
+int AdmissionController::placeOnGpu(double load, size_t vram) const {
+    int best = -1;
+    double bestUtilization = 0.0;
+
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        const int device = static_cast<int>(i);
+        if (!fitsGpu(device, load, vram)) {
+            continue;
+        }
+
+        const double after = utilization(device, load, static_cast<double>(vram));
+        if (best < 0 || after < bestUtilization) {
+            best = device;
+            bestUtilization = after;
+        }
+    }
+
+    return best;
+}
+
+void AdmissionController::reserve(const std::string& cameraId, const Reservation& reservation) {
+    reservations_[cameraId] = reservation;
+
+    if (reservation.device >= 0) {
+        Device& gpu = devices_[reservation.device];
+        gpu.load += reservation.decodeLoad;
+        gpu.reservedVram += reservation.vramBytes;
+    } else {
+        cpuLoad_ += reservation.decodeLoad;
+    }
+}
+
+void AdmissionController::unreserve(const Reservation& reservation) {
+    if (reservation.device >= 0) {
+        Device& gpu = devices_[reservation.device];
+        gpu.load = std::max(0.0, gpu.load - reservation.decodeLoad);
+        gpu.reservedVram -= std::min(gpu.reservedVram, reservation.vramBytes);
+    } else {
+        cpuLoad_ = std::max(0.0, cpuLoad_ - reservation.decodeLoad);
+    }
+}
+
+} // namespace stream
+} // namespace fluxvision
@@ -0,0 +1,180 @@
+// src/core/stream/admission_controller.h
+// Admission control and device placement: keeps the GPUs' decode engines and VRAM from being overcommitted
+#pragma once
+
+#include "camera_stream.h"
+#include "../gpu/memory_pool.h"
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fluxvision {
+namespace stream {
+
+// Where a camera may run
+enum class AdmissionDecision {
+    ADMIT,             // GPU at the requested tier
+    ADMIT_DOWNGRADED,  // GPU at a lower tier
+    CPU_DECODE,        // GPU full: software decoder
+    REJECT             // Nothing has room
+};
+
+struct AdmissionResult {
+    AdmissionDecision decision = AdmissionDecision::REJECT;
+    StreamQuality quality = StreamQuality::GRID_VIEW;  // Tier to run at
+    int device = -1;             // Device index for GPU decisions (-1 otherwise)
+    double decodeLoad = 0.0;     // In 1080p30-stream equivalents
+    size_t vramBytes = 0;        // Estimated VRAM (0 on the CPU decoder)
+};
+
+// Estimates each camera's cost from its stream parameters (resolution and
+// frame rate from the SPS, as reported by the RTSP client) and quality tier,
+// and admits it only where that cost fits:
+// 1. on a GPU at the requested tier;
+// 2. on a GPU at a lower tier, down to Config::minQuality;
+// 3. on the CPU decoder, within Config::cpuCapacity;
+// 4. otherwise not at all.
+// Decode load is measured in 1080p30 equivalents (pixels per second) against
+// what each device's NVDEC engines sustain; VRAM against that device's GPU
+// memory pool limit, counting reservations of cameras whose decoders haven't
+// allocated yet.
+//
+// Placement: devices are indexed in the order they were passed in. Of the
+// devices a camera fits on, it goes to the one left least utilized (the
+// larger of its decode and VRAM utilization after admission). As cameras come,
+// go and change tier, planMigration() proposes moving a camera off the
+// busiest device once it is Config::rebalanceThreshold ahead of the idlest.
+//
+// Thread-safety: all methods may be called from any thread.
+class AdmissionController {
+public:
+    struct Config {
+        double nvdecCapacity = 24.0;        // 1080p30 streams each device's NVDEC engines sustain
+        double maxNvdecUtilization = 0.9;   // Headroom kept free for bursts and IDR spikes
+        double cpuCapacity = -1.0;          // 1080p30 streams for the CPU decoder (0 = no CPU fallback,
+                                            // < 0 = cpuStreamsPerThread x the CpuDecodeBudget limit)
+        double cpuStreamsPerThread = 0.5;   // Software 1080p30 streams per decode thread (H.265 worst case)
+        StreamQuality minQuality = StreamQuality::THUMBNAIL;  // Lowest tier admission downgrades to
+        size_t perDecoderOverheadBytes = 16ULL * 1024 * 1024; // Decoder context, bitstream buffers
+        double rebalanceThreshold = 0.25;   // Utilization gap between devices worth a migration
+        bool rebalanceOnChange = true;      // StreamManager migrates after removals and tier changes
+    };
+
+    // Stream parameters of the opened profile
+    struct StreamInfo {
+        int width = 0;
+        int height = 0;
+        int fps = 0;                 // 0 = unknown (assume 30)
+        bool hasSubStream = false;   // Low tiers switch to a sub stream (assumed 640x360)
+    };
+
+    struct DeviceStats {
+        double load = 0.0;           // Reserved decode load (1080p30 equivalents)
+        double capacity = 0.0;       // Usable: nvdecCapacity * maxNvdecUtilization
+        size_t reservedVramBytes = 0;
+        double utilization = 0.0;    // Larger of decode and VRAM utilization
+        size_t cameras = 0;
+    };
+
+    struct Stats {
+        double gpuLoad = 0.0;        // Reserved decode load, all devices
+        double gpuCapacity = 0.0;    // Usable capacity, all devices
+        double cpuLoad = 0.0;
+        size_t reservedVramBytes = 0;
+        size_t gpuCameras = 0;
+        size_t cpuCameras = 0;
+        uint64_t admitted = 0;
+        uint64_t downgraded = 0;     // Admitted (or upgrades granted) below the requested tier
+        uint64_t cpuFallbacks = 0;
+        uint64_t rejected = 0;
+        uint64_t migrations = 0;
+        std::vector<DeviceStats> devices;
+    };
+
+    // One device; memoryPool: not owned, may be nullptr (VRAM then isn't checked)
+    AdmissionController(const Config& config, gpu::GPUMemoryPool* memoryPool);
+
+    // One entry per device, each that device's memory pool (not owned, may be nullptr)
+    AdmissionController(const Config& config, const std::vector<gpu::GPUMemoryPool*>& devices);
+
+    // Delete copy/move
+    AdmissionController(const AdmissionController&) = delete;
+    AdmissionController& operator=(const AdmissionController&) = delete;
+
+    // Decide placement for a new camera and reserve its cost (unless rejected)
+    AdmissionResult admit(const std::string& cameraId, const StreamInfo& info,
+                          StreamQuality requested);
+
+    // Propose one camera to move off the busiest device (nothing is changed)
+    // Returns: false if the devices are balanced within Config::rebalanceThreshold
+    bool planMigration(std::string& cameraId, int& device) const;
+
+    // Move a GPU camera's reservation to another device, if it fits there
+    bool migrate(const std::string& cameraId, int device);
+
+    // Device a camera is placed on (-1: CPU decoder or not admitted)
+    int getDevice(const std::string& cameraId) const;
+    size_t getDeviceCount() const { return devices_.size(); }
+
+    // Stream parameters an admitted camera was costed with
+    bool getStreamInfo(const std::string& cameraId, StreamInfo& info) const;
+
+    // The decoder actually created: moves the reservation to the CPU if NVDEC
+    // was unavailable after all
+    void confirm(const std::string& cameraId, bool hardwareDecoder);
+
+    // Tier change for an admitted camera: downgrades are always granted,
+    // upgrades only as far as they fit. Returns the tier to use.
+    StreamQuality requestQuality(const std::string& cameraId, StreamQuality quality);
+
+    // Camera removed
+    void release(const std::string& cameraId);
+
+    Stats getStats() const;
+
+    // Cost model
+    static double estimateDecodeLoad(const StreamInfo& info, StreamQuality quality);
+    size_t estimateVram(const StreamInfo& info, StreamQuality quality) const;
+
+private:
+    struct Reservation {
+        StreamInfo info;
+        StreamQuality quality = StreamQuality::GRID_VIEW;
+        int device = -1;             // -1: CPU decoder
+        double decodeLoad = 0.0;
+        size_t vramBytes = 0;
+    };
+
+    struct Device {
+        gpu::GPUMemoryPool* memoryPool = nullptr;
+        double load = 0.0;
+        size_t reservedVram = 0;
+    };
+
+    Config config_;
+
+    mutable std::mutex mutex_;
+    std::map<std::string, Reservation> reservations_;
+    std::vector<Device> devices_;
+    double cpuLoad_ = 0.0;
+
+    // Statistics
+    uint64_t admitted_ = 0;
+    uint64_t downgraded_ = 0;
+    uint64_t cpuFallbacks_ = 0;
+    uint64_t rejected_ = 0;
+    uint64_t migrations_ = 0;
+
+    bool fitsGpu(int device, double load, size_t vram) const;         // mutex_ held
+    bool fitsCpu(double load) const;                                  // mutex_ held
+    double utilization(int device, double loadDelta, double vramDelta) const;  // mutex_ held
+    int placeOnGpu(double load, size_t vram) const;  // Least utilized fitting device, or -1; mutex_ held
+    void reserve(const std::string& cameraId, const Reservation& reservation);  // mutex_ held
+    void unreserve(const Reservation& reservation); // mutex_ held
+};
+
+} // namespace stream
+} // namespace fluxvision
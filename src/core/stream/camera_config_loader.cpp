@@ -0,0 +1,136 @@
+// src/core/stream/camera_config_loader.cpp
+#include "camera_config_loader.h"
+#include <iostream>
+
+#ifdef HAVE_YAML_CPP
+#include <yaml-cpp/yaml.h>
+#endif
+
+namespace fluxvision {
+namespace stream {
+
+#ifdef HAVE_YAML_CPP
+
+namespace {
+    bool parseQuality(const std::string& name, StreamQuality& quality) {
+        if (name == "paused") {
+            quality = StreamQuality::PAUSED;
+        } else if (name == "thumbnail") {
+            quality = StreamQuality::THUMBNAIL;
+        } else if (name == "grid_view") {
+            quality = StreamQuality::GRID_VIEW;
+        } else if (name == "focused") {
+            quality = StreamQuality::FOCUSED;
+        } else if (name == "fullscreen") {
+            quality = StreamQuality::FULLSCREEN;
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    bool parseTransport(const std::string& name, network::TransportType& transport) {
+        if (name == "tcp") {
+            transport = network::TransportType::TCP;
+        } else if (name == "udp") {
+            transport = network::TransportType::UDP;
+        } else {
+            return false;
+        }
+        return true;
+    }
+}
+
+bool loadCameraSiteConfig(const std::string& path, CameraSiteConfig& site) {
+    site = CameraSiteConfig{};
+
+    try {
+        const YAML::Node root = YAML::LoadFile(path);
+
+        if (const YAML::Node resources = root["resources"]) {
+            site.startupConcurrency = resources["camera_startup_concurrency"].as<size_t>(0);
+        }
+
+        const YAML::Node cameras = root["cameras"];
+        if (!cameras) {
+            return true;  // No cameras configured yet
+        }
+        if (!cameras.IsSequence()) {
+            std::cerr << "CameraConfigLoader: " << path << ": cameras must be a list" << std::endl;
+            return false;
+        }
+
+        for (const YAML::Node& node : cameras) {
+            CameraStream::Config config;
+            config.id = node["id"].as<std::string>("");
+
+            const YAML::Node mainStream = node["main_stream"];
+            if (mainStream) {
+                config.rtspUrl = mainStream["url"].as<std::string>("");
+                config.username = mainStream["username"].as<std::string>("");
+                config.password = mainStream["password"].as<std::string>("");
+            }
+
+            if (config.id.empty() || config.rtspUrl.empty()) {
+                std::cerr << "CameraConfigLoader: skipping camera without id or main_stream.url (line "
+                          << node.Mark().line + 1 << ")" << std::endl;
+                continue;
+            }
+
+            if (!node["enabled"].as<bool>(true)) {
+                continue;
+            }
+
+            // The sub stream uses the main stream's credentials
+            if (const YAML::Node subStream = node["sub_stream"]) {
+                config.subStreamUrl = subStream["url"].as<std::string>("");
+            }
+
+            if (const YAML::Node quality = node["quality"]) {
+                if (!parseQuality(quality.as<std::string>(), config.quality)) {
+                    std::cerr << "CameraConfigLoader: camera " << config.id << ": unknown quality '"
+                              << quality.as<std::string>() << "', using grid_view" << std::endl;
+                }
+            }
+
+            // udp: native RTP/UDP ingest, which only opens the main stream
+            if (const YAML::Node transport = node["transport"]) {
+                if (!parseTransport(transport.as<std::string>(), config.transport)) {
+                    std::cerr << "CameraConfigLoader: camera " << config.id << ": unknown transport '"
+                              << transport.as<std::string>() << "', using tcp" << std::endl;
+                }
+            }
+            if (config.transport == network::TransportType::UDP && !config.subStreamUrl.empty()) {
+                std::cerr << "CameraConfigLoader: camera " << config.id
+                          << ": sub_stream is not used with transport udp" << std::endl;
+                config.subStreamUrl.clear();
+            }
+
+            // Keyframe-only decode while nothing moves (off for alarm and entrance cameras)
+            if (const YAML::Node gating = node["activity_gating"]) {
+                config.activityGate.enabled = gating.as<bool>(false);
+            }
+
+            site.cameras.push_back(std::move(config));
+        }
+    }
+    catch (const YAML::Exception& e) {
+        std::cerr << "CameraConfigLoader: failed to load " << path << ": " << e.what() << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+#else
+
+bool loadCameraSiteConfig(const std::string& path, CameraSiteConfig& site) {
+    site = CameraSiteConfig{};
+    std::cerr << "CameraConfigLoader: built without yaml-cpp, cannot load " << path << std::endl;
+    return false;
+}
+
+#endif
+
+} // namespace stream
+} // namespace fluxvision
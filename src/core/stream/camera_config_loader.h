@@ -0,0 +1,27 @@
+// src/core/stream/camera_config_loader.h
+// Camera list from config.yaml, for StreamManager::addCameras()
+#pragma once
+
+#include "camera_stream.h"
+#include <cstddef>
+#include <string>
+#include <vector>
+
+namespace fluxvision {
+namespace stream {
+
+// The parts of config.yaml the stream layer reads
+struct CameraSiteConfig {
+    std::vector<CameraStream::Config> cameras;  // Enabled cameras, in file order
+    size_t startupConcurrency = 0;              // resources.camera_startup_concurrency (0 = not set)
+};
+
+// Reads the cameras section: id, enabled, main_stream (url, username,
+// password), sub_stream.url, an optional quality tier (paused, thumbnail,
+// grid_view, focused, fullscreen), transport (tcp, udp) and activity_gating
+// (bool). Cameras without an id or main stream URL are skipped with a warning.
+// Returns: false if the file can't be read or parsed (or yaml-cpp is missing)
+bool loadCameraSiteConfig(const std::string& path, CameraSiteConfig& site);
+
+} // namespace stream
+} // namespace fluxvision
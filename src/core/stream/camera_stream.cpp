@@ -1,16 +1,29 @@
 // src/core/stream/camera_stream.cpp
 #include "camera_stream.h"
-#include "../codec/decoder_factory.h"
+#include "../codec/decoder_pool.h"
+#include "../network/rtsp_udp_source.h"
+#include <algorithm>
 #include <iostream>
 
 namespace fluxvision {
 namespace stream {
 
+namespace {
+    // Reactor mode: a stalled camera holds its shared network thread at most this
+    // long per read. Cameras with longer gaps between frames (low-fps sub
+    // streams) fail their reads here and belong in pinned mode.
+    constexpr int kReactorReadTimeoutMs = 1000;
+}
+
 CameraStream::CameraStream(const Config& config)
     : config_(config)
     , quality_(config.quality)
+    , priority_(config.priority)
+    , deviceId_(config.cudaDeviceId)
     , packetQueue_(config.packetQueueSize)
-    , lastFpsUpdate_(std::chrono::steady_clock::now())
+    , decimator_(config.quality)
+    , gopCache_(config.gopCacheBytes)
+    , activityGate_(config.activityGate)
 {
 }
 
@@ -18,26 +31,53 @@ CameraStream::~CameraStream() {
     stop();
 }
 
+bool CameraStream::open() {
+    if (source_) {
+        return true;  // Already connected
+    }
+
+    updateState(StreamState::CONNECTING);
+
+    if (!initializeSource()) {
+        source_.reset();
+        updateState(StreamState::ERROR);
+        return false;
+    }
+
+    return true;
+}
+
 bool CameraStream::start() {
     if (state_.load() == StreamState::RUNNING) {
         return true;  // Already running
     }
 
-    updateState(StreamState::CONNECTING);
+    // Initialize RTSP client (or the configured source)
+    if (!open()) {
+        return false;
+    }
 
-    // Initialize RTSP client
-    if (!initializeRtspClient()) {
-        updateState(StreamState::ERROR);
+    // Initialize decoder (lazy: at the first IDR, on a decode worker)
+    if (!config_.lazyDecoder && !startDecoder()) {
         return false;
     }
 
-    // Initialize decoder
+    updateState(StreamState::RUNNING);
+    return true;
+}
+
+bool CameraStream::startDecoder() {
+    if (decoder_) {
+        return true;
+    }
+
     if (!initializeDecoder()) {
         updateState(StreamState::ERROR);
         return false;
     }
 
-    updateState(StreamState::RUNNING);
+    // Show the cached GOP at once instead of waiting for the next IDR
+    primePending_ = true;
     return true;
 }
 
@@ -49,25 +89,26 @@ void CameraStream::stop() {
     updateState(StreamState::STOPPED);
 
     // Cleanup components
-    if (rtspClient_) {
-        rtspClient_->disconnect();
-        rtspClient_.reset();
+    if (source_) {
+        source_->disconnect();
+        source_.reset();
     }
 
-    if (decoder_) {
-        decoder_.reset();
-    }
+    // Parked for the next compatible camera (or this one, on reconnect)
+    DecoderPool::instance().release(std::move(decoder_));
 
-    // Clear packet queue
-    StreamPacket dummy;
-    while (packetQueue_.pop(dummy)) {
-        // Drain queue
+    // Clear packet queue; the cached GOP survives for the next start()
+    {
+        std::lock_guard<std::mutex> lock(gopMutex_);
+        gopCache_.seal();
+
+        StreamPacket dummy;
+        while (packetQueue_.pop(dummy)) {
+            // Drain queue
+        }
     }
 
-    // Reset statistics
-    std::lock_guard<std::mutex> lock(statsMutex_);
-    stats_ = Stats{};
-    framesSinceLastUpdate_ = 0;
+    // Counters are kept: they are cumulative for the camera's lifetime
 }
 
 bool CameraStream::reconnect() {
@@ -88,41 +129,296 @@ bool CameraStream::reconnect() {
 }
 
 void CameraStream::setQuality(StreamQuality quality) {
-    if (quality_.load() == quality) {
+    std::lock_guard<std::mutex> lock(qualityMutex_);
+    const StreamQuality previous = cappedQuality();
+    quality_ = quality;
+    applyQuality(previous, cappedQuality());
+}
+
+void CameraStream::setQualityCap(StreamQuality cap) {
+    std::lock_guard<std::mutex> lock(qualityMutex_);
+    const StreamQuality previous = cappedQuality();
+    qualityCap_ = cap;
+    applyQuality(previous, cappedQuality());
+}
+
+StreamQuality CameraStream::cappedQuality() const {
+    return std::min(quality_.load(), qualityCap_.load());
+}
+
+void CameraStream::applyQuality(StreamQuality previous, StreamQuality quality) {
+    if (previous == quality) {
         return;  // No change
     }
 
-    quality_.store(quality);
+    // PAUSED only decoded keyframes: replay the GOP rather than wait for the next one
+    if (previous == StreamQuality::PAUSED) {
+        primePending_ = true;
+    }
+
+    // Make-before-break profile switch: the current stream keeps playing until
+    // the other one delivers a keyframe, and the decoder reconfigures in place
+    if (!config_.subStreamUrl.empty() && source_) {
+        const bool wantSub = usesSubStream(quality);
+        const bool onSub = source_->getCurrentProfile() == network::StreamProfile::SUB;
+
+        if (wantSub != onSub || source_->isSwitching()) {
+            wantSub ? source_->switchToSubStream() : source_->switchToMainStream();
+        }
+    }
+
+    // The network connection is kept in every tier. The decode consumer picks the
+    // new quality up at its next slice: the decimator switches its target FPS
+    // (PAUSED decodes keyframes only) and the decoder resizes its surface pool.
+}
 
-    // For PAUSED quality, we can pause decoding but keep network connection
-    // For other qualities, decoder may need reinitialization with new resolution
-    // (Implementation detail: this will be handled in Phase 4 when we add dynamic quality)
+StreamQuality CameraStream::getQuality() const {
+    return activityGate_.isGated() ? StreamQuality::PAUSED : cappedQuality();
+}
+
+void CameraStream::measureActivity(const FrameHandle& frame) {
+    const auto now = ActivityGate::Clock::now();
+    if (!activityGate_.shouldMeasure(now)) {
+        return;
+    }
+
+    if (!activity_) {
+        gpu::ActivityEstimator::Config activityConfig;
+        activityConfig.cudaDeviceId = config_.cudaDeviceId;
+        activityConfig.cellThreshold = config_.activityGate.cellThreshold;
+        activity_ = std::make_unique<gpu::ActivityEstimator>(activityConfig);
+
+        // CPU-decoded frames are measured on the host
+        if (frame->cudaSurface) {
+            activity_->initialize();
+        }
+    }
+
+    // The last measurement is still on the GPU: skip this frame rather than wait
+    if (!activity_->isBusy() && activity_->submit(frame)) {
+        activityGate_.onMeasured(now);
+    }
+}
+
+void CameraStream::updateActivityGate() {
+    if (!config_.activityGate.enabled) {
+        return;
+    }
+
+    const auto now = ActivityGate::Clock::now();
+    const StreamQuality requested = cappedQuality();
+    const bool wasGated = activityGate_.isGated();
+
+    float activity = 0.0f;
+    const bool gated = activity_ && activity_->poll(activity)
+                           ? activityGate_.update(activity, requested, now)
+                           : activityGate_.onRequestedQuality(requested, now);
+    if (gated == wasGated) {
+        return;
+    }
+
+    // Leaving PAUSED: replay the GOP rather than wait for the next keyframe
+    if (!gated) {
+        primePending_ = true;
+    }
+
+    std::cout << "Camera " << config_.id << (gated ? " idle: keyframe-only decode"
+                                                   : " active: back to requested quality") << std::endl;
+}
+
+bool CameraStream::moveToDevice(int cudaDeviceId, std::shared_ptr<gpu::GPUMemoryPool> memoryPool) {
+    const int previousDevice = config_.cudaDeviceId;
+    std::shared_ptr<gpu::GPUMemoryPool> previousPool = config_.memoryPool;
+
+    config_.cudaDeviceId = cudaDeviceId;
+    config_.memoryPool = std::move(memoryPool);
+
+    if (!decoder_) {
+        deviceId_ = cudaDeviceId;
+        return true;  // Applies at the next start()
+    }
+
+    // Keep decoding where we are unless the new decoder comes up
+    std::unique_ptr<IDecoder> previous = std::move(decoder_);
+    if (!initializeDecoder()) {
+        std::cerr << "Failed to move camera " << config_.id << " to CUDA device "
+                  << cudaDeviceId << std::endl;
+        config_.cudaDeviceId = previousDevice;
+        config_.memoryPool = std::move(previousPool);
+        decoder_ = std::move(previous);
+        return false;
+    }
+
+    // The old decoder's surfaces go back to their pool as its frames are dropped
+    DecoderPool::instance().release(std::move(previous));
+    deviceId_ = cudaDeviceId;
+
+    // Downloads still in flight are dropped; the next one starts on the new device
+    downloader_.reset();
+    downloaderFailed_ = false;
+    activity_.reset();
+    accountedGpuBytes_ = 0;
+    decimator_.resync();
+    primePending_ = true;
+    return true;
+}
+
+gpu::FrameDownloader* CameraStream::ensureDownloader() {
+    if (downloader_ || downloaderFailed_) {
+        return downloader_.get();
+    }
+
+    gpu::FrameDownloader::Config downloaderConfig;
+    downloaderConfig.cudaDeviceId = config_.cudaDeviceId;
+
+    auto downloader = std::make_shared<gpu::FrameDownloader>(downloaderConfig);
+    if (!downloader->initialize()) {
+        std::cerr << "Camera " << config_.id << ": host frame downloads unavailable" << std::endl;
+        downloaderFailed_ = true;   // Don't retry on every frame
+        return nullptr;
+    }
+
+    downloader_ = std::move(downloader);
+    return downloader_.get();
+}
+
+bool CameraStream::queuePacket(StreamPacket&& packet) {
+    metrics_.recordPacket(packet.data.size(), packet.isKeyFrame);
+    packet.queuedTime = metrics::traceNow();
+
+    std::lock_guard<std::mutex> lock(gopMutex_);
+    gopCache_.append(packet);
+
+    // Backpressure: the queue sheds non-reference pictures, then whole GOPs
+    return packetQueue_.push(std::move(packet));
+}
+
+bool CameraStream::takeCachedGop(std::vector<StreamPacket>& packets, bool& continuous) {
+    std::lock_guard<std::mutex> lock(gopMutex_);
+
+    // Everything queued was received before the newest cached picture
+    StreamPacket stale;
+    while (packetQueue_.pop(stale)) {
+        // Drain queue
+    }
+
+    gopCache_.snapshot(packets);
+    continuous = !gopCache_.isSealed();
+    return !packets.empty();
+}
+
+bool CameraStream::usesSubStream(StreamQuality quality) {
+    return quality == StreamQuality::PAUSED ||
+           quality == StreamQuality::THUMBNAIL ||
+           quality == StreamQuality::GRID_VIEW;
+}
+
+bool CameraStream::getStreamInfo(int& width, int& height, int& framerate) const {
+    return source_ && source_->getStreamInfo(width, height, framerate);
 }
 
 CameraStream::Stats CameraStream::getStats() const {
-    std::lock_guard<std::mutex> lock(statsMutex_);
-    Stats statsCopy = stats_;
-    statsCopy.packetsInQueue = packetQueue_.size();
-    return statsCopy;
+    Stats stats;
+    stats.currentFps = static_cast<int>(metrics_.fps());
+    stats.decodedFrames = static_cast<int>(metrics_.framesDecoded());
+    stats.bytesReceived = static_cast<size_t>(metrics_.bytes());
+    stats.lastFrameTimestamp = metrics_.lastPts();
+    stats.latency = std::chrono::milliseconds(metrics_.lastLatencyUs() / 1000);
+    stats.packetsInQueue = packetQueue_.size();
+    stats.droppedFrames = static_cast<int>(packetQueue_.droppedCount());
+    stats.decimatedFrames = static_cast<int>(decimator_.decimatedCount());
+    return stats;
+}
+
+void CameraStream::sampleMetrics(metrics::CameraSample& sample) const {
+    static const char* const stateNames[] = {"STOPPED", "CONNECTING", "RUNNING", "ERROR", "RECONNECTING"};
+    static const char* const qualityNames[] = {"PAUSED", "THUMBNAIL", "GRID_VIEW", "FOCUSED", "FULLSCREEN"};
+
+    sample.cameraId = config_.id;
+    sample.state = stateNames[static_cast<int>(state_.load())];
+    sample.quality = qualityNames[static_cast<int>(getQuality())];  // Tier decoded at (gated, capped)
+    sample.decoder = metrics_.decoderName();
+    sample.cudaDevice = deviceId_.load();
+    sample.idleGated = activityGate_.isGated();
+    sample.governed = qualityCap_.load() < quality_.load();
+
+    sample.packets = metrics_.packets();
+    sample.bytes = metrics_.bytes();
+    sample.keyframes = metrics_.keyframes();
+
+    sample.queueDepth = packetQueue_.size();
+    sample.queueCapacity = packetQueue_.capacity();
+
+    const PacketQueue::Stats queue = packetQueue_.getStats();
+    sample.droppedNonReference = queue.droppedNonReference;
+    sample.droppedGop = queue.droppedGop;
+    sample.droppedFull = queue.droppedFull;
+    sample.discardedStale = queue.discardedStale;
+    sample.decimated = decimator_.decimatedCount();
+
+    sample.framesDecoded = metrics_.framesDecoded();
+    sample.decodeErrors = metrics_.decodeErrors();
+    sample.fps = metrics_.fps();
+    sample.decodeLatency = metrics_.decodeLatency();
+    for (size_t i = 0; i < metrics::kLatencyStageCount; ++i) {
+        sample.stageLatency[i] = metrics_.stageLatency(static_cast<metrics::LatencyStage>(i));
+    }
+
+    sample.surfacesAllocated = metrics_.surfacesAllocated();
+    sample.surfaceCapacity = metrics_.surfaceCapacity();
+    sample.gpuBytes = metrics_.gpuBytes();
 }
 
-bool CameraStream::initializeRtspClient() {
+bool CameraStream::initializeSource() {
     try {
+        if (config_.sourceFactory) {
+            source_ = config_.sourceFactory(config_);
+            if (!source_) {
+                std::cerr << "Failed to open source for camera: " << config_.id << std::endl;
+                return false;
+            }
+            return true;
+        }
+
+        if (config_.transport == network::TransportType::UDP) {
+            network::RtspUdpSource::Config udpConfig;
+            udpConfig.url = config_.rtspUrl;
+            udpConfig.username = config_.username;
+            udpConfig.password = config_.password;
+            udpConfig.timeoutMs = 5000;
+            udpConfig.blocking = !config_.nonBlockingReceive;  // Reactor: serviced on socket readiness
+
+            auto udpSource = std::make_unique<network::RtspUdpSource>();
+            if (!udpSource->connect(udpConfig)) {
+                std::cerr << "Failed to connect RTSP/UDP source for camera: " << config_.id << std::endl;
+                return false;
+            }
+
+            source_ = std::move(udpSource);
+            return true;
+        }
+
         network::RtspClient::Config rtspConfig;
         rtspConfig.url = config_.rtspUrl;
+        rtspConfig.subStreamUrl = config_.subStreamUrl;
+        rtspConfig.initialProfile = usesSubStream(cappedQuality()) ? network::StreamProfile::SUB
+                                                                   : network::StreamProfile::MAIN;
         rtspConfig.username = config_.username;
         rtspConfig.password = config_.password;
         rtspConfig.transport = network::TransportType::TCP;
         rtspConfig.timeoutMs = 5000;
         rtspConfig.autoReconnect = config_.autoReconnect;
+        rtspConfig.nonBlocking = config_.nonBlockingReceive;
+        rtspConfig.readTimeoutMs = config_.nonBlockingReceive ? kReactorReadTimeoutMs : 0;
 
-        rtspClient_ = std::make_unique<network::RtspClient>();
+        auto rtspClient = std::make_unique<network::RtspClient>();
 
-        if (!rtspClient_->connect(rtspConfig)) {
+        if (!rtspClient->connect(rtspConfig)) {
             std::cerr << "Failed to connect RTSP client for camera: " << config_.id << std::endl;
             return false;
         }
 
+        source_ = std::move(rtspClient);
         return true;
     }
     catch (const std::exception& e) {
@@ -134,33 +430,51 @@ bool CameraStream::initializeRtspClient() {
 
 bool CameraStream::initializeDecoder() {
     try {
-        // Get stream info from RTSP client
+        // Get stream info from the source
         int width, height, framerate;
-        if (!rtspClient_->getStreamInfo(width, height, framerate)) {
+        if (!source_->getStreamInfo(width, height, framerate)) {
             std::cerr << "Failed to get stream info for camera: " << config_.id << std::endl;
             return false;
         }
 
+        // H.264 or H.265, as negotiated in the SDP
+        const CodecType codec = source_->getCodec();
+        if (codec == CodecType::UNKNOWN) {
+            std::cerr << "Unsupported video codec for camera: " << config_.id << std::endl;
+            return false;
+        }
+
         // Create decoder configuration based on quality level
         DecoderConfig decoderConfig;
-        decoderConfig.codec = CodecType::H264;  // Assume H.264 for now
-        decoderConfig.quality = static_cast<fluxvision::StreamQuality>(quality_.load());
-        decoderConfig.maxWidth = width;
-        decoderConfig.maxHeight = height;
+        decoderConfig.codec = codec;
+        decoderConfig.quality = static_cast<fluxvision::StreamQuality>(cappedQuality());
+        decoderConfig.maxWidth = std::max(width, config_.maxWidth);
+        decoderConfig.maxHeight = std::max(height, config_.maxHeight);
         decoderConfig.preferHardware = true;
+        decoderConfig.zeroCopyOutput = config_.zeroCopyFrames;
+        decoderConfig.memoryPool = config_.memoryPool;
+        decoderConfig.cameraId = config_.id;
+        decoderConfig.cudaDeviceId = config_.cudaDeviceId;
+
+        // Leave room to switch up to the main stream without rebuilding the decoder
+        if (!config_.subStreamUrl.empty() && config_.maxWidth == 0 && config_.maxHeight == 0) {
+            decoderConfig.maxWidth = std::max(width, 1920);
+            decoderConfig.maxHeight = std::max(height, 1080);
+        }
 
-        // Determine if this should use sub-stream resolution
-        stream::StreamQuality quality = quality_.load();
-        decoderConfig.isSubStream = (quality == stream::StreamQuality::THUMBNAIL ||
-                                     quality == stream::StreamQuality::GRID_VIEW);
+        // Sub-stream resolution if that is the profile we opened
+        decoderConfig.isSubStream =
+            source_->getCurrentProfile() == network::StreamProfile::SUB;
 
-        // Try NVDEC first, fallback to CPU decoder
-        decoder_ = DecoderFactory::create(DecoderType::NVDEC, decoderConfig);
+        // Try NVDEC first, fallback to CPU decoder (admission may place us on the CPU directly)
+        if (config_.decoderType != DecoderType::CPU) {
+            decoder_ = DecoderPool::instance().acquire(DecoderType::NVDEC, decoderConfig);
+        }
 
-        if (!decoder_) {
+        if (!decoder_ && config_.decoderType != DecoderType::NVDEC) {
             std::cerr << "Failed to create NVDEC decoder for camera " << config_.id
                       << ", trying CPU decoder..." << std::endl;
-            decoder_ = DecoderFactory::create(DecoderType::CPU, decoderConfig);
+            decoder_ = DecoderPool::instance().acquire(DecoderType::CPU, decoderConfig);
         }
 
         if (!decoder_) {
@@ -189,17 +503,5 @@ void CameraStream::updateState(StreamState newState) {
     }
 }
 
-void CameraStream::updateFps() {
-    auto now = std::chrono::steady_clock::now();
-    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(now - lastFpsUpdate_);
-
-    if (elapsed.count() >= 1000) {  // Update every second
-        std::lock_guard<std::mutex> lock(statsMutex_);
-        stats_.currentFps = static_cast<int>((framesSinceLastUpdate_ * 1000.0) / elapsed.count());
-        framesSinceLastUpdate_ = 0;
-        lastFpsUpdate_ = now;
-    }
-}
-
 } // namespace stream
 } // namespace fluxvision
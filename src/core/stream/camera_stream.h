@@ -4,12 +4,24 @@
 
 #include "../network/rtsp_client.h"
 #include "../codec/decoder_interface.h"
-#include "../threading/bounded_queue.h"
+#include "../codec/decoder_factory.h"
+#include "../gpu/frame_downloader.h"
+#include "../gpu/activity_estimator.h"
+#include "activity_gate.h"
+#include "packet_queue.h"
+#include "frame_decimator.h"
+#include "frame_fanout.h"
+#include "gop_cache.h"
+#include "packet_fanout.h"
+#include "../metrics/camera_metrics.h"
+#include "../metrics/frame_trace.h"
+#include <functional>
 #include <memory>
 #include <string>
 #include <atomic>
 #include <mutex>
 #include <chrono>
+#include <vector>
 
 namespace fluxvision {
 namespace stream {
@@ -32,29 +44,42 @@ enum class StreamState {
     RECONNECTING  // Auto-reconnecting after failure
 };
 
-// Packet for per-camera queue
-struct StreamPacket {
-    std::vector<uint8_t> data;
-    int64_t timestamp;
-    bool isKeyFrame;
-};
-
 // Per-camera stream manager
 class CameraStream {
 public:
+    struct Config;
+
+    // Connected source for a camera in place of the RTSP client (nullptr: failed)
+    using SourceFactory = std::function<std::unique_ptr<network::StreamSource>(const Config& config)>;
+
     struct Config {
         std::string id;              // Unique camera identifier
         std::string rtspUrl;         // RTSP stream URL
+        std::string subStreamUrl;    // Optional low-resolution stream for THUMBNAIL/GRID_VIEW/PAUSED
         std::string username;        // RTSP auth username
         std::string password;        // RTSP auth password
+        network::TransportType transport = network::TransportType::TCP; // UDP: native RTP/UDP ingest (main stream only)
         StreamQuality quality = StreamQuality::GRID_VIEW;
         bool autoReconnect = true;   // Auto-reconnect on failure
         size_t packetQueueSize = 60; // Bounded queue size (2 seconds @ 30fps)
+        size_t gopCacheBytes = 8 * 1024 * 1024; // Last GOP kept to prime new decoders (0 = off)
+        bool nonBlockingReceive = false; // Non-blocking RTSP reads (set by StreamManager in reactor mode)
+        bool zeroCopyFrames = false; // NVDEC: lease mapped surfaces to consumers (no D2D copy)
+        int maxWidth = 0;            // Largest resolution of any profile: the decoder resizes in
+        int maxHeight = 0;           // place up to it (0 = opened stream, 1080p with a sub stream)
+        std::shared_ptr<gpu::GPUMemoryPool> memoryPool; // Shared surface allocator (set by StreamManager)
+        DecoderType decoderType = DecoderType::AUTO;    // AUTO: NVDEC, CPU if that fails
+        int cudaDeviceId = 0;        // NVDEC device, matching memoryPool (set by StreamManager)
+        bool lazyDecoder = false;    // start() only connects; the decode consumer calls startDecoder() at the first IDR
+        SourceFactory sourceFactory; // Empty: RtspClient on rtspUrl (benchmarks and tools supply their own)
+        ActivityGate::Config activityGate; // Keyframe-only decode while the scene is static (off by default)
+        int priority = 0;            // Load shedding order: lowest first; > 0 (alarm) is never stepped down
     };
 
     struct Stats {
         int currentFps = 0;
         int droppedFrames = 0;
+        int decimatedFrames = 0;     // Skipped before decode to match the quality's target FPS
         int decodedFrames = 0;
         size_t packetsInQueue = 0;
         size_t bytesReceived = 0;
@@ -70,25 +95,100 @@ public:
     CameraStream& operator=(const CameraStream&) = delete;
 
     // Lifecycle
-    bool start();
+    bool open();    // Connect only, so stream info is known before the decoder exists
+    bool start();   // Connects if needed, then creates the decoder (unless lazyDecoder)
+    bool startDecoder();  // lazyDecoder: create it now (decode consumer; false sets ERROR)
+
+    // stop() and reconnect() destroy the client and park the decoder: the camera
+    // must not be registered with a network or decode thread meanwhile
+    // (StreamManager detaches it first)
     void stop();
     bool reconnect();
+    void markFailed() { updateState(StreamState::ERROR); }  // Network side gave up on the session
 
-    // Quality control
+    // Quality control (any thread; the decode consumer applies it at its next slice)
+    // getQuality() is the tier decoded at: PAUSED while the activity gate is
+    // closed, else the requested one, lowered to the cap while the quality
+    // governor sheds load
     void setQuality(StreamQuality quality);
-    StreamQuality getQuality() const { return quality_.load(); }
+    StreamQuality getQuality() const;
+    StreamQuality getRequestedQuality() const { return quality_.load(); }
+    void setQualityCap(StreamQuality cap);   // FULLSCREEN = no cap
+    StreamQuality getQualityCap() const { return qualityCap_.load(); }
+
+    // Load shedding order (any thread; alarms raise it while they last)
+    void setPriority(int priority) { priority_ = priority; }
+    int getPriority() const { return priority_.load(); }
+
+    // Activity gating (decode consumer only): measureActivity() samples a
+    // decoded frame when the gate wants one; updateActivityGate() feeds the
+    // finished measurements to the gate (before the slice applies the quality)
+    void measureActivity(const FrameHandle& frame);
+    void updateActivityGate();
+    bool isIdleGated() const { return activityGate_.isGated(); }
 
     // State
     StreamState getState() const { return state_.load(); }
     bool isRunning() const { return state_.load() == StreamState::RUNNING; }
 
-    // Statistics
+    // Statistics (read from the lock-free counters; any thread)
     Stats getStats() const;
 
+    // Hot-path counters: the network thread records ingest, the decode consumer decode
+    metrics::CameraMetrics& getMetrics() { return metrics_; }
+    const metrics::CameraMetrics& getMetrics() const { return metrics_; }
+
+    // Joins per-frame stamps into stage latencies (decode consumer only)
+    metrics::FrameTracer& getTracer() { return tracer_; }
+
+    // Point-in-time copy of every counter, for a scrape (any thread, no locks)
+    void sampleMetrics(metrics::CameraSample& sample) const;
+
+    // Resolution and frame rate of the opened profile (after open())
+    bool getStreamInfo(int& width, int& height, int& framerate) const;
+
+    // Decoder placement, applied at the next start() (admission control)
+    void setDecoderType(DecoderType type) { config_.decoderType = type; }
+
+    // Move decoding to another CUDA device: rebuilds a running decoder there,
+    // resuming at the next IDR (on failure the old decoder is kept). The camera
+    // must not be registered with a decode scheduler meanwhile. Frames already
+    // handed out stay valid.
+    bool moveToDevice(int cudaDeviceId, std::shared_ptr<gpu::GPUMemoryPool> memoryPool);
+    int getDeviceId() const { return deviceId_.load(); }
+
+    // Network side: queue a packet for decoding and keep it in the GOP cache
+    // Returns: false if the packet queue dropped it
+    bool queuePacket(StreamPacket&& packet);
+
+    // Decode consumer: the decoder is new or left PAUSED and wants the cached
+    // GOP replayed (cleared by the call)
+    bool takePrimeRequest() { return primePending_.exchange(false); }
+
+    // Decode consumer: copy of the cached GOP; the queued packets it covers (and
+    // older ones) are discarded so nothing is decoded twice. continuous is false
+    // if the GOP predates a reconnect, so what follows needs a fresh IDR.
+    // Returns: false if nothing is cached
+    bool takeCachedGop(std::vector<StreamPacket>& packets, bool& continuous);
+
     // Accessors for internal components (used by StreamManager)
-    network::RtspClient* getRtspClient() { return rtspClient_.get(); }
+    network::StreamSource* getSource() { return source_.get(); }
     IDecoder* getDecoder() { return decoder_.get(); }
-    threading::BoundedQueue<StreamPacket>* getPacketQueue() { return &packetQueue_; }
+    PacketQueue* getPacketQueue() { return &packetQueue_; }
+    FrameDecimator* getDecimator() { return &decimator_; }   // Decode consumer only
+    FrameFanout* getFanout() { return &fanout_; }            // Frame subscribers of this camera
+    PacketFanout* getPacketFanout() { return &packetFanout_; }  // Compressed-stream subscribers
+
+    // Pinned-memory downloads for hostFrames subscribers (decode consumer only)
+    // ensureDownloader() creates it on the camera's device at first use; nullptr
+    // if that failed (no CUDA)
+    gpu::FrameDownloader* getDownloader() { return downloader_.get(); }
+    gpu::FrameDownloader* ensureDownloader();
+
+    // VRAM last reported to the GPU memory pool ledger, for decoders that
+    // don't allocate from the pool (decode consumer only)
+    size_t getAccountedGpuBytes() const { return accountedGpuBytes_; }
+    void setAccountedGpuBytes(size_t bytes) { accountedGpuBytes_ = bytes; }
 
     // Configuration
     const Config& getConfig() const { return config_; }
@@ -97,24 +197,39 @@ public:
 private:
     Config config_;
     std::atomic<StreamQuality> quality_;
+    std::atomic<StreamQuality> qualityCap_{StreamQuality::FULLSCREEN};
+    std::atomic<int> priority_;
+    std::mutex qualityMutex_;        // setQuality() and setQualityCap() apply one change at a time
     std::atomic<StreamState> state_{StreamState::STOPPED};
+    std::atomic<int> deviceId_;      // config_.cudaDeviceId, readable from any thread
 
     // Core components
-    std::unique_ptr<network::RtspClient> rtspClient_;
+    std::unique_ptr<network::StreamSource> source_;
     std::unique_ptr<IDecoder> decoder_;
-    threading::BoundedQueue<StreamPacket> packetQueue_;
+    PacketQueue packetQueue_;
+    FrameDecimator decimator_;
+    FrameFanout fanout_;
+    std::mutex gopMutex_;            // Cache and queue push/drain stay in step
+    GopCache gopCache_;
+    std::atomic<bool> primePending_{false};
+    PacketFanout packetFanout_;
+    size_t accountedGpuBytes_ = 0;
+    std::shared_ptr<gpu::FrameDownloader> downloader_;
+    bool downloaderFailed_ = false;
+    ActivityGate activityGate_;
+    std::unique_ptr<gpu::ActivityEstimator> activity_;  // Created at the first measurement
 
     // Statistics tracking
-    mutable std::mutex statsMutex_;
-    Stats stats_;
-    std::chrono::steady_clock::time_point lastFpsUpdate_;
-    int framesSinceLastUpdate_ = 0;
+    metrics::CameraMetrics metrics_;
+    metrics::FrameTracer tracer_{metrics_};
 
     // Internal helpers
-    bool initializeRtspClient();
+    static bool usesSubStream(StreamQuality quality);
+    StreamQuality cappedQuality() const;
+    void applyQuality(StreamQuality previous, StreamQuality quality);  // qualityMutex_ held
+    bool initializeSource();
     bool initializeDecoder();
     void updateState(StreamState newState);
-    void updateFps();
 };
 
 } // namespace stream
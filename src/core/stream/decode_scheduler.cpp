@@ -0,0 +1,215 @@
+// src/core/stream/decode_scheduler.cpp
+#include "decode_scheduler.h"
+#include "../codec/types.h"
+#include <algorithm>
+#include <iostream>
+
+namespace fluxvision {
+namespace stream {
+
+namespace {
+    // Pass advance for one access unit at weight 1 (stride = kStrideScale / weight)
+    constexpr uint64_t kStrideScale = 1 << 16;
+}
+
+DecodeScheduler::DecodeScheduler(const Config& config)
+    : config_(config)
+{
+    if (config_.maxUnitsPerSlice == 0) {
+        config_.maxUnitsPerSlice = 1;
+    }
+}
+
+DecodeScheduler::~DecodeScheduler() {
+    stop();
+}
+
+bool DecodeScheduler::start(threading::DecodeThreadPool* decodePool, SliceHandler handler) {
+    if (running_) {
+        return true;  // Already running
+    }
+
+    if (!decodePool || !handler) {
+        std::cerr << "DecodeScheduler: null decode pool or slice handler" << std::endl;
+        return false;
+    }
+
+    handler_ = std::move(handler);
+    running_ = true;
+
+    // Workers keep the scheduler alive: the pool may run a queued worker task
+    // after its owner is gone (e.g. a decode thread that failed CUDA setup)
+    auto self = shared_from_this();
+    const size_t numWorkers = decodePool->getThreadCount();
+
+    for (size_t i = 0; i < numWorkers; ++i) {
+        decodePool->post([self](threading::DecodeThreadPool::Context /* cudaContext */) {
+            // CUcontext is already current on the decode thread, decoders use it implicitly
+            self->workerLoop();
+        });
+    }
+
+    return true;
+}
+
+void DecodeScheduler::stop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    running_ = false;
+    readyCv_.notify_all();
+
+    // Wait for in-flight slices so the handler is never invoked after stop()
+    idleCv_.wait(lock, [this] { return activeWorkers_ == 0; });
+}
+
+bool DecodeScheduler::registerCamera(const std::string& id, CameraStream* camera) {
+    if (!camera) {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (entries_.find(id) != entries_.end()) {
+        return false;  // Already registered
+    }
+
+    auto entry = std::make_shared<Entry>();
+    entry->id = id;
+    entry->camera = camera;
+    entry->pass = globalPass_;
+    entries_[id] = entry;
+
+    // Packets may already be queued
+    if (!camera->getPacketQueue()->empty()) {
+        enqueueLocked(entry);
+    }
+
+    return true;
+}
+
+void DecodeScheduler::unregisterCamera(const std::string& id) {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    std::shared_ptr<Entry> entry = it->second;
+    entries_.erase(it);
+
+    // Queued copies are discarded lazily when popped
+    entry->removed = true;
+
+    idleCv_.wait(lock, [&entry] { return entry->state != EntryState::RUNNING; });
+}
+
+void DecodeScheduler::notifyPending(const std::string& id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    auto it = entries_.find(id);
+    if (it == entries_.end()) {
+        return;
+    }
+
+    Entry& entry = *it->second;
+
+    if (entry.state == EntryState::IDLE) {
+        enqueueLocked(it->second);
+    } else if (entry.state == EntryState::RUNNING) {
+        entry.rearm = true;  // Worker re-queues when its slice ends
+    }
+}
+
+DecodeScheduler::Stats DecodeScheduler::getStats() const {
+    Stats stats;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats.registeredCameras = entries_.size();
+        stats.readyCameras = ready_.size();
+    }
+
+    stats.slicesServed = slicesServed_.load();
+    stats.unitsServed = unitsServed_.load();
+
+    return stats;
+}
+
+void DecodeScheduler::workerLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+
+    if (!running_) {
+        return;
+    }
+
+    activeWorkers_++;
+
+    while (true) {
+        readyCv_.wait(lock, [this] { return !running_ || !ready_.empty(); });
+
+        if (!running_) {
+            break;
+        }
+
+        std::shared_ptr<Entry> entry = ready_.top().entry;
+        ready_.pop();
+
+        if (entry->removed) {
+            continue;
+        }
+
+        entry->state = EntryState::RUNNING;
+        entry->rearm = false;
+        globalPass_ = std::max(globalPass_, entry->pass);
+
+        lock.unlock();
+
+        size_t consumed = 0;
+        try {
+            consumed = handler_(*entry->camera, config_.maxUnitsPerSlice);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "DecodeScheduler: slice error for camera " << entry->id
+                      << ": " << e.what() << std::endl;
+        }
+
+        slicesServed_++;
+        unitsServed_ += consumed;
+
+        lock.lock();
+
+        // Charge the camera for the work done (at least one unit per turn)
+        uint32_t weight = weightFor(entry->camera->getQuality());
+        entry->pass += (kStrideScale / weight) * std::max<size_t>(consumed, 1);
+        entry->state = EntryState::IDLE;
+
+        if (!entry->removed && entry->camera->isRunning() &&
+            (entry->rearm || !entry->camera->getPacketQueue()->empty())) {
+            enqueueLocked(entry);
+        }
+
+        idleCv_.notify_all();
+    }
+
+    activeWorkers_--;
+    idleCv_.notify_all();
+}
+
+void DecodeScheduler::enqueueLocked(const std::shared_ptr<Entry>& entry) {
+    // Idle cameras don't bank credit: rejoin at the current virtual time
+    entry->pass = std::max(entry->pass, globalPass_);
+    entry->state = EntryState::QUEUED;
+
+    ready_.push({entry->pass, weightFor(entry->camera->getQuality()), nextSeq_++, entry});
+    readyCv_.notify_one();
+}
+
+uint32_t DecodeScheduler::weightFor(StreamQuality quality) {
+    // Weight by target frame rate: 1 (PAUSED) .. 30 (FULLSCREEN)
+    int fps = getTargetFPS(static_cast<fluxvision::StreamQuality>(quality));
+    return static_cast<uint32_t>(std::max(fps, 1));
+}
+
+} // namespace stream
+} // namespace fluxvision
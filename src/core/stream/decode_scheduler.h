@@ -0,0 +1,129 @@
+// src/core/stream/decode_scheduler.h
+// Multiplexed decode scheduler: a few decode threads serve many cameras
+// Cameras with pending packets sit on a ready-list ordered by quality-weighted fairness
+#pragma once
+
+#include "camera_stream.h"
+#include "../threading/decode_thread_pool.h"
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fluxvision {
+namespace stream {
+
+// Stride scheduler over cameras
+//
+// Each decode thread runs one long-lived worker that pops the ready camera with
+// the lowest pass value, decodes a bounded slice of access units, then advances
+// that camera's pass by stride * units. Stride is inversely proportional to the
+// target FPS of the camera's StreamQuality, so FULLSCREEN streams are served first
+// and proportionally more often than THUMBNAIL ones without starving either.
+// A camera is serviced by at most one worker at a time, which keeps its packet
+// queue single-consumer.
+class DecodeScheduler : public std::enable_shared_from_this<DecodeScheduler> {
+public:
+    struct Config {
+        size_t maxUnitsPerSlice = 4;   // Access units decoded per camera per turn
+    };
+
+    // Decodes up to maxUnits access units of one camera on a decode thread
+    // Returns the number of access units consumed from the camera's packet queue
+    using SliceHandler = std::function<size_t(CameraStream& camera, size_t maxUnits)>;
+
+    struct Stats {
+        size_t registeredCameras = 0;
+        size_t readyCameras = 0;
+        uint64_t slicesServed = 0;
+        uint64_t unitsServed = 0;
+    };
+
+    explicit DecodeScheduler(const Config& config);
+    ~DecodeScheduler();
+
+    // Delete copy/move
+    DecodeScheduler(const DecodeScheduler&) = delete;
+    DecodeScheduler& operator=(const DecodeScheduler&) = delete;
+
+    // Start one worker per decode thread (scheduler must be owned by a shared_ptr)
+    bool start(threading::DecodeThreadPool* decodePool, SliceHandler handler);
+
+    // Stop workers; waits for in-flight slices to finish
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+    // Camera registration (thread-safe)
+    // unregisterCamera() waits for an in-flight slice of the camera to return
+    bool registerCamera(const std::string& id, CameraStream* camera);
+    void unregisterCamera(const std::string& id);
+
+    // Signal that packets were pushed to the camera's queue (called by producers)
+    void notifyPending(const std::string& id);
+
+    // Statistics
+    Stats getStats() const;
+
+private:
+    enum class EntryState {
+        IDLE,      // Nothing pending
+        QUEUED,    // On the ready-list
+        RUNNING    // Being serviced by a worker
+    };
+
+    struct Entry {
+        std::string id;
+        CameraStream* camera = nullptr;
+        EntryState state = EntryState::IDLE;
+        bool rearm = false;      // Packets arrived while RUNNING
+        bool removed = false;    // Unregistered, drop when dequeued
+        uint64_t pass = 0;       // Virtual time consumed (stride scheduling)
+    };
+
+    struct ReadyItem {
+        uint64_t pass;
+        uint32_t weight;
+        uint64_t seq;
+        std::shared_ptr<Entry> entry;
+    };
+
+    // Min-heap on pass; higher weight wins ties, then FIFO order
+    struct ReadyOrder {
+        bool operator()(const ReadyItem& a, const ReadyItem& b) const {
+            if (a.pass != b.pass) return a.pass > b.pass;
+            if (a.weight != b.weight) return a.weight < b.weight;
+            return a.seq > b.seq;
+        }
+    };
+
+    Config config_;
+    SliceHandler handler_;
+    std::atomic<bool> running_{false};
+
+    mutable std::mutex mutex_;
+    std::condition_variable readyCv_;       // Ready-list became non-empty / stopping
+    std::condition_variable idleCv_;        // A slice finished / a worker exited
+    std::unordered_map<std::string, std::shared_ptr<Entry>> entries_;
+    std::priority_queue<ReadyItem, std::vector<ReadyItem>, ReadyOrder> ready_;
+    uint64_t globalPass_ = 0;               // Pass of the most recently dispatched camera
+    uint64_t nextSeq_ = 0;
+    size_t activeWorkers_ = 0;
+
+    // Statistics
+    std::atomic<uint64_t> slicesServed_{0};
+    std::atomic<uint64_t> unitsServed_{0};
+
+    void workerLoop();
+    void enqueueLocked(const std::shared_ptr<Entry>& entry);
+
+    static uint32_t weightFor(StreamQuality quality);
+};
+
+} // namespace stream
+} // namespace fluxvision
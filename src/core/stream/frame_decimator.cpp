@@ -0,0 +1,102 @@
+// src/core/stream/frame_decimator.cpp
+#include "frame_decimator.h"
+#include "camera_stream.h"
+#include "../codec/types.h"
+#include <algorithm>
+
+namespace fluxvision {
+namespace stream {
+
+namespace {
+    // Timestamp gaps above this are discontinuities, not frame spacing
+    constexpr int64_t kMaxFrameGapUs = 1000000;
+}
+
+FrameDecimator::FrameDecimator(StreamQuality quality)
+    : quality_(quality)
+{
+    setQuality(quality);
+}
+
+void FrameDecimator::setQuality(StreamQuality quality) {
+    quality_ = quality;
+    keyframesOnly_ = (quality == StreamQuality::PAUSED);
+
+    const int fps = getTargetFPS(static_cast<fluxvision::StreamQuality>(quality));
+    intervalUs_ = fps > 0 ? 1000000 / fps : 0;
+
+    // Start a fresh schedule at the next decoded picture
+    haveSchedule_ = false;
+}
+
+bool FrameDecimator::shouldDecode(const StreamPacket& packet) {
+    const int64_t ts = packet.timestamp;
+    trackFrameDuration(ts);
+
+    // Keyframes always go through: they refresh PAUSED tiles and repair the reference chain
+    if (packet.isKeyFrame) {
+        needKeyframe_ = false;
+        advanceSchedule(ts, true);
+        return true;
+    }
+
+    if (keyframesOnly_ || needKeyframe_) {
+        if (packet.isReference) {
+            needKeyframe_ = true;  // Later P frames would reference a missing picture
+        }
+        return skip();
+    }
+
+    // Without usable timestamps we can't measure the rate: decode everything
+    if (intervalUs_ == 0 || frameDurationUs_ == 0) {
+        return true;
+    }
+
+    // Timestamps jumped backwards (reconnect, wrap): restart the schedule
+    if (haveSchedule_ && nextDueUs_ - ts > 2 * intervalUs_) {
+        haveSchedule_ = false;
+    }
+
+    // Half a native frame of slack so jitter doesn't halve the delivered rate
+    const bool due = !haveSchedule_ || ts >= nextDueUs_ - frameDurationUs_ / 2;
+
+    if (!due && !packet.isReference) {
+        return skip();
+    }
+
+    advanceSchedule(ts, due);
+    return true;
+}
+
+void FrameDecimator::advanceSchedule(int64_t timestampUs, bool due) {
+    if (!haveSchedule_ || timestampUs - nextDueUs_ > intervalUs_) {
+        // First picture, or we fell behind by more than a slot: don't burst to catch up
+        nextDueUs_ = timestampUs + intervalUs_;
+        haveSchedule_ = true;
+    } else if (due) {
+        nextDueUs_ += intervalUs_;
+    } else {
+        // Forced early picture (reference or keyframe) counts as this slot's output
+        nextDueUs_ = std::max(nextDueUs_, timestampUs + intervalUs_);
+    }
+}
+
+bool FrameDecimator::skip() {
+    decimated_++;
+    return false;
+}
+
+void FrameDecimator::trackFrameDuration(int64_t timestampUs) {
+    const int64_t delta = timestampUs - lastTimestampUs_;
+    lastTimestampUs_ = timestampUs;
+
+    if (delta <= 0 || delta > kMaxFrameGapUs) {
+        return;
+    }
+
+    // Exponential moving average (1/8)
+    frameDurationUs_ = frameDurationUs_ == 0 ? delta : (frameDurationUs_ * 7 + delta) / 8;
+}
+
+} // namespace stream
+} // namespace fluxvision
@@ -0,0 +1,64 @@
+// src/core/stream/frame_decimator.h
+// Pre-decode frame decimation: decode only as many pictures as the quality tier displays
+#pragma once
+
+#include "packet_queue.h"
+#include <atomic>
+#include <cstdint>
+
+namespace fluxvision {
+namespace stream {
+
+enum class StreamQuality;
+
+// Decides per access unit whether it is worth decoding at the current quality
+//
+// - PAUSED: IDR pictures only (keyframe-only refresh).
+// - Other tiers: non-reference pictures (nal_ref_idc == 0) are skipped until the
+//   decoded rate, measured on packet timestamps, matches getTargetFPS() of the
+//   tier. Reference pictures are always decoded since later ones depend on them,
+//   so streams that mark every P frame as reference are only decimated in PAUSED.
+// - After reference pictures were skipped (PAUSED), nothing is decoded until the
+//   next IDR so the decoder never sees a broken reference chain.
+//
+// Thread-safety: shouldDecode()/setQuality() from the camera's decode consumer
+// only (the scheduler serves a camera on one worker at a time); counters may be
+// read from any thread.
+class FrameDecimator {
+public:
+    explicit FrameDecimator(StreamQuality quality);
+
+    // Switch tier (resets rate tracking; leaving PAUSED waits for an IDR)
+    void setQuality(StreamQuality quality);
+    StreamQuality getQuality() const { return quality_; }
+
+    // Fresh decoder: decode nothing until the next IDR
+    void resync() { needKeyframe_ = true; }
+
+    // True if the packet should be sent to the decoder
+    bool shouldDecode(const StreamPacket& packet);
+
+    // Packets skipped so far
+    uint64_t decimatedCount() const { return decimated_.load(); }
+
+private:
+    StreamQuality quality_;
+    int64_t intervalUs_ = 0;        // Minimum spacing of decoded pictures (0 = decode all)
+    bool keyframesOnly_ = false;
+    bool needKeyframe_ = false;     // A reference picture was skipped
+
+    // Rate tracking on packet timestamps (microseconds)
+    bool haveSchedule_ = false;
+    int64_t nextDueUs_ = 0;         // Timestamp at which the next picture is due
+    int64_t lastTimestampUs_ = 0;
+    int64_t frameDurationUs_ = 0;   // Smoothed native frame spacing
+
+    std::atomic<uint64_t> decimated_{0};
+
+    bool skip();
+    void advanceSchedule(int64_t timestampUs, bool due);
+    void trackFrameDuration(int64_t timestampUs);
+};
+
+} // namespace stream
+} // namespace fluxvision
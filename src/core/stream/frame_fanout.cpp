@@ -0,0 +1,239 @@
+// src/core/stream/frame_fanout.cpp
+#include "frame_fanout.h"
+#include <algorithm>
+
+namespace fluxvision {
+namespace stream {
+
+FrameSubscription::FrameSubscription(const Options& options)
+    : options_(options)
+    , queue_(options.policy == DropPolicy::QUEUE_N ? std::max<size_t>(options.queueDepth, 1) + 1 : 1)
+{
+    options_.queueDepth = std::max<size_t>(options_.queueDepth, 1);
+}
+
+void FrameSubscription::offer(const FrameHandle& frame) {
+    if (!frame || isCancelled()) {
+        return;
+    }
+
+    if (options_.policy == DropPolicy::QUEUE_N) {
+        // The ring rounds up to a power of two: enforce the configured depth ourselves
+        FrameHandle copy = frame;
+        if (queue_.size() >= options_.queueDepth || !queue_.push(std::move(copy))) {
+            dropped_++;
+            return;
+        }
+    } else {
+        slots_[back_] = frame;
+        const uint8_t previous = middle_.exchange(static_cast<uint8_t>(back_ | kFresh),
+                                                  std::memory_order_acq_rel);
+        back_ = previous & kIndexMask;
+
+        if (previous & kFresh) {
+            // The consumer never took it: hand the surface back now, not at the next publish
+            dropped_++;
+            slots_[back_].reset();
+        }
+    }
+
+    notifyWaiter();
+}
+
+bool FrameSubscription::poll(FrameHandle& frame) {
+    return take(frame);
+}
+
+bool FrameSubscription::waitForFrame(FrameHandle& frame, std::chrono::milliseconds timeout) {
+    if (take(frame)) {
+        return true;
+    }
+
+    waiters_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        frameReady_.wait_for(lock, timeout, [this] { return hasFrame() || isCancelled(); });
+    }
+    waiters_.fetch_sub(1);
+
+    return take(frame);
+}
+
+void FrameSubscription::cancel() {
+    cancelled_.store(true, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+    }
+    frameReady_.notify_all();
+}
+
+FrameSubscription::Stats FrameSubscription::getStats() const {
+    Stats stats;
+    stats.delivered = delivered_.load();
+    stats.dropped = dropped_.load();
+    return stats;
+}
+
+bool FrameSubscription::take(FrameHandle& frame) {
+    if (options_.policy == DropPolicy::QUEUE_N) {
+        if (!queue_.pop(frame)) {
+            return false;
+        }
+    } else {
+        if (!(middle_.load(std::memory_order_acquire) & kFresh)) {
+            return false;
+        }
+
+        const uint8_t previous = middle_.exchange(front_, std::memory_order_acq_rel);
+        front_ = previous & kIndexMask;
+        frame = std::move(slots_[front_]);
+    }
+
+    delivered_++;
+    return true;
+}
+
+bool FrameSubscription::hasFrame() const {
+    if (options_.policy == DropPolicy::QUEUE_N) {
+        return !queue_.empty();
+    }
+    return (middle_.load(std::memory_order_acquire) & kFresh) != 0;
+}
+
+void FrameSubscription::notifyWaiter() {
+    // Pairs with the fence in waitForFrame(): either the waiter sees the frame
+    // in its predicate, or we see the waiter and wake it
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+    }
+    frameReady_.notify_one();
+}
+
+FrameFanout::~FrameFanout() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& weak : subscribers_) {
+        if (auto subscription = weak.lock()) {
+            subscription->cancel();
+        }
+    }
+}
+
+std::shared_ptr<FrameSubscription> FrameFanout::subscribe(const FrameSubscription::Options& options) {
+    auto subscription = std::make_shared<FrameSubscription>(options);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pruneExpired();
+    subscribers_.push_back(subscription);
+    updateCounts();
+    version_.fetch_add(1, std::memory_order_release);
+
+    return subscription;
+}
+
+void FrameFanout::unsubscribe(const std::shared_ptr<FrameSubscription>& subscription) {
+    if (!subscription) {
+        return;
+    }
+
+    subscription->cancel();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+        [&](const std::weak_ptr<FrameSubscription>& weak) {
+            auto locked = weak.lock();
+            return !locked || locked == subscription;
+        }), subscribers_.end());
+    updateCounts();
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+size_t FrameFanout::publish(const FrameHandle& frame) {
+    return offer(frame, false);
+}
+
+size_t FrameFanout::publishDownloaded(const FrameHandle& frame) {
+    return offer(frame, true);
+}
+
+size_t FrameFanout::offer(const FrameHandle& frame, bool downloaded) {
+    // Pick up subscriber changes without ever waiting on subscribe()/unsubscribe()
+    if (version_.load(std::memory_order_acquire) != snapshotVersion_) {
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            snapshot_ = subscribers_;
+            snapshotVersion_ = version_.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t offered = 0;
+    bool sawExpired = false;
+
+    for (const auto& weak : snapshot_) {
+        auto subscription = weak.lock();
+        if (!subscription) {
+            sawExpired = true;
+            continue;
+        }
+        if (subscription->isCancelled()) {
+            continue;
+        }
+
+        // hostFrames subscribers get device frames only once downloaded
+        const bool wantsHost = subscription->getOptions().hostFrames;
+        if (downloaded ? !wantsHost : (wantsHost && frame && frame->cudaSurface)) {
+            continue;
+        }
+
+        subscription->offer(frame);
+        offered++;
+    }
+
+    // Subscribers that dropped their handle without unsubscribing
+    if (sawExpired) {
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            pruneExpired();
+        }
+    }
+
+    return offered;
+}
+
+size_t FrameFanout::subscriberCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_.size();
+}
+
+void FrameFanout::pruneExpired() {
+    const size_t before = subscribers_.size();
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+        [](const std::weak_ptr<FrameSubscription>& weak) { return weak.expired(); }),
+        subscribers_.end());
+
+    if (subscribers_.size() != before) {
+        updateCounts();
+        version_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void FrameFanout::updateCounts() {
+    size_t host = 0;
+    for (const auto& weak : subscribers_) {
+        auto subscription = weak.lock();
+        host += subscription && subscription->getOptions().hostFrames ? 1 : 0;
+    }
+
+    count_.store(subscribers_.size(), std::memory_order_release);
+    hostCount_.store(host, std::memory_order_release);
+}
+
+} // namespace stream
+} // namespace fluxvision
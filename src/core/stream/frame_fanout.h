@@ -0,0 +1,150 @@
+// src/core/stream/frame_fanout.h
+// Per-camera frame fan-out: independent subscribers, each with its own lock-free mailbox
+#pragma once
+
+#include "../codec/frame_lease.h"
+#include "../threading/bounded_queue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fluxvision {
+namespace stream {
+
+// What a mailbox does when its subscriber falls behind
+enum class DropPolicy {
+    LATEST_ONLY,  // Keep only the newest frame (live view)
+    QUEUE_N       // Keep up to queueDepth frames in order; newer frames are dropped when full
+};
+
+// One subscriber's mailbox for one camera
+//
+// The decode worker publishes (a camera is decoded by one worker at a time);
+// one consumer thread polls. Both sides are wait-free, so a slow or stuck
+// subscriber only loses its own frames. Dropped frames go straight back to
+// the decoder's pool.
+class FrameSubscription {
+public:
+    struct Options {
+        DropPolicy policy = DropPolicy::LATEST_ONLY;
+        size_t queueDepth = 4;       // QUEUE_N only
+        std::string name;            // For diagnostics ("live", "recorder", ...)
+        bool hostFrames = false;     // CPU pixels: NVDEC frames arrive downloaded to pinned host memory
+    };
+
+    struct Stats {
+        uint64_t delivered = 0;      // Frames taken by the consumer
+        uint64_t dropped = 0;        // Frames overwritten or rejected by the drop policy
+    };
+
+    explicit FrameSubscription(const Options& options);
+
+    // Delete copy/move
+    FrameSubscription(const FrameSubscription&) = delete;
+    FrameSubscription& operator=(const FrameSubscription&) = delete;
+
+    // Take the next frame (consumer side)
+    // Returns: true if a frame was taken, false if the mailbox is empty
+    bool poll(FrameHandle& frame);
+
+    // Like poll(), but waits up to timeout for a frame to arrive (consumer side)
+    bool waitForFrame(FrameHandle& frame, std::chrono::milliseconds timeout);
+
+    // Hand a frame to the mailbox (publisher side); no-op once cancelled
+    void offer(const FrameHandle& frame);
+
+    // Stop delivery; the publisher may still hand over a frame already in flight
+    void cancel();
+    bool isCancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+    const Options& getOptions() const { return options_; }
+    Stats getStats() const;
+
+private:
+    Options options_;
+    std::atomic<bool> cancelled_{false};
+
+    // LATEST_ONLY: triple buffer. The publisher owns back_, the consumer front_;
+    // middle_ is swapped atomically and carries a "fresh" bit.
+    static constexpr uint8_t kIndexMask = 0x3;
+    static constexpr uint8_t kFresh = 0x4;
+    FrameHandle slots_[3];
+    std::atomic<uint8_t> middle_{1};
+    uint8_t back_ = 0;               // Publisher only
+    uint8_t front_ = 2;              // Consumer only
+
+    // QUEUE_N
+    threading::BoundedQueue<FrameHandle> queue_;
+
+    // Wakeup for waitForFrame(); the publisher only touches the mutex while a
+    // consumer is waiting, and never for longer than the consumer's empty check
+    std::mutex waitMutex_;
+    std::condition_variable frameReady_;
+    std::atomic<int> waiters_{0};
+
+    // Statistics
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> dropped_{0};
+
+    bool take(FrameHandle& frame);
+    bool hasFrame() const;
+    void notifyWaiter();
+};
+
+// Subscriber registry for one camera
+//
+// subscribe()/unsubscribe() may be called from any thread. publish() is
+// lock-free in steady state: the publisher works on its own snapshot of the
+// subscriber list and only re-reads it (try_lock, never waiting) after the
+// list changed. Subscriptions are held weakly: dropping the last
+// shared_ptr unsubscribes.
+class FrameFanout {
+public:
+    FrameFanout() = default;
+    ~FrameFanout();  // Cancels remaining subscriptions (camera removed)
+
+    // Delete copy/move
+    FrameFanout(const FrameFanout&) = delete;
+    FrameFanout& operator=(const FrameFanout&) = delete;
+
+    std::shared_ptr<FrameSubscription> subscribe(const FrameSubscription::Options& options);
+    void unsubscribe(const std::shared_ptr<FrameSubscription>& subscription);
+
+    // Offer a frame to every subscriber (decode worker)
+    // Device frames skip hostFrames subscribers: they get the download instead
+    // Returns: number of subscribers the frame was offered to
+    size_t publish(const FrameHandle& frame);
+
+    // Offer a downloaded copy of a device frame to the hostFrames subscribers (decode worker)
+    size_t publishDownloaded(const FrameHandle& frame);
+
+    size_t subscriberCount() const;
+    bool hasSubscribers() const { return count_.load(std::memory_order_acquire) > 0; }
+    bool hasHostSubscribers() const { return hostCount_.load(std::memory_order_acquire) > 0; }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::weak_ptr<FrameSubscription>> subscribers_;
+    std::atomic<uint64_t> version_{0};
+    std::atomic<size_t> count_{0};
+    std::atomic<size_t> hostCount_{0};
+
+    // Publisher-only copy of subscribers_
+    std::vector<std::weak_ptr<FrameSubscription>> snapshot_;
+    uint64_t snapshotVersion_ = 0;
+
+    // Offer to the subscribers whose hostFrames matches downloaded (or to all)
+    size_t offer(const FrameHandle& frame, bool downloaded);
+
+    void updateCounts();  // mutex_ held
+    void pruneExpired();  // mutex_ held
+};
+
+} // namespace stream
+} // namespace fluxvision
@@ -0,0 +1,53 @@
+// src/core/stream/gop_cache.cpp
+#include "gop_cache.h"
+#include <algorithm>
+
+namespace fluxvision {
+namespace stream {
+
+GopCache::GopCache(size_t maxBytes, size_t maxPackets)
+    : maxBytes_(maxBytes)
+    , maxPackets_(maxPackets)
+{
+    packets_.reserve(std::min<size_t>(maxPackets_, 128));
+}
+
+void GopCache::append(const StreamPacket& packet) {
+    if (maxBytes_ == 0 || maxPackets_ == 0) {
+        return;  // Disabled
+    }
+
+    if (packet.isKeyFrame) {
+        clear();
+        sealed_ = false;
+    } else if (sealed_) {
+        return;
+    }
+
+    if (packets_.size() >= maxPackets_ || bytes_ + packet.data.size() > maxBytes_) {
+        // Too long to replay in a burst: wait for the next IDR
+        clear();
+        sealed_ = true;
+        return;
+    }
+
+    packets_.push_back(packet);
+    packets_.back().discardOlder = false;
+    bytes_ += packet.data.size();
+}
+
+void GopCache::seal() {
+    sealed_ = true;
+}
+
+void GopCache::snapshot(std::vector<StreamPacket>& packets) const {
+    packets.assign(packets_.begin(), packets_.end());
+}
+
+void GopCache::clear() {
+    packets_.clear();  // Keeps the capacity, releases the buffers
+    bytes_ = 0;
+}
+
+} // namespace stream
+} // namespace fluxvision
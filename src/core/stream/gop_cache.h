@@ -0,0 +1,52 @@
+// src/core/stream/gop_cache.h
+// Most recent GOP of a camera, kept as refcounted packets to prime new decoders
+#pragma once
+
+#include "packet_queue.h"
+#include <cstddef>
+#include <vector>
+
+namespace fluxvision {
+namespace stream {
+
+// Access units from the last IDR up to the newest picture received
+//
+// A decoder fed the cached GOP in a burst has the current picture at once
+// instead of waiting for the next IDR (2-4 s on typical cameras). The packets
+// share their buffers with the packet queue, so the cache only costs memory
+// for pictures that were already decoded. A GOP that outgrows the limits is
+// dropped whole: the tail of a GOP without its IDR can't be decoded.
+//
+// Thread-safety: not thread-safe (the owner serializes access).
+class GopCache {
+public:
+    explicit GopCache(size_t maxBytes = 8 * 1024 * 1024, size_t maxPackets = 300);
+
+    // Network side: a keyframe starts a new GOP, other pictures extend the current one
+    void append(const StreamPacket& packet);
+
+    // Stream discontinuity (reconnect): keep the cached GOP, but don't extend
+    // it with pictures of the new session until that session sends an IDR
+    void seal();
+    bool isSealed() const { return sealed_; }
+
+    // Copy of the cached GOP, keyframe first (refcount bumps only)
+    void snapshot(std::vector<StreamPacket>& packets) const;
+
+    void clear();
+
+    bool empty() const { return packets_.empty(); }
+    size_t size() const { return packets_.size(); }
+    size_t bytes() const { return bytes_; }
+
+private:
+    size_t maxBytes_;
+    size_t maxPackets_;
+
+    std::vector<StreamPacket> packets_;
+    size_t bytes_ = 0;
+    bool sealed_ = true;    // Nothing to extend until the first keyframe
+};
+
+} // namespace stream
+} // namespace fluxvision
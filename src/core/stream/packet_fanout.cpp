@@ -0,0 +1,213 @@
+// src/core/stream/packet_fanout.cpp
+#include "packet_fanout.h"
+#include <algorithm>
+
+namespace fluxvision {
+namespace stream {
+
+PacketSubscription::PacketSubscription(const Options& options)
+    : options_(options)
+{
+    options_.queueDepth = std::max<size_t>(options_.queueDepth, 2);
+
+    if (options_.policy == PacketDropPolicy::SHED_GOP) {
+        // PacketQueue keeps one ring slot free and headroom above its watermark
+        shedQueue_ = std::make_unique<PacketQueue>(options_.queueDepth + 1);
+    } else {
+        backlogQueue_ = std::make_unique<threading::BoundedQueue<StreamPacket>>(options_.queueDepth + 1);
+    }
+}
+
+void PacketSubscription::offer(const StreamPacket& packet) {
+    if (isCancelled()) {
+        return;
+    }
+
+    StreamPacket copy = packet;  // Refcount bump, not a copy of the bitstream
+
+    if (shedQueue_) {
+        // Counts its own drops, including the stale tail the consumer discards
+        shedQueue_->push(std::move(copy));
+    } else {
+        // Resume only at an IDR: the consumer gets a gap, never a broken GOP
+        if (skipToKeyframe_ && !packet.isKeyFrame) {
+            dropped_++;
+            return;
+        }
+
+        // The ring rounds up to a power of two: enforce the configured depth ourselves
+        copy.discardOlder = false;
+        if (backlogQueue_->size() >= options_.queueDepth || !backlogQueue_->push(std::move(copy))) {
+            skipToKeyframe_ = true;
+            dropped_++;
+            return;
+        }
+        skipToKeyframe_ = false;
+    }
+
+    notifyWaiter();
+}
+
+bool PacketSubscription::poll(StreamPacket& packet) {
+    return take(packet);
+}
+
+bool PacketSubscription::waitForPacket(StreamPacket& packet, std::chrono::milliseconds timeout) {
+    if (take(packet)) {
+        return true;
+    }
+
+    waiters_.fetch_add(1);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    {
+        std::unique_lock<std::mutex> lock(waitMutex_);
+        packetReady_.wait_for(lock, timeout, [this] { return hasPacket() || isCancelled(); });
+    }
+    waiters_.fetch_sub(1);
+
+    return take(packet);
+}
+
+void PacketSubscription::cancel() {
+    cancelled_.store(true, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+    }
+    packetReady_.notify_all();
+}
+
+size_t PacketSubscription::size() const {
+    return shedQueue_ ? shedQueue_->size() : backlogQueue_->size();
+}
+
+PacketSubscription::Stats PacketSubscription::getStats() const {
+    Stats stats;
+    stats.delivered = delivered_.load();
+    stats.dropped = shedQueue_ ? shedQueue_->droppedCount() : dropped_.load();
+    return stats;
+}
+
+bool PacketSubscription::take(StreamPacket& packet) {
+    const bool taken = shedQueue_ ? shedQueue_->pop(packet) : backlogQueue_->pop(packet);
+    if (!taken) {
+        return false;
+    }
+
+    delivered_++;
+    return true;
+}
+
+bool PacketSubscription::hasPacket() const {
+    return shedQueue_ ? !shedQueue_->empty() : !backlogQueue_->empty();
+}
+
+void PacketSubscription::notifyWaiter() {
+    // Pairs with the fence in waitForPacket()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (waiters_.load(std::memory_order_relaxed) == 0) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(waitMutex_);
+    }
+    packetReady_.notify_one();
+}
+
+PacketFanout::~PacketFanout() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    for (const auto& weak : subscribers_) {
+        if (auto subscription = weak.lock()) {
+            subscription->cancel();
+        }
+    }
+}
+
+std::shared_ptr<PacketSubscription> PacketFanout::subscribe(const PacketSubscription::Options& options) {
+    auto subscription = std::make_shared<PacketSubscription>(options);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    pruneExpired();
+    subscribers_.push_back(subscription);
+    count_.store(subscribers_.size(), std::memory_order_release);
+    version_.fetch_add(1, std::memory_order_release);
+
+    return subscription;
+}
+
+void PacketFanout::unsubscribe(const std::shared_ptr<PacketSubscription>& subscription) {
+    if (!subscription) {
+        return;
+    }
+
+    subscription->cancel();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+        [&](const std::weak_ptr<PacketSubscription>& weak) {
+            auto locked = weak.lock();
+            return !locked || locked == subscription;
+        }), subscribers_.end());
+    count_.store(subscribers_.size(), std::memory_order_release);
+    version_.fetch_add(1, std::memory_order_release);
+}
+
+size_t PacketFanout::publish(const StreamPacket& packet) {
+    // Pick up subscriber changes without ever waiting on subscribe()/unsubscribe()
+    if (version_.load(std::memory_order_acquire) != snapshotVersion_) {
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            snapshot_ = subscribers_;
+            snapshotVersion_ = version_.load(std::memory_order_relaxed);
+        }
+    }
+
+    size_t offered = 0;
+    bool sawExpired = false;
+
+    for (const auto& weak : snapshot_) {
+        auto subscription = weak.lock();
+        if (!subscription) {
+            sawExpired = true;
+            continue;
+        }
+        if (subscription->isCancelled()) {
+            continue;
+        }
+
+        subscription->offer(packet);
+        offered++;
+    }
+
+    // Subscribers that dropped their handle without unsubscribing
+    if (sawExpired) {
+        std::unique_lock<std::mutex> lock(mutex_, std::try_to_lock);
+        if (lock.owns_lock()) {
+            pruneExpired();
+        }
+    }
+
+    return offered;
+}
+
+size_t PacketFanout::subscriberCount() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return subscribers_.size();
+}
+
+void PacketFanout::pruneExpired() {
+    const size_t before = subscribers_.size();
+    subscribers_.erase(std::remove_if(subscribers_.begin(), subscribers_.end(),
+        [](const std::weak_ptr<PacketSubscription>& weak) { return weak.expired(); }),
+        subscribers_.end());
+
+    if (subscribers_.size() != before) {
+        count_.store(subscribers_.size(), std::memory_order_release);
+        version_.fetch_add(1, std::memory_order_release);
+    }
+}
+
+} // namespace stream
+} // namespace fluxvision
@@ -0,0 +1,132 @@
+// src/core/stream/packet_fanout.h
+// Per-camera packet fan-out: one RTSP ingest feeding any number of compressed-stream consumers
+#pragma once
+
+#include "packet_queue.h"
+#include "../threading/bounded_queue.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace fluxvision {
+namespace stream {
+
+// What a packet queue does when its consumer falls behind
+enum class PacketDropPolicy {
+    SHED_GOP,          // PacketQueue shedding: newest keyframe wins (live decode, restreaming)
+    KEEP_BACKLOG       // Keep what is queued, drop new packets until the next IDR (recording, export)
+};
+
+// One consumer's bounded queue of compressed access units for one camera
+//
+// The network thread pushes (one per camera); one consumer thread pops.
+// Packets share their refcounted buffers with every other consumer, so a
+// subscription costs a queue slot per packet, not a copy. Either policy only
+// ever drops whole GOP tails, so what comes out always decodes.
+class PacketSubscription {
+public:
+    struct Options {
+        PacketDropPolicy policy = PacketDropPolicy::SHED_GOP;
+        size_t queueDepth = 120;     // Access units (about 4 s at 30 fps)
+        std::string name;            // For diagnostics ("recorder", "restream", ...)
+    };
+
+    struct Stats {
+        uint64_t delivered = 0;      // Packets taken by the consumer
+        uint64_t dropped = 0;        // Packets dropped or discarded by the drop policy
+    };
+
+    explicit PacketSubscription(const Options& options);
+
+    // Delete copy/move
+    PacketSubscription(const PacketSubscription&) = delete;
+    PacketSubscription& operator=(const PacketSubscription&) = delete;
+
+    // Take the next packet (consumer side)
+    // Returns: true if a packet was taken, false if the queue is empty
+    bool poll(StreamPacket& packet);
+
+    // Like poll(), but waits up to timeout for a packet to arrive (consumer side)
+    bool waitForPacket(StreamPacket& packet, std::chrono::milliseconds timeout);
+
+    // Hand a packet to the queue (publisher side); no-op once cancelled
+    void offer(const StreamPacket& packet);
+
+    // Stop delivery; the publisher may still hand over a packet already in flight
+    void cancel();
+    bool isCancelled() const { return cancelled_.load(std::memory_order_acquire); }
+
+    size_t size() const;
+    const Options& getOptions() const { return options_; }
+    Stats getStats() const;
+
+private:
+    Options options_;
+    std::atomic<bool> cancelled_{false};
+
+    // SHED_GOP
+    std::unique_ptr<PacketQueue> shedQueue_;
+
+    // KEEP_BACKLOG
+    std::unique_ptr<threading::BoundedQueue<StreamPacket>> backlogQueue_;
+    bool skipToKeyframe_ = false;    // Publisher only
+
+    // Wakeup for waitForPacket(), as in FrameSubscription
+    std::mutex waitMutex_;
+    std::condition_variable packetReady_;
+    std::atomic<int> waiters_{0};
+
+    // Statistics
+    std::atomic<uint64_t> delivered_{0};
+    std::atomic<uint64_t> dropped_{0};   // KEEP_BACKLOG (PacketQueue counts its own)
+
+    bool take(StreamPacket& packet);
+    bool hasPacket() const;
+    void notifyWaiter();
+};
+
+// Packet subscriber registry for one camera
+//
+// Same contract as FrameFanout: subscribe()/unsubscribe() from any thread,
+// publish() lock-free in steady state on the network thread, subscriptions
+// held weakly.
+class PacketFanout {
+public:
+    PacketFanout() = default;
+    ~PacketFanout();  // Cancels remaining subscriptions (camera removed)
+
+    // Delete copy/move
+    PacketFanout(const PacketFanout&) = delete;
+    PacketFanout& operator=(const PacketFanout&) = delete;
+
+    std::shared_ptr<PacketSubscription> subscribe(const PacketSubscription::Options& options);
+    void unsubscribe(const std::shared_ptr<PacketSubscription>& subscription);
+
+    // Offer a packet to every subscriber (network thread)
+    // Returns: number of subscribers the packet was offered to
+    size_t publish(const StreamPacket& packet);
+
+    size_t subscriberCount() const;
+    bool hasSubscribers() const { return count_.load(std::memory_order_acquire) > 0; }
+
+private:
+    mutable std::mutex mutex_;
+    std::vector<std::weak_ptr<PacketSubscription>> subscribers_;
+    std::atomic<uint64_t> version_{0};
+    std::atomic<size_t> count_{0};
+
+    // Publisher-only copy of subscribers_
+    std::vector<std::weak_ptr<PacketSubscription>> snapshot_;
+    uint64_t snapshotVersion_ = 0;
+
+    void pruneExpired();  // mutex_ held
+};
+
+} // namespace stream
+} // namespace fluxvision
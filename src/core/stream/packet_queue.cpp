@@ -0,0 +1,118 @@
+// src/core/stream/packet_queue.cpp
+#include "packet_queue.h"
+
+namespace fluxvision {
+namespace stream {
+
+PacketQueue::PacketQueue(size_t capacity, size_t highWatermark)
+    : queue_(capacity)
+    , highWatermark_(highWatermark)
+{
+    // One slot of the ring is always free: usable depth is capacity - 1
+    const size_t usable = queue_.capacity() - 1;
+
+    if (highWatermark_ == 0) {
+        highWatermark_ = (usable * 3) / 4;
+    }
+    if (highWatermark_ == 0 || highWatermark_ > usable) {
+        highWatermark_ = usable;
+    }
+}
+
+bool PacketQueue::push(StreamPacket&& packet) {
+    packet.discardOlder = false;
+
+    if (skipToKeyframe_) {
+        // GOP already broken: nothing before the next IDR is decodable
+        if (!packet.isKeyFrame) {
+            droppedGop_++;
+            return false;
+        }
+        return pushKeyframe(std::move(packet));
+    }
+
+    if (queue_.size() >= highWatermark_) {
+        // Consumer is falling behind: start over at a fresh GOP when we can
+        if (packet.isKeyFrame) {
+            return pushKeyframe(std::move(packet));
+        }
+
+        if (!packet.isReference) {
+            droppedNonReference_++;
+            return false;
+        }
+
+        // Dropping a reference picture breaks the rest of the GOP
+        skipToKeyframe_ = true;
+        droppedGop_++;
+        return false;
+    }
+
+    const bool isReference = packet.isReference;
+    if (!queue_.push(std::move(packet))) {
+        droppedFull_++;
+        skipToKeyframe_ = isReference;
+        return false;
+    }
+
+    pushed_++;
+    return true;
+}
+
+bool PacketQueue::pushKeyframe(StreamPacket&& packet) {
+    const bool resync = !queue_.empty();
+    packet.discardOlder = resync;
+
+    if (!queue_.push(std::move(packet))) {
+        droppedFull_++;
+        skipToKeyframe_ = true;
+        return false;
+    }
+
+    skipToKeyframe_ = false;
+    pushed_++;
+
+    // Counted after publishing; pop() tolerates seeing the packet first
+    if (resync) {
+        pendingResyncs_.fetch_add(1, std::memory_order_release);
+    }
+
+    return true;
+}
+
+bool PacketQueue::pop(StreamPacket& packet) {
+    while (queue_.pop(packet)) {
+        if (packet.discardOlder) {
+            pendingResyncs_.fetch_sub(1, std::memory_order_acq_rel);
+            return true;
+        }
+
+        // A newer keyframe is queued behind this packet: skip the stale backlog
+        if (pendingResyncs_.load(std::memory_order_acquire) > 0) {
+            discardedStale_++;
+            continue;
+        }
+
+        return true;
+    }
+
+    return false;
+}
+
+uint64_t PacketQueue::droppedCount() const {
+    return droppedNonReference_.load() + droppedGop_.load() +
+           droppedFull_.load() + discardedStale_.load();
+}
+
+PacketQueue::Stats PacketQueue::getStats() const {
+    Stats stats;
+    stats.pushed = pushed_.load();
+    stats.droppedNonReference = droppedNonReference_.load();
+    stats.droppedGop = droppedGop_.load();
+    stats.droppedFull = droppedFull_.load();
+    stats.discardedStale = discardedStale_.load();
+    return stats;
+}
+
+} // namespace stream
+} // namespace fluxvision
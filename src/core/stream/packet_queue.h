@@ -0,0 +1,101 @@
+// src/core/stream/packet_queue.h
+// Per-camera packet queue with a GOP-aware overflow policy
+// Keeps the SPSC contract: the producer never pops, stale entries are discarded by the consumer
+#pragma once
+
+#include "../codec/packet_buffer.h"
+#include "../threading/bounded_queue.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace fluxvision {
+namespace stream {
+
+// Packet for per-camera queue
+struct StreamPacket {
+    PacketBuffer data;          // Refcounted slice of the received packet
+    int64_t timestamp = 0;
+    bool isKeyFrame = false;
+    bool isReference = true;    // nal_ref_idc != 0: later pictures may depend on it
+    bool discardOlder = false;  // Set by PacketQueue: everything queued before it is stale
+    int64_t receiveTime = 0;    // Steady clock (microseconds): read from the network
+    int64_t queuedTime = 0;     // Steady clock (microseconds): pushed to the queue
+};
+
+// Bounded SPSC access-unit queue that sheds load without breaking the decoder
+//
+// Once the queue is above its high watermark the producer drops, in order:
+// 1. non-reference pictures (nothing depends on them);
+// 2. the rest of the current GOP, from the first reference picture that does
+//    not fit until the next IDR (a P frame without its references only
+//    decodes to garbage);
+// When that IDR arrives it is queued behind the stale tail and flagged: the
+// consumer then discards everything older than it, so the decoder resumes at
+// the newest keyframe instead of working through a backlog it cannot display.
+// The headroom above the watermark keeps room for the resync keyframe.
+class PacketQueue {
+public:
+    struct Stats {
+        uint64_t pushed = 0;               // Packets queued
+        uint64_t droppedNonReference = 0;  // Non-reference pictures dropped on overflow
+        uint64_t droppedGop = 0;           // Pictures dropped while skipping to the next IDR
+        uint64_t droppedFull = 0;          // Packets rejected by a completely full queue
+        uint64_t discardedStale = 0;       // Queued packets discarded behind a resync keyframe
+    };
+
+    // highWatermark: depth at which dropping starts (0 = 3/4 of capacity)
+    explicit PacketQueue(size_t capacity = 60, size_t highWatermark = 0);
+
+    // Delete copy/move
+    PacketQueue(const PacketQueue&) = delete;
+    PacketQueue& operator=(const PacketQueue&) = delete;
+
+    // Push packet (producer side), applying the overflow policy
+    // Returns: true if queued, false if dropped
+    bool push(StreamPacket&& packet);
+
+    // Pop next packet to decode (consumer side), skipping stale entries
+    // Returns: true if popped, false if empty
+    bool pop(StreamPacket& packet);
+
+    // Check if empty (approximate, lock-free)
+    bool empty() const { return queue_.empty(); }
+
+    // Get current size (approximate)
+    size_t size() const { return queue_.size(); }
+
+    size_t capacity() const { return queue_.capacity(); }
+
+    // Producer is dropping until the next keyframe (producer side)
+    bool isSkippingToKeyframe() const { return skipToKeyframe_; }
+
+    // Packets dropped or discarded so far, for any reason
+    uint64_t droppedCount() const;
+
+    Stats getStats() const;
+
+private:
+    threading::BoundedQueue<StreamPacket> queue_;
+    size_t highWatermark_;
+
+    // Producer-only state
+    bool skipToKeyframe_ = false;
+
+    // Resync keyframes queued but not yet popped. Signed: the consumer may pop
+    // a flagged packet before the producer has counted it.
+    std::atomic<int32_t> pendingResyncs_{0};
+
+    // Statistics
+    std::atomic<uint64_t> pushed_{0};
+    std::atomic<uint64_t> droppedNonReference_{0};
+    std::atomic<uint64_t> droppedGop_{0};
+    std::atomic<uint64_t> droppedFull_{0};
+    std::atomic<uint64_t> discardedStale_{0};
+
+    // Queue packet, flagging it as a resync point if older packets are present
+    bool pushKeyframe(StreamPacket&& packet);
+};
+
+} // namespace stream
+} // namespace fluxvision
@@ -1,5 +1,11 @@
 // src/core/stream/pipeline.cpp
 #include "pipeline.h"
+#include "../codec/cpu_decode_budget.h"
+#include "../gpu/cuda_context.h"
+#include "../metrics/frame_trace.h"
+#include "../metrics/openmetrics.h"
+#include "../threading/cpu_topology.h"
+#include <algorithm>
 #include <iostream>
 
 namespace fluxvision {
@@ -22,52 +28,92 @@ bool StreamPipeline::initialize() {
 
     std::cout << "StreamPipeline: initializing..." << std::endl;
 
-    // 1. Initialize GPU Memory Pool
-    {
+    // Leftovers of a failed initialize()
+    decodePools_.clear();
+    memoryPools_.clear();
+    deviceIds_ = resolveDevices();
+
+    // Software decoders share one thread budget; admission sizes CPU fallback from it
+    CpuDecodeBudget::instance().setLimit(config_.cpuDecodeThreads);
+    DecoderPool::instance().setCapacity(config_.idleDecoders);
+    DecoderPool::instance().setMaxIdleAge(config_.idleDecoderAge);
+
+    // Nodes the pools are kept on (-1 = unknown or single node: leave to the scheduler)
+    const threading::CpuTopology& topology = threading::CpuTopology::instance();
+    const bool placeOnNodes = config_.numaPlacement && topology.getNodeCount() > 1;
+
+    // 1. Initialize GPU Memory Pools (one per device)
+    for (int deviceId : deviceIds_) {
         gpu::GPUMemoryPool::Config memConfig;
         memConfig.maxGpuMemoryBytes = config_.maxGpuMemoryBytes;
         memConfig.enableWarnings = config_.enableMemoryWarnings;
+        memConfig.cudaDeviceId = deviceId;
 
-        memoryPool_ = std::make_unique<gpu::GPUMemoryPool>(memConfig);
+        // Shared: decoders and outstanding frames keep it alive past shutdown()
+        auto memoryPool = std::make_shared<gpu::GPUMemoryPool>(memConfig);
 
-        if (!memoryPool_->initialize()) {
-            std::cerr << "StreamPipeline: failed to initialize GPU memory pool" << std::endl;
+        if (!memoryPool->initialize()) {
+            std::cerr << "StreamPipeline: failed to initialize GPU memory pool for CUDA device "
+                      << deviceId << std::endl;
             return false;
         }
 
-        std::cout << "StreamPipeline: GPU memory pool initialized (limit: "
-                  << (config_.maxGpuMemoryBytes / (1024 * 1024)) << " MB)" << std::endl;
+        memoryPools_.push_back(std::move(memoryPool));
+
+        std::cout << "StreamPipeline: GPU memory pool initialized (CUDA device " << deviceId
+                  << ", limit: " << (config_.maxGpuMemoryBytes / (1024 * 1024)) << " MB)" << std::endl;
     }
 
     // 2. Initialize Network Thread Pool
     {
-        networkPool_ = std::make_unique<threading::NetworkThreadPool>(config_.networkThreads);
+        threading::NetworkThreadPool::Config networkConfig;
+        networkConfig.numThreads = config_.networkThreads;
+        networkConfig.enableReactor = config_.enableNetworkReactor;
+        networkConfig.numaNode = placeOnNodes ? topology.nodeOfNetworkInterface(config_.networkInterface) : -1;
+
+        networkPool_ = std::make_unique<threading::NetworkThreadPool>(networkConfig);
 
         std::cout << "StreamPipeline: network thread pool initialized ("
-                  << config_.networkThreads << " threads)" << std::endl;
+                  << config_.networkThreads << " threads, "
+                  << (networkPool_->isReactorMode() ? "reactor" : "pinned") << " mode";
+        if (networkConfig.numaNode >= 0) {
+            std::cout << ", NUMA node " << networkConfig.numaNode;
+        }
+        std::cout << ")" << std::endl;
     }
 
-    // 3. Initialize Decode Thread Pool
-    {
+    // 3. Initialize Decode Thread Pools (one per device, contexts on that device)
+    for (int deviceId : deviceIds_) {
         threading::DecodeThreadPool::Config decodeConfig;
         decodeConfig.numThreads = config_.decodeThreads;
-        decodeConfig.cudaDeviceId = config_.cudaDeviceId;
+        decodeConfig.cudaDeviceId = deviceId;
         decodeConfig.enableWorkStealing = true;
+        decodeConfig.numaNode = placeOnNodes ? topology.nodeOfCudaDevice(deviceId) : -1;
 
-        decodePool_ = std::make_unique<threading::DecodeThreadPool>(decodeConfig);
+        decodePools_.push_back(std::make_unique<threading::DecodeThreadPool>(decodeConfig));
 
         std::cout << "StreamPipeline: decode thread pool initialized ("
-                  << config_.decodeThreads << " threads, CUDA device "
-                  << config_.cudaDeviceId << ")" << std::endl;
+                  << config_.decodeThreads << " threads, CUDA device " << deviceId;
+        if (decodeConfig.numaNode >= 0) {
+            std::cout << ", NUMA node " << decodeConfig.numaNode;
+        }
+        std::cout << ")" << std::endl;
     }
 
     // 4. Initialize Stream Manager
     {
+        std::vector<DecodeDevice> devices;
+        for (size_t i = 0; i < deviceIds_.size(); ++i) {
+            DecodeDevice device;
+            device.cudaDeviceId = deviceIds_[i];
+            device.decodePool = decodePools_[i].get();
+            device.memoryPool = memoryPools_[i].get();
+            devices.push_back(device);
+        }
+
         streamManager_ = std::make_unique<StreamManager>();
 
-        if (!streamManager_->initialize(networkPool_.get(),
-                                       decodePool_.get(),
-                                       memoryPool_.get())) {
+        if (!streamManager_->initialize(networkPool_.get(), devices, config_.admission)) {
             std::cerr << "StreamPipeline: failed to initialize stream manager" << std::endl;
             return false;
         }
@@ -75,12 +121,46 @@ bool StreamPipeline::initialize() {
         std::cout << "StreamPipeline: stream manager initialized" << std::endl;
     }
 
+    // Load-adaptive tier caps over every camera
+    if (config_.governor.enabled) {
+        QualityGovernor::Config governorConfig = config_.governor;
+        governorConfig.nvdecCapacity = config_.admission.nvdecCapacity;
+
+        std::vector<gpu::GPUMemoryPool*> memoryPools;
+        for (const auto& memoryPool : memoryPools_) {
+            memoryPools.push_back(memoryPool.get());
+        }
+
+        governor_ = std::make_unique<QualityGovernor>(governorConfig, streamManager_.get(),
+                                                      std::move(memoryPools), deviceIds_);
+        if (!governor_->start()) {
+            std::cerr << "StreamPipeline: quality governor unavailable" << std::endl;
+            governor_.reset();
+        }
+    }
+
+    // Scrapes read the cameras' counters only; a busy port doesn't stop streaming
+    if (config_.enableMetrics) {
+        StreamManager* streams = streamManager_.get();
+        metricsServer_ = std::make_unique<metrics::MetricsServer>(config_.metrics, [streams]() {
+            return metrics::renderOpenMetrics(streams->collectMetrics());
+        });
+
+        if (!metricsServer_->start()) {
+            std::cerr << "StreamPipeline: metrics endpoint unavailable" << std::endl;
+            metricsServer_.reset();
+        }
+    }
+
+    metrics::TraceBuffer::instance().setEnabled(config_.enableFrameTracing);
+
     initialized_ = true;
 
     std::cout << "StreamPipeline: initialization complete" << std::endl;
     std::cout << "  - Network threads: " << config_.networkThreads << std::endl;
-    std::cout << "  - Decode threads: " << config_.decodeThreads << std::endl;
-    std::cout << "  - GPU memory limit: " << (config_.maxGpuMemoryBytes / (1024 * 1024)) << " MB" << std::endl;
+    std::cout << "  - CUDA devices: " << deviceIds_.size() << std::endl;
+    std::cout << "  - Decode threads: " << config_.decodeThreads << " per device" << std::endl;
+    std::cout << "  - GPU memory limit: " << (config_.maxGpuMemoryBytes / (1024 * 1024)) << " MB per device" << std::endl;
     std::cout << "  - Packet queue size: " << config_.packetQueueSize << std::endl;
 
     return true;
@@ -94,24 +174,36 @@ void StreamPipeline::shutdown() {
     std::cout << "StreamPipeline: shutting down..." << std::endl;
 
     // Shutdown in reverse order of initialization
+    if (metricsServer_) {
+        metricsServer_->stop();
+        metricsServer_.reset();
+    }
+
+    if (governor_) {
+        governor_->stop();
+        governor_.reset();
+    }
+
     if (streamManager_) {
         streamManager_->shutdown();
         streamManager_.reset();
     }
 
-    if (decodePool_) {
-        decodePool_->shutdown(true);  // Wait for pending tasks
-        decodePool_.reset();
+    // Parked decoders hold the devices' contexts and memory pools
+    DecoderPool::instance().clear();
+
+    for (auto& decodePool : decodePools_) {
+        decodePool->shutdown(true);  // Wait for pending tasks
     }
+    decodePools_.clear();
 
     if (networkPool_) {
         networkPool_->shutdown(true);  // Wait for pending tasks
         networkPool_.reset();
     }
 
-    if (memoryPool_) {
-        memoryPool_.reset();
-    }
+    memoryPools_.clear();
+    deviceIds_.clear();
 
     initialized_ = false;
 
@@ -125,20 +217,67 @@ PipelineStats StreamPipeline::getStats() const {
         stats.networkPoolStats = networkPool_->getStats();
     }
 
-    if (decodePool_) {
-        stats.decodePoolStats = decodePool_->getStats();
+    for (size_t i = 0; i < deviceIds_.size(); ++i) {
+        DeviceStats device;
+        device.cudaDeviceId = deviceIds_[i];
+        device.decodePoolStats = decodePools_[i]->getStats();
+        device.memoryStats = memoryPools_[i]->getStats();
+        stats.devices.push_back(std::move(device));
     }
 
-    if (memoryPool_) {
-        stats.memoryStats = memoryPool_->getStats();
+    if (!stats.devices.empty()) {
+        stats.decodePoolStats = stats.devices.front().decodePoolStats;
+        stats.memoryStats = stats.devices.front().memoryStats;
     }
 
     if (streamManager_) {
         stats.streamStats = streamManager_->getGlobalStats();
     }
 
+    stats.decoderPoolStats = DecoderPool::instance().getStats();
+
+    if (governor_) {
+        stats.governorStats = governor_->getStats();
+    }
+
     return stats;
 }
 
+threading::DecodeThreadPool* StreamPipeline::getDecodePool(size_t device) {
+    return device < decodePools_.size() ? decodePools_[device].get() : nullptr;
+}
+
+gpu::GPUMemoryPool* StreamPipeline::getMemoryPool(size_t device) {
+    return device < memoryPools_.size() ? memoryPools_[device].get() : nullptr;
+}
+
+std::vector<int> StreamPipeline::resolveDevices() const {
+    if (config_.useAllDevices) {
+        const int count = CudaContext::getDeviceCount();
+        if (count > 0) {
+            std::vector<int> all(static_cast<size_t>(count));
+            for (int i = 0; i < count; ++i) {
+                all[i] = i;
+            }
+            return all;
+        }
+        std::cerr << "StreamPipeline: no CUDA devices found, using device "
+                  << config_.cudaDeviceId << std::endl;
+    }
+
+    if (!config_.cudaDeviceIds.empty()) {
+        // Duplicates would give one device two schedulers
+        std::vector<int> devices;
+        for (int deviceId : config_.cudaDeviceIds) {
+            if (std::find(devices.begin(), devices.end(), deviceId) == devices.end()) {
+                devices.push_back(deviceId);
+            }
+        }
+        return devices;
+    }
+
+    return {config_.cudaDeviceId};
+}
+
 } // namespace stream
 } // namespace fluxvision
@@ -3,20 +3,34 @@
 #pragma once
 
 #include "stream_manager.h"
+#include "quality_governor.h"
+#include "../codec/decoder_pool.h"
 #include "../threading/network_thread_pool.h"
 #include "../threading/decode_thread_pool.h"
 #include "../gpu/memory_pool.h"
+#include "../metrics/metrics_server.h"
 #include <memory>
+#include <vector>
 
 namespace fluxvision {
 namespace stream {
 
+// Per-device statistics
+struct DeviceStats {
+    int cudaDeviceId = 0;
+    threading::DecodeThreadPool::Stats decodePoolStats;
+    gpu::GPUMemoryPool::Stats memoryStats;
+};
+
 // Complete pipeline statistics
 struct PipelineStats {
     threading::ThreadPool::Stats networkPoolStats;
-    threading::DecodeThreadPool::Stats decodePoolStats;
-    gpu::GPUMemoryPool::Stats memoryStats;
+    threading::DecodeThreadPool::Stats decodePoolStats;  // First device
+    gpu::GPUMemoryPool::Stats memoryStats;               // First device
+    std::vector<DeviceStats> devices;
     GlobalStats streamStats;
+    DecoderPool::Stats decoderPoolStats;
+    QualityGovernor::Stats governorStats;
 };
 
 // Complete streaming pipeline for 42+ cameras
@@ -25,19 +39,46 @@ public:
     struct Config {
         // Thread pool configuration
         size_t networkThreads = 8;      // Network receive threads
-        size_t decodeThreads = 4;       // Hardware decode threads
+        bool enableNetworkReactor = false; // Shared reactor threads instead of a pinned thread per camera (see NetworkReactor)
+        size_t decodeThreads = 4;       // Hardware decode threads (per device)
         int cudaDeviceId = 0;           // CUDA device for decoding
+        std::vector<int> cudaDeviceIds; // Multi-GPU: decode on these devices instead
+        bool useAllDevices = false;     // Multi-GPU: decode on every CUDA device found
+
+        // NUMA placement (multi-socket only): decode workers on their GPU's node,
+        // network threads on the node servicing the NIC's interrupts
+        bool numaPlacement = true;
+        std::string networkInterface;   // NIC the cameras arrive on ("" = default route)
 
         // Queue configuration
         size_t packetQueueSize = 60;    // Per-camera packet queue size (2 seconds @ 30fps)
 
         // GPU memory configuration
-        size_t maxGpuMemoryBytes = 3ULL * 1024 * 1024 * 1024;  // 3GB limit
+        size_t maxGpuMemoryBytes = 3ULL * 1024 * 1024 * 1024;  // 3GB limit (per device)
         bool enableMemoryWarnings = true;
 
+        // Admission control (NVDEC/CPU decode capacity)
+        AdmissionController::Config admission;
+        size_t cpuDecodeThreads = 0;    // Threads all CPU decoders share (0 = one per core)
+
+        // Under load, step background cameras' tiers down (and back up as it eases);
+        // governor.nvdecCapacity follows admission.nvdecCapacity
+        QualityGovernor::Config governor;
+
+        // Decoders parked by stopped/reconnecting cameras for the next compatible camera
+        size_t idleDecoders = 16;       // 0 = always create a new decoder
+        std::chrono::seconds idleDecoderAge{300};
+
         // Surface configuration (for pre-allocation)
         uint32_t defaultSurfaceWidth = 1920;
         uint32_t defaultSurfaceHeight = 1080;
+
+        // Prometheus/OpenMetrics scrape endpoint
+        bool enableMetrics = false;
+        metrics::MetricsServer::Config metrics;
+
+        // Keep per-frame stage timestamps for metrics::TraceBuffer dumps
+        bool enableFrameTracing = false;
     };
 
     explicit StreamPipeline(const Config& config);
@@ -59,10 +100,11 @@ public:
     // Access to stream manager (main interface)
     StreamManager* getStreamManager() { return streamManager_.get(); }
 
-    // Access to thread pools (for advanced use)
+    // Access to thread pools (for advanced use); device: index into getDeviceIds()
     threading::NetworkThreadPool* getNetworkPool() { return networkPool_.get(); }
-    threading::DecodeThreadPool* getDecodePool() { return decodePool_.get(); }
-    gpu::GPUMemoryPool* getMemoryPool() { return memoryPool_.get(); }
+    threading::DecodeThreadPool* getDecodePool(size_t device = 0);
+    gpu::GPUMemoryPool* getMemoryPool(size_t device = 0);
+    const std::vector<int>& getDeviceIds() const { return deviceIds_; }
 
     // Statistics from all components
     PipelineStats getStats() const;
@@ -74,11 +116,16 @@ private:
     Config config_;
     std::atomic<bool> initialized_{false};
 
-    // Core components (owned by pipeline)
+    // Core components (owned by pipeline); decode and memory pools per device
+    std::vector<int> deviceIds_;
     std::unique_ptr<threading::NetworkThreadPool> networkPool_;
-    std::unique_ptr<threading::DecodeThreadPool> decodePool_;
-    std::unique_ptr<gpu::GPUMemoryPool> memoryPool_;
+    std::vector<std::unique_ptr<threading::DecodeThreadPool>> decodePools_;
+    std::vector<std::shared_ptr<gpu::GPUMemoryPool>> memoryPools_;
     std::unique_ptr<StreamManager> streamManager_;
+    std::unique_ptr<metrics::MetricsServer> metricsServer_;
+    std::unique_ptr<QualityGovernor> governor_;
+
+    std::vector<int> resolveDevices() const;
 };
 
 } // namespace stream
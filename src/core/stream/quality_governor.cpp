@@ -0,0 +1,321 @@
+// src/core/stream/quality_governor.cpp
+#include "quality_governor.h"
+#include "../gpu/device_monitor.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+
+namespace fluxvision {
+namespace stream {
+
+namespace {
+    const char* qualityName(StreamQuality quality) {
+        static const char* const names[] = {"PAUSED", "THUMBNAIL", "GRID_VIEW", "FOCUSED", "FULLSCREEN"};
+        return names[static_cast<int>(quality)];
+    }
+
+    StreamQuality stepQuality(StreamQuality quality, int delta) {
+        const int tier = std::clamp(static_cast<int>(quality) + delta,
+                                    static_cast<int>(StreamQuality::PAUSED),
+                                    static_cast<int>(StreamQuality::FULLSCREEN));
+        return static_cast<StreamQuality>(tier);
+    }
+
+    int domainOf(const CameraLoad& camera) {
+        return camera.hardware ? static_cast<int>(camera.device) : -1;
+    }
+}
+
+QualityGovernor::Config::Config()
+    : minQuality(StreamQuality::THUMBNAIL)
+    , protectedQuality(StreamQuality::FULLSCREEN)
+{
+}
+
+QualityGovernor::QualityGovernor(const Config& config, StreamManager* streamManager,
+                                 std::vector<gpu::GPUMemoryPool*> memoryPools,
+                                 std::vector<int> cudaDeviceIds)
+    : config_(config)
+    , streamManager_(streamManager)
+    , memoryPools_(std::move(memoryPools))
+    , cudaDeviceIds_(std::move(cudaDeviceIds))
+{
+    config_.stepsPerDecision = std::max<size_t>(config_.stepsPerDecision, 1);
+}
+
+QualityGovernor::~QualityGovernor() {
+    stop();
+}
+
+bool QualityGovernor::start() {
+    if (thread_.joinable()) {
+        return true;
+    }
+
+    if (!streamManager_) {
+        std::cerr << "QualityGovernor: no stream manager" << std::endl;
+        return false;
+    }
+
+    // First CPU sample: the busy fraction is measured between evaluations
+    sampleCpuBusy();
+
+    stopping_ = false;
+    thread_ = std::thread(&QualityGovernor::run, this);
+    return true;
+}
+
+void QualityGovernor::stop() {
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void QualityGovernor::run() {
+    std::unique_lock<std::mutex> lock(wakeMutex_);
+    while (!wake_.wait_for(lock, config_.interval, [this] { return stopping_; })) {
+        lock.unlock();
+        evaluate();
+        lock.lock();
+    }
+}
+
+void QualityGovernor::evaluate() {
+    const auto now = std::chrono::steady_clock::now();
+    std::vector<CameraLoad> cameras = streamManager_->collectLoad();
+    const double cpu = sampleCpuBusy();
+
+    // Pressure of each domain: every device, and the CPU decoder if it has cameras
+    std::map<int, Pressure> pressures;
+    std::map<int, size_t> queued;
+    std::vector<double> modelledLoad(memoryPools_.size(), 0.0);
+    bool cpuCameras = false;
+
+    for (const CameraLoad& camera : cameras) {
+        const int domain = domainOf(camera);
+        cpuCameras = cpuCameras || domain == kCpuDomain;
+        if (camera.queueCapacity > 0) {
+            pressures[domain].queue += static_cast<double>(camera.queueDepth) / camera.queueCapacity;
+            queued[domain]++;
+        }
+        if (camera.hardware && camera.device < modelledLoad.size()) {
+            modelledLoad[camera.device] += camera.decodeLoad;
+        }
+    }
+
+    for (auto& [domain, pressure] : pressures) {
+        pressure.queue /= static_cast<double>(std::max<size_t>(queued[domain], 1));
+    }
+
+    for (size_t device = 0; device < memoryPools_.size(); ++device) {
+        Pressure& pressure = pressures[static_cast<int>(device)];
+
+        const int measured = device < cudaDeviceIds_.size()
+                                 ? gpu::DeviceMonitor::instance().getDecoderUtilization(cudaDeviceIds_[device])
+                                 : -1;
+        pressure.nvdec = measured >= 0 ? measured / 100.0
+                                       : modelledLoad[device] / std::max(config_.nvdecCapacity, 1.0);
+        pressure.vram = memoryPools_[device] ? memoryPools_[device]->getStats().utilizationPercent / 100.0 : 0.0;
+        pressure.cpu = cpuCameras ? 0.0 : cpu;
+    }
+    if (cpuCameras) {
+        pressures[kCpuDomain].cpu = cpu;
+    }
+
+    // Cameras that must not be held down lose their cap at once
+    for (CameraLoad& camera : cameras) {
+        if (camera.cap < camera.requested &&
+            (camera.priority > 0 || camera.requested >= config_.protectedQuality)) {
+            streamManager_->setQualityCap(camera.cameraId, StreamQuality::FULLSCREEN);
+            steps_.erase(camera.cameraId);
+            camera.cap = StreamQuality::FULLSCREEN;
+        }
+    }
+
+    Stats round;
+    for (auto& [domainId, pressure] : pressures) {
+        round.queuePressure = std::max(round.queuePressure, pressure.queue);
+        round.nvdecPressure = std::max(round.nvdecPressure, pressure.nvdec);
+        round.vramPressure = std::max(round.vramPressure, pressure.vram);
+        round.cpuPressure = std::max(round.cpuPressure, pressure.cpu);
+
+        Domain& domain = domains_[domainId];
+        const bool overload = overloaded(pressure);
+        const bool relax = relaxed(pressure);
+        round.overloadedDomains += overload ? 1 : 0;
+
+        if (!relax) {
+            domain.relaxed = false;
+        } else if (!domain.relaxed) {
+            domain.relaxed = true;
+            domain.relaxedSince = now;
+        }
+
+        if (now < domain.settledAt) {
+            continue;
+        }
+
+        if (overload) {
+            // Lowest priority, lowest requested tier, stepped least
+            std::vector<const CameraLoad*> candidates;
+            for (const CameraLoad& camera : cameras) {
+                const StreamQuality capped = std::min(camera.requested, camera.cap);
+                if (domainOf(camera) == domainId && camera.priority <= 0 && !camera.idleGated &&
+                    camera.requested < config_.protectedQuality && capped > config_.minQuality) {
+                    candidates.push_back(&camera);
+                }
+            }
+            std::sort(candidates.begin(), candidates.end(), [this](const CameraLoad* a, const CameraLoad* b) {
+                if (a->priority != b->priority) {
+                    return a->priority < b->priority;
+                }
+                if (a->requested != b->requested) {
+                    return a->requested < b->requested;
+                }
+                const int stepsA = steps_.count(a->cameraId) ? steps_.at(a->cameraId) : 0;
+                const int stepsB = steps_.count(b->cameraId) ? steps_.at(b->cameraId) : 0;
+                if (stepsA != stepsB) {
+                    return stepsA < stepsB;
+                }
+                return a->cameraId < b->cameraId;
+            });
+
+            const size_t count = std::min(candidates.size(), config_.stepsPerDecision);
+            for (size_t i = 0; i < count; ++i) {
+                const CameraLoad& camera = *candidates[i];
+                const StreamQuality cap = stepQuality(std::min(camera.requested, camera.cap), -1);
+                streamManager_->setQualityCap(camera.cameraId, cap);
+                steps_[camera.cameraId]++;
+                round.stepsDown++;
+
+                std::cout << "QualityGovernor: camera " << camera.cameraId << " down to " << qualityName(cap)
+                          << " (queue " << pressure.queue << ", nvdec " << pressure.nvdec
+                          << ", vram " << pressure.vram << ", cpu " << pressure.cpu << ")" << std::endl;
+            }
+
+            if (count > 0) {
+                domain.settledAt = now + config_.settleTime;
+            }
+            domain.relaxed = false;
+            continue;
+        }
+
+        if (!domain.relaxed || now - domain.relaxedSince < config_.recoverAfter) {
+            continue;
+        }
+
+        // Relaxed long enough: the most important capped camera gets a tier back
+        const CameraLoad* best = nullptr;
+        for (const CameraLoad& camera : cameras) {
+            if (domainOf(camera) != domainId || camera.cap >= camera.requested) {
+                continue;
+            }
+            if (!best || camera.priority > best->priority ||
+                (camera.priority == best->priority && camera.requested > best->requested)) {
+                best = &camera;
+            }
+        }
+
+        if (best) {
+            StreamQuality cap = stepQuality(best->cap, 1);
+            if (cap >= best->requested) {
+                cap = StreamQuality::FULLSCREEN;   // Uncapped
+                steps_.erase(best->cameraId);
+            } else {
+                steps_[best->cameraId]--;
+            }
+            streamManager_->setQualityCap(best->cameraId, cap);
+            round.stepsUp++;
+            domain.settledAt = now + config_.settleTime;
+
+            std::cout << "QualityGovernor: camera " << best->cameraId << " back up to "
+                      << qualityName(std::min(cap, best->requested)) << std::endl;
+        }
+    }
+
+    // Forget cameras that left; count the ones still held down
+    std::map<std::string, int> steps;
+    for (const CameraLoad& camera : cameras) {
+        auto it = steps_.find(camera.cameraId);
+        if (it != steps_.end()) {
+            steps.insert(*it);
+        }
+        round.governedCameras += camera.cap < camera.requested ? 1 : 0;
+    }
+    steps_.swap(steps);
+
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    round.stepsDown += stats_.stepsDown;
+    round.stepsUp += stats_.stepsUp;
+    stats_ = round;
+}
+
+QualityGovernor::Stats QualityGovernor::getStats() const {
+    std::lock_guard<std::mutex> lock(statsMutex_);
+    return stats_;
+}
+
+bool QualityGovernor::overloaded(const Pressure& pressure) const {
+    return pressure.queue > config_.queueHigh || pressure.nvdec > config_.nvdecHigh ||
+           pressure.vram > config_.vramHigh || pressure.cpu > config_.cpuHigh;
+}
+
+bool QualityGovernor::relaxed(const Pressure& pressure) const {
+    return pressure.queue < config_.queueLow && pressure.nvdec < config_.nvdecLow &&
+           pressure.vram < config_.vramLow && pressure.cpu < config_.cpuLow;
+}
+
+double QualityGovernor::sampleCpuBusy() {
+    uint64_t busy = 0;
+    uint64_t total = 0;
+
+#ifdef _WIN32
+    FILETIME idleTime, kernelTime, userTime;
+    if (!GetSystemTimes(&idleTime, &kernelTime, &userTime)) {
+        return 0.0;
+    }
+    auto ticks = [](const FILETIME& time) {
+        return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+    };
+    total = ticks(kernelTime) + ticks(userTime);   // Kernel time includes idle time
+    busy = total - ticks(idleTime);
+#else
+    // "cpu  user nice system idle iowait irq softirq steal ..." in clock ticks
+    std::ifstream stat("/proc/stat");
+    std::string line;
+    if (!std::getline(stat, line)) {
+        return 0.0;
+    }
+
+    std::istringstream fields(line);
+    std::string label;
+    fields >> label;
+    uint64_t value = 0;
+    for (int field = 0; field < 8 && fields >> value; ++field) {
+        total += value;
+        if (field != 3 && field != 4) {   // idle, iowait
+            busy += value;
+        }
+    }
+#endif
+
+    const uint64_t busyDelta = busy - lastCpuBusy_;
+    const uint64_t totalDelta = total - lastCpuTotal_;
+    lastCpuBusy_ = busy;
+    lastCpuTotal_ = total;
+    return totalDelta > 0 && busyDelta <= totalDelta ? static_cast<double>(busyDelta) / totalDelta : 0.0;
+}
+
+} // namespace stream
+} // namespace fluxvision
@@ -0,0 +1,146 @@
+// src/core/stream/quality_governor.h
+// Load-adaptive tier caps: under pressure the least important cameras give up quality first
+#pragma once
+
+#include "stream_manager.h"
+#include "../gpu/memory_pool.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fluxvision {
+namespace stream {
+
+// Quality governor
+//
+// Every interval it reads four pressures, each as a 0-1 fraction:
+// - queue: mean packet queue fill of the cameras decoding somewhere;
+// - NVDEC: decode engine utilization from NVML (gpu::DeviceMonitor), else the
+//   admission cost model of the tiers actually decoded;
+// - VRAM: the device's GPU memory pool utilization;
+// - CPU: system-wide busy time since the last evaluation.
+// Pressures are judged per domain: each device (its NVDEC cameras) and the
+// CPU decoder (its cameras). CPU pressure also counts for every GPU domain while there
+// are no CPU-decoded cameras, since network and host work then dominate.
+//
+// A domain with any pressure above its high mark is overloaded. The governor
+// steps the lowest-priority cameras there (stepsPerDecision of them) down by
+// one tier using StreamManager::setQualityCap(). Ties go to the lowest
+// requested tier, then to the camera stepped least. It then waits settleTime
+// for the sub/main switches and the queues to react before judging that
+// domain again.
+//
+// Never stepped down: cameras with priority > 0 (alarms), cameras requested
+// at protectedQuality or above, activity-gated cameras, and cameras already
+// at minQuality. A capped camera that becomes one of these gets its cap
+// lifted at once.
+//
+// Once every pressure of a domain has stayed below its low mark for
+// recoverAfter, the highest-priority capped camera steps back up, one tier
+// per settleTime. The gap between the marks plus the hold time is the
+// hysteresis that keeps tiers from flapping.
+//
+// Caps never change admission reservations, so stepping back up always fits.
+//
+// Thread-safety: start()/stop() from the owner; getStats() from any thread.
+class QualityGovernor {
+public:
+    struct Config {
+        bool enabled = false;
+        std::chrono::milliseconds interval{1000};
+        std::chrono::seconds settleTime{3};      // After a step, before judging that domain again
+        std::chrono::seconds recoverAfter{15};   // Below every low mark this long before stepping up
+
+        double queueHigh = 0.5;     // Mean packet queue fill
+        double queueLow = 0.15;
+        double nvdecHigh = 0.95;    // NVDEC utilization
+        double nvdecLow = 0.75;
+        double vramHigh = 0.95;     // GPU memory pool utilization
+        double vramLow = 0.8;
+        double cpuHigh = 0.9;       // System CPU busy fraction
+        double cpuLow = 0.7;
+
+        StreamQuality minQuality;        // Lowest tier a camera is stepped down to (THUMBNAIL)
+        StreamQuality protectedQuality;  // Requested at or above: never stepped down (FULLSCREEN)
+        size_t stepsPerDecision = 2;     // Cameras of a domain stepped down at once
+        double nvdecCapacity = 24.0;     // 1080p30 streams per device, for the cost model fallback
+
+        Config();
+    };
+
+    struct Stats {
+        double queuePressure = 0.0;  // Highest over the domains
+        double nvdecPressure = 0.0;
+        double vramPressure = 0.0;
+        double cpuPressure = 0.0;
+        size_t overloadedDomains = 0;
+        size_t governedCameras = 0;  // Capped below their requested tier
+        uint64_t stepsDown = 0;
+        uint64_t stepsUp = 0;
+    };
+
+    // memoryPools: one per device, in StreamManager device order (not owned)
+    QualityGovernor(const Config& config, StreamManager* streamManager,
+                    std::vector<gpu::GPUMemoryPool*> memoryPools, std::vector<int> cudaDeviceIds);
+    ~QualityGovernor();
+
+    // Delete copy/move
+    QualityGovernor(const QualityGovernor&) = delete;
+    QualityGovernor& operator=(const QualityGovernor&) = delete;
+
+    bool start();
+    void stop();   // Caps stay where they are
+
+    // One round (the governor thread runs it every interval)
+    void evaluate();
+
+    Stats getStats() const;
+
+private:
+    static constexpr int kCpuDomain = -1;
+
+    struct Pressure {
+        double queue = 0.0;
+        double nvdec = 0.0;
+        double vram = 0.0;
+        double cpu = 0.0;
+    };
+
+    struct Domain {
+        std::chrono::steady_clock::time_point settledAt;    // No decisions before this
+        std::chrono::steady_clock::time_point relaxedSince;
+        bool relaxed = false;
+    };
+
+    Config config_;
+    StreamManager* streamManager_;
+    std::vector<gpu::GPUMemoryPool*> memoryPools_;
+    std::vector<int> cudaDeviceIds_;
+
+    std::map<int, Domain> domains_;      // Device index or kCpuDomain; governor thread only
+    std::map<std::string, int> steps_;   // Tiers each capped camera was stepped down
+
+    // System CPU time at the last evaluation
+    uint64_t lastCpuBusy_ = 0;
+    uint64_t lastCpuTotal_ = 0;
+
+    mutable std::mutex statsMutex_;
+    Stats stats_;
+
+    std::mutex wakeMutex_;
+    std::condition_variable wake_;
+    bool stopping_ = false;
+    std::thread thread_;
+
+    bool overloaded(const Pressure& pressure) const;
+    bool relaxed(const Pressure& pressure) const;
+    double sampleCpuBusy();
+    void run();
+};
+
+} // namespace stream
+} // namespace fluxvision
@@ -0,0 +1,288 @@
+// src/core/stream/snapshot_service.cpp
+#include "snapshot_service.h"
+#include <algorithm>
+#include <iostream>
+
+namespace fluxvision {
+namespace stream {
+
+namespace {
+    FrameSubscription::Options snapshotOptions() {
+        FrameSubscription::Options options;
+        options.policy = DropPolicy::LATEST_ONLY;
+        options.name = "snapshot";
+        return options;
+    }
+}
+
+SnapshotService::SnapshotService(StreamManager& streams, const Config& config)
+    : streams_(streams)
+    , config_(config)
+    , encoder_(config.encoder)
+{
+    config_.maxEntries = std::max<size_t>(1, config_.maxEntries);
+}
+
+SnapshotService::~SnapshotService() {
+    stop();
+}
+
+bool SnapshotService::start() {
+    {
+        std::lock_guard<std::mutex> lock(encodeMutex_);
+        if (started_) {
+            return true;
+        }
+        if (!encoder_.initialize()) {
+            std::cerr << "SnapshotService: JPEG encoder unavailable" << std::endl;
+            return false;
+        }
+        started_ = true;
+    }
+
+    if (config_.refreshInterval.count() > 0) {
+        std::lock_guard<std::mutex> lock(watchMutex_);
+        stopRequested_ = false;
+        refreshThread_ = std::thread([this]() { refreshLoop(); });
+    }
+    return true;
+}
+
+void SnapshotService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(watchMutex_);
+        stopRequested_ = true;
+    }
+    refreshCv_.notify_all();
+
+    if (refreshThread_.joinable()) {
+        refreshThread_.join();
+    }
+
+    // Frames held by the mailboxes go back to their decoders
+    std::unordered_map<std::string, std::shared_ptr<FrameSubscription>> watched;
+    {
+        std::lock_guard<std::mutex> lock(watchMutex_);
+        watched.swap(watched_);
+    }
+    for (auto& [cameraId, subscription] : watched) {
+        streams_.unsubscribe(cameraId, subscription);
+    }
+}
+
+SnapshotService::SnapshotPtr SnapshotService::getSnapshot(const std::string& cameraId) {
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        stats_.requests++;
+    }
+
+    if (SnapshotPtr cached = lookup(cameraId, true)) {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        stats_.hits++;
+        return cached;
+    }
+
+    // Wait for the frame without holding the encoder: other cameras' requests proceed
+    FrameHandle frame;
+    if (!takeFrame(cameraId, frame)) {
+        SnapshotPtr stale = lookup(cameraId, false);
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        (stale ? stats_.stale : stats_.timeouts)++;
+        return stale;
+    }
+
+    std::vector<SnapshotPtr> encoded = encodeFrames({cameraId}, {frame});
+    if (encoded.front()) {
+        return encoded.front();
+    }
+    return lookup(cameraId, false);
+}
+
+SnapshotService::SnapshotPtr SnapshotService::getCached(const std::string& cameraId) {
+    return lookup(cameraId, false);
+}
+
+bool SnapshotService::watch(const std::string& cameraId) {
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    if (watched_.count(cameraId)) {
+        return true;
+    }
+
+    std::shared_ptr<FrameSubscription> subscription = streams_.subscribe(cameraId, snapshotOptions());
+    if (!subscription) {
+        return false;
+    }
+
+    watched_.emplace(cameraId, std::move(subscription));
+    return true;
+}
+
+void SnapshotService::unwatch(const std::string& cameraId) {
+    std::shared_ptr<FrameSubscription> subscription;
+    {
+        std::lock_guard<std::mutex> lock(watchMutex_);
+        auto it = watched_.find(cameraId);
+        if (it == watched_.end()) {
+            return;
+        }
+        subscription = std::move(it->second);
+        watched_.erase(it);
+    }
+
+    streams_.unsubscribe(cameraId, subscription);
+}
+
+void SnapshotService::invalidate(const std::string& cameraId) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+
+    auto it = entries_.find(cameraId);
+    if (it != entries_.end()) {
+        cacheBytes_ -= (*it->second)->image.data.size();
+        lru_.erase(it->second);
+        entries_.erase(it);
+    }
+}
+
+SnapshotService::Stats SnapshotService::getStats() const {
+    Stats stats;
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        stats = stats_;
+        stats.entries = lru_.size();
+        stats.bytes = cacheBytes_;
+    }
+
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    stats.watched = watched_.size();
+    return stats;
+}
+
+void SnapshotService::refreshLoop() {
+    std::unique_lock<std::mutex> lock(watchMutex_);
+
+    while (!stopRequested_) {
+        refreshCv_.wait_for(lock, config_.refreshInterval, [this]() { return stopRequested_; });
+        if (stopRequested_) {
+            break;
+        }
+
+        // Newest frame of every watched camera that produced one since the last round
+        std::vector<std::string> cameraIds;
+        std::vector<FrameHandle> frames;
+        for (auto& [cameraId, subscription] : watched_) {
+            FrameHandle frame;
+            if (subscription->poll(frame)) {
+                cameraIds.push_back(cameraId);
+                frames.push_back(std::move(frame));
+            }
+        }
+
+        if (frames.empty()) {
+            continue;
+        }
+
+        lock.unlock();
+        encodeFrames(cameraIds, frames);
+        frames.clear();  // Back to the decoders before sleeping
+        lock.lock();
+    }
+}
+
+SnapshotService::SnapshotPtr SnapshotService::lookup(const std::string& cameraId, bool freshOnly) {
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+
+    auto it = entries_.find(cameraId);
+    if (it == entries_.end()) {
+        return nullptr;
+    }
+
+    SnapshotPtr snapshot = *it->second;
+    if (freshOnly && std::chrono::steady_clock::now() - snapshot->capturedAt > config_.freshness) {
+        return nullptr;
+    }
+
+    lru_.splice(lru_.begin(), lru_, it->second);
+    return snapshot;
+}
+
+bool SnapshotService::takeFrame(const std::string& cameraId, FrameHandle& frame) {
+    // Watched: the mailbox already holds the newest frame, if one arrived since the last still
+    // (polled under watchMutex_: the refresh thread consumes the same mailbox)
+    {
+        std::lock_guard<std::mutex> lock(watchMutex_);
+        auto it = watched_.find(cameraId);
+        if (it != watched_.end() && it->second->poll(frame)) {
+            return true;
+        }
+    }
+
+    std::shared_ptr<FrameSubscription> subscription = streams_.subscribe(cameraId, snapshotOptions());
+    if (!subscription) {
+        return false;
+    }
+
+    const bool received = subscription->waitForFrame(frame, config_.frameTimeout);
+    streams_.unsubscribe(cameraId, subscription);
+    return received;
+}
+
+std::vector<SnapshotService::SnapshotPtr> SnapshotService::encodeFrames(
+        const std::vector<std::string>& cameraIds, const std::vector<FrameHandle>& frames) {
+    std::vector<SnapshotPtr> snapshots(frames.size());
+    std::vector<JpegImage> images;
+
+    {
+        std::lock_guard<std::mutex> lock(encodeMutex_);
+        if (!started_) {
+            return snapshots;
+        }
+        encoder_.encode(frames, images);
+    }
+
+    const auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+
+    for (size_t i = 0; i < frames.size(); ++i) {
+        if (images[i].data.empty()) {
+            stats_.failures++;
+            continue;
+        }
+
+        stats_.encodes++;
+        stats_.hardwareEncodes += images[i].hardware ? 1 : 0;
+
+        auto snapshot = std::make_shared<Snapshot>();
+        snapshot->cameraId = cameraIds[i];
+        snapshot->image = std::move(images[i]);
+        snapshot->capturedAt = now;
+        insert(snapshot);
+        snapshots[i] = std::move(snapshot);
+    }
+
+    return snapshots;
+}
+
+void SnapshotService::insert(const SnapshotPtr& snapshot) {
+    auto it = entries_.find(snapshot->cameraId);
+    if (it != entries_.end()) {
+        cacheBytes_ -= (*it->second)->image.data.size();
+        lru_.erase(it->second);
+        entries_.erase(it);
+    }
+
+    lru_.push_front(snapshot);
+    entries_[snapshot->cameraId] = lru_.begin();
+    cacheBytes_ += snapshot->image.data.size();
+
+    // Evict least recently used stills, never the one just added
+    while (lru_.size() > 1 && (lru_.size() > config_.maxEntries || cacheBytes_ > config_.maxBytes)) {
+        const SnapshotPtr& oldest = lru_.back();
+        cacheBytes_ -= oldest->image.data.size();
+        entries_.erase(oldest->cameraId);
+        lru_.pop_back();
+        stats_.evictions++;
+    }
+}
+
+} // namespace stream
+} // namespace fluxvision
@@ -0,0 +1,126 @@
+// src/core/stream/snapshot_service.h
+// Per-camera "latest still" JPEGs, encoded on demand or at a fixed rate and served from a bounded LRU
+#pragma once
+
+#include "stream_manager.h"
+#include "../codec/jpeg_encoder.h"
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fluxvision {
+namespace stream {
+
+// Snapshot service for camera pickers, alarms and reports
+//
+// getSnapshot() returns the cached JPEG while it is younger than the
+// freshness window; otherwise it subscribes to the camera, takes the next
+// decoded frame and encodes it (nvJPEG straight from the NVDEC surface, CPU
+// MJPEG for CpuDecoder frames). Watched cameras keep a LATEST_ONLY
+// subscription open, so a request never waits for a frame, and with a
+// refreshInterval a background thread re-encodes all of them in one batch
+// per interval. A watched camera holds one decoded frame in its mailbox.
+//
+// The cache is bounded by entry count and bytes, least recently used first out.
+//
+// Thread-safety: all methods may be called from any thread.
+class SnapshotService {
+public:
+    struct Config {
+        JpegEncoder::Config encoder;                 // Quality, thumbnail size, nvJPEG
+        std::chrono::milliseconds freshness{2000};   // Serve cached stills younger than this
+        std::chrono::milliseconds frameTimeout{1000};  // On demand: wait this long for a frame
+        std::chrono::milliseconds refreshInterval{0};  // Watched cameras: re-encode period (0 = on demand)
+        size_t maxEntries = 256;
+        size_t maxBytes = 32 * 1024 * 1024;
+    };
+
+    struct Snapshot {
+        std::string cameraId;
+        JpegImage image;
+        std::chrono::steady_clock::time_point capturedAt;
+    };
+    using SnapshotPtr = std::shared_ptr<const Snapshot>;
+
+    struct Stats {
+        uint64_t requests = 0;
+        uint64_t hits = 0;           // Served fresh from the cache
+        uint64_t stale = 0;          // No new frame in time: served the older cached still
+        uint64_t timeouts = 0;       // No frame and nothing cached
+        uint64_t encodes = 0;
+        uint64_t hardwareEncodes = 0;
+        uint64_t failures = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t bytes = 0;
+        size_t watched = 0;
+    };
+
+    SnapshotService(StreamManager& streams, const Config& config);
+    ~SnapshotService();
+
+    // Delete copy/move
+    SnapshotService(const SnapshotService&) = delete;
+    SnapshotService& operator=(const SnapshotService&) = delete;
+
+    // Set up the encoder and, with a refreshInterval, the refresh thread
+    bool start();
+    void stop();
+
+    // Fresh still of cameraId (may wait up to frameTimeout); nullptr if none
+    SnapshotPtr getSnapshot(const std::string& cameraId);
+
+    // Cached still regardless of age, without encoding; nullptr if none
+    SnapshotPtr getCached(const std::string& cameraId);
+
+    // Keep cameraId's newest frame at hand (and refreshed, with a refreshInterval)
+    bool watch(const std::string& cameraId);
+    void unwatch(const std::string& cameraId);
+
+    // Drop cameraId's cached still (camera removed or reconfigured)
+    void invalidate(const std::string& cameraId);
+
+    Stats getStats() const;
+
+private:
+    StreamManager& streams_;
+    Config config_;
+
+    // Encoder (encodeMutex_)
+    JpegEncoder encoder_;
+    std::mutex encodeMutex_;
+    bool started_ = false;
+
+    // LRU cache, most recently used first (cacheMutex_)
+    mutable std::mutex cacheMutex_;
+    std::list<SnapshotPtr> lru_;
+    std::unordered_map<std::string, std::list<SnapshotPtr>::iterator> entries_;
+    size_t cacheBytes_ = 0;
+
+    // Watched cameras (watchMutex_)
+    mutable std::mutex watchMutex_;
+    std::unordered_map<std::string, std::shared_ptr<FrameSubscription>> watched_;
+    std::condition_variable refreshCv_;
+    bool stopRequested_ = false;
+    std::thread refreshThread_;
+
+    // Statistics (cacheMutex_)
+    Stats stats_;
+
+    void refreshLoop();
+    SnapshotPtr lookup(const std::string& cameraId, bool freshOnly);
+    bool takeFrame(const std::string& cameraId, FrameHandle& frame);
+    std::vector<SnapshotPtr> encodeFrames(const std::vector<std::string>& cameraIds,
+                                          const std::vector<FrameHandle>& frames);
+    void insert(const SnapshotPtr& snapshot);  // cacheMutex_ held
+};
+
+} // namespace stream
+} // namespace fluxvision
@@ -1,10 +1,22 @@
 // src/core/stream/stream_manager.cpp
 #include "stream_manager.h"
+#include <algorithm>
+#include <cstring>
 #include <iostream>
+#include <thread>
+#include <unordered_set>
 
 namespace fluxvision {
 namespace stream {
 
+namespace {
+    // Reads per reactor service: bounds how long one camera holds a reactor thread
+    constexpr int kMaxReadsPerService = 16;
+
+    // Pinned loop back-off while a read would block (client reconnecting)
+    constexpr int kPinnedIdleMs = 10;
+}
+
 StreamManager::StreamManager() {
 }
 
@@ -14,19 +26,62 @@ StreamManager::~StreamManager() {
 
 bool StreamManager::initialize(threading::NetworkThreadPool* networkPool,
                                threading::DecodeThreadPool* decodePool,
-                               gpu::GPUMemoryPool* memoryPool) {
+                               gpu::GPUMemoryPool* memoryPool,
+                               const AdmissionController::Config& admissionConfig) {
+    DecodeDevice device;
+    device.cudaDeviceId = memoryPool ? memoryPool->getDeviceId() : 0;
+    device.decodePool = decodePool;
+    device.memoryPool = memoryPool;
+    return initialize(networkPool, std::vector<DecodeDevice>{device}, admissionConfig);
+}
+
+bool StreamManager::initialize(threading::NetworkThreadPool* networkPool,
+                               const std::vector<DecodeDevice>& devices,
+                               const AdmissionController::Config& admissionConfig) {
     if (initialized_) {
         return true;  // Already initialized
     }
 
-    if (!networkPool || !decodePool || !memoryPool) {
-        std::cerr << "StreamManager: null thread pool or memory pool provided" << std::endl;
+    if (!networkPool || devices.empty()) {
+        std::cerr << "StreamManager: no network thread pool or decode devices provided" << std::endl;
         return false;
     }
 
+    for (const auto& device : devices) {
+        if (!device.decodePool || !device.memoryPool) {
+            std::cerr << "StreamManager: null thread pool or memory pool provided for CUDA device "
+                      << device.cudaDeviceId << std::endl;
+            return false;
+        }
+    }
+
     networkPool_ = networkPool;
-    decodePool_ = decodePool;
-    memoryPool_ = memoryPool;
+
+    std::vector<gpu::GPUMemoryPool*> memoryPools;
+    std::vector<Device> started;
+    for (const auto& resources : devices) {
+        Device device;
+        device.resources = resources;
+        device.scheduler = std::make_shared<DecodeScheduler>(DecodeScheduler::Config{});
+
+        if (!device.scheduler->start(resources.decodePool, [this](CameraStream& camera, size_t maxUnits) {
+                return decodeSlice(camera, maxUnits);
+            })) {
+            std::cerr << "StreamManager: failed to start decode scheduler for CUDA device "
+                      << resources.cudaDeviceId << std::endl;
+            for (auto& other : started) {
+                other.scheduler->stop();
+            }
+            return false;
+        }
+
+        memoryPools.push_back(resources.memoryPool);
+        started.push_back(std::move(device));
+    }
+
+    devices_ = std::move(started);
+    admission_ = std::make_unique<AdmissionController>(admissionConfig, memoryPools);
+    rebalanceOnChange_ = admissionConfig.rebalanceOnChange;
 
     initialized_ = true;
     running_ = true;
@@ -40,28 +95,87 @@ bool StreamManager::addCamera(const CameraStream::Config& config) {
         return false;
     }
 
-    // Check if camera already exists
+    // Reserve the id before connecting: a second add of it fails here, not after its connect
     {
-        std::shared_lock<std::shared_mutex> lock(camerasMutex_);
-        if (cameras_.find(config.id) != cameras_.end()) {
+        std::unique_lock<std::shared_mutex> lock(camerasMutex_);
+        if (cameras_.find(config.id) != cameras_.end() || !addingCameras_.emplace(config.id).second) {
             std::cerr << "StreamManager: camera " << config.id << " already exists" << std::endl;
             return false;
         }
     }
 
-    // Create camera stream
-    auto camera = std::make_unique<CameraStream>(config);
+    // Given up once the camera is registered, or when adding it fails
+    struct Reservation {
+        StreamManager* manager;
+        const std::string& id;
+        ~Reservation() {
+            std::unique_lock<std::shared_mutex> lock(manager->camerasMutex_);
+            manager->addingCameras_.erase(id);
+        }
+    } reservation{this, config.id};
+
+    // Create camera stream (reactor threads must never block inside a read)
+    CameraStream::Config cameraConfig = config;
+    cameraConfig.nonBlockingReceive = networkPool_->isReactorMode();
+    cameraConfig.cudaDeviceId = devices_.front().resources.cudaDeviceId;  // Until placed
+    cameraConfig.memoryPool = devices_.front().resources.memoryPool->shared();  // nullptr: decoders allocate on their own
+    auto camera = std::make_unique<CameraStream>(cameraConfig);
+
+    // Connect first: admission needs the stream's resolution and frame rate
+    if (!camera->open()) {
+        std::cerr << "StreamManager: failed to connect camera " << config.id << std::endl;
+        return false;
+    }
+
+    AdmissionController::StreamInfo info;
+    camera->getStreamInfo(info.width, info.height, info.fps);
+    info.hasSubStream = !config.subStreamUrl.empty();
+
+    const AdmissionResult admission = admission_->admit(config.id, info, config.quality);
+
+    if (admission.device >= 0) {
+        const DecodeDevice& device = devices_[admission.device].resources;
+        camera->moveToDevice(device.cudaDeviceId, device.memoryPool->shared());
+    }
+
+    switch (admission.decision) {
+        case AdmissionDecision::ADMIT:
+            break;
+        case AdmissionDecision::ADMIT_DOWNGRADED:
+            std::cout << "StreamManager: GPU busy, admitting camera " << config.id
+                      << " at a lower quality tier" << std::endl;
+            camera->setQuality(admission.quality);
+            break;
+        case AdmissionDecision::CPU_DECODE:
+            std::cout << "StreamManager: GPU full, decoding camera " << config.id
+                      << " on the CPU" << std::endl;
+            camera->setDecoderType(DecoderType::CPU);
+            camera->setQuality(admission.quality);
+            break;
+        case AdmissionDecision::REJECT:
+            std::cerr << "StreamManager: rejecting camera " << config.id << " ("
+                      << info.width << "x" << info.height << "@" << info.fps
+                      << "): no NVDEC, VRAM or CPU decode capacity left" << std::endl;
+            return false;
+    }
 
     // Start camera
     if (!camera->start()) {
         std::cerr << "StreamManager: failed to start camera " << config.id << std::endl;
+        admission_->release(config.id);
         return false;
     }
 
+    // Lazy decoders are confirmed once created
+    if (IDecoder* decoder = camera->getDecoder()) {
+        admission_->confirm(config.id, decoder->isHardwareAccelerated());
+    }
+
     // Assign camera to network thread
     networkPool_->assignCamera(config.id);
 
-    // Add to registry
+    // Add to registry (no migration may move it before it is registered for decode)
+    std::lock_guard<std::mutex> migrationLock(migrationMutex_);
     {
         std::unique_lock<std::shared_mutex> lock(camerasMutex_);
         cameras_[config.id] = std::move(camera);
@@ -70,43 +184,203 @@ bool StreamManager::addCamera(const CameraStream::Config& config) {
     // Start network receive loop for this camera
     startNetworkReceiveLoop(config.id);
 
-    // Start decode loop for this camera
+    // Register camera with the decode scheduler
     startDecodeLoop(config.id);
 
     std::cout << "StreamManager: added camera " << config.id << std::endl;
     return true;
 }
 
-bool StreamManager::removeCamera(const std::string& id) {
-    std::unique_lock<std::shared_mutex> lock(camerasMutex_);
+BulkAddResult StreamManager::addCameras(const std::vector<CameraStream::Config>& configs,
+                                        const BulkAddOptions& options,
+                                        CameraStartCallback progress) {
+    const auto startTime = std::chrono::steady_clock::now();
+    BulkAddResult result;
 
-    auto it = cameras_.find(id);
-    if (it == cameras_.end()) {
-        return false;  // Camera not found
+    std::mutex progressMutex;
+    auto report = [&](const std::string& cameraId, CameraStartStage stage) {
+        std::lock_guard<std::mutex> lock(progressMutex);
+
+        if (stage == CameraStartStage::STARTED) {
+            result.started++;
+        } else if (stage == CameraStartStage::FAILED) {
+            result.failed++;
+        }
+
+        if (progress) {
+            CameraStartProgress update;
+            update.cameraId = cameraId;
+            update.stage = stage;
+            update.completed = result.started + result.failed;
+            update.total = configs.size();
+            progress(update);
+        }
+    };
+
+    // Two configs with one id would race each other into the registry
+    std::vector<const CameraStream::Config*> pending;
+    std::unordered_set<std::string> ids;
+    for (const auto& config : configs) {
+        if (!ids.insert(config.id).second) {
+            std::cerr << "StreamManager: duplicate camera " << config.id << " in bulk add" << std::endl;
+            report(config.id, CameraStartStage::FAILED);
+            continue;
+        }
+        pending.push_back(&config);
     }
 
-    // Stop camera
-    it->second->stop();
+    // Each worker takes the next camera once its previous one is up (or failed)
+    std::atomic<size_t> next{0};
+    auto worker = [&] {
+        for (size_t i = next++; i < pending.size(); i = next++) {
+            CameraStream::Config config = *pending[i];
+            config.lazyDecoder = config.lazyDecoder || options.lazyDecoders;
 
-    // Unassign from network thread
-    networkPool_->unassignCamera(id);
+            report(config.id, CameraStartStage::CONNECTING);
+            report(config.id, addCamera(config) ? CameraStartStage::STARTED : CameraStartStage::FAILED);
+        }
+    };
 
-    // Remove from registry
-    cameras_.erase(it);
+    const size_t workerCount = std::min(std::max<size_t>(options.maxInFlight, 1), pending.size());
+    std::vector<std::thread> workers;
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+
+    result.elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+
+    std::cout << "StreamManager: bulk add started " << result.started << "/" << configs.size()
+              << " cameras in " << result.elapsed.count() << " ms" << std::endl;
+    return result;
+}
+
+bool StreamManager::removeCamera(const std::string& id) {
+    std::unique_ptr<CameraStream> camera;
+
+    // Remove from registry (after any migration of it has finished)
+    {
+        std::lock_guard<std::mutex> migrationLock(migrationMutex_);
+        std::unique_lock<std::shared_mutex> lock(camerasMutex_);
+
+        auto it = cameras_.find(id);
+        if (it == cameras_.end()) {
+            return false;  // Camera not found
+        }
+
+        camera = std::move(it->second);
+        cameras_.erase(it);
+    }
+
+    // Detach from the network and decode threads first: both wait for an
+    // in-flight receive/decode of this camera, so stop() can safely tear it down
+    Device& device = deviceFor(*camera);
+    detachCamera(id, *camera);
+
+    // Stop camera
+    camera->stop();
+    device.resources.memoryPool->unregisterAllocation(id);
+    admission_->release(id);
 
     std::cout << "StreamManager: removed camera " << id << std::endl;
+
+    if (rebalanceOnChange_) {
+        rebalance();
+    }
     return true;
 }
 
 void StreamManager::setQuality(const std::string& id, StreamQuality quality) {
-    std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+    {
+        std::shared_lock<std::shared_mutex> lock(camerasMutex_);
 
-    auto it = cameras_.find(id);
-    if (it != cameras_.end()) {
-        it->second->setQuality(quality);
+        auto it = cameras_.find(id);
+        if (it == cameras_.end()) {
+            return;
+        }
+
+        // Upgrades are granted only as far as the GPU has room
+        it->second->setQuality(admission_->requestQuality(id, quality));
+    }
+
+    if (rebalanceOnChange_) {
+        rebalance();
     }
 }
 
+bool StreamManager::migrateCamera(const std::string& id, size_t device) {
+    if (!initialized_ || device >= devices_.size()) {
+        return false;
+    }
+
+    // Held throughout: removeCamera() can't take the camera away meanwhile
+    std::lock_guard<std::mutex> migrationLock(migrationMutex_);
+
+    CameraStream* found = getCamera(id);
+    if (!found) {
+        return false;
+    }
+
+    CameraStream& camera = *found;
+    const size_t from = deviceIndex(camera.getDeviceId());
+    if (from == device) {
+        return true;
+    }
+
+    IDecoder* decoder = camera.getDecoder();
+    if (!decoder || !decoder->isHardwareAccelerated()) {
+        std::cerr << "StreamManager: camera " << id << " is not decoding on a GPU" << std::endl;
+        return false;
+    }
+
+    if (!admission_->migrate(id, static_cast<int>(device))) {
+        std::cerr << "StreamManager: no room to move camera " << id << " to CUDA device "
+                  << devices_[device].resources.cudaDeviceId << std::endl;
+        return false;
+    }
+
+    // No slice may run while the decoder is rebuilt
+    devices_[from].scheduler->unregisterCamera(id);
+
+    const DecodeDevice& target = devices_[device].resources;
+    const bool moved = camera.moveToDevice(target.cudaDeviceId, target.memoryPool->shared());
+    if (moved) {
+        devices_[from].resources.memoryPool->unregisterAllocation(id);
+    } else {
+        admission_->migrate(id, static_cast<int>(from));  // Still decoding on the old device
+    }
+
+    // AUTO decoders fall back to the CPU if NVDEC fails on the new device
+    admission_->confirm(id, camera.getDecoder()->isHardwareAccelerated());
+    devices_[moved ? device : from].scheduler->registerCamera(id, &camera);
+
+    if (!moved) {
+        return false;
+    }
+
+    std::cout << "StreamManager: moved camera " << id << " to CUDA device "
+              << target.cudaDeviceId << std::endl;
+    return true;
+}
+
+bool StreamManager::rebalance() {
+    if (!initialized_ || devices_.size() < 2) {
+        return false;
+    }
+
+    std::string cameraId;
+    int device = -1;
+    if (!admission_->planMigration(cameraId, device)) {
+        return false;
+    }
+
+    return migrateCamera(cameraId, static_cast<size_t>(device));
+}
+
 CameraStream* StreamManager::getCamera(const std::string& id) {
     std::shared_lock<std::shared_mutex> lock(camerasMutex_);
 
@@ -118,45 +392,181 @@ CameraStream* StreamManager::getCamera(const std::string& id) {
     return nullptr;
 }
 
-void StreamManager::startAll() {
+std::shared_ptr<FrameSubscription> StreamManager::subscribe(const std::string& cameraId,
+                                                            const FrameSubscription::Options& options) {
     std::shared_lock<std::shared_mutex> lock(camerasMutex_);
 
-    for (auto& [id, camera] : cameras_) {
-        if (camera->getState() == StreamState::STOPPED) {
-            camera->start();
-        }
+    auto it = cameras_.find(cameraId);
+    if (it == cameras_.end()) {
+        std::cerr << "StreamManager: cannot subscribe to unknown camera " << cameraId << std::endl;
+        return nullptr;
     }
+
+    return it->second->getFanout()->subscribe(options);
 }
 
-void StreamManager::stopAll() {
+void StreamManager::unsubscribe(const std::string& cameraId,
+                                const std::shared_ptr<FrameSubscription>& subscription) {
     std::shared_lock<std::shared_mutex> lock(camerasMutex_);
 
-    for (auto& [id, camera] : cameras_) {
-        camera->stop();
+    auto it = cameras_.find(cameraId);
+    if (it != cameras_.end()) {
+        it->second->getFanout()->unsubscribe(subscription);
+    } else if (subscription) {
+        subscription->cancel();
     }
 }
 
-void StreamManager::setAllQuality(StreamQuality quality) {
+std::shared_ptr<PacketSubscription> StreamManager::subscribePackets(const std::string& cameraId,
+                                                                    const PacketSubscription::Options& options) {
     std::shared_lock<std::shared_mutex> lock(camerasMutex_);
 
-    for (auto& [id, camera] : cameras_) {
-        camera->setQuality(quality);
+    auto it = cameras_.find(cameraId);
+    if (it == cameras_.end()) {
+        std::cerr << "StreamManager: cannot subscribe to packets of unknown camera " << cameraId << std::endl;
+        return nullptr;
     }
+
+    return it->second->getPacketFanout()->subscribe(options);
 }
 
-void StreamManager::reconnectAll() {
+void StreamManager::unsubscribePackets(const std::string& cameraId,
+                                       const std::shared_ptr<PacketSubscription>& subscription) {
     std::shared_lock<std::shared_mutex> lock(camerasMutex_);
 
-    for (auto& [id, camera] : cameras_) {
-        if (camera->getState() == StreamState::ERROR) {
-            camera->reconnect();
+    auto it = cameras_.find(cameraId);
+    if (it != cameras_.end()) {
+        it->second->getPacketFanout()->unsubscribe(subscription);
+    } else if (subscription) {
+        subscription->cancel();
+    }
+}
+
+void StreamManager::startAll() {
+    std::lock_guard<std::mutex> migrationLock(migrationMutex_);
+
+    for (const auto& id : getCameraIds()) {
+        CameraStream* camera = getCamera(id);
+        if (camera && camera->getState() == StreamState::STOPPED && camera->start()) {
+            attachCamera(id);
+        }
+    }
+}
+
+void StreamManager::stopAll() {
+    // Detached first: stop() destroys the client and parks the decoder
+    std::lock_guard<std::mutex> migrationLock(migrationMutex_);
+
+    for (const auto& id : getCameraIds()) {
+        if (CameraStream* camera = getCamera(id)) {
+            detachCamera(id, *camera);
+            camera->stop();
+        }
+    }
+}
+
+void StreamManager::setAllQuality(StreamQuality quality) {
+    {
+        std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+
+        for (auto& [id, camera] : cameras_) {
+            camera->setQuality(admission_->requestQuality(id, quality));
+        }
+    }
+
+    if (rebalanceOnChange_) {
+        rebalance();
+    }
+}
+
+void StreamManager::reconnectAll() {
+    std::vector<std::string> failed;
+    {
+        std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+        for (auto& [id, camera] : cameras_) {
+            if (camera->getState() == StreamState::ERROR) {
+                failed.push_back(id);
+            }
         }
     }
+
+    for (const auto& id : failed) {
+        reconnectCamera(id);
+    }
+}
+
+bool StreamManager::reconnectCamera(const std::string& id) {
+    if (!running_) {
+        return false;
+    }
+
+    // Held throughout: removeCamera() and migrations wait for the new session
+    std::lock_guard<std::mutex> migrationLock(migrationMutex_);
+
+    CameraStream* camera = getCamera(id);
+    if (!camera) {
+        return false;
+    }
+
+    // Nothing may read from the old client or decode with the old decoder
+    // while reconnect() replaces them
+    detachCamera(id, *camera);
+
+    if (!camera->reconnect()) {
+        // Stays detached in ERROR; the next reconnectAll() tries again
+        std::cerr << "StreamManager: failed to reconnect camera " << id << std::endl;
+        return false;
+    }
+
+    if (IDecoder* decoder = camera->getDecoder()) {
+        admission_->confirm(id, decoder->isHardwareAccelerated());
+    }
+
+    attachCamera(id);
+    return true;
+}
+
+void StreamManager::attachCamera(const std::string& cameraId) {
+    networkPool_->assignCamera(cameraId);
+    startNetworkReceiveLoop(cameraId);
+    startDecodeLoop(cameraId);
+}
+
+void StreamManager::detachCamera(const std::string& cameraId, CameraStream& camera) {
+    // Both wait for a receive or decode slice of the camera in flight; a
+    // camera already detached is left as it is
+    stopNetworkReceiveLoop(cameraId);
+    deviceFor(camera).scheduler->unregisterCamera(cameraId);
 }
 
 void StreamManager::setFrameCallback(FrameCallback callback) {
+    updateCallbacks([&](Callbacks& callbacks) {
+        callbacks.frame = callback ? std::make_shared<const FrameCallback>(std::move(callback)) : nullptr;
+    });
+}
+
+void StreamManager::setFrameHandleCallback(FrameHandleCallback callback) {
+    updateCallbacks([&](Callbacks& callbacks) {
+        callbacks.frameHandle = callback ? std::make_shared<const FrameHandleCallback>(std::move(callback))
+                                         : nullptr;
+    });
+}
+
+void StreamManager::setPacketCallback(PacketCallback callback) {
+    updateCallbacks([&](Callbacks& callbacks) {
+        callbacks.packet = callback ? std::make_shared<const PacketCallback>(std::move(callback)) : nullptr;
+    });
+}
+
+void StreamManager::updateCallbacks(const std::function<void(Callbacks&)>& update) {
     std::lock_guard<std::mutex> lock(callbackMutex_);
-    frameCallback_ = std::move(callback);
+    auto callbacks = std::make_shared<Callbacks>(*std::atomic_load(&callbacks_));
+    update(*callbacks);
+    std::atomic_store(&callbacks_, std::shared_ptr<const Callbacks>(std::move(callbacks)));
+}
+
+std::shared_ptr<const PacketCallback> StreamManager::getPacketCallback() const {
+    return getCallbacks()->packet;
 }
 
 GlobalStats StreamManager::getGlobalStats() const {
@@ -188,14 +598,96 @@ GlobalStats StreamManager::getGlobalStats() const {
         stats.avgFps = totalFps / stats.activeCameras;
     }
 
-    // Get memory statistics from GPU memory pool
-    if (memoryPool_) {
-        stats.memoryStats = memoryPool_->getStats();
+    // Memory and scheduler statistics of every device
+    for (const auto& device : devices_) {
+        stats.deviceMemoryStats.push_back(device.resources.memoryPool->getStats());
+
+        const DecodeScheduler::Stats scheduler = device.scheduler->getStats();
+        stats.schedulerStats.registeredCameras += scheduler.registeredCameras;
+        stats.schedulerStats.readyCameras += scheduler.readyCameras;
+        stats.schedulerStats.slicesServed += scheduler.slicesServed;
+        stats.schedulerStats.unitsServed += scheduler.unitsServed;
+    }
+
+    if (!stats.deviceMemoryStats.empty()) {
+        stats.memoryStats = stats.deviceMemoryStats.front();
+    }
+
+    if (admission_) {
+        stats.admissionStats = admission_->getStats();
     }
 
     return stats;
 }
 
+void StreamManager::setQualityCap(const std::string& id, StreamQuality cap) {
+    std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+
+    auto it = cameras_.find(id);
+    if (it != cameras_.end()) {
+        it->second->setQualityCap(cap);
+    }
+}
+
+void StreamManager::setPriority(const std::string& id, int priority) {
+    std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+
+    auto it = cameras_.find(id);
+    if (it != cameras_.end()) {
+        it->second->setPriority(priority);
+    }
+}
+
+std::vector<CameraLoad> StreamManager::collectLoad() const {
+    std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+
+    std::vector<CameraLoad> loads;
+    loads.reserve(cameras_.size());
+    for (const auto& [id, camera] : cameras_) {
+        if (!camera->isRunning()) {
+            continue;
+        }
+
+        CameraLoad load;
+        load.cameraId = id;
+        load.requested = camera->getRequestedQuality();
+        load.quality = camera->getQuality();
+        load.cap = camera->getQualityCap();
+        load.priority = camera->getPriority();
+        load.idleGated = camera->isIdleGated();
+        load.hardware = std::strcmp(camera->getMetrics().decoderName(), "cpu") != 0;
+        load.device = deviceIndex(camera->getDeviceId());
+        load.queueDepth = camera->getPacketQueue()->size();
+        load.queueCapacity = camera->getPacketQueue()->capacity();
+
+        // Costed like admission did (the RTSP client belongs to the camera's threads)
+        AdmissionController::StreamInfo info;
+        if (admission_ && admission_->getStreamInfo(id, info)) {
+            load.decodeLoad = AdmissionController::estimateDecodeLoad(info, load.quality);
+        }
+
+        loads.push_back(std::move(load));
+    }
+    return loads;
+}
+
+std::vector<metrics::CameraSample> StreamManager::collectMetrics() const {
+    // Shared lock on the registry only (taken exclusively just by add/remove);
+    // every per-camera value is a relaxed atomic read
+    std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+
+    std::vector<metrics::CameraSample> samples(cameras_.size());
+    size_t i = 0;
+    for (const auto& [id, camera] : cameras_) {
+        camera->sampleMetrics(samples[i++]);
+    }
+
+    std::sort(samples.begin(), samples.end(), [](const metrics::CameraSample& a, const metrics::CameraSample& b) {
+        return a.cameraId < b.cameraId;
+    });
+    return samples;
+}
+
 std::vector<std::string> StreamManager::getCameraIds() const {
     std::shared_lock<std::shared_mutex> lock(camerasMutex_);
 
@@ -220,6 +712,28 @@ void StreamManager::shutdown() {
     }
 
     running_ = false;
+
+    // Detach every camera from the network and decode threads before destroying it
+    {
+        std::lock_guard<std::mutex> migrationLock(migrationMutex_);
+
+        for (const auto& id : getCameraIds()) {
+            CameraStream* camera = getCamera(id);
+            if (!camera) {
+                continue;
+            }
+
+            Device& device = deviceFor(*camera);
+            detachCamera(id, *camera);
+            device.resources.memoryPool->unregisterAllocation(id);
+            admission_->release(id);
+        }
+    }
+
+    for (auto& device : devices_) {
+        device.scheduler->stop();
+    }
+
     stopAll();
 
     std::unique_lock<std::shared_mutex> lock(camerasMutex_);
@@ -228,104 +742,422 @@ void StreamManager::shutdown() {
     initialized_ = false;
 }
 
+size_t StreamManager::deviceIndex(int cudaDeviceId) const {
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        if (devices_[i].resources.cudaDeviceId == cudaDeviceId) {
+            return i;
+        }
+    }
+    return 0;
+}
+
 void StreamManager::startNetworkReceiveLoop(const std::string& cameraId) {
-    // Submit network receive task to network thread pool
-    networkPool_->submit([this, cameraId]() {
-        // Get camera
+    if (networkPool_->isReactorMode()) {
         CameraStream* camera = getCamera(cameraId);
-        if (!camera) {
-            return;
+        if (camera && !registerNetworkSource(cameraId, camera)) {
+            std::cerr << "StreamManager: failed to register camera " << cameraId
+                      << " with network reactor" << std::endl;
         }
+        return;
+    }
 
-        auto* rtspClient = camera->getRtspClient();
-        auto* packetQueue = camera->getPacketQueue();
-
-        if (!rtspClient || !packetQueue) {
-            return;
+    // Pinned-thread mode: a thread of its own per camera, blocked in its reads
+    // (the network pool's fixed workers would leave cameras beyond their count unread)
+    auto loop = std::make_shared<PinnedLoop>();
+    std::lock_guard<std::mutex> lock(pinnedMutex_);
+    pinnedLoops_[cameraId] = loop;
+
+    loop->thread = std::thread([this, cameraId, loop = loop.get()]() {
+        bool failed = false;
+        receivePinned(cameraId, *loop, failed);
+
+        // Restarted from a pool task: reconnecting detaches the camera, which
+        // joins this thread
+        if (failed && running_) {
+            networkPool_->post([this, cameraId]() {
+                reconnectCamera(cameraId);
+            });
         }
+    });
+}
 
-        // Network receive loop (runs continuously while camera is active)
-        while (running_ && camera->isRunning()) {
-            try {
-                // Receive NAL units from RTSP client
-                std::vector<network::NalUnit> nalUnits;
-                if (rtspClient->receiveNalUnits(nalUnits)) {
-                    // Push NAL units to packet queue
-                    for (auto& nal : nalUnits) {
-                        StreamPacket packet;
-                        packet.data = std::move(nal.data);
-                        packet.timestamp = nal.pts;
-                        packet.isKeyFrame = nal.isKeyframe;
-
-                        // Push or drop oldest if queue full (backpressure)
-                        packetQueue->pushOrDropOldest(std::move(packet));
-                    }
-                }
+void StreamManager::receivePinned(const std::string& cameraId, PinnedLoop& loop, bool& failed) {
+    CameraStream* camera = getCamera(cameraId);
+    if (!camera) {
+        return;
+    }
+
+    auto* source = camera->getSource();
+    auto* packetQueue = camera->getPacketQueue();
+    auto* packetFanout = camera->getPacketFanout();
+
+    if (!source || !packetQueue) {
+        return;
+    }
+
+    // Network receive loop (runs continuously while camera is active)
+    while (running_ && camera->isRunning() && !loop.stop.load()) {
+        try {
+            // Receive whole access units (one per picture) from the camera's source
+            std::vector<network::AccessUnit> accessUnits;
+            const auto status = source->readAccessUnits(accessUnits);
+            if (status == network::StreamSource::ReadStatus::CLOSED) {
+                // The client gave up on its own reconnects; reconnectAll() brings it back
+                std::cerr << "Network source closed for camera " << cameraId << std::endl;
+                camera->markFailed();
+                break;
             }
-            catch (const std::exception& e) {
-                std::cerr << "Network receive error for camera " << cameraId
-                          << ": " << e.what() << std::endl;
 
-                // Attempt reconnection if enabled
-                if (camera->getConfig().autoReconnect) {
-                    camera->reconnect();
+            if (status == network::StreamSource::ReadStatus::OK && !accessUnits.empty()) {
+                const auto packetCallback = getPacketCallback();
+
+                // Push access units to packet queue
+                for (auto& au : accessUnits) {
+                    StreamPacket packet;
+                    packet.data = std::move(au.data);
+                    packet.timestamp = au.pts;
+                    packet.isKeyFrame = au.isKeyframe;
+                    packet.isReference = au.isReference;
+                    packet.receiveTime = au.receiveTime;
+
+                    if (packetCallback) {
+                        (*packetCallback)(cameraId, packet);
+                    }
+
+                    // Same buffers for every subscriber, each with its own queue
+                    if (packetFanout->hasSubscribers()) {
+                        packetFanout->publish(packet);
+                    }
+
+                    camera->queuePacket(std::move(packet));
                 }
-                break;
+
+                deviceFor(*camera).scheduler->notifyPending(cameraId);
+            } else if (status == network::StreamSource::ReadStatus::WOULD_BLOCK) {
+                // Client reconnecting: don't spin on it
+                std::this_thread::sleep_for(std::chrono::milliseconds(kPinnedIdleMs));
             }
         }
-    });
+        catch (const std::exception& e) {
+            std::cerr << "Network receive error for camera " << cameraId
+                      << ": " << e.what() << std::endl;
+
+            // Attempt reconnection if enabled (once this loop has returned)
+            camera->markFailed();
+            failed = camera->getConfig().autoReconnect;
+            break;
+        }
+    }
 }
 
-void StreamManager::startDecodeLoop(const std::string& cameraId) {
-    // Submit decode task to decode thread pool
-    decodePool_->submitDecodeTask(cameraId, [this, cameraId](CUcontext /* cudaContext */) {
-        // Get camera (CUcontext is set current by decode thread, decoder uses it implicitly)
-        CameraStream* camera = getCamera(cameraId);
-        if (!camera) {
+void StreamManager::stopNetworkReceiveLoop(const std::string& cameraId) {
+    // Reactor mode: removing the source waits for a service in flight
+    networkPool_->unassignCamera(cameraId);
+
+    std::shared_ptr<PinnedLoop> loop;
+    {
+        std::lock_guard<std::mutex> lock(pinnedMutex_);
+        auto it = pinnedLoops_.find(cameraId);
+        if (it == pinnedLoops_.end()) {
             return;
         }
+        loop = std::move(it->second);
+        pinnedLoops_.erase(it);
+    }
 
-        auto* decoder = camera->getDecoder();
-        auto* packetQueue = camera->getPacketQueue();
+    loop->stop = true;
+    if (loop->thread.joinable()) {
+        loop->thread.join();
+    }
+}
 
-        if (!decoder || !packetQueue) {
-            return;
+bool StreamManager::registerNetworkSource(const std::string& cameraId, CameraStream* camera) {
+    // The camera pointer stays valid while registered: detachCamera() unregisters
+    // (waiting for any in-flight service) before the camera is destroyed.
+    // RTP/UDP sources expose their socket and are serviced on readiness (and on
+    // the reactor's socket timer, for jitter and keepalive deadlines). FFmpeg does
+    // not expose the RTSP/TCP socket, so those sources are handle-less and the
+    // reactor polls them on its adaptive timer. Each such read blocks until data
+    // or the client's read deadline, and the other cameras of this reactor wait
+    // meanwhile: the reason reactor mode is opt-in.
+    //
+    // A failed camera is dropped by the reactor (CLOSED). Its thread assignment
+    // stays until reconnectCamera() or removeCamera() detaches it.
+    auto service = [this, cameraId, camera, accessUnits = std::vector<network::AccessUnit>()]() mutable
+        -> threading::ServiceResult {
+        if (!running_) {
+            return threading::ServiceResult::CLOSED;
         }
 
-        // Decode loop (runs continuously while camera is active)
-        while (running_ && camera->isRunning()) {
-            StreamPacket packet;
+        // Reconnect and stop detach first: not running here means the camera failed
+        if (!camera->isRunning()) {
+            return threading::ServiceResult::CLOSED;
+        }
 
-            // Try to pop packet from queue
-            if (packetQueue->pop(packet)) {
-                try {
-                    // Decode packet
-                    DecodeResult result = decoder->decode(packet.data.data(), packet.data.size());
+        auto* source = camera->getSource();
+        auto* packetQueue = camera->getPacketQueue();
+        auto* packetFanout = camera->getPacketFanout();
+        if (!source || !packetQueue) {
+            return threading::ServiceResult::WOULD_BLOCK;
+        }
 
-                    if (result.status == DecodeStatus::SUCCESS && result.frame) {
-                        // Notify frame callback
-                        onFrameDecoded(cameraId, result.frame);
-                    }
+        for (int i = 0; i < kMaxReadsPerService; ++i) {
+            auto status = source->readAccessUnits(accessUnits);
+
+            if (status == network::StreamSource::ReadStatus::WOULD_BLOCK) {
+                return i > 0 ? threading::ServiceResult::PROGRESS
+                             : threading::ServiceResult::WOULD_BLOCK;
+            }
+
+            if (status == network::StreamSource::ReadStatus::CLOSED) {
+                // The client gave up (reconnect attempts exhausted, or none allowed);
+                // reconnectAll() brings the camera back
+                std::cerr << "Network source closed for camera " << cameraId << std::endl;
+                camera->markFailed();
+                return threading::ServiceResult::CLOSED;
+            }
+
+            if (accessUnits.empty()) {
+                continue;  // Parameter sets or partial picture only
+            }
+
+            const auto packetCallback = getPacketCallback();
+            for (auto& au : accessUnits) {
+                StreamPacket packet;
+                packet.data = std::move(au.data);
+                packet.timestamp = au.pts;
+                packet.isKeyFrame = au.isKeyframe;
+                packet.isReference = au.isReference;
+                packet.receiveTime = au.receiveTime;
+
+                // Sees every picture, including those the queue is about to shed
+                if (packetCallback) {
+                    (*packetCallback)(cameraId, packet);
                 }
-                catch (const std::exception& e) {
-                    std::cerr << "Decode error for camera " << cameraId
-                              << ": " << e.what() << std::endl;
+
+                // Same buffers for every subscriber, each with its own queue
+                if (packetFanout->hasSubscribers()) {
+                    packetFanout->publish(packet);
                 }
-            } else {
-                // Queue empty, brief sleep to avoid busy-wait
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+                camera->queuePacket(std::move(packet));
             }
+
+            deviceFor(*camera).scheduler->notifyPending(cameraId);
         }
-    });
+
+        // Budget exhausted: yield to other cameras on this reactor
+        return threading::ServiceResult::PROGRESS;
+    };
+
+    auto* source = camera->getSource();
+    const threading::SocketHandle handle = source ? source->nativeHandle() : threading::kInvalidSocket;
+    return networkPool_->registerCamera(cameraId, handle, std::move(service));
 }
 
-void StreamManager::onFrameDecoded(const std::string& cameraId,
-                                   const DecodedFrame* frame) {
-    // Invoke user callback if set
-    std::lock_guard<std::mutex> lock(callbackMutex_);
-    if (frameCallback_) {
-        frameCallback_(cameraId, frame);
+void StreamManager::startDecodeLoop(const std::string& cameraId) {
+    // No thread is pinned: the scheduler serves the camera whenever packets are pending
+    CameraStream* camera = getCamera(cameraId);
+    if (camera && !deviceFor(*camera).scheduler->registerCamera(cameraId, camera)) {
+        std::cerr << "StreamManager: failed to register camera " << cameraId
+                  << " with decode scheduler" << std::endl;
+    }
+}
+
+size_t StreamManager::decodeSlice(CameraStream& camera, size_t maxUnits) {
+    // Runs on a decode thread (CUcontext already current, decoder uses it implicitly)
+    auto* decoder = camera.getDecoder();
+    auto* packetQueue = camera.getPacketQueue();
+
+    if (!running_ || !camera.isRunning()) {
+        return 0;
+    }
+
+    const std::string cameraId = camera.getId();
+    auto* decimator = camera.getDecimator();
+
+    // Downloads queued by earlier slices that have finished meanwhile
+    deliverDownloads(camera);
+
+    size_t consumed = 0;
+    StreamPacket packet;
+
+    // Lazy start: nothing before the first IDR can be decoded, so the decoder is
+    // only created once one arrives (here, with the worker's context current)
+    bool haveKeyframe = false;
+    if (!decoder) {
+        while (!haveKeyframe && consumed < maxUnits && packetQueue->pop(packet)) {
+            consumed++;
+            haveKeyframe = packet.isKeyFrame;
+        }
+
+        if (!haveKeyframe || !startDecoder(camera)) {
+            return consumed;
+        }
+        decoder = camera.getDecoder();
+    }
+
+    // Idle cameras decode keyframes only until activity is seen again
+    camera.updateActivityGate();
+
+    // Apply quality changes here, between packets, so decoders never reconfigure mid-decode
+    const StreamQuality quality = camera.getQuality();
+    if (decimator->getQuality() != quality) {
+        decoder->setQuality(static_cast<fluxvision::StreamQuality>(quality));
+        decimator->setQuality(quality);
+    }
+
+    // Instant start: replay the cached GOP instead of waiting for the next IDR
+    // (it starts at or after a keyframe popped above)
+    if (camera.takePrimeRequest() && quality != StreamQuality::PAUSED && primeDecoder(camera)) {
+        haveKeyframe = false;
+    }
+
+    if (haveKeyframe) {
+        decodePacket(camera, packet);
+    }
+
+    while (consumed < maxUnits && packetQueue->pop(packet)) {
+        consumed++;
+        decodePacket(camera, packet);
+    }
+
+    deliverDownloads(camera);
+
+    // Decoders allocating from the shared pool are accounted by it; others report
+    // their surface pool resizes (first sequence header, quality change, sub/main switch)
+    MemoryStats memory = decoder->getMemoryUsage();
+    camera.getMetrics().recordSurfaces(decoder->isHardwareAccelerated(), memory.surfacePoolSize,
+                                       memory.surfacePoolCapacity, memory.gpuMemoryUsed);
+    if (!camera.getConfig().memoryPool && memory.gpuMemoryUsed != camera.getAccountedGpuBytes()) {
+        deviceFor(camera).resources.memoryPool->updateAllocation(cameraId, memory.gpuMemoryUsed,
+                                                                 memory.surfacePoolSize);
+        camera.setAccountedGpuBytes(memory.gpuMemoryUsed);
+    }
+
+    return consumed;
+}
+
+void StreamManager::decodePacket(CameraStream& camera, const StreamPacket& packet) {
+    // Called right after the pop
+    const int64_t popped = metrics::traceNow();
+
+    // Skip pictures the tier won't display (PAUSED: keyframes only)
+    if (!camera.getDecimator()->shouldDecode(packet)) {
+        return;
+    }
+
+    IDecoder* decoder = camera.getDecoder();
+    const int64_t submitted = metrics::traceNow();
+    DecodeResult result = decoder->decodePacket(packet.data, packet.timestamp);
+    const bool decoded = result.status == DecodeStatus::SUCCESS ||
+                         result.status == DecodeStatus::NEED_MORE_DATA;
+    camera.getMetrics().recordDecode(std::chrono::microseconds(metrics::traceNow() - submitted), decoded);
+    if (!decoded) {
+        return;
+    }
+
+    // Before draining: the frame this packet produces may come out right away
+    camera.getTracer().onSubmit(packet.timestamp, packet.receiveTime, packet.queuedTime, popped, submitted);
+
+    // Deliver every frame the decoder has ready (decode() may complete several or none)
+    while (FrameHandle frame = decoder->acquireFrame()) {
+        onFrameDecoded(camera, frame);
+    }
+}
+
+bool StreamManager::startDecoder(CameraStream& camera) {
+    if (!camera.startDecoder()) {
+        std::cerr << "StreamManager: failed to create decoder for camera " << camera.getId() << std::endl;
+        return false;
+    }
+
+    // AUTO decoders may have fallen back to the CPU
+    admission_->confirm(camera.getId(), camera.getDecoder()->isHardwareAccelerated());
+    return true;
+}
+
+bool StreamManager::primeDecoder(CameraStream& camera) {
+    std::vector<StreamPacket> gop;
+    bool continuous = false;
+    if (!camera.takeCachedGop(gop, continuous)) {
+        return false;
+    }
+
+    auto* decoder = camera.getDecoder();
+    auto* decimator = camera.getDecimator();
+
+    // Decode the burst, but only show where it ends up (the newest picture)
+    FrameHandle newest;
+    for (const StreamPacket& cached : gop) {
+        if (!decimator->shouldDecode(cached)) {
+            continue;
+        }
+
+        DecodeResult result = decoder->decodePacket(cached.data, cached.timestamp);
+        if (result.status != DecodeStatus::SUCCESS &&
+            result.status != DecodeStatus::NEED_MORE_DATA) {
+            continue;
+        }
+
+        while (FrameHandle frame = decoder->acquireFrame()) {
+            newest = std::move(frame);
+        }
     }
+
+    if (newest) {
+        onFrameDecoded(camera, newest);
+    }
+
+    // Cached before a reconnect: the new session's pictures don't follow on from it
+    if (!continuous) {
+        decimator->resync();
+    }
+    return true;
+}
+
+void StreamManager::deliverDownloads(CameraStream& camera) {
+    gpu::FrameDownloader* downloader = camera.getDownloader();
+    if (!downloader) {
+        return;
+    }
+
+    std::vector<FrameHandle> downloaded;
+    downloader->poll(downloaded);
+    for (const FrameHandle& frame : downloaded) {
+        camera.getFanout()->publishDownloaded(frame);
+    }
+}
+
+void StreamManager::onFrameDecoded(CameraStream& camera, const FrameHandle& frame) {
+    camera.getMetrics().recordFrame(frame->pts);
+
+    // Per-camera subscribers: wait-free hand-off into each mailbox
+    camera.getFanout()->publish(frame);
+
+    // Activity gating: a sampled frame goes to the estimator, read back next slice
+    camera.measureActivity(frame);
+
+    // Subscribers wanting CPU pixels get the frame once its copy to pinned
+    // memory finishes (a later deliverDownloads()); a full downloader drops it
+    if (frame->cudaSurface && camera.getFanout()->hasHostSubscribers()) {
+        if (gpu::FrameDownloader* downloader = camera.ensureDownloader()) {
+            downloader->submit(frame);
+        }
+    }
+
+    // Global callback: a snapshot of the published set, no lock per frame; a
+    // replaced callback finishes its calls in flight on the old set
+    const std::shared_ptr<const Callbacks> callbacks = getCallbacks();
+    if (callbacks->frameHandle) {
+        (*callbacks->frameHandle)(camera.getId(), frame);
+    } else if (callbacks->frame) {
+        (*callbacks->frame)(camera.getId(), frame.get());
+    }
+
+    camera.getTracer().onDelivered(camera.getConfig().id, frame->pts, frame->outputTime, metrics::traceNow());
+
+    // Unless a consumer kept a copy, the surface goes back to the pool on return
 }
 
 } // namespace stream
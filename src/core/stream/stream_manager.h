@@ -3,13 +3,20 @@
 #pragma once
 
 #include "camera_stream.h"
+#include "decode_scheduler.h"
+#include "admission_controller.h"
 #include "../threading/network_thread_pool.h"
 #include "../threading/decode_thread_pool.h"
 #include "../gpu/memory_pool.h"
 #include "../codec/types.h"
 #include <unordered_map>
+#include <unordered_set>
 #include <shared_mutex>
 #include <functional>
+#include <mutex>
+#include <memory>
+#include <chrono>
+#include <thread>
 #include <vector>
 
 namespace fluxvision {
@@ -19,6 +26,51 @@ namespace stream {
 using FrameCallback = std::function<void(const std::string& cameraId,
                                          const DecodedFrame* frame)>;
 
+// Handle callback: consumers may keep (and share) the handle past the call;
+// the frame's surface returns to the decoder's pool when the last copy is dropped
+using FrameHandleCallback = std::function<void(const std::string& cameraId,
+                                               const FrameHandle& frame)>;
+
+// Packet callback: every received access unit, before decode and load shedding
+// (recording, forwarding). Runs on the network thread: must not block.
+using PacketCallback = std::function<void(const std::string& cameraId,
+                                          const StreamPacket& packet)>;
+
+// Where one camera is during addCameras()
+enum class CameraStartStage {
+    CONNECTING,   // RTSP session setup started
+    STARTED,      // Admitted and streaming (a lazy decoder follows at the first IDR)
+    FAILED        // Connection failed, rejected by admission control, or duplicate id
+};
+
+struct CameraStartProgress {
+    std::string cameraId;
+    CameraStartStage stage = CameraStartStage::CONNECTING;
+    size_t completed = 0;        // Cameras started or failed so far
+    size_t total = 0;
+};
+
+// Bulk-add progress (calls are serialized, but come from the connecting threads)
+using CameraStartCallback = std::function<void(const CameraStartProgress& progress)>;
+
+struct BulkAddOptions {
+    size_t maxInFlight = 32;     // Cameras connecting at once (RTSP handshakes in parallel)
+    bool lazyDecoders = true;    // Create each decoder on a decode worker at the camera's first IDR
+};
+
+struct BulkAddResult {
+    size_t started = 0;
+    size_t failed = 0;
+    std::chrono::milliseconds elapsed{0};
+};
+
+// Decode resources of one CUDA device (not owned)
+struct DecodeDevice {
+    int cudaDeviceId = 0;
+    threading::DecodeThreadPool* decodePool = nullptr;  // Workers with contexts on this device
+    gpu::GPUMemoryPool* memoryPool = nullptr;            // Surfaces on this device
+};
+
 // Global statistics across all cameras
 struct GlobalStats {
     size_t totalCameras = 0;
@@ -28,7 +80,25 @@ struct GlobalStats {
     double avgFps = 0.0;
     size_t totalDroppedFrames = 0;
     size_t totalDecodedFrames = 0;
-    gpu::GPUMemoryPool::Stats memoryStats;
+    gpu::GPUMemoryPool::Stats memoryStats;                     // First device
+    std::vector<gpu::GPUMemoryPool::Stats> deviceMemoryStats;  // Every device, in initialize() order
+    DecodeScheduler::Stats schedulerStats;                     // Summed over devices
+    AdmissionController::Stats admissionStats;
+};
+
+// Load picture of one running camera, for the quality governor
+struct CameraLoad {
+    std::string cameraId;
+    StreamQuality requested = StreamQuality::GRID_VIEW;
+    StreamQuality quality = StreamQuality::GRID_VIEW;    // Decoded at (cap and activity gate applied)
+    StreamQuality cap = StreamQuality::FULLSCREEN;
+    int priority = 0;
+    bool idleGated = false;
+    bool hardware = true;        // NVDEC (false: CPU decoder)
+    size_t device = 0;           // Index into the devices passed to initialize()
+    size_t queueDepth = 0;
+    size_t queueCapacity = 0;
+    double decodeLoad = 0.0;     // 1080p30 equivalents at quality (admission cost model)
 };
 
 // Manages multiple camera streams
@@ -44,26 +114,92 @@ public:
     // Initialize with thread pools and memory pool
     bool initialize(threading::NetworkThreadPool* networkPool,
                    threading::DecodeThreadPool* decodePool,
-                   gpu::GPUMemoryPool* memoryPool);
+                   gpu::GPUMemoryPool* memoryPool,
+                   const AdmissionController::Config& admissionConfig = AdmissionController::Config());
+
+    // Multi-GPU: one decode pool and memory pool per device. Cameras are placed
+    // on the device with the most headroom (CPU-decoded cameras use the first).
+    bool initialize(threading::NetworkThreadPool* networkPool,
+                   const std::vector<DecodeDevice>& devices,
+                   const AdmissionController::Config& admissionConfig = AdmissionController::Config());
 
     // Camera management
+    // addCamera() connects first, then admits the camera at the requested tier,
+    // a lower tier or on the CPU decoder; false if it was rejected or failed to start
     bool addCamera(const CameraStream::Config& config);
+
+    // Bulk startup (site restart, config.yaml): cameras are added concurrently,
+    // at most maxInFlight at a time, so cold start is bound by the slowest
+    // handshakes rather than their sum. Blocks until every camera has started
+    // or failed.
+    BulkAddResult addCameras(const std::vector<CameraStream::Config>& configs,
+                             const BulkAddOptions& options = BulkAddOptions(),
+                             CameraStartCallback progress = nullptr);
     bool removeCamera(const std::string& id);
     void setQuality(const std::string& id, StreamQuality quality);
     CameraStream* getCamera(const std::string& id);
 
+    // Load shedding (quality governor): cap a camera's tier below what was
+    // requested (FULLSCREEN lifts the cap); the admission reservation is kept,
+    // so lifting it always fits. Priority orders who is capped first.
+    void setQualityCap(const std::string& id, StreamQuality cap);
+    void setPriority(const std::string& id, int priority);
+
+    // Device placement (device: index into the devices passed to initialize())
+    // migrateCamera() rebuilds the camera's decoder on the other device; decoding
+    // resumes at the next IDR. rebalance() performs the admission controller's
+    // proposed migration, if the devices have drifted out of balance.
+    bool migrateCamera(const std::string& id, size_t device);
+    bool rebalance();
+    size_t getDeviceCount() const { return devices_.size(); }
+
     // Batch operations
     void startAll();
     void stopAll();
     void setAllQuality(StreamQuality quality);
-    void reconnectAll();
+    void reconnectAll();   // Cameras in ERROR, one reconnectCamera() each
+
+    // Restart one camera's session. It is detached from the network and decode
+    // threads first (waiting for a receive or decode slice in flight), so its
+    // client and decoder can be replaced; false if it failed to come back.
+    bool reconnectCamera(const std::string& id);
 
-    // Frame callback
+    // Frame subscriptions (any thread): each subscriber polls its own mailbox and
+    // can never stall a decode worker. Dropping the subscription also unsubscribes.
+    // Returns nullptr if the camera doesn't exist.
+    std::shared_ptr<FrameSubscription> subscribe(const std::string& cameraId,
+                                                 const FrameSubscription::Options& options = {});
+    void unsubscribe(const std::string& cameraId,
+                     const std::shared_ptr<FrameSubscription>& subscription);
+
+    // Frame callback (all cameras; runs on the decode worker, so keep it short)
     void setFrameCallback(FrameCallback callback);
+    void setFrameHandleCallback(FrameHandleCallback callback);  // Takes precedence over FrameCallback
+
+    // Packet subscriptions (any thread): the camera's single RTSP session also
+    // feeds each subscriber its own bounded queue, sharing the packet buffers.
+    // A slow consumer only loses its own GOP tails. Returns nullptr if the
+    // camera doesn't exist.
+    std::shared_ptr<PacketSubscription> subscribePackets(const std::string& cameraId,
+                                                         const PacketSubscription::Options& options = {});
+    void unsubscribePackets(const std::string& cameraId,
+                            const std::shared_ptr<PacketSubscription>& subscription);
+
+    // Packet tap (all cameras, compressed, before the packet queue; runs on the
+    // network thread, so only for consumers that never block, like Recorder)
+    void setPacketCallback(PacketCallback callback);
 
     // Statistics
     GlobalStats getGlobalStats() const;
     std::vector<std::string> getCameraIds() const;
+
+    // Running cameras' tiers, queues and modelled decode load (any thread, no locks
+    // on the hot path)
+    std::vector<CameraLoad> collectLoad() const;
+
+    // Every camera's counters for a metrics scrape, sorted by camera id (never
+    // blocks the network or decode threads; see metrics::renderOpenMetrics)
+    std::vector<metrics::CameraSample> collectMetrics() const;
     size_t getCameraCount() const;
 
     // Lifecycle
@@ -71,27 +207,68 @@ public:
     void shutdown();
 
 private:
+    struct Device {
+        DecodeDevice resources;
+
+        // Multiplexes the device's cameras over its decode threads (shared with its pool workers)
+        std::shared_ptr<DecodeScheduler> scheduler;
+    };
+
     // Thread pools (not owned, injected)
     threading::NetworkThreadPool* networkPool_ = nullptr;
-    threading::DecodeThreadPool* decodePool_ = nullptr;
-    gpu::GPUMemoryPool* memoryPool_ = nullptr;
+    std::vector<Device> devices_;
+
+    // Keeps cameras from overcommitting NVDEC and VRAM, and places them on devices
+    std::unique_ptr<AdmissionController> admission_;
+    bool rebalanceOnChange_ = true;
+    std::mutex migrationMutex_;  // One migration at a time
 
     // Camera registry
     std::unordered_map<std::string, std::unique_ptr<CameraStream>> cameras_;
     mutable std::shared_mutex camerasMutex_;  // Read-write lock for camera access
+    std::unordered_set<std::string> addingCameras_;  // Ids reserved by addCamera() calls in progress
 
-    // Frame callback
-    FrameCallback frameCallback_;
-    std::mutex callbackMutex_;
+    // Global callbacks, replaced as a whole set: setters copy, change and
+    // publish it (std::atomic_store), workers take a snapshot with std::atomic_load
+    struct Callbacks {
+        std::shared_ptr<const FrameCallback> frame;
+        std::shared_ptr<const FrameHandleCallback> frameHandle;
+        std::shared_ptr<const PacketCallback> packet;
+    };
+    std::shared_ptr<const Callbacks> callbacks_ = std::make_shared<const Callbacks>();
+    std::mutex callbackMutex_;  // Serializes the setters only
 
     // Lifecycle
     std::atomic<bool> initialized_{false};
     std::atomic<bool> running_{false};
 
+    // Pinned-thread receive loop of one camera (pinnedMutex_ guards the map)
+    struct PinnedLoop {
+        std::atomic<bool> stop{false};
+        std::thread thread;     // Joined by stopNetworkReceiveLoop()
+    };
+    std::unordered_map<std::string, std::shared_ptr<PinnedLoop>> pinnedLoops_;
+    std::mutex pinnedMutex_;
+
     // Internal helpers
+    size_t deviceIndex(int cudaDeviceId) const;  // First device if unknown
+    Device& deviceFor(const CameraStream& camera) { return devices_[deviceIndex(camera.getDeviceId())]; }
+    std::shared_ptr<const PacketCallback> getPacketCallback() const;
+    std::shared_ptr<const Callbacks> getCallbacks() const { return std::atomic_load(&callbacks_); }
+    void updateCallbacks(const std::function<void(Callbacks&)>& update);
     void startNetworkReceiveLoop(const std::string& cameraId);
+    void stopNetworkReceiveLoop(const std::string& cameraId);  // Waits for a read in flight
+    void receivePinned(const std::string& cameraId, PinnedLoop& loop, bool& failed);
+    void attachCamera(const std::string& cameraId);   // Network and decode threads
+    void detachCamera(const std::string& cameraId, CameraStream& camera);
+    bool registerNetworkSource(const std::string& cameraId, CameraStream* camera);
     void startDecodeLoop(const std::string& cameraId);
-    void onFrameDecoded(const std::string& cameraId, const DecodedFrame* frame);
+    size_t decodeSlice(CameraStream& camera, size_t maxUnits);
+    void decodePacket(CameraStream& camera, const StreamPacket& packet);
+    bool startDecoder(CameraStream& camera);  // Lazy decoder, at the first IDR
+    bool primeDecoder(CameraStream& camera);  // Replay the GOP cache; false if empty
+    void onFrameDecoded(CameraStream& camera, const FrameHandle& frame);
+    void deliverDownloads(CameraStream& camera);  // Finished host copies to hostFrames subscribers
 };
 
 } // namespace stream
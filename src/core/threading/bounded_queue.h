@@ -48,17 +48,6 @@ public:
         return true;
     }
 
-    // Push with overflow strategy (drop oldest)
-    // Always succeeds by making space if needed
-    void pushOrDropOldest(T&& item) {
-        if (!push(std::forward<T>(item))) {
-            // Queue full - drop oldest, retry
-            T dummy;
-            pop(dummy);
-            push(std::forward<T>(item));
-        }
-    }
-
     // Pop item (consumer side)
     // Returns: true if popped, false if empty
     bool pop(T& item) {
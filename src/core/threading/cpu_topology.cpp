@@ -0,0 +1,264 @@
+// src/core/threading/cpu_topology.cpp
+#include "cpu_topology.h"
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#ifdef HAVE_CUDA
+#include <cuda.h>
+#endif
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <filesystem>
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace fluxvision {
+namespace threading {
+
+namespace {
+#ifndef _WIN32
+    std::string readLine(const std::string& path) {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    int readInt(const std::string& path, int fallback) {
+        const std::string line = readLine(path);
+        try {
+            return line.empty() ? fallback : std::stoi(line);
+        } catch (...) {
+            return fallback;
+        }
+    }
+
+    // Kernel CPU list format: "0-11,24-35"
+    std::vector<int> parseCpuList(const std::string& list) {
+        std::vector<int> cpus;
+        std::stringstream ranges(list);
+        std::string range;
+        while (std::getline(ranges, range, ',')) {
+            try {
+                const size_t dash = range.find('-');
+                const int first = std::stoi(range.substr(0, dash));
+                const int last = dash == std::string::npos ? first : std::stoi(range.substr(dash + 1));
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    cpus.push_back(cpu);
+                }
+            } catch (...) {
+                // Blank or malformed entry
+            }
+        }
+        return cpus;
+    }
+#endif
+}
+
+CpuTopology::CpuTopology() {
+    discover();
+
+    // No NUMA information: one node with every CPU
+    if (nodes_.empty()) {
+        std::vector<int> cpus;
+        const int count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+        for (int cpu = 0; cpu < count; ++cpu) {
+            cpus.push_back(cpu);
+        }
+        nodes_.push_back(std::move(cpus));
+    }
+}
+
+const CpuTopology& CpuTopology::instance() {
+    static CpuTopology topology;
+    return topology;
+}
+
+void CpuTopology::discover() {
+#ifdef _WIN32
+    ULONG highestNode = 0;
+    if (!GetNumaHighestNodeNumber(&highestNode)) {
+        return;
+    }
+
+    // CPUs are numbered group * 64 + bit, the numbering pinThread expects
+    for (ULONG node = 0; node <= highestNode; ++node) {
+        GROUP_AFFINITY affinity = {};
+        std::vector<int> cpus;
+        if (GetNumaNodeProcessorMaskEx(static_cast<USHORT>(node), &affinity)) {
+            for (int bit = 0; bit < 64; ++bit) {
+                if (affinity.Mask & (static_cast<KAFFINITY>(1) << bit)) {
+                    cpus.push_back(affinity.Group * 64 + bit);
+                }
+            }
+        }
+        nodes_.push_back(std::move(cpus));
+    }
+#else
+    // node<N> directories are numbered densely on every kernel we run on;
+    // a gap keeps its index with no CPUs
+    std::error_code ec;
+    int highestNode = -1;
+    for (const auto& entry : std::filesystem::directory_iterator("/sys/devices/system/node", ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+            std::all_of(name.begin() + 4, name.end(), [](char c) { return std::isdigit(static_cast<unsigned char>(c)); })) {
+            highestNode = std::max(highestNode, std::stoi(name.substr(4)));
+        }
+    }
+
+    for (int node = 0; node <= highestNode; ++node) {
+        nodes_.push_back(parseCpuList(readLine("/sys/devices/system/node/node" + std::to_string(node) + "/cpulist")));
+    }
+#endif
+}
+
+const std::vector<int>& CpuTopology::getNodeCpus(int node) const {
+    static const std::vector<int> kNone;
+    if (node < 0 || static_cast<size_t>(node) >= nodes_.size()) {
+        return kNone;
+    }
+    return nodes_[static_cast<size_t>(node)];
+}
+
+int CpuTopology::nodeOfCpu(int cpu) const {
+    for (size_t node = 0; node < nodes_.size(); ++node) {
+        if (std::binary_search(nodes_[node].begin(), nodes_[node].end(), cpu)) {
+            return static_cast<int>(node);
+        }
+    }
+    return -1;
+}
+
+int CpuTopology::nodeOfCudaDevice(int deviceId) const {
+#if defined(HAVE_CUDA) && !defined(_WIN32)
+    if (nodes_.size() < 2 || cuInit(0) != CUDA_SUCCESS) {
+        return nodes_.size() == 1 ? 0 : -1;
+    }
+
+    CUdevice device = 0;
+    char busId[32] = {};
+    if (cuDeviceGet(&device, deviceId) != CUDA_SUCCESS ||
+        cuDeviceGetPCIBusId(busId, static_cast<int>(sizeof(busId)), device) != CUDA_SUCCESS) {
+        return -1;
+    }
+
+    // CUDA reports "0000:3B:00.0"; sysfs names the slot in lower case
+    std::string slot(busId);
+    std::transform(slot.begin(), slot.end(), slot.begin(),
+                   [](char c) { return static_cast<char>(std::tolower(static_cast<unsigned char>(c))); });
+
+    const int node = readInt("/sys/bus/pci/devices/" + slot + "/numa_node", -1);
+    return static_cast<size_t>(node) < nodes_.size() ? node : -1;
+#else
+    (void)deviceId;
+    return nodes_.size() == 1 ? 0 : -1;
+#endif
+}
+
+int CpuTopology::nodeOfNetworkInterface(const std::string& name) const {
+#ifdef _WIN32
+    (void)name;
+    return nodes_.size() == 1 ? 0 : -1;
+#else
+    if (nodes_.size() == 1) {
+        return 0;
+    }
+
+    const std::string iface = name.empty() ? defaultNetworkInterface() : name;
+    if (iface.empty()) {
+        return -1;
+    }
+    const std::string device = "/sys/class/net/" + iface + "/device";
+
+    // Receive processing runs where the queues' interrupts are steered
+    // (irqbalance may move them away from the slot's node): majority vote
+    std::map<int, int> votes;
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(device + "/msi_irqs", ec)) {
+        const std::string irq = entry.path().filename().string();
+        const std::vector<int> cpus = parseCpuList(readLine("/proc/irq/" + irq + "/smp_affinity_list"));
+
+        // An IRQ allowed on every CPU says nothing about placement
+        if (cpus.empty() || cpus.size() >= static_cast<size_t>(std::thread::hardware_concurrency())) {
+            continue;
+        }
+        const int node = nodeOfCpu(cpus.front());
+        if (node >= 0) {
+            votes[node]++;
+        }
+    }
+
+    if (!votes.empty()) {
+        return std::max_element(votes.begin(), votes.end(),
+                                [](const auto& a, const auto& b) { return a.second < b.second; })->first;
+    }
+
+    const int node = readInt(device + "/numa_node", -1);
+    return static_cast<size_t>(node) < nodes_.size() ? node : -1;
+#endif
+}
+
+std::string CpuTopology::defaultNetworkInterface() {
+#ifdef _WIN32
+    return std::string();
+#else
+    // "Iface Destination Gateway ...", hex destination 00000000 is the default route
+    std::ifstream routes("/proc/net/route");
+    std::string line;
+    std::getline(routes, line);   // Header
+    while (std::getline(routes, line)) {
+        std::istringstream fields(line);
+        std::string iface;
+        std::string destination;
+        if (fields >> iface >> destination && destination == "00000000") {
+            return iface;
+        }
+    }
+    return std::string();
+#endif
+}
+
+bool CpuTopology::pinThread(std::thread& thread, const std::vector<int>& cpus) {
+    if (cpus.empty() || !thread.joinable()) {
+        return false;
+    }
+
+#ifdef _WIN32
+    // A thread's affinity lives in one processor group
+    GROUP_AFFINITY affinity = {};
+    affinity.Group = static_cast<WORD>(cpus.front() / 64);
+    for (int cpu : cpus) {
+        if (cpu / 64 == affinity.Group) {
+            affinity.Mask |= static_cast<KAFFINITY>(1) << (cpu % 64);
+        }
+    }
+    return SetThreadGroupAffinity(thread.native_handle(), &affinity, nullptr) != 0;
+#else
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    for (int cpu : cpus) {
+        if (cpu >= 0 && cpu < CPU_SETSIZE) {
+            CPU_SET(cpu, &cpuset);
+        }
+    }
+    return pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set_t), &cpuset) == 0;
+#endif
+}
+
+std::vector<int> CpuTopology::cpusForSlot(int node, int slot) const {
+    const std::vector<int>& cpus = getNodeCpus(node);
+    if (cpus.empty() || slot < 0) {
+        return cpus;
+    }
+    return {cpus[static_cast<size_t>(slot) % cpus.size()]};
+}
+
+} // namespace threading
+} // namespace fluxvision
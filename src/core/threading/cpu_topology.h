@@ -0,0 +1,61 @@
+// src/core/threading/cpu_topology.h
+// NUMA topology: CPUs per node, and the node local to a GPU or a NIC
+#pragma once
+
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fluxvision {
+namespace threading {
+
+// Process-wide view of the machine's NUMA nodes, read once from sysfs
+// (Linux) or the NUMA API (Windows)
+//
+// Used to keep a thread on the socket of the device it talks to: decode
+// workers next to their GPU, network threads next to the CPUs servicing the
+// NIC's interrupts. With the CPU pinned, first-touch allocations made by the
+// thread (packet payloads, decoder state) land on the same node. A machine
+// without NUMA information reports one node holding every CPU.
+//
+// Thread-safety: const methods are thread-safe; the topology never changes
+class CpuTopology {
+public:
+    static const CpuTopology& instance();
+
+    // Number of nodes (1 on non-NUMA machines)
+    size_t getNodeCount() const { return nodes_.size(); }
+
+    // CPUs of a node, ascending (empty for an unknown node)
+    const std::vector<int>& getNodeCpus(int node) const;
+
+    // Node of a CPU (-1 if unknown)
+    int nodeOfCpu(int cpu) const;
+
+    // Node the CUDA device's PCI slot is attached to (-1 if unknown or no CUDA)
+    int nodeOfCudaDevice(int deviceId) const;
+
+    // Node the network interface's IRQs are steered to, else the node of its
+    // PCI slot (-1 if unknown); "" = the interface of the default route
+    int nodeOfNetworkInterface(const std::string& name = std::string()) const;
+
+    // Interface carrying the default IPv4 route ("" if none / not Linux)
+    static std::string defaultNetworkInterface();
+
+    // Restrict a running thread to these CPUs (false if the OS refused)
+    static bool pinThread(std::thread& thread, const std::vector<int>& cpus);
+
+    // Thread placement on a node: one CPU of the node chosen by slot, or the
+    // whole node when slot < 0. Empty if the node is unknown.
+    std::vector<int> cpusForSlot(int node, int slot) const;
+
+private:
+    CpuTopology();
+
+    void discover();
+
+    std::vector<std::vector<int>> nodes_;
+};
+
+} // namespace threading
+} // namespace fluxvision
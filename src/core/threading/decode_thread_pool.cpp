@@ -1,23 +1,35 @@
 // src/core/threading/decode_thread_pool.cpp
 #include "decode_thread_pool.h"
+#include "cpu_topology.h"
 #include "../gpu/cuda_context.h"
 #include <iostream>
+#include <stdexcept>
 
 namespace fluxvision {
 namespace threading {
 
 DecodeThreadPool::DecodeThreadPool(const Config& config)
     : config_(config)
+    , queue_(config.numThreads, config.enableWorkStealing)
 {
     workers_.reserve(config_.numThreads);
 
+    // Create all workers before starting threads (decodeWorkerLoop indexes workers_)
     for (size_t i = 0; i < config_.numThreads; ++i) {
         auto worker = std::make_unique<DecodeWorker>();
         worker->workerId = i;
-        worker->thread = std::thread([this, i]() { decodeWorkerLoop(i); });
-
         workers_.push_back(std::move(worker));
     }
+
+    for (size_t i = 0; i < config_.numThreads; ++i) {
+        workers_[i]->thread = std::thread([this, i]() { decodeWorkerLoop(i); });
+
+        // Whole node: CPU decoders' own threads inherit it and spread over the socket
+        if (config_.numaNode >= 0) {
+            CpuTopology::pinThread(workers_[i]->thread,
+                                   CpuTopology::instance().getNodeCpus(config_.numaNode));
+        }
+    }
 }
 
 DecodeThreadPool::~DecodeThreadPool() {
@@ -25,18 +37,8 @@ DecodeThreadPool::~DecodeThreadPool() {
 }
 
 void DecodeThreadPool::shutdown(bool waitForTasks) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-        running_ = false;
-
-        if (!waitForTasks) {
-            // Clear pending tasks
-            std::queue<DecodeTask> empty;
-            std::swap(tasks_, empty);
-        }
-    }
-
-    condition_.notify_all();
+    running_ = false;
+    queue_.close(!waitForTasks);
 
     // Join all threads
     for (auto& worker : workers_) {
@@ -45,6 +47,11 @@ void DecodeThreadPool::shutdown(bool waitForTasks) {
         }
     }
 
+    // Discard tasks left behind (not waiting, or no worker had a CUDA context)
+    while (DecodeTask* task = queue_.tryPopAny()) {
+        delete task;
+    }
+
     // Cleanup CUDA contexts
     for (auto& worker : workers_) {
         cleanupCudaContext(*worker);
@@ -52,24 +59,21 @@ void DecodeThreadPool::shutdown(bool waitForTasks) {
 }
 
 #ifdef HAVE_CUDA
-void DecodeThreadPool::submitDecodeTask(const std::string& cameraId,
+void DecodeThreadPool::submitDecodeTask(const std::string& /* cameraId */,
                                         std::function<void(CUcontext)> task)
 #else
-void DecodeThreadPool::submitDecodeTask(const std::string& cameraId,
+void DecodeThreadPool::submitDecodeTask(const std::string& /* cameraId */,
                                         std::function<void(void*)> task)
 #endif
 {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-
-        if (!running_) {
-            throw std::runtime_error("DecodeThreadPool: Cannot submit task to stopped pool");
-        }
+    post(std::move(task));
+}
 
-        tasks_.push({cameraId, std::move(task)});
+void DecodeThreadPool::enqueue(DecodeTask* task) {
+    if (!queue_.push(task)) {
+        delete task;
+        throw std::runtime_error("DecodeThreadPool: Cannot submit task to stopped pool");
     }
-
-    condition_.notify_one();
 }
 
 void DecodeThreadPool::decodeWorkerLoop(size_t workerId) {
@@ -82,33 +86,23 @@ void DecodeThreadPool::decodeWorkerLoop(size_t workerId) {
         return;
     }
 
-    while (true) {
-        DecodeTask task;
+    // Tasks submitted from this worker go to its own deque
+    queue_.bindCurrentThread(workerId);
 
-        {
-            std::unique_lock<std::mutex> lock(queueMutex_);
+    while (DecodeTask* task = queue_.pop(workerId)) {
+        worker.busy = true;
 
-            condition_.wait(lock, [this] {
-                return !running_ || !tasks_.empty();
-            });
-
-            if (!running_ && tasks_.empty()) {
-                break;
-            }
-
-            if (!tasks_.empty()) {
-                task = std::move(tasks_.front());
-                tasks_.pop();
-                worker.busy = true;
-            }
+        // Execute task with this thread's CUDA context
+        try {
+            task->run(worker.cudaContext);
         }
-
-        if (task.task) {
-            // Execute task with this thread's CUDA context
-            task.task(worker.cudaContext);
-            worker.decodesProcessed++;
-            worker.busy = false;
+        catch (const std::exception& e) {
+            std::cerr << "DecodeThreadPool: task threw exception: " << e.what() << std::endl;
         }
+
+        delete task;
+        worker.decodesProcessed++;
+        worker.busy = false;
     }
 }
 
@@ -155,10 +149,7 @@ void DecodeThreadPool::cleanupCudaContext(DecodeWorker& worker) {
 DecodeThreadPool::Stats DecodeThreadPool::getStats() const {
     Stats stats;
 
-    {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-        stats.tasksInQueue = tasks_.size();
-    }
+    stats.tasksInQueue = queue_.size();
 
     stats.perThreadDecodeCount.reserve(workers_.size());
     for (const auto& worker : workers_) {
@@ -3,14 +3,14 @@
 // Each thread has its own persistent CUDA context
 #pragma once
 
+#include "work_queue.h"
 #include <vector>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
-#include <queue>
 #include <functional>
 #include <atomic>
+#include <memory>
 #include <string>
+#include <type_traits>
 
 #ifdef HAVE_CUDA
 #include <cuda.h>
@@ -22,10 +22,18 @@ namespace threading {
 // Specialized decode thread pool with CUDA context per thread
 class DecodeThreadPool {
 public:
+    // Context handed to every task (this thread's CUDA context)
+#ifdef HAVE_CUDA
+    using Context = CUcontext;
+#else
+    using Context = void*;
+#endif
+
     struct Config {
         size_t numThreads = 4;
         int cudaDeviceId = 0;
         bool enableWorkStealing = true;
+        int numaNode = -1;              // Keep workers on this NUMA node (-1 = anywhere)
     };
 
     struct Stats {
@@ -51,12 +59,19 @@ public:
                           std::function<void(void*)> task);
 #endif
 
+    // Submit any callable taking Context without std::function type erasure
+    template<typename F>
+    void post(F&& f);
+
     // Shutdown pool
     void shutdown(bool waitForTasks = true);
 
     // Check if running
     bool isRunning() const { return running_.load(); }
 
+    // Number of decode threads
+    size_t getThreadCount() const { return workers_.size(); }
+
     // Statistics
     Stats getStats() const;
 
@@ -73,28 +88,37 @@ private:
         size_t workerId = 0;
     };
 
+    // Intrusive task node: the callable is stored inline
     struct DecodeTask {
-        std::string cameraId;
-#ifdef HAVE_CUDA
-        std::function<void(CUcontext)> task;
-#else
-        std::function<void(void*)> task;
-#endif
+        virtual ~DecodeTask() = default;
+        virtual void run(Context context) = 0;
+    };
+
+    template<typename F>
+    struct CallableDecodeTask final : DecodeTask {
+        F fn;
+        explicit CallableDecodeTask(F&& f) : fn(std::move(f)) {}
+        explicit CallableDecodeTask(const F& f) : fn(f) {}
+        void run(Context context) override { fn(context); }
     };
 
     Config config_;
+    WorkQueue<DecodeTask> queue_;  // Per-worker deques when enableWorkStealing
     std::vector<std::unique_ptr<DecodeWorker>> workers_;
     std::atomic<bool> running_{true};
 
-    // Work queue (shared across all decode threads for work-stealing)
-    std::queue<DecodeTask> tasks_;
-    mutable std::mutex queueMutex_;
-    std::condition_variable condition_;
-
+    void enqueue(DecodeTask* task);
     void decodeWorkerLoop(size_t workerId);
     bool initializeCudaContext(DecodeWorker& worker);
     void cleanupCudaContext(DecodeWorker& worker);
 };
 
+// Template implementation
+template<typename F>
+void DecodeThreadPool::post(F&& f) {
+    using task_type = CallableDecodeTask<std::decay_t<F>>;
+    enqueue(new task_type(std::forward<F>(f)));
+}
+
 } // namespace threading
 } // namespace fluxvision
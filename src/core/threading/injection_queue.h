@@ -0,0 +1,121 @@
+// src/core/threading/injection_queue.h
+// Lock-free bounded MPMC (Multi-Producer, Multi-Consumer) queue
+// Used to inject tasks submitted from outside a pool's worker threads
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace fluxvision {
+namespace threading {
+
+// Bounded MPMC queue with per-cell sequence numbers (D. Vyukov's design)
+// One CAS per push/pop, no locks; producers and consumers only contend on
+// their own index.
+template<typename T>
+class InjectionQueue {
+public:
+    explicit InjectionQueue(size_t capacity = 1024)
+        : enqueuePos_(0)
+        , dequeuePos_(0)
+    {
+        // Capacity must be power of 2 for efficient modulo
+        capacity_ = 2;
+        while (capacity_ < capacity) {
+            capacity_ <<= 1;
+        }
+        mask_ = capacity_ - 1;
+
+        cells_.reset(new Cell[capacity_]);
+        for (size_t i = 0; i < capacity_; ++i) {
+            cells_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    // Delete copy/move
+    InjectionQueue(const InjectionQueue&) = delete;
+    InjectionQueue& operator=(const InjectionQueue&) = delete;
+
+    // Push item (any thread)
+    // Returns: true if pushed, false if full
+    bool push(T item) {
+        Cell* cell = nullptr;
+        size_t pos = enqueuePos_.load(std::memory_order_relaxed);
+
+        while (true) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Queue full
+            } else {
+                pos = enqueuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(item);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Pop item (any thread)
+    // Returns: true if popped, false if empty
+    bool pop(T& item) {
+        Cell* cell = nullptr;
+        size_t pos = dequeuePos_.load(std::memory_order_relaxed);
+
+        while (true) {
+            cell = &cells_[pos & mask_];
+            const size_t seq = cell->sequence.load(std::memory_order_acquire);
+            const intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeuePos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;  // Queue empty
+            } else {
+                pos = dequeuePos_.load(std::memory_order_relaxed);
+            }
+        }
+
+        item = std::move(cell->data);
+        cell->sequence.store(pos + mask_ + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Get capacity
+    size_t capacity() const { return capacity_; }
+
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    size_t capacity_;
+    size_t mask_;
+    std::unique_ptr<Cell[]> cells_;
+
+    // Cache-line padding to prevent false sharing (intentional alignment)
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4324)  // Structure padded due to alignment specifier
+#endif
+    alignas(64) std::atomic<size_t> enqueuePos_;  // Producer index
+    alignas(64) std::atomic<size_t> dequeuePos_;  // Consumer index
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+};
+
+} // namespace threading
+} // namespace fluxvision
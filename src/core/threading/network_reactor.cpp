@@ -0,0 +1,450 @@
+// src/core/threading/network_reactor.cpp
+#include "network_reactor.h"
+#include "cpu_topology.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <windows.h>
+#else
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <cerrno>
+#endif
+
+namespace fluxvision {
+namespace threading {
+
+namespace {
+    constexpr uint64_t kWakeToken = 0;
+
+#ifdef _WIN32
+    // Overlapped probe: a zero-byte WSARecv completes when the socket is readable
+    struct ReadProbe {
+        OVERLAPPED overlapped;
+        uint64_t token;
+    };
+#endif
+}
+
+NetworkReactor::NetworkReactor(const Config& config)
+    : config_(config)
+{
+}
+
+NetworkReactor::~NetworkReactor() {
+    stop();
+}
+
+bool NetworkReactor::start() {
+    if (running_.load()) {
+        return true;
+    }
+
+#ifdef _WIN32
+    iocp_ = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+    if (!iocp_) {
+        std::cerr << config_.name << ": CreateIoCompletionPort failed: " << GetLastError() << std::endl;
+        return false;
+    }
+#else
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ < 0) {
+        std::cerr << config_.name << ": epoll_create1 failed: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ < 0) {
+        std::cerr << config_.name << ": eventfd failed: " << std::strerror(errno) << std::endl;
+        close(epollFd_);
+        epollFd_ = -1;
+        return false;
+    }
+
+    epoll_event ev = {};
+    ev.events = EPOLLIN;
+    ev.data.u64 = kWakeToken;
+    epoll_ctl(epollFd_, EPOLL_CTL_ADD, wakeFd_, &ev);
+#endif
+
+    running_ = true;
+    thread_ = std::thread([this]() { eventLoop(); });
+    loopThreadId_ = thread_.get_id();
+
+    if (config_.numaNode >= 0) {
+        CpuTopology::pinThread(thread_, CpuTopology::instance().getNodeCpus(config_.numaNode));
+    }
+    return true;
+}
+
+void NetworkReactor::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    wakeup();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        for (auto& entry : sources_) {
+            disarmHandle(entry.second);
+        }
+        sources_.clear();
+        tokensById_.clear();
+    }
+
+#ifdef _WIN32
+    if (iocp_) {
+        CloseHandle(iocp_);
+        iocp_ = nullptr;
+    }
+#else
+    if (wakeFd_ >= 0) {
+        close(wakeFd_);
+        wakeFd_ = -1;
+    }
+    if (epollFd_ >= 0) {
+        close(epollFd_);
+        epollFd_ = -1;
+    }
+#endif
+}
+
+bool NetworkReactor::addSource(const std::string& id, SocketHandle handle, ServiceCallback callback) {
+    if (!callback) {
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+
+        if (!running_.load()) {
+            std::cerr << config_.name << ": cannot add source to stopped reactor" << std::endl;
+            return false;
+        }
+
+        if (tokensById_.count(id)) {
+            std::cerr << config_.name << ": source " << id << " already registered" << std::endl;
+            return false;
+        }
+
+        uint64_t token = nextToken_++;
+
+        Source source;
+        source.id = id;
+        source.handle = handle;
+        source.callback = std::move(callback);
+        source.token = token;
+        source.nextPoll = Clock::now();
+        if (handle != kInvalidSocket) {
+            source.nextPoll += std::chrono::milliseconds(config_.socketTimerMs);
+        }
+
+        auto inserted = sources_.emplace(token, std::move(source));
+        if (handle != kInvalidSocket && !armHandle(inserted.first->second)) {
+            sources_.erase(inserted.first);
+            return false;
+        }
+
+        tokensById_[id] = token;
+    }
+
+    // Recompute the wait timeout so the new source's timer is honoured
+    wakeup();
+    return true;
+}
+
+void NetworkReactor::removeSource(const std::string& id) {
+    std::unique_lock<std::mutex> lock(sourcesMutex_);
+
+    auto idIt = tokensById_.find(id);
+    if (idIt == tokensById_.end()) {
+        return;
+    }
+
+    uint64_t token = idIt->second;
+    tokensById_.erase(idIt);
+
+    auto it = sources_.find(token);
+    if (it == sources_.end()) {
+        return;
+    }
+
+    if (servicingToken_ == token) {
+        if (std::this_thread::get_id() == loopThreadId_) {
+            // Called from inside its own callback: erase once the callback returns
+            it->second.removed = true;
+            return;
+        }
+
+        serviceDone_.wait(lock, [this, token] { return servicingToken_ != token; });
+        it = sources_.find(token);
+        if (it == sources_.end()) {
+            return;
+        }
+    }
+
+    disarmHandle(it->second);
+    sources_.erase(it);
+}
+
+NetworkReactor::Stats NetworkReactor::getStats() const {
+    Stats stats;
+
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        stats.sourceCount = sources_.size();
+    }
+
+    stats.wakeups = wakeups_.load();
+    stats.readyEvents = readyEvents_.load();
+    stats.timerServices = timerServices_.load();
+    return stats;
+}
+
+void NetworkReactor::wakeup() {
+#ifdef _WIN32
+    if (iocp_) {
+        PostQueuedCompletionStatus(iocp_, 0, kWakeToken, nullptr);
+    }
+#else
+    if (wakeFd_ >= 0) {
+        uint64_t one = 1;
+        ssize_t written = write(wakeFd_, &one, sizeof(one));
+        (void)written;  // EAGAIN means a wakeup is already pending
+    }
+#endif
+}
+
+int NetworkReactor::computeWaitTimeoutMs() {
+    std::lock_guard<std::mutex> lock(sourcesMutex_);
+
+    if (sources_.empty()) {
+        return -1;  // Block until wakeup
+    }
+
+    Clock::time_point earliest = Clock::time_point::max();
+    for (const auto& entry : sources_) {
+        earliest = std::min(earliest, entry.second.nextPoll);
+    }
+
+    auto now = Clock::now();
+    if (earliest <= now) {
+        return 0;
+    }
+
+    auto waitMs = std::chrono::duration_cast<std::chrono::milliseconds>(earliest - now).count();
+    return static_cast<int>(std::max<int64_t>(1, waitMs));
+}
+
+void NetworkReactor::eventLoop() {
+#ifndef _WIN32
+    std::vector<epoll_event> events(static_cast<size_t>(std::max(1, config_.maxEventsPerWait)));
+#endif
+
+    while (running_.load()) {
+        int timeoutMs = computeWaitTimeoutMs();
+
+#ifdef _WIN32
+        DWORD bytes = 0;
+        ULONG_PTR key = 0;
+        OVERLAPPED* overlapped = nullptr;
+        BOOL ok = GetQueuedCompletionStatus(static_cast<HANDLE>(iocp_), &bytes, &key, &overlapped,
+                                            timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+        wakeups_++;
+
+        // Drain everything already queued before touching timers
+        while (ok || overlapped) {
+            if (overlapped) {
+                auto* probe = reinterpret_cast<ReadProbe*>(overlapped);
+                uint64_t token = probe->token;
+
+                bool owned = false;
+                {
+                    std::lock_guard<std::mutex> lock(sourcesMutex_);
+                    auto it = sources_.find(token);
+                    owned = (it != sources_.end() && it->second.overlapped == probe);
+                }
+
+                if (owned) {
+                    readyEvents_++;
+                    serviceToken(token, false);
+                } else {
+                    delete probe;  // Completion of a cancelled probe (source removed)
+                }
+            }
+
+            overlapped = nullptr;
+            ok = GetQueuedCompletionStatus(static_cast<HANDLE>(iocp_), &bytes, &key, &overlapped, 0);
+        }
+#else
+        int n = epoll_wait(epollFd_, events.data(), static_cast<int>(events.size()), timeoutMs);
+        wakeups_++;
+
+        if (n < 0 && errno != EINTR) {
+            std::cerr << config_.name << ": epoll_wait failed: " << std::strerror(errno) << std::endl;
+            break;
+        }
+
+        for (int i = 0; i < n; ++i) {
+            uint64_t token = events[i].data.u64;
+            if (token == kWakeToken) {
+                uint64_t value = 0;
+                ssize_t drained = read(wakeFd_, &value, sizeof(value));
+                (void)drained;
+                continue;
+            }
+
+            readyEvents_++;
+            serviceToken(token, false);
+        }
+#endif
+
+        serviceDueTimers();
+    }
+}
+
+void NetworkReactor::serviceDueTimers() {
+    std::vector<uint64_t> due;
+    auto now = Clock::now();
+
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        for (const auto& entry : sources_) {
+            if (entry.second.nextPoll <= now) {
+                due.push_back(entry.first);
+            }
+        }
+    }
+
+    for (uint64_t token : due) {
+        timerServices_++;
+        serviceToken(token, true);
+    }
+}
+
+void NetworkReactor::serviceToken(uint64_t token, bool fromTimer) {
+    Source* source = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        auto it = sources_.find(token);
+        if (it == sources_.end()) {
+            return;
+        }
+        if (!fromTimer && it->second.handle == kInvalidSocket) {
+            return;  // Stale event for a re-registered token
+        }
+        source = &it->second;  // Node stays valid: erase waits on servicingToken_
+        servicingToken_ = token;
+    }
+
+    ServiceResult result;
+    try {
+        result = source->callback();
+    } catch (const std::exception& e) {
+        std::cerr << config_.name << ": source " << source->id << " threw: " << e.what() << std::endl;
+        result = ServiceResult::CLOSED;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(sourcesMutex_);
+        servicingToken_ = 0;
+
+        if (result == ServiceResult::CLOSED || source->removed) {
+            tokensById_.erase(source->id);
+            disarmHandle(*source);
+            sources_.erase(token);
+        } else if (source->handle == kInvalidSocket) {
+            // Adaptive polling: stay hot while data flows, back off while idle
+            if (result == ServiceResult::PROGRESS) {
+                source->pollIntervalMs = 0;
+            } else if (source->pollIntervalMs == 0) {
+                source->pollIntervalMs = config_.minPollIntervalMs;
+            } else {
+                source->pollIntervalMs = std::min(source->pollIntervalMs * 2, config_.maxPollIntervalMs);
+            }
+            source->nextPoll = Clock::now() + std::chrono::milliseconds(source->pollIntervalMs);
+        } else {
+            // Any service restarts the quiet-spell timer of a socket source
+            source->nextPoll = Clock::now() + std::chrono::milliseconds(config_.socketTimerMs);
+#ifdef _WIN32
+            if (!fromTimer) {
+                armHandle(*source);  // Completion probes are one-shot, post the next one
+            }
+#endif
+        }
+    }
+
+    serviceDone_.notify_all();
+}
+
+bool NetworkReactor::armHandle(Source& source) {
+#ifdef _WIN32
+    SOCKET socket = static_cast<SOCKET>(source.handle);
+
+    if (!source.overlapped) {
+        // First arm: associate the socket with this port (once per socket lifetime)
+        if (!CreateIoCompletionPort(reinterpret_cast<HANDLE>(socket), static_cast<HANDLE>(iocp_), 0, 0)) {
+            std::cerr << config_.name << ": failed to associate socket for " << source.id
+                      << ": " << GetLastError() << std::endl;
+            return false;
+        }
+        auto* probe = new ReadProbe{};
+        probe->token = source.token;
+        source.overlapped = probe;
+    }
+
+    auto* probe = static_cast<ReadProbe*>(source.overlapped);
+    std::memset(&probe->overlapped, 0, sizeof(probe->overlapped));
+
+    WSABUF buffer = {0, nullptr};
+    DWORD flags = 0;
+    int ret = WSARecv(socket, &buffer, 1, nullptr, &flags, &probe->overlapped, nullptr);
+    if (ret == SOCKET_ERROR && WSAGetLastError() != WSA_IO_PENDING) {
+        std::cerr << config_.name << ": WSARecv probe failed for " << source.id
+                  << ": " << WSAGetLastError() << std::endl;
+        return false;
+    }
+    return true;
+#else
+    epoll_event ev = {};
+    ev.events = EPOLLIN;  // Level-triggered: sources may stop early for fairness
+    ev.data.u64 = source.token;
+
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, static_cast<int>(source.handle), &ev) < 0) {
+        std::cerr << config_.name << ": epoll_ctl ADD failed for " << source.id
+                  << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+    return true;
+#endif
+}
+
+void NetworkReactor::disarmHandle(Source& source) {
+    if (source.handle == kInvalidSocket) {
+        return;
+    }
+
+#ifdef _WIN32
+    if (source.overlapped) {
+        // The probe is freed when its cancellation completion is dequeued
+        CancelIoEx(reinterpret_cast<HANDLE>(static_cast<SOCKET>(source.handle)),
+                   &static_cast<ReadProbe*>(source.overlapped)->overlapped);
+        source.overlapped = nullptr;
+    }
+#else
+    epoll_ctl(epollFd_, EPOLL_CTL_DEL, static_cast<int>(source.handle), nullptr);
+#endif
+}
+
+} // namespace threading
+} // namespace fluxvision
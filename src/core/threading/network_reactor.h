@@ -0,0 +1,140 @@
+// src/core/threading/network_reactor.h
+// Event-driven I/O reactor: one thread multiplexes many camera sockets
+// Linux uses epoll, Windows uses an I/O completion port
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fluxvision {
+namespace threading {
+
+// Native socket handle (int fd on Linux, SOCKET on Windows)
+using SocketHandle = intptr_t;
+constexpr SocketHandle kInvalidSocket = -1;
+
+// Result of one service call, used to drive polling of handle-less sources
+enum class ServiceResult {
+    PROGRESS,     // Data was consumed, more may be pending
+    WOULD_BLOCK,  // Nothing available right now
+    CLOSED        // Source is finished, unregister it
+};
+
+// Single-threaded event loop serving many sources
+//
+// Sources with a native socket are registered with epoll/IOCP and run when the
+// socket is readable, plus once every Config::socketTimerMs of quiet so they can
+// act on their own deadlines (jitter gaps, keepalives, stall detection). Sources without an exposed socket (FFmpeg-owned RTSP
+// sessions) are polled on the reactor's timer with an adaptive interval:
+// immediately while data keeps arriving, backing off to
+// Config::maxPollIntervalMs while idle. That is not readiness: their service
+// blocks in the read until data or the read deadline, holding up every other
+// source of the reactor meanwhile. They stay on pinned threads by default
+// (NetworkThreadPool::Config::enableReactor).
+class NetworkReactor {
+public:
+    struct Config {
+        std::string name = "NetworkReactor";
+        int maxEventsPerWait = 256;       // Readiness events fetched per wait
+        int minPollIntervalMs = 1;        // First back-off step for idle handle-less sources
+        int maxPollIntervalMs = 10;       // Upper bound on idle back-off (~1/4 frame @ 25fps)
+        int socketTimerMs = 10;           // Longest quiet spell before a socket source is serviced anyway
+        int numaNode = -1;                // Keep the loop thread on this NUMA node (-1 = anywhere)
+    };
+
+    // Service callback: runs on the reactor thread, must not block
+    using ServiceCallback = std::function<ServiceResult()>;
+
+    struct Stats {
+        size_t sourceCount = 0;
+        uint64_t wakeups = 0;         // Wait calls that returned
+        uint64_t readyEvents = 0;     // Socket readiness events dispatched
+        uint64_t timerServices = 0;   // Timer services dispatched (polls and socket deadlines)
+    };
+
+    explicit NetworkReactor(const Config& config);
+    ~NetworkReactor();
+
+    // Delete copy/move
+    NetworkReactor(const NetworkReactor&) = delete;
+    NetworkReactor& operator=(const NetworkReactor&) = delete;
+
+    // Start/stop the event loop thread
+    bool start();
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    // Register a source (thread-safe)
+    // handle may be kInvalidSocket for sources serviced by timer polling
+    bool addSource(const std::string& id, SocketHandle handle, ServiceCallback callback);
+
+    // Unregister a source (thread-safe)
+    // Blocks until an in-flight service of this source has returned, unless called
+    // from the reactor thread itself. After return the callback is never invoked again.
+    void removeSource(const std::string& id);
+
+    // Statistics
+    Stats getStats() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct Source {
+        std::string id;
+        SocketHandle handle = kInvalidSocket;
+        ServiceCallback callback;
+        uint64_t token = 0;                  // Key used in epoll/IOCP registration
+        Clock::time_point nextPoll;          // Next timer service
+        int pollIntervalMs = 0;              // Handle-less sources only
+        bool removed = false;                // Removal requested during its own service
+#ifdef _WIN32
+        void* overlapped = nullptr;          // Zero-byte WSARecv readiness probe
+#endif
+    };
+
+    Config config_;
+    std::atomic<bool> running_{false};
+    std::thread thread_;
+    std::thread::id loopThreadId_;
+
+    // Source registry (guarded by sourcesMutex_)
+    mutable std::mutex sourcesMutex_;
+    std::condition_variable serviceDone_;
+    std::unordered_map<uint64_t, Source> sources_;        // token -> source
+    std::unordered_map<std::string, uint64_t> tokensById_;
+    uint64_t nextToken_ = 1;
+    uint64_t servicingToken_ = 0;                          // Token being serviced (0 = none)
+
+    // Statistics
+    std::atomic<uint64_t> wakeups_{0};
+    std::atomic<uint64_t> readyEvents_{0};
+    std::atomic<uint64_t> timerServices_{0};
+
+    // Platform poller
+#ifdef _WIN32
+    void* iocp_ = nullptr;
+#else
+    int epollFd_ = -1;
+    int wakeFd_ = -1;   // eventfd used to interrupt epoll_wait
+#endif
+
+    void eventLoop();
+    void wakeup();
+    int computeWaitTimeoutMs();
+    void serviceToken(uint64_t token, bool fromTimer);
+    void serviceDueTimers();
+
+    bool armHandle(Source& source);
+    void disarmHandle(Source& source);
+};
+
+} // namespace threading
+} // namespace fluxvision
@@ -6,11 +6,39 @@ namespace fluxvision {
 namespace threading {
 
 NetworkThreadPool::NetworkThreadPool(size_t numThreads)
-    : pool_(ThreadPool::Config{numThreads, "NetworkPool", false})
-    , numThreads_(numThreads)
+    : NetworkThreadPool(Config{numThreads})
 {
 }
 
+NetworkThreadPool::NetworkThreadPool(const Config& config)
+    : config_(config)
+    , pool_(ThreadPool::Config{config.enableReactor ? config.blockingThreads : config.numThreads,
+                               "NetworkPool", false, true, config.numaNode})
+    , numThreads_(config.numThreads)
+    , camerasPerThread_(config.numThreads, 0)
+{
+    if (!config_.enableReactor) {
+        return;
+    }
+
+    reactors_.reserve(numThreads_);
+    for (size_t i = 0; i < numThreads_; ++i) {
+        NetworkReactor::Config reactorConfig;
+        reactorConfig.name = "NetworkReactor-" + std::to_string(i);
+        reactorConfig.maxPollIntervalMs = config_.maxPollIntervalMs;
+        reactorConfig.numaNode = config_.numaNode;
+
+        auto reactor = std::make_unique<NetworkReactor>(reactorConfig);
+        if (!reactor->start()) {
+            std::cerr << "NetworkThreadPool: failed to start reactor " << i
+                      << ", falling back to pinned-thread mode" << std::endl;
+            reactors_.clear();
+            return;
+        }
+        reactors_.push_back(std::move(reactor));
+    }
+}
+
 NetworkThreadPool::~NetworkThreadPool() {
     shutdown(true);
 }
@@ -24,16 +52,60 @@ size_t NetworkThreadPool::assignCamera(const std::string& cameraId) {
         return it->second;  // Return existing assignment
     }
 
-    // Round-robin assignment
-    size_t threadId = nextThread_.fetch_add(1) % numThreads_;
+    if (camerasPerThread_.empty()) {
+        return 0;
+    }
+
+    // Least-loaded assignment keeps threads balanced under camera churn
+    size_t threadId = 0;
+    for (size_t i = 1; i < camerasPerThread_.size(); ++i) {
+        if (camerasPerThread_[i] < camerasPerThread_[threadId]) {
+            threadId = i;
+        }
+    }
+
     cameraAssignments_[cameraId] = threadId;
+    camerasPerThread_[threadId]++;
 
     return threadId;
 }
 
+bool NetworkThreadPool::registerCamera(const std::string& cameraId, SocketHandle handle,
+                                       NetworkReactor::ServiceCallback callback) {
+    if (reactors_.empty()) {
+        std::cerr << "NetworkThreadPool: registerCamera requires reactor mode" << std::endl;
+        return false;
+    }
+
+    size_t threadId = assignCamera(cameraId);
+    if (!reactors_[threadId]->addSource(cameraId, handle, std::move(callback))) {
+        unassignCamera(cameraId);
+        return false;
+    }
+
+    return true;
+}
+
 void NetworkThreadPool::unassignCamera(const std::string& cameraId) {
-    std::lock_guard<std::mutex> lock(assignmentMutex_);
-    cameraAssignments_.erase(cameraId);
+    size_t threadId = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(assignmentMutex_);
+
+        auto it = cameraAssignments_.find(cameraId);
+        if (it == cameraAssignments_.end()) {
+            return;
+        }
+
+        threadId = it->second;
+        camerasPerThread_[threadId]--;
+        cameraAssignments_.erase(it);
+    }
+
+    // Outside the lock: removal may wait for an in-flight service to finish
+    if (threadId < reactors_.size()) {
+        reactors_[threadId]->removeSource(cameraId);
+    }
 }
 
 size_t NetworkThreadPool::getCameraThread(const std::string& cameraId) const {
@@ -48,9 +120,23 @@ size_t NetworkThreadPool::getCameraThread(const std::string& cameraId) const {
 }
 
 void NetworkThreadPool::shutdown(bool waitForTasks) {
+    for (auto& reactor : reactors_) {
+        reactor->stop();
+    }
     pool_.shutdown(waitForTasks);
 }
 
+std::vector<NetworkReactor::Stats> NetworkThreadPool::getReactorStats() const {
+    std::vector<NetworkReactor::Stats> stats;
+    stats.reserve(reactors_.size());
+
+    for (const auto& reactor : reactors_) {
+        stats.push_back(reactor->getStats());
+    }
+
+    return stats;
+}
+
 std::unordered_map<size_t, size_t> NetworkThreadPool::getCamerasPerThread() const {
     std::lock_guard<std::mutex> lock(assignmentMutex_);
 
@@ -1,12 +1,17 @@
 // src/core/threading/network_thread_pool.h
 // Specialized thread pool for network receive operations
-// Assigns cameras to threads in round-robin fashion
+// Assigns cameras to threads (least-loaded first); in reactor mode each thread
+// runs a NetworkReactor that multiplexes all cameras assigned to it (opt-in:
+// FFmpeg RTSP sessions expose no socket, so the reactor can only poll them)
 #pragma once
 
 #include "thread_pool.h"
+#include "network_reactor.h"
 #include <unordered_map>
 #include <string>
 #include <atomic>
+#include <memory>
+#include <vector>
 
 namespace fluxvision {
 namespace threading {
@@ -14,30 +19,52 @@ namespace threading {
 // Specialized network thread pool with camera assignment
 class NetworkThreadPool {
 public:
+    struct Config {
+        size_t numThreads = 8;          // Network threads (reactors in reactor mode)
+        bool enableReactor = false;     // Many cameras per thread; RTSP sessions timer-polled (see NetworkReactor)
+        size_t blockingThreads = 2;     // Reactor mode: workers for blocking submit() tasks
+        int maxPollIntervalMs = 10;     // Reactor idle back-off for handle-less sources
+        int numaNode = -1;              // Keep every network thread on this NUMA node (-1 = anywhere)
+    };
+
     explicit NetworkThreadPool(size_t numThreads = 8);
+    explicit NetworkThreadPool(const Config& config);
     ~NetworkThreadPool();
 
     // Delete copy/move
     NetworkThreadPool(const NetworkThreadPool&) = delete;
     NetworkThreadPool& operator=(const NetworkThreadPool&) = delete;
 
-    // Assign camera to a specific thread (round-robin)
+    // Assign camera to a specific thread (least-loaded)
     // Returns the thread ID that will handle this camera
     size_t assignCamera(const std::string& cameraId);
 
+    // Reactor mode: assign camera and register its receive source with the owning reactor
+    // handle may be kInvalidSocket when the socket is not exposed (serviced by timer polling)
+    bool registerCamera(const std::string& cameraId, SocketHandle handle,
+                        NetworkReactor::ServiceCallback callback);
+
     // Unassign camera (for removal)
+    // In reactor mode this also unregisters the source and waits for an in-flight service
     void unassignCamera(const std::string& cameraId);
 
     // Get thread assignment for a camera
     size_t getCameraThread(const std::string& cameraId) const;
 
     // Submit task to pool (thread-safe)
+    // In reactor mode this runs on the small blocking-task pool, not on a reactor
     template<typename F, typename... Args>
     auto submit(F&& f, Args&&... args)
         -> std::future<std::invoke_result_t<F, Args...>> {
         return pool_.submit(std::forward<F>(f), std::forward<Args>(args)...);
     }
 
+    // Fire-and-forget submit (no future, no std::function)
+    template<typename F>
+    void post(F&& f) {
+        pool_.post(std::forward<F>(f));
+    }
+
     // Shutdown pool
     void shutdown(bool waitForTasks = true);
 
@@ -46,20 +73,26 @@ public:
 
     // Statistics
     ThreadPool::Stats getStats() const { return pool_.getStats(); }
+    std::vector<NetworkReactor::Stats> getReactorStats() const;
 
     // Get number of threads
     size_t getThreadCount() const { return numThreads_; }
 
+    // Check if cameras are served by reactors instead of pinned pool threads
+    bool isReactorMode() const { return !reactors_.empty(); }
+
     // Get cameras per thread
     std::unordered_map<size_t, size_t> getCamerasPerThread() const;
 
 private:
+    Config config_;
     ThreadPool pool_;
     size_t numThreads_;
+    std::vector<std::unique_ptr<NetworkReactor>> reactors_;
 
     mutable std::mutex assignmentMutex_;
     std::unordered_map<std::string, size_t> cameraAssignments_;  // cameraId -> threadId
-    std::atomic<size_t> nextThread_{0};  // Round-robin counter
+    std::vector<size_t> camerasPerThread_;
 };
 
 } // namespace threading
@@ -1,5 +1,6 @@
 // src/core/threading/thread_pool.cpp
 #include "thread_pool.h"
+#include "cpu_topology.h"
 #include <iostream>
 
 #ifdef _WIN32
@@ -14,19 +15,23 @@ namespace threading {
 
 ThreadPool::ThreadPool(const Config& config)
     : config_(config)
+    , queue_(config.numThreads, config.enableWorkStealing)
 {
     workers_.reserve(config_.numThreads);
 
+    // Create all workers before starting threads (workerLoop indexes workers_)
     for (size_t i = 0; i < config_.numThreads; ++i) {
         auto worker = std::make_unique<Worker>();
         worker->workerId = i;
-        worker->thread = std::thread([this, i]() { workerLoop(i); });
+        workers_.push_back(std::move(worker));
+    }
+
+    for (size_t i = 0; i < config_.numThreads; ++i) {
+        workers_[i]->thread = std::thread([this, i]() { workerLoop(i); });
 
-        if (config_.enableAffinity) {
+        if (config_.enableAffinity || config_.numaNode >= 0) {
             setCpuAffinity(i);
         }
-
-        workers_.push_back(std::move(worker));
     }
 }
 
@@ -35,18 +40,8 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::shutdown(bool waitForTasks) {
-    {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-        running_ = false;
-
-        if (!waitForTasks) {
-            // Clear pending tasks
-            std::queue<std::function<void()>> empty;
-            std::swap(tasks_, empty);
-        }
-    }
-
-    condition_.notify_all();
+    running_ = false;
+    queue_.close(!waitForTasks);
 
     // Join all threads
     for (auto& worker : workers_) {
@@ -54,40 +49,54 @@ void ThreadPool::shutdown(bool waitForTasks) {
             worker->thread.join();
         }
     }
-}
 
-void ThreadPool::workerLoop(size_t workerId) {
-    Worker& worker = *workers_[workerId];
+    // Discard tasks left behind (only when not waiting for tasks)
+    while (Task* task = queue_.tryPopAny()) {
+        delete task;
+    }
+}
 
-    while (true) {
-        std::function<void()> task;
+void ThreadPool::enqueue(Task* task) {
+    if (!queue_.push(task)) {
+        delete task;
+        throw std::runtime_error("ThreadPool: Cannot submit task to stopped pool");
+    }
 
-        {
-            std::unique_lock<std::mutex> lock(queueMutex_);
+    tasksSubmitted_++;
+}
 
-            condition_.wait(lock, [this] {
-                return !running_ || !tasks_.empty();
-            });
+void ThreadPool::workerLoop(size_t workerId) {
+    Worker& worker = *workers_[workerId];
 
-            if (!running_ && tasks_.empty()) {
-                break;
-            }
+    // Tasks submitted from this worker go to its own deque
+    queue_.bindCurrentThread(workerId);
 
-            if (!tasks_.empty()) {
-                task = std::move(tasks_.front());
-                tasks_.pop();
-            }
+    while (Task* task = queue_.pop(workerId)) {
+        try {
+            task->run();
         }
-
-        if (task) {
-            task();
-            worker.tasksProcessed++;
-            tasksCompleted_++;
+        catch (const std::exception& e) {
+            std::cerr << config_.name << ": task threw exception: " << e.what() << std::endl;
+        }
+        catch (...) {
+            std::cerr << config_.name << ": task threw unknown exception" << std::endl;
         }
+
+        delete task;
+        worker.tasksProcessed++;
+        tasksCompleted_++;
     }
 }
 
 void ThreadPool::setCpuAffinity(size_t threadId) {
+    // On a node: one of its CPUs per worker with affinity, else the whole node
+    if (config_.numaNode >= 0) {
+        const int slot = config_.enableAffinity ? static_cast<int>(threadId) : -1;
+        CpuTopology::pinThread(workers_[threadId]->thread,
+                               CpuTopology::instance().cpusForSlot(config_.numaNode, slot));
+        return;
+    }
+
 #ifdef _WIN32
     // Windows: Set thread affinity
     DWORD_PTR mask = static_cast<DWORD_PTR>(1) << (threadId % std::thread::hardware_concurrency());
@@ -108,10 +117,7 @@ ThreadPool::Stats ThreadPool::getStats() const {
     stats.tasksSubmitted = tasksSubmitted_.load();
     stats.tasksCompleted = tasksCompleted_.load();
 
-    {
-        std::lock_guard<std::mutex> queueLock(queueMutex_);
-        stats.tasksInQueue = tasks_.size();
-    }
+    stats.tasksInQueue = queue_.size();
 
     // Per-thread stats
     stats.perThreadTaskCount.reserve(workers_.size());
@@ -2,26 +2,29 @@
 // Generic thread pool with work queue for task-based parallelism
 #pragma once
 
+#include "work_queue.h"
 #include <vector>
-#include <queue>
 #include <thread>
-#include <mutex>
-#include <condition_variable>
 #include <functional>
 #include <future>
 #include <atomic>
+#include <memory>
 #include <string>
+#include <stdexcept>
+#include <type_traits>
 
 namespace fluxvision {
 namespace threading {
 
-// Generic thread pool with task queue
+// Generic thread pool with work-stealing task queues
 class ThreadPool {
 public:
     struct Config {
         size_t numThreads = 4;
         std::string name = "ThreadPool";
         bool enableAffinity = false;  // CPU affinity (optional optimization)
+        bool enableWorkStealing = true;  // Per-worker deques + stealing (else shared FIFO)
+        int numaNode = -1;               // Keep workers on this NUMA node (-1 = anywhere)
     };
 
     struct Stats {
@@ -43,6 +46,12 @@ public:
     auto submit(F&& f, Args&&... args)
         -> std::future<std::invoke_result_t<F, Args...>>;
 
+    // Fire-and-forget submit (thread-safe)
+    // One allocation holding the callable itself: no std::function, no
+    // packaged_task, no future. Exceptions are logged and swallowed.
+    template<typename F>
+    void post(F&& f);
+
     // Shutdown pool
     void shutdown(bool waitForTasks = true);
 
@@ -53,6 +62,20 @@ public:
     Stats getStats() const;
 
 private:
+    // Intrusive task node: the callable is stored inline
+    struct Task {
+        virtual ~Task() = default;
+        virtual void run() = 0;
+    };
+
+    template<typename F>
+    struct CallableTask final : Task {
+        F fn;
+        explicit CallableTask(F&& f) : fn(std::move(f)) {}
+        explicit CallableTask(const F& f) : fn(f) {}
+        void run() override { fn(); }
+    };
+
     struct Worker {
         std::thread thread;
         std::atomic<size_t> tasksProcessed{0};
@@ -60,17 +83,15 @@ private:
     };
 
     Config config_;
+    WorkQueue<Task> queue_;
     std::vector<std::unique_ptr<Worker>> workers_;
-    std::queue<std::function<void()>> tasks_;
-
-    mutable std::mutex queueMutex_;
-    std::condition_variable condition_;
     std::atomic<bool> running_{true};
 
     // Statistics (atomic for thread-safe updates)
     std::atomic<size_t> tasksSubmitted_{0};
     std::atomic<size_t> tasksCompleted_{0};
 
+    void enqueue(Task* task);
     void workerLoop(size_t workerId);
     void setCpuAffinity(size_t threadId);
 };
@@ -82,26 +103,21 @@ auto ThreadPool::submit(F&& f, Args&&... args)
 {
     using return_type = std::invoke_result_t<F, Args...>;
 
-    auto task = std::make_shared<std::packaged_task<return_type()>>(
+    // packaged_task lives inside the task node (no shared_ptr control block)
+    std::packaged_task<return_type()> task(
         std::bind(std::forward<F>(f), std::forward<Args>(args)...)
     );
 
-    std::future<return_type> result = task->get_future();
-
-    {
-        std::lock_guard<std::mutex> lock(queueMutex_);
-
-        if (!running_) {
-            throw std::runtime_error("ThreadPool: Cannot submit task to stopped pool");
-        }
-
-        tasks_.emplace([task]() { (*task)(); });
-        tasksSubmitted_++;
-    }
-
-    condition_.notify_one();
+    std::future<return_type> result = task.get_future();
+    post(std::move(task));
     return result;
 }
 
+template<typename F>
+void ThreadPool::post(F&& f) {
+    using task_type = CallableTask<std::decay_t<F>>;
+    enqueue(new task_type(std::forward<F>(f)));
+}
+
 } // namespace threading
 } // namespace fluxvision
@@ -0,0 +1,223 @@
+// src/core/threading/work_queue.h
+// Task scheduling core shared by ThreadPool and DecodeThreadPool
+// Per-worker Chase-Lev deques + lock-free injection queue + idle parking
+#pragma once
+
+#include "work_stealing_deque.h"
+#include "injection_queue.h"
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace fluxvision {
+namespace threading {
+
+// Work queue of Task* for a fixed set of workers
+//
+// - Tasks pushed from one of the pool's own workers go to that worker's deque
+//   (no shared state touched); tasks pushed from outside go to the injection queue.
+// - Workers pop their own deque first, then the injection queue, then steal
+//   from the other workers' deques.
+// - Workers only take the park mutex when there is nothing to run, and
+//   producers only touch it when a worker is parked.
+// With stealing disabled every task goes through the injection queue (plain
+// shared FIFO, still lock-free).
+// The queue never owns tasks: whoever pops a task is responsible for it.
+template<typename Task>
+class WorkQueue {
+public:
+    WorkQueue(size_t numWorkers, bool enableStealing, size_t injectionCapacity = 1024)
+        : enableStealing_(enableStealing)
+        , injection_(injectionCapacity)
+    {
+        deques_.reserve(numWorkers);
+        for (size_t i = 0; i < numWorkers; ++i) {
+            deques_.push_back(std::make_unique<WorkStealingDeque<Task*>>());
+        }
+    }
+
+    // Delete copy/move
+    WorkQueue(const WorkQueue&) = delete;
+    WorkQueue& operator=(const WorkQueue&) = delete;
+
+    // Mark the calling thread as worker workerId (call once at worker start)
+    void bindCurrentThread(size_t workerId) {
+        currentQueue_ = this;
+        currentWorker_ = workerId;
+    }
+
+    // Enqueue task (thread-safe)
+    // Returns: false if the queue is closed (task not taken)
+    bool push(Task* task) {
+        activePushers_++;
+
+        if (closed_.load()) {
+            activePushers_--;
+            return false;
+        }
+
+        // Count before publishing so consumers never see the counter underflow
+        queued_++;
+
+        if (enableStealing_ && currentQueue_ == this) {
+            deques_[currentWorker_]->push(task);
+        } else if (!injection_.push(task)) {
+            // Injection queue full: rare burst, spill to a locked overflow list
+            std::lock_guard<std::mutex> lock(overflowMutex_);
+            overflow_.push_back(task);
+            overflowSize_++;
+        }
+
+        activePushers_--;
+
+        if (idleWorkers_.load() > 0) {
+            { std::lock_guard<std::mutex> lock(parkMutex_); }
+            parkCv_.notify_one();
+        }
+
+        return true;
+    }
+
+    // Dequeue task for worker workerId, blocking while empty
+    // Returns: nullptr once closed and drained (or closed with discard)
+    Task* pop(size_t workerId) {
+        while (true) {
+            if (discard_.load()) {
+                return nullptr;
+            }
+
+            if (Task* task = tryPop(workerId)) {
+                return task;
+            }
+
+            if (closed_.load()) {
+                // Exit only once no producer is mid-push and nothing is left
+                if (activePushers_.load() == 0 && queued_.load() == 0) {
+                    return nullptr;
+                }
+                std::this_thread::yield();
+                continue;
+            }
+
+            std::unique_lock<std::mutex> lock(parkMutex_);
+            idleWorkers_++;
+            parkCv_.wait(lock, [this] {
+                return queued_.load() > 0 || closed_.load();
+            });
+            idleWorkers_--;
+        }
+    }
+
+    // Non-blocking dequeue from any source (used to drain after workers exit)
+    Task* tryPopAny() {
+        Task* task = nullptr;
+
+        if (takeShared(task)) {
+            return task;
+        }
+
+        for (auto& deque : deques_) {
+            if (deque->steal(task)) {
+                queued_--;
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    // Stop accepting tasks and wake all workers
+    // discardPending: workers return immediately instead of draining
+    void close(bool discardPending) {
+        {
+            std::lock_guard<std::mutex> lock(parkMutex_);
+            closed_ = true;
+            discard_ = discardPending;
+        }
+        parkCv_.notify_all();
+    }
+
+    bool isClosed() const { return closed_.load(); }
+
+    // Tasks queued and not yet taken (approximate)
+    size_t size() const { return queued_.load(); }
+
+private:
+    bool enableStealing_;
+    std::vector<std::unique_ptr<WorkStealingDeque<Task*>>> deques_;
+    InjectionQueue<Task*> injection_;
+
+    // Overflow for a full injection queue
+    std::mutex overflowMutex_;
+    std::deque<Task*> overflow_;
+    std::atomic<size_t> overflowSize_{0};
+
+    // Parking (only used when a worker runs dry)
+    std::mutex parkMutex_;
+    std::condition_variable parkCv_;
+    std::atomic<size_t> idleWorkers_{0};
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> activePushers_{0};
+    std::atomic<bool> closed_{false};
+    std::atomic<bool> discard_{false};
+
+    // Worker identity of the calling thread
+    inline static thread_local const WorkQueue* currentQueue_ = nullptr;
+    inline static thread_local size_t currentWorker_ = 0;
+
+    Task* tryPop(size_t workerId) {
+        Task* task = nullptr;
+
+        if (workerId < deques_.size() && deques_[workerId]->pop(task)) {
+            queued_--;
+            return task;
+        }
+
+        if (takeShared(task)) {
+            return task;
+        }
+
+        if (!enableStealing_) {
+            return nullptr;
+        }
+
+        // Steal from the other workers, starting after ourselves
+        const size_t n = deques_.size();
+        for (size_t i = 1; i < n; ++i) {
+            auto& victim = deques_[(workerId + i) % n];
+            if (victim->steal(task)) {
+                queued_--;
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool takeShared(Task*& task) {
+        if (injection_.pop(task)) {
+            queued_--;
+            return true;
+        }
+
+        if (overflowSize_.load() > 0) {
+            std::lock_guard<std::mutex> lock(overflowMutex_);
+            if (!overflow_.empty()) {
+                task = overflow_.front();
+                overflow_.pop_front();
+                overflowSize_--;
+                queued_--;
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+} // namespace threading
+} // namespace fluxvision
@@ -0,0 +1,176 @@
+// src/core/threading/work_stealing_deque.h
+// Lock-free Chase-Lev work-stealing deque
+// Owner pushes/pops at the bottom (LIFO), thieves steal from the top (FIFO)
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+namespace fluxvision {
+namespace threading {
+
+// Chase-Lev deque (Le, Pop, Cohen, Zappa Nardelli: "Correct and Efficient
+// Work-Stealing for Weak Memory Models", PPoPP 2013)
+// push()/pop() must only be called by the owning thread, steal() by any thread.
+// T must be trivially copyable (typically a task pointer).
+template<typename T>
+class WorkStealingDeque {
+    static_assert(std::is_trivially_copyable<T>::value,
+                  "WorkStealingDeque elements must be trivially copyable");
+
+public:
+    explicit WorkStealingDeque(size_t initialCapacity = 256)
+        : top_(0)
+        , bottom_(0)
+    {
+        // Capacity must be power of 2 for efficient modulo
+        size_t capacity = 1;
+        while (capacity < initialCapacity) {
+            capacity <<= 1;
+        }
+
+        arrays_.push_back(std::make_unique<Array>(capacity));
+        array_.store(arrays_.back().get(), std::memory_order_relaxed);
+    }
+
+    // Delete copy/move
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    // Push item at the bottom (owner only), grows when full
+    void push(T item) {
+        const int64_t b = bottom_.load(std::memory_order_relaxed);
+        const int64_t t = top_.load(std::memory_order_acquire);
+        Array* array = array_.load(std::memory_order_relaxed);
+
+        if (b - t > static_cast<int64_t>(array->capacity) - 1) {
+            array = grow(array, t, b);
+        }
+
+        array->put(b, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Pop item from the bottom (owner only)
+    // Returns: true if popped, false if empty or the last item was stolen
+    bool pop(T& item) {
+        const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        Array* array = array_.load(std::memory_order_relaxed);
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b) {
+            // Empty
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = array->get(b);
+
+        if (t == b) {
+            // Last item: race against thieves
+            bool won = top_.compare_exchange_strong(t, t + 1,
+                                                    std::memory_order_seq_cst,
+                                                    std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    // Steal item from the top (any thread)
+    // Returns: true if stolen, false if empty or lost a race (caller may retry)
+    bool steal(T& item) {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) {
+            return false;  // Empty
+        }
+
+        Array* array = array_.load(std::memory_order_acquire);
+        T candidate = array->get(t);
+
+        if (!top_.compare_exchange_strong(t, t + 1,
+                                          std::memory_order_seq_cst,
+                                          std::memory_order_relaxed)) {
+            return false;  // Another thief or the owner took it
+        }
+
+        item = candidate;
+        return true;
+    }
+
+    // Check if empty (approximate, lock-free)
+    bool empty() const {
+        const int64_t t = top_.load(std::memory_order_acquire);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        return t >= b;
+    }
+
+    // Get current size (approximate)
+    size_t size() const {
+        const int64_t t = top_.load(std::memory_order_acquire);
+        const int64_t b = bottom_.load(std::memory_order_acquire);
+        return b > t ? static_cast<size_t>(b - t) : 0;
+    }
+
+private:
+    struct Array {
+        size_t capacity;
+        size_t mask;
+        std::unique_ptr<std::atomic<T>[]> slots;
+
+        explicit Array(size_t cap)
+            : capacity(cap)
+            , mask(cap - 1)
+            , slots(new std::atomic<T>[cap])
+        {}
+
+        T get(int64_t index) const {
+            return slots[static_cast<size_t>(index) & mask].load(std::memory_order_relaxed);
+        }
+
+        void put(int64_t index, T value) {
+            slots[static_cast<size_t>(index) & mask].store(value, std::memory_order_relaxed);
+        }
+    };
+
+    // Double capacity (owner only). Old arrays stay alive until destruction since
+    // a concurrent thief may still be reading from them.
+    Array* grow(Array* old, int64_t t, int64_t b) {
+        auto bigger = std::make_unique<Array>(old->capacity * 2);
+        for (int64_t i = t; i < b; ++i) {
+            bigger->put(i, old->get(i));
+        }
+
+        Array* raw = bigger.get();
+        arrays_.push_back(std::move(bigger));
+        array_.store(raw, std::memory_order_release);
+        return raw;
+    }
+
+    // Cache-line padding to prevent false sharing (intentional alignment)
+#ifdef _MSC_VER
+#pragma warning(push)
+#pragma warning(disable: 4324)  // Structure padded due to alignment specifier
+#endif
+    alignas(64) std::atomic<int64_t> top_;     // Thieves
+    alignas(64) std::atomic<int64_t> bottom_;  // Owner
+#ifdef _MSC_VER
+#pragma warning(pop)
+#endif
+    std::atomic<Array*> array_{nullptr};
+    std::vector<std::unique_ptr<Array>> arrays_;  // Current + retired arrays (owner only)
+};
+
+} // namespace threading
+} // namespace fluxvision
@@ -0,0 +1,520 @@
+// src/recording/keyframe_index.cpp
+#include "keyframe_index.h"
+#include <sqlite3.h>
+#include <filesystem>
+#include <iostream>
+#include <iterator>
+
+namespace fluxvision {
+namespace recording {
+
+namespace {
+    // Flushes a failed batch is retried on (busy database, full disk) before it is dropped
+    constexpr int kMaxCommitAttempts = 5;
+
+    const char* kSchema =
+        "CREATE TABLE IF NOT EXISTS cameras ("
+        "  id INTEGER PRIMARY KEY,"
+        "  name TEXT NOT NULL UNIQUE);"
+        "CREATE TABLE IF NOT EXISTS segments ("
+        "  id INTEGER PRIMARY KEY,"
+        "  camera_id INTEGER NOT NULL,"
+        "  path TEXT NOT NULL UNIQUE,"
+        "  start_us INTEGER NOT NULL,"
+        "  end_us INTEGER,"
+        "  bytes INTEGER NOT NULL DEFAULT 0,"
+        "  complete INTEGER NOT NULL DEFAULT 0);"
+        "CREATE INDEX IF NOT EXISTS segments_by_time ON segments (camera_id, start_us);"
+        "CREATE TABLE IF NOT EXISTS keyframes ("
+        "  camera_id INTEGER NOT NULL,"
+        "  time_us INTEGER NOT NULL,"
+        "  segment_id INTEGER NOT NULL,"
+        "  byte_offset INTEGER NOT NULL,"
+        "  pts_us INTEGER NOT NULL,"
+        "  PRIMARY KEY (camera_id, time_us)) WITHOUT ROWID;";
+
+    // Resets the statement when it goes out of scope (keeps it reusable)
+    class StatementScope {
+    public:
+        explicit StatementScope(sqlite3_stmt* statement) : statement_(statement) {}
+        ~StatementScope() {
+            sqlite3_reset(statement_);
+            sqlite3_clear_bindings(statement_);
+        }
+
+        StatementScope(const StatementScope&) = delete;
+        StatementScope& operator=(const StatementScope&) = delete;
+
+    private:
+        sqlite3_stmt* statement_;
+    };
+
+    std::string columnText(sqlite3_stmt* statement, int column) {
+        const unsigned char* text = sqlite3_column_text(statement, column);
+        return text ? reinterpret_cast<const char*>(text) : std::string();
+    }
+}
+
+KeyframeIndex::KeyframeIndex(const Config& config)
+    : config_(config)
+{
+}
+
+KeyframeIndex::~KeyframeIndex() {
+    close();
+}
+
+bool KeyframeIndex::open() {
+    if (open_.load()) {
+        return true;
+    }
+
+    const std::filesystem::path parent = std::filesystem::path(config_.databasePath).parent_path();
+    if (!parent.empty()) {
+        std::error_code ec;
+        std::filesystem::create_directories(parent, ec);
+    }
+
+    std::lock_guard<std::mutex> lock(dbMutex_);
+
+    // Access is serialized by dbMutex_, so SQLite's own mutexes are not needed
+    const int flags = SQLITE_OPEN_READWRITE | SQLITE_OPEN_CREATE | SQLITE_OPEN_NOMUTEX;
+    if (sqlite3_open_v2(config_.databasePath.c_str(), &db_, flags, nullptr) != SQLITE_OK) {
+        std::cerr << "KeyframeIndex: cannot open " << config_.databasePath << ": "
+                  << (db_ ? sqlite3_errmsg(db_) : "out of memory") << std::endl;
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return false;
+    }
+
+    sqlite3_busy_timeout(db_, config_.busyTimeoutMs);
+
+    // WAL: readers don't block the writer; NORMAL sync: fsync per checkpoint, not per commit
+    if (!exec("PRAGMA journal_mode=WAL;") || !exec("PRAGMA synchronous=NORMAL;") ||
+        !createSchema() || !prepareStatements()) {
+        finalizeStatements();
+        sqlite3_close(db_);
+        db_ = nullptr;
+        return false;
+    }
+
+    {
+        std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+        stopRequested_ = false;
+    }
+
+    open_ = true;
+    thread_ = std::thread([this]() { commitLoop(); });
+    return true;
+}
+
+void KeyframeIndex::close() {
+    if (!open_.load()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(pendingMutex_);
+        stopRequested_ = true;
+    }
+    commitCv_.notify_one();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    // Last batch (the loop commits once more before exiting, this catches stragglers)
+    flush();
+
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    open_ = false;
+    finalizeStatements();
+    sqlite3_close(db_);
+    db_ = nullptr;
+    cameraIds_.clear();
+    segmentIds_.clear();
+}
+
+void KeyframeIndex::addKeyframe(const Recorder::KeyframeInfo& keyframe) {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    pendingKeyframes_.push_back(keyframe);
+}
+
+void KeyframeIndex::addSegment(const Recorder::SegmentInfo& segment) {
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    pendingSegments_.push_back(segment);
+}
+
+bool KeyframeIndex::flush() {
+    // dbMutex_ first: batches are committed in the order they were taken
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    if (!db_) {
+        return false;
+    }
+
+    std::vector<Recorder::KeyframeInfo> keyframes;
+    std::vector<Recorder::SegmentInfo> segments;
+    {
+        std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+        keyframes.swap(pendingKeyframes_);
+        segments.swap(pendingSegments_);
+    }
+
+    if (keyframes.empty() && segments.empty()) {
+        return true;
+    }
+
+    if (commit(keyframes, segments)) {
+        failedCommits_ = 0;
+        return true;
+    }
+
+    if (++failedCommits_ >= kMaxCommitAttempts) {
+        std::cerr << "KeyframeIndex: giving up after " << failedCommits_ << " attempts, "
+                  << keyframes.size() << " keyframes lost" << std::endl;
+        failedCommits_ = 0;
+        return false;
+    }
+
+    // Kept ahead of what was queued meanwhile, for the next flush
+    std::lock_guard<std::mutex> pendingLock(pendingMutex_);
+    keyframes.insert(keyframes.end(), std::make_move_iterator(pendingKeyframes_.begin()),
+                     std::make_move_iterator(pendingKeyframes_.end()));
+    segments.insert(segments.end(), std::make_move_iterator(pendingSegments_.begin()),
+                    std::make_move_iterator(pendingSegments_.end()));
+    pendingKeyframes_.swap(keyframes);
+    pendingSegments_.swap(segments);
+    return false;
+}
+
+bool KeyframeIndex::seek(const std::string& cameraId, int64_t timeUs, KeyframeLocation& location) {
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    if (!db_) {
+        return false;
+    }
+
+    const int64_t camera = lookupCamera(cameraId, false);
+    if (camera < 0) {
+        return false;
+    }
+
+    StatementScope scope(seekKeyframe_);
+    sqlite3_bind_int64(seekKeyframe_, 1, camera);
+    sqlite3_bind_int64(seekKeyframe_, 2, timeUs);
+
+    if (sqlite3_step(seekKeyframe_) != SQLITE_ROW) {
+        return false;
+    }
+
+    location.segmentPath = columnText(seekKeyframe_, 0);
+    location.offset = static_cast<uint64_t>(sqlite3_column_int64(seekKeyframe_, 1));
+    location.timeUs = sqlite3_column_int64(seekKeyframe_, 2);
+    location.ptsUs = sqlite3_column_int64(seekKeyframe_, 3);
+    return true;
+}
+
+std::vector<SegmentRecord> KeyframeIndex::findSegments(const std::string& cameraId,
+                                                       int64_t fromUs, int64_t toUs) {
+    std::vector<SegmentRecord> segments;
+
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    if (!db_) {
+        return segments;
+    }
+
+    const int64_t camera = lookupCamera(cameraId, false);
+    if (camera < 0) {
+        return segments;
+    }
+
+    StatementScope scope(selectSegments_);
+    sqlite3_bind_int64(selectSegments_, 1, camera);
+    sqlite3_bind_int64(selectSegments_, 2, toUs);
+    sqlite3_bind_int64(selectSegments_, 3, fromUs);
+
+    while (sqlite3_step(selectSegments_) == SQLITE_ROW) {
+        SegmentRecord record;
+        record.path = columnText(selectSegments_, 0);
+        record.startTimeUs = sqlite3_column_int64(selectSegments_, 1);
+        record.endTimeUs = sqlite3_column_int64(selectSegments_, 2);  // NULL reads as 0
+        record.bytes = static_cast<uint64_t>(sqlite3_column_int64(selectSegments_, 3));
+        record.complete = sqlite3_column_int(selectSegments_, 4) != 0;
+        segments.push_back(std::move(record));
+    }
+
+    return segments;
+}
+
+std::vector<std::string> KeyframeIndex::removeBefore(int64_t timeUs) {
+    std::vector<std::string> paths;
+
+    std::lock_guard<std::mutex> lock(dbMutex_);
+    if (!db_) {
+        return paths;
+    }
+
+    sqlite3_stmt* select = nullptr;
+    sqlite3_stmt* deleteKeyframes = nullptr;
+    sqlite3_stmt* deleteSegment = nullptr;
+
+    const bool prepared =
+        sqlite3_prepare_v2(db_, "SELECT id, camera_id, start_us, end_us, path FROM segments "
+                                "WHERE end_us IS NOT NULL AND end_us < ?", -1, &select, nullptr) == SQLITE_OK &&
+        sqlite3_prepare_v2(db_, "DELETE FROM keyframes WHERE camera_id = ? AND time_us BETWEEN ? AND ?",
+                           -1, &deleteKeyframes, nullptr) == SQLITE_OK &&
+        sqlite3_prepare_v2(db_, "DELETE FROM segments WHERE id = ?", -1, &deleteSegment, nullptr) == SQLITE_OK;
+
+    if (prepared && exec("BEGIN IMMEDIATE;")) {
+        bool ok = true;
+        sqlite3_bind_int64(select, 1, timeUs);
+
+        while (ok && sqlite3_step(select) == SQLITE_ROW) {
+            const int64_t segment = sqlite3_column_int64(select, 0);
+
+            // A segment's keyframes lie within its [start, end] on the (camera, time) key
+            sqlite3_bind_int64(deleteKeyframes, 1, sqlite3_column_int64(select, 1));
+            sqlite3_bind_int64(deleteKeyframes, 2, sqlite3_column_int64(select, 2));
+            sqlite3_bind_int64(deleteKeyframes, 3, sqlite3_column_int64(select, 3));
+            ok = sqlite3_step(deleteKeyframes) == SQLITE_DONE;
+            sqlite3_reset(deleteKeyframes);
+
+            sqlite3_bind_int64(deleteSegment, 1, segment);
+            ok = ok && sqlite3_step(deleteSegment) == SQLITE_DONE;
+            sqlite3_reset(deleteSegment);
+
+            if (ok) {
+                paths.push_back(columnText(select, 4));
+            }
+        }
+
+        if (ok) {
+            exec("COMMIT;");
+        } else {
+            std::cerr << "KeyframeIndex: retention cleanup failed: " << sqlite3_errmsg(db_) << std::endl;
+            exec("ROLLBACK;");
+            errors_++;
+            paths.clear();
+        }
+    }
+
+    sqlite3_finalize(select);
+    sqlite3_finalize(deleteKeyframes);
+    sqlite3_finalize(deleteSegment);
+    return paths;
+}
+
+KeyframeIndex::Stats KeyframeIndex::getStats() const {
+    Stats stats;
+    stats.keyframesIndexed = keyframesIndexed_.load();
+    stats.segmentsIndexed = segmentsIndexed_.load();
+    stats.transactions = transactions_.load();
+    stats.errors = errors_.load();
+
+    std::lock_guard<std::mutex> lock(pendingMutex_);
+    stats.pending = pendingKeyframes_.size() + pendingSegments_.size();
+    return stats;
+}
+
+void KeyframeIndex::commitLoop() {
+    while (true) {
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(pendingMutex_);
+            commitCv_.wait_for(lock, config_.commitInterval, [this]() { return stopRequested_; });
+            stopping = stopRequested_;
+        }
+
+        flush();
+
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+bool KeyframeIndex::createSchema() {
+    return exec(kSchema);
+}
+
+bool KeyframeIndex::prepareStatements() {
+    struct Statement {
+        sqlite3_stmt** statement;
+        const char* sql;
+    };
+
+    const Statement statements[] = {
+        {&insertCamera_, "INSERT OR IGNORE INTO cameras (name) VALUES (?)"},
+        {&selectCamera_, "SELECT id FROM cameras WHERE name = ?"},
+        {&insertSegment_, "INSERT OR IGNORE INTO segments (camera_id, path, start_us) VALUES (?, ?, ?)"},
+        {&selectSegment_, "SELECT id FROM segments WHERE path = ?"},
+        {&finishSegment_, "UPDATE segments SET end_us = ?, bytes = ?, complete = ? WHERE id = ?"},
+        {&insertKeyframe_, "INSERT OR REPLACE INTO keyframes (camera_id, time_us, segment_id, byte_offset, pts_us) "
+                           "VALUES (?, ?, ?, ?, ?)"},
+        {&seekKeyframe_, "SELECT s.path, k.byte_offset, k.time_us, k.pts_us FROM keyframes k "
+                         "JOIN segments s ON s.id = k.segment_id "
+                         "WHERE k.camera_id = ? AND k.time_us <= ? ORDER BY k.time_us DESC LIMIT 1"},
+        {&selectSegments_, "SELECT path, start_us, end_us, bytes, complete FROM segments "
+                           "WHERE camera_id = ? AND start_us <= ? AND (end_us IS NULL OR end_us >= ?) "
+                           "ORDER BY start_us"},
+    };
+
+    for (const Statement& entry : statements) {
+        if (sqlite3_prepare_v2(db_, entry.sql, -1, entry.statement, nullptr) != SQLITE_OK) {
+            std::cerr << "KeyframeIndex: cannot prepare statement: " << sqlite3_errmsg(db_) << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void KeyframeIndex::finalizeStatements() {
+    sqlite3_stmt** statements[] = {
+        &insertCamera_, &selectCamera_, &insertSegment_, &selectSegment_,
+        &finishSegment_, &insertKeyframe_, &seekKeyframe_, &selectSegments_,
+    };
+
+    for (sqlite3_stmt** statement : statements) {
+        sqlite3_finalize(*statement);  // No-op on nullptr
+        *statement = nullptr;
+    }
+}
+
+bool KeyframeIndex::exec(const char* sql) {
+    char* error = nullptr;
+    if (sqlite3_exec(db_, sql, nullptr, nullptr, &error) != SQLITE_OK) {
+        std::cerr << "KeyframeIndex: " << (error ? error : "query failed") << std::endl;
+        sqlite3_free(error);
+        return false;
+    }
+    return true;
+}
+
+bool KeyframeIndex::commit(std::vector<Recorder::KeyframeInfo>& keyframes,
+                           std::vector<Recorder::SegmentInfo>& segments) {
+    if (!exec("BEGIN;")) {
+        errors_++;
+        return false;
+    }
+
+    bool ok = true;
+
+    // Keyframes first: a segment's close is always queued after its keyframes
+    for (const Recorder::KeyframeInfo& keyframe : keyframes) {
+        const int64_t camera = lookupCamera(keyframe.cameraId, true);
+        const int64_t segment = camera < 0 ? -1 : lookupSegment(camera, keyframe.segmentPath,
+                                                                 keyframe.segmentStartUs);
+        if (segment < 0) {
+            ok = false;
+            break;
+        }
+
+        StatementScope scope(insertKeyframe_);
+        sqlite3_bind_int64(insertKeyframe_, 1, camera);
+        sqlite3_bind_int64(insertKeyframe_, 2, keyframe.timeUs);
+        sqlite3_bind_int64(insertKeyframe_, 3, segment);
+        sqlite3_bind_int64(insertKeyframe_, 4, static_cast<int64_t>(keyframe.offset));
+        sqlite3_bind_int64(insertKeyframe_, 5, keyframe.ptsUs);
+        if (sqlite3_step(insertKeyframe_) != SQLITE_DONE) {
+            ok = false;
+            break;
+        }
+    }
+
+    for (size_t i = 0; ok && i < segments.size(); ++i) {
+        const Recorder::SegmentInfo& info = segments[i];
+        const int64_t camera = lookupCamera(info.cameraId, true);
+        const int64_t segment = camera < 0 ? -1 : lookupSegment(camera, info.path, info.startTimeUs);
+        if (segment < 0) {
+            ok = false;
+            break;
+        }
+
+        StatementScope scope(finishSegment_);
+        sqlite3_bind_int64(finishSegment_, 1, info.endTimeUs);
+        sqlite3_bind_int64(finishSegment_, 2, static_cast<int64_t>(info.bytes));
+        sqlite3_bind_int(finishSegment_, 3, info.complete ? 1 : 0);
+        sqlite3_bind_int64(finishSegment_, 4, segment);
+        if (sqlite3_step(finishSegment_) != SQLITE_DONE) {
+            ok = false;
+            break;
+        }
+    }
+
+    if (!ok || !exec("COMMIT;")) {
+        std::cerr << "KeyframeIndex: commit of " << keyframes.size() << " keyframes failed: "
+                  << sqlite3_errmsg(db_) << std::endl;
+        exec("ROLLBACK;");
+        errors_++;
+
+        // Rolled back rows may have been cached
+        cameraIds_.clear();
+        segmentIds_.clear();
+        return false;
+    }
+
+    // Finished segments get no more keyframes
+    for (const Recorder::SegmentInfo& info : segments) {
+        segmentIds_.erase(info.path);
+    }
+
+    keyframesIndexed_ += keyframes.size();
+    segmentsIndexed_ += segments.size();
+    transactions_++;
+    return true;
+}
+
+int64_t KeyframeIndex::lookupCamera(const std::string& name, bool create) {
+    auto it = cameraIds_.find(name);
+    if (it != cameraIds_.end()) {
+        return it->second;
+    }
+
+    if (create) {
+        StatementScope scope(insertCamera_);
+        sqlite3_bind_text(insertCamera_, 1, name.c_str(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+        if (sqlite3_step(insertCamera_) != SQLITE_DONE) {
+            return -1;
+        }
+    }
+
+    StatementScope scope(selectCamera_);
+    sqlite3_bind_text(selectCamera_, 1, name.c_str(), static_cast<int>(name.size()), SQLITE_TRANSIENT);
+    if (sqlite3_step(selectCamera_) != SQLITE_ROW) {
+        return -1;
+    }
+
+    const int64_t id = sqlite3_column_int64(selectCamera_, 0);
+    cameraIds_[name] = id;
+    return id;
+}
+
+int64_t KeyframeIndex::lookupSegment(int64_t camera, const std::string& path, int64_t startTimeUs) {
+    auto it = segmentIds_.find(path);
+    if (it != segmentIds_.end()) {
+        return it->second;
+    }
+
+    {
+        StatementScope scope(insertSegment_);
+        sqlite3_bind_int64(insertSegment_, 1, camera);
+        sqlite3_bind_text(insertSegment_, 2, path.c_str(), static_cast<int>(path.size()), SQLITE_TRANSIENT);
+        sqlite3_bind_int64(insertSegment_, 3, startTimeUs);
+        if (sqlite3_step(insertSegment_) != SQLITE_DONE) {
+            return -1;
+        }
+    }
+
+    StatementScope scope(selectSegment_);
+    sqlite3_bind_text(selectSegment_, 1, path.c_str(), static_cast<int>(path.size()), SQLITE_TRANSIENT);
+    if (sqlite3_step(selectSegment_) != SQLITE_ROW) {
+        return -1;
+    }
+
+    const int64_t id = sqlite3_column_int64(selectSegment_, 0);
+    segmentIds_[path] = id;
+    return id;
+}
+
+} // namespace recording
+} // namespace fluxvision
@@ -0,0 +1,151 @@
+// src/recording/keyframe_index.h
+// SQLite index of recorded keyframes: (camera, wall-clock time) -> (segment file, byte offset)
+#pragma once
+
+#include "recorder.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+struct sqlite3;
+struct sqlite3_stmt;
+
+namespace fluxvision {
+namespace recording {
+
+// Seek target found in the index
+struct KeyframeLocation {
+    std::string segmentPath;
+    uint64_t offset = 0;                            // Byte offset of the keyframe's PAT in the file
+    int64_t timeUs = 0;                             // Wall clock of the keyframe
+    int64_t ptsUs = 0;                              // Stream timestamp of the IDR
+};
+
+// Recorded span of one camera
+struct SegmentRecord {
+    std::string path;
+    int64_t startTimeUs = 0;
+    int64_t endTimeUs = 0;                          // 0 while still recording
+    uint64_t bytes = 0;
+    bool complete = false;
+};
+
+// Keyframe index kept next to the recordings
+//
+// Wire it to a Recorder (both callbacks only queue in memory):
+//   recorder.setKeyframeCallback([&](const Recorder::KeyframeInfo& k) { index.addKeyframe(k); });
+//   recorder.setSegmentCallback([&](const Recorder::SegmentInfo& s) { index.addSegment(s); });
+//
+// Entries are committed by a background thread, one transaction per
+// commitInterval, on a WAL-mode database: readers (playback, other processes)
+// never block the recorder and the recorder never waits for fsync per frame.
+// Keyframes are keyed by (camera, time) in a WITHOUT ROWID table, so a seek is
+// a single B-tree descent regardless of retention.
+//
+// Thread-safety: all methods may be called from any thread.
+class KeyframeIndex {
+public:
+    struct Config {
+        std::string databasePath = "recordings/index.db";
+        std::chrono::milliseconds commitInterval{2000};
+        int busyTimeoutMs = 5000;                   // Wait for other writers (retention cleanup)
+    };
+
+    explicit KeyframeIndex(const Config& config);
+    ~KeyframeIndex();
+
+    // Delete copy/move
+    KeyframeIndex(const KeyframeIndex&) = delete;
+    KeyframeIndex& operator=(const KeyframeIndex&) = delete;
+
+    // Open (create) the database and start the commit thread
+    bool open();
+
+    // Commit what is pending and close
+    void close();
+
+    bool isOpen() const { return open_.load(); }
+
+    // Queue entries (cheap; called from the recorder's threads)
+    void addKeyframe(const Recorder::KeyframeInfo& keyframe);
+    void addSegment(const Recorder::SegmentInfo& segment);  // Finished segment
+
+    // Commit queued entries now (e.g. before seeking into the live edge). A
+    // batch that fails stays queued for the next flush, a few times at most
+    bool flush();
+
+    // Last keyframe of cameraId at or before timeUs; false if none
+    bool seek(const std::string& cameraId, int64_t timeUs, KeyframeLocation& location);
+
+    // Segments of cameraId overlapping [fromUs, toUs], oldest first
+    std::vector<SegmentRecord> findSegments(const std::string& cameraId, int64_t fromUs, int64_t toUs);
+
+    // Drop index entries of segments that ended before timeUs (retention);
+    // returns the paths so the caller can delete the files
+    std::vector<std::string> removeBefore(int64_t timeUs);
+
+    struct Stats {
+        uint64_t keyframesIndexed = 0;
+        uint64_t segmentsIndexed = 0;
+        uint64_t transactions = 0;
+        uint64_t errors = 0;
+        size_t pending = 0;
+    };
+    Stats getStats() const;
+
+private:
+    Config config_;
+    sqlite3* db_ = nullptr;
+    std::atomic<bool> open_{false};
+
+    // Prepared statements (dbMutex_)
+    sqlite3_stmt* insertCamera_ = nullptr;
+    sqlite3_stmt* selectCamera_ = nullptr;
+    sqlite3_stmt* insertSegment_ = nullptr;
+    sqlite3_stmt* selectSegment_ = nullptr;
+    sqlite3_stmt* finishSegment_ = nullptr;
+    sqlite3_stmt* insertKeyframe_ = nullptr;
+    sqlite3_stmt* seekKeyframe_ = nullptr;
+    sqlite3_stmt* selectSegments_ = nullptr;
+    std::mutex dbMutex_;
+
+    // Ids already resolved (dbMutex_)
+    std::unordered_map<std::string, int64_t> cameraIds_;
+    std::unordered_map<std::string, int64_t> segmentIds_;  // Segments still being written
+    int failedCommits_ = 0;                                // In a row, on the batch pending again
+
+    // Queued entries
+    std::vector<Recorder::KeyframeInfo> pendingKeyframes_;
+    std::vector<Recorder::SegmentInfo> pendingSegments_;
+    mutable std::mutex pendingMutex_;
+    std::condition_variable commitCv_;
+    bool stopRequested_ = false;
+    std::thread thread_;
+
+    // Statistics
+    std::atomic<uint64_t> keyframesIndexed_{0};
+    std::atomic<uint64_t> segmentsIndexed_{0};
+    std::atomic<uint64_t> transactions_{0};
+    std::atomic<uint64_t> errors_{0};
+
+    void commitLoop();
+
+    // dbMutex_ held
+    bool createSchema();
+    bool prepareStatements();
+    void finalizeStatements();
+    bool exec(const char* sql);
+    bool commit(std::vector<Recorder::KeyframeInfo>& keyframes,
+                std::vector<Recorder::SegmentInfo>& segments);
+    int64_t lookupCamera(const std::string& name, bool create);  // -1 if unknown/failed
+    int64_t lookupSegment(int64_t camera, const std::string& path, int64_t startTimeUs);
+};
+
+} // namespace recording
+} // namespace fluxvision
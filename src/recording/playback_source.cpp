@@ -0,0 +1,222 @@
+// src/recording/playback_source.cpp
+#include "playback_source.h"
+#include <limits>
+
+namespace fluxvision {
+namespace recording {
+
+namespace {
+    // Footage gaps above this (camera offline, recorder stopped) are skipped, not waited out
+    constexpr int64_t kMaxGapUs = 2000000;
+}
+
+PlaybackSource::PlaybackSource(KeyframeIndex& index, const Config& config)
+    : index_(index)
+    , config_(config)
+    , demuxer_(config.codec)
+    , decimator_(config.quality)
+{
+}
+
+bool PlaybackSource::seek(int64_t timeUs) {
+    havePending_ = false;
+    haveAnchor_ = false;
+    positioned_ = false;
+
+    KeyframeLocation location;
+    if (index_.seek(config_.cameraId, timeUs, location)) {
+        for (const SegmentRecord& segment : index_.findSegments(config_.cameraId, location.timeUs, location.timeUs)) {
+            if (segment.path == location.segmentPath && openSegment(segment, location.offset)) {
+                segmentBaseTimeUs_ = location.timeUs;
+                segmentBasePtsUs_ = location.ptsUs;
+                lastPtsUs_ = location.ptsUs;
+                haveSegmentBase_ = true;
+                positioned_ = true;
+                break;
+            }
+        }
+    } else {
+        // Before the first keyframe on record: start at the first segment after timeUs
+        const auto segments = index_.findSegments(config_.cameraId, timeUs,
+                                                  std::numeric_limits<int64_t>::max());
+        positioned_ = !segments.empty() && openSegment(segments.front(), 0);
+    }
+
+    if (!positioned_) {
+        return false;
+    }
+
+    positionUs_ = haveSegmentBase_ ? segmentBaseTimeUs_ : segment_.startTimeUs;
+    decimator_.resync();
+    applyQuality();
+    return true;
+}
+
+void PlaybackSource::setSpeed(double speed) {
+    if (speed <= 0.0) {
+        return;
+    }
+
+    const bool wasKeyframeOnly = isKeyframeOnly();
+    speed_ = speed;
+    haveAnchor_ = false;
+
+    if (wasKeyframeOnly != isKeyframeOnly()) {
+        applyQuality();
+
+        // Back to a normal rate: restart from the keyframe on screen instead of
+        // waiting for the next one
+        if (wasKeyframeOnly && positioned_) {
+            seek(positionUs_);
+        }
+    }
+}
+
+void PlaybackSource::setQuality(stream::StreamQuality quality) {
+    config_.quality = quality;
+    applyQuality();
+}
+
+PlaybackSource::ReadStatus PlaybackSource::read(stream::StreamPacket& packet) {
+    if (!positioned_) {
+        return ReadStatus::END;
+    }
+
+    while (!havePending_) {
+        const TsDemuxer::ReadStatus status = readUnit(pending_);
+        if (status == TsDemuxer::ReadStatus::NEED_MORE) {
+            return ReadStatus::WOULD_BLOCK;
+        }
+        if (status == TsDemuxer::ReadStatus::END) {
+            positioned_ = false;
+            return ReadStatus::END;
+        }
+
+        pendingTimeUs_ = wallClockOf(pending_.ptsUs);
+
+        if (!haveAnchor_ || pendingTimeUs_ - positionUs_ > kMaxGapUs) {
+            anchorTimeUs_ = pendingTimeUs_;
+            anchorClock_ = std::chrono::steady_clock::now();
+            haveAnchor_ = true;
+        }
+
+        // Decimate on the playback clock: at 2x a 30 fps camera arrives at 60 fps
+        stream::StreamPacket candidate;
+        candidate.timestamp = anchorTimeUs_ + static_cast<int64_t>((pendingTimeUs_ - anchorTimeUs_) / speed_);
+        candidate.isKeyFrame = pending_.isKeyframe;
+        candidate.isReference = pending_.isReference;
+
+        havePending_ = decimator_.shouldDecode(candidate);
+        if (!havePending_) {
+            positionUs_ = pendingTimeUs_;
+        }
+    }
+
+    const auto dueIn = std::chrono::microseconds(
+        static_cast<int64_t>((pendingTimeUs_ - anchorTimeUs_) / speed_));
+    if (std::chrono::steady_clock::now() < anchorClock_ + dueIn) {
+        return ReadStatus::WOULD_BLOCK;
+    }
+
+    packet.data = std::move(pending_.data);
+    packet.timestamp = pending_.ptsUs;
+    packet.isKeyFrame = pending_.isKeyframe;
+    packet.isReference = pending_.isReference;
+    packet.discardOlder = false;
+
+    positionUs_ = pendingTimeUs_;
+    havePending_ = false;
+    return ReadStatus::OK;
+}
+
+bool PlaybackSource::openSegment(const SegmentRecord& segment, uint64_t offset) {
+    if (!file_.open(segment.path)) {
+        return false;
+    }
+
+    segment_ = segment;
+    haveSegmentBase_ = false;
+
+    demuxer_.reset();
+    demuxer_.setInput(file_.data(), file_.size(), segment.endTimeUs != 0);
+    demuxer_.seek(offset);
+    return true;
+}
+
+bool PlaybackSource::advanceSegment() {
+    const auto segments = index_.findSegments(config_.cameraId, segment_.startTimeUs,
+                                              std::numeric_limits<int64_t>::max());
+
+    for (const SegmentRecord& segment : segments) {
+        if (segment.startTimeUs > segment_.startTimeUs && openSegment(segment, 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool PlaybackSource::refreshSegment() {
+    // Live edge: remap to see what the recorder appended, keep the position
+    for (const SegmentRecord& segment : index_.findSegments(config_.cameraId, segment_.startTimeUs,
+                                                            segment_.startTimeUs)) {
+        if (segment.path != segment_.path) {
+            continue;
+        }
+
+        const uint64_t position = demuxer_.position();
+        const size_t mappedSize = file_.size();
+        if (!file_.open(segment.path)) {
+            return false;
+        }
+
+        segment_ = segment;
+        demuxer_.setInput(file_.data(), file_.size(), segment.endTimeUs != 0);
+        demuxer_.seek(position);
+        return file_.size() > mappedSize || segment.endTimeUs != 0;
+    }
+    return false;
+}
+
+void PlaybackSource::applyQuality() {
+    // Scrubbing: IDR only, exactly like a PAUSED live tile
+    decimator_.setQuality(isKeyframeOnly() ? stream::StreamQuality::PAUSED : config_.quality);
+}
+
+int64_t PlaybackSource::wallClockOf(int64_t ptsUs) {
+    // A segment starts at a keyframe recorded at segment.startTimeUs
+    if (!haveSegmentBase_ || ptsUs < lastPtsUs_) {
+        segmentBaseTimeUs_ = haveSegmentBase_ ? positionUs_ : segment_.startTimeUs;
+        segmentBasePtsUs_ = ptsUs;
+        haveSegmentBase_ = true;
+    }
+
+    lastPtsUs_ = ptsUs;
+    return segmentBaseTimeUs_ + (ptsUs - segmentBasePtsUs_);
+}
+
+TsDemuxer::ReadStatus PlaybackSource::readUnit(TsDemuxer::AccessUnit& unit) {
+    while (true) {
+        const TsDemuxer::ReadStatus status = demuxer_.read(unit, isKeyframeOnly());
+        if (status == TsDemuxer::ReadStatus::OK) {
+            return status;
+        }
+
+        if (status == TsDemuxer::ReadStatus::NEED_MORE) {
+            // Segment still being recorded: pick up new data, or move on if it was abandoned
+            if (refreshSegment()) {
+                continue;
+            }
+            if (!advanceSegment()) {
+                return TsDemuxer::ReadStatus::NEED_MORE;
+            }
+            continue;
+        }
+
+        if (!advanceSegment()) {
+            return TsDemuxer::ReadStatus::END;
+        }
+    }
+}
+
+} // namespace recording
+} // namespace fluxvision
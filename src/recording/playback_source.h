@@ -0,0 +1,110 @@
+// src/recording/playback_source.h
+// Recorded-footage source: paced StreamPackets from segment files, seek via the keyframe index
+#pragma once
+
+#include "keyframe_index.h"
+#include "segment_io.h"
+#include "ts_demuxer.h"
+#include "core/stream/camera_stream.h"
+#include "core/stream/frame_decimator.h"
+#include "core/stream/packet_queue.h"
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+namespace fluxvision {
+namespace recording {
+
+// Plays one camera's recordings into the regular decode path
+//
+// Drop-in for RtspClient on the producing side: read() yields StreamPackets
+// that go to an IDecoder (or a CameraStream's PacketQueue) unchanged. Segments
+// are memory-mapped and demuxed in place; seek() lands on the last IDR at or
+// before the requested time through the keyframe index, so decoding starts
+// cleanly without scanning any file. Playback continues across segments.
+//
+// Pacing follows the footage timestamps scaled by the speed. The packets are
+// put through the same FrameDecimator as live cameras: the output tier
+// decides how many pictures are worth decoding, and at keyframeOnlySpeed or
+// faster it switches to PAUSED (IDR only). Those scrubs don't even copy the
+// skipped pictures out of the file, and NVDEC only sees frames that will be
+// shown.
+//
+// Thread-safety: not thread-safe (one consumer thread).
+class PlaybackSource {
+public:
+    struct Config {
+        std::string cameraId;
+        CodecType codec = CodecType::H264;
+        stream::StreamQuality quality = stream::StreamQuality::FULLSCREEN;  // Output tier
+        double keyframeOnlySpeed = 4.0;             // At or above: decode IDR pictures only
+    };
+
+    enum class ReadStatus {
+        OK,                                         // packet filled
+        WOULD_BLOCK,                                // Next picture not due yet, or live edge
+        END                                         // No more recordings
+    };
+
+    PlaybackSource(KeyframeIndex& index, const Config& config);
+
+    // Position at the last keyframe at or before timeUs (wall clock)
+    bool seek(int64_t timeUs);
+
+    // Playback rate (1.0 = real time); keeps the position
+    void setSpeed(double speed);
+    double getSpeed() const { return speed_; }
+    bool isKeyframeOnly() const { return speed_ >= config_.keyframeOnlySpeed; }
+
+    // Output tier (e.g. the tile was resized)
+    void setQuality(stream::StreamQuality quality);
+
+    // Next packet worth decoding, once it is due
+    ReadStatus read(stream::StreamPacket& packet);
+
+    // Wall-clock time of the last packet returned
+    int64_t getPositionUs() const { return positionUs_; }
+
+    // Pictures the decimator withheld from the decoder (scrubbing also skips unread ones)
+    uint64_t decimatedCount() const { return decimator_.decimatedCount(); }
+
+private:
+    KeyframeIndex& index_;
+    Config config_;
+
+    MappedFile file_;
+    SegmentRecord segment_;
+    TsDemuxer demuxer_;
+    stream::FrameDecimator decimator_;
+
+    double speed_ = 1.0;
+    bool positioned_ = false;
+
+    // Pacing anchor: footage time anchorTimeUs_ was due at steady-clock anchorClock_
+    bool haveAnchor_ = false;
+    int64_t anchorTimeUs_ = 0;
+    std::chrono::steady_clock::time_point anchorClock_;
+
+    // Segment's first keyframe, to turn PTS into wall-clock time
+    int64_t segmentBaseTimeUs_ = 0;
+    int64_t segmentBasePtsUs_ = 0;
+    bool haveSegmentBase_ = false;
+
+    int64_t positionUs_ = 0;
+    int64_t lastPtsUs_ = 0;
+
+    // Next picture, read ahead until it is due
+    bool havePending_ = false;
+    TsDemuxer::AccessUnit pending_;
+    int64_t pendingTimeUs_ = 0;
+
+    bool openSegment(const SegmentRecord& segment, uint64_t offset);
+    bool advanceSegment();
+    bool refreshSegment();
+    void applyQuality();
+    int64_t wallClockOf(int64_t ptsUs);
+    TsDemuxer::ReadStatus readUnit(TsDemuxer::AccessUnit& unit);
+};
+
+} // namespace recording
+} // namespace fluxvision
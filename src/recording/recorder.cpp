@@ -0,0 +1,329 @@
+// src/recording/recorder.cpp
+#include "recorder.h"
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <filesystem>
+#include <iostream>
+
+namespace fluxvision {
+namespace recording {
+
+namespace {
+    int64_t wallClockUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count();
+    }
+
+    // Camera ids come from configuration: keep them to one safe path component
+    std::string sanitizeComponent(const std::string& name) {
+        std::string result;
+        result.reserve(name.size());
+        for (char c : name) {
+            const unsigned char uc = static_cast<unsigned char>(c);
+            result += (std::isalnum(uc) || c == '-' || c == '_') ? c : '_';
+        }
+        return result.empty() ? "_" : result;
+    }
+}
+
+Recorder::Recorder(const Config& config)
+    : config_(config)
+    , writer_(config.io)
+{
+}
+
+Recorder::~Recorder() {
+    stop();
+}
+
+bool Recorder::start() {
+    if (running_.load()) {
+        return true;
+    }
+
+    if (!writer_.start()) {
+        std::cerr << "Recorder: failed to start segment writer" << std::endl;
+        return false;
+    }
+
+    running_ = true;
+    std::cout << "Recorder: recording to " << config_.rootDirectory << std::endl;
+    return true;
+}
+
+void Recorder::stop() {
+    if (!running_.exchange(false)) {
+        return;
+    }
+
+    std::vector<std::shared_ptr<Camera>> cameras;
+    {
+        std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+        for (const auto& entry : cameras_) {
+            cameras.push_back(entry.second);
+        }
+    }
+
+    for (const auto& camera : cameras) {
+        std::lock_guard<std::mutex> lock(camera->mutex);
+        closeSegment(*camera);
+        camera->waitingForKeyframe = true;
+    }
+
+    // Drains every queued write and finalizes the segments just closed
+    writer_.stop();
+}
+
+bool Recorder::addCamera(const std::string& cameraId, CodecType codec,
+                         const std::vector<uint8_t>& parameterSets) {
+    auto camera = std::make_shared<Camera>(cameraId, codec);
+    if (!parameterSets.empty()) {
+        camera->muxer.setParameterSets(parameterSets.data(), parameterSets.size());
+    }
+
+    std::unique_lock<std::shared_mutex> lock(camerasMutex_);
+    if (cameras_.count(cameraId)) {
+        std::cerr << "Recorder: camera " << cameraId << " already recording" << std::endl;
+        return false;
+    }
+
+    cameras_[cameraId] = std::move(camera);
+    return true;
+}
+
+bool Recorder::removeCamera(const std::string& cameraId) {
+    std::shared_ptr<Camera> camera;
+    {
+        std::unique_lock<std::shared_mutex> lock(camerasMutex_);
+        auto it = cameras_.find(cameraId);
+        if (it == cameras_.end()) {
+            return false;
+        }
+        camera = std::move(it->second);
+        cameras_.erase(it);
+    }
+
+    std::lock_guard<std::mutex> lock(camera->mutex);
+    closeSegment(*camera);
+    return true;
+}
+
+void Recorder::writePacket(const std::string& cameraId, const stream::StreamPacket& packet) {
+    if (!running_.load() || packet.data.empty()) {
+        return;
+    }
+
+    std::shared_ptr<Camera> camera = findCamera(cameraId);
+    if (!camera) {
+        return;
+    }
+
+    const int64_t nowUs = wallClockUs();
+    std::lock_guard<std::mutex> lock(camera->mutex);
+
+    // Segments (and every resumption after a drop) start at a keyframe
+    if (camera->waitingForKeyframe) {
+        if (!packet.isKeyFrame) {
+            packetsDropped_++;
+            return;
+        }
+        camera->waitingForKeyframe = false;
+    }
+
+    if (packet.isKeyFrame && camera->segmentId != 0) {
+        const uint64_t bytes = camera->flushedBytes + (camera->buffer ? camera->buffer->data.size() : 0);
+        const int64_t durationUs = std::chrono::duration_cast<std::chrono::microseconds>(
+            config_.segmentDuration).count();
+
+        if (nowUs - camera->startTimeUs >= durationUs || bytes >= config_.maxSegmentBytes) {
+            closeSegment(*camera);
+        }
+    }
+
+    if (camera->segmentId == 0 && !openSegment(*camera, nowUs)) {
+        camera->waitingForKeyframe = true;
+        packetsDropped_++;
+        return;
+    }
+
+    // Hand the current batch over before it would have to grow
+    const size_t needed = camera->muxer.maxOutputSize(packet.data.size());
+    if (camera->buffer && !camera->buffer->data.empty() &&
+        camera->buffer->data.size() + needed > config_.io.bufferBytes) {
+        flushBuffer(*camera);
+    }
+
+    if (!camera->buffer) {
+        camera->buffer = writer_.acquireBuffer();
+        if (!camera->buffer) {
+            // Disk is behind: skip to the next GOP instead of blocking the network thread
+            camera->waitingForKeyframe = true;
+            packetsDropped_++;
+            return;
+        }
+        camera->bufferStarted = std::chrono::steady_clock::now();
+    }
+
+    const uint64_t offset = camera->flushedBytes + camera->buffer->data.size();
+    camera->muxer.writeAccessUnit(packet.data.data(), packet.data.size(), packet.timestamp,
+                                  packet.isKeyFrame, camera->buffer->data);
+    camera->lastTimeUs = nowUs;
+    packetsWritten_++;
+
+    if (packet.isKeyFrame) {
+        std::shared_ptr<const KeyframeCallback> callback;
+        {
+            std::lock_guard<std::mutex> callbackLock(callbackMutex_);
+            callback = keyframeCallback_;
+        }
+
+        if (callback) {
+            KeyframeInfo keyframe;
+            keyframe.cameraId = camera->id;
+            keyframe.segmentPath = camera->path;
+            keyframe.segmentStartUs = camera->startTimeUs;
+            keyframe.timeUs = nowUs;
+            keyframe.offset = offset;
+            keyframe.ptsUs = packet.timestamp;
+            (*callback)(keyframe);
+        }
+    }
+
+    // Low-bitrate cameras: don't hold data in memory longer than flushInterval
+    if (std::chrono::steady_clock::now() - camera->bufferStarted >= config_.flushInterval) {
+        flushBuffer(*camera);
+    }
+}
+
+void Recorder::setSegmentCallback(SegmentCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    segmentCallback_ = callback ? std::make_shared<const SegmentCallback>(std::move(callback)) : nullptr;
+}
+
+void Recorder::setKeyframeCallback(KeyframeCallback callback) {
+    std::lock_guard<std::mutex> lock(callbackMutex_);
+    keyframeCallback_ = callback ? std::make_shared<const KeyframeCallback>(std::move(callback)) : nullptr;
+}
+
+Recorder::Stats Recorder::getStats() const {
+    Stats stats;
+    {
+        std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+        stats.cameras = cameras_.size();
+    }
+    stats.packetsWritten = packetsWritten_.load();
+    stats.packetsDropped = packetsDropped_.load();
+    stats.segmentsCompleted = segmentsCompleted_.load();
+    stats.segmentsFailed = segmentsFailed_.load();
+    stats.io = writer_.getStats();
+    return stats;
+}
+
+std::string Recorder::segmentPath(const std::string& rootDirectory, const std::string& cameraId,
+                                  int64_t timeUs) {
+    const std::time_t seconds = static_cast<std::time_t>(timeUs / 1000000);
+    const int milliseconds = static_cast<int>((timeUs / 1000) % 1000);
+
+    std::tm utc = {};
+#ifdef PLATFORM_WINDOWS
+    gmtime_s(&utc, &seconds);
+#else
+    gmtime_r(&seconds, &utc);
+#endif
+
+    char day[16];
+    char name[32];
+    std::snprintf(day, sizeof(day), "%04d-%02d-%02d", utc.tm_year + 1900, utc.tm_mon + 1, utc.tm_mday);
+    std::snprintf(name, sizeof(name), "%02d-%02d-%02d-%03d.ts", utc.tm_hour, utc.tm_min, utc.tm_sec,
+                  milliseconds);
+
+    return (std::filesystem::path(rootDirectory) / sanitizeComponent(cameraId) / day / name).string();
+}
+
+std::shared_ptr<Recorder::Camera> Recorder::findCamera(const std::string& cameraId) const {
+    std::shared_lock<std::shared_mutex> lock(camerasMutex_);
+    auto it = cameras_.find(cameraId);
+    return it != cameras_.end() ? it->second : nullptr;
+}
+
+bool Recorder::openSegment(Camera& camera, int64_t nowUs) {
+    const std::string path = segmentPath(config_.rootDirectory, camera.id, nowUs);
+
+    const uint64_t segmentId = writer_.openSegment(path);
+    if (segmentId == 0) {
+        return false;
+    }
+
+    camera.segmentId = segmentId;
+    camera.path = path;
+    camera.flushedBytes = 0;
+    camera.startTimeUs = nowUs;
+    camera.lastTimeUs = nowUs;
+    camera.muxer.reset();
+    return true;
+}
+
+void Recorder::closeSegment(Camera& camera) {
+    if (camera.segmentId == 0) {
+        writer_.releaseBuffer(std::move(camera.buffer));
+        return;
+    }
+
+    flushBuffer(camera);
+
+    SegmentInfo info;
+    info.cameraId = camera.id;
+    info.path = camera.path;
+    info.codec = camera.codec;
+    info.startTimeUs = camera.startTimeUs;
+    info.endTimeUs = camera.lastTimeUs;
+
+    writer_.closeSegment(camera.segmentId, camera.flushedBytes,
+                         [this, info](const SegmentWriter::SegmentResult& result) {
+                             onSegmentClosed(info, result);
+                         });
+
+    camera.segmentId = 0;
+    camera.path.clear();
+    camera.flushedBytes = 0;
+}
+
+void Recorder::flushBuffer(Camera& camera) {
+    if (!camera.buffer) {
+        return;
+    }
+
+    if (camera.buffer->data.empty()) {
+        writer_.releaseBuffer(std::move(camera.buffer));
+        return;
+    }
+
+    const size_t size = camera.buffer->data.size();
+    writer_.write(camera.segmentId, camera.flushedBytes, std::move(camera.buffer));
+    camera.flushedBytes += size;
+}
+
+void Recorder::onSegmentClosed(SegmentInfo info, const SegmentWriter::SegmentResult& result) {
+    info.bytes = result.bytes;
+    info.complete = result.ok;
+
+    if (result.ok) {
+        segmentsCompleted_++;
+    } else {
+        segmentsFailed_++;
+    }
+
+    std::shared_ptr<const SegmentCallback> callback;
+    {
+        std::lock_guard<std::mutex> lock(callbackMutex_);
+        callback = segmentCallback_;
+    }
+
+    if (callback) {
+        (*callback)(info);
+    }
+}
+
+} // namespace recording
+} // namespace fluxvision
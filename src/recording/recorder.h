@@ -0,0 +1,164 @@
+// src/recording/recorder.h
+// Continuous recording: remuxes received access units into MPEG-TS segment files
+#pragma once
+
+#include "segment_writer.h"
+#include "ts_muxer.h"
+#include "core/codec/types.h"
+#include "core/stream/packet_queue.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace fluxvision {
+namespace recording {
+
+// Zero-transcode recorder for many cameras
+//
+// Feed it every StreamPacket before decode (StreamManager::setPacketCallback):
+// packets are muxed straight into a per-camera batch buffer and handed to the
+// shared SegmentWriter once it is full or flushInterval old, so disk traffic is
+// one large write per buffer instead of one per packet. Segments start at a
+// keyframe and rotate at the first keyframe past segmentDuration or
+// maxSegmentBytes. If the writer falls behind and its buffer pool runs dry,
+// the camera drops packets until the next keyframe rather than blocking
+// the network thread; the segment keeps a clean gap.
+//
+// Layout: <rootDirectory>/<camera>/<YYYY-MM-DD>/<HH-MM-SS-mmm>.ts (UTC start time)
+//
+// Thread-safety: all methods may be called from any thread; packets of one
+// camera must arrive in order (they do: one network thread per camera).
+class Recorder {
+public:
+    struct Config {
+        std::string rootDirectory = "recordings";
+        std::chrono::milliseconds segmentDuration{60000};
+        uint64_t maxSegmentBytes = 256ULL * 1024 * 1024;
+        std::chrono::milliseconds flushInterval{1000};  // Bounds data lost on a crash
+        SegmentWriter::Config io;
+    };
+
+    // A finished segment file
+    struct SegmentInfo {
+        std::string cameraId;
+        std::string path;
+        CodecType codec = CodecType::H264;
+        int64_t startTimeUs = 0;                    // Wall clock (Unix epoch), first packet
+        int64_t endTimeUs = 0;                      // Wall clock, last packet
+        uint64_t bytes = 0;
+        bool complete = false;                      // Every write landed
+    };
+    using SegmentCallback = std::function<void(const SegmentInfo&)>;
+
+    // A keyframe as written: where a player can start decoding
+    struct KeyframeInfo {
+        std::string cameraId;
+        std::string segmentPath;
+        int64_t segmentStartUs = 0;                 // Wall clock of the segment's first packet
+        int64_t timeUs = 0;                         // Wall clock
+        uint64_t offset = 0;                        // Byte offset in the segment (PAT before the IDR)
+        int64_t ptsUs = 0;                          // StreamPacket::timestamp
+    };
+    using KeyframeCallback = std::function<void(const KeyframeInfo&)>;
+
+    struct Stats {
+        size_t cameras = 0;
+        uint64_t packetsWritten = 0;
+        uint64_t packetsDropped = 0;                // Waiting for a keyframe or no free buffer
+        uint64_t segmentsCompleted = 0;
+        uint64_t segmentsFailed = 0;
+        SegmentWriter::Stats io;
+    };
+
+    explicit Recorder(const Config& config);
+    ~Recorder();
+
+    // Delete copy/move
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    bool start();
+
+    // Close every open segment and wait for the data to reach the disk
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+    // parameterSets: Annex B VPS/SPS/PPS (e.g. from the SDP), repeated on keyframes that lack them
+    bool addCamera(const std::string& cameraId, CodecType codec,
+                   const std::vector<uint8_t>& parameterSets = {});
+    bool removeCamera(const std::string& cameraId);  // Closes its current segment
+
+    // Called on the network thread for every received access unit; never blocks on I/O
+    void writePacket(const std::string& cameraId, const stream::StreamPacket& packet);
+
+    // Runs on the I/O thread when a segment is finalized (e.g. to index it)
+    void setSegmentCallback(SegmentCallback callback);
+
+    // Runs on the network thread for every keyframe written; must not block
+    void setKeyframeCallback(KeyframeCallback callback);
+
+    Stats getStats() const;
+
+    // File path for a segment of cameraId starting at timeUs (wall clock)
+    static std::string segmentPath(const std::string& rootDirectory, const std::string& cameraId,
+                                   int64_t timeUs);
+
+private:
+    struct Camera {
+        Camera(const std::string& cameraId, CodecType cameraCodec)
+            : id(cameraId), codec(cameraCodec), muxer(cameraCodec) {}
+
+        std::mutex mutex;
+        const std::string id;
+        const CodecType codec;
+        TsMuxer muxer;
+
+        // Current segment (segmentId 0: none open)
+        uint64_t segmentId = 0;
+        std::string path;
+        uint64_t flushedBytes = 0;                  // Handed to the writer (offset of buffer)
+        int64_t startTimeUs = 0;
+        int64_t lastTimeUs = 0;
+
+        std::unique_ptr<WriteBuffer> buffer;
+        std::chrono::steady_clock::time_point bufferStarted;
+        bool waitingForKeyframe = true;
+    };
+
+    Config config_;
+    SegmentWriter writer_;
+    std::atomic<bool> running_{false};
+
+    std::unordered_map<std::string, std::shared_ptr<Camera>> cameras_;
+    mutable std::shared_mutex camerasMutex_;
+
+    std::shared_ptr<const SegmentCallback> segmentCallback_;
+    std::shared_ptr<const KeyframeCallback> keyframeCallback_;
+    std::mutex callbackMutex_;
+
+    // Statistics
+    std::atomic<uint64_t> packetsWritten_{0};
+    std::atomic<uint64_t> packetsDropped_{0};
+    std::atomic<uint64_t> segmentsCompleted_{0};
+    std::atomic<uint64_t> segmentsFailed_{0};
+
+    std::shared_ptr<Camera> findCamera(const std::string& cameraId) const;
+
+    // Camera mutex held
+    bool openSegment(Camera& camera, int64_t nowUs);
+    void closeSegment(Camera& camera);
+    void flushBuffer(Camera& camera);
+
+    void onSegmentClosed(SegmentInfo info, const SegmentWriter::SegmentResult& result);
+};
+
+} // namespace recording
+} // namespace fluxvision
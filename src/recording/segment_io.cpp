@@ -0,0 +1,630 @@
+// src/recording/segment_io.cpp
+#include "segment_io.h"
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <thread>
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(__linux__)
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+// Headers new enough for IORING_OP_WRITE (5.6) also have the opcode probe
+#if defined(__linux__) && defined(__NR_io_uring_setup) && defined(__NR_io_uring_enter) && \
+    defined(__NR_io_uring_register) && defined(IO_URING_OP_SUPPORTED)
+#define FLUXVISION_HAVE_IO_URING 1
+#endif
+
+namespace fluxvision {
+namespace recording {
+
+namespace {
+    bool createParentDirectories(const std::string& path) {
+        const std::filesystem::path parent = std::filesystem::path(path).parent_path();
+        if (parent.empty()) {
+            return true;
+        }
+
+        std::error_code ec;
+        std::filesystem::create_directories(parent, ec);
+        if (ec) {
+            std::cerr << "SegmentIO: cannot create directory " << parent.string()
+                      << ": " << ec.message() << std::endl;
+            return false;
+        }
+        return true;
+    }
+}
+
+#ifdef PLATFORM_WINDOWS
+
+bool isValidFile(FileHandle file) {
+    return file != nullptr && file != INVALID_HANDLE_VALUE;
+}
+
+FileHandle openSegmentFile(const std::string& path, uint64_t preallocateBytes) {
+    if (!createParentDirectories(path)) {
+        return kInvalidFile;
+    }
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "SegmentIO: cannot create " << path << " (error " << GetLastError() << ")" << std::endl;
+        return kInvalidFile;
+    }
+
+    if (preallocateBytes > 0) {
+        FILE_ALLOCATION_INFO allocation = {};
+        allocation.AllocationSize.QuadPart = static_cast<LONGLONG>(preallocateBytes);
+        if (!SetFileInformationByHandle(file, FileAllocationInfo, &allocation, sizeof(allocation))) {
+            std::cerr << "SegmentIO: preallocation failed for " << path
+                      << " (error " << GetLastError() << ")" << std::endl;
+        }
+    }
+
+    return file;
+}
+
+bool finalizeSegmentFile(FileHandle file, uint64_t size, bool sync) {
+    bool ok = true;
+
+    FILE_END_OF_FILE_INFO endOfFile = {};
+    endOfFile.EndOfFile.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFileInformationByHandle(file, FileEndOfFileInfo, &endOfFile, sizeof(endOfFile))) {
+        ok = false;
+    }
+
+    if (sync && !FlushFileBuffers(file)) {
+        ok = false;
+    }
+
+    CloseHandle(file);
+    return ok;
+}
+
+void closeSegmentFile(FileHandle file) {
+    if (isValidFile(file)) {
+        CloseHandle(file);
+    }
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+                              nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "SegmentIO: cannot open " << path << " (error " << GetLastError() << ")" << std::endl;
+        return false;
+    }
+
+    LARGE_INTEGER size = {};
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);  // The mapping keeps the file open
+    if (!mapping) {
+        return false;
+    }
+
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+
+    path_ = path;
+    mapping_ = mapping;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        UnmapViewOfFile(data_);
+        CloseHandle(mapping_);
+    }
+    mapping_ = nullptr;
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#else
+
+bool isValidFile(FileHandle file) {
+    return file >= 0;
+}
+
+FileHandle openSegmentFile(const std::string& path, uint64_t preallocateBytes) {
+    if (!createParentDirectories(path)) {
+        return kInvalidFile;
+    }
+
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        std::cerr << "SegmentIO: cannot create " << path << ": " << std::strerror(errno) << std::endl;
+        return kInvalidFile;
+    }
+
+#if defined(__linux__)
+    // Reserve extents up front; KEEP_SIZE so readers never see unwritten tail bytes
+    if (preallocateBytes > 0 &&
+        fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(preallocateBytes)) != 0 &&
+        errno != EOPNOTSUPP) {
+        std::cerr << "SegmentIO: preallocation failed for " << path << ": "
+                  << std::strerror(errno) << std::endl;
+    }
+#else
+    (void)preallocateBytes;
+#endif
+
+    return fd;
+}
+
+bool finalizeSegmentFile(FileHandle file, uint64_t size, bool sync) {
+    bool ok = true;
+
+    // Give back the unused part of the reservation
+    if (ftruncate(file, static_cast<off_t>(size)) != 0) {
+        ok = false;
+    }
+
+    if (sync && fdatasync(file) != 0) {
+        ok = false;
+    }
+
+    if (::close(file) != 0) {
+        ok = false;
+    }
+    return ok;
+}
+
+void closeSegmentFile(FileHandle file) {
+    if (isValidFile(file)) {
+        ::close(file);
+    }
+}
+
+bool MappedFile::open(const std::string& path) {
+    close();
+
+    const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        std::cerr << "SegmentIO: cannot open " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    struct stat info = {};
+    if (fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return false;
+    }
+
+    void* view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    ::close(fd);  // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        std::cerr << "SegmentIO: cannot map " << path << ": " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    // Playback reads forward: ask for aggressive read-ahead
+    madvise(view, static_cast<size_t>(info.st_size), MADV_SEQUENTIAL);
+
+    path_ = path;
+    data_ = static_cast<const uint8_t*>(view);
+    size_ = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::close() {
+    if (data_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
+
+MappedFile::~MappedFile() {
+    close();
+}
+
+namespace {
+
+// Positional writes performed immediately (still one call per batch buffer)
+class SyncBackend final : public IoBackend {
+public:
+    const char* name() const override { return "sync"; }
+
+    bool submitWrite(FileHandle file, const uint8_t* data, size_t size,
+                     uint64_t offset, void* tag) override {
+        IoCompletion completion;
+        completion.tag = tag;
+        completion.result = writeAt(file, data, size, offset);
+        completed_.push_back(completion);
+        return true;
+    }
+
+    void reap(std::vector<IoCompletion>& completions, bool /* wait */) override {
+        completions.insert(completions.end(), completed_.begin(), completed_.end());
+        completed_.clear();
+    }
+
+    size_t inFlight() const override { return completed_.size(); }
+
+private:
+    std::vector<IoCompletion> completed_;
+
+    static int64_t writeAt(FileHandle file, const uint8_t* data, size_t size, uint64_t offset) {
+#ifdef PLATFORM_WINDOWS
+        OVERLAPPED overlapped = {};
+        overlapped.Offset = static_cast<DWORD>(offset);
+        overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+
+        DWORD written = 0;
+        if (!WriteFile(file, data, static_cast<DWORD>(size), nullptr, &overlapped) &&
+            GetLastError() != ERROR_IO_PENDING) {
+            return -EIO;
+        }
+        if (!GetOverlappedResult(file, &overlapped, &written, TRUE)) {
+            return -EIO;
+        }
+        return static_cast<int64_t>(written);
+#else
+        size_t done = 0;
+        while (done < size) {
+            const ssize_t n = ::pwrite(file, data + done, size - done, static_cast<off_t>(offset + done));
+            if (n < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return -errno;
+            }
+            done += static_cast<size_t>(n);
+        }
+        return static_cast<int64_t>(done);
+#endif
+    }
+};
+
+#ifdef FLUXVISION_HAVE_IO_URING
+
+// io_uring through the raw syscalls (no liburing dependency)
+class IoUringBackend final : public IoBackend {
+public:
+    static std::unique_ptr<IoBackend> create(unsigned entries) {
+        std::unique_ptr<IoUringBackend> backend(new IoUringBackend());
+        if (!backend->setup(entries)) {
+            return nullptr;
+        }
+        return backend;
+    }
+
+    ~IoUringBackend() override {
+        if (sqes_) munmap(sqes_, sqesSize_);
+        if (cqRing_ && cqRing_ != sqRing_) munmap(cqRing_, cqRingSize_);
+        if (sqRing_) munmap(sqRing_, sqRingSize_);
+        if (ringFd_ >= 0) ::close(ringFd_);
+    }
+
+    const char* name() const override { return "io_uring"; }
+
+    bool submitWrite(FileHandle file, const uint8_t* data, size_t size,
+                     uint64_t offset, void* tag) override {
+        // Never more in flight than SQ entries: the CQ (twice as large) can't overflow
+        if (inFlight_ >= sqEntries_) {
+            return false;
+        }
+
+        const unsigned index = sqTail_ & *sqMask_;
+        io_uring_sqe& sqe = sqes_[index];
+        std::memset(&sqe, 0, sizeof(sqe));
+        sqe.opcode = IORING_OP_WRITE;
+        sqe.fd = file;
+        sqe.addr = reinterpret_cast<uint64_t>(data);
+        sqe.len = static_cast<uint32_t>(size);
+        sqe.off = offset;
+        sqe.user_data = reinterpret_cast<uint64_t>(tag);
+        sqArray_[index] = index;
+
+        sqTail_++;
+        __atomic_store_n(sharedSqTail_, sqTail_, __ATOMIC_RELEASE);
+
+        toSubmit_++;
+        inFlight_++;
+        return true;
+    }
+
+    void flush() override {
+        while (toSubmit_ > 0) {
+            const int submitted = enter(toSubmit_, 0, 0);
+            if (submitted < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                // EAGAIN/EBUSY: the kernel is short on resources, retry at the next flush
+                break;
+            }
+            toSubmit_ -= static_cast<unsigned>(submitted);
+        }
+    }
+
+    void reap(std::vector<IoCompletion>& completions, bool wait) override {
+        flush();
+
+        unsigned head = *cqHead_;
+        unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+
+        // Only what the kernel has taken can complete: writes flush() couldn't
+        // submit would leave the wait hanging
+        if (head == tail && wait && inFlight_ > toSubmit_) {
+            while (enter(0, 1, IORING_ENTER_GETEVENTS) < 0 && errno == EINTR) {
+            }
+            tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        } else if (head == tail && wait && toSubmit_ > 0) {
+            // Kernel short on resources: back off instead of spinning on flush()
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        while (head != tail) {
+            const io_uring_cqe& cqe = cqes_[head & *cqMask_];
+            IoCompletion completion;
+            completion.tag = reinterpret_cast<void*>(cqe.user_data);
+            completion.result = cqe.res;
+            completions.push_back(completion);
+
+            head++;
+            inFlight_--;
+        }
+
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+    }
+
+    size_t inFlight() const override { return inFlight_; }
+
+private:
+    int ringFd_ = -1;
+    unsigned sqEntries_ = 0;
+
+    void* sqRing_ = nullptr;
+    void* cqRing_ = nullptr;
+    size_t sqRingSize_ = 0;
+    size_t cqRingSize_ = 0;
+    io_uring_sqe* sqes_ = nullptr;
+    size_t sqesSize_ = 0;
+
+    unsigned* sharedSqTail_ = nullptr;
+    unsigned* sqMask_ = nullptr;
+    unsigned* sqArray_ = nullptr;
+    unsigned* cqHead_ = nullptr;
+    unsigned* cqTail_ = nullptr;
+    unsigned* cqMask_ = nullptr;
+    io_uring_cqe* cqes_ = nullptr;
+
+    unsigned sqTail_ = 0;            // Our copy; only this thread produces
+    unsigned toSubmit_ = 0;
+    size_t inFlight_ = 0;
+
+    IoUringBackend() = default;
+
+    int enter(unsigned toSubmit, unsigned minComplete, unsigned flags) {
+        return static_cast<int>(syscall(__NR_io_uring_enter, ringFd_, toSubmit, minComplete,
+                                        flags, nullptr, 0));
+    }
+
+    // IORING_OP_WRITE needs 5.6; rings of older kernels reject the probe too
+    bool supportsWrite() {
+        constexpr unsigned kProbeOps = 256;
+        std::vector<uint8_t> buffer(sizeof(io_uring_probe) + kProbeOps * sizeof(io_uring_probe_op), 0);
+        auto* probe = reinterpret_cast<io_uring_probe*>(buffer.data());
+
+        if (syscall(__NR_io_uring_register, ringFd_, IORING_REGISTER_PROBE, probe, kProbeOps) < 0) {
+            return false;
+        }
+        return IORING_OP_WRITE <= probe->last_op && IORING_OP_WRITE < probe->ops_len &&
+               (probe->ops[IORING_OP_WRITE].flags & IO_URING_OP_SUPPORTED) != 0;
+    }
+
+    bool setup(unsigned entries) {
+        io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+
+        ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+        if (ringFd_ < 0) {
+            return false;  // Old kernel, or disabled (containers, io_uring_disabled sysctl)
+        }
+
+        if (!supportsWrite()) {
+            return false;
+        }
+
+        sqEntries_ = params.sq_entries;
+        sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+        cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+
+        const bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+        if (singleMmap) {
+            sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+        }
+
+        sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ringFd_, IORING_OFF_SQ_RING);
+        if (sqRing_ == MAP_FAILED) {
+            sqRing_ = nullptr;
+            return false;
+        }
+
+        if (singleMmap) {
+            cqRing_ = sqRing_;
+        } else {
+            cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                           ringFd_, IORING_OFF_CQ_RING);
+            if (cqRing_ == MAP_FAILED) {
+                cqRing_ = nullptr;
+                return false;
+            }
+        }
+
+        sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+        void* sqes = mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                          ringFd_, IORING_OFF_SQES);
+        if (sqes == MAP_FAILED) {
+            return false;
+        }
+        sqes_ = static_cast<io_uring_sqe*>(sqes);
+
+        auto* sq = static_cast<uint8_t*>(sqRing_);
+        auto* cq = static_cast<uint8_t*>(cqRing_);
+        sharedSqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+        sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+        sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+        cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+        cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+        cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+        cqes_ = reinterpret_cast<io_uring_cqe*>(cq + params.cq_off.cqes);
+
+        sqTail_ = *sharedSqTail_;
+        return true;
+    }
+};
+
+#endif // FLUXVISION_HAVE_IO_URING
+
+#ifdef PLATFORM_WINDOWS
+
+// Overlapped WriteFile completing on an I/O completion port
+class OverlappedBackend final : public IoBackend {
+public:
+    static std::unique_ptr<IoBackend> create(size_t queueDepth) {
+        HANDLE port = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+        if (!port) {
+            return nullptr;
+        }
+        return std::unique_ptr<IoBackend>(new OverlappedBackend(port, queueDepth));
+    }
+
+    ~OverlappedBackend() override {
+        CloseHandle(port_);
+    }
+
+    const char* name() const override { return "overlapped"; }
+
+    bool attach(FileHandle file) override {
+        return CreateIoCompletionPort(file, port_, 0, 0) != nullptr;
+    }
+
+    bool submitWrite(FileHandle file, const uint8_t* data, size_t size,
+                     uint64_t offset, void* tag) override {
+        if (inFlight_ >= queueDepth_) {
+            return false;
+        }
+
+        auto* operation = new Operation();
+        operation->overlapped.Offset = static_cast<DWORD>(offset);
+        operation->overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+        operation->tag = tag;
+
+        if (!WriteFile(file, data, static_cast<DWORD>(size), nullptr, &operation->overlapped) &&
+            GetLastError() != ERROR_IO_PENDING) {
+            // Failed synchronously: no completion packet will be queued
+            immediate_.push_back(IoCompletion{tag, -EIO});
+            delete operation;
+            return true;
+        }
+
+        inFlight_++;
+        return true;
+    }
+
+    void reap(std::vector<IoCompletion>& completions, bool wait) override {
+        const bool haveImmediate = !immediate_.empty();
+        completions.insert(completions.end(), immediate_.begin(), immediate_.end());
+        immediate_.clear();
+
+        if (inFlight_ == 0) {
+            return;
+        }
+
+        OVERLAPPED_ENTRY entries[64];
+        ULONG removed = 0;
+        const DWORD timeout = (wait && !haveImmediate) ? INFINITE : 0;
+        if (!GetQueuedCompletionStatusEx(port_, entries, 64, &removed, timeout, FALSE)) {
+            return;
+        }
+
+        for (ULONG i = 0; i < removed; ++i) {
+            auto* operation = CONTAINING_RECORD(entries[i].lpOverlapped, Operation, overlapped);
+
+            IoCompletion completion;
+            completion.tag = operation->tag;
+            completion.result = operation->overlapped.Internal == 0
+                                    ? static_cast<int64_t>(entries[i].dwNumberOfBytesTransferred)
+                                    : -EIO;
+            completions.push_back(completion);
+
+            delete operation;
+            inFlight_--;
+        }
+    }
+
+    size_t inFlight() const override { return inFlight_ + immediate_.size(); }
+
+private:
+    struct Operation {
+        OVERLAPPED overlapped = {};
+        void* tag = nullptr;
+    };
+
+    HANDLE port_;
+    size_t queueDepth_;
+    size_t inFlight_ = 0;
+    std::vector<IoCompletion> immediate_;
+
+    OverlappedBackend(HANDLE port, size_t queueDepth)
+        : port_(port), queueDepth_(queueDepth) {}
+};
+
+#endif // PLATFORM_WINDOWS
+
+} // namespace
+
+std::unique_ptr<IoBackend> IoBackend::create(size_t queueDepth, bool allowAsync) {
+    if (allowAsync) {
+#if defined(FLUXVISION_HAVE_IO_URING)
+        if (auto backend = IoUringBackend::create(static_cast<unsigned>(queueDepth))) {
+            return backend;
+        }
+        std::cerr << "SegmentIO: io_uring unavailable, using synchronous writes" << std::endl;
+#elif defined(PLATFORM_WINDOWS)
+        if (auto backend = OverlappedBackend::create(queueDepth)) {
+            return backend;
+        }
+        std::cerr << "SegmentIO: I/O completion port unavailable, using synchronous writes" << std::endl;
+#endif
+    }
+
+    (void)queueDepth;
+    return std::make_unique<SyncBackend>();
+}
+
+} // namespace recording
+} // namespace fluxvision
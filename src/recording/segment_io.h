@@ -0,0 +1,101 @@
+// src/recording/segment_io.h
+// Segment file primitives, batched write backends (io_uring, overlapped I/O, pwrite), mapped reads
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace fluxvision {
+namespace recording {
+
+#ifdef PLATFORM_WINDOWS
+using FileHandle = void*;            // HANDLE opened for overlapped I/O
+inline const FileHandle kInvalidFile = reinterpret_cast<FileHandle>(static_cast<intptr_t>(-1));
+#else
+using FileHandle = int;
+constexpr FileHandle kInvalidFile = -1;
+#endif
+
+bool isValidFile(FileHandle file);
+
+// Create (truncate) a segment file, creating missing directories, and reserve
+// preallocateBytes of disk space without changing its size so segments don't
+// fragment as they grow. Blocking: call from the I/O thread.
+FileHandle openSegmentFile(const std::string& path, uint64_t preallocateBytes);
+
+// Trim the reservation to the bytes actually written, optionally flush, close
+bool finalizeSegmentFile(FileHandle file, uint64_t size, bool sync);
+
+// Close without trimming (failed segments)
+void closeSegmentFile(FileHandle file);
+
+// Read-only memory mapping of a recorded segment (playback)
+// Pages are faulted in by the kernel with sequential read-ahead, so playback
+// and scrubbing never copy through a read buffer. A segment still being
+// recorded can be remapped to pick up what was written since.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    bool isOpen() const { return data_ != nullptr; }
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+#ifdef PLATFORM_WINDOWS
+    void* mapping_ = nullptr;
+#endif
+};
+
+// A finished write
+struct IoCompletion {
+    void* tag = nullptr;
+    int64_t result = 0;              // Bytes written, or -errno
+};
+
+// Asynchronous positional writes, driven from a single I/O thread
+class IoBackend {
+public:
+    virtual ~IoBackend() = default;
+
+    virtual const char* name() const = 0;
+
+    // Prepare a newly opened file (IOCP association)
+    virtual bool attach(FileHandle file) { (void)file; return true; }
+
+    // Queue a write; false if queueDepth writes are already in flight (reap first)
+    // data must stay valid until the write completes
+    virtual bool submitWrite(FileHandle file, const uint8_t* data, size_t size,
+                             uint64_t offset, void* tag) = 0;
+
+    // Hand queued writes to the kernel
+    virtual void flush() {}
+
+    // Append finished writes; if wait, blocks until at least one finishes
+    // (only while writes are in flight)
+    virtual void reap(std::vector<IoCompletion>& completions, bool wait) = 0;
+
+    virtual size_t inFlight() const = 0;
+
+    // io_uring on Linux (kernels with IORING_OP_WRITE, 5.6+), overlapped I/O on
+    // Windows; synchronous positional writes if those are unavailable or
+    // allowAsync is false
+    static std::unique_ptr<IoBackend> create(size_t queueDepth, bool allowAsync);
+};
+
+} // namespace recording
+} // namespace fluxvision
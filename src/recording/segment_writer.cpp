@@ -0,0 +1,390 @@
+// src/recording/segment_writer.cpp
+#include "segment_writer.h"
+#include <cstring>
+#include <iostream>
+
+namespace fluxvision {
+namespace recording {
+
+SegmentWriter::SegmentWriter(const Config& config)
+    : config_(config)
+{
+    if (config_.queueDepth == 0) {
+        config_.queueDepth = 1;
+    }
+}
+
+SegmentWriter::~SegmentWriter() {
+    stop();
+}
+
+bool SegmentWriter::start() {
+    if (running_.load()) {
+        return true;
+    }
+
+    backend_ = IoBackend::create(config_.queueDepth, config_.useAsyncIo);
+    backendName_ = backend_->name();
+    completions_.reserve(config_.queueDepth);
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        stopRequested_ = false;
+    }
+
+    running_ = true;
+    thread_ = std::thread([this]() { ioLoop(); });
+
+    std::cout << "SegmentWriter: started (" << backendName_.load()
+              << ", queue depth " << config_.queueDepth << ")" << std::endl;
+    return true;
+}
+
+void SegmentWriter::stop() {
+    if (!running_.load()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        stopRequested_ = true;
+    }
+    requestCv_.notify_one();
+
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    running_ = false;
+    backend_.reset();
+}
+
+std::unique_ptr<WriteBuffer> SegmentWriter::acquireBuffer() {
+    std::lock_guard<std::mutex> lock(bufferMutex_);
+
+    if (!freeBuffers_.empty()) {
+        std::unique_ptr<WriteBuffer> buffer = std::move(freeBuffers_.back());
+        freeBuffers_.pop_back();
+        buffersInUse_++;
+        return buffer;
+    }
+
+    if (buffersAllocated_ >= config_.maxBuffers) {
+        bufferExhausted_++;
+        return nullptr;
+    }
+
+    auto buffer = std::make_unique<WriteBuffer>();
+    buffer->data.reserve(config_.bufferBytes);
+    buffersAllocated_++;
+    buffersInUse_++;
+    return buffer;
+}
+
+void SegmentWriter::releaseBuffer(std::unique_ptr<WriteBuffer> buffer) {
+    if (!buffer) {
+        return;
+    }
+
+    buffer->data.clear();
+
+    std::lock_guard<std::mutex> lock(bufferMutex_);
+    freeBuffers_.push_back(std::move(buffer));
+    buffersInUse_--;
+}
+
+uint64_t SegmentWriter::openSegment(const std::string& path) {
+    const uint64_t segmentId = nextSegmentId_++;
+
+    Request request;
+    request.type = RequestType::OPEN;
+    request.segmentId = segmentId;
+    request.path = path;
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        if (!running_.load() || stopRequested_) {
+            return 0;
+        }
+        requests_.push_back(std::move(request));
+    }
+    requestCv_.notify_one();
+
+    return segmentId;
+}
+
+void SegmentWriter::write(uint64_t segmentId, uint64_t offset, std::unique_ptr<WriteBuffer> buffer) {
+    if (!buffer) {
+        return;
+    }
+    if (buffer->data.empty()) {
+        releaseBuffer(std::move(buffer));
+        return;
+    }
+
+    Request request;
+    request.type = RequestType::WRITE;
+    request.segmentId = segmentId;
+    request.offset = offset;
+    request.buffer = std::move(buffer);
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        if (running_.load() && !stopRequested_) {
+            requests_.push_back(std::move(request));
+        }
+    }
+
+    if (request.buffer) {
+        // Not queued (stopped)
+        releaseBuffer(std::move(request.buffer));
+        return;
+    }
+    requestCv_.notify_one();
+}
+
+void SegmentWriter::closeSegment(uint64_t segmentId, uint64_t size, CloseCallback done) {
+    Request request;
+    request.type = RequestType::CLOSE;
+    request.segmentId = segmentId;
+    request.offset = size;
+    request.done = std::move(done);
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        if (!running_.load() || stopRequested_) {
+            return;
+        }
+        requests_.push_back(std::move(request));
+    }
+    requestCv_.notify_one();
+}
+
+SegmentWriter::Stats SegmentWriter::getStats() const {
+    Stats stats;
+    stats.backend = backendName_.load();
+    stats.segmentsOpened = segmentsOpened_.load();
+    stats.segmentsClosed = segmentsClosed_.load();
+    stats.openErrors = openErrors_.load();
+    stats.writesSubmitted = writesSubmitted_.load();
+    stats.writeErrors = writeErrors_.load();
+    stats.bytesWritten = bytesWritten_.load();
+    stats.bufferExhausted = bufferExhausted_.load();
+
+    {
+        std::lock_guard<std::mutex> lock(bufferMutex_);
+        stats.buffersAllocated = buffersAllocated_;
+        stats.buffersInUse = buffersInUse_;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(requestMutex_);
+        stats.pendingRequests = requests_.size();
+    }
+
+    return stats;
+}
+
+void SegmentWriter::ioLoop() {
+    std::deque<Request> batch;
+
+    while (true) {
+        bool stopping = false;
+        {
+            std::unique_lock<std::mutex> lock(requestMutex_);
+
+            // Only sleep on the condition variable when no write is outstanding;
+            // otherwise the backend wait below is what blocks
+            if (backend_->inFlight() == 0 && backlog_.empty()) {
+                requestCv_.wait(lock, [this]() { return stopRequested_ || !requests_.empty(); });
+            }
+
+            batch.swap(requests_);
+            stopping = stopRequested_;
+        }
+
+        for (Request& request : batch) {
+            handleRequest(request);
+        }
+        const bool idle = batch.empty();
+        batch.clear();
+
+        submitBacklog();
+        backend_->flush();
+
+        // Block for a completion only when there was nothing new to queue
+        completions_.clear();
+        backend_->reap(completions_, idle);
+        for (const IoCompletion& completion : completions_) {
+            handleCompletion(completion);
+        }
+
+        if (stopping && idle && backlog_.empty() && backend_->inFlight() == 0) {
+            std::lock_guard<std::mutex> lock(requestMutex_);
+            if (requests_.empty()) {
+                break;
+            }
+        }
+    }
+
+    // Segments that were never closed keep their reservation; the size the
+    // file reports is still exactly what was written
+    for (auto& entry : files_) {
+        closeSegmentFile(entry.second.handle);
+    }
+    files_.clear();
+}
+
+void SegmentWriter::handleRequest(Request& request) {
+    switch (request.type) {
+        case RequestType::OPEN: {
+            OpenFile file;
+            file.path = std::move(request.path);
+            file.handle = openSegmentFile(file.path, config_.preallocateBytes);
+
+            if (!isValidFile(file.handle)) {
+                file.failed = true;
+                openErrors_++;
+            } else if (!backend_->attach(file.handle)) {
+                std::cerr << "SegmentWriter: cannot attach " << file.path << " to " << backend_->name()
+                          << std::endl;
+                closeSegmentFile(file.handle);
+                file.handle = kInvalidFile;
+                file.failed = true;
+                openErrors_++;
+            } else {
+                segmentsOpened_++;
+            }
+
+            files_[request.segmentId] = std::move(file);
+            break;
+        }
+
+        case RequestType::WRITE: {
+            auto it = files_.find(request.segmentId);
+            if (it == files_.end() || it->second.failed) {
+                // Failed segment: nothing more lands on disk
+                writeErrors_++;
+                releaseBuffer(std::move(request.buffer));
+                break;
+            }
+
+            auto write = std::make_unique<PendingWrite>();
+            write->segmentId = request.segmentId;
+            write->offset = request.offset;
+            write->buffer = std::move(request.buffer);
+
+            it->second.pendingWrites++;
+            backlog_.push_back(std::move(write));
+            break;
+        }
+
+        case RequestType::CLOSE: {
+            auto it = files_.find(request.segmentId);
+            if (it == files_.end()) {
+                if (request.done) {
+                    SegmentResult result;
+                    result.segmentId = request.segmentId;
+                    request.done(result);
+                }
+                break;
+            }
+
+            it->second.closeRequested = true;
+            it->second.finalSize = request.offset;
+            it->second.done = std::move(request.done);
+            maybeFinalize(request.segmentId);
+            break;
+        }
+    }
+}
+
+void SegmentWriter::submitBacklog() {
+    while (!backlog_.empty()) {
+        PendingWrite& write = *backlog_.front();
+        const FileHandle handle = files_[write.segmentId].handle;
+        const std::vector<uint8_t>& data = write.buffer->data;
+
+        if (!backend_->submitWrite(handle, data.data() + write.written, data.size() - write.written,
+                                   write.offset + write.written, &write)) {
+            break;  // Queue full: retried after the next reap
+        }
+
+        writesSubmitted_++;
+        backlog_.front().release();  // Owned by the backend until its completion
+        backlog_.pop_front();
+    }
+}
+
+void SegmentWriter::handleCompletion(const IoCompletion& completion) {
+    std::unique_ptr<PendingWrite> write(static_cast<PendingWrite*>(completion.tag));
+
+    if (completion.result <= 0) {
+        const int error = completion.result < 0 ? static_cast<int>(-completion.result) : EIO;
+        std::cerr << "SegmentWriter: write failed for " << files_[write->segmentId].path
+                  << ": " << std::strerror(error) << std::endl;
+        finishWrite(std::move(write), false);
+        return;
+    }
+
+    write->written += static_cast<size_t>(completion.result);
+    bytesWritten_ += static_cast<uint64_t>(completion.result);
+
+    if (write->written < write->buffer->data.size()) {
+        // Short write: queue the rest ahead of everything else
+        backlog_.push_front(std::move(write));
+        return;
+    }
+
+    finishWrite(std::move(write), true);
+}
+
+void SegmentWriter::finishWrite(std::unique_ptr<PendingWrite> write, bool ok) {
+    const uint64_t segmentId = write->segmentId;
+    releaseBuffer(std::move(write->buffer));
+
+    OpenFile& file = files_[segmentId];
+    file.pendingWrites--;
+    if (!ok) {
+        file.failed = true;
+        writeErrors_++;
+    }
+
+    maybeFinalize(segmentId);
+}
+
+void SegmentWriter::maybeFinalize(uint64_t segmentId) {
+    auto it = files_.find(segmentId);
+    if (it == files_.end()) {
+        return;
+    }
+
+    OpenFile& file = it->second;
+    if (!file.closeRequested || file.pendingWrites > 0) {
+        return;
+    }
+
+    SegmentResult result;
+    result.segmentId = segmentId;
+    result.path = file.path;
+    result.ok = !file.failed;
+    result.bytes = result.ok ? file.finalSize : 0;
+
+    if (isValidFile(file.handle)) {
+        if (!finalizeSegmentFile(file.handle, file.finalSize, config_.syncOnClose)) {
+            std::cerr << "SegmentWriter: finalize failed for " << file.path << std::endl;
+            result.ok = false;
+        }
+    }
+
+    CloseCallback done = std::move(file.done);
+    files_.erase(it);
+    segmentsClosed_++;
+
+    if (done) {
+        done(result);
+    }
+}
+
+} // namespace recording
+} // namespace fluxvision
@@ -0,0 +1,176 @@
+// src/recording/segment_writer.h
+// Shared segment I/O engine: batched, asynchronous writes for every recorded camera
+#pragma once
+
+#include "segment_io.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace fluxvision {
+namespace recording {
+
+// Batch of muxed bytes destined for one segment file
+struct WriteBuffer {
+    std::vector<uint8_t> data;
+};
+
+// One I/O thread drives all segment files through an IoBackend
+//
+// Producers (recorder tap on the network threads) fill a WriteBuffer from the
+// shared pool and hand it over whole; they never touch a file descriptor or
+// wait for the disk. Opening, preallocating, writing and finalizing all
+// happen on the I/O thread, with up to Config::queueDepth writes in flight.
+// When the disk falls behind, the pool runs dry and acquireBuffer() returns
+// nullptr: the producer drops data instead of blocking.
+//
+// Thread-safety: all methods may be called from any thread.
+class SegmentWriter {
+public:
+    struct Config {
+        size_t bufferBytes = 512 * 1024;            // Batch size: one write per full buffer
+        size_t maxBuffers = 4096;                   // Pool cap across all cameras (memory bound)
+        size_t queueDepth = 256;                    // Writes in flight
+        uint64_t preallocateBytes = 64ULL * 1024 * 1024;  // Reserved per segment file
+        bool syncOnClose = false;                   // fdatasync/FlushFileBuffers finished segments
+        bool useAsyncIo = true;                     // io_uring / overlapped I/O when available
+    };
+
+    struct Stats {
+        const char* backend = "";                   // "io_uring", "overlapped" or "sync"
+        uint64_t segmentsOpened = 0;
+        uint64_t segmentsClosed = 0;
+        uint64_t openErrors = 0;
+        uint64_t writesSubmitted = 0;
+        uint64_t writeErrors = 0;
+        uint64_t bytesWritten = 0;
+        uint64_t bufferExhausted = 0;               // acquireBuffer() calls that found the pool empty
+        size_t buffersAllocated = 0;
+        size_t buffersInUse = 0;
+        size_t pendingRequests = 0;
+    };
+
+    // Finished segment, reported on the I/O thread
+    struct SegmentResult {
+        uint64_t segmentId = 0;
+        std::string path;
+        uint64_t bytes = 0;                         // Bytes on disk
+        bool ok = false;                            // Opened, every write landed, finalized
+    };
+    using CloseCallback = std::function<void(const SegmentResult&)>;
+
+    explicit SegmentWriter(const Config& config);
+    ~SegmentWriter();
+
+    // Delete copy/move
+    SegmentWriter(const SegmentWriter&) = delete;
+    SegmentWriter& operator=(const SegmentWriter&) = delete;
+
+    bool start();
+
+    // Finish all queued work (writes land, segments are finalized), then stop
+    void stop();
+
+    bool isRunning() const { return running_.load(); }
+
+    // Empty buffer with at least Config::bufferBytes capacity; nullptr if the pool is exhausted
+    std::unique_ptr<WriteBuffer> acquireBuffer();
+
+    // Give back a buffer that won't be written
+    void releaseBuffer(std::unique_ptr<WriteBuffer> buffer);
+
+    // Queue creation of a segment file; returns its id right away (0 if stopped)
+    uint64_t openSegment(const std::string& path);
+
+    // Queue a write at offset; the buffer returns to the pool once written
+    void write(uint64_t segmentId, uint64_t offset, std::unique_ptr<WriteBuffer> buffer);
+
+    // Queue finalization after all earlier writes of the segment; size is the
+    // total written. done (optional) runs on the I/O thread.
+    void closeSegment(uint64_t segmentId, uint64_t size, CloseCallback done = nullptr);
+
+    Stats getStats() const;
+
+private:
+    enum class RequestType { OPEN, WRITE, CLOSE };
+
+    struct Request {
+        RequestType type = RequestType::WRITE;
+        uint64_t segmentId = 0;
+        std::string path;                           // OPEN
+        uint64_t offset = 0;                        // WRITE: file offset; CLOSE: final size
+        std::unique_ptr<WriteBuffer> buffer;        // WRITE
+        CloseCallback done;                         // CLOSE
+    };
+
+    // A write handed to the backend (its completion tag)
+    struct PendingWrite {
+        uint64_t segmentId = 0;
+        uint64_t offset = 0;
+        size_t written = 0;                         // Short writes are resubmitted
+        std::unique_ptr<WriteBuffer> buffer;
+    };
+
+    // I/O thread only
+    struct OpenFile {
+        FileHandle handle = kInvalidFile;
+        std::string path;
+        size_t pendingWrites = 0;                   // Queued or in flight
+        bool failed = false;
+        bool closeRequested = false;
+        uint64_t finalSize = 0;
+        CloseCallback done;
+    };
+
+    Config config_;
+    std::unique_ptr<IoBackend> backend_;
+    std::atomic<const char*> backendName_{""};
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    // Requests from producers
+    mutable std::mutex requestMutex_;
+    std::condition_variable requestCv_;
+    std::deque<Request> requests_;
+    bool stopRequested_ = false;
+    std::atomic<uint64_t> nextSegmentId_{1};
+
+    // Buffer pool
+    mutable std::mutex bufferMutex_;
+    std::vector<std::unique_ptr<WriteBuffer>> freeBuffers_;
+    size_t buffersAllocated_ = 0;
+    size_t buffersInUse_ = 0;
+
+    // I/O thread state
+    std::unordered_map<uint64_t, OpenFile> files_;
+    std::deque<std::unique_ptr<PendingWrite>> backlog_;  // Waiting for a free queue slot
+    std::vector<IoCompletion> completions_;
+
+    // Statistics
+    std::atomic<uint64_t> segmentsOpened_{0};
+    std::atomic<uint64_t> segmentsClosed_{0};
+    std::atomic<uint64_t> openErrors_{0};
+    std::atomic<uint64_t> writesSubmitted_{0};
+    std::atomic<uint64_t> writeErrors_{0};
+    std::atomic<uint64_t> bytesWritten_{0};
+    std::atomic<uint64_t> bufferExhausted_{0};
+
+    void ioLoop();
+    void handleRequest(Request& request);
+    void submitBacklog();
+    void handleCompletion(const IoCompletion& completion);
+    void finishWrite(std::unique_ptr<PendingWrite> write, bool ok);
+    void maybeFinalize(uint64_t segmentId);
+};
+
+} // namespace recording
+} // namespace fluxvision
@@ -0,0 +1,275 @@
+// src/recording/ts_demuxer.cpp
+#include "ts_demuxer.h"
+#include "ts_muxer.h"
+#include "core/network/start_code_scanner.h"
+#include <algorithm>
+#include <cstring>
+
+namespace fluxvision {
+namespace recording {
+
+namespace {
+    constexpr size_t kPacketSize = TsMuxer::kPacketSize;
+    constexpr int64_t kPtsRange = 1LL << 33;
+
+    uint16_t packetPid(const uint8_t* p) {
+        return static_cast<uint16_t>(((p[1] & 0x1F) << 8) | p[2]);
+    }
+
+    bool payloadStart(const uint8_t* p) {
+        return (p[1] & 0x40) != 0;
+    }
+
+    bool randomAccess(const uint8_t* p) {
+        const bool hasAdaptation = (p[3] & 0x20) != 0;
+        return hasAdaptation && p[4] > 0 && (p[5] & 0x40) != 0;
+    }
+
+    // Offset of the payload within the packet (kPacketSize if it has none)
+    size_t payloadOffset(const uint8_t* p) {
+        const uint8_t control = (p[3] >> 4) & 0x03;
+        if ((control & 0x01) == 0) {
+            return kPacketSize;
+        }
+        size_t offset = 4;
+        if (control & 0x02) {
+            offset += 1 + p[4];
+        }
+        return offset < kPacketSize ? offset : kPacketSize;
+    }
+}
+
+TsDemuxer::TsDemuxer(CodecType codec)
+    : codec_(codec)
+{
+}
+
+void TsDemuxer::setInput(const uint8_t* data, size_t size, bool final) {
+    data_ = data;
+    size_ = size;
+    final_ = final;
+}
+
+void TsDemuxer::seek(uint64_t offset) {
+    position_ = offset;
+}
+
+void TsDemuxer::reset() {
+    position_ = 0;
+    pmtPid_ = kNoPid;
+    videoPid_ = kNoPid;
+    havePts_ = false;
+    lastPts_ = 0;
+}
+
+TsDemuxer::ReadStatus TsDemuxer::read(AccessUnit& unit, bool keyframesOnly) {
+    // Damaged PES packets are skipped
+    while (true) {
+        // Find the first packet of the next PES (a random access point if keyframesOnly)
+        size_t start = size_;
+        size_t pos = static_cast<size_t>(position_);
+        while (pos + kPacketSize <= size_) {
+            if (!syncAt(pos)) {
+                pos = resync(pos + 1);
+                continue;
+            }
+
+            const uint8_t* p = data_ + pos;
+            const uint16_t pid = packetPid(p);
+
+            if (payloadStart(p) && (pid == 0 || pid == pmtPid_)) {
+                parseTable(p);
+            } else if (pid == videoPid_ && payloadStart(p) && (!keyframesOnly || randomAccess(p))) {
+                start = pos;
+                break;
+            }
+            pos += kPacketSize;
+        }
+
+        if (start == size_) {
+            position_ = pos;
+            return final_ ? ReadStatus::END : ReadStatus::NEED_MORE;
+        }
+
+        // It ends where the next video PES starts
+        size_t end = size_;
+        size_t payloadBytes = 0;
+        pos = start;
+        while (pos + kPacketSize <= size_) {
+            if (!syncAt(pos)) {
+                pos = resync(pos + 1);
+                continue;
+            }
+
+            const uint8_t* p = data_ + pos;
+            if (packetPid(p) == videoPid_) {
+                if (payloadStart(p) && pos != start) {
+                    end = pos;
+                    break;
+                }
+                payloadBytes += kPacketSize - payloadOffset(p);
+            }
+            pos += kPacketSize;
+        }
+
+        if (end == size_ && !final_) {
+            position_ = start;  // Retry once more of the segment is on disk
+            return ReadStatus::NEED_MORE;
+        }
+
+        // Gather the PES packet (only this copy: it becomes the decoder's packet)
+        PacketBuffer pes = PacketBuffer::allocate(payloadBytes);
+        uint8_t* out = pes.mutableData();
+        size_t copied = 0;
+        for (pos = start; pos + kPacketSize <= end; ) {
+            if (!syncAt(pos)) {
+                pos = resync(pos + 1);
+                continue;
+            }
+
+            const uint8_t* p = data_ + pos;
+            if (packetPid(p) == videoPid_) {
+                const size_t offset = payloadOffset(p);
+                std::memcpy(out + copied, p + offset, kPacketSize - offset);
+                copied += kPacketSize - offset;
+            }
+            pos += kPacketSize;
+        }
+
+        const bool keyframe = randomAccess(data_ + start);
+        position_ = end;
+
+        // PES header: start code, stream id, length, flags, header length, PTS
+        const uint8_t* header = pes.data();
+        if (copied < 9 || header[0] != 0x00 || header[1] != 0x00 || header[2] != 0x01) {
+            continue;  // Damaged, skip it
+        }
+
+        const size_t headerSize = 9 + header[8];
+        if (headerSize > copied) {
+            continue;
+        }
+
+        if ((header[7] & 0x80) && headerSize >= 14) {
+            const uint64_t pts = (static_cast<uint64_t>(header[9] & 0x0E) << 29) |
+                                 (static_cast<uint64_t>(header[10]) << 22) |
+                                 (static_cast<uint64_t>(header[11] & 0xFE) << 14) |
+                                 (static_cast<uint64_t>(header[12]) << 7) |
+                                 (static_cast<uint64_t>(header[13]) >> 1);
+            unwrapPts(pts);
+        }
+
+        unit.data = pes.slice(headerSize, copied - headerSize);
+        unit.ptsUs = lastPts_ * 100 / 9;
+        unit.offset = start;
+        unit.isKeyframe = keyframe;
+        unit.isReference = true;
+        classify(unit);
+        return ReadStatus::OK;
+    }
+}
+
+bool TsDemuxer::syncAt(size_t offset) const {
+    return data_[offset] == 0x47;
+}
+
+size_t TsDemuxer::resync(size_t offset) const {
+    // A sync byte followed by another one a packet later
+    for (size_t i = offset; i + kPacketSize <= size_; ++i) {
+        if (data_[i] == 0x47 && (i + 2 * kPacketSize > size_ || data_[i + kPacketSize] == 0x47)) {
+            return i;
+        }
+    }
+    return size_;
+}
+
+void TsDemuxer::parseTable(const uint8_t* packet) {
+    const size_t offset = payloadOffset(packet);
+    if (offset + 1 >= kPacketSize) {
+        return;
+    }
+
+    const size_t sectionStart = offset + 1 + packet[offset];  // pointer_field
+    if (sectionStart + 12 > kPacketSize) {
+        return;
+    }
+
+    const uint8_t* section = packet + sectionStart;
+    const size_t sectionLength = ((section[1] & 0x0F) << 8) | section[2];
+    const size_t sectionEnd = std::min(sectionStart + 3 + sectionLength, kPacketSize) - sectionStart;
+    if (sectionEnd < 12 + 4) {
+        return;
+    }
+    const size_t loopEnd = sectionEnd - 4;  // CRC
+
+    if (section[0] == 0x00) {
+        // PAT: first real program
+        for (size_t i = 8; i + 4 <= loopEnd; i += 4) {
+            const uint16_t program = static_cast<uint16_t>((section[i] << 8) | section[i + 1]);
+            if (program != 0) {
+                pmtPid_ = static_cast<uint16_t>(((section[i + 2] & 0x1F) << 8) | section[i + 3]);
+                return;
+            }
+        }
+    } else if (section[0] == 0x02) {
+        // PMT: the H.264/H.265 elementary stream
+        const size_t programInfoLength = ((section[10] & 0x0F) << 8) | section[11];
+        for (size_t i = 12 + programInfoLength; i + 5 <= loopEnd; ) {
+            const uint8_t streamType = section[i];
+            const uint16_t pid = static_cast<uint16_t>(((section[i + 1] & 0x1F) << 8) | section[i + 2]);
+            const size_t infoLength = ((section[i + 3] & 0x0F) << 8) | section[i + 4];
+
+            if (streamType == 0x1B || streamType == 0x24) {
+                videoPid_ = pid;
+                return;
+            }
+            i += 5 + infoLength;
+        }
+    }
+}
+
+int64_t TsDemuxer::unwrapPts(uint64_t pts) {
+    int64_t value = static_cast<int64_t>(pts);
+    if (havePts_) {
+        // Nearest to the previous timestamp, modulo the 33-bit range
+        value += lastPts_ - (lastPts_ % kPtsRange);
+        if (value - lastPts_ > kPtsRange / 2) {
+            value -= kPtsRange;
+        } else if (lastPts_ - value > kPtsRange / 2) {
+            value += kPtsRange;
+        }
+    }
+
+    havePts_ = true;
+    lastPts_ = value;
+    return value;
+}
+
+void TsDemuxer::classify(AccessUnit& unit) const {
+    const uint8_t* end = unit.data.end();
+    const uint8_t* p = network::StartCodeScanner::findNext(unit.data.begin(), end);
+
+    // First slice decides; IDR/IRAP also marks a keyframe without the random access flag
+    while (p + 3 < end) {
+        const uint8_t header = p[3];
+        if (codec_ == CodecType::H265) {
+            const int type = (header >> 1) & 0x3F;
+            if (type < 32) {
+                unit.isKeyframe = unit.isKeyframe || (type >= 16 && type <= 23);
+                unit.isReference = !(type <= 14 && (type % 2) == 0);  // *_N sub-layer non-reference
+                return;
+            }
+        } else {
+            const int type = header & 0x1F;
+            if (type >= 1 && type <= 5) {
+                unit.isKeyframe = unit.isKeyframe || type == 5;
+                unit.isReference = ((header >> 5) & 0x03) != 0;
+                return;
+            }
+        }
+        p = network::StartCodeScanner::findNext(p + 3, end);
+    }
+}
+
+} // namespace recording
+} // namespace fluxvision
@@ -0,0 +1,76 @@
+// src/recording/ts_demuxer.h
+// MPEG-TS reader for recorded segments: PES packets back to Annex B access units
+#pragma once
+
+#include "core/codec/packet_buffer.h"
+#include "core/codec/types.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace fluxvision {
+namespace recording {
+
+// Counterpart of TsMuxer: walks a segment in memory and returns one access
+// unit per video PES packet
+//
+// The PID of the video stream is taken from the PMT; a PES packet ends where
+// the next one starts. In keyframe-only mode everything but random access
+// points is skipped by looking at TS headers only, without copying payloads,
+// which is what makes fast scrubbing cheap.
+//
+// Thread-safety: not thread-safe (one instance per playback).
+class TsDemuxer {
+public:
+    struct AccessUnit {
+        PacketBuffer data;                          // Annex B, start codes included
+        int64_t ptsUs = 0;                          // Unwrapped across the 33-bit rollover
+        bool isKeyframe = false;
+        bool isReference = true;
+        uint64_t offset = 0;                        // Offset of its first TS packet
+    };
+
+    enum class ReadStatus {
+        OK,
+        NEED_MORE,                                  // Last unit may still be growing (input not final)
+        END                                         // Input exhausted
+    };
+
+    explicit TsDemuxer(CodecType codec);
+
+    // Input to read from (not owned). final: no more bytes will be appended,
+    // so the last access unit ends at the end of data. The position is kept.
+    void setInput(const uint8_t* data, size_t size, bool final);
+
+    // Continue at offset (a TS packet boundary, e.g. a KeyframeLocation)
+    void seek(uint64_t offset);
+    uint64_t position() const { return position_; }
+
+    ReadStatus read(AccessUnit& unit, bool keyframesOnly);
+
+    // Forget timestamp history (new segment)
+    void reset();
+
+private:
+    static constexpr uint16_t kNoPid = 0xFFFF;
+
+    CodecType codec_;
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool final_ = false;
+    uint64_t position_ = 0;
+
+    uint16_t pmtPid_ = kNoPid;
+    uint16_t videoPid_ = kNoPid;
+
+    bool havePts_ = false;
+    int64_t lastPts_ = 0;                           // 90 kHz, unwrapped
+
+    bool syncAt(size_t offset) const;
+    size_t resync(size_t offset) const;
+    void parseTable(const uint8_t* packet);
+    int64_t unwrapPts(uint64_t pts);
+    void classify(AccessUnit& unit) const;
+};
+
+} // namespace recording
+} // namespace fluxvision
@@ -0,0 +1,294 @@
+// src/recording/ts_muxer.cpp
+#include "ts_muxer.h"
+#include "core/network/start_code_scanner.h"
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace fluxvision {
+namespace recording {
+
+namespace {
+    constexpr uint16_t kPatPid = 0x0000;
+    constexpr uint16_t kPmtPid = 0x1000;
+    constexpr uint16_t kVideoPid = 0x0100;
+    constexpr uint8_t kStreamTypeH264 = 0x1B;
+    constexpr uint8_t kStreamTypeH265 = 0x24;
+
+    constexpr size_t kTsPayloadSize = TsMuxer::kPacketSize - 4;
+    constexpr size_t kPcrFieldSize = 8;            // Adaptation length, flags, 6-byte PCR
+    constexpr size_t kPesHeaderSize = 14;          // Start code .. 5-byte PTS
+    constexpr uint64_t kTimestampMask = (1ULL << 33) - 1;
+    constexpr uint64_t kPcrLead = 9000;            // PCR runs 100 ms ahead of PTS (90 kHz)
+
+    // Access unit delimiters (primary_pic_type: any)
+    constexpr uint8_t kAudH264[] = {0x00, 0x00, 0x00, 0x01, 0x09, 0xF0};
+    constexpr uint8_t kAudH265[] = {0x00, 0x00, 0x00, 0x01, 0x46, 0x01, 0x50};
+
+    // CRC-32/MPEG-2 (poly 0x04C11DB7, no reflection, no final xor)
+    uint32_t crc32Mpeg(const uint8_t* data, size_t size) {
+        uint32_t crc = 0xFFFFFFFF;
+        for (size_t i = 0; i < size; ++i) {
+            crc ^= static_cast<uint32_t>(data[i]) << 24;
+            for (int bit = 0; bit < 8; ++bit) {
+                crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+            }
+        }
+        return crc;
+    }
+
+    void putCrc(uint8_t* section, size_t size) {
+        const uint32_t crc = crc32Mpeg(section, size);
+        section[size + 0] = static_cast<uint8_t>(crc >> 24);
+        section[size + 1] = static_cast<uint8_t>(crc >> 16);
+        section[size + 2] = static_cast<uint8_t>(crc >> 8);
+        section[size + 3] = static_cast<uint8_t>(crc);
+    }
+
+    void putTimestamp(uint8_t* p, uint8_t prefix, uint64_t ts) {
+        p[0] = static_cast<uint8_t>((prefix << 4) | ((ts >> 29) & 0x0E) | 0x01);
+        p[1] = static_cast<uint8_t>(ts >> 22);
+        p[2] = static_cast<uint8_t>(((ts >> 14) & 0xFE) | 0x01);
+        p[3] = static_cast<uint8_t>(ts >> 7);
+        p[4] = static_cast<uint8_t>(((ts << 1) & 0xFE) | 0x01);
+    }
+
+    // Timestamp unit check: media time against wall time over this long
+    constexpr int64_t kUnitCheckSpanUs = 2000000;
+    constexpr double kMinRate = 0.25;   // 90 kHz ticks passed as us advance at 0.09x
+    constexpr double kMaxRate = 8.0;
+
+    int64_t steadyClockUs() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    uint64_t to90kHz(int64_t timestampUs) {
+        return static_cast<uint64_t>(timestampUs * 9 / 100) & kTimestampMask;
+    }
+}
+
+TsMuxer::TsMuxer(CodecType codec)
+    : codec_(codec)
+{
+}
+
+void TsMuxer::setParameterSets(const uint8_t* data, size_t size) {
+    parameterSets_.assign(data, data + size);
+}
+
+void TsMuxer::checkTimestampUnit(int64_t timestampUs) {
+    if (unitChecked_) {
+        return;
+    }
+
+    const int64_t now = steadyClockUs();
+    if (unitCheckWallUs_ == 0) {
+        unitCheckWallUs_ = now;
+        unitCheckMediaUs_ = timestampUs;
+        return;
+    }
+
+    const int64_t wallUs = now - unitCheckWallUs_;
+    if (wallUs < kUnitCheckSpanUs) {
+        return;
+    }
+
+    // Once per muxer: a source in the wrong unit is wrong from its first frame
+    unitChecked_ = true;
+    const double rate = static_cast<double>(timestampUs - unitCheckMediaUs_) / static_cast<double>(wallUs);
+    if (rate < kMinRate || rate > kMaxRate) {
+        std::cerr << "TsMuxer: timestamps advance " << rate
+                  << "x wall time, source is not stamping in microseconds" << std::endl;
+        assert(!"TsMuxer: access unit timestamps must be microseconds");
+    }
+}
+
+void TsMuxer::reset() {
+    patContinuity_ = 0;
+    pmtContinuity_ = 0;
+    videoContinuity_ = 0;
+}
+
+size_t TsMuxer::maxOutputSize(size_t size) const {
+    const size_t pesBytes = kPesHeaderSize + sizeof(kAudH265) + parameterSets_.size() + size;
+    const size_t packets = 2 +                                          // PAT + PMT
+                           pesBytes / (kTsPayloadSize - kPcrFieldSize) + 1;
+    return packets * kPacketSize;
+}
+
+void TsMuxer::writeAccessUnit(const uint8_t* data, size_t size, int64_t timestampUs,
+                              bool keyframe, std::vector<uint8_t>& out) {
+    if (keyframe) {
+        checkTimestampUnit(timestampUs);
+        writeTables(out);
+    }
+
+    const uint64_t pts = to90kHz(timestampUs);
+    const uint64_t pcr = (pts - kPcrLead) & kTimestampMask;
+
+    // PES header: PTS only, unbounded length (allowed for video)
+    uint8_t pesHeader[kPesHeaderSize] = {0x00, 0x00, 0x01, 0xE0, 0x00, 0x00, 0x84, 0x80, 0x05};
+    putTimestamp(pesHeader + 9, 0x2, pts);
+
+    // Gathered payload: header, optional AUD and parameter sets, the access unit
+    Span spans[4];
+    size_t spanCount = 0;
+    spans[spanCount++] = {pesHeader, sizeof(pesHeader)};
+
+    if (!hasAccessUnitDelimiter(data, size)) {
+        if (codec_ == CodecType::H265) {
+            spans[spanCount++] = {kAudH265, sizeof(kAudH265)};
+        } else {
+            spans[spanCount++] = {kAudH264, sizeof(kAudH264)};
+        }
+    }
+
+    if (keyframe && !parameterSets_.empty() && !hasParameterSets(data, size)) {
+        spans[spanCount++] = {parameterSets_.data(), parameterSets_.size()};
+    }
+
+    spans[spanCount++] = {data, size};
+
+    size_t remaining = 0;
+    for (size_t i = 0; i < spanCount; ++i) {
+        remaining += spans[i].size;
+    }
+
+    size_t span = 0;
+    size_t spanOffset = 0;
+    bool first = true;
+
+    while (remaining > 0) {
+        // First packet: PCR (and random access flag); last: stuffing up to 188 bytes
+        const size_t minAdaptation = first ? kPcrFieldSize : 0;
+        const size_t payload = std::min(remaining, kTsPayloadSize - minAdaptation);
+        const size_t adaptation = kTsPayloadSize - payload;
+
+        const size_t start = out.size();
+        out.resize(start + kPacketSize);
+        uint8_t* p = out.data() + start;
+
+        p[0] = 0x47;
+        p[1] = static_cast<uint8_t>((first ? 0x40 : 0x00) | ((kVideoPid >> 8) & 0x1F));
+        p[2] = static_cast<uint8_t>(kVideoPid & 0xFF);
+        p[3] = static_cast<uint8_t>((adaptation > 0 ? 0x30 : 0x10) | (videoContinuity_ & 0x0F));
+        videoContinuity_ = (videoContinuity_ + 1) & 0x0F;
+
+        uint8_t* q = p + 4;
+        if (adaptation > 0) {
+            q[0] = static_cast<uint8_t>(adaptation - 1);
+            if (adaptation > 1) {
+                q[1] = 0x00;
+                size_t used = 2;
+                if (first) {
+                    q[1] = static_cast<uint8_t>(0x10 | (keyframe ? 0x40 : 0x00));
+                    q[2] = static_cast<uint8_t>(pcr >> 25);
+                    q[3] = static_cast<uint8_t>(pcr >> 17);
+                    q[4] = static_cast<uint8_t>(pcr >> 9);
+                    q[5] = static_cast<uint8_t>(pcr >> 1);
+                    q[6] = static_cast<uint8_t>(((pcr & 0x1) << 7) | 0x7E);
+                    q[7] = 0x00;
+                    used = kPcrFieldSize;
+                }
+                std::memset(q + used, 0xFF, adaptation - used);
+            }
+            q += adaptation;
+        }
+
+        // Copy payload from the gather list
+        size_t copied = 0;
+        while (copied < payload) {
+            const size_t n = std::min(payload - copied, spans[span].size - spanOffset);
+            std::memcpy(q + copied, spans[span].data + spanOffset, n);
+            copied += n;
+            spanOffset += n;
+            if (spanOffset == spans[span].size) {
+                span++;
+                spanOffset = 0;
+            }
+        }
+
+        remaining -= payload;
+        first = false;
+    }
+}
+
+void TsMuxer::writeTables(std::vector<uint8_t>& out) {
+    // PAT: program 1 -> PMT
+    uint8_t pat[16] = {
+        0x00, 0xB0, 0x0D,                 // table_id, section_length = 13
+        0x00, 0x01, 0xC1, 0x00, 0x00,     // transport_stream_id 1, version 0, current
+        0x00, 0x01,                       // program_number 1
+        static_cast<uint8_t>(0xE0 | (kPmtPid >> 8)), static_cast<uint8_t>(kPmtPid & 0xFF)
+    };
+    putCrc(pat, 12);
+    writeSection(kPatPid, patContinuity_, pat, sizeof(pat), out);
+
+    // PMT: one video stream, which also carries the PCR
+    const uint8_t streamType = codec_ == CodecType::H265 ? kStreamTypeH265 : kStreamTypeH264;
+    uint8_t pmt[22] = {
+        0x02, 0xB0, 0x12,                 // table_id, section_length = 18
+        0x00, 0x01, 0xC1, 0x00, 0x00,     // program_number 1, version 0, current
+        static_cast<uint8_t>(0xE0 | (kVideoPid >> 8)), static_cast<uint8_t>(kVideoPid & 0xFF),
+        0xF0, 0x00,                       // program_info_length 0
+        streamType,
+        static_cast<uint8_t>(0xE0 | (kVideoPid >> 8)), static_cast<uint8_t>(kVideoPid & 0xFF),
+        0xF0, 0x00                        // ES_info_length 0
+    };
+    putCrc(pmt, 17);
+    writeSection(kPmtPid, pmtContinuity_, pmt, 21, out);
+}
+
+void TsMuxer::writeSection(uint16_t pid, uint8_t& continuity, const uint8_t* section, size_t size,
+                           std::vector<uint8_t>& out) {
+    const size_t start = out.size();
+    out.resize(start + kPacketSize, 0xFF);
+    uint8_t* p = out.data() + start;
+
+    p[0] = 0x47;
+    p[1] = static_cast<uint8_t>(0x40 | ((pid >> 8) & 0x1F));
+    p[2] = static_cast<uint8_t>(pid & 0xFF);
+    p[3] = static_cast<uint8_t>(0x10 | (continuity & 0x0F));
+    p[4] = 0x00;  // pointer_field
+    std::memcpy(p + 5, section, size);
+
+    continuity = (continuity + 1) & 0x0F;
+}
+
+bool TsMuxer::hasAccessUnitDelimiter(const uint8_t* data, size_t size) const {
+    const size_t prefix = network::StartCodeScanner::prefixLength(data, size);
+    if (prefix == 0 || prefix >= size) {
+        return false;
+    }
+
+    const uint8_t header = data[prefix];
+    return codec_ == CodecType::H265 ? ((header >> 1) & 0x3F) == 35 : (header & 0x1F) == 9;
+}
+
+bool TsMuxer::hasParameterSets(const uint8_t* data, size_t size) const {
+    const uint8_t* end = data + size;
+    const uint8_t* p = network::StartCodeScanner::findNext(data, end);
+
+    // Parameter sets lead the access unit: stop at the first slice
+    while (p + 3 < end) {
+        const uint8_t header = p[3];
+        if (codec_ == CodecType::H265) {
+            const int type = (header >> 1) & 0x3F;
+            if (type == 33) return true;   // SPS
+            if (type < 32) return false;   // VCL
+        } else {
+            const int type = header & 0x1F;
+            if (type == 7) return true;    // SPS
+            if (type >= 1 && type <= 5) return false;
+        }
+        p = network::StartCodeScanner::findNext(p + 3, end);
+    }
+
+    return false;
+}
+
+} // namespace recording
+} // namespace fluxvision
@@ -0,0 +1,71 @@
+// src/recording/ts_muxer.h
+// MPEG-TS remuxer: wraps Annex B access units in PES/TS packets, no decode
+#pragma once
+
+#include "core/codec/types.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace fluxvision {
+namespace recording {
+
+// Single-program transport stream writer for one H.264/H.265 camera
+//
+// Each access unit becomes one PES packet (PTS only: cameras don't send
+// B-frames), split into 188-byte TS packets. Every keyframe is preceded by
+// PAT/PMT and carries the PCR and random_access_indicator, so each segment
+// (which starts at a keyframe) plays on its own and can be cut at any IDR.
+// Keyframes that don't carry their own SPS get the stored parameter sets
+// prepended, for cameras that only announce them in the SDP.
+//
+// Output is appended to a caller-owned buffer; nothing else is allocated.
+// Thread-safety: not thread-safe (one instance per camera).
+class TsMuxer {
+public:
+    static constexpr size_t kPacketSize = 188;
+
+    explicit TsMuxer(CodecType codec);
+
+    // Annex B parameter sets (VPS/SPS/PPS) to repeat on keyframes that lack them
+    void setParameterSets(const uint8_t* data, size_t size);
+
+    // Append one access unit (Annex B, start codes included). timestampUs is in
+    // microseconds; a source that advances far off wall time is reported (and
+    // asserted in debug builds) once per muxer
+    void writeAccessUnit(const uint8_t* data, size_t size, int64_t timestampUs,
+                         bool keyframe, std::vector<uint8_t>& out);
+
+    // Upper bound of what writeAccessUnit() appends for an access unit of size bytes
+    size_t maxOutputSize(size_t size) const;
+
+    // Restart continuity counters (new segment file)
+    void reset();
+
+private:
+    struct Span {
+        const uint8_t* data;
+        size_t size;
+    };
+
+    CodecType codec_;
+    std::vector<uint8_t> parameterSets_;
+    uint8_t patContinuity_ = 0;
+    uint8_t pmtContinuity_ = 0;
+    uint8_t videoContinuity_ = 0;
+
+    // First keyframe seen by the unit check (wall 0 = none yet)
+    int64_t unitCheckWallUs_ = 0;
+    int64_t unitCheckMediaUs_ = 0;
+    bool unitChecked_ = false;
+
+    void checkTimestampUnit(int64_t timestampUs);
+    void writeTables(std::vector<uint8_t>& out);
+    void writeSection(uint16_t pid, uint8_t& continuity, const uint8_t* section, size_t size,
+                      std::vector<uint8_t>& out);
+    bool hasAccessUnitDelimiter(const uint8_t* data, size_t size) const;
+    bool hasParameterSets(const uint8_t* data, size_t size) const;
+};
+
+} // namespace recording
+} // namespace fluxvision
@@ -0,0 +1,230 @@
+// tests/work_stealing_test.cpp
+// Stress test for the Chase-Lev deque and the Vyukov injection queue: every
+// item pushed must come out exactly once, whatever the interleaving
+#include "core/threading/work_stealing_deque.h"
+#include "core/threading/injection_queue.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using fluxvision::threading::InjectionQueue;
+using fluxvision::threading::WorkStealingDeque;
+
+namespace {
+    int failures = 0;
+}
+
+#define CHECK(condition)                                                      \
+    do {                                                                      \
+        if (!(condition)) {                                                   \
+            std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__,       \
+                         __LINE__, #condition);                               \
+            ++failures;                                                       \
+        }                                                                     \
+    } while (0)
+
+namespace {
+    // Each of 1..count seen exactly once across all consumers
+    bool exactlyOnce(const std::vector<std::vector<uint32_t>>& taken, uint32_t count) {
+        std::vector<uint8_t> seen(count + 1, 0);
+        size_t total = 0;
+        for (const auto& items : taken) {
+            for (uint32_t item : items) {
+                if (item == 0 || item > count || seen[item]++) {
+                    std::fprintf(stderr, "item %u out of range or taken twice\n", item);
+                    return false;
+                }
+            }
+            total += items.size();
+        }
+        if (total != count) {
+            std::fprintf(stderr, "%zu of %u items taken\n", total, count);
+            return false;
+        }
+        return true;
+    }
+
+    // Owner: push all, popping now and then; thieves steal until the owner is done
+    // and the deque is drained. maxOutstanding > 0 keeps the deque below its
+    // capacity, so indices wrap the same array instead of growing it.
+    void ownerAgainstThieves(size_t initialCapacity, uint32_t count, int thieves, size_t maxOutstanding) {
+        WorkStealingDeque<uint32_t> deque(initialCapacity);
+        std::vector<std::vector<uint32_t>> taken(static_cast<size_t>(thieves) + 1);
+        std::atomic<bool> ownerDone{false};
+
+        std::vector<std::thread> threads;
+        for (int i = 0; i < thieves; ++i) {
+            threads.emplace_back([&deque, &ownerDone, &items = taken[static_cast<size_t>(i) + 1]]() {
+                uint32_t item = 0;
+                while (true) {
+                    if (deque.steal(item)) {
+                        items.push_back(item);
+                    } else if (ownerDone.load(std::memory_order_acquire) && deque.empty()) {
+                        break;
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+
+        auto& ownerItems = taken[0];
+        uint32_t item = 0;
+        for (uint32_t next = 1; next <= count; ++next) {
+            while (maxOutstanding > 0 && deque.size() >= maxOutstanding) {
+                if (deque.pop(item)) {
+                    ownerItems.push_back(item);
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+
+            deque.push(next);
+            if (next % 3 == 0 && deque.pop(item)) {
+                ownerItems.push_back(item);
+            }
+        }
+        while (deque.pop(item)) {
+            ownerItems.push_back(item);
+        }
+        ownerDone.store(true, std::memory_order_release);
+
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        CHECK(deque.empty());
+        CHECK(exactlyOnce(taken, count));
+    }
+
+    void testDequeOrder() {
+        // Owner end is LIFO, thief end FIFO, across several grows from capacity 4
+        WorkStealingDeque<uint32_t> deque(4);
+        for (uint32_t i = 1; i <= 1000; ++i) {
+            deque.push(i);
+        }
+        CHECK(deque.size() == 1000);
+
+        uint32_t item = 0;
+        for (uint32_t i = 1; i <= 500; ++i) {
+            CHECK(deque.steal(item) && item == i);
+        }
+        for (uint32_t i = 1000; i > 500; --i) {
+            CHECK(deque.pop(item) && item == i);
+        }
+        CHECK(!deque.pop(item));
+        CHECK(!deque.steal(item));
+        CHECK(deque.empty());
+    }
+
+    void testDequeWraparound() {
+        // Indices run far past capacity 8 while never holding more than 8
+        WorkStealingDeque<uint32_t> deque(8);
+        uint32_t next = 1;
+        uint32_t item = 0;
+        for (int cycle = 0; cycle < 10000; ++cycle) {
+            const uint32_t first = next;
+            for (int i = 0; i < 8; ++i) {
+                deque.push(next++);
+            }
+            for (int i = 0; i < 4; ++i) {
+                CHECK(deque.steal(item) && item == first + i);
+            }
+            for (uint32_t i = next - 1; i >= first + 4; --i) {
+                CHECK(deque.pop(item) && item == i);
+            }
+        }
+        CHECK(deque.empty());
+    }
+
+    void testInjectionQueueBounds() {
+        InjectionQueue<uint32_t> queue(16);
+        CHECK(queue.capacity() == 16);
+
+        uint32_t item = 0;
+        for (int round = 0; round < 1000; ++round) {
+            for (uint32_t i = 0; i < 16; ++i) {
+                CHECK(queue.push(i));
+            }
+            CHECK(!queue.push(99));  // Full
+            for (uint32_t i = 0; i < 16; ++i) {
+                CHECK(queue.pop(item) && item == i);
+            }
+            CHECK(!queue.pop(item));  // Empty
+        }
+    }
+
+    // Several producers into a small queue (full most of the time), several consumers
+    void testInjectionQueueMpmc(int producers, int consumers, uint32_t perProducer) {
+        InjectionQueue<uint32_t> queue(64);
+        const uint32_t count = static_cast<uint32_t>(producers) * perProducer;
+        std::vector<std::vector<uint32_t>> taken(static_cast<size_t>(consumers));
+        std::atomic<uint32_t> consumed{0};
+
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, p, perProducer]() {
+                // Items p*perProducer+1 .. (p+1)*perProducer, in order
+                for (uint32_t i = 1; i <= perProducer; ++i) {
+                    while (!queue.push(static_cast<uint32_t>(p) * perProducer + i)) {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&queue, &consumed, count, &items = taken[static_cast<size_t>(c)]]() {
+                uint32_t item = 0;
+                while (consumed.load(std::memory_order_relaxed) < count) {
+                    if (queue.pop(item)) {
+                        items.push_back(item);
+                        consumed.fetch_add(1, std::memory_order_relaxed);
+                    } else {
+                        std::this_thread::yield();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        CHECK(exactlyOnce(taken, count));
+
+        // FIFO: each consumer sees every producer's items in push order
+        for (const auto& items : taken) {
+            std::vector<uint32_t> last(static_cast<size_t>(producers), 0);
+            for (uint32_t item : items) {
+                const size_t producer = (item - 1) / perProducer;
+                CHECK(item > last[producer]);
+                last[producer] = item;
+            }
+        }
+    }
+}
+
+int main() {
+    testDequeOrder();
+    testDequeWraparound();
+
+    // Grows from 16 while thieves read the old arrays
+    ownerAgainstThieves(16, 500000, 4, 0);
+    // Same array throughout: indices wrap capacity 64 thousands of times
+    ownerAgainstThieves(64, 500000, 4, 48);
+    // Last-item races: the deque holds one or two items at a time
+    ownerAgainstThieves(4, 200000, 3, 2);
+
+    testInjectionQueueBounds();
+    testInjectionQueueMpmc(4, 4, 100000);
+    testInjectionQueueMpmc(1, 6, 200000);
+    testInjectionQueueMpmc(6, 1, 50000);
+
+    if (failures > 0) {
+        std::fprintf(stderr, "work_stealing_test: %d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("work_stealing_test: passed\n");
+    return 0;
+}
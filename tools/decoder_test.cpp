@@ -28,6 +28,7 @@ void printCapabilities() {
     std::cout << "NVDEC Available:     " << (caps.nvdecAvailable ? "YES" : "NO") << std::endl;
     std::cout << "CPU Decoder:         " << (caps.cpuDecoderAvailable ? "YES" : "NO") << std::endl;
     std::cout << "CUDA Devices:        " << caps.cudaDeviceCount << std::endl;
+    std::cout << "CPU Offload:         " << caps.cpuHwAccel << std::endl;
     std::cout << "Recommended:         " << caps.recommendedDecoder << std::endl;
     std::cout << "========================================\n" << std::endl;
 }
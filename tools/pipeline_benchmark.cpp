@@ -0,0 +1,977 @@
+// tools/pipeline_benchmark.cpp
+// Reproducible pipeline benchmark: recorded Annex B bitstreams replayed as synthetic cameras
+//
+// Each run builds a fresh StreamPipeline, adds N cameras that all replay the
+// input files (FileReplaySource, looped), lets them settle, then measures
+// a fixed window from the cameras' own counters. --find-max ramps the camera
+// count per quality tier until the pipeline stops keeping up. Results go to a
+// JSON file so releases can be compared run against run.
+#include "core/stream/pipeline.h"
+#include "core/network/access_unit_assembler.h"
+#include "core/network/bitstream_parser.h"
+#include "core/network/h264_parser.h"
+#include "core/network/hevc_parser.h"
+#include "core/network/stream_source.h"
+#include "core/threading/bounded_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+using namespace fluxvision;
+
+namespace {
+
+struct BenchConfig {
+    std::vector<std::string> inputs;
+    size_t cameras = 16;
+    std::vector<stream::StreamQuality> qualities = {stream::StreamQuality::GRID_VIEW};
+    double replayRate = 1.0;         // 1 = real time, 0 = as fast as the pipeline takes it
+    int durationSeconds = 20;        // Measurement window per run
+    int warmupSeconds = 5;           // Connect, first IDR, decoder start before measuring
+    DecoderType decoder = DecoderType::AUTO;
+    bool allDevices = false;
+
+    // Camera-count ramp
+    bool findMax = false;
+    size_t step = 8;
+    size_t maxCameras = 512;
+    double maxDropRatio = 0.01;      // Queue drops per received access unit
+    double maxP99Ms = 500.0;         // Receive-to-deliver p99
+
+    // Microbenchmarks
+    bool micro = false;
+    bool microOnly = false;
+
+    std::string jsonPath;
+};
+
+const char* qualityName(stream::StreamQuality quality) {
+    switch (quality) {
+        case stream::StreamQuality::PAUSED:     return "PAUSED";
+        case stream::StreamQuality::THUMBNAIL:  return "THUMBNAIL";
+        case stream::StreamQuality::GRID_VIEW:  return "GRID_VIEW";
+        case stream::StreamQuality::FOCUSED:    return "FOCUSED";
+        case stream::StreamQuality::FULLSCREEN: return "FULLSCREEN";
+    }
+    return "UNKNOWN";
+}
+
+bool parseQuality(const std::string& name, stream::StreamQuality& quality) {
+    const stream::StreamQuality tiers[] = {stream::StreamQuality::THUMBNAIL, stream::StreamQuality::GRID_VIEW,
+                                   stream::StreamQuality::FOCUSED, stream::StreamQuality::FULLSCREEN};
+    for (stream::StreamQuality tier : tiers) {
+        if (name == qualityName(tier)) {
+            quality = tier;
+            return true;
+        }
+    }
+    return false;
+}
+
+void printUsage(const char* programName) {
+    std::cout << "Usage: " << programName << " --input <file.h264|file.h265> [options]" << std::endl;
+    std::cout << "\nOptions:" << std::endl;
+    std::cout << "  --input <file>        Annex B bitstream to replay (repeat for several; cameras cycle)" << std::endl;
+    std::cout << "  --cameras <n>         Cameras per run (default: 16)" << std::endl;
+    std::cout << "  --quality <tier|all>  THUMBNAIL, GRID_VIEW, FOCUSED, FULLSCREEN or all (default: GRID_VIEW)" << std::endl;
+    std::cout << "  --rate <x>            Replay speed, 1 = real time, 0 = as fast as possible (default: 1)" << std::endl;
+    std::cout << "  --duration <seconds>  Measurement window per run (default: 20)" << std::endl;
+    std::cout << "  --warmup <seconds>    Settle time before measuring (default: 5)" << std::endl;
+    std::cout << "  --decoder <type>      auto, nvdec or cpu (default: auto)" << std::endl;
+    std::cout << "  --all-gpus            Decode on every CUDA device" << std::endl;
+    std::cout << "  --find-max            Ramp cameras per tier until the pipeline falls behind" << std::endl;
+    std::cout << "  --step <n>            Cameras added per ramp step (default: 8)" << std::endl;
+    std::cout << "  --max-cameras <n>     Ramp limit (default: 512)" << std::endl;
+    std::cout << "  --max-drop <ratio>    Ramp: tolerated queue drops per access unit (default: 0.01)" << std::endl;
+    std::cout << "  --max-p99 <ms>        Ramp: tolerated receive-to-deliver p99 (default: 500)" << std::endl;
+    std::cout << "  --micro               Also run the parser and queue microbenchmarks" << std::endl;
+    std::cout << "  --micro-only          Only run the microbenchmarks" << std::endl;
+    std::cout << "  --json <path>         Write results as JSON" << std::endl;
+    std::cout << "  --help                Show this help" << std::endl;
+
+    std::cout << "\nExamples:" << std::endl;
+    std::cout << "  " << programName << " --input lobby_1080p.h264 --cameras 64 --quality all --json out.json" << std::endl;
+    std::cout << "  " << programName << " --input lobby_1080p.h264 --find-max --quality GRID_VIEW" << std::endl;
+    std::cout << "  " << programName << " --input lobby_1080p.h264 --micro-only" << std::endl;
+}
+
+bool parseArgs(int argc, char** argv, BenchConfig& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        const bool hasValue = i + 1 < argc;
+
+        if (arg == "--help" || arg == "-h") {
+            printUsage(argv[0]);
+            return false;
+        }
+        else if (arg == "--input" && hasValue) {
+            config.inputs.push_back(argv[++i]);
+        }
+        else if (arg == "--cameras" && hasValue) {
+            config.cameras = std::stoul(argv[++i]);
+        }
+        else if (arg == "--quality" && hasValue) {
+            const std::string name = argv[++i];
+            config.qualities.clear();
+            if (name == "all") {
+                config.qualities = {stream::StreamQuality::THUMBNAIL, stream::StreamQuality::GRID_VIEW,
+                                    stream::StreamQuality::FOCUSED, stream::StreamQuality::FULLSCREEN};
+            } else {
+                stream::StreamQuality quality;
+                if (!parseQuality(name, quality)) {
+                    std::cerr << "Error: unknown quality " << name << std::endl;
+                    return false;
+                }
+                config.qualities.push_back(quality);
+            }
+        }
+        else if (arg == "--rate" && hasValue) {
+            config.replayRate = std::stod(argv[++i]);
+        }
+        else if (arg == "--duration" && hasValue) {
+            config.durationSeconds = std::stoi(argv[++i]);
+        }
+        else if (arg == "--warmup" && hasValue) {
+            config.warmupSeconds = std::stoi(argv[++i]);
+        }
+        else if (arg == "--decoder" && hasValue) {
+            const std::string name = argv[++i];
+            if (name == "nvdec") {
+                config.decoder = DecoderType::NVDEC;
+            } else if (name == "cpu") {
+                config.decoder = DecoderType::CPU;
+            } else {
+                config.decoder = DecoderType::AUTO;
+            }
+        }
+        else if (arg == "--all-gpus") {
+            config.allDevices = true;
+        }
+        else if (arg == "--find-max") {
+            config.findMax = true;
+        }
+        else if (arg == "--step" && hasValue) {
+            config.step = std::max<size_t>(1, std::stoul(argv[++i]));
+        }
+        else if (arg == "--max-cameras" && hasValue) {
+            config.maxCameras = std::stoul(argv[++i]);
+        }
+        else if (arg == "--max-drop" && hasValue) {
+            config.maxDropRatio = std::stod(argv[++i]);
+        }
+        else if (arg == "--max-p99" && hasValue) {
+            config.maxP99Ms = std::stod(argv[++i]);
+        }
+        else if (arg == "--micro") {
+            config.micro = true;
+        }
+        else if (arg == "--micro-only") {
+            config.micro = true;
+            config.microOnly = true;
+        }
+        else if (arg == "--json" && hasValue) {
+            config.jsonPath = argv[++i];
+        }
+        else {
+            std::cerr << "Unknown option: " << arg << std::endl;
+            printUsage(argv[0]);
+            return false;
+        }
+    }
+
+    if (config.inputs.empty()) {
+        std::cerr << "Error: at least one --input file required" << std::endl;
+        printUsage(argv[0]);
+        return false;
+    }
+
+    if (config.findMax && config.replayRate <= 0.0) {
+        std::cerr << "Error: --find-max needs a real-time replay (--rate > 0)" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+// ============================================================================
+// Measurement helpers
+// ============================================================================
+
+using Clock = std::chrono::steady_clock;
+
+double secondsSince(Clock::time_point start) {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// User + system CPU time of the whole process, in seconds
+double processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) {
+        return 0.0;
+    }
+    auto seconds = [](const FILETIME& time) {
+        ULARGE_INTEGER value;
+        value.LowPart = time.dwLowDateTime;
+        value.HighPart = time.dwHighDateTime;
+        return static_cast<double>(value.QuadPart) / 1e7;   // 100 ns units
+    };
+    return seconds(kernel) + seconds(user);
+#else
+    rusage usage = {};
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1e6;
+#endif
+}
+
+// Histogram of the measurement window: later snapshot minus earlier one
+metrics::LatencyHistogram::Snapshot difference(const metrics::LatencyHistogram::Snapshot& later,
+                                               const metrics::LatencyHistogram::Snapshot& earlier) {
+    metrics::LatencyHistogram::Snapshot window;
+    for (size_t i = 0; i < metrics::kLatencyBucketCount; ++i) {
+        window.buckets[i] = later.buckets[i] - earlier.buckets[i];
+        window.count += window.buckets[i];
+    }
+    window.sumUs = later.sumUs - earlier.sumUs;
+    return window;
+}
+
+void accumulate(metrics::LatencyHistogram::Snapshot& total, const metrics::LatencyHistogram::Snapshot& add) {
+    for (size_t i = 0; i < metrics::kLatencyBucketCount; ++i) {
+        total.buckets[i] += add.buckets[i];
+    }
+    total.count += add.count;
+    total.sumUs += add.sumUs;
+}
+
+// Upper bound of the bucket holding the quantile, in milliseconds (the
+// histogram's resolution; the overflow bucket reports the largest bound)
+double quantileMs(const metrics::LatencyHistogram::Snapshot& histogram, double quantile) {
+    if (histogram.count == 0) {
+        return 0.0;
+    }
+
+    const uint64_t rank = static_cast<uint64_t>(quantile * static_cast<double>(histogram.count - 1)) + 1;
+    uint64_t cumulative = 0;
+    for (size_t i = 0; i < metrics::kLatencyBucketsUs.size(); ++i) {
+        cumulative += histogram.buckets[i];
+        if (cumulative >= rank) {
+            return metrics::kLatencyBucketsUs[i] / 1000.0;
+        }
+    }
+    return metrics::kLatencyBucketsUs.back() / 1000.0;
+}
+
+// Counters summed over every camera
+struct Totals {
+    uint64_t packets = 0;
+    uint64_t bytes = 0;
+    uint64_t decoded = 0;
+    uint64_t decodeErrors = 0;
+    uint64_t dropped = 0;             // Queue overflow and stale discards
+    uint64_t decimated = 0;
+    size_t gpuBytes = 0;
+    size_t nvdecCameras = 0;
+    metrics::LatencyHistogram::Snapshot decodeLatency;
+    metrics::LatencyHistogram::Snapshot totalLatency;
+};
+
+Totals sumSamples(const std::vector<metrics::CameraSample>& samples) {
+    Totals totals;
+    for (const metrics::CameraSample& sample : samples) {
+        totals.packets += sample.packets;
+        totals.bytes += sample.bytes;
+        totals.decoded += sample.framesDecoded;
+        totals.decodeErrors += sample.decodeErrors;
+        totals.dropped += sample.droppedNonReference + sample.droppedGop + sample.droppedFull +
+                          sample.discardedStale;
+        totals.decimated += sample.decimated;
+        totals.gpuBytes += sample.gpuBytes;
+        totals.nvdecCameras += sample.decoder == "nvdec" ? 1 : 0;
+        accumulate(totals.decodeLatency, sample.decodeLatency);
+        accumulate(totals.totalLatency, sample.stageLatency[static_cast<size_t>(metrics::LatencyStage::TOTAL)]);
+    }
+    return totals;
+}
+
+// ============================================================================
+// Recorded-file replay
+// ============================================================================
+
+bool readFile(const std::string& path, std::vector<uint8_t>& bytes) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return false;
+    }
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return !bytes.empty();
+}
+
+bool isHevcFile(const std::string& path) {
+    auto endsWith = [&](const char* suffix) {
+        const size_t length = std::char_traits<char>::length(suffix);
+        return path.size() >= length && path.compare(path.size() - length, length, suffix) == 0;
+    };
+    return endsWith(".h265") || endsWith(".hevc") || endsWith(".265");
+}
+
+// A recorded file, split into pictures once and shared by every camera replaying it
+struct ReplayClip {
+    CodecType codec = CodecType::H264;
+    int width = 0;
+    int height = 0;
+    int framerate = 25;                          // From the SPS, else 25
+    std::vector<network::AccessUnit> pictures;   // Slices of one buffer holding the whole file
+};
+
+std::shared_ptr<const ReplayClip> loadClip(const std::string& path) {
+    std::vector<uint8_t> bytes;
+    if (!readFile(path, bytes)) {
+        std::cerr << "Cannot read " << path << std::endl;
+        return nullptr;
+    }
+
+    auto clip = std::make_shared<ReplayClip>();
+    clip->codec = isHevcFile(path) ? CodecType::H265 : CodecType::H264;
+
+    network::BitstreamParser parser(clip->codec);
+    network::AccessUnitAssembler assembler(clip->codec);
+    parser.parsePacket(PacketBuffer::copyOf(bytes), 0);
+
+    network::NalUnit nal;
+    while (parser.getNalUnit(nal)) {
+        const bool sps = clip->codec == CodecType::H265 ? nal.type == network::NalUnitType::HEVC_SPS
+                                                        : nal.type == network::NalUnitType::SPS;
+        if (sps && clip->width == 0) {
+            network::SPSInfo info;
+            const bool parsed = clip->codec == CodecType::H265
+                                    ? network::HevcParser::extractSPS(nal.data.data(), nal.data.size(), info)
+                                    : network::H264Parser::extractSPS(nal.data.data(), nal.data.size(), info);
+            if (parsed) {
+                clip->width = info.width;
+                clip->height = info.height;
+                clip->framerate = info.framerate > 0 ? info.framerate : clip->framerate;
+            }
+        }
+        assembler.push(std::move(nal));
+    }
+    assembler.flush();
+
+    network::AccessUnit au;
+    while (assembler.pop(au)) {
+        clip->pictures.push_back(std::move(au));
+    }
+
+    if (clip->pictures.empty() || clip->width == 0 || !clip->pictures.front().isKeyframe) {
+        std::cerr << path << ": not an Annex B stream starting with its parameter sets and a keyframe"
+                  << std::endl;
+        return nullptr;
+    }
+    return clip;
+}
+
+// Synthetic camera replaying a clip through the normal ingest path
+//
+// Pictures are handed out in file order, looped at the end, with pts
+// (microseconds) one frame interval apart that keep rising across loops.
+// Reads are paced at rate times the clip's frame rate (0 = as fast as the
+// reader asks): a reactor gets WOULD_BLOCK until the next picture is due, a
+// pinned reader sleeps until then.
+class FileReplaySource : public network::StreamSource {
+public:
+    FileReplaySource(std::shared_ptr<const ReplayClip> clip, double rate, bool nonBlocking)
+        : clip_(std::move(clip))
+        , rate_(rate)
+        , nonBlocking_(nonBlocking)
+        , frameUs_(1000000 / clip_->framerate)
+        , startUs_(nowMicros())
+    {
+    }
+
+    void disconnect() override { state_ = network::ConnectionState::DISCONNECTED; }
+
+    ReadStatus readAccessUnits(std::vector<network::AccessUnit>& accessUnits) override {
+        accessUnits.clear();
+        if (state_.load() != network::ConnectionState::CONNECTED) {
+            return ReadStatus::CLOSED;
+        }
+
+        int64_t now = nowMicros();
+        if (rate_ > 0.0) {
+            const int64_t due = startUs_ + scheduled(frames_);
+            if (now - due > kMaxLagUs) {
+                startUs_ = now - scheduled(frames_);   // Stalled reader: restart the schedule
+            } else if (now < due) {
+                if (nonBlocking_) {
+                    return ReadStatus::WOULD_BLOCK;
+                }
+                std::this_thread::sleep_for(std::chrono::microseconds(due - now));
+                now = nowMicros();
+            }
+        }
+
+        network::AccessUnit au = clip_->pictures[frames_ % clip_->pictures.size()];
+        au.pts = frames_ * frameUs_;
+        au.dts = au.pts;
+        au.receiveTime = now;
+        frames_++;
+
+        accessUnits.push_back(std::move(au));
+        return ReadStatus::OK;
+    }
+
+    bool getStreamInfo(int& width, int& height, int& framerate) const override {
+        width = clip_->width;
+        height = clip_->height;
+        framerate = clip_->framerate;
+        return true;
+    }
+
+    CodecType getCodec() const override { return clip_->codec; }
+    network::ConnectionState getState() const override { return state_.load(); }
+
+private:
+    // A reader that fell this far behind restarts its schedule instead of
+    // bursting to catch up
+    static constexpr int64_t kMaxLagUs = 1000000;
+
+    static int64_t nowMicros() {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            Clock::now().time_since_epoch()).count();
+    }
+
+    int64_t scheduled(int64_t frames) const {
+        return static_cast<int64_t>(static_cast<double>(frames * frameUs_) / rate_);
+    }
+
+    std::shared_ptr<const ReplayClip> clip_;
+    const double rate_;
+    const bool nonBlocking_;
+    const int64_t frameUs_;
+    int64_t startUs_;                // Steady clock of picture 0 of the schedule
+    uint64_t frames_ = 0;            // Pictures handed out, across loops
+    std::atomic<network::ConnectionState> state_{network::ConnectionState::CONNECTED};
+};
+
+// ============================================================================
+// Pipeline runs
+// ============================================================================
+
+struct RunResult {
+    stream::StreamQuality quality = stream::StreamQuality::GRID_VIEW;
+    size_t requested = 0;
+    size_t started = 0;
+    size_t devices = 1;
+    size_t nvdecCameras = 0;
+    double windowSeconds = 0.0;
+    double ingestFps = 0.0;           // Access units received per second, all cameras
+    double decodeFps = 0.0;           // Frames delivered per second, all cameras
+    double decodeFpsPerCamera = 0.0;
+    double ingestMbps = 0.0;
+    double dropRatio = 0.0;           // Queue drops per received access unit
+    double cpuPercentPerCamera = 0.0; // Of one core
+    double vramMbPerCamera = 0.0;     // Decoder surfaces
+    double poolMbPerCamera = 0.0;     // Everything the memory pools hold
+    double decodeP50Ms = 0.0;
+    double decodeP99Ms = 0.0;
+    double latencyP50Ms = 0.0;        // Receive to deliver
+    double latencyP99Ms = 0.0;
+    uint64_t decodeErrors = 0;
+    bool sustained = false;           // Met the ramp's drop and latency limits
+};
+
+bool runLoad(const BenchConfig& config, stream::StreamQuality quality, size_t cameraCount, RunResult& result) {
+    result = RunResult{};
+    result.quality = quality;
+    result.requested = cameraCount;
+
+    stream::StreamPipeline::Config pipelineConfig;
+    pipelineConfig.useAllDevices = config.allDevices;
+    pipelineConfig.enableMemoryWarnings = false;
+
+    stream::StreamPipeline pipeline(pipelineConfig);
+    if (!pipeline.initialize()) {
+        std::cerr << "Pipeline initialization failed" << std::endl;
+        return false;
+    }
+    result.devices = std::max<size_t>(1, pipeline.getDeviceIds().size());
+
+    auto* streams = pipeline.getStreamManager();
+
+    std::vector<std::shared_ptr<const ReplayClip>> clips;
+    for (const std::string& input : config.inputs) {
+        clips.push_back(loadClip(input));
+        if (!clips.back()) {
+            pipeline.shutdown();
+            return false;
+        }
+    }
+
+    std::vector<stream::CameraStream::Config> cameras;
+    cameras.reserve(cameraCount);
+    for (size_t i = 0; i < cameraCount; ++i) {
+        stream::CameraStream::Config camera;
+        char id[32];
+        std::snprintf(id, sizeof(id), "bench-%04zu", i);
+        camera.id = id;
+        camera.rtspUrl = config.inputs[i % config.inputs.size()];
+        camera.quality = quality;
+        camera.decoderType = config.decoder;
+        camera.autoReconnect = false;
+
+        // nonBlockingReceive is set by the stream manager in reactor mode
+        camera.sourceFactory = [clip = clips[i % clips.size()], rate = config.replayRate](
+                                   const stream::CameraStream::Config& cameraConfig) {
+            return std::make_unique<FileReplaySource>(clip, rate, cameraConfig.nonBlockingReceive);
+        };
+        cameras.push_back(camera);
+    }
+
+    const auto added = streams->addCameras(cameras);
+    result.started = added.started;
+    if (added.started == 0) {
+        std::cerr << "No camera started" << std::endl;
+        pipeline.shutdown();
+        return false;
+    }
+
+    std::this_thread::sleep_for(std::chrono::seconds(config.warmupSeconds));
+
+    // Measurement window
+    const std::vector<metrics::CameraSample> before = streams->collectMetrics();
+    const double cpuBefore = processCpuSeconds();
+    const Clock::time_point start = Clock::now();
+
+    std::this_thread::sleep_for(std::chrono::seconds(config.durationSeconds));
+
+    const std::vector<metrics::CameraSample> after = streams->collectMetrics();
+    const double cpuSeconds = processCpuSeconds() - cpuBefore;
+    const double window = secondsSince(start);
+    const stream::PipelineStats pipelineStats = pipeline.getStats();
+
+    pipeline.shutdown();
+
+    const Totals first = sumSamples(before);
+    const Totals last = sumSamples(after);
+    const double started = static_cast<double>(result.started);
+
+    result.windowSeconds = window;
+    result.nvdecCameras = last.nvdecCameras;
+    result.ingestFps = (last.packets - first.packets) / window;
+    result.decodeFps = (last.decoded - first.decoded) / window;
+    result.decodeFpsPerCamera = result.decodeFps / started;
+    result.ingestMbps = (last.bytes - first.bytes) * 8.0 / window / 1e6;
+
+    const uint64_t received = last.packets - first.packets;
+    result.dropRatio = received > 0 ? static_cast<double>(last.dropped - first.dropped) / received : 0.0;
+    result.decodeErrors = last.decodeErrors - first.decodeErrors;
+
+    result.cpuPercentPerCamera = cpuSeconds / window / started * 100.0;
+    result.vramMbPerCamera = last.gpuBytes / started / (1024.0 * 1024.0);
+
+    size_t poolBytes = 0;
+    for (const stream::DeviceStats& device : pipelineStats.devices) {
+        poolBytes += device.memoryStats.pooledBytes;
+    }
+    result.poolMbPerCamera = poolBytes / started / (1024.0 * 1024.0);
+
+    const auto decodeLatency = difference(last.decodeLatency, first.decodeLatency);
+    const auto totalLatency = difference(last.totalLatency, first.totalLatency);
+    result.decodeP50Ms = quantileMs(decodeLatency, 0.50);
+    result.decodeP99Ms = quantileMs(decodeLatency, 0.99);
+    result.latencyP50Ms = quantileMs(totalLatency, 0.50);
+    result.latencyP99Ms = quantileMs(totalLatency, 0.99);
+
+    result.sustained = result.started == result.requested &&
+                       result.dropRatio <= config.maxDropRatio &&
+                       result.latencyP99Ms <= config.maxP99Ms &&
+                       result.decodeFps > 0.0;
+    return true;
+}
+
+void printRun(const RunResult& run) {
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "  " << std::setw(10) << std::left << qualityName(run.quality) << std::right
+              << " cameras " << std::setw(4) << run.started << "/" << std::setw(4) << run.requested
+              << "  decode " << std::setw(8) << run.decodeFps << " fps"
+              << "  cpu/cam " << std::setw(6) << run.cpuPercentPerCamera << "%"
+              << "  vram/cam " << std::setw(7) << run.vramMbPerCamera << " MB"
+              << "  p99 " << std::setw(7) << run.latencyP99Ms << " ms"
+              << "  drops " << std::setw(6) << run.dropRatio * 100.0 << "%"
+              << (run.sustained ? "" : "  (falling behind)") << std::endl;
+}
+
+// Largest camera count that still meets the limits, doubling the step until
+// the first failure, then stepping back up from the last good count
+struct RampResult {
+    stream::StreamQuality quality = stream::StreamQuality::GRID_VIEW;
+    size_t maxCameras = 0;
+    size_t devices = 1;
+    RunResult atMax;
+    std::vector<RunResult> steps;
+};
+
+RampResult findMaxCameras(const BenchConfig& config, stream::StreamQuality quality) {
+    RampResult ramp;
+    ramp.quality = quality;
+
+    size_t good = 0;
+    size_t bad = config.maxCameras + 1;
+    size_t next = std::min(config.step, config.maxCameras);
+
+    while (next > good && next < bad) {
+        RunResult run;
+        if (!runLoad(config, quality, next, run)) {
+            bad = next;
+        } else {
+            printRun(run);
+            ramp.steps.push_back(run);
+            ramp.devices = run.devices;
+            if (run.sustained) {
+                good = next;
+                ramp.atMax = run;
+            } else {
+                bad = next;
+            }
+        }
+
+        // Grow geometrically until a failure, then bisect down to the step size
+        if (bad > config.maxCameras) {
+            next = std::min(good * 2, config.maxCameras);
+        } else if (bad - good > config.step) {
+            next = good + (bad - good) / 2;
+        } else {
+            break;
+        }
+    }
+
+    ramp.maxCameras = good;
+    return ramp;
+}
+
+// ============================================================================
+// Microbenchmarks
+// ============================================================================
+
+struct MicroResult {
+    std::string name;
+    double opsPerSecond = 0.0;
+    double nsPerOp = 0.0;
+    double megabytesPerSecond = 0.0;   // 0 if not a byte stream
+};
+
+// Repeat body until at least minSeconds have passed; returns operations per second
+template <typename Body>
+double measure(double minSeconds, uint64_t opsPerIteration, Body body) {
+    uint64_t ops = 0;
+    const Clock::time_point start = Clock::now();
+    double elapsed = 0.0;
+    do {
+        body();
+        ops += opsPerIteration;
+        elapsed = secondsSince(start);
+    } while (elapsed < minSeconds);
+    return ops / elapsed;
+}
+
+MicroResult makeResult(const std::string& name, double opsPerSecond, double bytesPerOp = 0.0) {
+    MicroResult result;
+    result.name = name;
+    result.opsPerSecond = opsPerSecond;
+    result.nsPerOp = opsPerSecond > 0.0 ? 1e9 / opsPerSecond : 0.0;
+    result.megabytesPerSecond = opsPerSecond * bytesPerOp / 1e6;
+    return result;
+}
+
+std::vector<MicroResult> runMicrobenchmarks(const BenchConfig& config) {
+    std::vector<MicroResult> results;
+    constexpr double kMinSeconds = 1.0;
+
+    std::vector<uint8_t> bitstream;
+    if (!readFile(config.inputs.front(), bitstream)) {
+        std::cerr << "Cannot read " << config.inputs.front() << std::endl;
+        return results;
+    }
+    const CodecType codec = isHevcFile(config.inputs.front()) ? CodecType::H265
+                                                                       : CodecType::H264;
+
+    // BitstreamParser: split the whole file at its start codes (zero-copy slices)
+    const PacketBuffer packet = PacketBuffer::copyOf(bitstream);
+    network::BitstreamParser parser(codec);
+    std::vector<network::NalUnit> nalUnits;
+    parser.parsePacket(packet, 0);
+    network::NalUnit nal;
+    while (parser.getNalUnit(nal)) {
+        nalUnits.push_back(nal);
+    }
+
+    if (!nalUnits.empty()) {
+        const double filesPerSecond = measure(kMinSeconds, 1, [&]() {
+            parser.parsePacket(packet, 0);
+            network::NalUnit unit;
+            while (parser.getNalUnit(unit)) {
+            }
+        });
+        MicroResult result = makeResult("bitstream_parser.nal_units", filesPerSecond * nalUnits.size(),
+                                        static_cast<double>(bitstream.size()) / nalUnits.size());
+        results.push_back(result);
+    }
+
+    // H264Parser: NAL headers of every unit, and the stream's SPS
+    if (codec == CodecType::H264 && !nalUnits.empty()) {
+        volatile int sink = 0;
+        results.push_back(makeResult("h264_parser.nal_header", measure(kMinSeconds, nalUnits.size(), [&]() {
+            for (const network::NalUnit& unit : nalUnits) {
+                sink = sink + network::H264Parser::parseNalHeader(unit.data.data(), unit.data.size()).refIdc;
+            }
+        })));
+
+        const network::NalUnit* spsUnit = nullptr;
+        for (const network::NalUnit& unit : nalUnits) {
+            if (unit.type == network::NalUnitType::SPS) {
+                spsUnit = &unit;
+                break;
+            }
+        }
+        if (spsUnit) {
+            results.push_back(makeResult("h264_parser.extract_sps", measure(kMinSeconds, 1000, [&]() {
+                for (int i = 0; i < 1000; ++i) {
+                    network::SPSInfo sps;
+                    network::H264Parser::extractSPS(spsUnit->data.data(), spsUnit->data.size(), sps);
+                    sink = sink + sps.width;
+                }
+            })));
+        }
+    }
+
+    // BoundedQueue: producer and consumer threads, the packet queue's usage
+    {
+        constexpr uint64_t kItems = 1 << 24;
+        threading::BoundedQueue<uint64_t> queue(1024);
+
+        const Clock::time_point start = Clock::now();
+        std::thread producer([&]() {
+            for (uint64_t i = 0; i < kItems; ) {
+                uint64_t item = i;
+                if (queue.push(std::move(item))) {
+                    ++i;
+                }
+            }
+        });
+
+        uint64_t received = 0;
+        uint64_t checksum = 0;
+        uint64_t item = 0;
+        while (received < kItems) {
+            if (queue.pop(item)) {
+                checksum += item;
+                ++received;
+            }
+        }
+        producer.join();
+
+        const double elapsed = secondsSince(start);
+        if (checksum != kItems * (kItems - 1) / 2) {
+            std::cerr << "BoundedQueue: items lost or reordered" << std::endl;
+        }
+        results.push_back(makeResult("bounded_queue.spsc_transfer", kItems / elapsed));
+    }
+
+    // BoundedQueue: push + pop on one thread (uncontended cost of the atomics)
+    {
+        threading::BoundedQueue<uint64_t> queue(1024);
+        uint64_t item = 0;
+        results.push_back(makeResult("bounded_queue.push_pop", measure(kMinSeconds, 1000000, [&]() {
+            for (int i = 0; i < 1000000; ++i) {
+                uint64_t value = static_cast<uint64_t>(i);
+                queue.push(std::move(value));
+                queue.pop(item);
+            }
+        })));
+    }
+
+    return results;
+}
+
+void printMicro(const MicroResult& result) {
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "  " << std::setw(30) << std::left << result.name << std::right
+              << std::setw(14) << result.opsPerSecond / 1e6 << " M ops/s"
+              << std::setw(10) << result.nsPerOp << " ns/op";
+    if (result.megabytesPerSecond > 0.0) {
+        std::cout << std::setw(10) << result.megabytesPerSecond << " MB/s";
+    }
+    std::cout << std::endl;
+}
+
+// ============================================================================
+// JSON report
+// ============================================================================
+
+void appendJsonString(std::ostringstream& out, const std::string& value) {
+    out << '"';
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            out << '\\' << c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", static_cast<unsigned char>(c));
+            out << escaped;
+        } else {
+            out << c;
+        }
+    }
+    out << '"';
+}
+
+void appendRun(std::ostringstream& out, const RunResult& run) {
+    out << "{\"quality\":\"" << qualityName(run.quality) << "\""
+        << ",\"cameras_requested\":" << run.requested
+        << ",\"cameras_started\":" << run.started
+        << ",\"cameras_nvdec\":" << run.nvdecCameras
+        << ",\"devices\":" << run.devices
+        << ",\"window_seconds\":" << run.windowSeconds
+        << ",\"ingest_fps\":" << run.ingestFps
+        << ",\"ingest_mbps\":" << run.ingestMbps
+        << ",\"decode_fps\":" << run.decodeFps
+        << ",\"decode_fps_per_camera\":" << run.decodeFpsPerCamera
+        << ",\"drop_ratio\":" << run.dropRatio
+        << ",\"decode_errors\":" << run.decodeErrors
+        << ",\"cpu_percent_per_camera\":" << run.cpuPercentPerCamera
+        << ",\"vram_mb_per_camera\":" << run.vramMbPerCamera
+        << ",\"pool_mb_per_camera\":" << run.poolMbPerCamera
+        << ",\"decode_p50_ms\":" << run.decodeP50Ms
+        << ",\"decode_p99_ms\":" << run.decodeP99Ms
+        << ",\"latency_p50_ms\":" << run.latencyP50Ms
+        << ",\"latency_p99_ms\":" << run.latencyP99Ms
+        << ",\"sustained\":" << (run.sustained ? "true" : "false") << "}";
+}
+
+std::string toJson(const BenchConfig& config, const std::vector<RunResult>& runs,
+                   const std::vector<RampResult>& ramps, const std::vector<MicroResult>& micro) {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+
+    out << "{\"benchmark\":\"fluxvision-pipeline\",\"config\":{\"inputs\":[";
+    for (size_t i = 0; i < config.inputs.size(); ++i) {
+        out << (i ? "," : "");
+        appendJsonString(out, config.inputs[i]);
+    }
+    out << "],\"replay_rate\":" << config.replayRate
+        << ",\"duration_seconds\":" << config.durationSeconds
+        << ",\"warmup_seconds\":" << config.warmupSeconds
+        << ",\"max_drop_ratio\":" << config.maxDropRatio
+        << ",\"max_p99_ms\":" << config.maxP99Ms << "}";
+
+    out << ",\"runs\":[";
+    for (size_t i = 0; i < runs.size(); ++i) {
+        out << (i ? "," : "");
+        appendRun(out, runs[i]);
+    }
+    out << "]";
+
+    out << ",\"max_cameras\":[";
+    for (size_t i = 0; i < ramps.size(); ++i) {
+        const RampResult& ramp = ramps[i];
+        out << (i ? "," : "")
+            << "{\"quality\":\"" << qualityName(ramp.quality) << "\""
+            << ",\"max_cameras\":" << ramp.maxCameras
+            << ",\"max_cameras_per_gpu\":" << ramp.maxCameras / ramp.devices
+            << ",\"at_max\":";
+        appendRun(out, ramp.atMax);
+        out << ",\"steps\":[";
+        for (size_t s = 0; s < ramp.steps.size(); ++s) {
+            out << (s ? "," : "");
+            appendRun(out, ramp.steps[s]);
+        }
+        out << "]}";
+    }
+    out << "]";
+
+    out << ",\"micro\":[";
+    for (size_t i = 0; i < micro.size(); ++i) {
+        out << (i ? "," : "")
+            << "{\"name\":\"" << micro[i].name << "\""
+            << ",\"ops_per_second\":" << micro[i].opsPerSecond
+            << ",\"ns_per_op\":" << micro[i].nsPerOp
+            << ",\"mb_per_second\":" << micro[i].megabytesPerSecond << "}";
+    }
+    out << "]}\n";
+
+    return out.str();
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchConfig config;
+    if (!parseArgs(argc, argv, config)) {
+        return 1;
+    }
+
+    std::cout << "\n========================================" << std::endl;
+    std::cout << "  FluxVision VMS - Pipeline Benchmark" << std::endl;
+    std::cout << "========================================\n" << std::endl;
+
+    std::vector<MicroResult> micro;
+    if (config.micro) {
+        std::cout << "Microbenchmarks:" << std::endl;
+        micro = runMicrobenchmarks(config);
+        for (const MicroResult& result : micro) {
+            printMicro(result);
+        }
+        std::cout << std::endl;
+    }
+
+    std::vector<RunResult> runs;
+    std::vector<RampResult> ramps;
+    bool failed = false;
+
+    if (!config.microOnly) {
+        for (stream::StreamQuality quality : config.qualities) {
+            if (config.findMax) {
+                std::cout << "Finding max cameras at " << qualityName(quality) << ":" << std::endl;
+                ramps.push_back(findMaxCameras(config, quality));
+                const RampResult& ramp = ramps.back();
+                std::cout << "  => " << ramp.maxCameras << " cameras (" << ramp.maxCameras / ramp.devices
+                          << " per GPU)\n" << std::endl;
+            } else {
+                RunResult run;
+                if (runLoad(config, quality, config.cameras, run)) {
+                    printRun(run);
+                    runs.push_back(run);
+                } else {
+                    failed = true;
+                }
+            }
+        }
+    }
+
+    if (!config.jsonPath.empty()) {
+        std::ofstream file(config.jsonPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            std::cerr << "Cannot write " << config.jsonPath << std::endl;
+            return 1;
+        }
+        file << toJson(config, runs, ramps, micro);
+        std::cout << "\nResults written to " << config.jsonPath << std::endl;
+    }
+
+    return failed ? 1 : 0;
+}